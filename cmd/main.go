@@ -153,6 +153,7 @@ func main() {
 
 	// 创建源文件解析器
 	sourceFileParser := parser.NewSourceFileParser(appLogger)
+	defer sourceFileParser.Close()
 
 	packageClassifier := packageclassifier.NewPackageClassifier()
 
@@ -162,6 +163,8 @@ func main() {
 	indexer := service.NewCodeIndexer(scanRepo, sourceFileParser, dependencyAnalyzer, workspaceReader, codegraphStore,
 		workspaceRepo, service.IndexerConfig{VisitPattern: workspace.DefaultVisitPattern}, appLogger)
 
+	service.RegisterMetrics(codegraphStore, indexer, eventRepo, appLogger)
+
 	codegraphProcessor := service.NewCodegraphProcessor(workspaceReader, indexer, workspaceRepo, eventRepo, appLogger)
 	codebaseService := service.NewCodebaseService(storageManager, appLogger, workspaceReader, workspaceRepo, definition.NewDefinitionParser(), indexer)
 	extensionService := service.NewExtensionService(storageManager, syncRepo, scanRepo, workspaceRepo, eventRepo, codebaseEmbeddingRepo, codebaseService, fileScanService, appLogger)
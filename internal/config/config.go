@@ -27,6 +27,8 @@ type ConfigSync struct {
 	RetryDelaySeconds       int     `json:"retryDelaySeconds"`
 	EmbeddingSuccessPercent float32 `json:"embeddingSuccessPercent"`
 	CodegraphSuccessPercent float32 `json:"codegraphSuccessPercent"`
+	UploadConcurrency       int     `json:"uploadConcurrency"`   // 每个工作区同时上传的请求数
+	UploadBandwidthKBps     int     `json:"uploadBandwidthKBps"` // 每个工作区的上传带宽，0 表示不限速
 }
 
 // Pprof configuration
@@ -105,6 +107,8 @@ var DefaultConfigSync = ConfigSync{
 	RetryDelaySeconds:       3,    // Default retry delay in seconds
 	EmbeddingSuccessPercent: 80.0, // Default embedding success percent
 	CodegraphSuccessPercent: 90.0, // Default codegraph success percent
+	UploadConcurrency:       4,    // Default concurrent uploads per workspace
+	UploadBandwidthKBps:     0,    // Default unlimited upload bandwidth
 }
 
 // Default pprof configuration
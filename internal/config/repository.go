@@ -52,6 +52,7 @@ type EmbeddingConfig struct {
 type IgnoreConfig struct {
 	IgnoreRules  *gitignore.GitIgnore
 	IncludeRules []string
+	IncludeExts  map[string]struct{} // IncludeRules lookup set, read-only
 	MaxFileCount int
 	MaxFileSize  int
 }
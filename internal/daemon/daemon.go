@@ -240,6 +240,8 @@ func configChanged(current, new config.ClientConfig) bool {
 		current.Sync.RetryDelaySeconds != new.Sync.RetryDelaySeconds ||
 		current.Sync.EmbeddingSuccessPercent != new.Sync.EmbeddingSuccessPercent ||
 		current.Sync.CodegraphSuccessPercent != new.Sync.CodegraphSuccessPercent ||
+		current.Sync.UploadConcurrency != new.Sync.UploadConcurrency ||
+		current.Sync.UploadBandwidthKBps != new.Sync.UploadBandwidthKBps ||
 		current.Scan.MaxFileSizeKB != new.Scan.MaxFileSizeKB ||
 		current.Scan.MaxFileCount != new.Scan.MaxFileCount ||
 		!equalIgnorePatterns(current.Scan.FolderIgnorePatterns, new.Scan.FolderIgnorePatterns) ||
@@ -0,0 +1,4 @@
+-- 事件表复合索引：按路径去重和按状态领取事件时避免全表扫描
+CREATE INDEX IF NOT EXISTS idx_events_workspace_source ON events(workspace_path, source_file_path, created_at);
+CREATE INDEX IF NOT EXISTS idx_events_workspace_embedding_status ON events(workspace_path, embedding_status, created_at);
+CREATE INDEX IF NOT EXISTS idx_events_workspace_codegraph_status ON events(workspace_path, codegraph_status, created_at);
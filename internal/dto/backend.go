@@ -52,6 +52,21 @@ type CallGraphData struct {
 	List []*types.RelationNode `json:"list"`
 }
 
+// RelationChunk 流式查询返回的一批节点，按层依次输出，客户端按 Id、ParentId 组装成树。
+// 最后一行 Done 为 true，没有收到说明查询中断
+type RelationChunk struct {
+	Layer int                  `json:"layer"`
+	Nodes []*RelationChunkNode `json:"nodes,omitempty"`
+	Done  bool                 `json:"done,omitempty"`
+}
+
+// RelationChunkNode 不含子节点的关系节点，ParentId 为 0 表示根节点
+type RelationChunkNode struct {
+	Id       int `json:"id"`
+	ParentId int `json:"parentId"`
+	types.RelationNode
+}
+
 // GetCallGraphRequest 获取函数调用链及其函数定义
 type SearchCallGraphRequest struct {
 	ClientId     string `form:"clientId" binding:"required"`
@@ -166,6 +181,18 @@ type ExportIndexRequest struct {
 	CodebasePath string `form:"codebasePath" binding:"required"`
 }
 
+// ExportSnapshotRequest 导出索引快照请求
+type ExportSnapshotRequest struct {
+	ClientId     string `json:"clientId" binding:"required"`
+	CodebasePath string `json:"codebasePath" binding:"required"`
+	Dir          string `json:"dir"` // 快照输出目录，为空时写入 SNAPSHOT_DIR
+}
+
+// ExportSnapshotData 导出的快照文件
+type ExportSnapshotData struct {
+	Files []string `json:"files"`
+}
+
 // DeleteIndexRequest 删除索引请求
 type DeleteIndexRequest struct {
 	ClientId     string `form:"clientId" binding:"required"`
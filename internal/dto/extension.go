@@ -402,3 +402,53 @@ type IndexSwitchResponse struct {
 	// example: true
 	Data bool `json:"data"`
 }
+
+// SearchSymbolRequest represents the query parameters for symbol search
+// @Description 按符号名前缀、子串或模糊匹配搜索符号的查询参数
+type SearchSymbolRequest struct {
+	// 工作空间路径
+	// required: true
+	// example: g:\projects\codebase-indexer
+	Workspace string `form:"workspace" binding:"required"`
+
+	// 符号名或其中一部分
+	// required: true
+	// example: Vec
+	Query string `form:"query" binding:"required"`
+
+	// 语言，为空时搜索全部语言
+	// example: go
+	Language string `form:"language,omitempty"`
+
+	// 最多返回的符号数，默认50，最大500
+	// example: 50
+	Limit int `form:"limit,omitempty"`
+}
+
+// SymbolInfo 符号搜索结果
+type SymbolInfo struct {
+	Name        string            `json:"name"`
+	Language    string            `json:"language"`
+	MatchType   string            `json:"matchType"`
+	Score       float64           `json:"score"`
+	Definitions []*DefinitionInfo `json:"definitions"`
+}
+
+type SymbolSearchData struct {
+	List []*SymbolInfo `json:"list"`
+}
+
+// SearchSymbolResponse represents the response for symbol search
+// @Description 符号搜索的响应数据，结果按匹配程度排序
+type SearchSymbolResponse struct {
+	// 响应代码
+	// example: 0
+	Code string `json:"code"`
+
+	// 响应消息
+	// example: ok
+	Message string `json:"message"`
+
+	// 匹配的符号
+	Data *SymbolSearchData `json:"data"`
+}
@@ -135,6 +135,72 @@ func (h *BackendHandler) SearchCallGraph(c *gin.Context) {
 	response.OkJson(c, callGraph)
 }
 
+// SearchCallGraphStream 流式获取函数调用链
+// @Summary 流式获取函数调用链
+// @Description 参数与 /callgraph 相同，按层以 NDJSON 返回调用链节点，每行是一个 dto.RelationChunk，客户端断开后停止查询
+// @Tags search
+// @Accept json
+// @Produce application/x-ndjson
+// @Param clientId query string true "用户机器ID"
+// @Param codebasePath query string true "代码库绝对路径"
+// @Param filePath query string true "文件绝对路径"
+// @Param lineRange query string false "行范围，如 1-10"
+// @Param symbolName query string false "符号名，比如函数名、类名等"
+// @Param maxLayer query int false "最大层数，默认最大10层"
+// @Success 200 {object} response.Response{data=dto.RelationChunk} "成功，每行一个"
+// @Failure 400 {object} response.Response "请求参数错误"
+// @Router /codebase-indexer/api/v1/callgraph/stream [get]
+func (h *BackendHandler) SearchCallGraphStream(c *gin.Context) {
+	var req dto.SearchCallGraphRequest
+	if err := c.ShouldBindQuery(&req); err != nil {
+		h.logger.Error("invalid request format: %v", err)
+		response.Error(c, http.StatusBadRequest, err)
+		return
+	}
+	h.logger.Info("stream callgraph request: ClientId=%s, Workspace=%s, FilePath=%s", req.ClientId, req.CodebasePath, req.FilePath)
+	stream := response.NewStreamWriter(c)
+	err := h.codebaseService.StreamCallGraph(c.Request.Context(), &req, func(chunk *dto.RelationChunk) error {
+		return stream.Write(chunk)
+	})
+	if err != nil {
+		h.logger.Error("stream callgraph err:%v", err)
+		stream.Error(http.StatusBadRequest, err)
+	}
+}
+
+// SearchReferenceStream 流式关系检索
+// @Summary 流式关系检索
+// @Description 参数与 /search/reference 相同，以 NDJSON 返回关系节点，每行是一个 dto.RelationChunk，客户端断开后停止查询
+// @Tags search
+// @Accept json
+// @Produce application/x-ndjson
+// @Param clientId query string true "用户机器ID"
+// @Param codebasePath query string true "代码库绝对路径"
+// @Param filePath query string false "文件绝对路径"
+// @Param startLine query int false "开始行号"
+// @Param endLine query int false "结束行号"
+// @Param symbolName query string false "符号名"
+// @Success 200 {object} response.Response{data=dto.RelationChunk} "成功，每行一个"
+// @Failure 400 {object} response.Response "请求参数错误"
+// @Router /codebase-indexer/api/v1/search/reference/stream [get]
+func (h *BackendHandler) SearchReferenceStream(c *gin.Context) {
+	var req dto.SearchReferenceRequest
+	if err := c.ShouldBindQuery(&req); err != nil {
+		h.logger.Error("invalid request format: %v", err)
+		response.Error(c, http.StatusBadRequest, err)
+		return
+	}
+	h.logger.Info("stream relation request: ClientId=%s, Workspace=%s, FilePath=%s", req.ClientId, req.CodebasePath, req.FilePath)
+	stream := response.NewStreamWriter(c)
+	err := h.codebaseService.StreamReference(c.Request.Context(), &req, func(chunk *dto.RelationChunk) error {
+		return stream.Write(chunk)
+	})
+	if err != nil {
+		h.logger.Error("stream relation err:%v", err)
+		stream.Error(http.StatusBadRequest, err)
+	}
+}
+
 // GetFileContent 获取源文件内容接口
 // @Summary 获取文件内容
 // @Description 获取源文件内容，以二进制流形式返回
@@ -286,6 +352,34 @@ func (h *BackendHandler) ExportIndex(c *gin.Context) {
 	}
 }
 
+// ExportSnapshots 导出代码库的索引快照
+// @Summary 导出索引快照
+// @Description 将代码库各项目的索引导出为快照文件，其他机器将 SNAPSHOT_DIR 指向快照目录后，首次索引前会导入匹配的快照
+// @Tags index
+// @Accept json
+// @Produce json
+// @Param request body dto.ExportSnapshotRequest true "导出请求"
+// @Success 200 {object} ExportSnapshotResponse "成功"
+// @Failure 400 {object} ExportSnapshotResponse "请求参数错误"
+// @Failure 500 {object} ExportSnapshotResponse "服务器内部错误"
+// @Router /codebase-indexer/api/v1/index/snapshot [post]
+func (h *BackendHandler) ExportSnapshots(c *gin.Context) {
+	var req dto.ExportSnapshotRequest
+	if err := c.ShouldBindJSON(&req); err != nil {
+		h.logger.Error("invalid request format: %v", err)
+		response.Error(c, http.StatusBadRequest, err)
+		return
+	}
+
+	data, err := h.codebaseService.ExportSnapshots(c, &req)
+	if err != nil {
+		h.logger.Error("export index snapshots err: %v", err)
+		response.Error(c, http.StatusBadRequest, err)
+		return
+	}
+	response.OkJson(c, data)
+}
+
 func (h *BackendHandler) DeleteIndex(c *gin.Context) {
 	var req dto.DeleteIndexRequest
 	if err := c.ShouldBindQuery(&req); err != nil {
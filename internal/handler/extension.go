@@ -572,6 +572,51 @@ func (h *ExtensionHandler) SwitchIndex(c *gin.Context) {
 	})
 }
 
+// SearchSymbols handles workspace symbol search via REST API
+// @Summary 搜索符号
+// @Description 按符号名前缀、子串或模糊匹配搜索工作区内的符号，结果按匹配程度排序
+// @Tags search
+// @Accept json
+// @Produce json
+// @Param workspace query string true "工作区路径" example(g:\projects\codebase-indexer)
+// @Param query query string true "符号名或其中一部分" example(Vec)
+// @Param language query string false "语言，为空时搜索全部语言"
+// @Param limit query int false "最多返回的符号数，默认50，最大500"
+// @Success 200 {object} SearchSymbolResponse "查询成功"
+// @Failure 400 {object} SearchSymbolResponse "请求参数错误"
+// @Failure 500 {object} SearchSymbolResponse "服务器内部错误"
+// @Router /codebase-indexer/api/v1/search/symbols [get]
+func (h *ExtensionHandler) SearchSymbols(c *gin.Context) {
+	var req dto.SearchSymbolRequest
+	if err := c.ShouldBindQuery(&req); err != nil {
+		h.logger.Error("invalid query parameters: %v", err)
+		c.JSON(http.StatusBadRequest, dto.SearchSymbolResponse{
+			Code:    errs.ErrBadRequest,
+			Message: "invalid query parameters",
+		})
+		return
+	}
+
+	h.logger.Info("symbol search request: Workspace=%s, Query=%s", req.Workspace, req.Query)
+
+	// 调用service层处理业务逻辑
+	data, err := h.extensionService.SearchSymbols(c.Request.Context(), &req)
+	if err != nil {
+		h.logger.Error("failed to search symbols: %v", err)
+		c.JSON(http.StatusInternalServerError, dto.SearchSymbolResponse{
+			Code:    errs.ErrInternalServerError,
+			Message: fmt.Sprintf("failed to search symbols: %v", err),
+		})
+		return
+	}
+
+	c.JSON(http.StatusOK, dto.SearchSymbolResponse{
+		Code:    "0",
+		Message: "ok",
+		Data:    data,
+	})
+}
+
 // UpdateSyncConfig handles sync configuration update via REST API
 // @Summary 更新同步配置
 // @Description 从Header中获取参数更新同步配置
@@ -2,7 +2,12 @@ package job
 
 import (
 	"context"
+	"errors"
 	"fmt"
+	"os"
+	"path/filepath"
+	"strconv"
+	"sync"
 	"time"
 
 	"codebase-indexer/internal/config"
@@ -10,10 +15,18 @@ import (
 	"codebase-indexer/internal/model"
 	"codebase-indexer/internal/repository"
 	"codebase-indexer/internal/service"
+	"codebase-indexer/internal/watcher"
 	"codebase-indexer/pkg/logger"
 )
 
-// FileScanJob 文件扫描任务
+const (
+	// reconcileInterval 监听中的工作区全量扫描对账的间隔，弥补监听遗漏的变更
+	reconcileInterval = 30 * time.Minute
+	watchDebounce     = 500 * time.Millisecond
+	watchMaxDelay     = 5 * time.Second
+)
+
+// FileScanJob 文件扫描任务。支持文件监听的平台由监听器上报变更，定时任务只做低频全量对账
 type FileScanJob struct {
 	scanner  service.FileScanService
 	storage  repository.StorageInterface
@@ -22,6 +35,11 @@ type FileScanJob struct {
 	interval time.Duration
 	ctx      context.Context
 	cancel   context.CancelFunc
+
+	watcher      *watcher.Watcher
+	scanMu       sync.Mutex           // 串行执行全量扫描和监听变更的检测
+	watched      map[string]string    // 监听的根目录 -> 工作区路径
+	lastFullScan map[string]time.Time // 工作区路径 -> 上次全量扫描时间
 }
 
 // NewFileScanJob 创建文件扫描任务
@@ -41,6 +59,9 @@ func NewFileScanJob(
 		interval: interval,
 		ctx:      ctx,
 		cancel:   cancel,
+
+		watched:      make(map[string]string),
+		lastFullScan: make(map[string]time.Time),
 	}
 }
 
@@ -53,6 +74,7 @@ func (j *FileScanJob) Start(ctx context.Context) {
 		}
 	}()
 	j.logger.Info("starting file scan job with interval: %v", j.interval)
+	j.startWatcher()
 
 	// 立即执行一次扫描
 	authInfo := config.GetAuthInfo()
@@ -91,6 +113,11 @@ func (j *FileScanJob) Start(ctx context.Context) {
 func (j *FileScanJob) Stop() {
 	j.logger.Info("stopping file scan job...")
 	j.cancel()
+	if j.watcher != nil {
+		if err := j.watcher.Close(); err != nil {
+			j.logger.Warn("failed to close file watcher: %v", err)
+		}
+	}
 	j.logger.Info("file scan job stopped")
 }
 
@@ -139,8 +166,14 @@ func (j *FileScanJob) scanWorkspaces(ctx context.Context) {
 		// 继续执行
 	}
 
-	// 扫描每个工作区
+	j.syncWatches(workspaces)
+
+	// 扫描每个工作区，监听中的工作区只按对账间隔全量扫描
 	for _, workspace := range workspaces {
+		if j.watcher != nil && j.watcher.Watching(workspace.WorkspacePath) &&
+			time.Since(j.lastFullScanTime(workspace.WorkspacePath)) < reconcileInterval {
+			continue
+		}
 		err := j.scanWorkspace(workspace)
 		if err != nil {
 			j.logger.Error("failed to scan workspace %s: %v", workspace.WorkspacePath, err)
@@ -153,11 +186,14 @@ func (j *FileScanJob) scanWorkspaces(ctx context.Context) {
 
 // scanWorkspace 扫描单个工作区
 func (j *FileScanJob) scanWorkspace(workspace *model.Workspace) error {
+	j.scanMu.Lock()
+	defer j.scanMu.Unlock()
 	// 检测文件变更
 	events, err := j.scanner.DetectFileChanges(workspace.WorkspacePath)
 	if err != nil {
 		return fmt.Errorf("failed to detect file changes: %w", err)
 	}
+	j.lastFullScan[workspace.WorkspacePath] = time.Now()
 	if len(events) == 0 {
 		j.logger.Debug("no file changes detected in workspace: %s", workspace.WorkspacePath)
 		return nil
@@ -173,3 +209,112 @@ func (j *FileScanJob) scanWorkspace(workspace *model.Workspace) error {
 
 	return nil
 }
+
+// startWatcher 创建文件监听器，平台不支持或通过 FILE_WATCH_ENABLED=false 关闭时只使用定时全量扫描
+func (j *FileScanJob) startWatcher() {
+	if v, ok := os.LookupEnv("FILE_WATCH_ENABLED"); ok {
+		if enabled, err := strconv.ParseBool(v); err == nil && !enabled {
+			j.logger.Info("file watching disabled, use periodic full scan")
+			return
+		}
+	}
+	w, err := watcher.NewWatcher(j.logger, watcher.Options{
+		Debounce:   watchDebounce,
+		MaxDelay:   watchMaxDelay,
+		OnChanges:  j.handleWatchedChanges,
+		OnOverflow: j.handleWatchOverflow,
+	})
+	if err != nil {
+		if errors.Is(err, watcher.ErrUnsupported) {
+			j.logger.Info("file watching is not supported on this platform, use periodic full scan")
+		} else {
+			j.logger.Warn("failed to create file watcher, use periodic full scan: %v", err)
+		}
+		return
+	}
+	j.watcher = w
+}
+
+// syncWatches 监听新的活跃工作区，取消不再活跃的工作区的监听
+func (j *FileScanJob) syncWatches(workspaces []*model.Workspace) {
+	if j.watcher == nil {
+		return
+	}
+	active := make(map[string]string, len(workspaces))
+	for _, workspace := range workspaces {
+		active[filepath.Clean(workspace.WorkspacePath)] = workspace.WorkspacePath
+	}
+
+	j.scanMu.Lock()
+	defer j.scanMu.Unlock()
+	for root, workspacePath := range active {
+		if _, ok := j.watched[root]; ok {
+			continue
+		}
+		if err := j.watcher.Watch(root, j.scanner.IgnoreFilter(workspacePath)); err != nil {
+			j.logger.Warn("failed to watch workspace %s, use periodic full scan: %v", workspacePath, err)
+			continue
+		}
+		j.watched[root] = workspacePath
+	}
+	for root, workspacePath := range j.watched {
+		if _, ok := active[root]; ok {
+			continue
+		}
+		j.watcher.Unwatch(root)
+		delete(j.watched, root)
+		delete(j.lastFullScan, workspacePath)
+	}
+}
+
+func (j *FileScanJob) lastFullScanTime(workspacePath string) time.Time {
+	j.scanMu.Lock()
+	defer j.scanMu.Unlock()
+	return j.lastFullScan[workspacePath]
+}
+
+// scanEnabled 已登录且未关闭codebase
+func (j *FileScanJob) scanEnabled() bool {
+	authInfo := config.GetAuthInfo()
+	if authInfo.ClientId == "" || authInfo.Token == "" || authInfo.ServerURL == "" {
+		return false
+	}
+	codebaseEnv := j.storage.GetCodebaseEnv()
+	return codebaseEnv == nil || codebaseEnv.Switch != dto.SwitchOff
+}
+
+func (j *FileScanJob) watchedWorkspace(root string) (string, bool) {
+	j.scanMu.Lock()
+	defer j.scanMu.Unlock()
+	workspacePath, ok := j.watched[root]
+	return workspacePath, ok
+}
+
+// handleWatchedChanges 监听到的变更直接生成事件
+func (j *FileScanJob) handleWatchedChanges(root string, relPaths []string) {
+	workspacePath, ok := j.watchedWorkspace(root)
+	if !ok || !j.scanEnabled() {
+		return
+	}
+	j.scanMu.Lock()
+	events, err := j.scanner.DetectPathChanges(workspacePath, relPaths)
+	j.scanMu.Unlock()
+	if err != nil {
+		j.logger.Error("failed to detect watched changes in workspace %s: %v", workspacePath, err)
+		return
+	}
+	if len(events) > 0 {
+		j.logger.Info("detected %d watched file changes in workspace: %s", len(events), workspacePath)
+	}
+}
+
+// handleWatchOverflow 变更可能丢失，立即全量扫描
+func (j *FileScanJob) handleWatchOverflow(root string) {
+	workspacePath, ok := j.watchedWorkspace(root)
+	if !ok || !j.scanEnabled() {
+		return
+	}
+	if err := j.scanWorkspace(&model.Workspace{WorkspacePath: workspacePath}); err != nil {
+		j.logger.Error("failed to scan workspace %s: %v", workspacePath, err)
+	}
+}
@@ -4,7 +4,9 @@ import (
 	"database/sql"
 	"fmt"
 	"runtime"
+	"sort"
 	"strings"
+	"sync"
 	"time"
 
 	"codebase-indexer/internal/database"
@@ -66,8 +68,14 @@ type EventRepository interface {
 	GetEventsCountByType(eventTypes []string) (int64, error)
 	// GetEventsCountByWorkspaceAndStatus 根据工作区路径、嵌入状态和代码图状态获取事件总数
 	GetEventsCountByWorkspaceAndStatus(workspacePaths []string, embeddingStatuses []int, codegraphStatuses []int) (int64, error)
+	// GetEventsCountGroupByWorkspace 按工作区统计满足嵌入状态和代码图状态条件的事件数
+	GetEventsCountGroupByWorkspace(embeddingStatuses []int, codegraphStatuses []int) (map[string]int64, error)
 	// GetLatestEventByWorkspaceAndSourcePath 根据工作区路径和源文件路径获取最新记录
 	GetLatestEventByWorkspaceAndSourcePath(workspacePath, sourceFilePath string) (*model.Event, error)
+	// GetLatestEventsBySourcePaths 批量获取工作区内指定源文件路径的最新记录，按源文件路径索引
+	GetLatestEventsBySourcePaths(workspacePath string, sourceFilePaths []string) (map[string]*model.Event, error)
+	// ClaimEventsForEmbedding 领取最早的 limit 个待处理事件并置为上报中，领取与状态更新在一条语句内完成
+	ClaimEventsForEmbedding(workspacePath string, eventTypes []string, statuses []int, limit int) ([]*model.Event, error)
 	// BatchCreateEvents 批量创建事件
 	BatchCreateEvents(events []*model.Event) error
 	// BatchDeleteEvents 批量删除事件
@@ -90,6 +98,10 @@ type EventRepository interface {
 type eventRepository struct {
 	db     database.DatabaseManager
 	logger logger.Logger
+
+	stmtMu sync.Mutex
+	stmtDB *sql.DB // 预编译语句所属的连接池，连接池变化后重新编译
+	stmts  map[string]*sql.Stmt
 }
 
 // 批量插入事件时每个事件需要的字段数量
@@ -97,12 +109,117 @@ type eventRepository struct {
 //  embedding_status, codegraph_status, created_at, updated_at)
 const eventInsertFieldCount = 8
 
+// 单条语句中 IN 列表的最大参数个数
+const eventQueryChunkSize = 500
+
+// eventSelectColumns 查询事件的列，顺序与 scanEvent 一致
+const eventSelectColumns = `id, workspace_path, event_type, source_file_path, target_file_path,
+	codegraph_status, embedding_status, sync_id, file_hash, created_at, updated_at`
+
 // NewEventRepository 创建事件Repository
 func NewEventRepository(db database.DatabaseManager, logger logger.Logger) EventRepository {
 	return &eventRepository{
 		db:     db,
 		logger: logger,
+		stmts:  make(map[string]*sql.Stmt),
+	}
+}
+
+// prepared 返回缓存的预编译语句，只用于固定文本的高频语句
+func (r *eventRepository) prepared(query string) (*sql.Stmt, error) {
+	db := r.db.GetDB()
+	r.stmtMu.Lock()
+	defer r.stmtMu.Unlock()
+	if r.stmtDB != db {
+		for _, stmt := range r.stmts {
+			stmt.Close()
+		}
+		r.stmts = make(map[string]*sql.Stmt)
+		r.stmtDB = db
+	}
+	if stmt, ok := r.stmts[query]; ok {
+		return stmt, nil
+	}
+	stmt, err := db.Prepare(query)
+	if err != nil {
+		return nil, fmt.Errorf("[DB] failed to prepare statement: %w", err)
+	}
+	r.stmts[query] = stmt
+	return stmt, nil
+}
+
+type rowScanner interface {
+	Scan(dest ...interface{}) error
+}
+
+// scanEvent 按 eventSelectColumns 的列顺序读取一行事件
+func scanEvent(row rowScanner) (*model.Event, error) {
+	var event model.Event
+	err := row.Scan(
+		&event.ID,
+		&event.WorkspacePath,
+		&event.EventType,
+		&event.SourceFilePath,
+		&event.TargetFilePath,
+		&event.CodegraphStatus,
+		&event.EmbeddingStatus,
+		&event.SyncId,
+		&event.FileHash,
+		&event.CreatedAt,
+		&event.UpdatedAt,
+	)
+	if err != nil {
+		return nil, err
+	}
+	return &event, nil
+}
+
+// sqlPlaceholders 生成 n 个以逗号分隔的占位符
+func sqlPlaceholders(n int) string {
+	if n <= 0 {
+		return ""
+	}
+	return strings.Repeat("?,", n-1) + "?"
+}
+
+// buildEventFilter 构造事件类型、工作区和状态的过滤条件，返回不含 WHERE 的条件列表
+func buildEventFilter(eventTypes []string, workspacePaths []string, embeddingStatuses []int,
+	codegraphStatuses []int) ([]string, []interface{}) {
+	var conditions []string
+	var args []interface{}
+	if len(eventTypes) > 0 {
+		conditions = append(conditions, fmt.Sprintf("event_type IN (%s)", sqlPlaceholders(len(eventTypes))))
+		for _, eventType := range eventTypes {
+			args = append(args, eventType)
+		}
+	}
+	if len(workspacePaths) > 0 {
+		conditions = append(conditions, fmt.Sprintf("workspace_path IN (%s)", sqlPlaceholders(len(workspacePaths))))
+		for _, path := range workspacePaths {
+			args = append(args, path)
+		}
+	}
+	if len(embeddingStatuses) > 0 {
+		conditions = append(conditions, fmt.Sprintf("embedding_status IN (%s)", sqlPlaceholders(len(embeddingStatuses))))
+		for _, status := range embeddingStatuses {
+			args = append(args, status)
+		}
 	}
+	if len(codegraphStatuses) > 0 {
+		conditions = append(conditions, fmt.Sprintf("codegraph_status IN (%s)", sqlPlaceholders(len(codegraphStatuses))))
+		for _, status := range codegraphStatuses {
+			args = append(args, status)
+		}
+	}
+	return conditions, args
+}
+
+// joinWhere 拼接过滤条件
+func joinWhere(conditions []string) string {
+	if len(conditions) == 0 {
+		return ""
+	}
+	return "WHERE " + strings.Join(conditions, " AND ")
 }
 
 // CreateEvent 创建事件
@@ -118,7 +235,11 @@ func (r *eventRepository) CreateEvent(event *model.Event) error {
 	caller := getCallerInfo(2)
 	r.logger.Info("[DB] CreateEvent called by: %s, path: %s", caller, event.SourceFilePath)
 
-	result, err := r.db.GetDB().Exec(query,
+	stmt, err := r.prepared(query)
+	if err != nil {
+		return err
+	}
+	result, err := stmt.Exec(
 		event.WorkspacePath,
 		event.EventType,
 		event.SourceFilePath,
@@ -545,80 +666,7 @@ func (r *eventRepository) GetEventsByTypeAndStatusAndWorkspaces(eventTypes []str
 		return r.getAllEventsByTypeAndStatusAndWorkspaces(eventTypes, workspacePaths, isDesc, embeddingStatuses, codegraphStatuses)
 	}
 
-	query := `
-		SELECT id, workspace_path, event_type, source_file_path, target_file_path,
-			codegraph_status, embedding_status, sync_id, file_hash, created_at, updated_at
-		FROM events
-	`
-
-	args := []interface{}{}
-	whereClause := ""
-
-	// 构造事件类型过滤条件
-	if len(eventTypes) > 0 {
-		placeholders := strings.Repeat("?,", len(eventTypes))
-		placeholders = placeholders[:len(placeholders)-1] // 移除最后一个逗号
-		whereClause = fmt.Sprintf("WHERE event_type IN (%s)", placeholders)
-		for _, eventType := range eventTypes {
-			args = append(args, eventType)
-		}
-	}
-
-	// 添加工作空间路径过滤条件
-	if len(workspacePaths) > 0 {
-		placeholders := ""
-		for i := range workspacePaths {
-			if i > 0 {
-				placeholders += ","
-			}
-			placeholders += "?"
-		}
-		if whereClause == "" {
-			whereClause = fmt.Sprintf("WHERE workspace_path IN (%s)", placeholders)
-		} else {
-			whereClause += fmt.Sprintf(" AND workspace_path IN (%s)", placeholders)
-		}
-		for _, path := range workspacePaths {
-			args = append(args, path)
-		}
-	}
-
-	// 如果提供了状态列表，添加状态过滤条件
-	if len(embeddingStatuses) > 0 {
-		placeholders := ""
-		for i := range embeddingStatuses {
-			if i > 0 {
-				placeholders += ","
-			}
-			placeholders += "?"
-		}
-		if whereClause == "" {
-			whereClause = fmt.Sprintf("WHERE embedding_status IN (%s)", placeholders)
-		} else {
-			whereClause += fmt.Sprintf(" AND embedding_status IN (%s)", placeholders)
-		}
-		for _, status := range embeddingStatuses {
-			args = append(args, status)
-		}
-	}
-
-	if len(codegraphStatuses) > 0 {
-		placeholders := ""
-		for i := range codegraphStatuses {
-			if i > 0 {
-				placeholders += ","
-			}
-			placeholders += "?"
-		}
-		if whereClause == "" {
-			whereClause = fmt.Sprintf("WHERE codegraph_status IN (%s)", placeholders)
-		} else {
-			whereClause += fmt.Sprintf(" AND codegraph_status IN (%s)", placeholders)
-		}
-		for _, status := range codegraphStatuses {
-			args = append(args, status)
-		}
-	}
+	conditions, args := buildEventFilter(eventTypes, workspacePaths, embeddingStatuses, codegraphStatuses)
 
 	// 构造排序条件
 	orderDirection := "ASC"
@@ -627,7 +675,8 @@ func (r *eventRepository) GetEventsByTypeAndStatusAndWorkspaces(eventTypes []str
 	}
 
 	// 组装完整查询
-	query = fmt.Sprintf("%s %s ORDER BY created_at %s LIMIT ?", query, whereClause, orderDirection)
+	query := fmt.Sprintf("SELECT %s FROM events %s ORDER BY created_at %s LIMIT ?",
+		eventSelectColumns, joinWhere(conditions), orderDirection)
 	args = append(args, limit)
 
 	rows, err := r.db.GetDB().Query(query, args...)
@@ -638,179 +687,80 @@ func (r *eventRepository) GetEventsByTypeAndStatusAndWorkspaces(eventTypes []str
 
 	var events []*model.Event
 	for rows.Next() {
-		var event model.Event
-		var createdAt, updatedAt time.Time
-
-		err := rows.Scan(
-			&event.ID,
-			&event.WorkspacePath,
-			&event.EventType,
-			&event.SourceFilePath,
-			&event.TargetFilePath,
-			&event.CodegraphStatus,
-			&event.EmbeddingStatus,
-			&event.SyncId,
-			&event.FileHash,
-			&createdAt,
-			&updatedAt,
-		)
-
+		event, err := scanEvent(rows)
 		if err != nil {
 			return nil, fmt.Errorf("[DB] failed to scan event row: %w", err)
 		}
-
-		event.CreatedAt = createdAt
-		event.UpdatedAt = updatedAt
-		events = append(events, &event)
+		events = append(events, event)
 	}
 
-	return events, nil
+	return events, rows.Err()
 }
 
 // getAllEventsByTypeAndStatusAndWorkspaces 获取所有符合条件的事件（分批查询）
+// 按自增ID做游标分页，避免 OFFSET 随页数增加重复扫描已读过的行；ID 与插入顺序一致
 func (r *eventRepository) getAllEventsByTypeAndStatusAndWorkspaces(eventTypes []string, workspacePaths []string,
 	isDesc bool, embeddingStatuses []int, codegraphStatuses []int) ([]*model.Event, error) {
 	const batchSize = 1000
-	var allEvents []*model.Event
-	offset := 0
-
-	// 构建基础查询条件
-	baseQuery := `
-		SELECT id, workspace_path, event_type, source_file_path, target_file_path,
-			codegraph_status, embedding_status, sync_id, file_hash, created_at, updated_at
-		FROM events
-	`
-
-	args := []interface{}{}
-	whereClause := ""
-
-	// 构造事件类型过滤条件
-	if len(eventTypes) > 0 {
-		placeholders := strings.Repeat("?,", len(eventTypes))
-		placeholders = placeholders[:len(placeholders)-1] // 移除最后一个逗号
-		whereClause = fmt.Sprintf("WHERE event_type IN (%s)", placeholders)
-		for _, eventType := range eventTypes {
-			args = append(args, eventType)
-		}
-	}
-
-	// 添加工作空间路径过滤条件
-	if len(workspacePaths) > 0 {
-		placeholders := ""
-		for i := range workspacePaths {
-			if i > 0 {
-				placeholders += ","
-			}
-			placeholders += "?"
-		}
-		if whereClause == "" {
-			whereClause = fmt.Sprintf("WHERE workspace_path IN (%s)", placeholders)
-		} else {
-			whereClause += fmt.Sprintf(" AND workspace_path IN (%s)", placeholders)
-		}
-		for _, path := range workspacePaths {
-			args = append(args, path)
-		}
-	}
-
-	// 如果提供了状态列表，添加状态过滤条件
-	if len(embeddingStatuses) > 0 {
-		placeholders := ""
-		for i := range embeddingStatuses {
-			if i > 0 {
-				placeholders += ","
-			}
-			placeholders += "?"
-		}
-		if whereClause == "" {
-			whereClause = fmt.Sprintf("WHERE embedding_status IN (%s)", placeholders)
-		} else {
-			whereClause += fmt.Sprintf(" AND embedding_status IN (%s)", placeholders)
-		}
-		for _, status := range embeddingStatuses {
-			args = append(args, status)
-		}
+	conditions, args := buildEventFilter(eventTypes, workspacePaths, embeddingStatuses, codegraphStatuses)
+	allEvents, err := r.queryEventsByCursor(conditions, args, isDesc, batchSize)
+	if err != nil {
+		return nil, err
 	}
 
-	if len(codegraphStatuses) > 0 {
-		placeholders := ""
-		for i := range codegraphStatuses {
-			if i > 0 {
-				placeholders += ","
-			}
-			placeholders += "?"
-		}
-		if whereClause == "" {
-			whereClause = fmt.Sprintf("WHERE codegraph_status IN (%s)", placeholders)
-		} else {
-			whereClause += fmt.Sprintf(" AND codegraph_status IN (%s)", placeholders)
-		}
-		for _, status := range codegraphStatuses {
-			args = append(args, status)
-		}
-	}
+	r.logger.Info("[DB] Retrieved %d events by type, status and workspaces", len(allEvents))
+	return allEvents, nil
+}
 
-	// 构造排序条件
-	orderDirection := "ASC"
+// queryEventsByCursor 按ID游标分批读取满足条件的全部事件
+func (r *eventRepository) queryEventsByCursor(conditions []string, args []interface{}, isDesc bool,
+	batchSize int) ([]*model.Event, error) {
+	orderDirection, cursorOp := "ASC", ">"
 	if isDesc {
-		orderDirection = "DESC"
+		orderDirection, cursorOp = "DESC", "<"
 	}
+	cursorConditions := append(append([]string(nil), conditions...), fmt.Sprintf("id %s ?", cursorOp))
+	firstQuery := fmt.Sprintf("SELECT %s FROM events %s ORDER BY id %s LIMIT ?",
+		eventSelectColumns, joinWhere(conditions), orderDirection)
+	nextQuery := fmt.Sprintf("SELECT %s FROM events %s ORDER BY id %s LIMIT ?",
+		eventSelectColumns, joinWhere(cursorConditions), orderDirection)
 
+	var allEvents []*model.Event
 	for {
-		// 构建分页查询
-		batchArgs := make([]interface{}, len(args))
-		copy(batchArgs, args)
-		query := fmt.Sprintf("%s %s ORDER BY created_at %s LIMIT ? OFFSET ?", baseQuery, whereClause, orderDirection)
-		batchArgs = append(batchArgs, batchSize, offset)
+		query := firstQuery
+		batchArgs := append([]interface{}(nil), args...)
+		if len(allEvents) > 0 {
+			query = nextQuery
+			batchArgs = append(batchArgs, allEvents[len(allEvents)-1].ID)
+		}
+		batchArgs = append(batchArgs, batchSize)
 
 		rows, err := r.db.GetDB().Query(query, batchArgs...)
 		if err != nil {
-			return nil, fmt.Errorf("[DB] failed to query events batch (offset %d): %w", offset, err)
+			return nil, fmt.Errorf("[DB] failed to query events batch (after %d): %w", len(allEvents), err)
 		}
 
-		var batchEvents []*model.Event
+		count := 0
 		for rows.Next() {
-			var event model.Event
-			var createdAt, updatedAt time.Time
-
-			err := rows.Scan(
-				&event.ID,
-				&event.WorkspacePath,
-				&event.EventType,
-				&event.SourceFilePath,
-				&event.TargetFilePath,
-				&event.CodegraphStatus,
-				&event.EmbeddingStatus,
-				&event.SyncId,
-				&event.FileHash,
-				&createdAt,
-				&updatedAt,
-			)
+			event, err := scanEvent(rows)
 			if err != nil {
 				rows.Close()
-				return nil, fmt.Errorf("[DB] failed to scan event row (offset %d): %w", offset, err)
+				return nil, fmt.Errorf("[DB] failed to scan event row (after %d): %w", len(allEvents), err)
 			}
-
-			event.CreatedAt = createdAt
-			event.UpdatedAt = updatedAt
-			batchEvents = append(batchEvents, &event)
+			allEvents = append(allEvents, event)
+			count++
 		}
+		err = rows.Err()
 		rows.Close()
-
-		if len(batchEvents) == 0 {
-			break
+		if err != nil {
+			return nil, fmt.Errorf("[DB] failed to iterate events batch: %w", err)
 		}
 
-		allEvents = append(allEvents, batchEvents...)
-		offset += len(batchEvents)
-
 		// 如果返回的记录数小于批次大小，说明已经查询完毕
-		if len(batchEvents) < batchSize {
+		if count < batchSize {
 			break
 		}
 	}
-
-	r.logger.Info("[DB] Retrieved %d events by type, status and workspaces", len(allEvents))
 	return allEvents, nil
 }
 
@@ -1038,63 +988,9 @@ func (r *eventRepository) GetRecentEvents(workspacePath string, limit int) ([]*m
 // GetEventsByWorkspaceForDeduplication 获取工作区内所有事件用于去重（无限制，用于内存中比较）
 func (r *eventRepository) GetEventsByWorkspaceForDeduplication(workspacePath string) ([]*model.Event, error) {
 	const batchSize = 1000
-	var allEvents []*model.Event
-	offset := 0
-
-	for {
-		query := `
-			SELECT id, workspace_path, event_type, source_file_path, target_file_path, embedding_status, codegraph_status, sync_id, file_hash, created_at, updated_at
-			FROM events
-			WHERE workspace_path = ?
-			ORDER BY created_at DESC
-			LIMIT ? OFFSET ?
-		`
-
-		rows, err := r.db.GetDB().Query(query, workspacePath, batchSize, offset)
-		if err != nil {
-			return nil, fmt.Errorf("[DB] failed to query events batch: %w", err)
-		}
-
-		var batchEvents []*model.Event
-		for rows.Next() {
-			var event model.Event
-			var createdAt, updatedAt time.Time
-
-			err := rows.Scan(
-				&event.ID,
-				&event.WorkspacePath,
-				&event.EventType,
-				&event.SourceFilePath,
-				&event.TargetFilePath,
-				&event.EmbeddingStatus,
-				&event.CodegraphStatus,
-				&event.SyncId,
-				&event.FileHash,
-				&createdAt,
-				&updatedAt,
-			)
-			if err != nil {
-				rows.Close()
-				return nil, fmt.Errorf("[DB] failed to scan event row: %w", err)
-			}
-
-			event.CreatedAt = createdAt
-			event.UpdatedAt = updatedAt
-			batchEvents = append(batchEvents, &event)
-		}
-		rows.Close()
-
-		if len(batchEvents) == 0 {
-			break
-		}
-
-		allEvents = append(allEvents, batchEvents...)
-		offset += len(batchEvents)
-
-		// 如果返回的记录数小于批次大小，说明已经查询完毕
-		if len(batchEvents) < batchSize {
-			break
-		}
+	allEvents, err := r.queryEventsByCursor([]string{"workspace_path = ?"}, []interface{}{workspacePath}, true, batchSize)
+	if err != nil {
+		return nil, err
 	}
 
 	r.logger.Info("[DB] Retrieved %d events for deduplication in workspace: %s", len(allEvents), workspacePath)
@@ -1216,36 +1112,45 @@ func (r *eventRepository) GetEventsCountByWorkspaceAndStatus(workspacePaths []st
 	return count, nil
 }
 
+// GetEventsCountGroupByWorkspace 按工作区统计满足嵌入状态和代码图状态条件的事件数
+func (r *eventRepository) GetEventsCountGroupByWorkspace(embeddingStatuses []int, codegraphStatuses []int) (map[string]int64, error) {
+	conditions, args := buildEventFilter(nil, nil, embeddingStatuses, codegraphStatuses)
+	query := fmt.Sprintf("SELECT workspace_path, COUNT(*) FROM events %s GROUP BY workspace_path", joinWhere(conditions))
+	rows, err := r.db.GetDB().Query(query, args...)
+	if err != nil {
+		return nil, fmt.Errorf("[DB] failed to count events group by workspace: %w", err)
+	}
+	defer rows.Close()
+
+	counts := make(map[string]int64)
+	for rows.Next() {
+		var workspacePath string
+		var count int64
+		if err := rows.Scan(&workspacePath, &count); err != nil {
+			return nil, fmt.Errorf("[DB] failed to scan event count: %w", err)
+		}
+		counts[workspacePath] = count
+	}
+	if err := rows.Err(); err != nil {
+		return nil, fmt.Errorf("[DB] failed to iterate event counts: %w", err)
+	}
+	return counts, nil
+}
+
 // GetLatestEventByWorkspaceAndSourcePath 根据工作区路径和源文件路径获取最新记录
 func (r *eventRepository) GetLatestEventByWorkspaceAndSourcePath(workspacePath, sourceFilePath string) (*model.Event, error) {
-	query := `
-		SELECT id, workspace_path, event_type, source_file_path, target_file_path,
-			codegraph_status, embedding_status, sync_id, file_hash, created_at, updated_at
+	query := `SELECT ` + eventSelectColumns + `
 		FROM events
 		WHERE workspace_path = ? AND source_file_path = ?
 		ORDER BY created_at DESC
 		LIMIT 1
 	`
 
-	row := r.db.GetDB().QueryRow(query, workspacePath, sourceFilePath)
-
-	var event model.Event
-	var createdAt, updatedAt time.Time
-
-	err := row.Scan(
-		&event.ID,
-		&event.WorkspacePath,
-		&event.EventType,
-		&event.SourceFilePath,
-		&event.TargetFilePath,
-		&event.CodegraphStatus,
-		&event.EmbeddingStatus,
-		&event.SyncId,
-		&event.FileHash,
-		&createdAt,
-		&updatedAt,
-	)
-
+	stmt, err := r.prepared(query)
+	if err != nil {
+		return nil, err
+	}
+	event, err := scanEvent(stmt.QueryRow(workspacePath, sourceFilePath))
 	if err != nil {
 		if err == sql.ErrNoRows {
 			r.logger.Warn("[DB] event not found, workspace: %s, sourceFilePath: %s", workspacePath, sourceFilePath)
@@ -1254,10 +1159,94 @@ func (r *eventRepository) GetLatestEventByWorkspaceAndSourcePath(workspacePath,
 		return nil, err
 	}
 
-	event.CreatedAt = createdAt
-	event.UpdatedAt = updatedAt
+	return event, nil
+}
 
-	return &event, nil
+// GetLatestEventsBySourcePaths 批量获取工作区内指定源文件路径的最新记录，按源文件路径索引
+func (r *eventRepository) GetLatestEventsBySourcePaths(workspacePath string, sourceFilePaths []string) (map[string]*model.Event, error) {
+	latest := make(map[string]*model.Event, len(sourceFilePaths))
+	for i := 0; i < len(sourceFilePaths); i += eventQueryChunkSize {
+		end := min(i+eventQueryChunkSize, len(sourceFilePaths))
+		batch := sourceFilePaths[i:end]
+
+		// 命中 (workspace_path, source_file_path, created_at) 索引，同一路径按创建时间倒序，第一条即最新
+		query := fmt.Sprintf(`SELECT %s FROM events
+			WHERE workspace_path = ? AND source_file_path IN (%s)
+			ORDER BY source_file_path, created_at DESC, id DESC`, eventSelectColumns, sqlPlaceholders(len(batch)))
+		args := make([]interface{}, 0, len(batch)+1)
+		args = append(args, workspacePath)
+		for _, path := range batch {
+			args = append(args, path)
+		}
+
+		rows, err := r.db.GetDB().Query(query, args...)
+		if err != nil {
+			return nil, fmt.Errorf("[DB] failed to query latest events by source paths: %w", err)
+		}
+		for rows.Next() {
+			event, err := scanEvent(rows)
+			if err != nil {
+				rows.Close()
+				return nil, fmt.Errorf("[DB] failed to scan event row: %w", err)
+			}
+			if _, exists := latest[event.SourceFilePath]; !exists {
+				latest[event.SourceFilePath] = event
+			}
+		}
+		err = rows.Err()
+		rows.Close()
+		if err != nil {
+			return nil, fmt.Errorf("[DB] failed to iterate latest events: %w", err)
+		}
+	}
+	return latest, nil
+}
+
+// ClaimEventsForEmbedding 领取最早的 limit 个待处理事件并置为上报中，领取与状态更新在一条语句内完成
+func (r *eventRepository) ClaimEventsForEmbedding(workspacePath string, eventTypes []string, statuses []int,
+	limit int) ([]*model.Event, error) {
+	if limit <= 0 || len(statuses) == 0 {
+		return nil, nil
+	}
+
+	conditions, filterArgs := buildEventFilter(eventTypes, []string{workspacePath}, statuses, nil)
+	query := fmt.Sprintf(`UPDATE events SET embedding_status = ?, updated_at = ?
+		WHERE id IN (SELECT id FROM events %s ORDER BY created_at ASC, id ASC LIMIT ?)
+		RETURNING %s`, joinWhere(conditions), eventSelectColumns)
+	args := make([]interface{}, 0, len(filterArgs)+3)
+	args = append(args, model.EmbeddingStatusUploading, time.Now())
+	args = append(args, filterArgs...)
+	args = append(args, limit)
+
+	rows, err := r.db.GetDB().Query(query, args...)
+	if err != nil {
+		return nil, fmt.Errorf("[DB] failed to claim events: %w", err)
+	}
+	defer rows.Close()
+
+	var events []*model.Event
+	for rows.Next() {
+		event, err := scanEvent(rows)
+		if err != nil {
+			return nil, fmt.Errorf("[DB] failed to scan claimed event: %w", err)
+		}
+		events = append(events, event)
+	}
+	if err := rows.Err(); err != nil {
+		return nil, fmt.Errorf("[DB] failed to iterate claimed events: %w", err)
+	}
+
+	// RETURNING 不保证顺序，按创建顺序返回
+	sort.Slice(events, func(i, j int) bool {
+		if !events[i].CreatedAt.Equal(events[j].CreatedAt) {
+			return events[i].CreatedAt.Before(events[j].CreatedAt)
+		}
+		return events[i].ID < events[j].ID
+	})
+	if len(events) > 0 {
+		r.logger.Info("[DB] Claimed %d events in workspace: %s", len(events), workspacePath)
+	}
+	return events, nil
 }
 
 // BatchCreateEvents 批量创建事件
@@ -1405,10 +1394,11 @@ func (r *eventRepository) BatchUpdateEvents(events []*model.Event) error {
 			WHERE id = ?
 		`
 
-		stmt, err := tx.Prepare(query)
+		cached, err := r.prepared(query)
 		if err != nil {
-			return fmt.Errorf("[DB] failed to prepare statement: %w", err)
+			return err
 		}
+		stmt := tx.Stmt(cached)
 		defer stmt.Close()
 
 		for _, event := range events {
@@ -1448,10 +1438,11 @@ func (r *eventRepository) UpdateEventsEmbedding(events []*model.Event) error {
 			WHERE id = ?
 		`
 
-		stmt, err := tx.Prepare(query)
+		cached, err := r.prepared(query)
 		if err != nil {
-			return fmt.Errorf("[DB] failed to prepare statement: %w", err)
+			return err
 		}
+		stmt := tx.Stmt(cached)
 		defer stmt.Close()
 
 		for _, event := range events {
@@ -1484,22 +1475,20 @@ func (r *eventRepository) UpdateEventsEmbeddingStatus(eventIDs []int64, status i
 	r.logger.Info("[DB] UpdateEventsEmbeddingStatus called by: %s, count: %d, status: %d", caller, len(eventIDs), status)
 
 	return database.ExecuteInTransaction(r.db, func(tx *sql.Tx) error {
-		query := `
-			UPDATE events
-			SET embedding_status = ?, updated_at = ?
-			WHERE id = ?
-		`
-
-		stmt, err := tx.Prepare(query)
-		if err != nil {
-			return fmt.Errorf("[DB] failed to prepare statement: %w", err)
-		}
-		defer stmt.Close()
-
-		for _, id := range eventIDs {
-			_, err = stmt.Exec(status, nowTime, id)
-			if err != nil {
-				return fmt.Errorf("[DB] failed to update event status for ID %d: %w", id, err)
+		// 按ID分批更新，每批一条语句
+		for i := 0; i < len(eventIDs); i += eventQueryChunkSize {
+			end := min(i+eventQueryChunkSize, len(eventIDs))
+			batch := eventIDs[i:end]
+
+			query := fmt.Sprintf("UPDATE events SET embedding_status = ?, updated_at = ? WHERE id IN (%s)",
+				sqlPlaceholders(len(batch)))
+			args := make([]interface{}, 0, len(batch)+2)
+			args = append(args, status, nowTime)
+			for _, id := range batch {
+				args = append(args, id)
+			}
+			if _, err := tx.Exec(query, args...); err != nil {
+				return fmt.Errorf("[DB] failed to update event status (batch %d-%d): %w", i+1, end, err)
 			}
 		}
 
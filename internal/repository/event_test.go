@@ -498,3 +498,121 @@ func TestEventRepository_GetEventsByWorkspaceForDeduplication(t *testing.T) {
 		assert.Equal(t, 1200, len(events))
 	})
 }
+
+func TestEventRepository_GetLatestEventsBySourcePaths(t *testing.T) {
+	dbManager, cleanup := setupTestEventDB(t)
+	defer cleanup()
+
+	logger := &mocks.MockLogger{}
+	logger.On("Info", mock.Anything, mock.Anything).Maybe().Return()
+	logger.On("Warn", mock.Anything, mock.Anything).Maybe().Return()
+	eventRepo := NewEventRepository(dbManager, logger)
+
+	workspacePath := "/path/to/workspace-latest"
+	events := []*model.Event{
+		{WorkspacePath: workspacePath, EventType: "add_file", SourceFilePath: "a.go", TargetFilePath: "a.go"},
+		{WorkspacePath: workspacePath, EventType: "modify_file", SourceFilePath: "a.go", TargetFilePath: "a.go"},
+		{WorkspacePath: workspacePath, EventType: "add_file", SourceFilePath: "b.go", TargetFilePath: "b.go"},
+		{WorkspacePath: "/other", EventType: "add_file", SourceFilePath: "c.go", TargetFilePath: "c.go"},
+	}
+	for _, event := range events {
+		require.NoError(t, eventRepo.CreateEvent(event))
+	}
+
+	latest, err := eventRepo.GetLatestEventsBySourcePaths(workspacePath, []string{"a.go", "b.go", "c.go", "d.go"})
+	require.NoError(t, err)
+	require.Len(t, latest, 2)
+	assert.Equal(t, events[1].ID, latest["a.go"].ID)
+	assert.Equal(t, "modify_file", latest["a.go"].EventType)
+	assert.Equal(t, events[2].ID, latest["b.go"].ID)
+
+	latest, err = eventRepo.GetLatestEventsBySourcePaths(workspacePath, nil)
+	require.NoError(t, err)
+	assert.Empty(t, latest)
+}
+
+func TestEventRepository_ClaimEventsForEmbedding(t *testing.T) {
+	dbManager, cleanup := setupTestEventDB(t)
+	defer cleanup()
+
+	logger := &mocks.MockLogger{}
+	logger.On("Info", mock.Anything, mock.Anything).Maybe().Return()
+	eventRepo := NewEventRepository(dbManager, logger)
+
+	workspacePath := "/path/to/workspace-claim"
+	var events []*model.Event
+	for i := 0; i < 5; i++ {
+		events = append(events, &model.Event{
+			WorkspacePath:   workspacePath,
+			EventType:       model.EventTypeAddFile,
+			SourceFilePath:  fmt.Sprintf("file%d.go", i),
+			EmbeddingStatus: model.EmbeddingStatusInit,
+		})
+	}
+	events = append(events, &model.Event{
+		WorkspacePath:   workspacePath,
+		EventType:       model.EventTypeDeleteFile,
+		SourceFilePath:  "deleted.go",
+		EmbeddingStatus: model.EmbeddingStatusInit,
+	})
+	require.NoError(t, eventRepo.BatchCreateEvents(events))
+
+	eventTypes := []string{model.EventTypeAddFile, model.EventTypeModifyFile}
+	statuses := []int{model.EmbeddingStatusInit, model.EmbeddingStatusUploadFailed}
+
+	claimed, err := eventRepo.ClaimEventsForEmbedding(workspacePath, eventTypes, statuses, 3)
+	require.NoError(t, err)
+	require.Len(t, claimed, 3)
+	for i, event := range claimed {
+		assert.Equal(t, events[i].ID, event.ID)
+		assert.Equal(t, model.EmbeddingStatusUploading, event.EmbeddingStatus)
+	}
+
+	// 已领取的事件不会被再次领取
+	claimed, err = eventRepo.ClaimEventsForEmbedding(workspacePath, eventTypes, statuses, 3)
+	require.NoError(t, err)
+	require.Len(t, claimed, 2)
+	assert.Equal(t, events[3].ID, claimed[0].ID)
+	assert.Equal(t, events[4].ID, claimed[1].ID)
+
+	claimed, err = eventRepo.ClaimEventsForEmbedding(workspacePath, eventTypes, statuses, 3)
+	require.NoError(t, err)
+	assert.Empty(t, claimed)
+
+	// 退回后可以重新领取
+	require.NoError(t, eventRepo.UpdateEventsEmbeddingStatus([]int64{events[0].ID}, model.EmbeddingStatusUploadFailed))
+	claimed, err = eventRepo.ClaimEventsForEmbedding(workspacePath, eventTypes, statuses, 3)
+	require.NoError(t, err)
+	require.Len(t, claimed, 1)
+	assert.Equal(t, events[0].ID, claimed[0].ID)
+
+	deleted, err := eventRepo.GetEventByID(events[5].ID)
+	require.NoError(t, err)
+	assert.Equal(t, model.EmbeddingStatusInit, deleted.EmbeddingStatus)
+}
+
+func TestEventRepository_GetEventsCountGroupByWorkspace(t *testing.T) {
+	dbManager, cleanup := setupTestEventDB(t)
+	defer cleanup()
+
+	logger := &mocks.MockLogger{}
+	logger.On("Info", mock.Anything, mock.Anything).Maybe().Return()
+	eventRepo := NewEventRepository(dbManager, logger)
+
+	require.NoError(t, eventRepo.BatchCreateEvents([]*model.Event{
+		{WorkspacePath: "/ws-a", EventType: model.EventTypeAddFile, SourceFilePath: "a.go",
+			EmbeddingStatus: model.EmbeddingStatusInit, CodegraphStatus: model.CodegraphStatusInit},
+		{WorkspacePath: "/ws-a", EventType: model.EventTypeAddFile, SourceFilePath: "b.go",
+			EmbeddingStatus: model.EmbeddingStatusSuccess, CodegraphStatus: model.CodegraphStatusInit},
+		{WorkspacePath: "/ws-b", EventType: model.EventTypeAddFile, SourceFilePath: "c.go",
+			EmbeddingStatus: model.EmbeddingStatusInit, CodegraphStatus: model.CodegraphStatusSuccess},
+	}))
+
+	counts, err := eventRepo.GetEventsCountGroupByWorkspace([]int{model.EmbeddingStatusInit}, nil)
+	require.NoError(t, err)
+	assert.Equal(t, map[string]int64{"/ws-a": 1, "/ws-b": 1}, counts)
+
+	counts, err = eventRepo.GetEventsCountGroupByWorkspace(nil, []int{model.CodegraphStatusInit})
+	require.NoError(t, err)
+	assert.Equal(t, map[string]int64{"/ws-a": 2}, counts)
+}
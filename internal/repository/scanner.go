@@ -3,20 +3,23 @@ package repository
 
 import (
 	"bytes"
+	"context"
 	"fmt"
 	"io/fs"
 	"maps"
 	"os"
 	"path/filepath"
-	"strconv"
+	"slices"
 	"strings"
 	"sync"
+	"sync/atomic"
 	"time"
 
 	"codebase-indexer/internal/config"
 	"codebase-indexer/internal/utils"
 	"codebase-indexer/pkg/codegraph/lang"
 	"codebase-indexer/pkg/codegraph/types"
+	codegraphutils "codebase-indexer/pkg/codegraph/utils"
 	"codebase-indexer/pkg/logger"
 
 	gitignore "github.com/sabhiram/go-gitignore"
@@ -30,6 +33,7 @@ type ScannerInterface interface {
 	LoadFolderIgnoreRules(codebasePath string) *gitignore.GitIgnore
 	LoadIncludeFiles() []string
 	ScanCodebase(ignoreConfig *config.IgnoreConfig, codebasePath string) (map[string]string, error)
+	ScanCodebaseTree(ignoreConfig *config.IgnoreConfig, codebasePath string, previous *utils.FileTree) (*utils.FileTree, error)
 	ScanFilePaths(codebasePath string, filePaths []string) (map[string]string, error)
 	ScanDirectory(codebasePath, dirPath string) (map[string]string, error)
 	ScanFile(codebasePath, filePath string) (string, error)
@@ -41,6 +45,35 @@ type FileScanner struct {
 	scannerConfig *config.ScannerConfig
 	logger        logger.Logger
 	rwMutex       sync.RWMutex
+	trees         sync.Map      // codebasePath -> 上次扫描的 *utils.FileTree，用于复用文件哈希
+	ignoreRules   sync.Map      // codebasePath -> *ignoreRulesCache
+	configGen     atomic.Uint64 // 扫描配置版本，配置变化后缓存的规则失效
+
+	includeMu    sync.Mutex
+	includeGen   uint64
+	includeFiles []string
+	includeExts  map[string]struct{}
+}
+
+// ignoreRulesCache 编译后的忽略规则，.gitignore/.coignore 的修改时间和大小不变时复用
+type ignoreRulesCache struct {
+	generation uint64
+	gitignore  ignoreFileStamp
+	coignore   ignoreFileStamp
+	rules      *gitignore.GitIgnore
+}
+
+type ignoreFileStamp struct {
+	modTime int64
+	size    int64 // 文件不存在时为 -1
+}
+
+func statIgnoreFile(path string) ignoreFileStamp {
+	info, err := os.Stat(path)
+	if err != nil {
+		return ignoreFileStamp{size: -1}
+	}
+	return ignoreFileStamp{modTime: info.ModTime().UnixNano(), size: info.Size()}
 }
 
 func NewFileScanner(logger logger.Logger) ScannerInterface {
@@ -67,6 +100,7 @@ func (s *FileScanner) SetScannerConfig(config *config.ScannerConfig) {
 	}
 	s.rwMutex.Lock()
 	defer s.rwMutex.Unlock()
+	defer s.configGen.Add(1)
 	if len(config.FolderIgnorePatterns) > 0 {
 		s.scannerConfig.FolderIgnorePatterns = config.FolderIgnorePatterns
 	}
@@ -90,9 +124,11 @@ func (s *FileScanner) GetScannerConfig() *config.ScannerConfig {
 
 // LoadIgnoreConfig loads the ignore config
 func (s *FileScanner) LoadIgnoreConfig(codebasePath string) *config.IgnoreConfig {
+	includeFiles, includeExts := s.loadIncludeSet()
 	return &config.IgnoreConfig{
 		IgnoreRules:  s.LoadIgnoreRules(codebasePath),
-		IncludeRules: s.LoadIncludeFiles(),
+		IncludeRules: includeFiles,
+		IncludeExts:  includeExts,
 		MaxFileCount: s.scannerConfig.MaxFileCount,
 		MaxFileSize:  s.scannerConfig.MaxFileSizeKB,
 	}
@@ -108,8 +144,7 @@ func (s *FileScanner) CheckIgnoreFile(ignoreConfig *config.IgnoreConfig, codebas
 	if ignoreRules == nil {
 		return false, fmt.Errorf("ignore rules not loaded")
 	}
-	includeRules := ignoreConfig.IncludeRules
-	fileIncludeMap := utils.StringSlice2Map(includeRules)
+	fileIncludeMap := includeExtsOf(ignoreConfig)
 
 	filePath := fileInfo.Path
 	relPath, err := filepath.Rel(codebasePath, filePath)
@@ -155,10 +190,21 @@ func (s *FileScanner) CheckIgnoreFile(ignoreConfig *config.IgnoreConfig, codebas
 }
 
 // LoadIgnoreRules Load and combine default ignore rules with .gitignore rules
+// The compiled rules are cached per codebase until the ignore files or scanner config change
 func (s *FileScanner) LoadIgnoreRules(codebasePath string) *gitignore.GitIgnore {
+	generation := s.configGen.Load()
+	gitignoreStamp := statIgnoreFile(filepath.Join(codebasePath, ".gitignore"))
+	coignoreStamp := statIgnoreFile(filepath.Join(codebasePath, ".coignore"))
+	if cached, ok := s.ignoreRules.Load(codebasePath); ok {
+		c := cached.(*ignoreRulesCache)
+		if c.generation == generation && c.gitignore == gitignoreStamp && c.coignore == coignoreStamp {
+			return c.rules
+		}
+	}
+
 	// First create ignore object with default rules
 	// fileIngoreRules := s.scannerConfig.FileIgnorePatterns
-	currentIgnoreRules := s.scannerConfig.FolderIgnorePatterns
+	currentIgnoreRules := slices.Clone(s.scannerConfig.FolderIgnorePatterns)
 
 	// Read and merge .gitignore file
 	gitignoreRules := s.loadGitignore(codebasePath)
@@ -181,6 +227,12 @@ func (s *FileScanner) LoadIgnoreRules(codebasePath string) *gitignore.GitIgnore
 	}
 
 	compiledIgnore := gitignore.CompileIgnoreLines(uniqueRules...)
+	s.ignoreRules.Store(codebasePath, &ignoreRulesCache{
+		generation: generation,
+		gitignore:  gitignoreStamp,
+		coignore:   coignoreStamp,
+		rules:      compiledIgnore,
+	})
 
 	return compiledIgnore
 }
@@ -270,120 +322,168 @@ func (s *FileScanner) loadCoignore(codebasePath string) []string {
 	return ignores
 }
 
-// LoadIncludeFiles returns the list of file extensions to include during scanning
+// LoadIncludeFiles returns the list of file extensions to include during scanning.
+// The returned slice is shared and must not be modified
 func (s *FileScanner) LoadIncludeFiles() []string {
-	includeFiles := s.scannerConfig.FileIncludePatterns
+	includeFiles, _ := s.loadIncludeSet()
+	return includeFiles
+}
 
+// loadIncludeSet 返回包含的扩展名列表及其查找表，扫描配置不变时复用
+func (s *FileScanner) loadIncludeSet() ([]string, map[string]struct{}) {
+	generation := s.configGen.Load()
+	s.includeMu.Lock()
+	defer s.includeMu.Unlock()
+	if s.includeFiles != nil && s.includeGen == generation {
+		return s.includeFiles, s.includeExts
+	}
+
+	includeFiles := slices.Clone(s.scannerConfig.FileIncludePatterns)
 	treeSitterParsers := lang.GetTreeSitterParsers()
 	for _, l := range treeSitterParsers {
-		if len(includeFiles) == 0 {
-			includeFiles = l.SupportedExts
-		} else {
-			includeFiles = append(includeFiles, l.SupportedExts...)
-		}
+		includeFiles = append(includeFiles, l.SupportedExts...)
 	}
+	if includeFiles == nil {
+		includeFiles = []string{}
+	}
+	s.includeGen = generation
+	s.includeFiles = includeFiles
+	s.includeExts = utils.StringSlice2Map(includeFiles)
+	return s.includeFiles, s.includeExts
+}
 
-	return includeFiles
+// includeExtsOf 忽略配置中的扩展名查找表，未预先构建时临时构建
+func includeExtsOf(ignoreConfig *config.IgnoreConfig) map[string]struct{} {
+	if ignoreConfig.IncludeExts != nil {
+		return ignoreConfig.IncludeExts
+	}
+	return utils.StringSlice2Map(ignoreConfig.IncludeRules)
 }
 
 // ScanCodebase scans codebase directory and generates hash tree
 func (s *FileScanner) ScanCodebase(ignoreConfig *config.IgnoreConfig, codebasePath string) (map[string]string, error) {
+	tree, err := s.ScanCodebaseTree(ignoreConfig, codebasePath, s.cachedTree(codebasePath))
+	if err != nil {
+		return make(map[string]string), err
+	}
+	return tree.FileHashes(), nil
+}
+
+// ScanCodebaseTree scans codebase directory and builds file tree.
+// Files whose mtime and size match the previous tree reuse its content hash
+func (s *FileScanner) ScanCodebaseTree(ignoreConfig *config.IgnoreConfig, codebasePath string,
+	previous *utils.FileTree) (*utils.FileTree, error) {
 	s.logger.Info("starting codebase scan: %s", codebasePath)
 	startTime := time.Now()
 
-	hashTree := make(map[string]string)
-	var filesScanned int
+	tree := utils.NewFileTree()
 
 	if ignoreConfig == nil || codebasePath == "" {
-		return hashTree, fmt.Errorf("ignoreConfig or codebasePath is nil")
+		return tree, fmt.Errorf("ignoreConfig or codebasePath is nil")
 	}
 	ignore := ignoreConfig.IgnoreRules
-	fileInclude := ignoreConfig.IncludeRules
-	fileIncludeMap := utils.StringSlice2Map(fileInclude)
+	fileIncludeMap := includeExtsOf(ignoreConfig)
 	maxFileSizeKB := ignoreConfig.MaxFileSize
 	maxFileSize := int64(maxFileSizeKB * 1024)
 	maxFileCount := ignoreConfig.MaxFileCount
 
-	err := filepath.WalkDir(codebasePath, func(path string, d fs.DirEntry, err error) error {
-		if err != nil {
-			s.logger.Warn("error accessing file %s: %v", path, err)
-			return nil // Continue scanning other files
-		}
-
-		// Calculate relative path
-		relPath, err := filepath.Rel(codebasePath, path)
-		if err != nil {
-			s.logger.Warn("failed to get relative path for file %s: %v", path, err)
-			return nil
-		}
-
-		if d.IsDir() {
+	var mu sync.Mutex
+	var filesScanned, filesHashed int
+	var limitReached bool
+	err := codegraphutils.ParallelWalk(context.Background(), codebasePath, codegraphutils.ParallelWalkOptions{
+		VisitDir: func(entry codegraphutils.WalkEntry) error {
 			// For directories, check if we should skip entire dir
-			// Don't skip root dir (relPath=".") due to ".*" rules
-			if relPath != "." && ignore != nil && ignore.MatchesPath(relPath+"/") {
-				s.logger.Debug("skipping ignored directory: %s", relPath)
-				return fs.SkipDir
+			if ignore != nil && ignore.MatchesPath(entry.RelPath+"/") {
+				s.logger.Debug("skipping ignored directory: %s", entry.RelPath)
+				return filepath.SkipDir
 			}
 			return nil
-		}
+		},
+		VisitFile: func(entry codegraphutils.WalkEntry) error {
+			relPath := entry.RelPath
+			// Check if file is excluded by ignore
+			if ignore != nil && ignore.MatchesPath(relPath) {
+				s.logger.Debug("skipping file excluded by ignore: %s", relPath)
+				return nil
+			}
 
-		// Check if file is excluded by ignore
-		if ignore != nil && ignore.MatchesPath(relPath) {
-			s.logger.Debug("skipping file excluded by ignore: %s", relPath)
-			return nil
-		}
+			// Verify file extension is supported before stat
+			if len(fileIncludeMap) > 0 {
+				if _, ok := fileIncludeMap[filepath.Ext(relPath)]; !ok {
+					s.logger.Debug("skipping file with unsupported extension: %s", relPath)
+					return nil
+				}
+			}
 
-		info, err := d.Info()
-		if err != nil {
-			s.logger.Warn("error getting file info for %s: %v", path, err)
-			return nil
-		}
+			info, err := entry.Entry.Info()
+			if err != nil {
+				s.logger.Warn("error getting file info for %s: %v", entry.Path, err)
+				return nil
+			}
 
-		// Verify file size doesn't exceed max limit
-		if info.Size() >= maxFileSize {
-			s.logger.Debug("skipping file larger than %dKB: %s (size: %.2f KB)", maxFileSizeKB, relPath, float64(info.Size())/1024)
-			return nil
-		}
+			// Verify file size doesn't exceed max limit
+			if info.Size() >= maxFileSize {
+				s.logger.Debug("skipping file larger than %dKB: %s (size: %.2f KB)", maxFileSizeKB, relPath, float64(info.Size())/1024)
+				return nil
+			}
 
-		// Verify file extension is supported
-		if len(fileIncludeMap) > 0 {
-			fileExt := filepath.Ext(path)
-			if _, ok := fileIncludeMap[fileExt]; !ok {
-				s.logger.Debug("skipping file with unsupported extension: %s", relPath)
+			// Calculate file hash
+			hash, hashed, err := fileHash(previous, relPath, entry.Path, info)
+			if err != nil {
+				s.logger.Warn("error calculating hash for file %s: %v", entry.Path, err)
 				return nil
 			}
-		}
 
-		// Calculate file hash
-		hash, err := utils.CalculateFileTimestamp(path)
-		if err != nil {
-			s.logger.Warn("error calculating hash for file %s: %v", path, err)
+			mu.Lock()
+			defer mu.Unlock()
+			if filesScanned >= maxFileCount {
+				limitReached = true
+				return filepath.SkipAll
+			}
+			filesScanned++
+			if hashed {
+				filesHashed++
+			}
+			tree.Add(relPath, info.ModTime().UnixMilli(), info.Size(), hash)
 			return nil
-		}
-
-		filesScanned++
-		if filesScanned > maxFileCount {
-			return fmt.Errorf("reached maximum file count limit: %d", filesScanned)
-		}
-
-		hashTree[relPath] = strconv.FormatInt(hash, 10)
-
-		return nil
+		},
+		OnError: func(path string, err error) error {
+			s.logger.Warn("error accessing file %s: %v", path, err)
+			return nil // Continue scanning other files
+		},
 	})
-
 	if err != nil {
-		// 检查是否是达到文件数上限的错误
-		if err.Error() == fmt.Sprintf("reached maximum file count limit: %d", filesScanned) {
-			s.logger.Warn("reached maximum file count limit: %d, stopping scan, time taken: %v", filesScanned, time.Since(startTime))
-			return hashTree, nil
-		}
 		return nil, fmt.Errorf("failed to scan codebase: %v", err)
 	}
+	tree.Seal()
+	s.trees.Store(codebasePath, tree)
 
-	s.logger.Info("codebase scan completed, %d files scanned, time taken: %v",
-		filesScanned, time.Since(startTime))
+	if limitReached {
+		s.logger.Warn("reached maximum file count limit: %d, stopping scan, time taken: %v", filesScanned, time.Since(startTime))
+		return tree, nil
+	}
+	s.logger.Info("codebase scan completed, %d files scanned, %d files hashed, time taken: %v",
+		filesScanned, filesHashed, time.Since(startTime))
 
-	return hashTree, nil
+	return tree, nil
+}
+
+// cachedTree 返回该代码库上次扫描的文件树，没有时返回 nil
+func (s *FileScanner) cachedTree(codebasePath string) *utils.FileTree {
+	if tree, ok := s.trees.Load(codebasePath); ok {
+		return tree.(*utils.FileTree)
+	}
+	return nil
+}
+
+// fileHash 修改时间和大小与上次扫描一致时复用内容哈希，否则读取文件计算。hashed 表示是否读取了文件
+func fileHash(previous *utils.FileTree, relPath, path string, info fs.FileInfo) (hash uint64, hashed bool, err error) {
+	if node := previous.Lookup(relPath); node != nil && !node.IsDir &&
+		node.ModTime == info.ModTime().UnixMilli() && node.Size == info.Size() {
+		return node.Hash, false, nil
+	}
+	hash, err = utils.HashFileContent(path)
+	return hash, err == nil, err
 }
 
 // ScanFilePaths scans file paths and generates hash tree
@@ -433,88 +533,95 @@ func (s *FileScanner) ScanDirectory(codebasePath, dirPath string) (map[string]st
 	startTime := time.Now()
 
 	hashTree := make(map[string]string)
-	var filesScanned int
 
 	ignore := s.LoadIgnoreRules(codebasePath)
-	fileInclude := s.LoadIncludeFiles()
-	fileIncludeMap := utils.StringSlice2Map(fileInclude)
-
+	_, fileIncludeMap := s.loadIncludeSet()
 	maxFileSizeKB := s.scannerConfig.MaxFileSizeKB
 	maxFileSize := int64(maxFileSizeKB * 1024)
-	err := filepath.WalkDir(dirPath, func(path string, d fs.DirEntry, err error) error {
-		if err != nil {
-			s.logger.Warn("error accessing file %s: %v", path, err)
-			return nil // Continue scanning other files
-		}
+	maxFileCount := s.scannerConfig.MaxFileCount
+	previous := s.cachedTree(codebasePath)
 
-		// Calculate relative path
-		relPath, err := filepath.Rel(codebasePath, path)
-		if err != nil {
-			s.logger.Warn("failed to get relative path for file %s: %v", path, err)
-			return nil
+	dirRelPath, err := filepath.Rel(codebasePath, dirPath)
+	if err != nil {
+		return nil, fmt.Errorf("failed to get relative path: %v", err)
+	}
+	codebaseRelPath := func(relPath string) string {
+		if dirRelPath == "." {
+			return relPath
 		}
+		return filepath.Join(dirRelPath, relPath)
+	}
 
-		if d.IsDir() {
+	var mu sync.Mutex
+	var filesScanned int
+	var limitReached bool
+	err = codegraphutils.ParallelWalk(context.Background(), dirPath, codegraphutils.ParallelWalkOptions{
+		VisitDir: func(entry codegraphutils.WalkEntry) error {
 			// For directories, check if we should skip entire dir
-			// Don't skip root dir (relPath=".") due to ".*" rules
-			if relPath != "." && ignore != nil && ignore.MatchesPath(relPath+"/") {
+			relPath := codebaseRelPath(entry.RelPath)
+			if ignore != nil && ignore.MatchesPath(relPath+"/") {
 				s.logger.Debug("skipping ignored directory: %s", relPath)
-				return fs.SkipDir
+				return filepath.SkipDir
 			}
 			return nil
-		}
+		},
+		VisitFile: func(entry codegraphutils.WalkEntry) error {
+			relPath := codebaseRelPath(entry.RelPath)
+			// Check if file is excluded by ignore
+			if ignore != nil && ignore.MatchesPath(relPath) {
+				s.logger.Debug("skipping file excluded by ignore: %s", relPath)
+				return nil
+			}
 
-		// Check if file is excluded by ignore
-		if ignore != nil && ignore.MatchesPath(relPath) {
-			s.logger.Debug("skipping file excluded by ignore: %s", relPath)
-			return nil
-		}
+			if len(fileIncludeMap) > 0 {
+				if _, ok := fileIncludeMap[filepath.Ext(relPath)]; !ok {
+					s.logger.Debug("skipping file not included: %s", relPath)
+					return nil
+				}
+			}
 
-		info, err := d.Info()
-		if err != nil {
-			s.logger.Warn("error getting file info for %s: %v", path, err)
-			return nil
-		}
+			info, err := entry.Entry.Info()
+			if err != nil {
+				s.logger.Warn("error getting file info for %s: %v", entry.Path, err)
+				return nil
+			}
 
-		// Verify file size doesn't exceed max limit
-		if info.Size() >= maxFileSize {
-			s.logger.Debug("skipping file larger than %dKB: %s (size: %.2f KB)", maxFileSizeKB, relPath, float64(info.Size())/1024)
-			return nil
-		}
+			// Verify file size doesn't exceed max limit
+			if info.Size() >= maxFileSize {
+				s.logger.Debug("skipping file larger than %dKB: %s (size: %.2f KB)", maxFileSizeKB, relPath, float64(info.Size())/1024)
+				return nil
+			}
 
-		if len(fileIncludeMap) > 0 {
-			if _, ok := fileIncludeMap[relPath]; !ok {
-				s.logger.Debug("skipping file not included: %s", relPath)
+			// Calculate file hash
+			hash, _, err := fileHash(previous, relPath, entry.Path, info)
+			if err != nil {
+				s.logger.Warn("error calculating hash for file %s: %v", entry.Path, err)
 				return nil
 			}
-		}
 
-		// Calculate file hash
-		hash, err := utils.CalculateFileTimestamp(path)
-		if err != nil {
-			s.logger.Warn("error calculating hash for file %s: %v", path, err)
+			mu.Lock()
+			defer mu.Unlock()
+			if filesScanned >= maxFileCount {
+				limitReached = true
+				return filepath.SkipAll
+			}
+			filesScanned++
+			hashTree[relPath] = utils.FormatFileHash(hash)
 			return nil
-		}
-
-		filesScanned++
-		if filesScanned > s.scannerConfig.MaxFileCount {
-			return fmt.Errorf("reached maximum file count limit: %d", filesScanned)
-		}
-
-		hashTree[relPath] = strconv.FormatInt(hash, 10)
-
-		return nil
+		},
+		OnError: func(path string, err error) error {
+			s.logger.Warn("error accessing file %s: %v", path, err)
+			return nil // Continue scanning other files
+		},
 	})
-
 	if err != nil {
-		// 检查是否是达到文件数上限的错误
-		if err.Error() == fmt.Sprintf("reached maximum file count limit: %d", filesScanned) {
-			s.logger.Warn("reached maximum file count limit: %d, stopping scan, time taken: %v", filesScanned, time.Since(startTime))
-			return hashTree, nil
-		}
 		return nil, fmt.Errorf("failed to scan directory: %v", err)
 	}
 
+	if limitReached {
+		s.logger.Warn("reached maximum file count limit: %d, stopping scan, time taken: %v", filesScanned, time.Since(startTime))
+		return hashTree, nil
+	}
 	s.logger.Info("directory scan completed, %d files scanned, time taken: %v",
 		filesScanned, time.Since(startTime))
 
@@ -528,8 +635,7 @@ func (s *FileScanner) ScanFile(codebasePath, filePath string) (string, error) {
 
 	// fileIgnore := s.LoadFileIgnoreRules(codebasePath)
 	ignore := s.LoadIgnoreRules(codebasePath)
-	fileInclude := s.LoadIncludeFiles()
-	fileIncludeMap := utils.StringSlice2Map(fileInclude)
+	_, fileIncludeMap := s.loadIncludeSet()
 	maxFileSizeKB := s.scannerConfig.MaxFileSizeKB
 	maxFileSize := int64(maxFileSizeKB * 1024)
 	relPath, err := filepath.Rel(codebasePath, filePath)
@@ -547,11 +653,11 @@ func (s *FileScanner) ScanFile(codebasePath, filePath string) (string, error) {
 		return "", fmt.Errorf("file larger than %dKB(size: %.2f KB)", maxFileSizeKB, float64(info.Size())/1024)
 	}
 	if len(fileIncludeMap) > 0 {
-		if _, ok := fileIncludeMap[relPath]; !ok {
+		if _, ok := fileIncludeMap[filepath.Ext(relPath)]; !ok {
 			return "", fmt.Errorf("file not included: %s", relPath)
 		}
 	}
-	hash, err := utils.CalculateFileTimestamp(filePath)
+	hash, _, err := fileHash(s.cachedTree(codebasePath), relPath, filePath, info)
 	if err != nil {
 		return "", fmt.Errorf("failed to scan file: %v", err)
 	}
@@ -559,5 +665,5 @@ func (s *FileScanner) ScanFile(codebasePath, filePath string) (string, error) {
 	s.logger.Info("file scan completed, time taken: %v",
 		time.Since(startTime))
 
-	return strconv.FormatInt(hash, 10), nil
+	return utils.FormatFileHash(hash), nil
 }
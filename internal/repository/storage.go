@@ -23,8 +23,13 @@ type StorageInterface interface {
 	DeleteCodebaseConfig(codebaseId string) error
 	GetCodebaseEnv() *config.CodebaseEnv
 	SaveCodebaseEnv(codebaseEnv *config.CodebaseEnv) error
+	GetFileTree(codebaseId string) (*utils.FileTree, error)
+	SaveFileTree(codebaseId string, tree *utils.FileTree) error
 }
 
+// fileTreeDir 文件树目录，位于配置目录下，加载配置时会跳过子目录
+const fileTreeDir = "trees"
+
 type StorageManager struct {
 	codebasePath    string
 	codebaseConfigs map[string]*config.CodebaseConfig // Stores all codebase configurations
@@ -219,7 +224,7 @@ func (s *StorageManager) SaveCodebaseConfig(config *config.CodebaseConfig) error
 	s.rwMutex.Lock()
 	defer s.rwMutex.Unlock()
 
-	data, err := json.MarshalIndent(config, "", "  ")
+	data, err := json.Marshal(config)
 	if err != nil {
 		return fmt.Errorf("failed to serialize config: %v", err)
 	}
@@ -257,6 +262,9 @@ func (s *StorageManager) DeleteCodebaseConfig(codebaseId string) error {
 	if err := os.Remove(filePath); err != nil {
 		return fmt.Errorf("failed to delete codebase file: %v", err)
 	}
+	if err := os.Remove(s.fileTreePath(codebaseId)); err != nil && !os.IsNotExist(err) {
+		s.logger.Warn("failed to delete file tree of codebase %s: %v", codebaseId, err)
+	}
 
 	// Only delete in-memory config after file deletion succeeds
 	if exists {
@@ -267,3 +275,50 @@ func (s *StorageManager) DeleteCodebaseConfig(codebaseId string) error {
 	}
 	return nil
 }
+
+func (s *StorageManager) fileTreePath(codebaseId string) string {
+	return filepath.Join(s.codebasePath, fileTreeDir, codebaseId)
+}
+
+// GetFileTree 读取上次扫描保存的文件树，不存在时返回 nil
+func (s *StorageManager) GetFileTree(codebaseId string) (*utils.FileTree, error) {
+	file, err := os.Open(s.fileTreePath(codebaseId))
+	if err != nil {
+		if os.IsNotExist(err) {
+			return nil, nil
+		}
+		return nil, fmt.Errorf("failed to open file tree: %v", err)
+	}
+	defer file.Close()
+	return utils.ReadFileTree(file)
+}
+
+// SaveFileTree 保存文件树，先写临时文件再重命名，避免中断时留下不完整的文件
+func (s *StorageManager) SaveFileTree(codebaseId string, tree *utils.FileTree) error {
+	if tree == nil {
+		return fmt.Errorf("file tree is empty")
+	}
+	dir := filepath.Join(s.codebasePath, fileTreeDir)
+	if err := os.MkdirAll(dir, 0755); err != nil {
+		return fmt.Errorf("failed to create file tree directory: %v", err)
+	}
+	file, err := os.CreateTemp(dir, codebaseId+".*.tmp")
+	if err != nil {
+		return fmt.Errorf("failed to create file tree file: %v", err)
+	}
+	tmpPath := file.Name()
+	if _, err = tree.WriteTo(file); err != nil {
+		file.Close()
+		os.Remove(tmpPath)
+		return fmt.Errorf("failed to write file tree: %v", err)
+	}
+	if err = file.Close(); err != nil {
+		os.Remove(tmpPath)
+		return fmt.Errorf("failed to write file tree: %v", err)
+	}
+	if err = os.Rename(tmpPath, s.fileTreePath(codebaseId)); err != nil {
+		os.Remove(tmpPath)
+		return fmt.Errorf("failed to save file tree: %v", err)
+	}
+	return nil
+}
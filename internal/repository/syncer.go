@@ -34,6 +34,7 @@ type SyncInterface interface {
 	GetSyncConfig() *config.SyncConfig
 	FetchServerHashTree(codebasePath string) (map[string]string, error)
 	UploadFile(filePath string, uploadReq dto.UploadReq) error
+	UploadStream(body utils.UploadBody, uploadReq dto.UploadReq) error
 	GetClientConfig() (config.ClientConfig, error)
 	FetchUploadToken(req dto.UploadTokenReq) (*dto.UploadTokenResp, error)
 	FetchFileStatus(req dto.FileStatusReq) (*dto.FileStatusResp, error)
@@ -234,6 +235,84 @@ func (hs *HTTPSync) UploadFile(filePath string, uploadReq dto.UploadReq) error {
 	return nil
 }
 
+// UploadStream 边生成边上传文件内容，multipart 请求体通过管道以分块传输发送
+func (hs *HTTPSync) UploadStream(body utils.UploadBody, uploadReq dto.UploadReq) error {
+	hs.logger.Info("uploading stream: %s", body.FileName)
+
+	// 验证配置
+	authInfo := config.GetAuthInfo()
+	if err := hs.ValidateSyncConfig(authInfo); err != nil {
+		return err
+	}
+
+	timeout := body.Timeout
+	if timeout <= 0 {
+		timeout = hs.calculateTimeout(body.Size)
+	}
+
+	pipeReader, pipeWriter := io.Pipe()
+	writer := multipart.NewWriter(pipeWriter)
+	counter := &writeCounter{}
+	writeDone := make(chan struct{})
+	go func() {
+		defer close(writeDone)
+		pipeWriter.CloseWithError(writeMultipartStream(writer, body, counter, uploadReq))
+	}()
+
+	startTime := time.Now()
+	url := fmt.Sprintf("%s%s", authInfo.ServerURL, API_UPLOAD_FILE)
+	httpReq := &utils.HTTPRequest{
+		Method:      "POST",
+		URL:         url,
+		Timeout:     timeout,
+		ContentType: writer.FormDataContentType(),
+		Headers: map[string]string{
+			"X-Request-ID": uploadReq.RequestId,
+		},
+	}
+	hs.logger.Info("sending HTTP %s request to: %s", "POST", url)
+	resp, err := hs.httpClient.DoStreamRequest(httpReq, pipeReader, -1, authInfo.Token)
+	// 请求提前结束时让写入方退出
+	pipeReader.CloseWithError(io.ErrClosedPipe)
+	<-writeDone
+
+	duration := time.Since(startTime)
+	hs.logger.Info("upload stats - stream: %s, uploaded: %d bytes, duration: %v, speed: %.2f KB/s",
+		body.FileName, counter.n, duration, float64(counter.n)/1024/duration.Seconds())
+	if err != nil {
+		return err
+	}
+	if resp.StatusCode < 200 || resp.StatusCode >= 300 {
+		return fmt.Errorf("upload failed, status: %d, response: %s", resp.StatusCode, string(resp.Body))
+	}
+
+	hs.logger.Info("stream uploaded successfully: %s", body.FileName)
+	return nil
+}
+
+// writeMultipartStream 写入文件字段和普通字段
+func writeMultipartStream(writer *multipart.Writer, body utils.UploadBody, counter *writeCounter, uploadReq dto.UploadReq) error {
+	part, err := writer.CreateFormFile("file", body.FileName)
+	if err != nil {
+		return fmt.Errorf("failed to create form file: %v", err)
+	}
+	if err := body.Write(io.MultiWriter(part, counter)); err != nil {
+		return fmt.Errorf("failed to write file content: %v", err)
+	}
+	fields := [][2]string{
+		{"clientId", uploadReq.ClientId},
+		{"codebasePath", uploadReq.CodebasePath},
+		{"codebaseName", uploadReq.CodebaseName},
+		{"uploadToken", uploadReq.UploadToken},
+	}
+	for _, field := range fields {
+		if err := writer.WriteField(field[0], field[1]); err != nil {
+			return fmt.Errorf("failed to write field: %v", err)
+		}
+	}
+	return writer.Close()
+}
+
 // executeMultipartUpload 执行multipart上传
 func (hs *HTTPSync) executeMultipartUpload(httpReq *utils.HTTPRequest, formData *utils.MultipartFormData, file io.Reader, counter *writeCounter, token string) error {
 	// 创建multipart表单
@@ -14,7 +14,9 @@ func SetupBackendRoutes(router *gin.Engine, backendHandler *handler.BackendHandl
 	api := router.Group("/codebase-indexer/api/v1")
 	{
 		api.GET("/callgraph", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.SearchCallGraph)
+		api.GET("/callgraph/stream", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.SearchCallGraphStream)
 		api.GET("/search/reference", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.SearchReference)
+		api.GET("/search/reference/stream", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.SearchReferenceStream)
 		api.GET("/search/definition", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.SearchDefinition)
 		api.GET("/files/content", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.GetFileContent)
 		api.GET("/files/skeleton", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.GetFileSkeleton)
@@ -23,6 +25,7 @@ func SetupBackendRoutes(router *gin.Engine, backendHandler *handler.BackendHandl
 		api.GET("/files/structure", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.GetFileStructure)
 		api.GET("/index/summary", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.GetIndexSummary)
 		api.GET("/index/export", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.ExportIndex)
+		api.POST("/index/snapshot", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.ExportSnapshots)
 		api.DELETE("/index", AuthMiddleware(logger), BackendRateLimitMiddleware(logger), backendHandler.DeleteIndex)
 	}
 }
@@ -3,6 +3,7 @@ package server
 
 import (
 	"net/http"
+	"strconv"
 	"strings"
 	"time"
 
@@ -12,6 +13,7 @@ import (
 	"codebase-indexer/internal/config"
 	"codebase-indexer/internal/utils"
 	"codebase-indexer/pkg/logger"
+	"codebase-indexer/pkg/metrics"
 )
 
 // RecoveryMiddleware panic恢复中间件
@@ -28,6 +30,22 @@ func RecoveryMiddleware(logger logger.Logger) gin.HandlerFunc {
 	})
 }
 
+var httpRequestDuration = metrics.NewHistogramVec("codebase_indexer_http_request_duration_seconds",
+	"Duration of HTTP requests by route.", metrics.DefBuckets, "method", "route", "status")
+
+// MetricsMiddleware 按路由记录请求耗时，未匹配的路由统一记为 unmatched，避免路径参数撑大标签
+func MetricsMiddleware() gin.HandlerFunc {
+	return func(c *gin.Context) {
+		start := time.Now()
+		c.Next()
+		route := c.FullPath()
+		if route == "" {
+			route = "unmatched"
+		}
+		httpRequestDuration.WithLabelValues(c.Request.Method, route, strconv.Itoa(c.Writer.Status())).ObserveSince(start)
+	}
+}
+
 // LoggingMiddleware 请求日志中间件
 func LoggingMiddleware(logger logger.Logger) gin.HandlerFunc {
 	return func(c *gin.Context) {
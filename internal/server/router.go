@@ -12,6 +12,7 @@ import (
 	"codebase-indexer/internal/handler"
 	"codebase-indexer/internal/utils"
 	"codebase-indexer/pkg/logger"
+	"codebase-indexer/pkg/metrics"
 )
 
 // Server 服务器接口
@@ -88,6 +89,7 @@ func (s *server) EnableSwagger() {
 func (s *server) setupMiddleware() {
 	// 基础中间件
 	s.engine.Use(RecoveryMiddleware(s.logger))
+	s.engine.Use(MetricsMiddleware())
 	s.engine.Use(LoggingMiddleware(s.logger))
 	s.engine.Use(CORSMiddleware())
 	s.engine.Use(SecurityMiddleware())
@@ -101,6 +103,9 @@ func (s *server) setupMiddleware() {
 		utils.Success(c, data)
 	})
 
+	// Prometheus 指标
+	s.engine.GET("/metrics", gin.WrapH(metrics.Default.Handler()))
+
 	// Swagger文档路由
 	if s.swaggerEnabled {
 		s.setupSwaggerRoutes()
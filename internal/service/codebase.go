@@ -57,12 +57,25 @@ type CodebaseService interface {
 	// QueryCallGraph 查询代码片段内部元素或单符号的调用链及其里面的元素定义，支持代码片段检索
 	QueryCallGraph(ctx context.Context, req *dto.SearchCallGraphRequest) (*dto.CallGraphData, error)
 
+	// StreamReference 流式查询代码间的关系，每得到一批节点调用一次 send
+	StreamReference(ctx context.Context, req *dto.SearchReferenceRequest, send func(*dto.RelationChunk) error) error
+
+	// StreamCallGraph 流式查询调用链，每展开一层调用一次 send，send 失败或 ctx 取消时停止展开
+	StreamCallGraph(ctx context.Context, req *dto.SearchCallGraphRequest, send func(*dto.RelationChunk) error) error
+
+	// SearchSymbols 按符号名前缀、子串或模糊匹配搜索符号
+	SearchSymbols(ctx context.Context, req *dto.SearchSymbolRequest) (*dto.SymbolSearchData, error)
+
 	// Summarize 获取代码库索引摘要信息
 	Summarize(ctx context.Context, req *dto.GetIndexSummaryRequest) (*dto.IndexSummary, error)
 
 	// DeleteIndex 删除代码库的索引（支持按类型删除）
 	DeleteIndex(ctx context.Context, req *dto.DeleteIndexRequest) error
 	ExportIndex(c *gin.Context, d *dto.ExportIndexRequest) error
+
+	// ExportSnapshots 导出代码库各项目的索引快照，供其他机器首次索引前导入
+	ExportSnapshots(ctx context.Context, req *dto.ExportSnapshotRequest) (*dto.ExportSnapshotData, error)
+
 	ReadCodeSnippets(c *gin.Context, d *dto.ReadCodeSnippetsRequest) (*dto.CodeSnippetsData, error)
 
 	// GetFileSkeleton 获取文件骨架信息
@@ -419,6 +432,45 @@ func (l *codebaseService) QueryDefinition(ctx context.Context, req *dto.SearchDe
 	return &dto.DefinitionData{List: definitions}, nil
 }
 
+// SearchSymbols 按符号名前缀、子串或模糊匹配搜索符号，不填充代码内容
+func (l *codebaseService) SearchSymbols(ctx context.Context, req *dto.SearchSymbolRequest) (*dto.SymbolSearchData, error) {
+	// 索引是否关闭
+	if l.manager.GetCodebaseEnv().Switch == dto.SwitchOff {
+		return nil, errs.ErrIndexDisabled
+	}
+
+	results, err := l.indexer.SearchSymbols(ctx, &types.SearchSymbolOptions{
+		Workspace: req.Workspace,
+		Query:     req.Query,
+		Language:  req.Language,
+		Limit:     req.Limit,
+	})
+	if err != nil {
+		return nil, err
+	}
+
+	list := make([]*dto.SymbolInfo, 0, len(results))
+	for _, r := range results {
+		definitions := make([]*dto.DefinitionInfo, 0, len(r.Definitions))
+		for _, d := range r.Definitions {
+			definitions = append(definitions, &dto.DefinitionInfo{
+				FilePath: d.Path,
+				Name:     d.Name,
+				Type:     d.Type,
+				Position: dto.ToPosition(d.Range),
+			})
+		}
+		list = append(list, &dto.SymbolInfo{
+			Name:        r.SymbolName,
+			Language:    r.Language,
+			MatchType:   r.MatchType,
+			Score:       r.Score,
+			Definitions: definitions,
+		})
+	}
+	return &dto.SymbolSearchData{List: list}, nil
+}
+
 func (l *codebaseService) convert2DefinitionInfo(ctx context.Context, nodes []*types.Definition, nodeLimit int, lineLimit int) ([]*dto.DefinitionInfo, error) {
 	if len(nodes) == 0 {
 		return nil, nil
@@ -512,13 +564,13 @@ const defaultMaxLayer = 5
 const maxLayerNodeLimit = 8
 const defaultLineLimit = 200
 
-func (l *codebaseService) QueryCallGraph(ctx context.Context, req *dto.SearchCallGraphRequest) (resp *dto.CallGraphData, err error) {
-	// 二次校验
+// checkCallGraphRequest 二次校验，并限制最大层数
+func checkCallGraphRequest(req *dto.SearchCallGraphRequest) error {
 	if req.CodebasePath == types.EmptyString {
-		return nil, errs.NewMissingParamError("codebasePath")
+		return errs.NewMissingParamError("codebasePath")
 	}
 	if req.FilePath == types.EmptyString {
-		return nil, errs.NewMissingParamError("filePath")
+		return errs.NewMissingParamError("filePath")
 	}
 	if req.MaxLayer <= 0 {
 		req.MaxLayer = defaultMaxLayer
@@ -526,6 +578,13 @@ func (l *codebaseService) QueryCallGraph(ctx context.Context, req *dto.SearchCal
 	if req.MaxLayer > defaultMaxLayerLimit {
 		req.MaxLayer = defaultMaxLayerLimit
 	}
+	return nil
+}
+
+func (l *codebaseService) QueryCallGraph(ctx context.Context, req *dto.SearchCallGraphRequest) (resp *dto.CallGraphData, err error) {
+	if err = checkCallGraphRequest(req); err != nil {
+		return nil, err
+	}
 	// 保证同一时间只有一个查询调用，避免内存过高
 	l.mu.Lock()
 	defer l.mu.Unlock()
@@ -558,20 +617,8 @@ func (l *codebaseService) fillContent(ctx context.Context, nodes []*types.Relati
 		if i >= layerNodeLimit {
 			break
 		}
-		if node.Position.EndLine-node.Position.StartLine <= lineLimit {
-			// 读取文件内容
-			content, err := l.workspaceReader.ReadFile(ctx, node.FilePath, types.ReadOptions{
-				StartLine: node.Position.StartLine,
-				EndLine:   node.Position.EndLine,
-			})
-
-			if err != nil {
-				l.logger.Error("read file content failed: %v", err)
-				continue
-			}
-
-			// 设置节点内容
-			node.Content = string(content)
+		if !l.fillNodeContent(ctx, node, lineLimit) {
+			continue
 		}
 
 		// 如果还没有达到层级限制且有子节点，递归处理子节点
@@ -585,6 +632,25 @@ func (l *codebaseService) fillContent(ctx context.Context, nodes []*types.Relati
 	return nil
 }
 
+// fillNodeContent 节点的代码不超过 lineLimit 行时读取并填充内容，读取失败返回 false
+func (l *codebaseService) fillNodeContent(ctx context.Context, node *types.RelationNode, lineLimit int) bool {
+	if node.Position == nil || node.Position.EndLine-node.Position.StartLine > lineLimit {
+		return true
+	}
+	// 读取文件内容
+	content, err := l.workspaceReader.ReadFile(ctx, node.FilePath, types.ReadOptions{
+		StartLine: node.Position.StartLine,
+		EndLine:   node.Position.EndLine,
+	})
+	if err != nil {
+		l.logger.Error("read file content failed: %v", err)
+		return false
+	}
+	// 设置节点内容
+	node.Content = string(content)
+	return true
+}
+
 func (l *codebaseService) Summarize(ctx context.Context, req *dto.GetIndexSummaryRequest) (*dto.IndexSummary, error) {
 	if l.manager.GetCodebaseEnv().Switch == dto.SwitchOff {
 		return nil, errs.ErrIndexDisabled
@@ -635,6 +701,22 @@ func (l *codebaseService) DeleteIndex(ctx context.Context, req *dto.DeleteIndexR
 	return nil
 }
 
+func (l *codebaseService) ExportSnapshots(ctx context.Context, req *dto.ExportSnapshotRequest) (*dto.ExportSnapshotData, error) {
+	if l.manager.GetCodebaseEnv().Switch == dto.SwitchOff {
+		return nil, errs.ErrIndexDisabled
+	}
+	if req.CodebasePath == types.EmptyString {
+		return nil, errs.NewMissingParamError("codebasePath")
+	}
+	l.logger.Info("start to export index snapshots for workspace %s", req.CodebasePath)
+	files, err := l.indexer.ExportSnapshots(ctx, req.CodebasePath, req.Dir)
+	if err != nil {
+		return nil, fmt.Errorf("failed to export index snapshots, err:%w", err)
+	}
+	l.logger.Info("exported %d index snapshots for workspace %s", len(files), req.CodebasePath)
+	return &dto.ExportSnapshotData{Files: files}, nil
+}
+
 func (s *codebaseService) GetFileSkeleton(ctx context.Context, req *dto.GetFileSkeletonRequest) (*dto.FileSkeletonData, error) {
 	// 1. 参数校验
 	if req.WorkspacePath == "" || req.FilePath == "" {
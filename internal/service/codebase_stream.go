@@ -0,0 +1,142 @@
+package service
+
+import (
+	"context"
+
+	"codebase-indexer/internal/dto"
+	"codebase-indexer/internal/errs"
+	"codebase-indexer/internal/service/indexer"
+	"codebase-indexer/pkg/codegraph/types"
+)
+
+// 流式查询：索引器每展开一层（引用查询每遍历一个文件）发出一批节点，节点编号后立即返回给客户端，
+// 客户端不必等待整个调用图构建完成。填充内容的层数和节点数限制与非流式查询一致
+
+// relationStream 把索引器发出的节点转换为 RelationChunk
+type relationStream struct {
+	l              *codebaseService
+	send           func(*dto.RelationChunk) error
+	layerLimit     int
+	layerNodeLimit int
+	rootContent    bool // 为 false 时不填充根节点内容，只填充第一个根节点下的子节点，与按符号名查询引用一致
+	nextId         int
+	ids            map[*types.RelationNode]int
+	children       map[*types.RelationNode]int      // 已发出的子节点数，nil 对应根节点
+	fillable       map[*types.RelationNode]struct{} // 子节点需要填充内容的节点
+	err            error                            // send 返回的错误
+}
+
+func (l *codebaseService) newRelationStream(send func(*dto.RelationChunk) error, layerLimit, layerNodeLimit int,
+	rootContent bool) *relationStream {
+	return &relationStream{
+		l:              l,
+		send:           send,
+		layerLimit:     layerLimit,
+		layerNodeLimit: layerNodeLimit,
+		rootContent:    rootContent,
+		ids:            make(map[*types.RelationNode]int),
+		children:       make(map[*types.RelationNode]int),
+		fillable:       make(map[*types.RelationNode]struct{}),
+	}
+}
+
+func (s *relationStream) emitter(ctx context.Context) indexer.RelationEmitter {
+	return func(layer int, parents, nodes []*types.RelationNode) error {
+		chunk := &dto.RelationChunk{Layer: layer, Nodes: make([]*dto.RelationChunkNode, 0, len(nodes))}
+		for i, n := range nodes {
+			parent := parents[i]
+			s.nextId++
+			s.ids[n] = s.nextId
+			s.fill(ctx, layer, parent, n)
+			node := *n
+			node.Children = nil
+			chunk.Nodes = append(chunk.Nodes, &dto.RelationChunkNode{Id: s.ids[n], ParentId: s.ids[parent], RelationNode: node})
+		}
+		if err := s.send(chunk); err != nil {
+			s.err = err
+			return err
+		}
+		return nil
+	}
+}
+
+// fill 按 fillContent 的规则填充内容：每个父节点只填充前 layerNodeLimit 个子节点，只向下填充 layerLimit 层
+func (s *relationStream) fill(ctx context.Context, layer int, parent, node *types.RelationNode) {
+	index := s.children[parent]
+	s.children[parent]++
+	if parent != nil {
+		if _, ok := s.fillable[parent]; !ok {
+			return
+		}
+	}
+	if !s.rootContent {
+		if layer == 0 {
+			if index == 0 {
+				s.fillable[node] = struct{}{}
+			}
+			return
+		}
+		layer--
+	}
+	if index >= s.layerNodeLimit || layer >= s.layerLimit {
+		return
+	}
+	if s.l.fillNodeContent(ctx, node, defaultLineLimit) && layer+1 < s.layerLimit {
+		s.fillable[node] = struct{}{}
+	}
+}
+
+// finish 查询完成后发送结束标记
+func (s *relationStream) finish(ctx context.Context, err error) error {
+	if err != nil {
+		return err
+	}
+	if s.err != nil {
+		return s.err
+	}
+	// 调用图展开被取消时返回的是部分结果
+	if err := ctx.Err(); err != nil {
+		return err
+	}
+	return s.send(&dto.RelationChunk{Done: true})
+}
+
+func (l *codebaseService) StreamReference(ctx context.Context, req *dto.SearchReferenceRequest,
+	send func(*dto.RelationChunk) error) error {
+	if l.manager.GetCodebaseEnv().Switch == dto.SwitchOff {
+		return errs.ErrIndexDisabled
+	}
+	if req.CodebasePath == types.EmptyString {
+		return errs.NewMissingParamError("codebasePath")
+	}
+	// 根据symbolName查询引用时不填充根节点内容
+	rootContent := req.FilePath != types.EmptyString || req.SymbolName == types.EmptyString
+	stream := l.newRelationStream(send, relationFillContentLayerLimit, relationFillContentLayerNodeLimit, rootContent)
+	_, err := l.indexer.QueryReferences(indexer.WithRelationEmitter(ctx, stream.emitter(ctx)), &types.QueryReferenceOptions{
+		Workspace:  req.CodebasePath,
+		FilePath:   req.FilePath,
+		StartLine:  req.StartLine,
+		EndLine:    req.EndLine,
+		SymbolName: req.SymbolName,
+	})
+	return stream.finish(ctx, err)
+}
+
+func (l *codebaseService) StreamCallGraph(ctx context.Context, req *dto.SearchCallGraphRequest,
+	send func(*dto.RelationChunk) error) error {
+	if err := checkCallGraphRequest(req); err != nil {
+		return err
+	}
+	// 保证同一时间只有一个查询调用，避免内存过高
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	stream := l.newRelationStream(send, req.MaxLayer, maxLayerNodeLimit, true)
+	_, err := l.indexer.QueryCallGraph(indexer.WithRelationEmitter(ctx, stream.emitter(ctx)), &types.QueryCallGraphOptions{
+		Workspace:  req.CodebasePath,
+		FilePath:   req.FilePath,
+		LineRange:  req.LineRange,
+		SymbolName: req.SymbolName,
+		MaxLayer:   req.MaxLayer,
+	})
+	return stream.finish(ctx, err)
+}
@@ -0,0 +1,65 @@
+package service
+
+import (
+	"codebase-indexer/internal/dto"
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/test/mocks"
+	"context"
+	"errors"
+	"testing"
+
+	"github.com/golang/mock/gomock"
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestRelationStream(t *testing.T) {
+	ctrl := gomock.NewController(t)
+	defer ctrl.Finish()
+	mockWorkspaceReader := mocks.NewMockWorkspaceReader(ctrl)
+	mockWorkspaceReader.EXPECT().ReadFile(gomock.Any(), gomock.Any(), gomock.Any()).
+		DoAndReturn(func(ctx context.Context, path string, option types.ReadOptions) ([]byte, error) {
+			return []byte(path), nil
+		}).AnyTimes()
+	l := &codebaseService{workspaceReader: mockWorkspaceReader, logger: &mocks.MockLogger{}}
+
+	var chunks []*dto.RelationChunk
+	stream := l.newRelationStream(func(chunk *dto.RelationChunk) error {
+		chunks = append(chunks, chunk)
+		return nil
+	}, 2, 1, true)
+	ctx := context.Background()
+	emit := stream.emitter(ctx)
+	node := func(path string) *types.RelationNode {
+		return &types.RelationNode{FilePath: path, Position: &types.Position{StartLine: 1, EndLine: 2}}
+	}
+	root := node("root")
+	a, b := node("a"), node("b")
+	c := node("c")
+	require.NoError(t, emit(0, []*types.RelationNode{nil}, []*types.RelationNode{root}))
+	root.Children = append(root.Children, a, b)
+	require.NoError(t, emit(1, []*types.RelationNode{root, root}, []*types.RelationNode{a, b}))
+	a.Children = append(a.Children, c)
+	require.NoError(t, emit(2, []*types.RelationNode{a}, []*types.RelationNode{c}))
+	require.NoError(t, stream.finish(ctx, nil))
+
+	require.Len(t, chunks, 4)
+	assert.Equal(t, 0, chunks[0].Nodes[0].ParentId)
+	assert.Equal(t, "root", chunks[0].Nodes[0].Content)
+	// 只填充每个父节点的前 layerNodeLimit 个子节点，只填充 layerLimit 层
+	layer1 := chunks[1].Nodes
+	require.Len(t, layer1, 2)
+	assert.Equal(t, chunks[0].Nodes[0].Id, layer1[0].ParentId)
+	assert.Equal(t, "a", layer1[0].Content)
+	assert.Empty(t, layer1[1].Content)
+	assert.Nil(t, layer1[0].Children)
+	assert.Equal(t, layer1[0].Id, chunks[2].Nodes[0].ParentId)
+	assert.Empty(t, chunks[2].Nodes[0].Content)
+	assert.True(t, chunks[3].Done)
+
+	// 发送失败后不再发送结束标记
+	sendErr := errors.New("client closed")
+	stream = l.newRelationStream(func(chunk *dto.RelationChunk) error { return sendErr }, 2, 1, false)
+	assert.ErrorIs(t, stream.emitter(ctx)(0, []*types.RelationNode{nil}, []*types.RelationNode{node("root")}), sendErr)
+	assert.ErrorIs(t, stream.finish(ctx, nil), sendErr)
+}
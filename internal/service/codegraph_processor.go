@@ -1,12 +1,14 @@
 package service
 
 import (
+	"codebase-indexer/internal/service/indexer"
 	"codebase-indexer/pkg/codegraph/utils"
 	"codebase-indexer/pkg/codegraph/workspace"
 	"context"
 	"errors"
 	"fmt"
 	"path/filepath"
+	"sync"
 	"time"
 
 	"codebase-indexer/internal/model"
@@ -33,6 +35,8 @@ type CodegraphProcessor struct {
 	workspaceRepo   repository.WorkspaceRepository
 	eventRepo       repository.EventRepository
 	logger          logger.Logger
+	schedulerOnce   sync.Once
+	scheduler       *eventScheduler
 }
 
 func NewCodegraphProcessor(
@@ -114,13 +118,8 @@ func (c *CodegraphProcessor) ProcessModifyFileEvent(ctx context.Context, event *
 		}
 		return nil
 	}
-	// 删除之前已经存在的索引
-	err = c.indexer.RemoveIndexes(ctx, event.WorkspacePath, []string{event.SourceFilePath})
-	if err != nil {
-		return fmt.Errorf("codegraph update modify event %d err: %w", event.ID, err)
-	}
-	// 使用索引器重新索引文件
-	err = c.indexer.IndexFiles(ctx, event.WorkspacePath, []string{event.SourceFilePath})
+	// 增量更新文件索引，没有旧索引时由索引器删除后重建
+	err = c.indexer.UpdateFileIndex(ctx, event.WorkspacePath, event.SourceFilePath)
 	if err = c.updateEventStatusFinally(event, err); err != nil {
 		return fmt.Errorf("codegraph update modify event %d err: %w", event.ID, err)
 	}
@@ -199,139 +198,123 @@ func (c *CodegraphProcessor) ProcessOpenWorkspaceEvent(ctx context.Context, even
 	return nil
 }
 
-// ProcessEvents 处理事件记录
-func (c *CodegraphProcessor) ProcessEvents(ctx context.Context, workspacePaths []string) error {
-
-	codegraphStatuses := []int{
-		model.CodegraphStatusInit,
-	}
-	// 重新构建事件
-	rebuildEvents, err := c.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{model.EventTypeRebuildWorkspace}, workspacePaths, 10,
-		false, nil, codegraphStatuses)
+// codegraphEventTypes 代码图处理的事件类型
+var codegraphEventTypes = []string{
+	model.EventTypeRebuildWorkspace,
+	model.EventTypeOpenWorkspace,
+	model.EventTypeAddFile,
+	model.EventTypeModifyFile,
+	model.EventTypeDeleteFile,
+	model.EventTypeRenameFile,
+}
 
+// ProcessEvents 领取待处理事件交给调度器，按优先级执行：正在编辑的文件 > 修改 > 添加、删除、重命名 > 打开、重建工作区。
+// 最多等待 codegraphRoundWait，未完成的长任务在后台继续，下一轮领取的高优先级事件可以抢占它
+func (c *CodegraphProcessor) ProcessEvents(ctx context.Context, workspacePaths []string) error {
+	events, err := c.pendingEvents(workspacePaths)
 	if err != nil {
-		c.logger.Error("failed to get rebuild_workspace events: %v", err)
-		return fmt.Errorf("failed to get rebuild_workspace events: %w", err)
+		return err
 	}
-
-	// 处理重新构建事件
-	for _, event := range rebuildEvents {
-		// 转换路径
+	scheduler := c.eventScheduler()
+	now := time.Now()
+	submitted := make([]*schedTask, 0, len(events))
+	for _, event := range events {
 		c.convertWorkspaceFilePathToAbs(event)
-		c.logger.Info("codegraph start to process rebuild_workspace event: %s", event.WorkspacePath)
-		err = c.ProcessRebuildWorkspaceEvent(ctx, event)
-		if err != nil {
-			c.logger.Error("failed to process rebuild_workspace event for codegraph: %v", err)
+		task := scheduler.submit(ctx, event, eventPriorityOf(event, now), c.runEvent)
+		if task == nil {
 			continue
 		}
-		c.logger.Info("codegraph process rebuild_workspace event successfully: %s", event.WorkspacePath)
-	}
-
-	// 打开工作区事件
-	openEvents, err := c.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{model.EventTypeOpenWorkspace}, workspacePaths, 10,
-		false, nil, codegraphStatuses)
-
-	if err != nil {
-		c.logger.Error("failed to get open_workspace events: %v", err)
-		return fmt.Errorf("failed to get open_workspace events: %w", err)
+		submitted = append(submitted, task)
+		if event.EventType == model.EventTypeOpenWorkspace {
+			// 打开工作区的事件优先级最低，先在后台打开已有的项目数据库供查询使用
+			c.indexer.PreopenWorkspace(ctx, event.WorkspacePath)
+		}
 	}
 
-	// 处理打开工作区事件
-	for _, event := range openEvents {
-		c.convertWorkspaceFilePathToAbs(event)
-		c.logger.Info("codegraph start to process open_workspace event: %s", event.WorkspacePath)
-		err = c.ProcessOpenWorkspaceEvent(ctx, event)
-		if err != nil {
-			c.logger.Error("failed to process open_workspace event for codegraph: %v", err)
-			continue
+	timer := time.NewTimer(codegraphRoundWait)
+	defer timer.Stop()
+	for _, task := range submitted {
+		select {
+		case <-task.done:
+		case <-timer.C:
+			return nil
+		case <-ctx.Done():
+			return ctx.Err()
 		}
-		c.logger.Info("codegraph process open_workspace event successfully: %s", event.WorkspacePath)
 	}
+	return nil
+}
 
-	// 处理添加文件事件
-	addEvents, err := c.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{model.EventTypeAddFile}, workspacePaths, 10,
-		false, nil, codegraphStatuses)
-
-	if err != nil {
-		c.logger.Error("failed to get add file events: %v", err)
-		return fmt.Errorf("failed to get add file events: %w", err)
+// pendingEvents 按类型领取最早的待处理事件。积压较多时最早的修改事件里可能没有正在编辑的文件，
+// 另外领取最新的修改事件
+func (c *CodegraphProcessor) pendingEvents(workspacePaths []string) ([]*model.Event, error) {
+	codegraphStatuses := []int{
+		model.CodegraphStatusInit,
 	}
-
-	// 处理添加文件事件
-	for _, event := range addEvents {
-		c.convertWorkspaceFilePathToAbs(event)
-		c.logger.Info("codegraph start to process add_file event: %s", event.SourceFilePath)
-		err = c.ProcessAddFileEvent(ctx, event)
+	var events []*model.Event
+	seen := make(map[int64]struct{})
+	fetch := func(eventType string, isDesc bool) error {
+		typeEvents, err := c.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{eventType}, workspacePaths, 10,
+			isDesc, nil, codegraphStatuses)
 		if err != nil {
-			c.logger.Error("failed to process add file event for codegraph: %v", err)
-			continue
+			c.logger.Error("failed to get %s events: %v", eventType, err)
+			return fmt.Errorf("failed to get %s events: %w", eventType, err)
 		}
-		c.logger.Info("codegraph process add_file event successfully: %s", event.SourceFilePath)
-	}
-
-	// 处理修改文件事件
-	modifyEvents, err := c.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{model.EventTypeModifyFile}, workspacePaths, 10,
-		false, nil, codegraphStatuses)
-
-	if err != nil {
-		c.logger.Error("failed to get modify file events: %v", err)
-		return fmt.Errorf("failed to get modify file events: %w", err)
+		for _, event := range typeEvents {
+			if _, ok := seen[event.ID]; !ok {
+				seen[event.ID] = struct{}{}
+				events = append(events, event)
+			}
+		}
+		return nil
 	}
-
-	for _, event := range modifyEvents {
-		c.convertWorkspaceFilePathToAbs(event)
-		c.logger.Info("codegraph start to process modify_file event: %s", event.SourceFilePath)
-		err = c.ProcessModifyFileEvent(ctx, event)
-		if err != nil {
-			c.logger.Error("failed to process modify file event for codegraph: %v", err)
-			continue
+	for _, eventType := range codegraphEventTypes {
+		if err := fetch(eventType, false); err != nil {
+			return nil, err
 		}
-		c.logger.Info("codegraph process modify_file event successfully: %s", event.SourceFilePath)
 	}
-
-	// 处理删除文件事件
-	deleteEvents, err := c.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{model.EventTypeDeleteFile}, workspacePaths, 10,
-		false, nil, codegraphStatuses)
-
-	if err != nil {
-		c.logger.Error("failed to get delete file events: %v", err)
-		return fmt.Errorf("failed to get delete file events: %w", err)
+	if err := fetch(model.EventTypeModifyFile, true); err != nil {
+		return nil, err
 	}
+	return events, nil
+}
 
-	for _, event := range deleteEvents {
-		c.convertWorkspaceFilePathToAbs(event)
-		c.logger.Info("codegraph start to process delete_file event: %s", event.SourceFilePath)
+func (c *CodegraphProcessor) eventScheduler() *eventScheduler {
+	c.schedulerOnce.Do(func() {
+		c.scheduler = newEventScheduler(DefaultCodegraphWorkers)
+	})
+	return c.scheduler
+}
+
+// runEvent 在获得执行权后处理事件，长任务通过上下文中的让出点响应抢占
+func (c *CodegraphProcessor) runEvent(ctx context.Context, task *schedTask) {
+	event := task.event
+	ctx = indexer.WithYielder(ctx, task)
+	start := time.Now()
+	c.logger.Info("codegraph start to process %s event: workspace %s, source %s, target %s, priority %d",
+		event.EventType, event.WorkspacePath, event.SourceFilePath, event.TargetFilePath, task.priority)
+	var err error
+	switch event.EventType {
+	case model.EventTypeRebuildWorkspace:
+		err = c.ProcessRebuildWorkspaceEvent(ctx, event)
+	case model.EventTypeOpenWorkspace:
+		err = c.ProcessOpenWorkspaceEvent(ctx, event)
+	case model.EventTypeAddFile:
+		err = c.ProcessAddFileEvent(ctx, event)
+	case model.EventTypeModifyFile:
+		err = c.ProcessModifyFileEvent(ctx, event)
+	case model.EventTypeDeleteFile:
 		err = c.ProcessDeleteFileEvent(ctx, event)
-		if err != nil {
-			c.logger.Error("failed to process delete file event for codegraph: %v", err)
-			continue
-		}
-		c.logger.Info("codegraph process delete_file event successfully: %s", event.SourceFilePath)
+	case model.EventTypeRenameFile:
+		err = c.ProcessRenameFileEvent(ctx, event)
 	}
-
-	// 处理重命名事件
-	renameEvents, err := c.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{model.EventTypeRenameFile}, workspacePaths, 10,
-		false, nil, codegraphStatuses)
-
 	if err != nil {
-		c.logger.Error("failed to get rename file events: %v", err)
-		return fmt.Errorf("failed to get rename file events: %w", err)
+		c.logger.Error("failed to process %s event for codegraph: %v", event.EventType, err)
+		return
 	}
-
-	for _, event := range renameEvents {
-		c.convertWorkspaceFilePathToAbs(event)
-		c.logger.Info("codegraph start to process rename_file event: source %s target %s",
-			event.SourceFilePath, event.TargetFilePath)
-		err = c.ProcessRenameFileEvent(ctx, event)
-		if err != nil {
-			c.logger.Error("failed to process rename file event for codegraph: %v", err)
-			continue
-		}
-		c.logger.Info("codegraph process rename_file event successfully: source %s target %s",
-			event.SourceFilePath, event.TargetFilePath)
-
-	}
-	return nil
+	c.logger.Info("codegraph process %s event successfully: workspace %s, source %s, target %s, cost %d ms",
+		event.EventType, event.WorkspacePath, event.SourceFilePath, event.TargetFilePath,
+		time.Since(start).Milliseconds())
 }
 
 func (c *CodegraphProcessor) updateEventStatusFinally(event *model.Event, err error) error {
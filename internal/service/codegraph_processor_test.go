@@ -331,11 +331,8 @@ func TestCodegraphProcessor_ProcessModifyFileEvent(t *testing.T) {
 				}
 				mockWorkspaceReader.EXPECT().Stat("/workspace/file.go").Return(fileInfo, nil)
 
-				// 删除旧索引
-				mockIndexer.EXPECT().RemoveIndexes(gomock.Any(), "/workspace", []string{"/workspace/file.go"}).Return(nil)
-
-				// 重新索引文件成功
-				mockIndexer.EXPECT().IndexFiles(gomock.Any(), "/workspace", []string{"/workspace/file.go"}).Return(nil)
+				// 增量更新索引成功
+				mockIndexer.EXPECT().UpdateFileIndex(gomock.Any(), "/workspace", "/workspace/file.go").Return(nil)
 
 				// 更新事件状态为成功
 				mockEventRepo.EXPECT().UpdateEvent(gomock.Any()).Return(nil)
@@ -0,0 +1,217 @@
+package service
+
+import (
+	"context"
+	"sort"
+	"sync"
+	"time"
+
+	"codebase-indexer/internal/model"
+)
+
+// 代码图事件调度：事件按优先级等待执行权，多个执行槽位在工作区之间共享，空出的槽位总是交给
+// 当前可执行的最高优先级任务；同一工作区同一时间只有一个任务持有执行权。打开、重建工作区这类长任务
+// 在批次之间检查让出点，有更高优先级的任务在等待时让出执行权，之后保持原有位置继续
+
+// eventPriority 事件优先级，值越小越优先
+type eventPriority int
+
+const (
+	priorityActiveFile eventPriority = iota // 刚修改的文件，通常是正在编辑的文件
+	priorityModifyFile
+	priorityFileChange // 添加、删除、重命名
+	priorityWorkspace  // 打开、重建工作区
+)
+
+const (
+	// activeFileWindow 创建时间在该时间内的修改事件视为正在编辑的文件
+	activeFileWindow = 30 * time.Second
+	// DefaultCodegraphWorkers 代码图事件的执行槽位数
+	DefaultCodegraphWorkers = 2
+	// codegraphRoundWait 一轮事件处理等待任务完成的最长时间，长任务在后台继续，下一轮领取的新事件可以抢占它
+	codegraphRoundWait = time.Second
+)
+
+// eventPriorityOf 事件的优先级
+func eventPriorityOf(event *model.Event, now time.Time) eventPriority {
+	switch event.EventType {
+	case model.EventTypeModifyFile:
+		if now.Sub(event.CreatedAt) <= activeFileWindow {
+			return priorityActiveFile
+		}
+		return priorityModifyFile
+	case model.EventTypeOpenWorkspace, model.EventTypeRebuildWorkspace:
+		return priorityWorkspace
+	default:
+		return priorityFileChange
+	}
+}
+
+// schedTask 调度的任务，实现 indexer.Yielder
+type schedTask struct {
+	scheduler *eventScheduler
+	event     *model.Event
+	priority  eventPriority
+	seq       uint64
+	granted   chan struct{}
+	held      bool // 持有执行权
+	done      chan struct{}
+}
+
+type eventScheduler struct {
+	mu      sync.Mutex
+	workers int
+	running int
+	seq     uint64
+	waiting []*schedTask       // 等待执行权的任务，按优先级、提交顺序排列
+	busy    map[string]bool    // 有任务持有执行权的工作区
+	tasks   map[int64]struct{} // 已提交且未结束的事件
+}
+
+func newEventScheduler(workers int) *eventScheduler {
+	if workers <= 0 {
+		workers = DefaultCodegraphWorkers
+	}
+	return &eventScheduler{
+		workers: workers,
+		busy:    make(map[string]bool),
+		tasks:   make(map[int64]struct{}),
+	}
+}
+
+// submit 提交事件，在获得执行权后调用 run。事件已提交、尚未结束时返回 nil
+func (s *eventScheduler) submit(ctx context.Context, event *model.Event, priority eventPriority,
+	run func(ctx context.Context, task *schedTask)) *schedTask {
+	s.mu.Lock()
+	if _, ok := s.tasks[event.ID]; ok {
+		s.mu.Unlock()
+		return nil
+	}
+	s.tasks[event.ID] = struct{}{}
+	s.seq++
+	task := &schedTask{scheduler: s, event: event, priority: priority, seq: s.seq, done: make(chan struct{})}
+	s.enqueueLocked(task)
+	s.mu.Unlock()
+
+	go func() {
+		defer func() {
+			s.mu.Lock()
+			delete(s.tasks, event.ID)
+			s.mu.Unlock()
+			close(task.done)
+		}()
+		if err := s.acquire(ctx, task); err != nil {
+			return
+		}
+		defer s.release(task)
+		run(ctx, task)
+	}()
+	return task
+}
+
+// enqueueLocked 加入等待队列并分配空闲的执行槽位
+func (s *eventScheduler) enqueueLocked(task *schedTask) {
+	task.granted = make(chan struct{})
+	i := sort.Search(len(s.waiting), func(i int) bool { return task.before(s.waiting[i]) })
+	s.waiting = append(s.waiting, nil)
+	copy(s.waiting[i+1:], s.waiting[i:])
+	s.waiting[i] = task
+	s.dispatchLocked()
+}
+
+func (t *schedTask) before(o *schedTask) bool {
+	if t.priority != o.priority {
+		return t.priority < o.priority
+	}
+	return t.seq < o.seq
+}
+
+// dispatchLocked 按顺序把空闲槽位交给工作区空闲的任务
+func (s *eventScheduler) dispatchLocked() {
+	for i := 0; i < len(s.waiting) && s.running < s.workers; {
+		task := s.waiting[i]
+		if s.busy[task.event.WorkspacePath] {
+			i++
+			continue
+		}
+		s.waiting = append(s.waiting[:i], s.waiting[i+1:]...)
+		s.running++
+		s.busy[task.event.WorkspacePath] = true
+		task.held = true
+		close(task.granted)
+	}
+}
+
+// acquire 等待执行权，取消时退出等待队列
+func (s *eventScheduler) acquire(ctx context.Context, task *schedTask) error {
+	select {
+	case <-task.granted:
+		return nil
+	case <-ctx.Done():
+	}
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	for i, t := range s.waiting {
+		if t == task {
+			s.waiting = append(s.waiting[:i], s.waiting[i+1:]...)
+			return ctx.Err()
+		}
+	}
+	// 取消的同时已获得执行权
+	s.releaseLocked(task)
+	return ctx.Err()
+}
+
+func (s *eventScheduler) release(task *schedTask) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.releaseLocked(task)
+}
+
+func (s *eventScheduler) releaseLocked(task *schedTask) {
+	if !task.held {
+		return
+	}
+	task.held = false
+	s.running--
+	delete(s.busy, task.event.WorkspacePath)
+	s.dispatchLocked()
+}
+
+// Preempted 有更高优先级的任务在等待，并且该任务让出后就能执行：同一工作区的任务，或者槽位已满时
+// 其他空闲工作区的任务
+func (t *schedTask) Preempted() bool {
+	s := t.scheduler
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	return s.preemptedLocked(t)
+}
+
+func (s *eventScheduler) preemptedLocked(t *schedTask) bool {
+	for _, w := range s.waiting {
+		if !w.before(t) || w.priority == t.priority {
+			return false
+		}
+		if w.event.WorkspacePath == t.event.WorkspacePath ||
+			s.running >= s.workers && !s.busy[w.event.WorkspacePath] {
+			return true
+		}
+	}
+	return false
+}
+
+// Yield 让出执行权后按原有顺序重新排队，返回时重新持有执行权
+func (t *schedTask) Yield(ctx context.Context) error {
+	s := t.scheduler
+	s.mu.Lock()
+	if !s.preemptedLocked(t) {
+		s.mu.Unlock()
+		return nil
+	}
+	t.held = false
+	s.running--
+	delete(s.busy, t.event.WorkspacePath)
+	s.enqueueLocked(t)
+	s.mu.Unlock()
+	return s.acquire(ctx, t)
+}
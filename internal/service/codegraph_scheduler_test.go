@@ -0,0 +1,98 @@
+package service
+
+import (
+	"context"
+	"sync"
+	"testing"
+	"time"
+
+	"codebase-indexer/internal/model"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestEventPriorityOf(t *testing.T) {
+	now := time.Now()
+	assert.Equal(t, priorityActiveFile, eventPriorityOf(&model.Event{EventType: model.EventTypeModifyFile, CreatedAt: now}, now))
+	assert.Equal(t, priorityModifyFile, eventPriorityOf(&model.Event{EventType: model.EventTypeModifyFile,
+		CreatedAt: now.Add(-time.Minute)}, now))
+	assert.Equal(t, priorityFileChange, eventPriorityOf(&model.Event{EventType: model.EventTypeAddFile}, now))
+	assert.Equal(t, priorityWorkspace, eventPriorityOf(&model.Event{EventType: model.EventTypeRebuildWorkspace}, now))
+}
+
+func TestEventScheduler(t *testing.T) {
+	ctx := context.Background()
+	s := newEventScheduler(1)
+	var mu sync.Mutex
+	var order []int64
+	record := func(id int64) {
+		mu.Lock()
+		defer mu.Unlock()
+		order = append(order, id)
+	}
+
+	// 重建任务持有唯一的槽位，等待期间提交的任务按优先级执行
+	started := make(chan struct{})
+	resume := make(chan struct{})
+	rebuild := s.submit(ctx, &model.Event{ID: 1, WorkspacePath: "/a"}, priorityWorkspace,
+		func(ctx context.Context, task *schedTask) {
+			close(started)
+			<-resume
+			assert.True(t, task.Preempted())
+			assert.NoError(t, task.Yield(ctx))
+			assert.False(t, task.Preempted())
+			record(1)
+		})
+	require.NotNil(t, rebuild)
+	<-started
+	assert.Nil(t, s.submit(ctx, &model.Event{ID: 1, WorkspacePath: "/a"}, priorityWorkspace, nil))
+
+	run := func(ctx context.Context, task *schedTask) { record(task.event.ID) }
+	change := s.submit(ctx, &model.Event{ID: 2, WorkspacePath: "/b"}, priorityFileChange, run)
+	modify := s.submit(ctx, &model.Event{ID: 3, WorkspacePath: "/a"}, priorityModifyFile, run)
+	active := s.submit(ctx, &model.Event{ID: 4, WorkspacePath: "/b"}, priorityActiveFile, run)
+
+	// 已取消的任务退出等待队列，不影响其他任务
+	cancelCtx, cancel := context.WithCancel(ctx)
+	cancelled := s.submit(cancelCtx, &model.Event{ID: 5, WorkspacePath: "/c"}, priorityActiveFile, run)
+	cancel()
+	<-cancelled.done
+
+	close(resume)
+	for _, task := range []*schedTask{rebuild, change, modify, active} {
+		<-task.done
+	}
+	assert.Equal(t, []int64{4, 3, 2, 1}, order)
+	assert.Zero(t, s.running)
+	assert.Empty(t, s.waiting)
+	assert.Empty(t, s.tasks)
+}
+
+func TestEventScheduler_OneTaskPerWorkspace(t *testing.T) {
+	ctx := context.Background()
+	s := newEventScheduler(2)
+	started := make(chan int64, 3)
+	resume := make(chan struct{})
+	run := func(ctx context.Context, task *schedTask) {
+		started <- task.event.ID
+		<-resume
+	}
+	tasks := []*schedTask{
+		s.submit(ctx, &model.Event{ID: 1, WorkspacePath: "/a"}, priorityModifyFile, run),
+		s.submit(ctx, &model.Event{ID: 2, WorkspacePath: "/a"}, priorityModifyFile, run),
+		s.submit(ctx, &model.Event{ID: 3, WorkspacePath: "/b"}, priorityModifyFile, run),
+	}
+	// 同一工作区的第二个任务等待，空闲的槽位交给其他工作区
+	assert.ElementsMatch(t, []int64{1, 3}, []int64{<-started, <-started})
+	select {
+	case id := <-started:
+		t.Fatalf("task %d started while workspace busy", id)
+	case <-time.After(50 * time.Millisecond):
+	}
+	close(resume)
+	assert.Equal(t, int64(2), <-started)
+	for _, task := range tasks {
+		<-task.done
+	}
+}
@@ -6,6 +6,7 @@ import (
 	"os"
 	"path/filepath"
 	"strings"
+	"sync"
 	"time"
 
 	"codebase-indexer/internal/config"
@@ -37,6 +38,7 @@ type embeddingProcessService struct {
 	uploadService UploadService
 	syncer        repository.SyncInterface
 	logger        logger.Logger
+	configMu      sync.Mutex // 并发批次读改写 embedding 配置时加锁
 }
 
 // NewEmbeddingProcessService 创建事件处理服务
@@ -250,10 +252,10 @@ func (ep *embeddingProcessService) processWorkspaceEvents(ctx context.Context, w
 		model.EmbeddingStatusBuildFailed,
 	}
 
-	// 获取待处理的添加和修改文件事件（合并处理）
-	addModifyEvents, err := ep.eventRepo.GetEventsByTypeAndStatusAndWorkspaces([]string{model.EventTypeAddFile, model.EventTypeModifyFile}, []string{workspacePath}, 150, false, targetStatuses, nil)
+	// 领取待处理的添加和修改文件事件（合并处理），领取后状态即为上报中
+	addModifyEvents, err := ep.eventRepo.ClaimEventsForEmbedding(workspacePath, []string{model.EventTypeAddFile, model.EventTypeModifyFile}, targetStatuses, 150)
 	if err != nil {
-		return fmt.Errorf("failed to get add/modify file events: %w", err)
+		return fmt.Errorf("failed to claim add/modify file events: %w", err)
 	}
 
 	// 获取待处理的重命名和删除文件事件（合并处理）
@@ -279,6 +281,7 @@ func (ep *embeddingProcessService) processWorkspaceEvents(ctx context.Context, w
 	// 需要通过 uploadService 获取 syncer 来获取上传令牌
 	uploadTokenResp, err := ep.syncer.FetchUploadToken(tokenReq)
 	if err != nil {
+		ep.releaseClaimedEvents(addModifyEvents)
 		return fmt.Errorf("failed to get upload token for workspace %s: %w", workspacePath, err)
 	}
 	uploadToken := uploadTokenResp.Data.Token
@@ -305,52 +308,79 @@ func (ep *embeddingProcessService) processWorkspaceEvents(ctx context.Context, w
 	return nil
 }
 
-// processBatchEvents 批量处理添加和修改事件
+// processBatchEvents 批量处理添加和修改事件，多个批次并发上传，并发数受工作区上传限制约束
 func (ep *embeddingProcessService) processBatchAddModifyEvents(ctx context.Context, workspacePath string, events []*model.Event, uploadToken string, maxFileSizeKB int) error {
 	ep.logger.Info("processing %d add/modify events for workspace: %s", len(events), workspacePath)
 
 	// 分批处理，每批10个事件
 	batchSize := 10
+	workers := make(chan struct{}, UploadConcurrency())
+	var wg sync.WaitGroup
 	for i := 0; i < len(events); i += batchSize {
+		if ctx.Err() != nil {
+			// 已领取但未处理的事件退回，等待下次处理
+			ep.releaseClaimedEvents(events[i:])
+			break
+		}
 		end := i + batchSize
 		if end > len(events) {
 			end = len(events)
 		}
 
 		batch := events[i:end]
-		err := ep.processBatchAddModify(ctx, workspacePath, batch, uploadToken, maxFileSizeKB)
-		if err != nil {
-			ep.logger.Error("failed to process batch add/modify events [%d:%d]: %v", i, end, err)
-			// 继续处理下一批，不因单批失败而中断整个处理
-			continue
-		}
-
-		// 添加延迟控制请求频率
-		time.Sleep(100 * time.Millisecond)
+		workers <- struct{}{}
+		wg.Add(1)
+		go func(start, end int) {
+			defer func() {
+				<-workers
+				wg.Done()
+			}()
+			err := ep.processBatchAddModify(ctx, workspacePath, batch, uploadToken, maxFileSizeKB)
+			if err != nil {
+				ep.logger.Error("failed to process batch add/modify events [%d:%d]: %v", start, end, err)
+				// 继续处理下一批，不因单批失败而中断整个处理
+			}
+		}(i, end)
 	}
+	wg.Wait()
 
 	return nil
 }
 
-// processBatchAddModify 批量处理添加和修改事件
-func (ep *embeddingProcessService) processBatchAddModify(ctx context.Context, workspacePath string, events []*model.Event, uploadToken string, maxFileSizeKB int) error {
+// releaseClaimedEvents 退回已领取但未上报的事件，置为上报失败以便下次重新领取
+func (ep *embeddingProcessService) releaseClaimedEvents(events []*model.Event) {
 	if len(events) == 0 {
-		return nil
+		return
 	}
-
-	// 1. 批量更新事件状态为上传中
 	eventIDs := make([]int64, len(events))
 	for i, event := range events {
 		eventIDs[i] = event.ID
 	}
-	err := ep.eventRepo.UpdateEventsEmbeddingStatus(eventIDs, model.EmbeddingStatusUploading)
-	if err != nil {
-		return fmt.Errorf("failed to update events status to uploading: %w", err)
+	if err := ep.eventRepo.UpdateEventsEmbeddingStatus(eventIDs, model.EmbeddingStatusUploadFailed); err != nil {
+		ep.logger.Error("failed to release claimed events: %v", err)
 	}
+}
 
-	// 2. 计算changes
-	changes := make([]*utils.FileStatus, len(events))
-	for i, event := range events {
+// processBatchAddModify 批量处理添加和修改事件，内容哈希与已构建成功的记录一致的文件不再上传
+func (ep *embeddingProcessService) processBatchAddModify(ctx context.Context, workspacePath string, events []*model.Event, uploadToken string, maxFileSizeKB int) error {
+	if len(events) == 0 {
+		return nil
+	}
+
+	// 1. 计算changes，服务端已有相同内容的文件直接标记为构建成功
+	var embeddedHashes map[string]string
+	var failedFiles map[string]string
+	embeddingId := utils.GenerateEmbeddingID(workspacePath)
+	if embeddingConfig, err := ep.embeddingRepo.GetEmbeddingConfig(embeddingId); err == nil {
+		embeddedHashes = embeddingConfig.HashTree
+		failedFiles = embeddingConfig.FailedFiles
+	}
+
+	uploadEvents := make([]*model.Event, 0, len(events))
+	changes := make([]*utils.FileStatus, 0, len(events))
+	var skippedEvents []*model.Event
+	var hashFailedIDs []int64
+	for _, event := range events {
 		status := utils.FILE_STATUS_ADDED
 		if event.EventType == model.EventTypeModifyFile {
 			status = utils.FILE_STATUS_MODIFIED
@@ -360,16 +390,51 @@ func (ep *embeddingProcessService) processBatchAddModify(ctx context.Context, wo
 		fileHash, err := buildFileHash(workspacePath, event.SourceFilePath, maxFileSizeKB)
 		if err != nil {
 			ep.logger.Error("failed to build file hash: %v", err)
+			hashFailedIDs = append(hashFailedIDs, event.ID)
 			continue
 		}
 
-		changes[i] = &utils.FileStatus{
+		_, failed := failedFiles[event.SourceFilePath]
+		if hash, ok := embeddedHashes[event.SourceFilePath]; ok && hash == fileHash && !failed {
+			skippedEvents = append(skippedEvents, &model.Event{
+				ID:              event.ID,
+				EmbeddingStatus: model.EmbeddingStatusSuccess,
+				SyncId:          event.SyncId,
+				FileHash:        fileHash,
+			})
+			continue
+		}
+
+		uploadEvents = append(uploadEvents, event)
+		changes = append(changes, &utils.FileStatus{
 			Path:       event.SourceFilePath,
 			TargetPath: event.TargetFilePath,
 			Hash:       fileHash,
 			Status:     status,
+		})
+	}
+
+	if len(hashFailedIDs) > 0 {
+		if err := ep.eventRepo.UpdateEventsEmbeddingStatus(hashFailedIDs, model.EmbeddingStatusUploadFailed); err != nil {
+			ep.logger.Error("failed to update events status to uploadFailed: %v", err)
 		}
 	}
+	if len(skippedEvents) > 0 {
+		ep.logger.Info("skipped %d unchanged files already embedded", len(skippedEvents))
+		if err := ep.eventRepo.UpdateEventsEmbedding(skippedEvents); err != nil {
+			ep.logger.Error("failed to update unchanged events status to success: %v", err)
+		}
+	}
+	if len(uploadEvents) == 0 {
+		return nil
+	}
+	events = uploadEvents
+
+	// 2. 事件领取时已置为上报中
+	eventIDs := make([]int64, len(events))
+	for i, event := range events {
+		eventIDs[i] = event.ID
+	}
 
 	// 3. 使用UploadChangesWithRetry批量上报，传入uploadToken
 	fileStatuses, err := ep.uploadService.UploadChangesWithRetryWithToken(workspacePath, changes, 1, uploadToken)
@@ -511,24 +576,26 @@ func (ep *embeddingProcessService) processBatchRenameDelete(ctx context.Context,
 func buildFileHash(workspacePath string, filePath string, maxFileSizeKB int) (string, error) {
 	// 1. 验证文件路径
 	fullPath := filepath.Join(workspacePath, filePath)
-	if _, err := os.Stat(fullPath); os.IsNotExist(err) {
+	fileInfo, err := os.Stat(fullPath)
+	if os.IsNotExist(err) {
 		return "", fmt.Errorf("file does not exist: %s", fullPath)
 	}
-
-	// 2. 检查文件大小
-	fileInfo, err := os.Stat(fullPath)
 	if err != nil {
 		return "", fmt.Errorf("failed to get file info: %w", err)
 	}
 
+	// 2. 检查文件大小
 	fileSizeKB := float64(fileInfo.Size()) / 1024
 	if fileSizeKB > float64(maxFileSizeKB) {
 		return "", fmt.Errorf("file size %.2fKB exceeds limit %dKB", fileSizeKB, maxFileSizeKB)
 	}
 
-	fileTimestamp := fileInfo.ModTime().UnixMilli()
-
-	return fmt.Sprintf("%d", fileTimestamp), nil
+	// 3. 按内容计算哈希，仅修改时间变化的文件不会重复上传
+	hash, err := utils.HashFileContent(fullPath)
+	if err != nil {
+		return "", err
+	}
+	return utils.FormatFileHash(hash), nil
 }
 
 func (ep *embeddingProcessService) uploadFilePathFailed(event *model.Event, uploadErr error) error {
@@ -602,6 +669,9 @@ func (ep *embeddingProcessService) uploadFilePathFailed(event *model.Event, uplo
 
 // uploadFilePathsFailed 批量处理文件路径失败的情况
 func (ep *embeddingProcessService) uploadFilePathsFailed(workspacePath string, events []*model.Event, uploadErr error) {
+	ep.configMu.Lock()
+	defer ep.configMu.Unlock()
+
 	embeddingId := utils.GenerateEmbeddingID(workspacePath)
 	embeddingConfig, err := ep.embeddingRepo.GetEmbeddingConfig(embeddingId)
 	if err != nil {
@@ -796,6 +866,9 @@ func (ep *embeddingProcessService) CleanWorkspaceFilePath(ctx context.Context, f
 
 // CleanWorkspaceFilePaths 批量删除 workspace 中指定文件的 filepath 记录
 func (ep *embeddingProcessService) CleanWorkspaceFilePaths(ctx context.Context, workspacePath string, events []*model.Event) error {
+	ep.configMu.Lock()
+	defer ep.configMu.Unlock()
+
 	// 获取 embedding 配置
 	embeddingId := utils.GenerateEmbeddingID(workspacePath)
 	embeddingConfig, err := ep.embeddingRepo.GetEmbeddingConfig(embeddingId)
@@ -46,6 +46,9 @@ type ExtensionService interface {
 
 	// GetIndexStatus 获取索引状态
 	GetIndexStatus(ctx context.Context, workspacePath string) (*dto.IndexStatusResponse, error)
+
+	// SearchSymbols 按符号名前缀、子串或模糊匹配搜索工作区内的符号
+	SearchSymbols(ctx context.Context, req *dto.SearchSymbolRequest) (*dto.SymbolSearchData, error)
 }
 
 // CheckIgnoreResult 检查结果
@@ -409,7 +412,7 @@ func (s *extensionService) SwitchIndex(ctx context.Context, workspacePath, switc
 		}
 
 		// switch on, 触发文件扫描
-		go s.scanService.DetectFileChanges(workspacePath)
+		go s.scanService.ReconcileFileChanges(workspacePath)
 	} else {
 		_, err = s.workspaceRepo.GetWorkspaceByPath(workspacePath)
 		if err != nil {
@@ -521,7 +524,7 @@ func (s *extensionService) processEvents(workspacePath, clientID string, events
 				successCount++
 			}
 			// open_workspace 事件触发文件扫描
-			go s.scanService.DetectFileChanges(workspacePath)
+			go s.scanService.ReconcileFileChanges(workspacePath)
 			break
 		}
 
@@ -945,7 +948,7 @@ func (s *extensionService) TriggerIndex(ctx context.Context, workspacePath, inde
 
 	if indexType != dto.IndexTypeCodegraph {
 		// rebuild_workspace 事件触发文件扫描
-		go s.scanService.DetectFileChanges(workspacePath)
+		go s.scanService.ReconcileFileChanges(workspacePath)
 	}
 
 	s.logger.Info("successfully triggered index for workspace: %s", workspacePath)
@@ -1251,3 +1254,8 @@ func (s *extensionService) calculateCodegraphStatus(workspace *model.Workspace)
 
 	return status
 }
+
+// SearchSymbols 按符号名前缀、子串或模糊匹配搜索工作区内的符号
+func (s *extensionService) SearchSymbols(ctx context.Context, req *dto.SearchSymbolRequest) (*dto.SymbolSearchData, error) {
+	return s.codebaseService.SearchSymbols(ctx, req)
+}
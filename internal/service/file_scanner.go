@@ -2,18 +2,28 @@ package service
 
 import (
 	"fmt"
+	"os"
+	"path/filepath"
 	"time"
 
+	"codebase-indexer/internal/config"
 	"codebase-indexer/internal/model"
 	"codebase-indexer/internal/repository"
 	"codebase-indexer/internal/utils"
+	"codebase-indexer/pkg/codegraph/types"
 	"codebase-indexer/pkg/logger"
 )
 
+// codebaseConfigRefreshInterval 文件没有变化时刷新代码库配置注册时间的间隔，需小于注册过期时间
+const codebaseConfigRefreshInterval = 5 * time.Minute
+
 // FileScanService 工作区扫描服务接口
 type FileScanService interface {
 	ScanActiveWorkspaces() ([]*model.Workspace, error)
 	DetectFileChanges(workspacePath string) ([]*model.Event, error)
+	ReconcileFileChanges(workspacePath string) ([]*model.Event, error)
+	DetectPathChanges(workspacePath string, relPaths []string) ([]*model.Event, error)
+	IgnoreFilter(workspacePath string) func(relPath string, isDir bool) bool
 	UpdateWorkspaceStats(workspace *model.Workspace) error
 	MapFileStatusToEventType(status string) string
 }
@@ -64,18 +74,20 @@ func (ws *fileScanService) ScanActiveWorkspaces() ([]*model.Workspace, error) {
 	return activeWorkspaces, nil
 }
 
-// DetectFileChanges 检测文件变更
+// DetectFileChanges 检测文件变更，与上次扫描保存的文件树比较，哈希相同的子树直接跳过
 func (ws *fileScanService) DetectFileChanges(workspacePath string) ([]*model.Event, error) {
-	ws.logger.Info("scanning workspace: %s", workspacePath)
+	return ws.detectFileChanges(workspacePath, false)
+}
 
-	// 获取当前文件哈希树
-	ignoreConfig := ws.fileScanner.LoadIgnoreConfig(workspacePath)
-	currentHashTree, err := ws.fileScanner.ScanCodebase(ignoreConfig, workspacePath)
-	if err != nil {
-		return nil, fmt.Errorf("failed to scan codebase: %w", err)
-	}
+// ReconcileFileChanges 检测文件变更，逐个文件与已向量化的文件核对。
+// 打开、重建工作区会清理未完成的事件，需要据此重新生成
+func (ws *fileScanService) ReconcileFileChanges(workspacePath string) ([]*model.Event, error) {
+	return ws.detectFileChanges(workspacePath, true)
+}
+
+func (ws *fileScanService) detectFileChanges(workspacePath string, reconcile bool) ([]*model.Event, error) {
+	ws.logger.Info("scanning workspace: %s, reconcile: %v", workspacePath, reconcile)
 
-	// 获取上次保存的哈希树
 	// 生成codebaseId
 	codebaseId := utils.GenerateCodebaseID(workspacePath)
 	codebaseConfig, err := ws.storage.GetCodebaseConfig(codebaseId)
@@ -83,46 +95,75 @@ func (ws *fileScanService) DetectFileChanges(workspacePath string) ([]*model.Eve
 		return nil, fmt.Errorf("failed to get codebase config: %w", err)
 	}
 
-	// 更新哈希树
-	codebaseConfig.HashTree = currentHashTree
-	codebaseConfig.RegisterTime = time.Now()
-	err = ws.storage.SaveCodebaseConfig(codebaseConfig)
+	// 以上次保存的文件树为基准扫描，修改时间和大小未变的文件复用内容哈希
+	previousTree, err := ws.storage.GetFileTree(codebaseId)
 	if err != nil {
-		return nil, fmt.Errorf("failed to save codebase config: %w", err)
+		ws.logger.Warn("failed to load file tree of workspace %s, rehash all files: %v", workspacePath, err)
+		previousTree = nil
 	}
-
-	embeddingId := utils.GenerateEmbeddingID(workspacePath)
-	embeddingConfig, err := ws.embeddingRepo.GetEmbeddingConfig(embeddingId)
+	ignoreConfig := ws.fileScanner.LoadIgnoreConfig(workspacePath)
+	currentTree, err := ws.fileScanner.ScanCodebaseTree(ignoreConfig, workspacePath, previousTree)
 	if err != nil {
-		return nil, fmt.Errorf("failed to get embedding config: %w", err)
+		return nil, fmt.Errorf("failed to scan codebase: %w", err)
+	}
+
+	// 计算文件变更。没有上次的文件树或需要核对时与已向量化的文件比较
+	var changes []*utils.FileStatus
+	if reconcile || previousTree == nil {
+		embeddingId := utils.GenerateEmbeddingID(workspacePath)
+		embeddingConfig, err := ws.embeddingRepo.GetEmbeddingConfig(embeddingId)
+		if err != nil {
+			return nil, fmt.Errorf("failed to get embedding config: %w", err)
+		}
+		changes = utils.CalculateFileChanges(currentTree.FileHashes(), embeddingConfig.HashTree)
+	} else {
+		changes = utils.DiffFileTrees(previousTree, currentTree)
+	}
+	var events []*model.Event
+	if len(changes) > 0 {
+		// 事件写入失败时不保存文件树，下次扫描重新检测
+		if events, err = ws.createChangeEvents(workspacePath, changes); err != nil {
+			return nil, err
+		}
+	}
+
+	// 文件树没有变化时不重写，代码库配置只按间隔刷新注册时间
+	treeChanged := previousTree == nil || previousTree.RootHash() != currentTree.RootHash()
+	if treeChanged {
+		ws.logger.Info("workspace %s file tree changed, %d files changed", workspacePath, len(changes))
+		if err = ws.storage.SaveFileTree(codebaseId, currentTree); err != nil {
+			ws.logger.Warn("failed to save file tree of workspace %s: %v", workspacePath, err)
+		}
+	}
+	if treeChanged || time.Since(codebaseConfig.RegisterTime) >= codebaseConfigRefreshInterval {
+		codebaseConfig.RegisterTime = time.Now()
+		if err = ws.storage.SaveCodebaseConfig(codebaseConfig); err != nil {
+			return nil, fmt.Errorf("failed to save codebase config: %w", err)
+		}
 	}
 
-	// 计算文件变更
-	changes := utils.CalculateFileChanges(currentHashTree, embeddingConfig.HashTree)
 	if len(changes) == 0 {
 		// 查询 open_workspace 事件并更新状态为完成
 		ws.updateNonSuccessOpenOrRebuildEventStatus(workspacePath)
 		return nil, nil
 	}
+	return events, nil
+}
 
-	// 在生成新事件后，查询工作区内所有现有事件
-	existingEvents, err := ws.eventRepo.GetEventsByWorkspaceForDeduplication(workspacePath)
+// createChangeEvents 按文件变更生成事件，与工作区已有事件去重后批量写入
+func (ws *fileScanService) createChangeEvents(workspacePath string, changes []*utils.FileStatus) ([]*model.Event, error) {
+	// 只查询变更路径的最新事件，用于去重
+	paths := make([]string, len(changes))
+	for i, change := range changes {
+		paths[i] = change.Path
+	}
+	eventPathMap, err := ws.eventRepo.GetLatestEventsBySourcePaths(workspacePath, paths)
 	if err != nil {
 		ws.logger.Error("failed to get existing events for deduplication: %v", err)
 		// 降级处理：继续执行，但跳过去重逻辑
 		return ws.handleEventsWithoutDeduplication(changes, workspacePath)
 	}
 
-	// 构建源文件路径到事件记录的映射，用于快速查找
-	eventPathMap := make(map[string]*model.Event)
-	for _, existingEvent := range existingEvents {
-		// 如果同一路径有多个事件，保留最新的一个
-		if currentEvent, exists := eventPathMap[existingEvent.SourceFilePath]; !exists ||
-			existingEvent.CreatedAt.After(currentEvent.CreatedAt) {
-			eventPathMap[existingEvent.SourceFilePath] = existingEvent
-		}
-	}
-
 	// 生成事件并进行去重处理
 	var events []*model.Event
 	var eventsToCreate []*model.Event // 需要批量创建的事件（新文件 + building时需创建的）
@@ -207,6 +248,114 @@ func (ws *fileScanService) DetectFileChanges(workspacePath string) ([]*model.Eve
 	return events, nil
 }
 
+// DetectPathChanges 检测监听到的路径变更，只检查这些路径，不遍历整个工作区。
+// 路径可以是文件或目录，不存在的路径按删除处理
+func (ws *fileScanService) DetectPathChanges(workspacePath string, relPaths []string) ([]*model.Event, error) {
+	embeddingId := utils.GenerateEmbeddingID(workspacePath)
+	embeddingConfig, err := ws.embeddingRepo.GetEmbeddingConfig(embeddingId)
+	if err != nil {
+		return nil, fmt.Errorf("failed to get embedding config: %w", err)
+	}
+	ignoreConfig := ws.fileScanner.LoadIgnoreConfig(workspacePath)
+	if ignoreConfig == nil {
+		return nil, fmt.Errorf("failed to load ignore config")
+	}
+
+	currentHashTree := make(map[string]string)
+	checked := make(map[string]bool) // 已检查的路径，值表示是否存在
+	for _, relPath := range relPaths {
+		ws.collectPathHashes(workspacePath, relPath, ignoreConfig, currentHashTree, checked)
+	}
+
+	var changes []*utils.FileStatus
+	for relPath, hash := range currentHashTree {
+		oldHash, ok := embeddingConfig.HashTree[relPath]
+		switch {
+		case !ok:
+			changes = append(changes, &utils.FileStatus{Path: relPath, Hash: hash, Status: utils.FILE_STATUS_ADDED})
+		case oldHash != hash:
+			changes = append(changes, &utils.FileStatus{Path: relPath, Hash: hash, Status: utils.FILE_STATUS_MODIFIED})
+		}
+	}
+	// 检查过但已不存在或被忽略的文件，以及已删除目录下的文件
+	for relPath, hash := range embeddingConfig.HashTree {
+		if _, ok := currentHashTree[relPath]; ok {
+			continue
+		}
+		if !removedByCheckedPath(relPath, checked) {
+			continue
+		}
+		changes = append(changes, &utils.FileStatus{Path: relPath, Hash: hash, Status: utils.FILE_STATUS_DELETED})
+	}
+	if len(changes) == 0 {
+		return nil, nil
+	}
+	ws.logger.Info("detected %d changes from %d watched paths in workspace: %s", len(changes), len(relPaths), workspacePath)
+	return ws.createChangeEvents(workspacePath, changes)
+}
+
+// collectPathHashes 计算路径下未被忽略的文件哈希，目录递归
+func (ws *fileScanService) collectPathHashes(workspacePath, relPath string, ignoreConfig *config.IgnoreConfig,
+	hashTree map[string]string, checked map[string]bool) {
+	path := filepath.Join(workspacePath, relPath)
+	info, err := os.Stat(path)
+	if err != nil {
+		checked[relPath] = false
+		return
+	}
+	checked[relPath] = true
+	fileInfo := &types.FileInfo{Name: info.Name(), Path: path, Size: info.Size(), IsDir: info.IsDir()}
+	if skip, err := ws.fileScanner.CheckIgnoreFile(ignoreConfig, workspacePath, fileInfo); err != nil || skip {
+		return
+	}
+	if !info.IsDir() {
+		hash, err := utils.HashFileContent(path)
+		if err != nil {
+			ws.logger.Warn("failed to hash file %s: %v", path, err)
+			return
+		}
+		hashTree[relPath] = utils.FormatFileHash(hash)
+		return
+	}
+	entries, err := os.ReadDir(path)
+	if err != nil {
+		ws.logger.Warn("failed to read directory %s: %v", path, err)
+		return
+	}
+	for _, entry := range entries {
+		childPath := filepath.Join(relPath, entry.Name())
+		if _, ok := checked[childPath]; ok {
+			continue
+		}
+		ws.collectPathHashes(workspacePath, childPath, ignoreConfig, hashTree, checked)
+	}
+}
+
+// removedByCheckedPath 文件本身或其所在目录已检查过，且当前不在哈希树中，说明已删除或被忽略
+func removedByCheckedPath(relPath string, checked map[string]bool) bool {
+	for p := relPath; p != "." && p != string(filepath.Separator); p = filepath.Dir(p) {
+		if _, ok := checked[p]; ok {
+			return true
+		}
+	}
+	return false
+}
+
+// IgnoreFilter 返回工作区的忽略规则判断函数，规则在调用时加载一次
+func (ws *fileScanService) IgnoreFilter(workspacePath string) func(relPath string, isDir bool) bool {
+	ignoreConfig := ws.fileScanner.LoadIgnoreConfig(workspacePath)
+	if ignoreConfig == nil || ignoreConfig.IgnoreRules == nil {
+		return func(string, bool) bool { return false }
+	}
+	ignoreRules := ignoreConfig.IgnoreRules
+	return func(relPath string, isDir bool) bool {
+		if isDir {
+			return ignoreRules.MatchesPath(relPath + "/")
+		}
+		return ignoreRules.MatchesPath(relPath)
+	}
+}
+
 func (ws *fileScanService) updateNonSuccessOpenOrRebuildEventStatus(workspacePath string) {
 	openWorkspaceEvents, err := ws.eventRepo.GetEventsByTypeAndStatusAndWorkspaces(
 		[]string{model.EventTypeOpenWorkspace, model.EventTypeRebuildWorkspace},
@@ -264,7 +413,11 @@ func (ws *fileScanService) UpdateWorkspaceStats(workspace *model.Workspace) erro
 	if err != nil {
 		return fmt.Errorf("failed to get codebase config: %w", err)
 	}
+	// 文件数取自上次扫描保存的文件树
 	fileNum := len(codebaseConfig.HashTree)
+	if tree, err := ws.storage.GetFileTree(codebaseId); err == nil && tree != nil {
+		fileNum = tree.FileCount()
+	}
 
 	// 更新工作区文件数量
 	updateWorkspace := model.Workspace{
@@ -22,6 +22,9 @@ type Indexer interface {
 	// IndexFiles 根据工作区路径、文件路径，批量保存索引
 	IndexFiles(ctx context.Context, workspacePath string, filePaths []string) error
 
+	// UpdateFileIndex 文件修改后增量更新索引
+	UpdateFileIndex(ctx context.Context, workspacePath string, filePath string) error
+
 	// RenameIndexes 重命名索引，根据路径（文件或文件夹）
 	RenameIndexes(ctx context.Context, workspacePath string, sourceFilePath string, targetFilePath string) error
 
@@ -40,6 +43,15 @@ type Indexer interface {
 	// QueryCallGraph 查询代码片段内部元素或单符号的调用链及其里面的元素定义，支持代码片段检索
 	QueryCallGraph(ctx context.Context, opts *types.QueryCallGraphOptions) ([]*types.RelationNode, error)
 
+	// SearchSymbols 按符号名前缀、子串或模糊匹配搜索符号
+	SearchSymbols(ctx context.Context, opts *types.SearchSymbolOptions) ([]*types.SymbolSearchResult, error)
+
+	// ExportSnapshots 导出工作区内各项目的索引快照到目录，返回写入的文件。dir 为空时写入配置的共享快照目录
+	ExportSnapshots(ctx context.Context, workspacePath string, dir string) ([]string, error)
+
+	// PreopenWorkspace 工作区激活时在后台打开其项目数据库
+	PreopenWorkspace(ctx context.Context, workspacePath string)
+
 	// GetSummary 获取代码图摘要信息
 	GetSummary(ctx context.Context, workspacePath string) (*types.CodeGraphSummary, error)
 
@@ -1,7 +1,8 @@
 package indexer
 
 import (
-	"codebase-indexer/pkg/codegraph/cache"
+	"codebase-indexer/pkg/codegraph/parser"
+	"codebase-indexer/pkg/codegraph/pool"
 	"codebase-indexer/pkg/codegraph/proto"
 	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
 	"codebase-indexer/pkg/codegraph/types"
@@ -10,6 +11,7 @@ import (
 	"context"
 	"errors"
 	"fmt"
+	"sync"
 	"time"
 )
 
@@ -58,69 +60,144 @@ type ProgressInfo struct {
 	WorkspacePath string
 }
 
-// processBatch 处理单个批次的文件
-func (idx *Indexer) processBatch(ctx context.Context, batchId int, params *BatchProcessParams,
-	symbolCache *cache.LRUCache[*codegraphpb.SymbolOccurrence]) (*types.IndexTaskMetrics, error) {
-	batchStartTime := time.Now()
+// batchOutcome 单个批次的处理结果，按批次顺序汇总，保证统计结果与并发执行顺序无关
+type batchOutcome struct {
+	metrics *types.IndexTaskMetrics
+	err     error
+}
+
+// pipelineBatch 在流水线各阶段之间传递的批次
+type pipelineBatch struct {
+	id          int
+	index       int
+	params      *BatchProcessParams
+	start       time.Time
+	tables      []*parser.FileElementTable
+	protoTables []*codegraphpb.FileElementTable
+	metrics     *types.IndexTaskMetrics
+	bytes       int64 // 占用的在途字节预算
+	timings     stageTimings
+}
 
+// parseBatch 解析阶段：按文件大小占用在途字节预算后读取并解析文件，再按实际读取的字节数调整占用。
+// 返回 false 表示批次已结束，不再进入后续阶段，占用的预算已释放
+func (idx *Indexer) parseBatch(ctx context.Context, batch *pipelineBatch, budget *byteBudget,
+	outcomes []*batchOutcome) bool {
+	params := batch.params
 	idx.logger.Info("batch-%d start, [%d:%d]/%d, batch_size %d",
-		batchId, params.BatchStart, params.BatchEnd, params.TotalFiles, params.BatchSize)
+		batch.id, params.BatchStart, params.BatchEnd, params.TotalFiles, params.BatchSize)
 
-	// 解析文件
-	elementTables, metrics, err := idx.parseFiles(ctx, params.SourceFiles)
+	var estimatedBytes int64
+	for _, f := range params.SourceFiles {
+		estimatedBytes += f.Size
+	}
+	waitStart := time.Now()
+	reserved, err := budget.acquire(ctx, estimatedBytes)
+	batch.timings.wait = time.Since(waitStart)
 	if err != nil {
-		return nil, fmt.Errorf("parse files failed: %w", err)
+		outcomes[batch.index] = &batchOutcome{err: fmt.Errorf("wait for inflight budget: %w", err)}
+		return false
+	}
+
+	parseStart := time.Now()
+	elementTables, metrics, contentBytes, err := idx.parseFiles(ctx, params.SourceFiles)
+	batch.timings.parse = time.Since(parseStart)
+	if err != nil {
+		budget.release(reserved)
+		outcomes[batch.index] = &batchOutcome{err: fmt.Errorf("parse files failed: %w", err)}
+		return false
 	}
 	if len(elementTables) == 0 {
-		return metrics, nil
+		budget.release(reserved)
+		outcomes[batch.index] = &batchOutcome{metrics: metrics}
+		return false
 	}
+	batch.bytes = budget.resize(reserved, contentBytes)
+	batch.tables = elementTables
+	batch.metrics = metrics
+	return true
+}
 
-	idx.logger.Info("batch-%d [%d:%d]/%d parse files end, cost %d ms", batchId,
-		params.BatchStart, params.BatchEnd, params.TotalFiles, time.Since(batchStartTime).Milliseconds())
+// analyzeBatch 分析阶段：写入符号表，预处理import，转换为proto
+func (idx *Indexer) analyzeBatch(ctx context.Context, batch *pipelineBatch) error {
+	params := batch.params
+	metrics := batch.metrics
 
-	// 项目符号表存储
+	// 项目符号表存储，按文件写增量，各批次之间无需串行
 	symbolStart := time.Now()
-
-	symbolMetrics, err := idx.analyzer.SaveSymbolOccurrences(ctx, params.ProjectUuid, params.TotalFiles, elementTables, symbolCache)
+	symbolMetrics, err := idx.analyzer.SaveSymbolOccurrences(ctx, params.ProjectUuid, params.TotalFiles, batch.tables)
+	batch.timings.symbols = time.Since(symbolStart)
 	metrics.TotalSymbols += symbolMetrics.TotalSymbols
 	metrics.TotalSavedSymbols += symbolMetrics.TotalSavedSymbols
 	metrics.TotalVariables += symbolMetrics.TotalVariables
 	metrics.TotalSavedVariables += symbolMetrics.TotalSavedVariables
 	if err != nil {
-		return nil, fmt.Errorf("save symbol definitions failed: %w", err)
+		return fmt.Errorf("save symbol definitions failed: %w", err)
 	}
-	idx.logger.Info("batch-%d batch [%d:%d]/%d save symbols end, cost %d ms", batchId,
-		params.BatchStart, params.BatchEnd, params.TotalFiles, time.Since(symbolStart).Milliseconds())
 
 	// 预处理import
-	if err := idx.preprocessImports(ctx, elementTables, params.Project); err != nil {
-		idx.logger.Error("batch-%d preprocess import error: %v", utils.TruncateError(err))
+	importStart := time.Now()
+	if err := idx.preprocessImports(ctx, batch.tables, params.Project); err != nil {
+		idx.logger.Error("batch-%d preprocess import error: %v", batch.id, utils.TruncateError(err))
 	}
+	batch.timings.imports = time.Since(importStart)
 
-	// element存储，后面依赖分析，基于磁盘，避免大型项目占用太多内存
-	protoElementTables := proto.FileElementTablesToProto(elementTables)
-	batchSaveStart := time.Now()
-	// 关系索引存储
-	if err = idx.storage.BatchSave(ctx, params.ProjectUuid, workspace.FileElementTables(protoElementTables)); err != nil {
-		metrics.TotalFailedFiles += params.BatchSize
-		for _, f := range params.SourceFiles {
-			metrics.FailedFilePaths = append(metrics.FailedFilePaths, f.Path)
-		}
-		return nil, fmt.Errorf("batch save element tables failed: %w", err)
+	encodeStart := time.Now()
+	// 逐个文件转换，转换完立即释放该文件的解析结果，不必等整批转换完
+	batch.protoTables = make([]*codegraphpb.FileElementTable, len(batch.tables))
+	for i, ft := range batch.tables {
+		batch.protoTables[i] = proto.FileElementTableToProto(ft)
+		batch.tables[i] = nil
 	}
+	batch.timings.encode = time.Since(encodeStart)
+	batch.tables = nil
+	return nil
+}
 
-	idx.logger.Info("batch-%d [%d:%d]/%d save element_tables end, cost %d ms, batch cost %d ms", batchId,
-		params.BatchStart, params.BatchEnd, params.TotalFiles, time.Since(batchSaveStart).Milliseconds(),
-		time.Since(batchStartTime).Milliseconds())
+// writeBatch 写入阶段：替换被调用者索引，写入文件元素表
+func (idx *Indexer) writeBatch(ctx context.Context, batch *pipelineBatch) error {
+	params := batch.params
+	metrics := batch.metrics
+	protoElementTables := batch.protoTables
 
-	return metrics, nil
+	// 被调用者反向索引和延迟解析的结果，需要在覆盖旧的element_table之前替换
+	calleeStart := time.Now()
+	oldTables := idx.getStoredFileElementTables(ctx, params.ProjectUuid, protoElementTables)
+	if err := idx.replaceCalleeIndex(ctx, params.ProjectUuid, oldTables, protoElementTables); err != nil {
+		idx.logger.Error("batch-%d save callee index error: %v", batch.id, utils.TruncateError(err))
+	}
+	unlockResolve, err := idx.markResolveStale(ctx, params.ProjectUuid, oldTables, protoElementTables)
+	if err != nil {
+		idx.logger.Error("batch-%d mark resolve stale error: %v", batch.id, utils.TruncateError(err))
+	}
+	batch.timings.callee = time.Since(calleeStart)
+
+	// element存储，后面依赖分析，基于磁盘，避免大型项目占用太多内存
+	writeStart := time.Now()
+	err = idx.storage.BatchSave(ctx, params.ProjectUuid, workspace.FileElementTables(protoElementTables))
+	unlockResolve()
+	batch.timings.write = time.Since(writeStart)
+	savedPaths := make([]string, 0, len(protoElementTables))
+	for _, ft := range protoElementTables {
+		savedPaths = append(savedPaths, ft.Path)
+	}
+	idx.invalidateIndex(params.ProjectUuid, savedPaths...)
+	if err != nil {
+		// 已解析成功的文件全部记为失败，解析阶段失败的文件已经记录过
+		metrics.TotalFailedFiles += len(protoElementTables)
+		metrics.FailedFilePaths = append(metrics.FailedFilePaths, savedPaths...)
+		return fmt.Errorf("batch save element tables failed: %w", err)
+	}
+	return nil
 }
 
-// indexFilesInBatches 批量处理文件
+// indexFilesInBatches 批量处理文件。批次经过 解析 -> 分析 -> 写入 三个阶段，阶段之间用有界通道连接：
+// 解析由 Concurrency 个协程并发执行，分析和写入各一个协程按到达顺序处理，
+// 后一批解析的同时前一批在写入。在途批次的源码字节数受 MaxInflightBytes 限制
 func (idx *Indexer) indexFilesInBatches(ctx context.Context, params *BatchProcessingParams) (*BatchProcessingResult, error) {
 
-	idx.logger.Info("%s, concurrency: %d, batch_size: %d cache_capacity: %d",
-		params.Project.Path, idx.config.MaxConcurrency, idx.config.MaxBatchSize, idx.config.CacheCapacity)
+	idx.logger.Info("%s, concurrency: %d, batch_size: %d, max_inflight_bytes: %d",
+		params.Project.Path, params.Concurrency, params.BatchSize, idx.config.MaxInflightBytes)
 
 	startTime := time.Now()
 	totalNeedIndexFiles := len(params.NeedIndexSourceFiles)
@@ -132,67 +209,140 @@ func (idx *Indexer) indexFilesInBatches(ctx context.Context, params *BatchProces
 		TotalFiles:      totalNeedIndexFiles,
 		FailedFilePaths: make([]string, 0, totalNeedIndexFiles/4), // 预估失败文件数约为文件数的5%
 	}
-	// 缓存
-	symbolCache := cache.NewLRUCache[*codegraphpb.SymbolOccurrence](1000, idx.config.CacheCapacity)
-	defer symbolCache.Purge()
+	batchSize := utils.Max(params.BatchSize, 1)
+	batchCount := (totalNeedIndexFiles + batchSize - 1) / batchSize
+	// 每个批次只写自己的槽位，汇总在全部批次结束后按批次顺序进行
+	outcomes := make([]*batchOutcome, batchCount)
 
-	var processedFilesCnt int
-	var batchId int
-	// 处理批次
-	for m := 0; m < totalNeedIndexFiles; {
-		batch := utils.Min(totalNeedIndexFiles-m, params.BatchSize)
-		batchStart, batchEnd := m, m+batch
-		sourceFilesBatch := params.NeedIndexSourceFiles[batchStart:batchEnd]
-		batchId++
-		// 构建批处理参数
-		batchParams := &BatchProcessParams{
-			ProjectUuid: params.ProjectUuid,
-			SourceFiles: sourceFilesBatch,
-			BatchStart:  batchStart,
-			BatchEnd:    batchEnd,
-			BatchSize:   batch,
-			TotalFiles:  totalNeedIndexFiles,
-			Project:     params.Project,
-		}
+	concurrency := utils.Max(params.Concurrency, 1)
+	budget := newByteBudget(int64(idx.config.MaxInflightBytes))
+	parsed := make(chan *pipelineBatch, concurrency)
+	analyzed := make(chan *pipelineBatch, 1)
+
+	taskPool := pool.NewTaskPool(concurrency, idx.logger)
+	defer taskPool.Close()
+	// 已解析、尚未结束写入的批次
+	var inflight sync.WaitGroup
+	yielder := yielderFromContext(ctx)
 
-		// 提交任务
-		err := func(ctx context.Context, taskID int) error {
-			batchStartTime := time.Now()
-			metrics, err := idx.processBatch(ctx, taskID, batchParams, symbolCache)
+	// 解析阶段：提交批次到任务池，全部完成后关闭通道
+	var submitErr error
+	go func() {
+		defer close(parsed)
+		for batchIndex := 0; batchIndex < batchCount; batchIndex++ {
+			if yielder != nil && batchIndex > 0 && yielder.Preempted() {
+				// 在途批次写完再让出，让出期间执行的任务不会被之后写入的旧内容覆盖
+				taskPool.Wait()
+				inflight.Wait()
+				if err := yielder.Yield(ctx); err != nil {
+					submitErr = fmt.Errorf("yield before batch-%d err:%w", batchIndex+1, err)
+					break
+				}
+			}
+			batchStart := batchIndex * batchSize
+			batchEnd := utils.Min(batchStart+batchSize, totalNeedIndexFiles)
+			batch := &pipelineBatch{
+				id:    batchIndex + 1,
+				index: batchIndex,
+				// 构建批处理参数
+				params: &BatchProcessParams{
+					ProjectUuid: params.ProjectUuid,
+					SourceFiles: params.NeedIndexSourceFiles[batchStart:batchEnd],
+					BatchStart:  batchStart,
+					BatchEnd:    batchEnd,
+					BatchSize:   batchEnd - batchStart,
+					TotalFiles:  totalNeedIndexFiles,
+					Project:     params.Project,
+				},
+			}
+			err := taskPool.Submit(ctx, func(ctx context.Context, _ uint64) {
+				batch.start = time.Now()
+				if idx.parseBatch(ctx, batch, budget, outcomes) {
+					inflight.Add(1)
+					parsed <- batch
+				}
+			})
 			if err != nil {
-				idx.logger.Debug("batch-%d process batch err:%v", taskID, err)
-				return fmt.Errorf("process batch err:%w", err)
+				idx.logger.Debug("%s submit task err:%v", params.ProjectUuid, err)
+				submitErr = fmt.Errorf("submit batch-%d err:%w", batch.id, err)
+				break
 			}
+		}
+		taskPool.Wait()
+	}()
 
-			processedFilesCnt += metrics.TotalFiles - metrics.TotalFailedFiles
-			projectMetrics.TotalFailedFiles += metrics.TotalFailedFiles
-			projectMetrics.TotalSymbols += metrics.TotalSymbols
-			projectMetrics.TotalSavedSymbols += metrics.TotalSavedSymbols
-			projectMetrics.TotalVariables += metrics.TotalVariables
-			projectMetrics.TotalSavedVariables += metrics.TotalSavedVariables
-			projectMetrics.FailedFilePaths = append(projectMetrics.FailedFilePaths, metrics.FailedFilePaths...)
-			//TODO 更新进度
-			batchUpdateStart := time.Now()
-			if err := idx.updateProgress(ctx, &ProgressInfo{
-				Total:         totalNeedIndexFiles,
-				Processed:     processedFilesCnt,
-				PreviousNum:   params.PreviousFileNum,
-				WorkspacePath: params.WorkspacePath,
-			}); err != nil {
-				return fmt.Errorf("update progress failed: %w", err)
+	// 分析阶段
+	go func() {
+		defer close(analyzed)
+		for batch := range parsed {
+			if err := idx.analyzeBatch(ctx, batch); err != nil {
+				budget.release(batch.bytes)
+				outcomes[batch.index] = &batchOutcome{err: err}
+				inflight.Done()
+				idx.logger.Debug("batch-%d process batch err:%v", batch.id, err)
+				continue
 			}
+			analyzed <- batch
+		}
+	}()
 
-			idx.logger.Info("update batch-%d workspace %s successful, file num %d/%d, cache size %d, cost %d ms, batch %d cost %d ms",
-				taskID, params.WorkspacePath, processedFilesCnt+params.PreviousFileNum,
-				totalNeedIndexFiles, symbolCache.Len(), time.Since(batchUpdateStart).Milliseconds(), batch, time.Since(batchStartTime).Milliseconds())
-			return nil
-		}(ctx, batchId)
+	// 写入阶段，进度只在这里更新，无需加锁
+	var processedFilesCnt int
+	var totalTimings stageTimings
+	for batch := range analyzed {
+		err := idx.writeBatch(ctx, batch)
+		budget.release(batch.bytes)
+		batch.protoTables = nil
+		outcomes[batch.index] = &batchOutcome{metrics: batch.metrics, err: err}
+		inflight.Done()
+		totalTimings.add(batch.timings)
+		batch.timings.observe()
+		idx.logger.Info("batch-%d [%d:%d]/%d end, %s, batch cost %d ms", batch.id, batch.params.BatchStart,
+			batch.params.BatchEnd, batch.params.TotalFiles, batch.timings, time.Since(batch.start).Milliseconds())
 		if err != nil {
-			idx.logger.Debug("%s submit task err:%v", params.ProjectUuid, err)
+			idx.logger.Debug("batch-%d process batch err:%v", batch.id, err)
+			continue
 		}
 
-		m += batch
+		processedFilesCnt += batch.metrics.TotalFiles - batch.metrics.TotalFailedFiles
+		if err := idx.updateProgress(ctx, &ProgressInfo{
+			Total:         totalNeedIndexFiles,
+			Processed:     processedFilesCnt,
+			PreviousNum:   params.PreviousFileNum,
+			WorkspacePath: params.WorkspacePath,
+		}); err != nil {
+			idx.logger.Debug("batch-%d update progress failed: %v", batch.id, err)
+			continue
+		}
+		idx.logger.Info("update batch-%d workspace %s successful, file num %d/%d", batch.id, params.WorkspacePath,
+			processedFilesCnt+params.PreviousFileNum, totalNeedIndexFiles)
+	}
+	// analyzed 关闭时解析协程已经结束
+	if submitErr != nil {
+		errs = append(errs, submitErr)
+	}
+	idx.logger.Info("%s index stages: %s, total cost %d ms", params.ProjectUuid, totalTimings,
+		time.Since(startTime).Milliseconds())
+
+	// 按批次顺序汇总统计，失败文件列表的顺序与输入顺序一致
+	processedFilesCnt = 0
+	for _, outcome := range outcomes {
+		// 未执行（上下文取消或提交失败）的批次
+		if outcome == nil || outcome.metrics == nil {
+			continue
+		}
+		metrics := outcome.metrics
+		if outcome.err == nil {
+			processedFilesCnt += metrics.TotalFiles - metrics.TotalFailedFiles
+		}
+		projectMetrics.TotalFailedFiles += metrics.TotalFailedFiles
+		projectMetrics.TotalSymbols += metrics.TotalSymbols
+		projectMetrics.TotalSavedSymbols += metrics.TotalSavedSymbols
+		projectMetrics.TotalVariables += metrics.TotalVariables
+		projectMetrics.TotalSavedVariables += metrics.TotalSavedVariables
+		projectMetrics.FailedFilePaths = append(projectMetrics.FailedFilePaths, metrics.FailedFilePaths...)
 	}
+	recordTaskMetrics(projectMetrics)
 
 	// 最终更新进度
 	if err := idx.updateProgress(ctx, &ProgressInfo{
@@ -0,0 +1,58 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/store"
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/workspace"
+	"codebase-indexer/test/mocks"
+	"context"
+	"fmt"
+	"path/filepath"
+	"testing"
+
+	"github.com/golang/mock/gomock"
+	"github.com/stretchr/testify/assert"
+)
+
+func TestIndexFilesInBatches_DeterministicFailedFiles(t *testing.T) {
+	ctrl := gomock.NewController(t)
+	defer ctrl.Finish()
+
+	workspaceRepo := mocks.NewMockWorkspaceRepository(ctrl)
+	workspaceRepo.EXPECT().UpdateCodegraphInfo(gomock.Any(), gomock.Any(), gomock.Any()).Return(nil).AnyTimes()
+
+	logger := &store.MockLogger{}
+	idx := &Indexer{
+		workspaceReader:     workspace.NewWorkSpaceReader(logger),
+		workspaceRepository: workspaceRepo,
+		config:              &Config{CacheCapacity: 100},
+		logger:              logger,
+	}
+
+	// 文件不存在，读取失败，全部记为失败文件
+	dir := t.TempDir()
+	files := make([]*types.FileWithModTimestamp, 0, 10)
+	expectedFailed := make([]string, 0, 10)
+	for i := 0; i < 10; i++ {
+		path := filepath.Join(dir, fmt.Sprintf("missing_%d.go", i))
+		files = append(files, &types.FileWithModTimestamp{Path: path, ModTime: int64(i)})
+		expectedFailed = append(expectedFailed, path)
+	}
+
+	result, err := idx.indexFilesInBatches(context.Background(), &BatchProcessingParams{
+		ProjectUuid:          "test-project",
+		NeedIndexSourceFiles: files,
+		TotalFilesCnt:        len(files),
+		Project:              &workspace.Project{Path: dir},
+		WorkspacePath:        dir,
+		Concurrency:          4,
+		BatchSize:            3,
+	})
+
+	assert.NoError(t, err)
+	assert.Equal(t, 0, result.ParsedFilesCount)
+	assert.Equal(t, 10, result.ProjectMetrics.TotalFiles)
+	assert.Equal(t, 10, result.ProjectMetrics.TotalFailedFiles)
+	// 并发执行时失败文件也按输入顺序汇总
+	assert.Equal(t, expectedFailed, result.ProjectMetrics.FailedFilePaths)
+}
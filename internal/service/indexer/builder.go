@@ -37,8 +37,15 @@ func (idx *Indexer) IndexWorkspace(ctx context.Context, workspacePath string) (*
 
 	var errs []error
 
-	// 循环项目，逐个处理
-	for _, project := range projects {
+	// 循环项目，逐个处理，项目之间也是让出点
+	yielder := yielderFromContext(ctx)
+	for i, project := range projects {
+		if yielder != nil && i > 0 && yielder.Preempted() {
+			if err := yielder.Yield(ctx); err != nil {
+				errs = append(errs, err)
+				break
+			}
+		}
 		projectTaskMetrics, err := idx.indexProject(ctx, workspacePath, project)
 		if err != nil {
 			idx.logger.Error("index project %s err: %v",
@@ -79,7 +86,7 @@ func (idx *Indexer) indexProject(ctx context.Context, workspacePath string, proj
 	databasePreviousFileNum := workspaceModel.CodegraphFileNum
 
 	// 收集要处理的源码文件
-	sourceFileTimestamps, err := idx.collectFiles(ctx, workspacePath, project.Path)
+	sourceFileTimestamps, sourceFileSizes, err := idx.collectFiles(ctx, workspacePath, project.Path)
 	if err != nil {
 		return &types.IndexTaskMetrics{TotalFiles: 0}, []error{fmt.Errorf("collect project files err:%v", err)}
 	}
@@ -89,17 +96,38 @@ func (idx *Indexer) indexProject(ctx context.Context, workspacePath string, proj
 		idx.logger.Info("found no source files in project %s, not index.", project.Path)
 		return &types.IndexTaskMetrics{TotalFiles: 0}, nil
 	}
+	// 首次索引时优先导入快照，之后只需索引内容与快照不一致的文件
+	idx.restoreSnapshot(ctx, project, sourceFileTimestamps)
+
 	// 校验文件时间戳和索引时间戳，比对需要索引
 	filterStart := time.Now()
-	needIndexFiles := idx.filterSourceFilesByTimestamp(ctx, projectUuid, sourceFileTimestamps)
+	needIndexFiles := idx.filterSourceFilesByTimestamp(ctx, projectUuid, sourceFileTimestamps, sourceFileSizes)
 	// gc
-	sourceFileTimestamps = nil
+	sourceFileTimestamps, sourceFileSizes = nil, nil
 
 	filteredCnt := totalFilesCnt - len(needIndexFiles)
 
 	idx.logger.Info("workspace %s filter files by timestamp cost %d ms, total %d files, remaining %d files, filtered %d files.", workspacePath,
 		time.Since(filterStart).Milliseconds(), totalFilesCnt, len(needIndexFiles), filteredCnt)
 
+	// 被调用者反向索引随批次增量维护，索引前确保已有索引的版本是最新的
+	if err := idx.ensureCalleeIndex(ctx, projectUuid); err != nil {
+		idx.logger.Error("project %s ensure callee index err: %v", project.Path, err)
+	}
+
+	// 首次全量索引写入量大，使用存储的批量导入模式，结束后统一压缩
+	if len(needIndexFiles) > 0 && !idx.projectIndexed(ctx, projectUuid) {
+		if err := idx.storage.BeginBulkLoad(ctx, projectUuid); err != nil {
+			idx.logger.Error("project %s begin bulk load err: %v", project.Path, err)
+		} else {
+			defer func() {
+				if err := idx.storage.EndBulkLoad(ctx, projectUuid); err != nil {
+					idx.logger.Error("project %s end bulk load err: %v", project.Path, err)
+				}
+			}()
+		}
+	}
+
 	// 阶段1-3：批量处理文件（解析、检查、保存符号表）
 	batchParams := &BatchProcessingParams{
 		ProjectUuid:          projectUuid,
@@ -117,6 +145,8 @@ func (idx *Indexer) indexProject(ctx context.Context, workspacePath string, proj
 	if err != nil {
 		return &types.IndexTaskMetrics{TotalFiles: 0}, []error{err}
 	}
+	// 阶段4：所有批次写入后，延迟解析跨文件的调用、引用
+	idx.resolveProject(ctx, projectUuid, true)
 
 	idx.logger.Info("project %s files parse finish. cost %d ms, visit %d files, "+
 		"parsed %d files successfully, failed %d files, total symbols: %d, saved symbols %d, total variables %d, saved variables %d",
@@ -132,9 +162,23 @@ func (idx *Indexer) indexProject(ctx context.Context, workspacePath string, proj
 	return batchResult.ProjectMetrics, nil
 }
 
-// filterSourceFilesByTimestamp 根据时间戳过滤需要索引的文件
-func (idx *Indexer) filterSourceFilesByTimestamp(ctx context.Context, projectUuid string, sourceFileTimestamps map[string]int64) []*types.FileWithModTimestamp {
-	iter := idx.storage.Iter(ctx, projectUuid)
+// projectIndexed 项目是否已有元素表索引，只读取第一个key
+func (idx *Indexer) projectIndexed(ctx context.Context, projectUuid string) bool {
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.PathKeySystemPrefix)
+	if iter == nil {
+		return false
+	}
+	defer iter.Close()
+	return iter.Next()
+}
+
+// filterSourceFilesByTimestamp 根据时间戳过滤需要索引的文件，sourceFileSizes 为收集时的文件大小
+func (idx *Indexer) filterSourceFilesByTimestamp(ctx context.Context, projectUuid string, sourceFileTimestamps map[string]int64,
+	sourceFileSizes map[string]int64) []*types.FileWithModTimestamp {
+	// 导入快照时确认内容未变的文件，修改时间没变就无需重新索引
+	adopted := idx.adoptedSnapshotFiles(ctx, projectUuid)
+	// 只遍历元素表，不读取符号表等其他类型的值
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.PathKeySystemPrefix)
 	defer func(iter store.Iterator) {
 		err := iter.Close()
 		if err != nil {
@@ -142,9 +186,6 @@ func (idx *Indexer) filterSourceFilesByTimestamp(ctx context.Context, projectUui
 		}
 	}(iter)
 	for iter.Next() {
-		if !store.IsElementPathKey(iter.Key()) {
-			continue
-		}
 		key, err := store.ToElementPathKey(iter.Key())
 		if err != nil {
 			idx.logger.Error("convert key %s to element_path_key err:%v", iter.Key(), err)
@@ -159,14 +200,15 @@ func (idx *Indexer) filterSourceFilesByTimestamp(ctx context.Context, projectUui
 			idx.logger.Error("unmarshal key %s element_table value err:%v", iter.Key(), err)
 			continue
 		}
-		if elementTable.Timestamp == fileTimestamp {
+		adoptedTimestamp, isAdopted := adopted[key.Path]
+		if elementTable.Timestamp == fileTimestamp || isAdopted && adoptedTimestamp == fileTimestamp {
 			delete(sourceFileTimestamps, key.Path)
 		}
 	}
 
 	needIndexFiles := make([]*types.FileWithModTimestamp, 0, len(sourceFileTimestamps))
 	for k, v := range sourceFileTimestamps {
-		needIndexFiles = append(needIndexFiles, &types.FileWithModTimestamp{Path: k, ModTime: v})
+		needIndexFiles = append(needIndexFiles, &types.FileWithModTimestamp{Path: k, ModTime: v, Size: sourceFileSizes[k]})
 	}
 	return needIndexFiles
 }
@@ -255,6 +297,7 @@ func (idx *Indexer) IndexFiles(ctx context.Context, workspacePath string, filePa
 				errs = append(errs, err)
 				continue
 			}
+			idx.resolveProject(ctx, projectUuid, false)
 
 			idx.logger.Info("project %s projectFiles parse finish. cost %d ms, visit %d projectFiles, "+
 				"parsed %d projectFiles successfully, failed %d projectFiles",
@@ -269,8 +312,9 @@ func (idx *Indexer) IndexFiles(ctx context.Context, workspacePath string, filePa
 	return err
 }
 
-// parseFiles 解析文件
-func (idx *Indexer) parseFiles(ctx context.Context, files []*types.FileWithModTimestamp) ([]*parser.FileElementTable, *types.IndexTaskMetrics, error) {
+// parseFiles 读取并解析文件，同时返回读取的源码字节数，用于估算批次在流水线中的内存占用
+func (idx *Indexer) parseFiles(ctx context.Context, files []*types.FileWithModTimestamp) ([]*parser.FileElementTable,
+	*types.IndexTaskMetrics, int64, error) {
 	totalFiles := len(files)
 
 	// 优化：预分配切片容量，减少动态扩容
@@ -281,6 +325,9 @@ func (idx *Indexer) parseFiles(ctx context.Context, files []*types.FileWithModTi
 	}
 
 	var errs []error
+	var contentBytes int64
+	// 同批次文件共享类型名等字符串，批次写入后随元素表一起释放
+	ctx = utils.WithStringInterner(ctx, utils.NewStringInterner())
 
 	for _, f := range files {
 		language, err := lang.InferLanguage(f.Path)
@@ -289,20 +336,25 @@ func (idx *Indexer) parseFiles(ctx context.Context, files []*types.FileWithModTi
 		}
 
 		// 直接读取文件并解析，避免不必要的中间变量
+		readStart := time.Now()
 		content, err := idx.workspaceReader.ReadFile(ctx, f.Path, types.ReadOptions{})
+		readStageDuration.ObserveSince(readStart)
 		if err != nil {
 			projectTaskMetrics.TotalFailedFiles++
 			projectTaskMetrics.FailedFilePaths = append(projectTaskMetrics.FailedFilePaths, f.Path)
 			idx.logger.Debug("read file %s err:%v", f, err)
 			continue
 		}
+		contentBytes += int64(len(content))
 		// 创建源文件对象并解析
 		sourceFile := &types.SourceFile{
 			Path:    f.Path,
 			Content: content,
 		}
 
+		parseStart := time.Now()
 		fileElementTable, err := idx.parser.Parse(ctx, sourceFile)
+		parseStageDuration.ObserveSince(parseStart)
 		if err != nil {
 			projectTaskMetrics.TotalFailedFiles++
 			projectTaskMetrics.FailedFilePaths = append(projectTaskMetrics.FailedFilePaths, f.Path)
@@ -316,13 +368,15 @@ func (idx *Indexer) parseFiles(ctx context.Context, files []*types.FileWithModTi
 		fileElementTables = append(fileElementTables, fileElementTable)
 	}
 
-	return fileElementTables, projectTaskMetrics, errors.Join(errs...)
+	return fileElementTables, projectTaskMetrics, contentBytes, errors.Join(errs...)
 }
 
-// collectFiles 收集文件用于index
-func (idx *Indexer) collectFiles(ctx context.Context, workspacePath string, projectPath string) (map[string]int64, error) {
+// collectFiles 收集文件用于index，返回文件的修改时间和大小
+func (idx *Indexer) collectFiles(ctx context.Context, workspacePath string, projectPath string) (map[string]int64,
+	map[string]int64, error) {
 	startTime := time.Now()
 	filePathModTimestamps := make(map[string]int64, 100)
+	filePathSizes := make(map[string]int64, 100)
 	ignoreConfig := idx.ignoreScanner.LoadIgnoreConfig(workspacePath)
 	if ignoreConfig == nil {
 		idx.logger.Error("collect source files ignore_config is nil")
@@ -353,17 +407,19 @@ func (idx *Indexer) collectFiles(ctx context.Context, workspacePath string, proj
 			return filepath.SkipAll
 		}
 		filePathModTimestamps[walkCtx.Path] = walkCtx.Info.ModTime.Unix()
+		filePathSizes[walkCtx.Path] = walkCtx.Info.Size
 		return nil
 	}, types.WalkOptions{IgnoreError: true, VisitPattern: visitPattern})
 
 	if err != nil {
-		return nil, err
+		return nil, nil, err
 	}
 
+	indexStageDuration.WithLabelValues(stageWalk).ObserveSince(startTime)
 	idx.logger.Info("collect project source files finish. cost %d ms, found %d source files to index, max files limit %d",
 		time.Since(startTime).Milliseconds(), len(filePathModTimestamps), maxFiles)
 
-	return filePathModTimestamps, nil
+	return filePathModTimestamps, filePathSizes, nil
 }
 
 // filterSourceFiles 根据规则过滤源文件
@@ -397,7 +453,8 @@ func (idx *Indexer) filterSourceFiles(ctx context.Context, workspacePath string,
 		if len(results) >= maxFilesLimit {
 			break
 		}
-		results = append(results, &types.FileWithModTimestamp{Path: file, ModTime: fileInfo.ModTime.Unix()})
+		results = append(results, &types.FileWithModTimestamp{Path: file, ModTime: fileInfo.ModTime.Unix(),
+			Size: fileInfo.Size})
 	}
 	return results
 }
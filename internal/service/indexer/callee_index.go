@@ -0,0 +1,215 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/proto"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/store"
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/workspace"
+	"context"
+	"errors"
+	"fmt"
+	"strings"
+	"time"
+
+	"google.golang.org/protobuf/types/known/wrapperspb"
+)
+
+// 被调用者反向索引（callee -> []caller）随元素表持久化，按 被调用符号名+调用方文件 存储，
+// 文件增删改时只更新该文件对应的key，调用图查询只做前缀点查。
+const (
+	// calleeIndexVersion 反向索引的存储格式版本，格式变化时递增，旧版本会被整体重建
+	calleeIndexVersion = 1
+	// calleeIndexVersionKey 反向索引版本号的元数据key
+	calleeIndexVersionKey = "callee_index_version"
+	// calleeIndexRebuildBatchSize 重建时每批写入的文件数
+	calleeIndexRebuildBatchSize = 200
+)
+
+// buildCalleeMapItems 提取单个文件内所有函数/方法的调用，按被调用符号名聚合
+func (idx *Indexer) buildCalleeMapItems(elementTable *codegraphpb.FileElementTable) []*codegraphpb.CalleeMapItem {
+	itemsByCallee := make(map[string]*codegraphpb.CalleeMapItem)
+	var items []*codegraphpb.CalleeMapItem
+
+	// 遍历所有函数/方法定义
+	for _, element := range elementTable.Elements {
+		if !element.IsDefinition ||
+			(element.ElementType != codegraphpb.ElementType_FUNCTION &&
+				element.ElementType != codegraphpb.ElementType_METHOD) {
+			continue
+		}
+		if len(element.Range) < 3 {
+			continue
+		}
+
+		// 获取调用者（函数/方法）参数个数
+		callerParams, err := proto.GetParametersFromExtraData(element.ExtraData)
+		if err != nil {
+			idx.logger.Debug("parse caller parameters from extra data, err: %v", err)
+			continue
+		}
+		callerParamCount := len(callerParams)
+		isVariadic := false
+		if callerParamCount > 0 {
+			lastParam := callerParams[callerParamCount-1]
+			if strings.Contains(lastParam.Name, VarVariadic) {
+				callerParamCount = callerParamCount - 1
+				isVariadic = true
+			}
+		}
+		position := types.ToPosition(element.Range)
+		// 查找该函数内部的所有调用
+		calleeKeys := idx.extractCalleeSymbols(elementTable, element.Range[0], element.Range[2])
+
+		// 为每个被调用的符号添加调用者信息
+		for _, calleeKey := range calleeKeys {
+			item, ok := itemsByCallee[calleeKey.SymbolName]
+			if !ok {
+				item = &codegraphpb.CalleeMapItem{CalleeName: calleeKey.SymbolName}
+				itemsByCallee[calleeKey.SymbolName] = item
+				items = append(items, item)
+			}
+			item.Callers = append(item.Callers, &codegraphpb.CallerInfo{
+				SymbolName: element.Name,
+				FilePath:   elementTable.Path,
+				Position: &codegraphpb.Position{
+					StartLine:   int32(position.StartLine),
+					StartColumn: int32(position.StartColumn),
+					EndLine:     int32(position.EndLine),
+					EndColumn:   int32(position.EndColumn),
+				},
+				ParamCount: int32(callerParamCount),
+				CalleeKey: &codegraphpb.CalleeKey{
+					SymbolName: calleeKey.SymbolName,
+					ParamCount: int32(calleeKey.ParamCount),
+				},
+				IsVariadic: isVariadic,
+			})
+		}
+	}
+	return items
+}
+
+// saveCalleeIndex 写入文件的反向索引项。调用方需保证这些文件的旧索引项已删除
+func (idx *Indexer) saveCalleeIndex(ctx context.Context, projectUuid string, elementTables []*codegraphpb.FileElementTable) error {
+	var items []*codegraphpb.CalleeMapItem
+	for _, ft := range elementTables {
+		items = append(items, idx.buildCalleeMapItems(ft)...)
+	}
+	if len(items) == 0 {
+		return nil
+	}
+	return idx.storage.BatchSave(ctx, projectUuid, workspace.CalleeMapItems(items))
+}
+
+// removeCalleeIndex 删除文件贡献的反向索引项，只需要遍历文件自身的调用元素
+func (idx *Indexer) removeCalleeIndex(ctx context.Context, projectUuid string, elementTables []*codegraphpb.FileElementTable) error {
+	var errs []error
+	for _, ft := range elementTables {
+		deleted := make(map[string]struct{})
+		for _, element := range ft.Elements {
+			if element.ElementType != codegraphpb.ElementType_CALL {
+				continue
+			}
+			if _, ok := deleted[element.Name]; ok {
+				continue
+			}
+			deleted[element.Name] = struct{}{}
+			if err := idx.storage.Delete(ctx, projectUuid, store.CalleeMapKey{
+				SymbolName: element.Name, FilePath: ft.Path}); err != nil {
+				errs = append(errs, err)
+			}
+		}
+	}
+	return errors.Join(errs...)
+}
+
+// getStoredFileElementTables 读取文件已存储的元素表，新文件没有旧的元素表，不在结果中
+func (idx *Indexer) getStoredFileElementTables(ctx context.Context, projectUuid string,
+	elementTables []*codegraphpb.FileElementTable) []*codegraphpb.FileElementTable {
+	var oldTables []*codegraphpb.FileElementTable
+	for _, ft := range elementTables {
+		old, err := idx.getFileElementTable(ctx, projectUuid, lang.Language(ft.Language), ft.Path)
+		if err != nil {
+			continue
+		}
+		oldTables = append(oldTables, old)
+	}
+	return oldTables
+}
+
+// replaceCalleeIndex 用新的元素表替换文件的反向索引项，需要在新元素表覆盖旧元素表之前调用
+func (idx *Indexer) replaceCalleeIndex(ctx context.Context, projectUuid string,
+	oldTables, elementTables []*codegraphpb.FileElementTable) error {
+	if err := idx.removeCalleeIndex(ctx, projectUuid, oldTables); err != nil {
+		return fmt.Errorf("remove old callee index failed: %w", err)
+	}
+	return idx.saveCalleeIndex(ctx, projectUuid, elementTables)
+}
+
+// ensureCalleeIndex 确保项目的反向索引版本是最新的，否则根据已存储的元素表整体重建一次
+func (idx *Indexer) ensureCalleeIndex(ctx context.Context, projectUuid string) error {
+	idx.calleeIndexMu.Lock()
+	defer idx.calleeIndexMu.Unlock()
+
+	versionKey := store.MetaKey{Name: calleeIndexVersionKey}
+	if bytes, err := idx.storage.Get(ctx, projectUuid, versionKey); err == nil {
+		var version wrapperspb.Int32Value
+		if err = store.UnmarshalValue(bytes, &version); err == nil && version.Value == calleeIndexVersion {
+			return nil
+		}
+	} else if !errors.Is(err, store.ErrKeyNotFound) {
+		return fmt.Errorf("get callee index version failed: %w", err)
+	}
+
+	start := time.Now()
+	idx.logger.Info("project %s callee index is outdated, start to rebuild, version %d", projectUuid, calleeIndexVersion)
+	defer idx.queryCache.bump(projectUuid)
+	if err := idx.storage.DeleteAllWithPrefix(ctx, projectUuid, store.CalleeMapKeySystemPrefix); err != nil {
+		return fmt.Errorf("delete outdated callee index failed: %w", err)
+	}
+
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.PathKeySystemPrefix)
+	if iter == nil {
+		return fmt.Errorf("failed to create iterator for project %s", projectUuid)
+	}
+	defer iter.Close()
+
+	var errs []error
+	files := 0
+	batch := make([]*codegraphpb.FileElementTable, 0, calleeIndexRebuildBatchSize)
+	for iter.Next() {
+		elementTable := new(codegraphpb.FileElementTable)
+		if err := store.UnmarshalValue(iter.Value(), elementTable); err != nil {
+			idx.logger.Error("failed to unmarshal key %s element_table value, err: %v", iter.Key(), err)
+			continue
+		}
+		batch = append(batch, elementTable)
+		files++
+		if len(batch) >= calleeIndexRebuildBatchSize {
+			if err := idx.saveCalleeIndex(ctx, projectUuid, batch); err != nil {
+				errs = append(errs, err)
+			}
+			batch = batch[:0]
+		}
+	}
+	if err := idx.saveCalleeIndex(ctx, projectUuid, batch); err != nil {
+		errs = append(errs, err)
+	}
+	if err := iter.Error(); err != nil {
+		errs = append(errs, err)
+	}
+	if len(errs) > 0 {
+		// 不写入版本号，下次重建
+		return fmt.Errorf("rebuild callee index failed: %w", errors.Join(errs...))
+	}
+
+	if err := idx.storage.Put(ctx, projectUuid, &store.Entry{Key: versionKey,
+		Value: wrapperspb.Int32(calleeIndexVersion)}); err != nil {
+		return fmt.Errorf("save callee index version failed: %w", err)
+	}
+	idx.logger.Info("project %s callee index rebuild end, cost %d ms, files %d", projectUuid,
+		time.Since(start).Milliseconds(), files)
+	return nil
+}
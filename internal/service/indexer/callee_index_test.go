@@ -0,0 +1,36 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/store"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func TestBuildCalleeMapItems(t *testing.T) {
+	idx := &Indexer{logger: &store.MockLogger{}}
+	table := &codegraphpb.FileElementTable{
+		Path:     "/test/main.go",
+		Language: "go",
+		Elements: []*codegraphpb.Element{
+			{Name: "main", ElementType: codegraphpb.ElementType_FUNCTION, IsDefinition: true, Range: []int32{0, 0, 10, 1}},
+			{Name: "Foo", ElementType: codegraphpb.ElementType_CALL, Range: []int32{2, 1, 2, 6}},
+			{Name: "Bar", ElementType: codegraphpb.ElementType_CALL, Range: []int32{3, 1, 3, 6}},
+			{Name: "Foo", ElementType: codegraphpb.ElementType_CALL, Range: []int32{4, 1, 4, 6}},
+			// 不在任何函数内的调用
+			{Name: "Baz", ElementType: codegraphpb.ElementType_CALL, Range: []int32{20, 1, 20, 6}},
+		},
+	}
+
+	items := idx.buildCalleeMapItems(table)
+
+	// 按被调用符号聚合，保持首次出现的顺序
+	assert.Len(t, items, 2)
+	assert.Equal(t, "Foo", items[0].CalleeName)
+	assert.Len(t, items[0].Callers, 2)
+	assert.Equal(t, "main", items[0].Callers[0].SymbolName)
+	assert.Equal(t, "/test/main.go", items[0].Callers[0].FilePath)
+	assert.Equal(t, "Bar", items[1].CalleeName)
+	assert.Len(t, items[1].Callers, 1)
+}
@@ -5,12 +5,14 @@ import (
 	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
 	"codebase-indexer/pkg/codegraph/store"
 	"codebase-indexer/pkg/codegraph/types"
+	"container/heap"
 	"context"
 	"fmt"
 	"path/filepath"
 	"sort"
 	"strconv"
 	"strings"
+	"sync"
 	"time"
 
 	lru "github.com/hashicorp/golang-lru/v2"
@@ -22,6 +24,21 @@ const (
 
 // QueryCallGraph 获取符号定义代码块里面的调用图
 func (idx *Indexer) QueryCallGraph(ctx context.Context, opts *types.QueryCallGraphOptions) ([]*types.RelationNode, error) {
+	if relationEmitterFromContext(ctx) != nil {
+		return idx.queryCallGraph(ctx, opts)
+	}
+	key := queryCacheKey(queryCallGraph, opts.Workspace, opts.FilePath, opts.LineRange, opts.SymbolName,
+		strconv.Itoa(opts.MaxLayer), strconv.Itoa(opts.MaxNodes), opts.Timeout.String())
+	return cachedQuery(ctx, idx.queryCache, queryCallGraph, key, cloneRelationNodes, relationNodesSize,
+		func(ctx context.Context) ([]*types.RelationNode, bool, error) {
+			start := time.Now()
+			nodes, err := idx.queryCallGraph(ctx, opts)
+			// 展开超时返回的是部分结果，不缓存
+			return nodes, time.Since(start) < newCallGraphBudget(opts).timeout, err
+		})
+}
+
+func (idx *Indexer) queryCallGraph(ctx context.Context, opts *types.QueryCallGraphOptions) ([]*types.RelationNode, error) {
 	startTime := time.Now()
 
 	// 参数验证
@@ -43,8 +60,10 @@ func (idx *Indexer) QueryCallGraph(ctx context.Context, opts *types.QueryCallGra
 	}
 	projectUuid := project.Uuid
 	defer func() {
+		queryDuration.WithLabelValues(queryCallGraph).ObserveSince(startTime)
 		idx.logger.Info("query callgraph cost %d ms", time.Since(startTime).Milliseconds())
 	}()
+	budget := newCallGraphBudget(opts)
 
 	var results []*types.RelationNode
 
@@ -64,14 +83,14 @@ func (idx *Indexer) QueryCallGraph(ctx context.Context, opts *types.QueryCallGra
 		}
 		// 查询组合1：文件路径+行范围
 		startLine, endLine = NormalizeLineRange(startLine, endLine, 1000)
-		results, err = idx.queryCallGraphByLineRange(ctx, projectUuid, opts.Workspace, opts.FilePath, startLine, endLine, opts.MaxLayer)
+		results, err = idx.queryCallGraphByLineRange(ctx, projectUuid, opts.Workspace, opts.FilePath, startLine, endLine, opts.MaxLayer, budget)
 		return results, err
 	}
 	opts.SymbolName = strings.TrimSpace(opts.SymbolName)
 	// 根据查询类型处理
 	if opts.SymbolName != "" {
 		// 查询组合2：文件路径+符号名(类、函数)
-		results, err = idx.queryCallGraphBySymbol(ctx, projectUuid, opts.Workspace, opts.FilePath, opts.SymbolName, opts.MaxLayer)
+		results, err = idx.queryCallGraphBySymbol(ctx, projectUuid, opts.Workspace, opts.FilePath, opts.SymbolName, opts.MaxLayer, budget)
 		return results, err
 	}
 
@@ -79,7 +98,8 @@ func (idx *Indexer) QueryCallGraph(ctx context.Context, opts *types.QueryCallGra
 }
 
 // queryCallGraphBySymbol 根据符号名查询调用链
-func (idx *Indexer) queryCallGraphBySymbol(ctx context.Context, projectUuid string, workspace, filePath, symbolName string, maxLayer int) ([]*types.RelationNode, error) {
+func (idx *Indexer) queryCallGraphBySymbol(ctx context.Context, projectUuid string, workspace, filePath, symbolName string, maxLayer int,
+	budget callGraphBudget) ([]*types.RelationNode, error) {
 	// 查找符号定义
 	fileTable, err := idx.getFileElementTableByPath(ctx, projectUuid, filePath)
 	if err != nil {
@@ -134,12 +154,13 @@ func (idx *Indexer) queryCallGraphBySymbol(ctx context.Context, projectUuid stri
 		calleeElements = append(calleeElements, callee)
 	}
 	visited := make(map[string]struct{})
-	idx.buildCallGraphBFS(ctx, projectUuid, workspace, definitions, calleeElements, maxLayer, visited)
+	idx.buildCallGraphBFS(ctx, projectUuid, workspace, definitions, calleeElements, maxLayer, visited, budget)
 	return definitions, nil
 }
 
 // queryCallGraphByLineRange 根据行范围查询调用链
-func (idx *Indexer) queryCallGraphByLineRange(ctx context.Context, projectUuid string, workspace string, filePath string, startLine, endLine, maxLayer int) ([]*types.RelationNode, error) {
+func (idx *Indexer) queryCallGraphByLineRange(ctx context.Context, projectUuid string, workspace string, filePath string, startLine, endLine, maxLayer int,
+	budget callGraphBudget) ([]*types.RelationNode, error) {
 	// 获取文件元素表
 	fileTable, err := idx.getFileElementTableByPath(ctx, projectUuid, filePath)
 	if err != nil {
@@ -196,20 +217,48 @@ func (idx *Indexer) queryCallGraphByLineRange(ctx context.Context, projectUuid s
 		calleeElements = append(calleeElements, callee)
 	}
 	visited := make(map[string]struct{})
-	idx.buildCallGraphBFS(ctx, projectUuid, workspace, definitions, calleeElements, maxLayer, visited)
+	idx.buildCallGraphBFS(ctx, projectUuid, workspace, definitions, calleeElements, maxLayer, visited, budget)
 
 	return definitions, nil
 }
 
+// callGraphBudget 单次调用图查询的节点数和耗时上限，超出后停止展开，返回已构建的部分
+type callGraphBudget struct {
+	maxNodes int
+	timeout  time.Duration
+}
+
+func newCallGraphBudget(opts *types.QueryCallGraphOptions) callGraphBudget {
+	budget := callGraphBudget{maxNodes: opts.MaxNodes, timeout: opts.Timeout}
+	if budget.maxNodes <= 0 {
+		budget.maxNodes = DefaultCallGraphMaxNodes
+	}
+	if budget.timeout <= 0 {
+		budget.timeout = DefaultCallGraphTimeout
+	}
+	return budget
+}
+
 // buildCallGraphBFS 使用BFS层次遍历构建调用链
-func (idx *Indexer) buildCallGraphBFS(ctx context.Context, projectUuid string, workspace string, rootNodes []*types.RelationNode, calleeInfos []*CalleeInfo, maxLayer int, visited map[string]struct{}) {
+// 每层先并发读取各被调用符号的调用者，再按节点顺序串行打分、剪枝，结果与串行遍历一致。
+// 上下文带有 RelationEmitter 时每展开一层发出该层的节点
+func (idx *Indexer) buildCallGraphBFS(ctx context.Context, projectUuid string, workspace string, rootNodes []*types.RelationNode,
+	calleeInfos []*CalleeInfo, maxLayer int, visited map[string]struct{}, budget callGraphBudget) {
+	emit := relationEmitterFromContext(ctx)
+	if err := emitRoots(emit, rootNodes); err != nil {
+		idx.logger.Debug("callgraph stream stopped, project %s, err: %v", projectUuid, err)
+		return
+	}
 	if len(rootNodes) == 0 || maxLayer <= 0 {
 		return
 	}
+	ctx, cancel := context.WithTimeout(ctx, budget.timeout)
+	defer cancel()
 
 	// 初始化队列，存储当前层的节点和对应的被调用元素
 	type layerNode struct {
 		node   *types.RelationNode
+		parent *types.RelationNode
 		callee *CalleeInfo
 	}
 
@@ -228,10 +277,10 @@ func (idx *Indexer) buildCallGraphBFS(ctx context.Context, projectUuid string, w
 			})
 		}
 	}
-	// 构建反向索引映射：callee -> []caller
-	err := idx.buildCalleeMap(ctx, projectUuid)
+	// 反向索引映射：callee -> []caller，随索引增量维护，仅在版本过旧时重建
+	err := idx.ensureCalleeIndex(ctx, projectUuid)
 	if err != nil {
-		idx.logger.Error("failed to build callee map for write, err: %v", err)
+		idx.logger.Error("failed to ensure callee index for project %s, err: %v", projectUuid, err)
 		return
 	}
 	calleeMap, err := lru.New[string, []CallerInfo](MaxCalleeMapCacheCapacity / 2)
@@ -239,28 +288,51 @@ func (idx *Indexer) buildCallGraphBFS(ctx context.Context, projectUuid string, w
 		idx.logger.Error("failed to create callee map cache, err: %v", err)
 		return
 	}
+	// 调用者文件的导入，整个遍历期间共享，每层未加载的文件一次批量读取
+	fileImports := make(map[string][]*codegraphpb.Import)
+	// 匹配分数只取决于调用者和被调用者所在文件，按文件对缓存
+	scores := make(map[[2]string]float64)
+	// 调用者文件对被调用符号的延迟解析结果，按 调用者文件+被调用符号名 缓存，nil 表示没有解析结果
+	resolved := make(map[[2]string]map[string]struct{})
+	nodeCount := 0
+	truncated := false
 	// BFS层次遍历
-	for layer := 0; layer < maxLayer && len(currentLayerNodes) > 0; layer++ {
+	for layer := 0; layer < maxLayer && len(currentLayerNodes) > 0 && !truncated; layer++ {
 		nextLayerNodes := make([]*layerNode, 0)
-		// 使用反向索引直接查找调用者
+
+		// 并发读取本层尚未缓存的被调用符号的调用者
+		missingCallees := make([]string, 0)
+		missingCalleeSet := make(map[string]struct{})
 		for _, ln := range currentLayerNodes {
+			calleeKey := ln.callee.SymbolName
+			if calleeMap.Contains(calleeKey) {
+				continue
+			}
+			if _, ok := missingCalleeSet[calleeKey]; !ok {
+				missingCalleeSet[calleeKey] = struct{}{}
+				missingCallees = append(missingCallees, calleeKey)
+			}
+		}
+		idx.loadCallers(ctx, projectUuid, missingCallees, calleeMap)
+		if ctx.Err() != nil {
+			truncated = true
+			break
+		}
+
+		// 筛出本层每个节点的候选调用者，收集需要加载导入的文件
+		layerCallers := make([][]CallerInfo, len(currentLayerNodes))
+		missingPaths := make([]string, 0)
+		missingSet := make(map[string]struct{})
+		for k, ln := range currentLayerNodes {
 			// 构建callee的key
 			calleeKey := ln.callee.SymbolName
 
-			// 从反向索引中获取调用者列表
+			// 从反向索引中获取调用者列表，不存在说明没有调用者或查询失败
 			callers, exists := calleeMap.Get(calleeKey)
 			if !exists {
-				// 从数据库查询
-				dbCallers, err := idx.queryCallersFromDB(ctx, projectUuid, calleeKey)
-				if err != nil {
-					// idx.logger.Debug("query callers from db for callee %s,err: %v", calleeKey.SymbolName, err)
-					continue
-				}
-				callers = dbCallers
-				// 更新缓存
-				calleeMap.Add(calleeKey, callers)
+				continue
 			}
-			realCallers := make([]CallerInfo, 0, len(callers))
+			candidates := make([]CallerInfo, 0, len(callers))
 			for i := range len(callers) {
 				// 根据可变参数，过滤掉不符合条件的调用者
 				if ln.callee.IsVariadic && callers[i].CalleeKey.ParamCount < ln.callee.ParamCount {
@@ -276,27 +348,99 @@ func (idx *Indexer) buildCallGraphBFS(ctx context.Context, projectUuid string, w
 					// 防止循环引用
 					continue
 				}
+				candidates = append(candidates, callers[i])
+			}
+			layerCallers[k] = candidates
+		}
 
-				fileElementTable, err := idx.getFileElementTableByPath(ctx, projectUuid, callers[i].FilePath)
-				if err != nil {
-					idx.logger.Error("failed to get file element table by path, err: %v", err)
+		// 调用者文件的解析结果已确认被调用者定义所在的文件时，不需要加载导入
+		resolveKeys := make([]store.ResolvedSymbolKey, 0)
+		for k, ln := range currentLayerNodes {
+			for _, caller := range layerCallers[k] {
+				pair := [2]string{caller.FilePath, ln.callee.SymbolName}
+				if _, ok := resolved[pair]; ok || !isResolvableFile(caller.FilePath) {
 					continue
 				}
-				imports := fileElementTable.Imports
-				// 计算匹配分数
-				score := idx.analyzer.CalculateSymbolMatchScore(workspace, imports, callers[i].FilePath, ln.callee.FilePath,
-					ln.callee.SymbolName, callers[i].SymbolName)
-				callers[i].Score = float64(score)
-				realCallers = append(realCallers, callers[i])
+				resolved[pair] = nil
+				resolveKeys = append(resolveKeys, store.ResolvedSymbolKey{SymbolName: ln.callee.SymbolName, FilePath: caller.FilePath})
 			}
+		}
+		if len(resolveKeys) > 0 {
+			paths, err := idx.getResolvedSymbolPaths(ctx, projectUuid, resolveKeys)
+			if err != nil {
+				idx.logger.Debug("failed to get resolved symbols, err: %v", err)
+			}
+			for i, p := range paths {
+				resolved[[2]string{resolveKeys[i].FilePath, resolveKeys[i].SymbolName}] = p
+			}
+		}
+		for k, ln := range currentLayerNodes {
+			for _, caller := range layerCallers[k] {
+				filePath := caller.FilePath
+				if resolved[[2]string{filePath, ln.callee.SymbolName}] != nil {
+					continue
+				}
+				if _, ok := fileImports[filePath]; ok {
+					continue
+				}
+				if _, ok := missingSet[filePath]; !ok {
+					missingSet[filePath] = struct{}{}
+					missingPaths = append(missingPaths, filePath)
+				}
+			}
+		}
 
-			sort.Slice(realCallers, func(i, j int) bool {
-				return realCallers[i].Score > realCallers[j].Score
-			})
-			// 第一层不限制，其他层限制
-			if layer != 0 && len(realCallers) > DefaultTopN {
-				realCallers = realCallers[:DefaultTopN]
+		if len(missingPaths) > 0 {
+			loaded, err := idx.getFileImportsByPaths(ctx, projectUuid, missingPaths)
+			if err != nil {
+				idx.logger.Error("failed to get file imports by paths, err: %v", err)
+			}
+			for filePath, imports := range loaded {
+				fileImports[filePath] = imports
 			}
+		}
+
+		for k, ln := range currentLayerNodes {
+			realCallers := make([]CallerInfo, 0, len(layerCallers[k]))
+			for _, caller := range layerCallers[k] {
+				// 同层前面的节点可能已经展开过该调用者
+				if _, ok := visited[caller.Key()]; ok {
+					continue
+				}
+				resolvedPaths := resolved[[2]string{caller.FilePath, ln.callee.SymbolName}]
+				imports, ok := fileImports[caller.FilePath]
+				if !ok && resolvedPaths == nil {
+					idx.logger.Error("failed to get file element table by path, index not found for file %s", caller.FilePath)
+					continue
+				}
+				// 计算匹配分数，经解析确认与按导入匹配的分数一致，缓存的分数对两种方式通用
+				pair := [2]string{caller.FilePath, ln.callee.FilePath}
+				score, ok := scores[pair]
+				if !ok {
+					if resolvedPaths != nil {
+						score = float64(idx.resolvedMatchScore(workspace, resolvedPaths, caller.FilePath, ln.callee.FilePath,
+							ln.callee.SymbolName, caller.SymbolName))
+					} else {
+						score = float64(idx.analyzer.CalculateSymbolMatchScore(workspace, imports, caller.FilePath, ln.callee.FilePath,
+							ln.callee.SymbolName, caller.SymbolName))
+					}
+					scores[pair] = score
+				}
+				caller.Score = score
+				realCallers = append(realCallers, caller)
+			}
+
+			// 第一层不限制，其他层只保留分数最高的 DefaultTopN 个
+			limit := len(realCallers)
+			if layer != 0 {
+				limit = DefaultTopN
+			}
+			if remaining := budget.maxNodes - nodeCount; limit > remaining {
+				limit = remaining
+				truncated = limit < len(realCallers)
+			}
+			realCallers = topCallers(realCallers, limit)
+			nodeCount += len(realCallers)
 
 			for i := range len(realCallers) {
 				// 创建对应的被调用元素
@@ -322,99 +466,119 @@ func (idx *Indexer) buildCallGraphBFS(ctx context.Context, projectUuid string, w
 
 				nextLayerNodes = append(nextLayerNodes, &layerNode{
 					node:   callerNode,
+					parent: ln.node,
 					callee: calleeInfo,
 				})
 			}
+			if truncated {
+				break
+			}
+		}
+
+		if emit != nil && len(nextLayerNodes) > 0 {
+			parents := make([]*types.RelationNode, len(nextLayerNodes))
+			nodes := make([]*types.RelationNode, len(nextLayerNodes))
+			for i, ln := range nextLayerNodes {
+				parents[i], nodes[i] = ln.parent, ln.node
+			}
+			if err := emit(layer+1, parents, nodes); err != nil {
+				idx.logger.Debug("callgraph stream stopped at layer %d, project %s, err: %v", layer+1, projectUuid, err)
+				return
+			}
 		}
 
 		// 移动到下一层
 		currentLayerNodes = nextLayerNodes
 	}
-	// 清除数据库
-	err = idx.storage.DeleteAllWithPrefix(ctx, projectUuid, store.CalleeMapKeySystemPrefix)
-	if err != nil {
-		idx.logger.Error("failed to delete callee map for project %s, err: %v", projectUuid, err)
+	if truncated {
+		idx.logger.Info("callgraph query truncated at %d nodes, project %s, err: %v", nodeCount, projectUuid, ctx.Err())
+	}
+}
+
+// loadCallers 并发查询多个被调用符号的调用者并写入缓存，查询失败的符号不写入
+func (idx *Indexer) loadCallers(ctx context.Context, projectUuid string, calleeNames []string,
+	calleeMap *lru.Cache[string, []CallerInfo]) {
+	if len(calleeNames) == 0 {
 		return
 	}
+	workers := make(chan struct{}, min(DefaultCallGraphWorkers, len(calleeNames)))
+	var wg sync.WaitGroup
+	for _, calleeName := range calleeNames {
+		if ctx.Err() != nil {
+			break
+		}
+		workers <- struct{}{}
+		wg.Add(1)
+		go func(calleeName string) {
+			defer func() {
+				<-workers
+				wg.Done()
+			}()
+			callers, err := idx.queryCallersFromDB(ctx, projectUuid, calleeName)
+			if err != nil {
+				return
+			}
+			calleeMap.Add(calleeName, callers)
+		}(calleeName)
+	}
+	wg.Wait()
 }
 
-// buildCalleeMap 构建反向索引映射：callee -> []caller
-func (idx *Indexer) buildCalleeMap(ctx context.Context, projectUuid string) error {
-	// 创建batcher实例
-	batcher := NewMapBatcher(idx.storage, idx.logger, projectUuid, DefaultMapBatchSize)
-	defer batcher.Flush()
+// callerHeap 按分数排列的小顶堆，分数相同时保留先出现的调用者
+type callerHeap struct {
+	callers []CallerInfo
+	order   []int
+}
 
-	// 用name作为key
-	calleeMap, err := lru.NewWithEvict(MaxCalleeMapCacheCapacity, func(key string, value []CallerInfo) {
-		batcher.Add(key, value, true)
-	})
-	if err != nil {
-		return fmt.Errorf("failed to create variadic map cache, err: %v", err)
+func (h *callerHeap) Len() int { return len(h.callers) }
+func (h *callerHeap) Less(i, j int) bool {
+	if h.callers[i].Score != h.callers[j].Score {
+		return h.callers[i].Score < h.callers[j].Score
 	}
-	iter := idx.storage.Iter(ctx, projectUuid)
-	defer iter.Close()
+	return h.order[i] > h.order[j]
+}
+func (h *callerHeap) Swap(i, j int) {
+	h.callers[i], h.callers[j] = h.callers[j], h.callers[i]
+	h.order[i], h.order[j] = h.order[j], h.order[i]
+}
+func (h *callerHeap) Push(x any) {}
+func (h *callerHeap) Pop() any {
+	n := len(h.callers) - 1
+	h.callers, h.order = h.callers[:n], h.order[:n]
+	return nil
+}
 
-	for iter.Next() {
-		key := iter.Key()
-		if store.IsSymbolNameKey(key) {
+// topCallers 返回分数最高的 n 个调用者，按分数从高到低排列，只保留 n 个元素的堆
+func topCallers(callers []CallerInfo, n int) []CallerInfo {
+	if n <= 0 {
+		return nil
+	}
+	if n >= len(callers) {
+		sort.SliceStable(callers, func(i, j int) bool {
+			return callers[i].Score > callers[j].Score
+		})
+		return callers
+	}
+	h := &callerHeap{callers: make([]CallerInfo, 0, n), order: make([]int, 0, n)}
+	for i, caller := range callers {
+		if h.Len() < n {
+			h.callers = append(h.callers, caller)
+			h.order = append(h.order, i)
+			heap.Fix(h, h.Len()-1)
 			continue
 		}
-
-		var elementTable codegraphpb.FileElementTable
-		if err := store.UnmarshalValue(iter.Value(), &elementTable); err != nil {
-			idx.logger.Error("failed to unmarshal file %s element_table value, err: %v", elementTable.Path, err)
-			continue
-		}
-
-		// 遍历所有函数/方法定义
-		for _, element := range elementTable.Elements {
-			if !element.IsDefinition ||
-				(element.ElementType != codegraphpb.ElementType_FUNCTION &&
-					element.ElementType != codegraphpb.ElementType_METHOD) {
-				continue
-			}
-
-			// 获取调用者（函数/方法）参数个数
-			callerParams, err := proto.GetParametersFromExtraData(element.ExtraData)
-			if err != nil {
-				idx.logger.Debug("parse caller parameters from extra data, err: %v", err)
-				continue
-			}
-			callerParamCount := len(callerParams)
-			isVariadic := false
-			if callerParamCount > 0 {
-				lastParam := callerParams[callerParamCount-1]
-				if strings.Contains(lastParam.Name, VarVariadic) {
-					callerParamCount = callerParamCount - 1
-					isVariadic = true
-				}
-			}
-			// 查找该函数内部的所有调用
-			calleeKeys := idx.extractCalleeSymbols(&elementTable, element.Range[0], element.Range[2])
-
-			// 为每个被调用的符号添加调用者信息
-			for _, calleeKey := range calleeKeys {
-				callerInfo := CallerInfo{
-					SymbolName: element.Name,
-					FilePath:   elementTable.Path,
-					Position:   types.ToPosition(element.Range),
-					ParamCount: callerParamCount,
-					IsVariadic: isVariadic,
-					CalleeKey:  calleeKey,
-				}
-				// 添加到缓存
-				if val, ok := calleeMap.Get(calleeKey.SymbolName); ok {
-					calleeMap.Add(calleeKey.SymbolName, append(val, callerInfo))
-				} else {
-					calleeMap.Add(calleeKey.SymbolName, []CallerInfo{callerInfo})
-				}
-			}
+		// 堆顶是当前保留的最低分，分数相同时先出现的优先
+		if caller.Score > h.callers[0].Score {
+			h.callers[0], h.order[0] = caller, i
+			heap.Fix(h, 0)
 		}
 	}
-
-	// 清空缓存，必须全部写到数据库里面去，保证数据库是最新的
-	calleeMap.Purge()
-	return nil
+	result := make([]CallerInfo, h.Len())
+	for i := len(result) - 1; i >= 0; i-- {
+		result[i] = h.callers[0]
+		heap.Pop(h)
+	}
+	return result
 }
 
 // extractCalleeSymbols 提取函数定义范围内的所有被调用符号
@@ -451,35 +615,46 @@ func (idx *Indexer) extractCalleeSymbols(fileTable *codegraphpb.FileElementTable
 	return calleeKeys
 }
 
-// queryCallersFromDB 从数据库查询指定符号的调用者列表
+// queryCallersFromDB 从数据库查询指定符号的调用者列表，按前缀读取该符号所有调用方文件的索引项
 func (idx *Indexer) queryCallersFromDB(ctx context.Context, projectUuid string, calleeName string) ([]CallerInfo, error) {
-	var item codegraphpb.CalleeMapItem
-	result, err := idx.storage.Get(ctx, projectUuid, store.CalleeMapKey{
-		SymbolName: calleeName,
-	})
-	if err != nil {
-		return nil, fmt.Errorf("storage query failed: %w", err)
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.CalleeMapKeyPrefix(calleeName))
+	if iter == nil {
+		return nil, fmt.Errorf("storage query failed: failed to create iterator for project %s", projectUuid)
 	}
+	defer iter.Close()
 
-	if err := store.UnmarshalValue(result, &item); err != nil {
-		return nil, fmt.Errorf("unmarshal failed: %w", err)
-	}
-
-	callers := make([]CallerInfo, 0, len(item.Callers))
-	for _, c := range item.Callers {
-		callers = append(callers, CallerInfo{
-			SymbolName: c.SymbolName,
-			FilePath:   c.FilePath,
-			Position: types.Position{
-				StartLine:   int(c.Position.StartLine),
-				StartColumn: int(c.Position.StartColumn),
-				EndLine:     int(c.Position.EndLine),
-				EndColumn:   int(c.Position.EndColumn),
-			},
-			ParamCount: int(c.ParamCount),
-			CalleeKey:  CalleeKey{SymbolName: c.CalleeKey.SymbolName, ParamCount: int(c.CalleeKey.ParamCount)},
-			Score:      c.Score,
-		})
+	var callers []CallerInfo
+	for iter.Next() {
+		var item codegraphpb.CalleeMapItem
+		if err := store.UnmarshalValue(iter.Value(), &item); err != nil {
+			return nil, fmt.Errorf("unmarshal failed: %w", err)
+		}
+		// 前缀可能匹配到名字更长的符号（名字中包含分隔符）
+		if item.CalleeName != calleeName {
+			continue
+		}
+		for _, c := range item.Callers {
+			callers = append(callers, CallerInfo{
+				SymbolName: c.SymbolName,
+				FilePath:   c.FilePath,
+				Position: types.Position{
+					StartLine:   int(c.Position.StartLine),
+					StartColumn: int(c.Position.StartColumn),
+					EndLine:     int(c.Position.EndLine),
+					EndColumn:   int(c.Position.EndColumn),
+				},
+				ParamCount: int(c.ParamCount),
+				IsVariadic: c.IsVariadic,
+				CalleeKey:  CalleeKey{SymbolName: c.CalleeKey.SymbolName, ParamCount: int(c.CalleeKey.ParamCount)},
+				Score:      c.Score,
+			})
+		}
+	}
+	if err := iter.Error(); err != nil {
+		return nil, fmt.Errorf("storage query failed: %w", err)
+	}
+	if len(callers) == 0 {
+		return nil, store.ErrKeyNotFound
 	}
 	return callers, nil
 }
@@ -202,3 +202,22 @@ func TestVariadicParameterMatching(t *testing.T) {
 	}
 }
 
+func TestTopCallers(t *testing.T) {
+	scores := []float64{50, 100, 75, 50, 10, 100, 75}
+	callers := make([]CallerInfo, len(scores))
+	for i, score := range scores {
+		callers[i] = CallerInfo{SymbolName: string(rune('a' + i)), Score: score}
+	}
+	names := func(callers []CallerInfo) string {
+		var s string
+		for _, c := range callers {
+			s += c.SymbolName
+		}
+		return s
+	}
+
+	// 分数相同时保留先出现的调用者
+	assert.Equal(t, "bfcg", names(topCallers(append([]CallerInfo(nil), callers...), 4)))
+	assert.Equal(t, "bfcgade", names(topCallers(append([]CallerInfo(nil), callers...), 10)))
+	assert.Empty(t, topCallers(callers, 0))
+}
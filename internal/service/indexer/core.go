@@ -26,6 +26,10 @@ type Indexer struct {
 	config              *Config
 	logger              logger.Logger
 	mu                  sync.Mutex
+	calleeIndexMu       sync.Mutex      // 串行化被调用者反向索引的重建
+	resolveStates       sync.Map        // projectUuid -> *resolveState，按项目串行化延迟解析
+	fileTables          *fileTableCache // 已解码的文件元素表，查询路径共享
+	queryCache          *queryCache     // 定义、引用、调用图的查询结果
 }
 
 // NewIndexer 创建新的代码索引器
@@ -40,7 +44,7 @@ func NewIndexer(
 	logger logger.Logger,
 ) *Indexer {
 	initConfig(&config)
-	return &Indexer{
+	idx := &Indexer{
 		ignoreScanner:       ignoreScanner,
 		parser:              parser,
 		analyzer:            analyzer,
@@ -49,6 +53,24 @@ func NewIndexer(
 		workspaceRepository: workspaceRepository,
 		config:              &config,
 		logger:              logger,
+		fileTables:          newFileTableCache(int64(config.FileTableCacheBytes), 0),
+		queryCache:          newQueryCache(config.QueryCacheCapacity, int64(config.QueryCacheBytes)),
+	}
+	if analyzer != nil && ignoreScanner != nil {
+		// 头文件索引与收集源码文件使用相同的忽略规则
+		analyzer.SetCppHeaderSkipFunc(idx.projectSkipFunc)
+	}
+	return idx
+}
+
+// projectSkipFunc 项目的忽略规则，忽略配置不可用时返回空
+func (idx *Indexer) projectSkipFunc(projectPath string) types.SkipFunc {
+	ignoreConfig := idx.ignoreScanner.LoadIgnoreConfig(projectPath)
+	if ignoreConfig == nil {
+		return nil
+	}
+	return func(fileInfo *types.FileInfo) (bool, error) {
+		return idx.ignoreScanner.CheckIgnoreFile(ignoreConfig, projectPath, fileInfo)
 	}
 }
 
@@ -101,11 +123,66 @@ func initConfig(config *Config) {
 	if config.CacheCapacity <= 0 {
 		config.CacheCapacity = DefaultCacheCapacity
 	}
+
+	// 从环境变量获取FileTableCacheBytes（环境变量名：FILE_TABLE_CACHE_MB）
+	if envVal, ok := os.LookupEnv("FILE_TABLE_CACHE_MB"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			config.FileTableCacheBytes = val * 1024 * 1024
+		}
+	}
+	if config.FileTableCacheBytes <= 0 {
+		config.FileTableCacheBytes = DefaultFileTableCacheBytes
+	}
+
+	// 从环境变量获取QueryCacheCapacity（环境变量名：QUERY_CACHE_CAPACITY）
+	if envVal, ok := os.LookupEnv("QUERY_CACHE_CAPACITY"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			config.QueryCacheCapacity = val
+		}
+	}
+	if config.QueryCacheCapacity <= 0 {
+		config.QueryCacheCapacity = DefaultQueryCacheCapacity
+	}
+
+	// 从环境变量获取QueryCacheBytes（环境变量名：QUERY_CACHE_MB）
+	if envVal, ok := os.LookupEnv("QUERY_CACHE_MB"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			config.QueryCacheBytes = val * 1024 * 1024
+		}
+	}
+	if config.QueryCacheBytes <= 0 {
+		config.QueryCacheBytes = DefaultQueryCacheBytes
+	}
+
+	// 从环境变量获取MaxInflightBytes（环境变量名：MAX_INFLIGHT_MB）
+	if envVal, ok := os.LookupEnv("MAX_INFLIGHT_MB"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			config.MaxInflightBytes = val * 1024 * 1024
+		}
+	}
+	if config.MaxInflightBytes <= 0 {
+		config.MaxInflightBytes = DefaultMaxInflightBytes
+	}
+
+	// 从环境变量获取SnapshotDir（环境变量名：SNAPSHOT_DIR）
+	if envVal, ok := os.LookupEnv("SNAPSHOT_DIR"); ok {
+		config.SnapshotDir = envVal
+	}
 }
 
-// IndexIter 获取索引迭代器
+// FileTableCacheStats 获取已解码文件元素表缓存的命中、未命中、淘汰计数
+func (idx *Indexer) FileTableCacheStats() FileTableCacheStats {
+	return idx.fileTables.stats()
+}
+
+// IndexIter 获取索引迭代器，符号表已合并增量并还原文件路径
 func (idx *Indexer) IndexIter(ctx context.Context, projectUuid string) store.Iterator {
-	return idx.storage.Iter(ctx, projectUuid)
+	if compactor, ok := idx.storage.(store.SymbolPostingCompactor); ok {
+		if _, err := compactor.CompactSymbolPostings(ctx, projectUuid); err != nil {
+			idx.logger.Warn("compact symbol postings of project %s err: %v", projectUuid, err)
+		}
+	}
+	return store.NewResolvedIterator(ctx, idx.storage, projectUuid, idx.storage.Iter(ctx, projectUuid))
 }
 
 // GetSummary 获取代码图摘要信息
@@ -121,6 +198,22 @@ func (idx *Indexer) GetSummary(ctx context.Context, workspacePath string) (*type
 	return summary, nil
 }
 
+// PreopenWorkspace 工作区激活时在后台打开其项目数据库，之后的查询和增量索引不必等待打开
+func (idx *Indexer) PreopenWorkspace(ctx context.Context, workspacePath string) {
+	preopener, ok := idx.storage.(store.Preopener)
+	if !ok {
+		return
+	}
+	go func() {
+		projects := idx.workspaceReader.FindProjects(ctx, workspacePath, false, workspace.DefaultVisitPattern)
+		projectUuids := make([]string, 0, len(projects))
+		for _, p := range projects {
+			projectUuids = append(projectUuids, p.Uuid)
+		}
+		preopener.Preopen(projectUuids...)
+	}()
+}
+
 // updateProgress 更新进度
 func (idx *Indexer) updateProgress(ctx context.Context, progress *ProgressInfo) error {
 
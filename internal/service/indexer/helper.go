@@ -13,6 +13,8 @@ import (
 	"os"
 	"path/filepath"
 	"strings"
+
+	"google.golang.org/protobuf/encoding/protowire"
 )
 
 // NormalizeLineRange 标准化行范围
@@ -123,6 +125,7 @@ func (idx *Indexer) GetProjectByFilePath(ctx context.Context, workspace, filePat
 		return nil, fmt.Errorf("failed to get project for workspace %s, file %s: %w", workspace, filePath, err)
 	}
 
+	idx.recordQueryProjects(ctx, project)
 	// 验证项目索引是否存在
 	exists, err := idx.storage.ProjectIndexExists(project.Uuid)
 	if err != nil {
@@ -140,22 +143,15 @@ func (idx *Indexer) getFileElementTableByPath(ctx context.Context, projectUuid s
 	if err != nil {
 		return nil, err
 	}
-	fileTableBytes, err := idx.storage.Get(ctx, projectUuid, store.ElementPathKey{Language: language, Path: filePath})
-	if errors.Is(err, store.ErrKeyNotFound) {
-		return nil, fmt.Errorf("index not found for file %s", filePath)
-	}
-	if err != nil {
-		return nil, fmt.Errorf("failed to get file %s index, err: %v", filePath, err)
-	}
-	var fileElementTable codegraphpb.FileElementTable
-	if err = store.UnmarshalValue(fileTableBytes, &fileElementTable); err != nil {
-		return nil, fmt.Errorf("failed to unmarshal file %s index value, err: %v", filePath, err)
-	}
-	return &fileElementTable, nil
+	return idx.getFileElementTable(ctx, projectUuid, language, filePath)
 }
 
-// getFileElementTable 根据文件路径获取文件元素表
+// getFileElementTable 根据文件路径获取文件元素表，优先读取已解码的缓存，返回的表只读
 func (idx *Indexer) getFileElementTable(ctx context.Context, projectUuid string, language lang.Language, filePath string) (*codegraphpb.FileElementTable, error) {
+	cached, generation, ok := idx.fileTables.get(projectUuid, filePath)
+	if ok {
+		return cached, nil
+	}
 	fileTableBytes, err := idx.storage.Get(ctx, projectUuid, store.ElementPathKey{Language: language, Path: filePath})
 	if errors.Is(err, store.ErrKeyNotFound) {
 		return nil, fmt.Errorf("index not found for file %s", filePath)
@@ -168,6 +164,7 @@ func (idx *Indexer) getFileElementTable(ctx context.Context, projectUuid string,
 	if err = store.UnmarshalValue(fileTableBytes, &fileElementTable); err != nil {
 		return nil, fmt.Errorf("failed to unmarshal file %s index value, err: %v", filePath, err)
 	}
+	idx.fileTables.add(projectUuid, filePath, generation, &fileElementTable, len(fileTableBytes))
 
 	return &fileElementTable, nil
 }
@@ -181,10 +178,94 @@ func (idx *Indexer) getSymbolOccurrenceByName(ctx context.Context, projectUuid s
 		return nil, err
 	}
 	var SymbolOccurrence codegraphpb.SymbolOccurrence
-	err = store.UnmarshalValue(bytes, &SymbolOccurrence)
+	err = store.UnmarshalSymbolOccurrence(ctx, idx.storage, projectUuid, bytes, &SymbolOccurrence)
 	return &SymbolOccurrence, err
 }
 
+// getSymbolOccurrencesByNames 批量获取符号出现，一次读取所有符号名，不存在的符号不在结果中
+func (idx *Indexer) getSymbolOccurrencesByNames(ctx context.Context, projectUuid string,
+	language lang.Language, symbolNames []string) (map[string]*codegraphpb.SymbolOccurrence, error) {
+	if len(symbolNames) == 0 {
+		return nil, nil
+	}
+	keys := make([]store.Key, len(symbolNames))
+	for i, name := range symbolNames {
+		keys[i] = store.SymbolNameKey{Language: language, Name: name}
+	}
+	values, err := idx.storage.MultiGet(ctx, projectUuid, keys)
+	if err != nil {
+		return nil, err
+	}
+	found := make(map[string]*codegraphpb.SymbolOccurrence, len(values))
+	for i, value := range values {
+		if value == nil {
+			continue
+		}
+		var symbolOccurrence codegraphpb.SymbolOccurrence
+		if err = store.UnmarshalSymbolOccurrence(ctx, idx.storage, projectUuid, value, &symbolOccurrence); err != nil {
+			return nil, fmt.Errorf("failed to unmarshal symbol %s occurrence, err: %v", symbolNames[i], err)
+		}
+		found[symbolNames[i]] = &symbolOccurrence
+	}
+	return found, nil
+}
+
+// getFileImportsByPaths 批量获取文件的导入，只解码文件表中元素列表之外的字段。
+// 无法识别语言或没有索引的文件不在结果中
+func (idx *Indexer) getFileImportsByPaths(ctx context.Context, projectUuid string,
+	filePaths []string) (map[string][]*codegraphpb.Import, error) {
+	keys := make([]store.Key, 0, len(filePaths))
+	paths := make([]string, 0, len(filePaths))
+	for _, filePath := range filePaths {
+		language, err := lang.InferLanguage(filePath)
+		if err != nil {
+			continue
+		}
+		keys = append(keys, store.ElementPathKey{Language: language, Path: filePath})
+		paths = append(paths, filePath)
+	}
+	if len(keys) == 0 {
+		return nil, nil
+	}
+	values, err := idx.storage.MultiGet(ctx, projectUuid, keys)
+	if err != nil {
+		return nil, err
+	}
+	imports := make(map[string][]*codegraphpb.Import, len(values))
+	for i, value := range values {
+		if value == nil {
+			continue
+		}
+		var fileTable codegraphpb.FileElementTable
+		if err = unmarshalFileTableWithoutElements(value, &fileTable); err != nil {
+			return nil, fmt.Errorf("failed to unmarshal file %s index value, err: %v", paths[i], err)
+		}
+		imports[paths[i]] = fileTable.Imports
+	}
+	return imports, nil
+}
+
+// unmarshalFileTableWithoutElements 跳过 elements 字段后解码文件表，元素列表占了绝大部分体积
+func unmarshalFileTableWithoutElements(value []byte, target *codegraphpb.FileElementTable) error {
+	elementsField := target.ProtoReflect().Descriptor().Fields().ByName("elements").Number()
+	header := make([]byte, 0, 256)
+	for rest := value; len(rest) > 0; {
+		num, typ, n := protowire.ConsumeTag(rest)
+		if n < 0 {
+			return protowire.ParseError(n)
+		}
+		m := protowire.ConsumeFieldValue(num, typ, rest[n:])
+		if m < 0 {
+			return protowire.ParseError(m)
+		}
+		if num != elementsField {
+			header = append(header, rest[:n+m]...)
+		}
+		rest = rest[n+m:]
+	}
+	return store.UnmarshalValue(header, target)
+}
+
 // findSymbolInDocByRange 按范围查找符号
 func (idx *Indexer) findSymbolInDocByRange(fileElementTable *codegraphpb.FileElementTable, symbolRange []int32) *codegraphpb.Element {
 	//TODO 二分查找
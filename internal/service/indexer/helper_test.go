@@ -6,6 +6,8 @@ import (
 	"testing"
 
 	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+	"google.golang.org/protobuf/proto"
 )
 
 func TestNormalizeLineRange(t *testing.T) {
@@ -388,3 +390,25 @@ func TestFindSymbolInDocByLineRange(t *testing.T) {
 	}
 }
 
+func TestUnmarshalFileTableWithoutElements(t *testing.T) {
+	table := &codegraphpb.FileElementTable{
+		Path:      "/a/b.go",
+		Language:  "go",
+		Timestamp: 42,
+		Imports:   []*codegraphpb.Import{{Name: "fmt", Source: "fmt"}},
+		Package:   &codegraphpb.Package{Name: "b"},
+		Elements:  []*codegraphpb.Element{{Name: "main", Range: []int32{1, 0, 3, 1}}},
+	}
+	data, err := proto.Marshal(table)
+	require.NoError(t, err)
+
+	var decoded codegraphpb.FileElementTable
+	require.NoError(t, unmarshalFileTableWithoutElements(data, &decoded))
+	assert.Equal(t, table.Path, decoded.Path)
+	assert.Equal(t, table.Timestamp, decoded.Timestamp)
+	assert.Equal(t, "fmt", decoded.Imports[0].Name)
+	assert.Equal(t, "b", decoded.Package.Name)
+	assert.Empty(t, decoded.Elements)
+
+	assert.Error(t, unmarshalFileTableWithoutElements([]byte{0xff}, &decoded))
+}
@@ -0,0 +1,142 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/parser"
+	"codebase-indexer/pkg/codegraph/proto"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/resolver"
+	"codebase-indexer/pkg/codegraph/store"
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/utils"
+	"context"
+	"fmt"
+	"time"
+)
+
+// UpdateFileIndex 文件修改后更新索引。文件已有索引时增量解析，符号位置只写该文件的增量；
+// 否则删除后重建
+func (idx *Indexer) UpdateFileIndex(ctx context.Context, workspacePath string, filePath string) error {
+	start := time.Now()
+	project, err := idx.GetProjectByFilePath(ctx, workspacePath, filePath)
+	if err != nil {
+		return idx.reindexFile(ctx, workspacePath, filePath)
+	}
+	oldTable, err := idx.getFileElementTableByPath(ctx, project.Uuid, filePath)
+	if err != nil {
+		idx.logger.Debug("file %s has no index, reindex it: %v", filePath, err)
+		return idx.reindexFile(ctx, workspacePath, filePath)
+	}
+
+	// 根据规则过滤，被过滤的文件不再保留索引
+	files := idx.filterSourceFiles(ctx, workspacePath, []string{filePath})
+	if len(files) == 0 {
+		return idx.RemoveIndexes(ctx, workspacePath, []string{filePath})
+	}
+
+	content, err := idx.workspaceReader.ReadFile(ctx, filePath, types.ReadOptions{})
+	if err != nil {
+		return fmt.Errorf("read file %s err: %w", filePath, err)
+	}
+	elementTable, err := idx.parser.ParseIncremental(ctx, &types.SourceFile{Path: filePath, Content: content})
+	if err != nil {
+		return fmt.Errorf("parse file %s err: %w", filePath, err)
+	}
+	elementTable.Timestamp = files[0].ModTime
+	elementTables := []*parser.FileElementTable{elementTable}
+	if err = idx.preprocessImports(ctx, elementTables, project); err != nil {
+		idx.logger.Error("file %s preprocess import error: %v", filePath, utils.TruncateError(err))
+	}
+
+	// 符号位置按文件写增量：删除的定义先写空增量，新表中的符号再整体替换该文件的位置
+	added, removed := diffFileElements(oldTable, elementTable)
+	if err = idx.analyzer.DeleteFileSymbolOccurrences(ctx, project.Uuid, elementTable.Language, elementTable.Path,
+		removedDefinitionNames(removed)); err != nil {
+		return fmt.Errorf("remove symbol occurrences of file %s err: %w", filePath, err)
+	}
+	if _, err = idx.analyzer.SaveSymbolOccurrences(ctx, project.Uuid, 1, elementTables); err != nil {
+		return fmt.Errorf("save symbol occurrences of file %s err: %w", filePath, err)
+	}
+
+	protoElementTables := proto.FileElementTablesToProto(elementTables)
+	oldTables := []*codegraphpb.FileElementTable{oldTable}
+	if err = idx.replaceCalleeIndex(ctx, project.Uuid, oldTables, protoElementTables); err != nil {
+		idx.logger.Error("file %s save callee index error: %v", filePath, utils.TruncateError(err))
+	}
+	unlockResolve, err := idx.markResolveStale(ctx, project.Uuid, oldTables, protoElementTables)
+	if err != nil {
+		idx.logger.Error("file %s mark resolve stale error: %v", filePath, utils.TruncateError(err))
+	}
+	err = idx.storage.Put(ctx, project.Uuid, &store.Entry{
+		Key:   store.ElementPathKey{Language: elementTable.Language, Path: elementTable.Path},
+		Value: protoElementTables[0]})
+	unlockResolve()
+	idx.invalidateIndex(project.Uuid, elementTable.Path)
+	if err != nil {
+		return fmt.Errorf("save file %s index err: %w", filePath, err)
+	}
+	idx.resolveProject(ctx, project.Uuid, false)
+
+	// 文件数不变，只刷新更新时间
+	if workspaceModel, err := idx.workspaceRepository.GetWorkspaceByPath(workspacePath); err == nil && workspaceModel != nil {
+		if err = idx.workspaceRepository.UpdateCodegraphInfo(workspacePath, workspaceModel.CodegraphFileNum,
+			time.Now().Unix()); err != nil {
+			idx.logger.Error("update workspace %s codegraph info err: %v", workspacePath, err)
+		}
+	}
+
+	idx.logger.Info("update file %s index end, cost %d ms, elements %d, added symbols %d, removed symbols %d",
+		filePath, time.Since(start).Milliseconds(), len(elementTable.Elements), len(added), len(removed))
+	return nil
+}
+
+// reindexFile 删除文件的旧索引后重建
+func (idx *Indexer) reindexFile(ctx context.Context, workspacePath string, filePath string) error {
+	if err := idx.RemoveIndexes(ctx, workspacePath, []string{filePath}); err != nil {
+		return err
+	}
+	return idx.IndexFiles(ctx, workspacePath, []string{filePath})
+}
+
+// diffFileElements 按 名称+类型+位置 比较新旧元素，返回新增的元素和删除的定义
+func diffFileElements(oldTable *codegraphpb.FileElementTable, newTable *parser.FileElementTable) (
+	added []resolver.Element, removed []*codegraphpb.Element) {
+	oldKeys := make(map[string]struct{}, len(oldTable.Elements))
+	for _, e := range oldTable.Elements {
+		oldKeys[elementKey(e.Name, e.ElementType, e.Range)] = struct{}{}
+	}
+	newKeys := make(map[string]struct{}, len(newTable.Elements))
+	for _, e := range newTable.Elements {
+		key := elementKey(e.GetName(), proto.ElementTypeToProto(e.GetType()), e.GetRange())
+		newKeys[key] = struct{}{}
+		if _, ok := oldKeys[key]; !ok {
+			added = append(added, e)
+		}
+	}
+	for _, e := range oldTable.Elements {
+		if !e.IsDefinition {
+			continue
+		}
+		if _, ok := newKeys[elementKey(e.Name, e.ElementType, e.Range)]; !ok {
+			removed = append(removed, e)
+		}
+	}
+	return added, removed
+}
+
+func elementKey(name string, elementType codegraphpb.ElementType, elementRange []int32) string {
+	return fmt.Sprintf("%s|%d|%v", name, elementType, elementRange)
+}
+
+// removedDefinitionNames 删除的定义的符号名，去重。仍有同名定义的符号随后由新表的增量覆盖
+func removedDefinitionNames(removed []*codegraphpb.Element) []string {
+	names := make([]string, 0, len(removed))
+	seen := make(map[string]struct{}, len(removed))
+	for _, e := range removed {
+		if _, ok := seen[e.Name]; ok {
+			continue
+		}
+		seen[e.Name] = struct{}{}
+		names = append(names, e.Name)
+	}
+	return names
+}
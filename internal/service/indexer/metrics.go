@@ -0,0 +1,68 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/metrics"
+)
+
+// 索引流水线阶段名，read、parse 按单个文件记录，walk 按项目记录，其余按批次记录
+const (
+	stageWalk        = "walk"
+	stageRead        = "read"
+	stageParse       = "parse"
+	stageWait        = "wait"
+	stageSymbolSave  = "symbol_save"
+	stageImport      = "import"
+	stageEncode      = "encode"
+	stageCalleeSave  = "callee_save"
+	stageElementSave = "element_save"
+)
+
+// 查询类型
+const (
+	queryReferences   = "references"
+	queryDefinitions  = "definitions"
+	queryCallGraph    = "callgraph"
+	querySymbolNames  = "symbol_names"
+	querySymbolSearch = "symbol_search"
+)
+
+var (
+	// 0.5ms ~ 131s，覆盖单文件解析到整个项目遍历
+	indexStageDuration = metrics.NewHistogramVec("codebase_indexer_index_stage_duration_seconds",
+		"Duration of indexing pipeline stages. read and parse are observed per file, walk per project, others per batch.",
+		metrics.ExponentialBuckets(0.0005, 4, 10), "stage")
+	indexFilesTotal = metrics.NewCounterVec("codebase_indexer_index_files_total",
+		"Files handled by indexing tasks.", "result")
+	indexSymbolsTotal = metrics.NewCounterVec("codebase_indexer_index_symbols_total",
+		"Symbols and variables found and saved by indexing tasks.", "kind", "result")
+	queryDuration = metrics.NewHistogramVec("codebase_indexer_query_duration_seconds",
+		"Duration of code graph queries.", metrics.DefBuckets, "query")
+	queryCacheTotal = metrics.NewCounterVec("codebase_indexer_query_cache_total",
+		"Query result cache lookups. shared counts requests that waited for an identical in-flight query.",
+		"query", "result")
+
+	// 按文件记录的阶段，提前取出子指标避免每个文件都查找标签
+	readStageDuration  = indexStageDuration.WithLabelValues(stageRead)
+	parseStageDuration = indexStageDuration.WithLabelValues(stageParse)
+)
+
+// observe 记录批次在流水线各阶段的耗时，parse 阶段已按文件记录
+func (t stageTimings) observe() {
+	indexStageDuration.WithLabelValues(stageWait).ObserveDuration(t.wait)
+	indexStageDuration.WithLabelValues(stageSymbolSave).ObserveDuration(t.symbols)
+	indexStageDuration.WithLabelValues(stageImport).ObserveDuration(t.imports)
+	indexStageDuration.WithLabelValues(stageEncode).ObserveDuration(t.encode)
+	indexStageDuration.WithLabelValues(stageCalleeSave).ObserveDuration(t.callee)
+	indexStageDuration.WithLabelValues(stageElementSave).ObserveDuration(t.write)
+}
+
+// recordTaskMetrics 把索引任务的统计累计到指标中
+func recordTaskMetrics(m *types.IndexTaskMetrics) {
+	indexFilesTotal.WithLabelValues("parsed").Add(float64(m.TotalFiles - m.TotalFailedFiles))
+	indexFilesTotal.WithLabelValues("failed").Add(float64(m.TotalFailedFiles))
+	indexSymbolsTotal.WithLabelValues("symbol", "found").Add(float64(m.TotalSymbols))
+	indexSymbolsTotal.WithLabelValues("symbol", "saved").Add(float64(m.TotalSavedSymbols))
+	indexSymbolsTotal.WithLabelValues("variable", "found").Add(float64(m.TotalVariables))
+	indexSymbolsTotal.WithLabelValues("variable", "saved").Add(float64(m.TotalSavedVariables))
+}
@@ -67,18 +67,38 @@ func (idx *Indexer) removeIndexByFilePaths(ctx context.Context, projectUuid stri
 	deletePaths := make(map[string]any)
 	for _, v := range deleteFileTables {
 		deletePaths[v.Path] = nil
+		// 删除的文件不再需要缓存的语法树
+		if idx.parser != nil {
+			idx.parser.Forget(v.Path)
+		}
 	}
 
 	// 2. 清理符号定义
-	if err = idx.cleanupSymbolOccurrences(ctx, projectUuid, deleteFileTables, deletePaths); err != nil {
+	if err = idx.cleanupSymbolOccurrences(ctx, projectUuid, deleteFileTables); err != nil {
 		return 0, fmt.Errorf("cleanup symbol definitions failed: %w", err)
 	}
 
-	// 3. 删除path索引
+	// 3. 清理被调用者反向索引
+	if err = idx.removeCalleeIndex(ctx, projectUuid, deleteFileTables); err != nil {
+		return 0, fmt.Errorf("cleanup callee index failed: %w", err)
+	}
+
+	// 4. 清理延迟解析的结果，引用了被删除定义的文件重新解析
+	unlockResolve, err := idx.markResolveStale(ctx, projectUuid, deleteFileTables, nil)
+	if err != nil {
+		idx.logger.Error("project %s mark resolve stale err: %v", projectUuid, utils.TruncateError(err))
+	}
+
+	// 5. 删除path索引
 	deleted, err := idx.deleteFileIndexes(ctx, projectUuid, deletePaths)
+	unlockResolve()
+	for fp := range deletePaths {
+		idx.invalidateIndex(projectUuid, fp)
+	}
 	if err != nil {
 		return 0, fmt.Errorf("delete file indexes failed: %w", err)
 	}
+	idx.resolveProject(ctx, projectUuid, false)
 
 	return deleted, nil
 }
@@ -128,84 +148,54 @@ func (idx *Indexer) searchFileElementTablesByPath(ctx context.Context, puuid str
 	return deleteFileTables, nil
 }
 
-// searchFileElementTablesByPathPrefix 按路径前缀搜索
+// searchFileElementTablesByPathPrefix 按路径前缀搜索，每种语言只遍历路径前缀范围内的元素表
 func (idx *Indexer) searchFileElementTablesByPathPrefix(ctx context.Context, projectUuid string, path string) (
 	[]*codegraphpb.FileElementTable, []error) {
 	var errs []error
 	tables := make([]*codegraphpb.FileElementTable, 0)
-	iter := idx.storage.Iter(ctx, projectUuid)
-	for iter.Next() {
-		if !store.IsElementPathKey(iter.Key()) {
+	// path 可能包含分隔符，也可能不包含，统一处理
+	pathPrefix := utils.EnsureTrailingSeparator(path)
+	for _, keyPrefix := range store.ElementPathKeyPrefixes(pathPrefix) {
+		iter := idx.storage.IterPrefix(ctx, projectUuid, keyPrefix)
+		if iter == nil {
 			continue
 		}
-		pathKey, err := store.ToElementPathKey(iter.Key())
-		if err != nil {
-			idx.logger.Debug("indexer delete index, parse element path key %s err:%v", iter.Key(), err)
-			continue
-		}
-		// path 可能包含分隔符，也可能不包含，统一处理
-		pathPrefix := utils.EnsureTrailingSeparator(path)
-		if strings.HasPrefix(pathKey.Path, pathPrefix) {
+		for iter.Next() {
 			ft := new(codegraphpb.FileElementTable)
-			if err = store.UnmarshalValue(iter.Value(), ft); err != nil {
+			if err := store.UnmarshalValue(iter.Value(), ft); err != nil {
 				errs = append(errs, err)
 				continue
 			}
 			tables = append(tables, ft)
 		}
-	}
-	err := iter.Close()
-	if err != nil {
-		idx.logger.Error("indexer close graph_store err:%v", err)
+		if err := iter.Close(); err != nil {
+			idx.logger.Error("indexer close graph_store err:%v", err)
+		}
 	}
 	return tables, errs
 }
 
-// cleanupSymbolOccurrences 清理符号定义
+// cleanupSymbolOccurrences 清理符号定义，每个文件的定义写空增量，不读取符号表
 func (idx *Indexer) cleanupSymbolOccurrences(ctx context.Context, projectUuid string,
-	deleteFileTables []*codegraphpb.FileElementTable, deletedPaths map[string]interface{}) error {
+	deleteFileTables []*codegraphpb.FileElementTable) error {
 	var errs []error
 
 	for _, ft := range deleteFileTables {
+		names := make([]string, 0, len(ft.Elements))
+		seen := make(map[string]struct{}, len(ft.Elements))
 		for _, e := range ft.Elements {
-			if e.IsDefinition {
-				language := lang.Language(ft.Language)
-				sym, err := idx.storage.Get(ctx, projectUuid, store.SymbolNameKey{Language: language, Name: e.GetName()})
-				if err != nil && !errors.Is(err, store.ErrKeyNotFound) {
-					errs = append(errs, err)
-					continue
-				}
-				symDefs := new(codegraphpb.SymbolOccurrence)
-				if err = store.UnmarshalValue(sym, symDefs); err != nil {
-					return fmt.Errorf("unmarshal SymbolOccurrence error:%w", err)
-				}
-
-				newSymDefs := &codegraphpb.SymbolOccurrence{
-					Name:        e.GetName(),
-					Language:    ft.Language,
-					Occurrences: make([]*codegraphpb.Occurrence, 0),
-				}
-				for _, d := range symDefs.Occurrences {
-					if _, ok := deletedPaths[d.Path]; ok {
-						continue
-					}
-					newSymDefs.Occurrences = append(newSymDefs.Occurrences, d)
-				}
-				// 如果新的为0，就无需再写入，并删除旧的
-				if len(newSymDefs.Occurrences) == 0 {
-					if err := idx.storage.Delete(ctx, projectUuid, store.SymbolNameKey{Language: language,
-						Name: newSymDefs.Name}); err != nil {
-						errs = append(errs, err)
-					}
-					continue
-				}
-
-				// 保存更新后的符号表
-				if err := idx.storage.Put(ctx, projectUuid, &store.Entry{Key: store.SymbolNameKey{Language: language,
-					Name: newSymDefs.Name}, Value: newSymDefs}); err != nil {
-					errs = append(errs, err)
-				}
+			if !e.IsDefinition {
+				continue
+			}
+			if _, ok := seen[e.GetName()]; ok {
+				continue
 			}
+			seen[e.GetName()] = struct{}{}
+			names = append(names, e.GetName())
+		}
+		if err := idx.analyzer.DeleteFileSymbolOccurrences(ctx, projectUuid, lang.Language(ft.Language), ft.Path,
+			names); err != nil {
+			errs = append(errs, err)
 		}
 	}
 
@@ -250,6 +240,7 @@ func (idx *Indexer) RemoveAllIndexes(ctx context.Context, workspacePath string)
 	var errs []error
 	for _, p := range projects {
 		errs = append(errs, idx.storage.DeleteAll(ctx, p.Uuid))
+		idx.invalidateProjectIndex(p.Uuid)
 	}
 	// 将数据库数据置为0
 	if err := idx.workspaceRepository.UpdateCodegraphInfo(workspacePath, 0, time.Now().Unix()); err != nil {
@@ -285,6 +276,14 @@ func (idx *Indexer) RenameIndexes(ctx context.Context, workspacePath string, sou
 	}
 
 	sourceProjectUuid, targetProjectUuid := sourceProject.Uuid, targetProject.Uuid
+	// 重命名最后更新符号表，结束后重新解析受影响的文件，再使查询结果失效
+	defer func() {
+		idx.resolveProject(ctx, sourceProjectUuid, false)
+		if targetProjectUuid != sourceProjectUuid {
+			idx.resolveProject(ctx, targetProjectUuid, false)
+		}
+		idx.queryCache.bump(sourceProjectUuid, targetProjectUuid)
+	}()
 	// 可能是文件，也可能是目录
 	sourceTables, err := idx.searchFileElementTablesByPath(ctx, sourceProjectUuid, []string{sourceFilePath})
 	if err != nil {
@@ -301,9 +300,18 @@ func (idx *Indexer) RenameIndexes(ctx context.Context, workspacePath string, sou
 		oldPath := st.Path
 		oldLanguage := st.Language
 		// 删除
+		if err = idx.removeCalleeIndex(ctx, sourceProjectUuid, []*codegraphpb.FileElementTable{st}); err != nil {
+			idx.logger.Debug("delete callee index %s %s err:%v", st.Language, st.Path, err)
+		}
+		unlockResolve, err := idx.markResolveStale(ctx, sourceProjectUuid, []*codegraphpb.FileElementTable{st}, nil)
+		if err != nil {
+			idx.logger.Debug("mark resolve stale %s %s err:%v", st.Language, st.Path, err)
+		}
 		if err = idx.storage.Delete(ctx, sourceProjectUuid, store.ElementPathKey{Language: lang.Language(st.Language), Path: st.Path}); err != nil {
 			idx.logger.Debug("delete index %s %s err:%v", st.Language, st.Path, err)
 		}
+		unlockResolve()
+		idx.invalidateIndex(sourceProjectUuid, oldPath)
 		// 将path中 sourceFilePath 重命名为targetFilePath，
 		newPath := strings.ReplaceAll(st.Path, trimmedSourcePath, trimmedTargetPath)
 		newLanguage, err := lang.InferLanguage(newPath)
@@ -319,6 +327,15 @@ func (idx *Indexer) RenameIndexes(ctx context.Context, workspacePath string, sou
 			Language: newLanguage, Path: newPath}, Value: st}); err != nil {
 			idx.logger.Debug("save new index %s err:%v ", newPath, err)
 		}
+		idx.invalidateIndex(targetProjectUuid, newPath)
+		if err = idx.saveCalleeIndex(ctx, targetProjectUuid, []*codegraphpb.FileElementTable{st}); err != nil {
+			idx.logger.Debug("save new callee index %s err:%v ", newPath, err)
+		}
+		unlockResolve, err = idx.markResolveStale(ctx, targetProjectUuid, nil, []*codegraphpb.FileElementTable{st})
+		if err != nil {
+			idx.logger.Debug("mark resolve stale %s err:%v ", newPath, err)
+		}
+		unlockResolve()
 
 		// 更新符号定义，找到相关符号，将它的path由old改为new
 		for _, e := range st.Elements {
@@ -0,0 +1,126 @@
+package indexer
+
+import (
+	"context"
+	"fmt"
+	"sync"
+	"time"
+)
+
+// byteBudget 流水线在途数据的字节预算。批次读取文件前按收集时的文件大小占用预算，读取后按实际字节数调整，
+// 写入完成后释放，预算用尽时解析阶段在读取前等待，内存占用与文件数无关
+type byteBudget struct {
+	mu    sync.Mutex
+	cond  *sync.Cond
+	limit int64
+	used  int64
+}
+
+func newByteBudget(limit int64) *byteBudget {
+	if limit <= 0 {
+		limit = DefaultMaxInflightBytes
+	}
+	b := &byteBudget{limit: limit}
+	b.cond = sync.NewCond(&b.mu)
+	return b
+}
+
+// acquire 占用 n 字节，返回实际占用的字节数，释放时原样传回。单个批次超过预算时按整个预算占用，
+// 等它写完再继续，避免永远等待
+func (b *byteBudget) acquire(ctx context.Context, n int64) (int64, error) {
+	n = min(max(n, 0), b.limit)
+	stop := context.AfterFunc(ctx, func() {
+		b.mu.Lock()
+		b.cond.Broadcast()
+		b.mu.Unlock()
+	})
+	defer stop()
+
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	for b.used > 0 && b.used+n > b.limit {
+		if err := ctx.Err(); err != nil {
+			return 0, err
+		}
+		b.cond.Wait()
+	}
+	if err := ctx.Err(); err != nil {
+		return 0, err
+	}
+	b.used += n
+	return n, nil
+}
+
+// resize 把已占用的 held 字节调整为 n，返回调整后的占用，释放时传回。不等待：文件在收集后变大时短暂超出预算，
+// 变小时唤醒等待者
+func (b *byteBudget) resize(held, n int64) int64 {
+	n = min(max(n, 0), b.limit)
+	if n == held {
+		return n
+	}
+	b.mu.Lock()
+	b.used += n - held
+	b.mu.Unlock()
+	if n < held {
+		b.cond.Broadcast()
+	}
+	return n
+}
+
+func (b *byteBudget) release(n int64) {
+	if n <= 0 {
+		return
+	}
+	b.mu.Lock()
+	b.used -= n
+	b.mu.Unlock()
+	b.cond.Broadcast()
+}
+
+// Yielder 长时间索引任务的让出点，由调度方通过上下文传入。流水线在提交每个批次前检查，
+// 需要让出时等在途批次写完再调用 Yield，返回后从下一个批次继续
+type Yielder interface {
+	// Preempted 是否有更高优先级的任务在等待执行
+	Preempted() bool
+	// Yield 让出执行权，直到再次被调度
+	Yield(ctx context.Context) error
+}
+
+type yielderKey struct{}
+
+// WithYielder 返回带让出点的上下文
+func WithYielder(ctx context.Context, yielder Yielder) context.Context {
+	return context.WithValue(ctx, yielderKey{}, yielder)
+}
+
+func yielderFromContext(ctx context.Context) Yielder {
+	yielder, _ := ctx.Value(yielderKey{}).(Yielder)
+	return yielder
+}
+
+// stageTimings 单个批次或整个任务在流水线各阶段的耗时
+type stageTimings struct {
+	parse   time.Duration // 读取并解析文件
+	wait    time.Duration // 等待在途字节预算
+	symbols time.Duration // 写入符号表
+	imports time.Duration // 预处理import
+	encode  time.Duration // 转换为proto
+	callee  time.Duration // 替换被调用者索引
+	write   time.Duration // 写入文件元素表
+}
+
+func (t *stageTimings) add(o stageTimings) {
+	t.parse += o.parse
+	t.wait += o.wait
+	t.symbols += o.symbols
+	t.imports += o.imports
+	t.encode += o.encode
+	t.callee += o.callee
+	t.write += o.write
+}
+
+func (t stageTimings) String() string {
+	return fmt.Sprintf("parse %d ms, wait %d ms, symbols %d ms, imports %d ms, encode %d ms, callee %d ms, write %d ms",
+		t.parse.Milliseconds(), t.wait.Milliseconds(), t.symbols.Milliseconds(), t.imports.Milliseconds(),
+		t.encode.Milliseconds(), t.callee.Milliseconds(), t.write.Milliseconds())
+}
@@ -0,0 +1,68 @@
+package indexer
+
+import (
+	"context"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestByteBudget(t *testing.T) {
+	ctx := context.Background()
+	budget := newByteBudget(100)
+
+	n, err := budget.acquire(ctx, 60)
+	require.NoError(t, err)
+	assert.Equal(t, int64(60), n)
+
+	// 超出预算时等待释放
+	acquired := make(chan int64)
+	go func() {
+		m, err := budget.acquire(ctx, 60)
+		assert.NoError(t, err)
+		acquired <- m
+	}()
+	select {
+	case <-acquired:
+		t.Fatal("acquire should wait until budget is released")
+	case <-time.After(50 * time.Millisecond):
+	}
+	budget.release(n)
+	assert.Equal(t, int64(60), <-acquired)
+	budget.release(60)
+
+	// 单个批次超过预算时按整个预算占用
+	n, err = budget.acquire(ctx, 1000)
+	require.NoError(t, err)
+	assert.Equal(t, int64(100), n)
+
+	// 等待期间上下文取消
+	cancelCtx, cancel := context.WithCancel(ctx)
+	go func() {
+		time.Sleep(20 * time.Millisecond)
+		cancel()
+	}()
+	_, err = budget.acquire(cancelCtx, 1)
+	assert.ErrorIs(t, err, context.Canceled)
+	budget.release(n)
+
+	// 按估算占用后调整为实际大小，缩小时唤醒等待者，增大时不等待
+	n, err = budget.acquire(ctx, 80)
+	require.NoError(t, err)
+	go func() {
+		m, err := budget.acquire(ctx, 60)
+		assert.NoError(t, err)
+		acquired <- m
+	}()
+	time.Sleep(20 * time.Millisecond)
+	n = budget.resize(n, 40)
+	assert.Equal(t, int64(40), n)
+	assert.Equal(t, int64(60), <-acquired)
+	n = budget.resize(n, 70)
+	assert.Equal(t, int64(70), n)
+	budget.release(n)
+	budget.release(60)
+	assert.Zero(t, budget.used)
+}
@@ -14,6 +14,8 @@ import (
 	"errors"
 	"fmt"
 	"path/filepath"
+	"sort"
+	"strconv"
 	"strings"
 	"time"
 )
@@ -22,7 +24,21 @@ import (
 // 支持根据符号名全局查找引用
 // 支持查询某个文件内的符号的引用
 // 支持查询某个文件内的行范围的符号的引用
+// 索引未变化时相同请求返回缓存的结果
 func (idx *Indexer) QueryReferences(ctx context.Context, opts *types.QueryReferenceOptions) ([]*types.RelationNode, error) {
+	if relationEmitterFromContext(ctx) != nil {
+		return idx.queryReferences(ctx, opts)
+	}
+	key := queryCacheKey(queryReferences, opts.Workspace, opts.FilePath, strconv.Itoa(opts.StartLine),
+		strconv.Itoa(opts.EndLine), opts.SymbolName)
+	return cachedQuery(ctx, idx.queryCache, queryReferences, key, cloneRelationNodes, relationNodesSize,
+		func(ctx context.Context) ([]*types.RelationNode, bool, error) {
+			nodes, err := idx.queryReferences(ctx, opts)
+			return nodes, true, err
+		})
+}
+
+func (idx *Indexer) queryReferences(ctx context.Context, opts *types.QueryReferenceOptions) ([]*types.RelationNode, error) {
 	startTime := time.Now()
 	filePath := opts.FilePath
 	start, end := NormalizeLineRange(opts.StartLine, opts.EndLine, MaxQueryLineLimit)
@@ -46,6 +62,7 @@ func (idx *Indexer) QueryReferences(ctx context.Context, opts *types.QueryRefere
 	}
 	projectUuid := project.Uuid
 	defer func() {
+		queryDuration.WithLabelValues(queryReferences).ObserveSince(startTime)
 		idx.logger.Info("Query_reference execution time: %d ms", time.Since(startTime).Milliseconds())
 	}()
 
@@ -104,8 +121,14 @@ func (idx *Indexer) QueryReferences(ctx context.Context, opts *types.QueryRefere
 	if len(definitions) == 0 {
 		return definitions, nil
 	}
+	if err := emitRoots(relationEmitterFromContext(ctx), definitions); err != nil {
+		return nil, err
+	}
 	// 找定义的所有引用，通过遍历所有文件的方式
-	idx.findSymbolReferences(ctx, projectUuid, definitionNames, filePath)
+	if err := idx.findSymbolReferences(ctx, projectUuid, lang.Language(fileElementTable.Language), definitionNames,
+		filePath); err != nil {
+		return nil, err
+	}
 
 	return definitions, nil
 }
@@ -114,24 +137,23 @@ func (idx *Indexer) QueryReferences(ctx context.Context, opts *types.QueryRefere
 func (idx *Indexer) queryReferencesBySymbolName(ctx context.Context, opts *types.QueryReferenceOptions) ([]*types.RelationNode, error) {
 	startTime := time.Now()
 	defer func() {
+		queryDuration.WithLabelValues(queryReferences).ObserveSince(startTime)
 		idx.logger.Info("Query_reference execution time: %d ms", time.Since(startTime).Milliseconds())
 	}()
 	projects := idx.workspaceReader.FindProjects(ctx, opts.Workspace, true, workspace.DefaultVisitPattern)
+	idx.recordQueryProjects(ctx, projects...)
 	if len(projects) == 0 {
 		return nil, fmt.Errorf("query references by symbol name [%s] failed, no project found in workspace %s", opts.SymbolName, opts.Workspace)
 	}
 	var defMap = make(map[string]*types.RelationNode)
 	var definitions []*types.RelationNode
+	var defLanguage lang.Language
 	findDefinition := func() {
 		for _, project := range projects {
 			// 查询同名定义
-			iter := idx.storage.Iter(ctx, project.Uuid)
+			iter := idx.storage.IterPrefix(ctx, project.Uuid, store.PathKeySystemPrefix)
 			defer iter.Close()
 			for iter.Next() {
-				key := iter.Key()
-				if store.IsSymbolNameKey(key) {
-					continue
-				}
 				var elementTable codegraphpb.FileElementTable
 				if err := store.UnmarshalValue(iter.Value(), &elementTable); err != nil {
 					idx.logger.Error("failed to unmarshal file element_table value, err: %v", err)
@@ -159,6 +181,7 @@ func (idx *Indexer) queryReferencesBySymbolName(ctx context.Context, opts *types
 					definitions = append(definitions, def)
 					// 相同的name得到的结果是一样的，所以不重复添加，找到一个就返回
 					defMap[elem.Name] = def
+					defLanguage = lang.Language(elementTable.Language)
 					return
 				}
 			}
@@ -169,21 +192,49 @@ func (idx *Indexer) queryReferencesBySymbolName(ctx context.Context, opts *types
 		// 提前返回，避免遍历所有文件
 		return definitions, nil
 	}
+	if err := emitRoots(relationEmitterFromContext(ctx), definitions); err != nil {
+		return nil, err
+	}
 	for _, project := range projects {
 		// 找定义的所有引用，通过遍历所有文件的方式
-		idx.findSymbolReferences(ctx, project.Uuid, defMap, opts.FilePath)
+		if err := idx.findSymbolReferences(ctx, project.Uuid, defLanguage, defMap, opts.FilePath); err != nil {
+			return nil, err
+		}
 	}
 	return definitions, nil
 }
 
-// findSymbolReferences 查找符号被调用或引用的位置
-func (idx *Indexer) findSymbolReferences(ctx context.Context, projectUuid string, definitionNames map[string]*types.RelationNode, filePath string) {
-	iter := idx.storage.Iter(ctx, projectUuid)
+// findSymbolReferences 查找符号被调用或引用的位置。项目的延迟解析结果完整时只读取引用了这些符号的文件，否则遍历项目所有文件。
+// 上下文带有 RelationEmitter 时每个文件发出一批引用，上下文取消或发出失败时停止遍历并返回错误
+func (idx *Indexer) findSymbolReferences(ctx context.Context, projectUuid string, language lang.Language,
+	definitionNames map[string]*types.RelationNode, filePath string) error {
+	emit := relationEmitterFromContext(ctx)
+	names := make([]string, 0, len(definitionNames))
+	for name := range definitionNames {
+		names = append(names, name)
+	}
+	if files, ok := idx.getResolvedReferenceFiles(ctx, projectUuid, language, names); ok {
+		for _, path := range files {
+			if err := ctx.Err(); err != nil {
+				return err
+			}
+			elementTable, err := idx.getFileElementTableByPath(ctx, projectUuid, path)
+			if err != nil {
+				idx.logger.Debug("get file %s element_table err: %v", path, err)
+				continue
+			}
+			if err := appendSymbolReferences(elementTable, definitionNames, emit); err != nil {
+				return err
+			}
+		}
+		return nil
+	}
+
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.PathKeySystemPrefix)
 	defer iter.Close()
 	for iter.Next() {
-		key := iter.Key()
-		if store.IsSymbolNameKey(key) {
-			continue
+		if err := ctx.Err(); err != nil {
+			return err
 		}
 		var elementTable codegraphpb.FileElementTable
 		if err := store.UnmarshalValue(iter.Value(), &elementTable); err != nil {
@@ -191,27 +242,45 @@ func (idx *Indexer) findSymbolReferences(ctx context.Context, projectUuid string
 			continue
 		}
 		// TODO 根据import 过滤
+		if err := appendSymbolReferences(&elementTable, definitionNames, emit); err != nil {
+			return err
+		}
+	}
+	return nil
+}
 
-		for _, element := range elementTable.Elements {
-			if element.IsDefinition {
-				continue
-			}
-			if element.ElementType != codegraphpb.ElementType_REFERENCE &&
-				element.ElementType != codegraphpb.ElementType_CALL {
-				continue
+// appendSymbolReferences 把文件中对这些符号的调用、引用加入定义节点的子节点，发出该文件的一批引用
+func appendSymbolReferences(elementTable *codegraphpb.FileElementTable, definitionNames map[string]*types.RelationNode,
+	emit RelationEmitter) error {
+	var parents, nodes []*types.RelationNode
+	for _, element := range elementTable.Elements {
+		if element.IsDefinition {
+			continue
+		}
+		if element.ElementType != codegraphpb.ElementType_REFERENCE &&
+			element.ElementType != codegraphpb.ElementType_CALL {
+			continue
+		}
+		// 引用
+		if v, ok := definitionNames[element.Name]; ok {
+			position := types.ToPosition(element.Range)
+			node := &types.RelationNode{
+				FilePath:   elementTable.Path,
+				SymbolName: element.Name,
+				Position:   &position,
+				NodeType:   string(proto.ElementTypeFromProto(element.ElementType)),
 			}
-			// 引用
-			if v, ok := definitionNames[element.Name]; ok {
-				position := types.ToPosition(element.Range)
-				v.Children = append(v.Children, &types.RelationNode{
-					FilePath:   elementTable.Path,
-					SymbolName: element.Name,
-					Position:   &position,
-					NodeType:   string(proto.ElementTypeFromProto(element.ElementType)),
-				})
+			v.Children = append(v.Children, node)
+			if emit != nil {
+				parents = append(parents, v)
+				nodes = append(nodes, node)
 			}
 		}
 	}
+	if len(nodes) > 0 {
+		return emit(1, parents, nodes)
+	}
+	return nil
 }
 
 // querySymbolsByLines 按位置查询 occurrence
@@ -252,8 +321,19 @@ func (idx *Indexer) querySymbolsByName(doc *codegraphpb.FileElementTable, opts *
 	return nodes
 }
 
-// QueryDefinitions 支持单符号全局查询、行号范围内的符号定义查询、代码片段内的符号定义查询
+// QueryDefinitions 支持单符号全局查询、行号范围内的符号定义查询、代码片段内的符号定义查询，
+// 索引未变化时相同请求返回缓存的结果
 func (idx *Indexer) QueryDefinitions(ctx context.Context, opts *types.QueryDefinitionOptions) ([]*types.Definition, error) {
+	key := queryCacheKey(queryDefinitions, opts.Workspace, opts.FilePath, strconv.Itoa(opts.StartLine),
+		strconv.Itoa(opts.EndLine), opts.SymbolNames, string(opts.CodeSnippet))
+	return cachedQuery(ctx, idx.queryCache, queryDefinitions, key, cloneDefinitions, definitionsSize,
+		func(ctx context.Context) ([]*types.Definition, bool, error) {
+			definitions, err := idx.queryDefinitions(ctx, opts)
+			return definitions, true, err
+		})
+}
+
+func (idx *Indexer) queryDefinitions(ctx context.Context, opts *types.QueryDefinitionOptions) ([]*types.Definition, error) {
 	// 参数验证
 	if opts.Workspace == "" {
 		return nil, fmt.Errorf("workspace cannot be empty")
@@ -304,6 +384,7 @@ func (idx *Indexer) QueryDefinitions(ctx context.Context, opts *types.QueryDefin
 	// 性能监控
 	startTime := time.Now()
 	defer func() {
+		queryDuration.WithLabelValues(queryDefinitions).ObserveSince(startTime)
 		idx.logger.Info("query func definitions cost %d ms", time.Since(startTime).Milliseconds())
 	}()
 
@@ -393,24 +474,46 @@ func (idx *Indexer) queryFuncDefinitionsBySnippet(ctx context.Context, project *
 // queryFuncDefinitionsByLineRange 通过行号范围查询函数定义
 func (idx *Indexer) queryFuncDefinitionsByLineRange(ctx context.Context, projectUuid string, language lang.Language, opts *types.QueryDefinitionOptions) ([]*types.Definition, error) {
 	// 首先查询出来范围内的所有符号
-	var fileTable codegraphpb.FileElementTable
-	fileTableBytes, err := idx.storage.Get(ctx, projectUuid, store.ElementPathKey{Language: language, Path: opts.FilePath})
-	if errors.Is(err, store.ErrKeyNotFound) {
-		return nil, fmt.Errorf("index not found for file %s", opts.FilePath)
-	}
+	fileTable, err := idx.getFileElementTable(ctx, projectUuid, language, opts.FilePath)
 	if err != nil {
-		return nil, fmt.Errorf("failed to get file %s index, err: %v", opts.FilePath, err)
-	}
-	if err = store.UnmarshalValue(fileTableBytes, &fileTable); err != nil {
-		return nil, fmt.Errorf("failed to unmarshal file %s index value, err: %v", opts.FilePath, err)
+		return nil, err
 	}
 
 	// 查询范围内的所有符号
 	queryStartLine := int32(opts.StartLine - 1)
 	queryEndLine := int32(opts.EndLine - 1)
-	foundSymbols := idx.findSymbolInDocByLineRange(ctx, &fileTable, queryStartLine, queryEndLine)
+	foundSymbols := idx.findSymbolInDocByLineRange(ctx, fileTable, queryStartLine, queryEndLine)
 	currentImports := fileTable.Imports
 
+	// 非定义符号的定义一次批量加载
+	referenceNames := make([]string, 0, len(foundSymbols))
+	for _, s := range foundSymbols {
+		if !s.IsDefinition {
+			referenceNames = append(referenceNames, s.GetName())
+		}
+	}
+	symbolOccurrences, err := idx.getSymbolOccurrencesByNames(ctx, projectUuid, language, referenceNames)
+	if err != nil {
+		idx.logger.Debug("get symbol occurrences err:%v", err)
+	}
+	// 已延迟解析的符号直接取解析到的定义文件，不再按导入过滤
+	resolvedPaths := make(map[string]map[string]struct{})
+	if isResolvableLanguage(language) && len(referenceNames) > 0 {
+		keys := make([]store.ResolvedSymbolKey, len(referenceNames))
+		for i, name := range referenceNames {
+			keys[i] = store.ResolvedSymbolKey{SymbolName: name, FilePath: opts.FilePath}
+		}
+		paths, err := idx.getResolvedSymbolPaths(ctx, projectUuid, keys)
+		if err != nil {
+			idx.logger.Debug("get resolved symbols err:%v", err)
+		}
+		for i, p := range paths {
+			if p != nil {
+				resolvedPaths[referenceNames[i]] = p
+			}
+		}
+	}
+
 	var results []*types.Definition
 	for _, s := range foundSymbols {
 		if s.IsDefinition {
@@ -424,22 +527,22 @@ func (idx *Indexer) queryFuncDefinitionsByLineRange(ctx context.Context, project
 			continue
 		} else {
 			// 加载其他符号的定义
-			bytes, err := idx.storage.Get(ctx, projectUuid, store.SymbolNameKey{Name: s.GetName(),
-				Language: language})
-			if err != nil {
-				if !errors.Is(err, store.ErrKeyNotFound) {
-					idx.logger.Debug("get symbol occurrence err:%v", err)
-				}
-				continue
-			}
-			var exist codegraphpb.SymbolOccurrence
-			if err = store.UnmarshalValue(bytes, &exist); err != nil {
-				idx.logger.Debug("unmarshal symbol occurrence err:%v", err)
+			exist, ok := symbolOccurrences[s.GetName()]
+			if !ok {
 				continue
 			}
 
-			// TODO 过滤效果待定
-			filtered := idx.analyzer.FilterByImports(opts.FilePath, currentImports, exist.Occurrences)
+			var filtered []*codegraphpb.Occurrence
+			if paths, ok := resolvedPaths[s.GetName()]; ok {
+				for _, o := range exist.Occurrences {
+					if _, ok := paths[o.Path]; ok {
+						filtered = append(filtered, o)
+					}
+				}
+			} else {
+				// TODO 过滤效果待定
+				filtered = idx.analyzer.FilterByImports(opts.FilePath, currentImports, exist.Occurrences)
+			}
 			if len(filtered) == 0 {
 				// 防止全部过滤掉
 				filtered = exist.Occurrences
@@ -465,21 +568,22 @@ func (idx *Indexer) queryFuncDefinitionsBySymbolNames(ctx context.Context, works
 	var results []*types.Definition
 	languages := lang.GetAllSupportedLanguages()
 	projects := idx.workspaceReader.FindProjects(ctx, workspacePath, true, workspace.DefaultVisitPattern)
+	idx.recordQueryProjects(ctx, projects...)
 	if len(projects) == 0 {
 		return nil, fmt.Errorf("query definitions by symbol names [%v] failed, no project found in workspace %s", symbolNames, workspacePath)
 	}
 	for _, project := range projects {
 		for _, language := range languages {
+			symbolOccurrences, err := idx.getSymbolOccurrencesByNames(ctx, project.Uuid, language, symbolNames)
+			if err != nil {
+				idx.logger.Debug("get project %s symbol occurrences err:%v", project.Uuid, err)
+				continue
+			}
 			for _, symbolName := range symbolNames {
-				bytes, err := idx.storage.Get(ctx, project.Uuid, store.SymbolNameKey{Name: symbolName,
-					Language: language})
-				if err != nil {
+				exist, ok := symbolOccurrences[symbolName]
+				if !ok {
 					continue
 				}
-				var exist codegraphpb.SymbolOccurrence
-				if err = store.UnmarshalValue(bytes, &exist); err != nil {
-					return nil, err
-				}
 				// 根据Occurrence信息封装为定义
 				for _, o := range exist.Occurrences {
 					results = append(results, &types.Definition{
@@ -495,6 +599,76 @@ func (idx *Indexer) queryFuncDefinitionsBySymbolNames(ctx context.Context, works
 	return results, nil
 }
 
+// SearchSymbols 按符号名前缀、子串或模糊匹配搜索工作区内的符号，合并各项目的结果按分数排序
+func (idx *Indexer) SearchSymbols(ctx context.Context, opts *types.SearchSymbolOptions) ([]*types.SymbolSearchResult, error) {
+	startTime := time.Now()
+	if strings.TrimSpace(opts.Query) == types.EmptyString {
+		return nil, errs.NewMissingParamError("query")
+	}
+	searcher, ok := idx.storage.(store.SymbolNameSearcher)
+	if !ok {
+		return nil, fmt.Errorf("symbol search is not supported by storage")
+	}
+	limit := opts.Limit
+	if limit <= 0 {
+		limit = store.DefaultSymbolSearchLimit
+	}
+	limit = min(limit, store.MaxSymbolSearchLimit)
+	projects := idx.workspaceReader.FindProjects(ctx, opts.Workspace, true, workspace.DefaultVisitPattern)
+	if len(projects) == 0 {
+		return nil, fmt.Errorf("search symbols %s failed, no project found in workspace %s", opts.Query, opts.Workspace)
+	}
+	defer func() {
+		queryDuration.WithLabelValues(querySymbolSearch).ObserveSince(startTime)
+	}()
+
+	var results []*types.SymbolSearchResult
+	for _, project := range projects {
+		matches, err := searcher.SearchSymbolNames(ctx, project.Uuid, store.SymbolSearchOptions{
+			Query:    opts.Query,
+			Language: lang.Language(opts.Language),
+			Limit:    limit,
+		})
+		if err != nil {
+			if errors.Is(err, context.Canceled) || errors.Is(err, context.DeadlineExceeded) {
+				return nil, err
+			}
+			idx.logger.Debug("search project %s symbols err:%v", project.Uuid, err)
+			continue
+		}
+		for _, m := range matches {
+			definitions := make([]*types.Definition, 0, len(m.Occurrences))
+			for _, o := range m.Occurrences {
+				definitions = append(definitions, &types.Definition{
+					Path:  o.Path,
+					Name:  m.Name,
+					Range: o.Range,
+					Type:  string(proto.ToDefinitionElementType(proto.ElementTypeFromProto(o.ElementType))),
+				})
+			}
+			results = append(results, &types.SymbolSearchResult{
+				SymbolName:  m.Name,
+				Language:    string(m.Language),
+				MatchType:   string(m.Kind),
+				Score:       m.Score,
+				Definitions: definitions,
+			})
+		}
+	}
+	sort.SliceStable(results, func(i, j int) bool {
+		if results[i].Score != results[j].Score {
+			return results[i].Score > results[j].Score
+		}
+		return results[i].SymbolName < results[j].SymbolName
+	})
+	if len(results) > limit {
+		results = results[:limit]
+	}
+	idx.logger.Info("search symbols %s end, cost %d ms, projects: %d, found: %d", opts.Query,
+		time.Since(startTime).Milliseconds(), len(projects), len(results))
+	return results, nil
+}
+
 // searchSymbolNames 搜索符号名
 func (idx *Indexer) searchSymbolNames(ctx context.Context, projectUuid string, language lang.Language, names []string, imports []*codegraphpb.Import) (
 	map[string][]*codegraphpb.Occurrence, error) {
@@ -512,23 +686,14 @@ func (idx *Indexer) searchSymbolNames(ctx context.Context, projectUuid string, l
 	names = deduped
 	found := make(map[string][]*codegraphpb.Occurrence)
 
+	// 所有符号名一次批量读取
+	symbolOccurrences, err := idx.getSymbolOccurrencesByNames(ctx, projectUuid, language, names)
+	if err != nil {
+		return nil, fmt.Errorf("failed to get symbol occurrences: %w", err)
+	}
 	for _, name := range names {
-
-		bytes, err := idx.storage.Get(ctx, projectUuid, store.SymbolNameKey{
-			Language: language,
-			Name:     name,
-		})
-
-		if err != nil {
-			continue
-		}
-
-		var symbolOccurrence codegraphpb.SymbolOccurrence
-		if err := store.UnmarshalValue(bytes, &symbolOccurrence); err != nil {
-			return nil, fmt.Errorf("failed to deserialize index: %w", err)
-		}
-
-		if len(symbolOccurrence.Occurrences) == 0 {
+		symbolOccurrence, ok := symbolOccurrences[name]
+		if !ok || len(symbolOccurrence.Occurrences) == 0 {
 			continue
 		}
 
@@ -558,6 +723,7 @@ func (idx *Indexer) searchSymbolNames(ctx context.Context, projectUuid string, l
 		}
 	}
 
+	queryDuration.WithLabelValues(querySymbolNames).ObserveSince(start)
 	idx.logger.Info("codegraph symbol name search end, cost %d ms, names count: %d, key found:%d",
 		time.Since(start).Milliseconds(), len(names), total, len(found))
 	return found, nil
@@ -577,6 +743,7 @@ func (idx *Indexer) queryElements(ctx context.Context, workspacePath string, fil
 	idx.logger.Info("start to query workspace %s files: %v", workspacePath, filePaths)
 
 	projects := idx.workspaceReader.FindProjects(ctx, workspacePath, false, workspace.DefaultVisitPattern)
+	idx.recordQueryProjects(ctx, projects...)
 	if len(projects) == 0 {
 		return nil, fmt.Errorf("no project found in workspace %s", workspacePath)
 	}
@@ -595,16 +762,11 @@ func (idx *Indexer) queryElements(ctx context.Context, workspacePath string, fil
 			if err != nil {
 				continue
 			}
-			fileTable, err := idx.storage.Get(context.Background(), puuid, store.ElementPathKey{Language: language, Path: fp})
+			ft, err := idx.getFileElementTable(context.Background(), puuid, language, fp)
 			if err != nil {
 				errs = append(errs, fmt.Errorf("get file table %s failed: %w", fp, err))
 				continue
 			}
-			ft := new(codegraphpb.FileElementTable)
-			if err = store.UnmarshalValue(fileTable, ft); err != nil {
-				errs = append(errs, err)
-				continue
-			}
 			results = append(results, ft)
 		}
 	}
@@ -622,6 +784,7 @@ func (idx *Indexer) querySymbols(ctx context.Context, workspacePath string, file
 	idx.logger.Info("start to query workspace %s file %s symbols: %v", workspacePath, filePath, symbolNames)
 
 	projects := idx.workspaceReader.FindProjects(ctx, workspacePath, false, workspace.DefaultVisitPattern)
+	idx.recordQueryProjects(ctx, projects...)
 	if len(projects) == 0 {
 		return nil, fmt.Errorf("no project found in workspace %s", workspacePath)
 	}
@@ -653,7 +816,7 @@ func (idx *Indexer) querySymbols(ctx context.Context, workspacePath string, file
 
 		if symbolDef != nil {
 			sd := new(codegraphpb.SymbolOccurrence)
-			if err = store.UnmarshalValue(symbolDef, sd); err != nil {
+			if err = store.UnmarshalSymbolOccurrence(ctx, idx.storage, targetProjectUuid, symbolDef, sd); err != nil {
 				errs = append(errs, err)
 				continue
 			}
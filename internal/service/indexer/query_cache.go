@@ -0,0 +1,276 @@
+package indexer
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/cache"
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/workspace"
+	"context"
+	"crypto/sha256"
+	"encoding/hex"
+	"errors"
+	"slices"
+	"strconv"
+	"sync"
+	"sync/atomic"
+)
+
+// 查询结果缓存：定义、引用、调用图的结果按请求内容缓存。条目记录计算时解析到的项目及其索引版本号，
+// 项目写入索引后版本号递增，条目在下次访问时失效。并发的相同请求只计算一次。
+// 缓存按条目数和估算的字节数淘汰，超过 queryCacheMaxEntryBytes 的结果不缓存。
+// 缓存的结果只读，返回给调用方的是副本
+
+const (
+	DefaultQueryCacheCapacity = 1024
+	DefaultQueryCacheBytes    = 32 * 1024 * 1024 // 32MB
+	// queryCacheMaxEntryBytes 单个结果估算超过该大小时不缓存，避免少数大结果挤掉其他条目
+	queryCacheMaxEntryBytes = 1024 * 1024
+	// queryNodeOverhead 结果中每个节点结构体、指针和切片头的估算开销
+	queryNodeOverhead = 128
+)
+
+type queryDep struct {
+	projectUuid string
+	generation  uint64
+}
+
+type queryCacheEntry struct {
+	value any
+	deps  []queryDep
+	size  int64
+}
+
+// queryCall 正在计算的请求，相同请求等待其结果
+type queryCall struct {
+	done  chan struct{}
+	value any
+	err   error
+}
+
+// queryDeps 计算期间解析到的项目，通过上下文传递
+type queryDeps struct {
+	mu   sync.Mutex
+	deps []queryDep
+}
+
+type queryDepsKey struct{}
+
+// queryCache nil 表示不缓存
+type queryCache struct {
+	entries     *cache.ShardedLRUCache[*queryCacheEntry]
+	generations sync.Map // projectUuid -> *atomic.Uint64
+	mu          sync.Mutex
+	calls       map[string]*queryCall
+}
+
+func newQueryCache(capacity int, maxBytes int64) *queryCache {
+	if capacity <= 0 {
+		capacity = DefaultQueryCacheCapacity
+	}
+	if maxBytes <= 0 {
+		maxBytes = DefaultQueryCacheBytes
+	}
+	return &queryCache{
+		entries: cache.NewShardedLRUCacheWithOptions[*queryCacheEntry](0, capacity,
+			cache.ShardedOptions[*queryCacheEntry]{
+				MaxBytes: maxBytes,
+				SizeOf: func(key string, entry *queryCacheEntry) int64 {
+					return int64(len(key)) + entry.size
+				},
+			}),
+		calls: make(map[string]*queryCall),
+	}
+}
+
+func (c *queryCache) generation(projectUuid string) *atomic.Uint64 {
+	if g, ok := c.generations.Load(projectUuid); ok {
+		return g.(*atomic.Uint64)
+	}
+	g, _ := c.generations.LoadOrStore(projectUuid, new(atomic.Uint64))
+	return g.(*atomic.Uint64)
+}
+
+// bump 递增项目的索引版本号，在写入存储之后调用
+func (c *queryCache) bump(projectUuids ...string) {
+	if c == nil {
+		return
+	}
+	for _, projectUuid := range projectUuids {
+		c.generation(projectUuid).Add(1)
+	}
+}
+
+func (c *queryCache) valid(entry *queryCacheEntry) bool {
+	for _, dep := range entry.deps {
+		if c.generation(dep.projectUuid).Load() != dep.generation {
+			return false
+		}
+	}
+	return true
+}
+
+// invalidateIndex 写入索引后调用，使文件元素表缓存和项目的查询结果失效
+func (idx *Indexer) invalidateIndex(projectUuid string, paths ...string) {
+	idx.fileTables.invalidate(projectUuid, paths...)
+	idx.queryCache.bump(projectUuid)
+}
+
+// invalidateProjectIndex 项目的索引整体替换或删除后调用
+func (idx *Indexer) invalidateProjectIndex(projectUuid string) {
+	idx.fileTables.invalidateProject(projectUuid)
+	idx.queryCache.bump(projectUuid)
+}
+
+// recordQueryProjects 查询解析到项目后、读取索引前调用，记录项目当前的版本号
+func (idx *Indexer) recordQueryProjects(ctx context.Context, projects ...*workspace.Project) {
+	deps, ok := ctx.Value(queryDepsKey{}).(*queryDeps)
+	if !ok || idx.queryCache == nil {
+		return
+	}
+	deps.mu.Lock()
+	defer deps.mu.Unlock()
+	for _, p := range projects {
+		deps.deps = append(deps.deps, queryDep{projectUuid: p.Uuid,
+			generation: idx.queryCache.generation(p.Uuid).Load()})
+	}
+}
+
+// cachedQuery 版本号未变时返回缓存的结果，否则计算。compute 返回的 cacheable 为 false 时（如超时返回的部分结果）
+// 不缓存；没有解析到项目的结果、size 估算超过 queryCacheMaxEntryBytes 的结果也不缓存
+func cachedQuery[T any](ctx context.Context, c *queryCache, query string, key string, clone func(T) T,
+	size func(T) int64, compute func(ctx context.Context) (T, bool, error)) (T, error) {
+	if c == nil {
+		value, _, err := compute(ctx)
+		return value, err
+	}
+	for {
+		if entry, ok := c.entries.Get(key); ok && c.valid(entry) {
+			queryCacheTotal.WithLabelValues(query, "hit").Inc()
+			return clone(entry.value.(T)), nil
+		}
+		c.mu.Lock()
+		if call, ok := c.calls[key]; ok {
+			c.mu.Unlock()
+			select {
+			case <-call.done:
+			case <-ctx.Done():
+				var zero T
+				return zero, ctx.Err()
+			}
+			if call.err == nil {
+				queryCacheTotal.WithLabelValues(query, "shared").Inc()
+				return clone(call.value.(T)), nil
+			}
+			// 发起方被取消时自己重新计算
+			if isContextError(call.err) && ctx.Err() == nil {
+				continue
+			}
+			var zero T
+			return zero, call.err
+		}
+		call := &queryCall{done: make(chan struct{})}
+		c.calls[key] = call
+		c.mu.Unlock()
+		queryCacheTotal.WithLabelValues(query, "miss").Inc()
+		return runQueryCall(ctx, c, key, call, clone, size, compute)
+	}
+}
+
+func runQueryCall[T any](ctx context.Context, c *queryCache, key string, call *queryCall, clone func(T) T,
+	size func(T) int64, compute func(ctx context.Context) (T, bool, error)) (T, error) {
+	call.err = errors.New("query aborted")
+	defer func() {
+		c.mu.Lock()
+		delete(c.calls, key)
+		c.mu.Unlock()
+		close(call.done)
+	}()
+	deps := &queryDeps{}
+	value, cacheable, err := compute(context.WithValue(ctx, queryDepsKey{}, deps))
+	call.value, call.err = value, err
+	if err != nil {
+		return value, err
+	}
+	if cacheable && len(deps.deps) > 0 {
+		if n := size(value); n <= queryCacheMaxEntryBytes {
+			c.entries.Put(key, &queryCacheEntry{value: value, deps: deps.deps, size: n})
+		}
+	}
+	return clone(value), nil
+}
+
+func isContextError(err error) bool {
+	return errors.Is(err, context.Canceled) || errors.Is(err, context.DeadlineExceeded)
+}
+
+// queryCacheKey 请求各字段按顺序拼接后取哈希，代码片段可能较大
+func queryCacheKey(query string, fields ...string) string {
+	h := sha256.New()
+	for _, f := range fields {
+		h.Write([]byte(strconv.Itoa(len(f))))
+		h.Write([]byte{0})
+		h.Write([]byte(f))
+	}
+	return query + "\x00" + hex.EncodeToString(h.Sum(nil))
+}
+
+func cloneRelationNodes(nodes []*types.RelationNode) []*types.RelationNode {
+	if nodes == nil {
+		return nil
+	}
+	cloned := make([]*types.RelationNode, len(nodes))
+	for i, n := range nodes {
+		if n == nil {
+			continue
+		}
+		c := *n
+		if n.Position != nil {
+			position := *n.Position
+			c.Position = &position
+		}
+		c.Children = cloneRelationNodes(n.Children)
+		cloned[i] = &c
+	}
+	return cloned
+}
+
+// relationNodesSize 估算结果占用的字节数
+func relationNodesSize(nodes []*types.RelationNode) int64 {
+	var size int64
+	for _, n := range nodes {
+		if n == nil {
+			continue
+		}
+		size += queryNodeOverhead + int64(len(n.FilePath)+len(n.SymbolName)+len(n.Content)+len(n.NodeType)) +
+			relationNodesSize(n.Children)
+	}
+	return size
+}
+
+func definitionsSize(definitions []*types.Definition) int64 {
+	var size int64
+	for _, d := range definitions {
+		if d == nil {
+			continue
+		}
+		size += queryNodeOverhead + int64(len(d.Name)+len(d.Type)+len(d.Path)+4*len(d.Range)+len(d.Content))
+	}
+	return size
+}
+
+func cloneDefinitions(definitions []*types.Definition) []*types.Definition {
+	if definitions == nil {
+		return nil
+	}
+	cloned := make([]*types.Definition, len(definitions))
+	for i, d := range definitions {
+		if d == nil {
+			continue
+		}
+		c := *d
+		c.Range = slices.Clone(d.Range)
+		c.Content = bytes.Clone(d.Content)
+		cloned[i] = &c
+	}
+	return cloned
+}
@@ -0,0 +1,159 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/workspace"
+	"context"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestCachedQuery(t *testing.T) {
+	idx := &Indexer{queryCache: newQueryCache(0, 0)}
+	project := &workspace.Project{Uuid: "p"}
+	var computed atomic.Int32
+	query := func(ctx context.Context) ([]*types.RelationNode, error) {
+		return cachedQuery(ctx, idx.queryCache, queryReferences, queryCacheKey(queryReferences, "a"), cloneRelationNodes,
+			relationNodesSize,
+			func(ctx context.Context) ([]*types.RelationNode, bool, error) {
+				computed.Add(1)
+				idx.recordQueryProjects(ctx, project)
+				return []*types.RelationNode{{SymbolName: "Foo", Position: &types.Position{StartLine: 1},
+					Children: []*types.RelationNode{{SymbolName: "Bar"}}}}, true, nil
+			})
+	}
+
+	ctx := context.Background()
+	nodes, err := query(ctx)
+	require.NoError(t, err)
+	// 调用方修改返回的结果不影响缓存
+	nodes[0].Content = "content"
+	nodes[0].Position.StartLine = 9
+	nodes[0].Children[0].SymbolName = "Baz"
+	nodes, err = query(ctx)
+	require.NoError(t, err)
+	assert.Equal(t, int32(1), computed.Load())
+	assert.Empty(t, nodes[0].Content)
+	assert.Equal(t, 1, nodes[0].Position.StartLine)
+	assert.Equal(t, "Bar", nodes[0].Children[0].SymbolName)
+
+	// 写入索引后重新计算
+	idx.invalidateIndex("other")
+	_, err = query(ctx)
+	require.NoError(t, err)
+	assert.Equal(t, int32(1), computed.Load())
+	idx.invalidateIndex("p", "/a.go")
+	_, err = query(ctx)
+	require.NoError(t, err)
+	assert.Equal(t, int32(2), computed.Load())
+}
+
+func TestCachedQuery_SingleFlight(t *testing.T) {
+	c := newQueryCache(0, 0)
+	idx := &Indexer{queryCache: c}
+	var computed atomic.Int32
+	release := make(chan struct{})
+	compute := func(ctx context.Context) ([]*types.Definition, bool, error) {
+		computed.Add(1)
+		idx.recordQueryProjects(ctx, &workspace.Project{Uuid: "p"})
+		<-release
+		// 超时等不可缓存的结果只共享给同时到达的请求
+		return []*types.Definition{{Name: "Foo", Range: []int32{1, 2}}}, false, nil
+	}
+	key := queryCacheKey(queryDefinitions, "snippet")
+
+	var wg sync.WaitGroup
+	results := make([][]*types.Definition, 8)
+	for i := range results {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			definitions, err := cachedQuery(context.Background(), c, queryDefinitions, key, cloneDefinitions,
+				definitionsSize, compute)
+			assert.NoError(t, err)
+			results[i] = definitions
+		}(i)
+	}
+	assert.Eventually(t, func() bool {
+		c.mu.Lock()
+		defer c.mu.Unlock()
+		return len(c.calls) == 1
+	}, time.Second, time.Millisecond)
+	// 其余请求到达后等待同一次计算
+	time.Sleep(50 * time.Millisecond)
+	close(release)
+	wg.Wait()
+
+	assert.Equal(t, int32(1), computed.Load())
+	for _, definitions := range results {
+		require.Len(t, definitions, 1)
+		assert.Equal(t, "Foo", definitions[0].Name)
+	}
+	assert.NotSame(t, results[0][0], results[1][0])
+	assert.Zero(t, c.entries.Len())
+
+	// 发起方取消时等待的请求自己重新计算
+	cancelCtx, cancel := context.WithCancel(context.Background())
+	started := make(chan struct{})
+	leaderDone := make(chan error, 1)
+	go func() {
+		_, err := cachedQuery(cancelCtx, c, queryDefinitions, key, cloneDefinitions, definitionsSize,
+			func(ctx context.Context) ([]*types.Definition, bool, error) {
+				close(started)
+				<-ctx.Done()
+				return nil, false, ctx.Err()
+			})
+		leaderDone <- err
+	}()
+	<-started
+	followerDone := make(chan []*types.Definition, 1)
+	go func() {
+		definitions, err := cachedQuery(context.Background(), c, queryDefinitions, key, cloneDefinitions, definitionsSize,
+			func(ctx context.Context) ([]*types.Definition, bool, error) {
+				return []*types.Definition{{Name: "Retry"}}, true, nil
+			})
+		assert.NoError(t, err)
+		followerDone <- definitions
+	}()
+	time.Sleep(10 * time.Millisecond)
+	cancel()
+	assert.ErrorIs(t, <-leaderDone, context.Canceled)
+	definitions := <-followerDone
+	require.Len(t, definitions, 1)
+	assert.Equal(t, "Retry", definitions[0].Name)
+	// 没有解析到项目的结果不缓存
+	assert.Zero(t, c.entries.Len())
+}
+
+func TestCachedQuery_SkipsLargeResults(t *testing.T) {
+	c := newQueryCache(0, 0)
+	idx := &Indexer{queryCache: c}
+	var computed atomic.Int32
+	query := func(content []byte) error {
+		key := queryCacheKey(queryDefinitions, string(content[:1]))
+		_, err := cachedQuery(context.Background(), c, queryDefinitions, key, cloneDefinitions, definitionsSize,
+			func(ctx context.Context) ([]*types.Definition, bool, error) {
+				computed.Add(1)
+				idx.recordQueryProjects(ctx, &workspace.Project{Uuid: "p"})
+				return []*types.Definition{{Name: "Foo", Content: content}}, true, nil
+			})
+		return err
+	}
+
+	large := make([]byte, queryCacheMaxEntryBytes)
+	large[0] = 'l'
+	require.NoError(t, query(large))
+	require.NoError(t, query(large))
+	assert.Equal(t, int32(2), computed.Load())
+	assert.Zero(t, c.entries.Len())
+
+	require.NoError(t, query([]byte("small")))
+	require.NoError(t, query([]byte("small")))
+	assert.Equal(t, int32(3), computed.Load())
+	assert.Equal(t, 1, c.entries.Len())
+}
@@ -0,0 +1,583 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/store"
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/utils"
+	"codebase-indexer/pkg/codegraph/workspace"
+	"context"
+	"errors"
+	"fmt"
+	"sort"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"google.golang.org/protobuf/proto"
+	"google.golang.org/protobuf/types/known/wrapperspb"
+)
+
+// 延迟解析：解析阶段按文件处理，先使用后定义、跨文件的符号无法确定定义。一次索引的所有批次写入后，
+// 根据已存储的符号表和导入，并发地把 C/C++、Java、Go 文件中的调用、引用解析到定义所在的文件，结果按
+// 符号名+引用方文件 持久化，查询时直接读取，不再逐次按名字匹配、按导入过滤。
+// 文件写入前删除其解析结果并标记为待解析；定义所在文件集合变化的符号名，引用它的文件一并标记。
+// 没有解析结果的引用（待解析、其他语言）在查询时回退到按名字匹配
+const (
+	// resolvedIndexVersion 解析结果的格式版本，格式或解析规则变化时递增，旧版本在下次索引项目时整体重新解析
+	resolvedIndexVersion = 1
+	// resolvedIndexVersionKey 解析结果版本号的元数据key
+	resolvedIndexVersionKey = "version"
+	// resolveChunkSize 每轮并发解析的文件数，轮与轮之间检查取消和让出
+	resolveChunkSize = 200
+	// resolvedImportScore 定义经导入确认时的匹配分数，与 CalculateSymbolMatchScore 按导入匹配的分数一致
+	resolvedImportScore = 50
+)
+
+// resolvableLanguages 做延迟解析的语言
+var resolvableLanguages = map[lang.Language]struct{}{
+	lang.C:    {},
+	lang.CPP:  {},
+	lang.Java: {},
+	lang.Go:   {},
+}
+
+func isResolvableLanguage(language lang.Language) bool {
+	_, ok := resolvableLanguages[language]
+	return ok
+}
+
+func isResolvableFile(filePath string) bool {
+	language, err := lang.InferLanguage(filePath)
+	return err == nil && isResolvableLanguage(language)
+}
+
+// resolvedNames 文件中需要解析的调用、引用的符号名，去重
+func resolvedNames(elementTable *codegraphpb.FileElementTable) []string {
+	seen := make(map[string]struct{})
+	var names []string
+	for _, element := range elementTable.Elements {
+		if element.IsDefinition || element.Name == types.EmptyString ||
+			(element.ElementType != codegraphpb.ElementType_CALL &&
+				element.ElementType != codegraphpb.ElementType_REFERENCE) {
+			continue
+		}
+		if _, ok := seen[element.Name]; ok {
+			continue
+		}
+		seen[element.Name] = struct{}{}
+		names = append(names, element.Name)
+	}
+	return names
+}
+
+func definitionNameSet(elementTable *codegraphpb.FileElementTable) map[string]struct{} {
+	names := make(map[string]struct{})
+	if elementTable == nil {
+		return names
+	}
+	for _, element := range elementTable.Elements {
+		if element.IsDefinition && element.Name != types.EmptyString {
+			names[element.Name] = struct{}{}
+		}
+	}
+	return names
+}
+
+// changedDefinitionNames 只在新旧元素表之一中定义的符号名，这些符号的定义所在文件集合发生了变化。
+// 新增文件 oldTable 为 nil，删除文件 newTable 为 nil
+func changedDefinitionNames(oldTable, newTable *codegraphpb.FileElementTable) []string {
+	oldNames, newNames := definitionNameSet(oldTable), definitionNameSet(newTable)
+	var changed []string
+	for name := range oldNames {
+		if _, ok := newNames[name]; !ok {
+			changed = append(changed, name)
+		}
+	}
+	for name := range newNames {
+		if _, ok := oldNames[name]; !ok {
+			changed = append(changed, name)
+		}
+	}
+	sort.Strings(changed)
+	return changed
+}
+
+// buildResolvedSymbols 根据文件的导入过滤符号的定义，生成文件的解析结果。没有定义或定义都未经导入确认的符号
+// 也记录（出现为空），之后新增定义时能按符号名找到引用方文件，查询时据此区分 未解析 和 无法确认
+func buildResolvedSymbols(filter func(filePath string, imports []*codegraphpb.Import,
+	occurrences []*codegraphpb.Occurrence) []*codegraphpb.Occurrence,
+	elementTable *codegraphpb.FileElementTable, occurrences map[string]*codegraphpb.SymbolOccurrence) []workspace.ResolvedSymbol {
+	var resolved []workspace.ResolvedSymbol
+	for _, name := range resolvedNames(elementTable) {
+		symbol := &codegraphpb.SymbolOccurrence{Name: name, Language: elementTable.Language}
+		occurrence, ok := occurrences[name]
+		if !ok || len(occurrence.Occurrences) == 0 {
+			resolved = append(resolved, workspace.ResolvedSymbol{FilePath: elementTable.Path, Symbol: symbol})
+			continue
+		}
+		seen := make(map[string]struct{})
+		for _, def := range filter(elementTable.Path, elementTable.Imports, occurrence.Occurrences) {
+			if _, ok := seen[def.Path]; ok {
+				continue
+			}
+			seen[def.Path] = struct{}{}
+			symbol.Occurrences = append(symbol.Occurrences, &codegraphpb.Occurrence{Path: def.Path, ElementType: def.ElementType})
+		}
+		resolved = append(resolved, workspace.ResolvedSymbol{FilePath: elementTable.Path, Symbol: symbol})
+	}
+	return resolved
+}
+
+// resolvedIndexReady 项目是否已经完成过当前版本的整体解析
+func (idx *Indexer) resolvedIndexReady(ctx context.Context, projectUuid string) bool {
+	bytes, err := idx.storage.Get(ctx, projectUuid, store.ResolvedMetaKey{Name: resolvedIndexVersionKey})
+	if err != nil {
+		return false
+	}
+	var version wrapperspb.Int32Value
+	return store.UnmarshalValue(bytes, &version) == nil && version.Value == resolvedIndexVersion
+}
+
+// resolvedIndexComplete 项目的解析结果是否完整：版本最新且没有待解析的文件
+func (idx *Indexer) resolvedIndexComplete(ctx context.Context, projectUuid string) bool {
+	if !idx.resolvedIndexReady(ctx, projectUuid) {
+		return false
+	}
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.ResolvedPendingKeyPrefix)
+	if iter == nil {
+		return false
+	}
+	defer iter.Close()
+	return !iter.Next() && iter.Error() == nil
+}
+
+// resolvePendingPaths 待解析的文件
+type resolvePendingPaths []string
+
+func (l resolvePendingPaths) Len() int                  { return len(l) }
+func (l resolvePendingPaths) Value(i int) proto.Message { return &wrapperspb.BoolValue{Value: true} }
+func (l resolvePendingPaths) Key(i int) store.Key       { return store.ResolvePendingKey{FilePath: l[i]} }
+
+// markResolveStale 在新元素表覆盖旧元素表之前调用：删除这些文件的解析结果，以及引用了定义变化的符号的文件的解析结果，
+// 并把它们标记为待解析。oldTables 为文件已存储的元素表，newTables 为 nil 表示删除文件。项目尚未整体解析且没有
+// 整体解析进行中时不做处理。返回时持有项目的解析锁，调用方写入元素表后调用返回的函数释放，期间解析不会读到旧表后
+// 清除新的标记。获取锁失败时返回的函数为空操作
+func (idx *Indexer) markResolveStale(ctx context.Context, projectUuid string,
+	oldTables, newTables []*codegraphpb.FileElementTable) (func(), error) {
+	nop := func() {}
+	if len(oldTables) == 0 && len(newTables) == 0 {
+		return nop, nil
+	}
+	unlock, err := idx.lockResolve(ctx, projectUuid)
+	if err != nil {
+		return nop, err
+	}
+	if !idx.resolvedIndexReady(ctx, projectUuid) && !idx.resolveState(projectUuid).running.Load() {
+		return unlock, nil
+	}
+	return unlock, idx.markResolveStaleLocked(ctx, projectUuid, oldTables, newTables)
+}
+
+func (idx *Indexer) markResolveStaleLocked(ctx context.Context, projectUuid string,
+	oldTables, newTables []*codegraphpb.FileElementTable) error {
+	var deletes []store.Key
+	pending := make(map[string]struct{})
+	removed := make(map[string]struct{}, len(oldTables))
+	oldByPath := make(map[string]*codegraphpb.FileElementTable, len(oldTables))
+	for _, old := range oldTables {
+		oldByPath[old.Path] = old
+		removed[old.Path] = struct{}{}
+		if !isResolvableLanguage(lang.Language(old.Language)) {
+			continue
+		}
+		for _, name := range resolvedNames(old) {
+			deletes = append(deletes, store.ResolvedSymbolKey{SymbolName: name, FilePath: old.Path})
+		}
+	}
+
+	changed := make(map[string]struct{})
+	for _, ft := range newTables {
+		delete(removed, ft.Path)
+		if isResolvableLanguage(lang.Language(ft.Language)) {
+			pending[ft.Path] = struct{}{}
+		}
+		for _, name := range changedDefinitionNames(oldByPath[ft.Path], ft) {
+			changed[name] = struct{}{}
+		}
+	}
+	for path := range removed {
+		for _, name := range changedDefinitionNames(oldByPath[path], nil) {
+			changed[name] = struct{}{}
+		}
+	}
+
+	var errs []error
+	for name := range changed {
+		prefix := store.ResolvedSymbolKeyPrefix(name)
+		iter := idx.storage.IterPrefix(ctx, projectUuid, prefix)
+		if iter == nil {
+			errs = append(errs, fmt.Errorf("failed to create iterator for project %s", projectUuid))
+			continue
+		}
+		for iter.Next() {
+			filePath := strings.TrimPrefix(iter.Key(), prefix)
+			deletes = append(deletes, store.ResolvedSymbolKey{SymbolName: name, FilePath: filePath})
+			if _, ok := removed[filePath]; !ok {
+				pending[filePath] = struct{}{}
+			}
+		}
+		if err := iter.Error(); err != nil {
+			errs = append(errs, err)
+		}
+		iter.Close()
+	}
+
+	for _, key := range deletes {
+		if err := idx.storage.Delete(ctx, projectUuid, key); err != nil {
+			errs = append(errs, err)
+		}
+	}
+	paths := make(resolvePendingPaths, 0, len(pending))
+	for path := range pending {
+		paths = append(paths, path)
+	}
+	if len(paths) > 0 {
+		if err := idx.storage.BatchSave(ctx, projectUuid, paths); err != nil {
+			errs = append(errs, err)
+		}
+	}
+	for path := range removed {
+		if err := idx.storage.Delete(ctx, projectUuid, store.ResolvePendingKey{FilePath: path}); err != nil {
+			errs = append(errs, err)
+		}
+	}
+	return errors.Join(errs...)
+}
+
+// resolveState 项目的延迟解析状态。lock 按轮持有，让出期间不持有，其他项目的解析互不等待
+type resolveState struct {
+	lock    chan struct{} // 容量为1，等待时响应取消
+	running atomic.Bool   // 整体解析进行中
+}
+
+func (idx *Indexer) resolveState(projectUuid string) *resolveState {
+	if state, ok := idx.resolveStates.Load(projectUuid); ok {
+		return state.(*resolveState)
+	}
+	state, _ := idx.resolveStates.LoadOrStore(projectUuid, &resolveState{lock: make(chan struct{}, 1)})
+	return state.(*resolveState)
+}
+
+// lockResolve 获取项目的解析锁，ctx 取消时放弃等待
+func (idx *Indexer) lockResolve(ctx context.Context, projectUuid string) (func(), error) {
+	state := idx.resolveState(projectUuid)
+	select {
+	case state.lock <- struct{}{}:
+		return func() { <-state.lock }, nil
+	case <-ctx.Done():
+		return nil, ctx.Err()
+	}
+}
+
+// beginResolveChunk 开始一轮解析：有更高优先级的任务等待时先让出，再检查取消并获取项目的解析锁
+func (idx *Indexer) beginResolveChunk(ctx context.Context, projectUuid string) (func(), error) {
+	if yielder := yielderFromContext(ctx); yielder != nil && yielder.Preempted() {
+		if err := yielder.Yield(ctx); err != nil {
+			return nil, err
+		}
+	}
+	if err := ctx.Err(); err != nil {
+		return nil, err
+	}
+	return idx.lockResolve(ctx, projectUuid)
+}
+
+// resolveProject 解析项目。full 为 true 且解析结果版本不是最新时整体重新解析，否则只解析待解析的文件。
+// 同一项目同时只有一个整体解析。解析失败只记录日志，查询回退到按名字匹配
+func (idx *Indexer) resolveProject(ctx context.Context, projectUuid string, full bool) {
+	ready := idx.resolvedIndexReady(ctx, projectUuid)
+	if !ready && !full {
+		return
+	}
+	if !ready {
+		// 持有解析锁设置标记：之后开始的元素表写入都会标记待解析，整体解析结束后一并处理
+		state := idx.resolveState(projectUuid)
+		unlock, err := idx.lockResolve(ctx, projectUuid)
+		if err != nil {
+			return
+		}
+		started := state.running.CompareAndSwap(false, true)
+		unlock()
+		if !started {
+			idx.logger.Debug("project %s full resolve is already running", projectUuid)
+			return
+		}
+		defer state.running.Store(false)
+	}
+	start := time.Now()
+	var files, symbols int
+	var err error
+	if ready {
+		files, symbols, err = idx.resolvePending(ctx, projectUuid)
+	} else if files, symbols, err = idx.resolveAll(ctx, projectUuid); err == nil {
+		// 整体解析期间写入的文件
+		var n, m int
+		n, m, err = idx.resolvePending(ctx, projectUuid)
+		files += n
+		symbols += m
+	}
+	if files > 0 {
+		idx.queryCache.bump(projectUuid)
+	}
+	if err != nil {
+		idx.logger.Error("project %s resolve err: %v", projectUuid, utils.TruncateError(err))
+		return
+	}
+	if files > 0 || !ready {
+		idx.logger.Info("project %s resolve end, cost %d ms, full %v, files %d, symbols %d", projectUuid,
+			time.Since(start).Milliseconds(), !ready, files, symbols)
+	}
+}
+
+// resolveAll 删除已有的解析结果，解析所有文件，成功后写入版本号
+func (idx *Indexer) resolveAll(ctx context.Context, projectUuid string) (int, int, error) {
+	if err := idx.storage.DeleteAllWithPrefix(ctx, projectUuid, store.ResolvedKeySystemPrefix); err != nil {
+		return 0, 0, fmt.Errorf("delete outdated resolved symbols failed: %w", err)
+	}
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.PathKeySystemPrefix)
+	if iter == nil {
+		return 0, 0, fmt.Errorf("failed to create iterator for project %s", projectUuid)
+	}
+	defer iter.Close()
+
+	var files, symbols int
+	chunk := make([]*codegraphpb.FileElementTable, 0, resolveChunkSize)
+	flush := func() error {
+		if len(chunk) == 0 {
+			return nil
+		}
+		unlock, err := idx.beginResolveChunk(ctx, projectUuid)
+		if err != nil {
+			return err
+		}
+		defer unlock()
+		n, err := idx.resolveTables(ctx, projectUuid, chunk)
+		files += len(chunk)
+		symbols += n
+		chunk = chunk[:0]
+		return err
+	}
+	for iter.Next() {
+		pathKey, err := store.ToElementPathKey(iter.Key())
+		if err != nil || !isResolvableLanguage(pathKey.Language) {
+			continue
+		}
+		elementTable := new(codegraphpb.FileElementTable)
+		if err := store.UnmarshalValue(iter.Value(), elementTable); err != nil {
+			idx.logger.Error("failed to unmarshal key %s element_table value, err: %v", iter.Key(), err)
+			continue
+		}
+		chunk = append(chunk, elementTable)
+		if len(chunk) >= resolveChunkSize {
+			if err := flush(); err != nil {
+				return files, symbols, err
+			}
+		}
+	}
+	if err := flush(); err != nil {
+		return files, symbols, err
+	}
+	if err := iter.Error(); err != nil {
+		// 不写入版本号，下次索引时重新解析
+		return files, symbols, err
+	}
+	if err := idx.storage.Put(ctx, projectUuid, &store.Entry{Key: store.ResolvedMetaKey{Name: resolvedIndexVersionKey},
+		Value: wrapperspb.Int32(resolvedIndexVersion)}); err != nil {
+		return files, symbols, fmt.Errorf("save resolved index version failed: %w", err)
+	}
+	return files, symbols, nil
+}
+
+// resolvePending 解析待解析的文件，文件已删除时只清除标记
+func (idx *Indexer) resolvePending(ctx context.Context, projectUuid string) (int, int, error) {
+	iter := idx.storage.IterPrefix(ctx, projectUuid, store.ResolvedPendingKeyPrefix)
+	if iter == nil {
+		return 0, 0, fmt.Errorf("failed to create iterator for project %s", projectUuid)
+	}
+	var paths []string
+	for iter.Next() {
+		paths = append(paths, strings.TrimPrefix(iter.Key(), store.ResolvedPendingKeyPrefix))
+	}
+	err := iter.Error()
+	iter.Close()
+	if err != nil {
+		return 0, 0, err
+	}
+
+	var files, symbols int
+	for start := 0; start < len(paths); start += resolveChunkSize {
+		n, m, err := idx.resolvePendingChunk(ctx, projectUuid, paths[start:min(start+resolveChunkSize, len(paths))])
+		files += n
+		symbols += m
+		if err != nil {
+			return files, symbols, err
+		}
+	}
+	return files, symbols, nil
+}
+
+// resolvePendingChunk 持有解析锁解析一轮待解析的文件并清除其标记
+func (idx *Indexer) resolvePendingChunk(ctx context.Context, projectUuid string, paths []string) (int, int, error) {
+	unlock, err := idx.beginResolveChunk(ctx, projectUuid)
+	if err != nil {
+		return 0, 0, err
+	}
+	defer unlock()
+	chunk := make([]*codegraphpb.FileElementTable, 0, len(paths))
+	for _, path := range paths {
+		elementTable, err := idx.getFileElementTableByPath(ctx, projectUuid, path)
+		if err != nil {
+			continue
+		}
+		chunk = append(chunk, elementTable)
+	}
+	symbols, err := idx.resolveTables(ctx, projectUuid, chunk)
+	if err != nil {
+		return len(chunk), symbols, err
+	}
+	var errs []error
+	for _, path := range paths {
+		if err := idx.storage.Delete(ctx, projectUuid, store.ResolvePendingKey{FilePath: path}); err != nil {
+			errs = append(errs, err)
+		}
+	}
+	return len(chunk), symbols, errors.Join(errs...)
+}
+
+// resolveTables 并发解析一轮文件，返回写入的解析结果数。调用方通过 beginResolveChunk 持有解析锁
+func (idx *Indexer) resolveTables(ctx context.Context, projectUuid string,
+	elementTables []*codegraphpb.FileElementTable) (int, error) {
+	if len(elementTables) == 0 {
+		return 0, nil
+	}
+
+	var (
+		wg       sync.WaitGroup
+		mu       sync.Mutex
+		errs     []error
+		resolved atomic.Int64
+	)
+	tables := make(chan *codegraphpb.FileElementTable)
+	for i := 0; i < utils.Max(idx.config.MaxConcurrency, 1); i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for elementTable := range tables {
+				n, err := idx.resolveTable(ctx, projectUuid, elementTable)
+				resolved.Add(int64(n))
+				if err != nil {
+					mu.Lock()
+					errs = append(errs, fmt.Errorf("resolve file %s failed: %w", elementTable.Path, err))
+					mu.Unlock()
+				}
+			}
+		}()
+	}
+	for _, elementTable := range elementTables {
+		tables <- elementTable
+	}
+	close(tables)
+	wg.Wait()
+	return int(resolved.Load()), errors.Join(errs...)
+}
+
+// resolveTable 解析单个文件并写入结果
+func (idx *Indexer) resolveTable(ctx context.Context, projectUuid string, elementTable *codegraphpb.FileElementTable) (int, error) {
+	occurrences, err := idx.getSymbolOccurrencesByNames(ctx, projectUuid, lang.Language(elementTable.Language),
+		resolvedNames(elementTable))
+	if err != nil {
+		return 0, err
+	}
+	resolved := buildResolvedSymbols(idx.analyzer.FilterByImports, elementTable, occurrences)
+	if len(resolved) == 0 {
+		return 0, nil
+	}
+	return len(resolved), idx.storage.BatchSave(ctx, projectUuid, workspace.ResolvedSymbols(resolved))
+}
+
+// getResolvedSymbolPaths 批量读取解析结果，返回与 keys 一一对应的定义所在文件集合，没有解析结果的为 nil
+func (idx *Indexer) getResolvedSymbolPaths(ctx context.Context, projectUuid string,
+	keys []store.ResolvedSymbolKey) ([]map[string]struct{}, error) {
+	if len(keys) == 0 {
+		return nil, nil
+	}
+	storeKeys := make([]store.Key, len(keys))
+	for i, key := range keys {
+		storeKeys[i] = key
+	}
+	values, err := idx.storage.MultiGet(ctx, projectUuid, storeKeys)
+	if err != nil {
+		return nil, err
+	}
+	paths := make([]map[string]struct{}, len(keys))
+	for i, value := range values {
+		if value == nil {
+			continue
+		}
+		// 与符号表一样按路径字典存储文件ID，需要还原路径
+		var symbol codegraphpb.SymbolOccurrence
+		if err := store.UnmarshalSymbolOccurrence(ctx, idx.storage, projectUuid, value, &symbol); err != nil {
+			return nil, fmt.Errorf("failed to unmarshal resolved symbol %s, err: %v", keys[i].SymbolName, err)
+		}
+		paths[i] = make(map[string]struct{}, len(symbol.Occurrences))
+		for _, occurrence := range symbol.Occurrences {
+			paths[i][occurrence.Path] = struct{}{}
+		}
+	}
+	return paths, nil
+}
+
+// getResolvedReferenceFiles 引用了这些符号的文件，按路径排序。只在解析结果完整时可用，否则返回 false
+func (idx *Indexer) getResolvedReferenceFiles(ctx context.Context, projectUuid string, language lang.Language,
+	symbolNames []string) ([]string, bool) {
+	if !isResolvableLanguage(language) || !idx.resolvedIndexComplete(ctx, projectUuid) {
+		return nil, false
+	}
+	seen := make(map[string]struct{})
+	var files []string
+	for _, name := range symbolNames {
+		prefix := store.ResolvedSymbolKeyPrefix(name)
+		iter := idx.storage.IterPrefix(ctx, projectUuid, prefix)
+		if iter == nil {
+			return nil, false
+		}
+		for iter.Next() {
+			filePath := strings.TrimPrefix(iter.Key(), prefix)
+			if _, ok := seen[filePath]; ok {
+				continue
+			}
+			seen[filePath] = struct{}{}
+			files = append(files, filePath)
+		}
+		err := iter.Error()
+		iter.Close()
+		if err != nil {
+			return nil, false
+		}
+	}
+	sort.Strings(files)
+	return files, true
+}
+
+// resolvedMatchScore 调用方的解析结果确认了被调用者的定义文件时，按导入匹配计分，无需读取调用方的导入。
+// 同文件、同目录的分数不依赖导入
+func (idx *Indexer) resolvedMatchScore(workspacePath string, resolved map[string]struct{}, callerPath, calleePath,
+	calleeName, callerName string) int {
+	if _, ok := resolved[calleePath]; ok && callerPath != calleePath && !utils.IsSameParentDir(callerPath, calleePath) {
+		return resolvedImportScore
+	}
+	return idx.analyzer.CalculateSymbolMatchScore(workspacePath, nil, callerPath, calleePath, calleeName, callerName)
+}
@@ -0,0 +1,212 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/analyzer"
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/store"
+	"context"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestBuildResolvedSymbols(t *testing.T) {
+	da := &analyzer.DependencyAnalyzer{}
+	table := &codegraphpb.FileElementTable{
+		Path:     "/p/a/main.go",
+		Language: "go",
+		Elements: []*codegraphpb.Element{
+			{Name: "main", ElementType: codegraphpb.ElementType_FUNCTION, IsDefinition: true},
+			{Name: "Foo", ElementType: codegraphpb.ElementType_CALL},
+			{Name: "Foo", ElementType: codegraphpb.ElementType_CALL},
+			{Name: "Bar", ElementType: codegraphpb.ElementType_REFERENCE},
+			{Name: "Baz", ElementType: codegraphpb.ElementType_CALL},
+			{Name: "x", ElementType: codegraphpb.ElementType_VARIABLE},
+		},
+	}
+	occurrences := map[string]*codegraphpb.SymbolOccurrence{
+		"Foo": {Name: "Foo", Language: "go", Occurrences: []*codegraphpb.Occurrence{
+			{Path: "/p/a/foo.go", Range: []int32{1, 0, 3, 1}},
+			{Path: "/p/a/foo.go", Range: []int32{5, 0, 7, 1}},
+			{Path: "/p/b/foo.go", Range: []int32{1, 0, 3, 1}},
+		}},
+		"Bar": {Name: "Bar", Language: "go", Occurrences: []*codegraphpb.Occurrence{{Path: "/p/c/bar.go"}}},
+	}
+
+	resolved := buildResolvedSymbols(da.FilterByImports, table, occurrences)
+
+	// 按首次出现的顺序，每个符号名一条，只记录经确认的定义文件
+	require.Len(t, resolved, 3)
+	assert.Equal(t, "/p/a/main.go", resolved[0].FilePath)
+	assert.Equal(t, "Foo", resolved[0].Symbol.Name)
+	require.Len(t, resolved[0].Symbol.Occurrences, 1)
+	assert.Equal(t, "/p/a/foo.go", resolved[0].Symbol.Occurrences[0].Path)
+	assert.Nil(t, resolved[0].Symbol.Occurrences[0].Range)
+	// 无法确认或没有定义的符号也记录
+	assert.Equal(t, "Bar", resolved[1].Symbol.Name)
+	assert.Empty(t, resolved[1].Symbol.Occurrences)
+	assert.Equal(t, "Baz", resolved[2].Symbol.Name)
+	assert.Empty(t, resolved[2].Symbol.Occurrences)
+}
+
+func TestChangedDefinitionNames(t *testing.T) {
+	table := func(names ...string) *codegraphpb.FileElementTable {
+		ft := &codegraphpb.FileElementTable{Path: "/p/a.go"}
+		for _, name := range names {
+			ft.Elements = append(ft.Elements, &codegraphpb.Element{Name: name, IsDefinition: true,
+				ElementType: codegraphpb.ElementType_FUNCTION})
+		}
+		// 调用不影响定义集合
+		ft.Elements = append(ft.Elements, &codegraphpb.Element{Name: "Call", ElementType: codegraphpb.ElementType_CALL})
+		return ft
+	}
+
+	assert.Equal(t, []string{"Bar", "Baz"}, changedDefinitionNames(table("Foo", "Bar"), table("Foo", "Baz")))
+	assert.Empty(t, changedDefinitionNames(table("Foo"), table("Foo")))
+	assert.Equal(t, []string{"Foo"}, changedDefinitionNames(nil, table("Foo")))
+	assert.Equal(t, []string{"Foo"}, changedDefinitionNames(table("Foo"), nil))
+}
+
+func TestResolvedMatchScore(t *testing.T) {
+	idx := &Indexer{analyzer: &analyzer.DependencyAnalyzer{}}
+	resolved := map[string]struct{}{"/p/b/foo.go": {}}
+
+	// 经解析确认的定义按导入匹配计分，同文件、同目录不变
+	assert.Equal(t, resolvedImportScore, idx.resolvedMatchScore("/p", resolved, "/p/a/main.go", "/p/b/foo.go", "Foo", "main"))
+	assert.Equal(t, 100, idx.resolvedMatchScore("/p", resolved, "/p/a/main.go", "/p/a/main.go", "Foo", "main"))
+	assert.Equal(t, 75, idx.resolvedMatchScore("/p", resolved, "/p/a/main.go", "/p/a/foo.go", "Foo", "main"))
+	assert.Less(t, idx.resolvedMatchScore("/p", resolved, "/p/a/main.go", "/p/c/foo.go", "Foo", "main"), resolvedImportScore)
+}
+
+func TestResolveProject_RoundTrip(t *testing.T) {
+	logger := &store.MockLogger{}
+	storage, err := store.NewLevelDBStorage(t.TempDir(), logger)
+	require.NoError(t, err)
+	defer storage.Close()
+	idx := &Indexer{
+		analyzer: &analyzer.DependencyAnalyzer{},
+		storage:  storage,
+		config:   &Config{MaxConcurrency: 2},
+		logger:   logger,
+	}
+	ctx := context.Background()
+	projectUuid := "p"
+
+	table := &codegraphpb.FileElementTable{
+		Path:     "/p/a/main.go",
+		Language: string(lang.Go),
+		Elements: []*codegraphpb.Element{
+			{Name: "main", ElementType: codegraphpb.ElementType_FUNCTION, IsDefinition: true},
+			{Name: "Foo", ElementType: codegraphpb.ElementType_CALL},
+		},
+	}
+	require.NoError(t, storage.Put(ctx, projectUuid, &store.Entry{
+		Key: store.ElementPathKey{Language: lang.Go, Path: table.Path}, Value: table}))
+	require.NoError(t, storage.Put(ctx, projectUuid, &store.Entry{
+		Key: store.SymbolNameKey{Language: lang.Go, Name: "Foo"},
+		Value: &codegraphpb.SymbolOccurrence{Name: "Foo", Language: string(lang.Go), Occurrences: []*codegraphpb.Occurrence{
+			{Path: "/p/a/foo.go", Range: []int32{1, 0, 3, 1}},
+			{Path: "/p/b/foo.go", Range: []int32{1, 0, 3, 1}},
+		}}}))
+
+	idx.resolveProject(ctx, projectUuid, true)
+	assert.True(t, idx.resolvedIndexComplete(ctx, projectUuid))
+
+	// 解析结果经路径字典存储后读回的仍是定义所在文件的路径
+	paths, err := idx.getResolvedSymbolPaths(ctx, projectUuid, []store.ResolvedSymbolKey{
+		{SymbolName: "Foo", FilePath: table.Path},
+		{SymbolName: "Bar", FilePath: table.Path},
+	})
+	require.NoError(t, err)
+	require.Len(t, paths, 2)
+	assert.Equal(t, map[string]struct{}{"/p/a/foo.go": {}}, paths[0])
+	assert.Nil(t, paths[1])
+
+	files, ok := idx.getResolvedReferenceFiles(ctx, projectUuid, lang.Go, []string{"Foo"})
+	assert.True(t, ok)
+	assert.Equal(t, []string{table.Path}, files)
+}
+
+func TestLockResolve(t *testing.T) {
+	idx := &Indexer{}
+	ctx := context.Background()
+	unlock, err := idx.lockResolve(ctx, "p")
+	require.NoError(t, err)
+
+	// 其他项目不等待同一把锁
+	other, err := idx.lockResolve(ctx, "q")
+	require.NoError(t, err)
+	other()
+
+	// 等待中的获取随 ctx 取消返回
+	cancelCtx, cancel := context.WithCancel(ctx)
+	cancel()
+	_, err = idx.lockResolve(cancelCtx, "p")
+	assert.ErrorIs(t, err, context.Canceled)
+
+	unlock()
+	unlock, err = idx.lockResolve(ctx, "p")
+	require.NoError(t, err)
+	unlock()
+}
+
+func TestMarkResolveStale_HoldsLockUntilWrite(t *testing.T) {
+	logger := &store.MockLogger{}
+	storage, err := store.NewLevelDBStorage(t.TempDir(), logger)
+	require.NoError(t, err)
+	defer storage.Close()
+	idx := &Indexer{
+		analyzer: &analyzer.DependencyAnalyzer{},
+		storage:  storage,
+		config:   &Config{MaxConcurrency: 2},
+		logger:   logger,
+	}
+	ctx := context.Background()
+	projectUuid := "p"
+
+	table := &codegraphpb.FileElementTable{
+		Path:     "/p/a/main.go",
+		Language: string(lang.Go),
+		Elements: []*codegraphpb.Element{
+			{Name: "Foo", ElementType: codegraphpb.ElementType_CALL},
+		},
+	}
+	require.NoError(t, storage.Put(ctx, projectUuid, &store.Entry{
+		Key: store.ElementPathKey{Language: lang.Go, Path: table.Path}, Value: table}))
+	idx.resolveProject(ctx, projectUuid, true)
+	require.True(t, idx.resolvedIndexComplete(ctx, projectUuid))
+
+	newTable := &codegraphpb.FileElementTable{
+		Path:     table.Path,
+		Language: table.Language,
+		Elements: []*codegraphpb.Element{
+			{Name: "Bar", ElementType: codegraphpb.ElementType_CALL},
+		},
+	}
+	unlock, err := idx.markResolveStale(ctx, projectUuid, []*codegraphpb.FileElementTable{table},
+		[]*codegraphpb.FileElementTable{newTable})
+	require.NoError(t, err)
+	assert.False(t, idx.resolvedIndexComplete(ctx, projectUuid))
+
+	// 写入新表之前，解析不能读到旧表后清除标记
+	timeoutCtx, cancel := context.WithTimeout(ctx, 10*time.Millisecond)
+	defer cancel()
+	_, err = idx.beginResolveChunk(timeoutCtx, projectUuid)
+	assert.ErrorIs(t, err, context.DeadlineExceeded)
+
+	require.NoError(t, storage.Put(ctx, projectUuid, &store.Entry{
+		Key: store.ElementPathKey{Language: lang.Go, Path: newTable.Path}, Value: newTable}))
+	unlock()
+	idx.resolveProject(ctx, projectUuid, false)
+	assert.True(t, idx.resolvedIndexComplete(ctx, projectUuid))
+	paths, err := idx.getResolvedSymbolPaths(ctx, projectUuid, []store.ResolvedSymbolKey{
+		{SymbolName: "Foo", FilePath: table.Path},
+		{SymbolName: "Bar", FilePath: table.Path},
+	})
+	require.NoError(t, err)
+	assert.Nil(t, paths[0])
+	assert.NotNil(t, paths[1])
+}
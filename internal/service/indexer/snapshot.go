@@ -0,0 +1,340 @@
+package indexer
+
+import (
+	"bufio"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/store"
+	"codebase-indexer/pkg/codegraph/utils"
+	"codebase-indexer/pkg/codegraph/workspace"
+	"context"
+	"crypto/sha256"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+)
+
+// 索引快照：导出的快照按项目和提交命名，放在共享的快照目录中。项目首次索引前导入匹配的快照，
+// 内容与快照一致的本地文件不再重新索引
+
+// ExportSnapshots 导出工作区内各项目的索引快照到目录，返回写入的文件。dir 为空时写入配置的共享快照目录
+func (idx *Indexer) ExportSnapshots(ctx context.Context, workspacePath string, dir string) ([]string, error) {
+	if dir == "" {
+		dir = idx.config.SnapshotDir
+	}
+	if dir == "" {
+		return nil, fmt.Errorf("snapshot dir is not specified and SNAPSHOT_DIR is not set")
+	}
+	snapshotStore, ok := idx.storage.(store.SnapshotStore)
+	if !ok {
+		return nil, fmt.Errorf("storage does not support snapshots")
+	}
+	projects := idx.workspaceReader.FindProjects(ctx, workspacePath, true, workspace.DefaultVisitPattern)
+	if len(projects) == 0 {
+		return nil, fmt.Errorf("find no projects in workspace: %s", workspacePath)
+	}
+	if err := os.MkdirAll(dir, 0755); err != nil {
+		return nil, fmt.Errorf("create snapshot dir %s err: %w", dir, err)
+	}
+	files := make([]string, 0, len(projects))
+	for _, project := range projects {
+		path, err := idx.exportProjectSnapshot(ctx, snapshotStore, workspacePath, project, dir)
+		if err != nil {
+			return files, fmt.Errorf("export project %s snapshot err: %w", project.Path, err)
+		}
+		files = append(files, path)
+	}
+	return files, nil
+}
+
+func (idx *Indexer) exportProjectSnapshot(ctx context.Context, snapshotStore store.SnapshotStore, workspacePath string,
+	project *workspace.Project, dir string) (string, error) {
+	commit, err := gitHead(project.Path)
+	if err != nil {
+		idx.logger.Warn("project %s read git head err: %v, export snapshot without commit", project.Path, err)
+	}
+	hashes, err := idx.indexedFileHashes(ctx, workspacePath, project)
+	if err != nil {
+		return "", err
+	}
+
+	tmp, err := os.CreateTemp(dir, project.Uuid+".*.tmp")
+	if err != nil {
+		return "", err
+	}
+	defer os.Remove(tmp.Name())
+	meta, err := snapshotStore.ExportSnapshot(ctx, project.Uuid, tmp, store.SnapshotMeta{
+		Commit:      commit,
+		ProjectPath: project.Path,
+		FileHashes:  hashes,
+	})
+	if err == nil {
+		err = tmp.Sync()
+	}
+	if closeErr := tmp.Close(); err == nil {
+		err = closeErr
+	}
+	if err != nil {
+		return "", err
+	}
+	path := filepath.Join(dir, snapshotFileName(project.Uuid, commit))
+	if err = os.Rename(tmp.Name(), path); err != nil {
+		return "", err
+	}
+	idx.logger.Info("project %s exported snapshot %s, commit %s, %d keys, %d files", project.Path, path, commit,
+		meta.Keys, len(hashes))
+	return path, nil
+}
+
+// indexedFileHashes 索引与本地文件一致（时间戳相同）的文件内容哈希
+func (idx *Indexer) indexedFileHashes(ctx context.Context, workspacePath string, project *workspace.Project) (map[string]string, error) {
+	timestamps, _, err := idx.collectFiles(ctx, workspacePath, project.Path)
+	if err != nil {
+		return nil, err
+	}
+	iter := idx.storage.IterPrefix(ctx, project.Uuid, store.PathKeySystemPrefix)
+	if iter == nil {
+		return nil, fmt.Errorf("failed to iterate project %s", project.Uuid)
+	}
+	defer iter.Close()
+	indexed := make(map[string]int64)
+	for iter.Next() {
+		key, err := store.ToElementPathKey(iter.Key())
+		if err != nil {
+			continue
+		}
+		fileTimestamp, ok := timestamps[key.Path]
+		if !ok {
+			continue
+		}
+		var elementTable codegraphpb.FileElementTable
+		if err = store.UnmarshalValue(iter.Value(), &elementTable); err != nil {
+			continue
+		}
+		if elementTable.Timestamp == fileTimestamp {
+			indexed[key.Path] = fileTimestamp
+		}
+	}
+	if err = iter.Close(); err != nil {
+		return nil, err
+	}
+	hashes := make(map[string]string, len(indexed))
+	err = idx.hashFiles(ctx, indexed, func(path string, _ int64, hash string) {
+		hashes[path] = hash
+	})
+	return hashes, err
+}
+
+// restoreSnapshot 项目没有索引时导入快照目录中匹配的快照，记录内容与快照一致的本地文件
+func (idx *Indexer) restoreSnapshot(ctx context.Context, project *workspace.Project, sourceFileTimestamps map[string]int64) {
+	if idx.config.SnapshotDir == "" {
+		return
+	}
+	snapshotStore, ok := idx.storage.(store.SnapshotStore)
+	if !ok || snapshotStore.MountedSnapshot(project.Uuid) != nil || idx.projectIndexed(ctx, project.Uuid) {
+		return
+	}
+	commit, _ := gitHead(project.Path)
+	path := findSnapshot(idx.config.SnapshotDir, project.Uuid, commit)
+	if path == "" {
+		return
+	}
+	start := time.Now()
+	meta, err := snapshotStore.ImportSnapshot(ctx, project.Uuid, path)
+	if err != nil {
+		idx.logger.Warn("project %s import snapshot %s err: %v", project.Path, path, err)
+		return
+	}
+	idx.invalidateProjectIndex(project.Uuid)
+
+	candidates := make(map[string]int64, len(meta.FileHashes))
+	for file := range meta.FileHashes {
+		if fileTimestamp, ok := sourceFileTimestamps[file]; ok {
+			candidates[file] = fileTimestamp
+		}
+	}
+	adopted := make(map[string]int64, len(candidates))
+	err = idx.hashFiles(ctx, candidates, func(file string, fileTimestamp int64, hash string) {
+		if meta.FileHashes[file] == hash {
+			adopted[file] = fileTimestamp
+		}
+	})
+	if err == nil {
+		err = snapshotStore.AdoptSnapshotFiles(ctx, project.Uuid, adopted)
+	}
+	if err != nil {
+		idx.logger.Warn("project %s adopt snapshot files err: %v", project.Path, err)
+	}
+	idx.logger.Info("project %s imported snapshot %s, commit %s (head %s), %d/%d files unchanged, cost %d ms",
+		project.Path, path, meta.Commit, commit, len(adopted), len(sourceFileTimestamps),
+		time.Since(start).Milliseconds())
+}
+
+// adoptedSnapshotFiles 导入快照时确认与快照一致的文件及其修改时间，没有挂载快照时返回 nil
+func (idx *Indexer) adoptedSnapshotFiles(ctx context.Context, projectUuid string) map[string]int64 {
+	snapshotStore, ok := idx.storage.(store.SnapshotStore)
+	if !ok || snapshotStore.MountedSnapshot(projectUuid) == nil {
+		return nil
+	}
+	adopted, err := snapshotStore.AdoptedSnapshotFiles(ctx, projectUuid)
+	if err != nil {
+		idx.logger.Warn("project %s read adopted snapshot files err: %v", projectUuid, err)
+	}
+	return adopted
+}
+
+// hashFiles 并发计算文件内容的 sha256，fn 串行调用，读取失败的文件跳过
+func (idx *Indexer) hashFiles(ctx context.Context, files map[string]int64, fn func(path string, timestamp int64, hash string)) error {
+	type file struct {
+		path      string
+		timestamp int64
+	}
+	ch := make(chan file)
+	var mu sync.Mutex
+	var wg sync.WaitGroup
+	for i := 0; i < idx.config.MaxConcurrency; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for f := range ch {
+				hash, err := hashFile(f.path)
+				if err != nil {
+					continue
+				}
+				mu.Lock()
+				fn(f.path, f.timestamp, hash)
+				mu.Unlock()
+			}
+		}()
+	}
+	var err error
+	for path, timestamp := range files {
+		if err = utils.CheckContext(ctx); err != nil {
+			break
+		}
+		ch <- file{path: path, timestamp: timestamp}
+	}
+	close(ch)
+	wg.Wait()
+	return err
+}
+
+func hashFile(path string) (string, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return "", err
+	}
+	defer f.Close()
+	h := sha256.New()
+	if _, err = io.Copy(h, f); err != nil {
+		return "", err
+	}
+	return hex.EncodeToString(h.Sum(nil)), nil
+}
+
+func snapshotFileName(projectUuid string, commit string) string {
+	if commit == "" {
+		return projectUuid + store.SnapshotFileExt
+	}
+	return projectUuid + "-" + commit + store.SnapshotFileExt
+}
+
+// findSnapshot 优先选择当前提交的快照，没有时选择项目最新的快照，不一致的文件由时间戳过滤重新索引
+func findSnapshot(dir string, projectUuid string, commit string) string {
+	if commit != "" {
+		path := filepath.Join(dir, snapshotFileName(projectUuid, commit))
+		if _, err := os.Stat(path); err == nil {
+			return path
+		}
+	}
+	matches, _ := filepath.Glob(filepath.Join(dir, projectUuid+"-*"+store.SnapshotFileExt))
+	matches = append(matches, filepath.Join(dir, snapshotFileName(projectUuid, "")))
+	var latest string
+	var latestTime time.Time
+	for _, match := range matches {
+		info, err := os.Stat(match)
+		if err != nil || info.IsDir() {
+			continue
+		}
+		if latest == "" || info.ModTime().After(latestTime) {
+			latest, latestTime = match, info.ModTime()
+		}
+	}
+	return latest
+}
+
+// gitHead 读取目录所在 git 仓库当前的提交，支持工作树和 packed-refs，不调用 git 命令
+func gitHead(dir string) (string, error) {
+	gitDir, err := findGitDir(dir)
+	if err != nil {
+		return "", err
+	}
+	head, err := os.ReadFile(filepath.Join(gitDir, "HEAD"))
+	if err != nil {
+		return "", err
+	}
+	ref, ok := strings.CutPrefix(strings.TrimSpace(string(head)), "ref: ")
+	if !ok {
+		return ref, nil
+	}
+	// 工作树的分支引用在主仓库目录
+	commonDir := gitDir
+	if data, err := os.ReadFile(filepath.Join(gitDir, "commondir")); err == nil {
+		commonDir = strings.TrimSpace(string(data))
+		if !filepath.IsAbs(commonDir) {
+			commonDir = filepath.Join(gitDir, commonDir)
+		}
+	}
+	for _, d := range []string{gitDir, commonDir} {
+		if data, err := os.ReadFile(filepath.Join(d, filepath.FromSlash(ref))); err == nil {
+			return strings.TrimSpace(string(data)), nil
+		}
+	}
+	f, err := os.Open(filepath.Join(commonDir, "packed-refs"))
+	if err != nil {
+		return "", fmt.Errorf("ref %s not found: %w", ref, err)
+	}
+	defer f.Close()
+	scanner := bufio.NewScanner(f)
+	for scanner.Scan() {
+		if hash, name, ok := strings.Cut(scanner.Text(), " "); ok && name == ref {
+			return hash, nil
+		}
+	}
+	return "", fmt.Errorf("ref %s not found", ref)
+}
+
+// findGitDir 向上查找 .git，.git 为文件时（工作树、子模块）读取其中的 gitdir
+func findGitDir(dir string) (string, error) {
+	for {
+		path := filepath.Join(dir, ".git")
+		info, err := os.Stat(path)
+		if err == nil {
+			if info.IsDir() {
+				return path, nil
+			}
+			data, err := os.ReadFile(path)
+			if err != nil {
+				return "", err
+			}
+			gitDir, ok := strings.CutPrefix(strings.TrimSpace(string(data)), "gitdir: ")
+			if !ok {
+				return "", fmt.Errorf("invalid git file %s", path)
+			}
+			if !filepath.IsAbs(gitDir) {
+				gitDir = filepath.Join(dir, gitDir)
+			}
+			return gitDir, nil
+		}
+		parent := filepath.Dir(dir)
+		if parent == dir {
+			return "", errors.New("not a git repository")
+		}
+		dir = parent
+	}
+}
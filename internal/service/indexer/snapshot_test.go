@@ -0,0 +1,72 @@
+package indexer
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestGitHead(t *testing.T) {
+	const commitA = "1111111111111111111111111111111111111111"
+	const commitB = "2222222222222222222222222222222222222222"
+	root := t.TempDir()
+	gitDir := filepath.Join(root, ".git")
+	require.NoError(t, os.MkdirAll(filepath.Join(gitDir, "refs", "heads"), 0755))
+	require.NoError(t, os.WriteFile(filepath.Join(gitDir, "HEAD"), []byte("ref: refs/heads/main\n"), 0644))
+	require.NoError(t, os.WriteFile(filepath.Join(gitDir, "packed-refs"),
+		[]byte("# pack-refs with: peeled fully-peeled sorted\n"+commitA+" refs/heads/main\n"), 0644))
+
+	// 子目录向上查找仓库，分支只在 packed-refs 中
+	sub := filepath.Join(root, "pkg", "a")
+	require.NoError(t, os.MkdirAll(sub, 0755))
+	head, err := gitHead(sub)
+	require.NoError(t, err)
+	assert.Equal(t, commitA, head)
+
+	// 松散引用优先
+	require.NoError(t, os.WriteFile(filepath.Join(gitDir, "refs", "heads", "main"), []byte(commitB+"\n"), 0644))
+	head, err = gitHead(root)
+	require.NoError(t, err)
+	assert.Equal(t, commitB, head)
+
+	// 工作树：.git 文件指向主仓库下的工作树目录，分支引用在主仓库
+	worktree := filepath.Join(t.TempDir(), "wt")
+	worktreeGitDir := filepath.Join(gitDir, "worktrees", "wt")
+	require.NoError(t, os.MkdirAll(worktree, 0755))
+	require.NoError(t, os.MkdirAll(worktreeGitDir, 0755))
+	require.NoError(t, os.WriteFile(filepath.Join(worktree, ".git"), []byte("gitdir: "+worktreeGitDir+"\n"), 0644))
+	require.NoError(t, os.WriteFile(filepath.Join(worktreeGitDir, "HEAD"), []byte("ref: refs/heads/main\n"), 0644))
+	require.NoError(t, os.WriteFile(filepath.Join(worktreeGitDir, "commondir"), []byte("../..\n"), 0644))
+	head, err = gitHead(worktree)
+	require.NoError(t, err)
+	assert.Equal(t, commitB, head)
+
+	// 分离头指针
+	require.NoError(t, os.WriteFile(filepath.Join(gitDir, "HEAD"), []byte(commitA+"\n"), 0644))
+	head, err = gitHead(root)
+	require.NoError(t, err)
+	assert.Equal(t, commitA, head)
+}
+
+func TestFindSnapshot(t *testing.T) {
+	dir := t.TempDir()
+	assert.Empty(t, findSnapshot(dir, "p", "c1"))
+
+	older := filepath.Join(dir, snapshotFileName("p", "c1"))
+	newer := filepath.Join(dir, snapshotFileName("p", "c2"))
+	require.NoError(t, os.WriteFile(older, nil, 0644))
+	require.NoError(t, os.WriteFile(newer, nil, 0644))
+	require.NoError(t, os.WriteFile(filepath.Join(dir, snapshotFileName("q", "c3")), nil, 0644))
+	now := time.Now()
+	require.NoError(t, os.Chtimes(older, now.Add(-time.Hour), now.Add(-time.Hour)))
+	require.NoError(t, os.Chtimes(newer, now, now))
+
+	// 当前提交的快照优先，否则取最新的
+	assert.Equal(t, older, findSnapshot(dir, "p", "c1"))
+	assert.Equal(t, newer, findSnapshot(dir, "p", "c9"))
+	assert.Equal(t, newer, findSnapshot(dir, "p", ""))
+}
@@ -0,0 +1,31 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/types"
+	"context"
+)
+
+// RelationEmitter 流式查询的接收方，由调用方通过上下文传入。查询每得到一批节点调用一次，parents[i] 是 nodes[i]
+// 的父节点，根节点为 nil，父节点总是先于子节点发出。返回错误时停止查询。
+// 流式查询不读写结果缓存，每次都重新计算
+type RelationEmitter func(layer int, parents, nodes []*types.RelationNode) error
+
+type relationEmitterKey struct{}
+
+// WithRelationEmitter 返回流式查询的上下文
+func WithRelationEmitter(ctx context.Context, emit RelationEmitter) context.Context {
+	return context.WithValue(ctx, relationEmitterKey{}, emit)
+}
+
+func relationEmitterFromContext(ctx context.Context) RelationEmitter {
+	emit, _ := ctx.Value(relationEmitterKey{}).(RelationEmitter)
+	return emit
+}
+
+// emitRoots 发出根节点
+func emitRoots(emit RelationEmitter, roots []*types.RelationNode) error {
+	if emit == nil || len(roots) == 0 {
+		return nil
+	}
+	return emit(0, make([]*types.RelationNode, len(roots)), roots)
+}
@@ -0,0 +1,153 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/cache"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"math"
+	"strconv"
+	"sync"
+	"sync/atomic"
+)
+
+const (
+	DefaultFileTableCacheBytes = 64 * 1024 * 1024 // 64MB
+	// fileTableDecodedSizeFactor 解码后的对象比编码大小大数倍，按编码大小乘以该系数估算占用
+	fileTableDecodedSizeFactor = 4
+)
+
+// FileTableCacheStats 文件元素表缓存的统计信息
+type FileTableCacheStats struct {
+	Hits      int64
+	Misses    int64
+	Evictions int64
+	Entries   int
+	Bytes     int64
+	MaxBytes  int64
+}
+
+type fileTableCacheEntry struct {
+	table *codegraphpb.FileElementTable
+	size  int64
+}
+
+// fileTableProjectState 项目的失效计数。generation 每次写入后递增，用于丢弃写入前开始的读取；
+// epoch 在整个项目失效时递增，旧键不再被访问，随LRU淘汰
+type fileTableProjectState struct {
+	generation atomic.Uint64
+	epoch      atomic.Uint64
+}
+
+// fileTableCache 按字节预算淘汰的已解码文件元素表缓存，所有查询路径共享，底层为分片LRU。
+// 缓存的表只读，调用方不能修改。写入索引后调用 invalidate，
+// 失效前已开始读取的旧数据通过项目版本号丢弃，不会被重新放入缓存。nil 表示不缓存。
+type fileTableCache struct {
+	tables   *cache.ShardedLRUCache[*fileTableCacheEntry]
+	projects sync.Map // projectUuid -> *fileTableProjectState
+	maxBytes int64
+}
+
+// newFileTableCache shards 为0时使用默认分片数，单个表超过分片预算时不缓存
+func newFileTableCache(maxBytes int64, shards int) *fileTableCache {
+	if maxBytes <= 0 {
+		maxBytes = DefaultFileTableCacheBytes
+	}
+	return &fileTableCache{
+		tables: cache.NewShardedLRUCacheWithOptions[*fileTableCacheEntry](0, math.MaxInt32,
+			cache.ShardedOptions[*fileTableCacheEntry]{
+				Shards:   shards,
+				MaxBytes: maxBytes,
+				SizeOf: func(_ string, entry *fileTableCacheEntry) int64 {
+					return entry.size
+				},
+			}),
+		maxBytes: maxBytes,
+	}
+}
+
+func (c *fileTableCache) project(projectUuid string) *fileTableProjectState {
+	if state, ok := c.projects.Load(projectUuid); ok {
+		return state.(*fileTableProjectState)
+	}
+	state, _ := c.projects.LoadOrStore(projectUuid, &fileTableProjectState{})
+	return state.(*fileTableProjectState)
+}
+
+func fileTableCacheKey(projectUuid string, epoch uint64, path string) string {
+	return projectUuid + "\x00" + strconv.FormatUint(epoch, 10) + "\x00" + path
+}
+
+// get 获取缓存的表，同时返回项目当前版本号，未命中时读取存储后用该版本号调用 add
+func (c *fileTableCache) get(projectUuid string, path string) (*codegraphpb.FileElementTable, uint64, bool) {
+	if c == nil {
+		return nil, 0, false
+	}
+	state := c.project(projectUuid)
+	generation := state.generation.Load()
+	entry, ok := c.tables.Get(fileTableCacheKey(projectUuid, state.epoch.Load(), path))
+	if !ok {
+		return nil, generation, false
+	}
+	return entry.table, generation, true
+}
+
+// add 放入解码后的表，encodedSize 为存储中的编码大小。
+// 读取期间项目有写入（版本号变化）或缓存中已有更新的表时放弃
+func (c *fileTableCache) add(projectUuid string, path string, generation uint64,
+	table *codegraphpb.FileElementTable, encodedSize int) {
+	if c == nil {
+		return
+	}
+	state := c.project(projectUuid)
+	if state.generation.Load() != generation {
+		return
+	}
+	key := fileTableCacheKey(projectUuid, state.epoch.Load(), path)
+	entry := &fileTableCacheEntry{table: table, size: int64(encodedSize) * fileTableDecodedSizeFactor}
+	if !c.tables.PutIf(key, entry, func(old *fileTableCacheEntry) bool {
+		return old.table.Timestamp <= table.Timestamp
+	}) {
+		return
+	}
+	// 放入的同时发生了写入，失效方可能已经删过该键，这里再删一次
+	if state.generation.Load() != generation {
+		c.tables.Delete(key)
+	}
+}
+
+// invalidate 删除项目下指定路径的缓存，在写入存储之后调用
+func (c *fileTableCache) invalidate(projectUuid string, paths ...string) {
+	if c == nil {
+		return
+	}
+	state := c.project(projectUuid)
+	state.generation.Add(1)
+	epoch := state.epoch.Load()
+	for _, path := range paths {
+		c.tables.Delete(fileTableCacheKey(projectUuid, epoch, path))
+	}
+}
+
+// invalidateProject 使项目下的所有缓存失效
+func (c *fileTableCache) invalidateProject(projectUuid string) {
+	if c == nil {
+		return
+	}
+	state := c.project(projectUuid)
+	state.generation.Add(1)
+	state.epoch.Add(1)
+}
+
+func (c *fileTableCache) stats() FileTableCacheStats {
+	if c == nil {
+		return FileTableCacheStats{}
+	}
+	stats := c.tables.Stats()
+	return FileTableCacheStats{
+		Hits:      stats.Hits,
+		Misses:    stats.Misses,
+		Evictions: stats.Evictions,
+		Entries:   stats.Len,
+		Bytes:     stats.Bytes,
+		MaxBytes:  c.maxBytes,
+	}
+}
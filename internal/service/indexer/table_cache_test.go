@@ -0,0 +1,63 @@
+package indexer
+
+import (
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func TestFileTableCache(t *testing.T) {
+	// 单分片便于验证淘汰顺序，每个表按 100*4 字节计，预算只够放两个
+	c := newFileTableCache(800, 1)
+	put := func(project, path string, timestamp int64) {
+		_, generation, _ := c.get(project, path)
+		c.add(project, path, generation, &codegraphpb.FileElementTable{Path: path, Timestamp: timestamp}, 100)
+	}
+
+	put("p1", "/a.go", 1)
+	put("p1", "/b.go", 1)
+	_, _, ok := c.get("p1", "/a.go")
+	assert.True(t, ok)
+	// 超出预算淘汰最久未使用的 /b.go
+	put("p1", "/c.go", 1)
+	_, _, ok = c.get("p1", "/b.go")
+	assert.False(t, ok)
+	_, _, ok = c.get("p1", "/c.go")
+	assert.True(t, ok)
+
+	// 读取期间发生写入，旧数据不再放入缓存
+	_, generation, _ := c.get("p2", "/a.go")
+	c.invalidate("p2", "/a.go")
+	c.add("p2", "/a.go", generation, &codegraphpb.FileElementTable{Path: "/a.go"}, 100)
+	_, _, ok = c.get("p2", "/a.go")
+	assert.False(t, ok)
+
+	stats := c.stats()
+	assert.Equal(t, 2, stats.Entries)
+	assert.Equal(t, int64(800), stats.Bytes)
+	assert.Equal(t, int64(1), stats.Evictions)
+
+	// 项目整体失效后旧键不再命中
+	c.invalidateProject("p1")
+	_, _, ok = c.get("p1", "/a.go")
+	assert.False(t, ok)
+	put("p1", "/a.go", 2)
+	table, _, ok := c.get("p1", "/a.go")
+	assert.True(t, ok)
+	assert.Equal(t, int64(2), table.Timestamp)
+	assert.Positive(t, stats.Hits)
+	assert.Positive(t, stats.Misses)
+
+	// 已有更新的表时不被旧表覆盖
+	put("p1", "/a.go", 5)
+	put("p1", "/a.go", 3)
+	table, _, _ = c.get("p1", "/a.go")
+	assert.Equal(t, int64(5), table.Timestamp)
+
+	// 未初始化的缓存不缓存任何内容
+	var disabled *fileTableCache
+	disabled.add("p1", "/a.go", 0, &codegraphpb.FileElementTable{Path: "/a.go"}, 100)
+	_, _, ok = disabled.get("p1", "/a.go")
+	assert.False(t, ok)
+}
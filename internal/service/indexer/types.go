@@ -1,13 +1,9 @@
 package indexer
 
 import (
-	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
-	"codebase-indexer/pkg/codegraph/store"
 	"codebase-indexer/pkg/codegraph/types"
-	"codebase-indexer/pkg/codegraph/workspace"
-	"codebase-indexer/pkg/logger"
-	"context"
 	"fmt"
+	"time"
 )
 
 // 常量定义
@@ -15,7 +11,6 @@ const (
 	MaxQueryLineLimit         = 200
 	DefaultConcurrency        = 1
 	DefaultBatchSize          = 50
-	DefaultMapBatchSize       = 5
 	DefaultMaxFiles           = 10000
 	DefaultMaxProjects        = 3
 	DefaultCacheCapacity      = 100000 // 假定单个文件平均10个元素,1万个文件
@@ -23,6 +18,10 @@ const (
 	MaxCalleeMapCacheCapacity = 1600
 	VarVariadic               = "..."
 	DefaultMaxLayer           = 3
+	DefaultMaxInflightBytes   = 256 * 1024 * 1024 // 索引流水线中在途批次的源码字节上限
+	DefaultCallGraphMaxNodes  = 2000              // 单次调用图查询最多展开的调用者节点数
+	DefaultCallGraphTimeout   = 10 * time.Second  // 单次调用图查询展开的耗时上限
+	DefaultCallGraphWorkers   = 8                 // 调用图每层并发查询调用者的协程数
 )
 
 // Config 索引器配置
@@ -33,6 +32,16 @@ type Config struct {
 	MaxProjects    int
 	VisitPattern   *types.VisitPattern
 	CacheCapacity  int
+	// FileTableCacheBytes 查询时已解码文件元素表缓存的字节预算
+	FileTableCacheBytes int
+	// QueryCacheCapacity 定义、引用、调用图查询结果缓存的条目数
+	QueryCacheCapacity int
+	// QueryCacheBytes 查询结果缓存按估算大小计的字节预算
+	QueryCacheBytes int
+	// MaxInflightBytes 索引流水线中已读取但尚未写入的源码字节上限，超出时解析阶段等待写入
+	MaxInflightBytes int
+	// SnapshotDir 共享的索引快照目录，项目首次索引前从这里导入快照，为空时不导入
+	SnapshotDir string
 }
 
 // CalleeKey 表示被调用的符号信息
@@ -84,95 +93,3 @@ func (c *CallerInfo) Key() string {
 		c.Position.EndColumn,
 	)
 }
-
-// MapBatcher 批量映射处理器
-type MapBatcher struct {
-	storage     store.GraphStorage // 存储
-	logger      logger.Logger
-	projectUuid string
-
-	batchSize int // 批量写入的大小限制
-	calleeMap map[string][]CallerInfo
-}
-
-// NewMapBatcher 创建批量映射处理器
-func NewMapBatcher(storage store.GraphStorage, logger logger.Logger, projectUuid string, batchSize int) *MapBatcher {
-	mb := &MapBatcher{
-		storage:     storage,
-		logger:      logger,
-		projectUuid: projectUuid,
-		batchSize:   batchSize,
-		calleeMap:   make(map[string][]CallerInfo),
-	}
-	return mb
-}
-
-// Add 添加映射项
-func (mb *MapBatcher) Add(key string, val []CallerInfo, merge bool) {
-	if merge {
-		mb.calleeMap[key] = append(mb.calleeMap[key], val...)
-	} else {
-		mb.calleeMap[key] = val
-	}
-	// 达到批次立即推送
-	if len(mb.calleeMap) >= mb.batchSize {
-		tempCalleeMap := mb.calleeMap
-		mb.calleeMap = make(map[string][]CallerInfo)
-		mb.flush(tempCalleeMap)
-	}
-}
-
-// flush 批量写入数据库
-func (mb *MapBatcher) flush(tempCalleeMap map[string][]CallerInfo) {
-	if len(tempCalleeMap) == 0 {
-		return
-	}
-	items := make([]*codegraphpb.CalleeMapItem, 0, len(tempCalleeMap))
-
-	for calleeName, callers := range tempCalleeMap {
-		item := &codegraphpb.CalleeMapItem{
-			CalleeName: calleeName,
-			Callers:    make([]*codegraphpb.CallerInfo, 0, len(callers)),
-		}
-		for _, c := range callers {
-			item.Callers = append(item.Callers, &codegraphpb.CallerInfo{
-				SymbolName: c.SymbolName,
-				FilePath:   c.FilePath,
-				Position: &codegraphpb.Position{
-					StartLine:   int32(c.Position.StartLine),
-					StartColumn: int32(c.Position.StartColumn),
-					EndLine:     int32(c.Position.EndLine),
-					EndColumn:   int32(c.Position.EndColumn),
-				},
-				ParamCount: int32(c.ParamCount),
-				CalleeKey: &codegraphpb.CalleeKey{
-					SymbolName: c.CalleeKey.SymbolName,
-					ParamCount: int32(c.CalleeKey.ParamCount),
-				},
-				IsVariadic: c.IsVariadic,
-				Score:      c.Score,
-			})
-		}
-
-		// 合并旧数据
-		old, _ := mb.storage.Get(context.Background(), mb.projectUuid,
-			store.CalleeMapKey{SymbolName: calleeName})
-		if old != nil {
-			var oldItem codegraphpb.CalleeMapItem
-			if err := store.UnmarshalValue(old, &oldItem); err == nil {
-				item.Callers = append(item.Callers, oldItem.Callers...)
-			}
-		}
-		items = append(items, item)
-	}
-
-	if err := mb.storage.BatchSave(context.Background(), mb.projectUuid,
-		workspace.CalleeMapItems(items)); err != nil {
-		mb.logger.Error("batch save failed: %v", err)
-	}
-}
-
-// Flush 手动刷盘
-func (mb *MapBatcher) Flush() {
-	mb.flush(mb.calleeMap)
-}
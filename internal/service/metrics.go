@@ -0,0 +1,171 @@
+package service
+
+import (
+	"codebase-indexer/internal/model"
+	"codebase-indexer/internal/repository"
+	"codebase-indexer/internal/service/indexer"
+	"codebase-indexer/pkg/codegraph/store"
+	"codebase-indexer/pkg/logger"
+	"codebase-indexer/pkg/metrics"
+	"runtime"
+	"strconv"
+)
+
+// 未处理完的事件状态，计入事件队列深度
+var (
+	pendingEmbeddingStatuses = []int{model.EmbeddingStatusInit, model.EmbeddingStatusUploading,
+		model.EmbeddingStatusBuilding, model.EmbeddingStatusUploadFailed}
+	pendingCodegraphStatuses = []int{model.CodegraphStatusInit, model.CodegraphStatusBuilding}
+)
+
+// fileTableCacheStatser 提供文件元素表缓存统计的索引器
+type fileTableCacheStatser interface {
+	FileTableCacheStats() indexer.FileTableCacheStats
+}
+
+// RegisterMetrics 注册在 /metrics 输出时采集的指标：LevelDB 统计、缓存命中率、事件队列深度和运行时信息
+func RegisterMetrics(storage *store.LevelDBStorage, codeIndexer Indexer, eventRepo repository.EventRepository,
+	logger logger.Logger) {
+	registerStorageMetrics(storage)
+	if statser, ok := codeIndexer.(fileTableCacheStatser); ok {
+		registerFileTableCacheMetrics(statser)
+	}
+	registerEventQueueMetrics(eventRepo, logger)
+	registerRuntimeMetrics()
+}
+
+func registerStorageMetrics(storage *store.LevelDBStorage) {
+	projectLevel := []string{"project", "level"}
+	project := []string{"project"}
+	levels := func(emit func(value float64, labelValues ...string), value func(l store.LevelStats) float64) {
+		for _, s := range storage.Stats() {
+			for _, l := range s.Levels {
+				emit(value(l), s.ProjectUuid, strconv.Itoa(l.Level))
+			}
+		}
+	}
+	projects := func(emit func(value float64, labelValues ...string), value func(s store.DBStats) float64) {
+		for _, s := range storage.Stats() {
+			emit(value(s), s.ProjectUuid)
+		}
+	}
+
+	metrics.NewGaugeFunc("codebase_indexer_leveldb_tables", "LevelDB table files per level.", projectLevel,
+		func(emit func(float64, ...string)) {
+			levels(emit, func(l store.LevelStats) float64 { return float64(l.Tables) })
+		})
+	metrics.NewGaugeFunc("codebase_indexer_leveldb_level_size_bytes", "LevelDB data size per level.", projectLevel,
+		func(emit func(float64, ...string)) {
+			levels(emit, func(l store.LevelStats) float64 { return float64(l.SizeBytes) })
+		})
+	metrics.NewCounterFunc("codebase_indexer_leveldb_compaction_seconds_total",
+		"Time spent compacting into each level since the database was opened.", projectLevel,
+		func(emit func(float64, ...string)) {
+			levels(emit, func(l store.LevelStats) float64 { return l.CompactionTime.Seconds() })
+		})
+	metrics.NewCounterFunc("codebase_indexer_leveldb_compaction_read_bytes_total",
+		"Bytes read by compactions into each level.", projectLevel,
+		func(emit func(float64, ...string)) {
+			levels(emit, func(l store.LevelStats) float64 { return float64(l.ReadBytes) })
+		})
+	metrics.NewCounterFunc("codebase_indexer_leveldb_compaction_write_bytes_total",
+		"Bytes written by compactions into each level.", projectLevel,
+		func(emit func(float64, ...string)) {
+			levels(emit, func(l store.LevelStats) float64 { return float64(l.WriteBytes) })
+		})
+	metrics.NewCounterFunc("codebase_indexer_leveldb_write_delays_total",
+		"Writes delayed because level 0 has too many tables.", project,
+		func(emit func(float64, ...string)) {
+			projects(emit, func(s store.DBStats) float64 { return float64(s.WriteDelayCount) })
+		})
+	metrics.NewCounterFunc("codebase_indexer_leveldb_write_delay_seconds_total",
+		"Time writes spent delayed by level 0 slowdown.", project,
+		func(emit func(float64, ...string)) {
+			projects(emit, func(s store.DBStats) float64 { return s.WriteDelay.Seconds() })
+		})
+	metrics.NewGaugeFunc("codebase_indexer_leveldb_write_paused",
+		"1 if writes are currently paused waiting for compaction.", project,
+		func(emit func(float64, ...string)) {
+			projects(emit, func(s store.DBStats) float64 {
+				if s.WritePaused {
+					return 1
+				}
+				return 0
+			})
+		})
+	metrics.NewGaugeFunc("codebase_indexer_leveldb_block_cache_bytes", "LevelDB block cache usage.", project,
+		func(emit func(float64, ...string)) {
+			projects(emit, func(s store.DBStats) float64 { return float64(s.CachedBlock) })
+		})
+	metrics.NewGaugeFunc("codebase_indexer_leveldb_opened_tables", "LevelDB table files currently open.", project,
+		func(emit func(float64, ...string)) {
+			projects(emit, func(s store.DBStats) float64 { return float64(s.OpenedTables) })
+		})
+}
+
+func registerFileTableCacheMetrics(statser fileTableCacheStatser) {
+	cacheLabel := []string{"cache"}
+	const cacheName = "file_table"
+	metrics.NewCounterFunc("codebase_indexer_cache_hits_total", "Cache hits.", cacheLabel,
+		func(emit func(float64, ...string)) {
+			emit(float64(statser.FileTableCacheStats().Hits), cacheName)
+		})
+	metrics.NewCounterFunc("codebase_indexer_cache_misses_total", "Cache misses.", cacheLabel,
+		func(emit func(float64, ...string)) {
+			emit(float64(statser.FileTableCacheStats().Misses), cacheName)
+		})
+	metrics.NewCounterFunc("codebase_indexer_cache_evictions_total", "Cache evictions.", cacheLabel,
+		func(emit func(float64, ...string)) {
+			emit(float64(statser.FileTableCacheStats().Evictions), cacheName)
+		})
+	metrics.NewGaugeFunc("codebase_indexer_cache_hit_ratio", "Cache hit ratio since start, 0 before any lookup.", cacheLabel,
+		func(emit func(float64, ...string)) {
+			stats := statser.FileTableCacheStats()
+			ratio := 0.0
+			if total := stats.Hits + stats.Misses; total > 0 {
+				ratio = float64(stats.Hits) / float64(total)
+			}
+			emit(ratio, cacheName)
+		})
+	metrics.NewGaugeFunc("codebase_indexer_cache_bytes", "Cache size in bytes.", cacheLabel,
+		func(emit func(float64, ...string)) {
+			emit(float64(statser.FileTableCacheStats().Bytes), cacheName)
+		})
+}
+
+func registerEventQueueMetrics(eventRepo repository.EventRepository, logger logger.Logger) {
+	metrics.NewGaugeFunc("codebase_indexer_event_queue_depth",
+		"Events not yet finished per workspace and queue.", []string{"workspace", "queue"},
+		func(emit func(float64, ...string)) {
+			queues := []struct {
+				name                 string
+				embedding, codegraph []int
+			}{
+				{name: "embedding", embedding: pendingEmbeddingStatuses},
+				{name: "codegraph", codegraph: pendingCodegraphStatuses},
+			}
+			for _, queue := range queues {
+				counts, err := eventRepo.GetEventsCountGroupByWorkspace(queue.embedding, queue.codegraph)
+				if err != nil {
+					logger.Warn("metrics: count %s events err: %v", queue.name, err)
+					continue
+				}
+				for workspacePath, count := range counts {
+					emit(float64(count), workspacePath, queue.name)
+				}
+			}
+		})
+}
+
+func registerRuntimeMetrics() {
+	metrics.NewGaugeFunc("codebase_indexer_goroutines", "Number of goroutines.", nil,
+		func(emit func(float64, ...string)) {
+			emit(float64(runtime.NumGoroutine()))
+		})
+	metrics.NewGaugeFunc("codebase_indexer_heap_alloc_bytes", "Bytes of allocated heap objects.", nil,
+		func(emit func(float64, ...string)) {
+			var m runtime.MemStats
+			runtime.ReadMemStats(&m)
+			emit(float64(m.HeapAlloc))
+		})
+}
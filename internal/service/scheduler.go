@@ -6,6 +6,7 @@ import (
 	"context"
 	"encoding/json"
 	"fmt"
+	"io"
 	"maps"
 	"os"
 	"path/filepath"
@@ -381,69 +382,80 @@ type SyncMetadata struct {
 
 // CreateChangesZip Create zip file containing file changes and metadata
 func (s *Scheduler) CreateChangesZip(config *config.CodebaseConfig, changes []*utils.FileStatus) (string, error) {
-	zipDir := filepath.Join(utils.UploadTmpDir, "zip")
-	if err := os.MkdirAll(zipDir, 0755); err != nil {
-		return "", err
-	}
-
-	zipPath := filepath.Join(zipDir, config.CodebaseId+"-"+time.Now().Format("20060102150405.000000")+".zip")
-	zipFile, err := os.Create(zipPath)
-	if err != nil {
-		return "", err
-	}
-	// Ensure cleanup of temporary zip file in case of error
-	cleanup := func() {
-		if err != nil {
-			if _, statErr := os.Stat(zipPath); statErr == nil {
-				_ = os.Remove(zipPath)
-				s.logger.Debug("temp zip file deleted successfully: %s", zipPath)
-			}
-		}
-	}
-	defer cleanup()
-	defer zipFile.Close()
+	return s.createZipFile(config, changes)
+}
 
-	zipWriter := zip.NewWriter(zipFile)
-	defer zipWriter.Close()
+// WriteFilesZip 将新增和修改的文件及同步元数据以 zip 格式写入 w，可直接写入上传请求体
+func (s *Scheduler) WriteFilesZip(w io.Writer, config *config.CodebaseConfig, fileStatus []*utils.FileStatus) error {
+	zipWriter := zip.NewWriter(w)
 
-	// Create SyncMetadata
+	// 创建SyncMetadata
 	metadata := &SyncMetadata{
 		ClientId:     config.ClientID,
 		CodebaseName: config.CodebaseName,
 		CodebasePath: config.CodebasePath,
-		FileList:     make([]utils.FileStatus, len(changes)),
+		FileList:     make([]utils.FileStatus, 0, len(fileStatus)),
 		Timestamp:    time.Now().Unix(),
 	}
 
-	for index, change := range changes {
+	// 给FileList设置值，在Windows系统下需要转换路径格式
+	for _, f := range fileStatus {
 		if runtime.GOOS == "windows" {
-			change.Path = filepath.ToSlash(change.Path)
+			f.Path = filepath.ToSlash(f.Path)
+			if f.Status == utils.FILE_STATUS_RENAME {
+				f.TargetPath = filepath.ToSlash(f.TargetPath)
+			}
 		}
-		metadata.FileList[index] = *change
+		metadata.FileList = append(metadata.FileList, *f)
 
-		// Only add new and modified files to zip
-		if change.Status == utils.FILE_STATUS_ADDED || change.Status == utils.FILE_STATUS_MODIFIED {
-			if err := utils.AddFileToZip(zipWriter, change.Path, config.CodebasePath); err != nil {
+		// 只添加新增和修改的文件到ZIP
+		if f.Status == utils.FILE_STATUS_ADDED || f.Status == utils.FILE_STATUS_MODIFIED {
+			if err := utils.AddFileToZip(zipWriter, f.Path, config.CodebasePath); err != nil {
 				// Continue trying to add other files but log error
-				s.logger.Warn("failed to add file to zip: %s, error: %v", change.Path, err)
+				s.logger.Warn("failed to add file to zip: %s, error: %v", f.Path, err)
 			}
 		}
 	}
 
-	// Add metadata file to zip
+	// 添加元数据文件到ZIP
 	metadataJson, err := json.Marshal(metadata)
 	if err != nil {
-		return "", err
+		return err
 	}
 
 	metadataFilePath := ".shenma_sync/" + time.Now().Format("20060102150405.000000")
 	metadataWriter, err := zipWriter.Create(metadataFilePath)
+	if err != nil {
+		return err
+	}
+
+	if _, err = metadataWriter.Write(metadataJson); err != nil {
+		return err
+	}
+
+	return zipWriter.Close()
+}
+
+// createZipFile 在上传临时目录下生成 zip 文件，失败时删除
+func (s *Scheduler) createZipFile(config *config.CodebaseConfig, fileStatus []*utils.FileStatus) (string, error) {
+	zipDir := filepath.Join(utils.UploadTmpDir, "zip")
+	if err := os.MkdirAll(zipDir, 0755); err != nil {
+		return "", err
+	}
+
+	zipPath := filepath.Join(zipDir, config.CodebaseId+"-"+time.Now().Format("20060102150405.000000")+".zip")
+	zipFile, err := os.Create(zipPath)
 	if err != nil {
 		return "", err
 	}
 
-	_, err = metadataWriter.Write(metadataJson)
+	err = s.WriteFilesZip(zipFile, config, fileStatus)
+	if closeErr := zipFile.Close(); err == nil {
+		err = closeErr
+	}
 	if err != nil {
+		_ = os.Remove(zipPath)
+		s.logger.Debug("temp zip file deleted successfully: %s", zipPath)
 		return "", err
 	}
 
@@ -545,146 +557,10 @@ func (s *Scheduler) SyncForCodebases(ctx context.Context, codebaseConfig []*conf
 
 // CreateSingleFileZip 创建单文件ZIP文件
 func (s *Scheduler) CreateSingleFileZip(config *config.CodebaseConfig, fileStatus *utils.FileStatus) (string, error) {
-	zipDir := filepath.Join(utils.UploadTmpDir, "zip")
-	if err := os.MkdirAll(zipDir, 0755); err != nil {
-		return "", err
-	}
-
-	zipPath := filepath.Join(zipDir, config.CodebaseId+"-"+time.Now().Format("20060102150405.000000")+".zip")
-	zipFile, err := os.Create(zipPath)
-	if err != nil {
-		return "", err
-	}
-
-	// 确保清理临时ZIP文件
-	cleanup := func() {
-		if err != nil {
-			if _, statErr := os.Stat(zipPath); statErr == nil {
-				_ = os.Remove(zipPath)
-				s.logger.Debug("temp zip file deleted successfully: %s", zipPath)
-			}
-		}
-	}
-	defer cleanup()
-	defer zipFile.Close()
-
-	zipWriter := zip.NewWriter(zipFile)
-	defer zipWriter.Close()
-
-	// 创建SyncMetadata
-	metadata := &SyncMetadata{
-		ClientId:     config.ClientID,
-		CodebaseName: config.CodebaseName,
-		CodebasePath: config.CodebasePath,
-		FileList:     make([]utils.FileStatus, 0),
-		Timestamp:    time.Now().Unix(),
-	}
-
-	if runtime.GOOS == "windows" {
-		fileStatus.Path = filepath.ToSlash(fileStatus.Path)
-	}
-	metadata.FileList = append(metadata.FileList, *fileStatus)
-
-	// 只添加新增和修改的文件到ZIP
-	if fileStatus.Status == utils.FILE_STATUS_ADDED || fileStatus.Status == utils.FILE_STATUS_MODIFIED {
-		if err := utils.AddFileToZip(zipWriter, fileStatus.Path, config.CodebasePath); err != nil {
-			// Continue trying to add other files but log error
-			s.logger.Warn("failed to add file to zip: %s, error: %v", fileStatus.Path, err)
-		}
-	}
-
-	// 添加元数据文件到ZIP
-	metadataJson, err := json.Marshal(metadata)
-	if err != nil {
-		return "", err
-	}
-
-	metadataFilePath := ".shenma_sync/" + time.Now().Format("20060102150405.000000")
-	metadataWriter, err := zipWriter.Create(metadataFilePath)
-	if err != nil {
-		return "", err
-	}
-
-	_, err = metadataWriter.Write(metadataJson)
-	if err != nil {
-		return "", err
-	}
-
-	return zipPath, nil
+	return s.createZipFile(config, []*utils.FileStatus{fileStatus})
 }
 
 // CreateFilesZip 创建多文件ZIP文件
 func (s *Scheduler) CreateFilesZip(config *config.CodebaseConfig, fileStatus []*utils.FileStatus) (string, error) {
-	zipDir := filepath.Join(utils.UploadTmpDir, "zip")
-	if err := os.MkdirAll(zipDir, 0755); err != nil {
-		return "", err
-	}
-
-	zipPath := filepath.Join(zipDir, config.CodebaseId+"-"+time.Now().Format("20060102150405.000000")+".zip")
-	zipFile, err := os.Create(zipPath)
-	if err != nil {
-		return "", err
-	}
-
-	// 确保清理临时ZIP文件
-	cleanup := func() {
-		if err != nil {
-			if _, statErr := os.Stat(zipPath); statErr == nil {
-				_ = os.Remove(zipPath)
-				s.logger.Debug("temp zip file deleted successfully: %s", zipPath)
-			}
-		}
-	}
-	defer cleanup()
-	defer zipFile.Close()
-
-	zipWriter := zip.NewWriter(zipFile)
-	defer zipWriter.Close()
-
-	// 创建SyncMetadata
-	metadata := &SyncMetadata{
-		ClientId:     config.ClientID,
-		CodebaseName: config.CodebaseName,
-		CodebasePath: config.CodebasePath,
-		FileList:     make([]utils.FileStatus, 0),
-		Timestamp:    time.Now().Unix(),
-	}
-
-	// 给FileList设置值，在Windows系统下需要转换路径格式
-	for _, f := range fileStatus {
-		if runtime.GOOS == "windows" {
-			f.Path = filepath.ToSlash(f.Path)
-			if f.Status == utils.FILE_STATUS_RENAME {
-				f.TargetPath = filepath.ToSlash(f.TargetPath)
-			}
-		}
-		metadata.FileList = append(metadata.FileList, *f)
-
-		// 只添加新增和修改的文件到ZIP
-		if f.Status == utils.FILE_STATUS_ADDED || f.Status == utils.FILE_STATUS_MODIFIED {
-			if err := utils.AddFileToZip(zipWriter, f.Path, config.CodebasePath); err != nil {
-				// Continue trying to add other files but log error
-				s.logger.Warn("failed to add file to zip: %s, error: %v", f.Path, err)
-			}
-		}
-	}
-
-	// 添加元数据文件到ZIP
-	metadataJson, err := json.Marshal(metadata)
-	if err != nil {
-		return "", err
-	}
-
-	metadataFilePath := ".shenma_sync/" + time.Now().Format("20060102150405.000000")
-	metadataWriter, err := zipWriter.Create(metadataFilePath)
-	if err != nil {
-		return "", err
-	}
-
-	_, err = metadataWriter.Write(metadataJson)
-	if err != nil {
-		return "", err
-	}
-
-	return zipPath, nil
+	return s.createZipFile(config, fileStatus)
 }
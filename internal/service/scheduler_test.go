@@ -1,9 +1,12 @@
 package service
 
 import (
+	"archive/zip"
+	"bytes"
 	"errors"
 	"os"
 	"path/filepath"
+	"strings"
 	"testing"
 	"time"
 
@@ -295,3 +298,33 @@ func TestUploadChangesZip(t *testing.T) {
 		mockHttpSync.AssertExpectations(t)
 	})
 }
+
+func TestWriteFilesZip(t *testing.T) {
+	mockLogger := &mocks.MockLogger{}
+	mockLogger.On("Warn", mock.Anything, mock.Anything).Return()
+	s := &Scheduler{logger: mockLogger, schedulerConfig: schedulerConfig}
+
+	codebasePath := t.TempDir()
+	if err := os.WriteFile(filepath.Join(codebasePath, "main.go"), []byte("package main"), 0644); err != nil {
+		t.Fatal(err)
+	}
+	config := &config.CodebaseConfig{CodebaseId: "test-id", CodebasePath: codebasePath}
+	changes := []*utils.FileStatus{
+		{Path: "main.go", Status: utils.FILE_STATUS_ADDED},
+		{Path: "removed.go", Status: utils.FILE_STATUS_DELETED},
+	}
+
+	var buf bytes.Buffer
+	assert.NoError(t, s.WriteFilesZip(&buf, config, changes))
+
+	reader, err := zip.NewReader(bytes.NewReader(buf.Bytes()), int64(buf.Len()))
+	assert.NoError(t, err)
+	var names []string
+	for _, f := range reader.File {
+		names = append(names, f.Name)
+	}
+	assert.Len(t, names, 2)
+	assert.Equal(t, "main.go", names[0])
+	assert.True(t, strings.HasPrefix(names[1], ".shenma_sync/"))
+	mockLogger.AssertNotCalled(t, "Warn", mock.Anything, mock.Anything)
+}
@@ -1,12 +1,15 @@
 package service
 
 import (
+	"context"
 	"fmt"
+	"io"
 	"math"
 	"os"
 	"path/filepath"
 	"strconv"
 	"strings"
+	"sync"
 	"time"
 
 	"codebase-indexer/internal/config"
@@ -14,6 +17,8 @@ import (
 	"codebase-indexer/internal/repository"
 	"codebase-indexer/internal/utils"
 	"codebase-indexer/pkg/logger"
+
+	"golang.org/x/time/rate"
 )
 
 // UploadService 文件上传服务接口
@@ -61,6 +66,48 @@ type uploadService struct {
 	logger    logger.Logger
 	config    *config.SyncConfig
 	uploadCfg *UploadConfig
+
+	limitMu sync.Mutex
+	limits  map[string]*workspaceUploadLimit
+}
+
+// workspaceUploadLimit 单个工作区的上传并发和带宽限制
+type workspaceUploadLimit struct {
+	concurrency   int
+	bandwidthKBps int
+	slots         chan struct{}
+	limiter       *rate.Limiter // 为空表示不限速
+}
+
+// rateLimitedWriter 按令牌桶限制写入速度
+type rateLimitedWriter struct {
+	w       io.Writer
+	limiter *rate.Limiter
+}
+
+func (rw *rateLimitedWriter) Write(p []byte) (int, error) {
+	written := 0
+	for len(p) > 0 {
+		n := min(len(p), rw.limiter.Burst())
+		if err := rw.limiter.WaitN(context.Background(), n); err != nil {
+			return written, err
+		}
+		m, err := rw.w.Write(p[:n])
+		written += m
+		if err != nil {
+			return written, err
+		}
+		p = p[n:]
+	}
+	return written, nil
+}
+
+// UploadConcurrency 每个工作区同时上传的请求数
+func UploadConcurrency() int {
+	if n := config.GetClientConfig().Sync.UploadConcurrency; n > 0 {
+		return n
+	}
+	return config.DefaultConfigSync.UploadConcurrency
 }
 
 // NewUploadService 创建文件上传服务
@@ -78,7 +125,67 @@ func NewUploadService(
 		logger:    logger,
 		config:    config,
 		uploadCfg: &uploadCfg,
+		limits:    make(map[string]*workspaceUploadLimit),
+	}
+}
+
+// workspaceLimit 获取工作区的上传限制，配置变化后重新创建
+func (us *uploadService) workspaceLimit(workspacePath string) *workspaceUploadLimit {
+	concurrency := UploadConcurrency()
+	bandwidthKBps := config.GetClientConfig().Sync.UploadBandwidthKBps
+
+	us.limitMu.Lock()
+	defer us.limitMu.Unlock()
+	limit, ok := us.limits[workspacePath]
+	if ok && limit.concurrency == concurrency && limit.bandwidthKBps == bandwidthKBps {
+		return limit
+	}
+	limit = &workspaceUploadLimit{
+		concurrency:   concurrency,
+		bandwidthKBps: bandwidthKBps,
+		slots:         make(chan struct{}, concurrency),
+	}
+	if bandwidthKBps > 0 {
+		bytesPerSecond := bandwidthKBps * 1024
+		limit.limiter = rate.NewLimiter(rate.Limit(bytesPerSecond), max(bytesPerSecond, 32*1024))
+	}
+	us.limits[workspacePath] = limit
+	return limit
+}
+
+// streamUploadChanges 边打包边上传变更文件，受工作区并发和带宽限制
+func (us *uploadService) streamUploadChanges(codebaseConfig *config.CodebaseConfig, changes []*utils.FileStatus,
+	uploadReq dto.UploadReq) error {
+	limit := us.workspaceLimit(codebaseConfig.CodebasePath)
+	limit.slots <- struct{}{}
+	defer func() { <-limit.slots }()
+
+	var size int64
+	for _, change := range changes {
+		if change.Status != utils.FILE_STATUS_ADDED && change.Status != utils.FILE_STATUS_MODIFIED {
+			continue
+		}
+		if info, err := os.Stat(filepath.Join(codebaseConfig.CodebasePath, change.Path)); err == nil {
+			size += info.Size()
+		}
+	}
+
+	body := utils.UploadBody{
+		FileName: codebaseConfig.CodebaseId + ".zip",
+		Size:     size,
+		Write: func(w io.Writer) error {
+			if limit.limiter != nil {
+				w = &rateLimitedWriter{w: w, limiter: limit.limiter}
+			}
+			return us.scheduler.WriteFilesZip(w, codebaseConfig, changes)
+		},
+	}
+	if limit.limiter != nil {
+		// 限速时按带宽预留传输时间
+		body.Timeout = utils.BaseWriteTimeoutSeconds*time.Second +
+			time.Duration(size/int64(limit.bandwidthKBps*1024))*time.Second
 	}
+	return us.syncer.UploadStream(body, uploadReq)
 }
 
 // SetUploadConfig 设置上传配置
@@ -581,21 +688,7 @@ func (us *uploadService) uploadChanges(workspacePath string, changes []*utils.Fi
 		RegisterTime: time.Now(),
 	}
 
-	// 5. 创建ZIP文件
-	zipPath, err := us.scheduler.CreateFilesZip(codebaseConfig, changes)
-	if err != nil {
-		return nil, fmt.Errorf("failed to create zip file: %w", err)
-	}
-	// 清理临时文件
-	defer func() {
-		if zipPath != "" {
-			if err := os.Remove(zipPath); err != nil {
-				us.logger.Warn("failed to delete temp file: %v", err)
-			}
-		}
-	}()
-
-	// 7. 上传文件
+	// 7. 上传文件，ZIP 内容直接写入请求体
 	requestId, err := utils.GenerateUUID()
 	if err != nil {
 		requestId = time.Now().Format("20060102150405.000")
@@ -609,7 +702,7 @@ func (us *uploadService) uploadChanges(workspacePath string, changes []*utils.Fi
 		RequestId:    requestId,
 		UploadToken:  tokenResp.Data.Token,
 	}
-	err = us.syncer.UploadFile(zipPath, uploadReq)
+	err = us.streamUploadChanges(codebaseConfig, changes, uploadReq)
 	if err != nil {
 		return nil, fmt.Errorf("failed to upload file: %w", err)
 	}
@@ -635,21 +728,7 @@ func (us *uploadService) uploadChangesWithToken(workspacePath string, changes []
 		RegisterTime: time.Now(),
 	}
 
-	// 5. 创建ZIP文件
-	zipPath, err := us.scheduler.CreateFilesZip(codebaseConfig, changes)
-	if err != nil {
-		return nil, fmt.Errorf("failed to create zip file: %w", err)
-	}
-	// 清理临时文件
-	defer func() {
-		if zipPath != "" {
-			if err := os.Remove(zipPath); err != nil {
-				us.logger.Warn("failed to delete temp file: %v", err)
-			}
-		}
-	}()
-
-	// 7. 上传文件
+	// 7. 上传文件，ZIP 内容直接写入请求体
 	requestId, err := utils.GenerateUUID()
 	if err != nil {
 		requestId = time.Now().Format("20060102150405.000")
@@ -663,7 +742,7 @@ func (us *uploadService) uploadChangesWithToken(workspacePath string, changes []
 		RequestId:    requestId,
 		UploadToken:  token,
 	}
-	err = us.syncer.UploadFile(zipPath, uploadReq)
+	err = us.streamUploadChanges(codebaseConfig, changes, uploadReq)
 	if err != nil {
 		return nil, fmt.Errorf("failed to upload file: %w", err)
 	}
@@ -0,0 +1,364 @@
+// utils/file_tree.go - Directory-level Merkle tree for change detection
+package utils
+
+import (
+	"bufio"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"hash/crc64"
+	"io"
+	"os"
+	"path/filepath"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+const (
+	fileTreeMagic      = "CFT1"
+	maxFileTreeDepth   = 512
+	maxFileTreeNameLen = 4096 // 节点名称长度上限，与 PATH_MAX 一致，防止损坏的文件导致超大分配
+)
+
+var crc64Table = crc64.MakeTable(crc64.ECMA)
+
+// FileTreeNode 文件树节点。文件的 Hash 为内容哈希，修改时间和大小不变时直接复用；
+// 目录的 Hash 由子节点的名称和哈希计算，子树没有变化时 Hash 不变
+type FileTreeNode struct {
+	Name     string
+	IsDir    bool
+	ModTime  int64 // 修改时间，毫秒
+	Size     int64
+	Hash     uint64
+	Children []*FileTreeNode // 按名称排序
+}
+
+// FileTree 代码库文件的目录级 Merkle 树
+type FileTree struct {
+	Root  *FileTreeNode
+	files int
+}
+
+// NewFileTree 创建空树
+func NewFileTree() *FileTree {
+	return &FileTree{Root: &FileTreeNode{IsDir: true}}
+}
+
+// FormatFileHash 文件哈希的字符串形式，作为变更事件和哈希表中的值
+func FormatFileHash(hash uint64) string {
+	return fmt.Sprintf("%016x", hash)
+}
+
+// HashFileContent 计算文件内容哈希
+func HashFileContent(path string) (uint64, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return 0, fmt.Errorf("failed to open file %s: %v", path, err)
+	}
+	defer file.Close()
+	hash := crc64.New(crc64Table)
+	if _, err := io.Copy(hash, file); err != nil {
+		return 0, fmt.Errorf("failed to hash file %s: %v", path, err)
+	}
+	return hash.Sum64(), nil
+}
+
+// Lookup 按相对路径查找节点，不存在时返回 nil
+func (t *FileTree) Lookup(relPath string) *FileTreeNode {
+	if t == nil || t.Root == nil {
+		return nil
+	}
+	node := t.Root
+	for _, name := range splitRelPath(relPath) {
+		node = node.child(name)
+		if node == nil {
+			return nil
+		}
+	}
+	return node
+}
+
+// Add 添加文件，构建完成后需调用 Seal 计算目录哈希
+func (t *FileTree) Add(relPath string, modTime, size int64, hash uint64) {
+	names := splitRelPath(relPath)
+	if len(names) == 0 {
+		return
+	}
+	node := t.Root
+	for _, name := range names[:len(names)-1] {
+		next := node.child(name)
+		if next == nil {
+			next = &FileTreeNode{Name: name, IsDir: true}
+			node.Children = append(node.Children, next)
+		}
+		node = next
+	}
+	node.Children = append(node.Children, &FileTreeNode{
+		Name: names[len(names)-1], ModTime: modTime, Size: size, Hash: hash,
+	})
+	t.files++
+}
+
+// Seal 子节点排序并自底向上计算目录哈希
+func (t *FileTree) Seal() {
+	sealNode(t.Root)
+}
+
+func sealNode(node *FileTreeNode) {
+	if !node.IsDir {
+		return
+	}
+	sort.Slice(node.Children, func(i, j int) bool { return node.Children[i].Name < node.Children[j].Name })
+	hash := crc64.New(crc64Table)
+	var buf [8]byte
+	for _, child := range node.Children {
+		sealNode(child)
+		_, _ = io.WriteString(hash, child.Name)
+		binary.BigEndian.PutUint64(buf[:], child.Hash)
+		_, _ = hash.Write(buf[:])
+		if child.IsDir {
+			_, _ = hash.Write([]byte{1})
+		} else {
+			_, _ = hash.Write([]byte{0})
+		}
+	}
+	node.Hash = hash.Sum64()
+}
+
+// RootHash 整棵树的哈希
+func (t *FileTree) RootHash() uint64 {
+	if t == nil || t.Root == nil {
+		return 0
+	}
+	return t.Root.Hash
+}
+
+// FileCount 文件数
+func (t *FileTree) FileCount() int {
+	if t == nil {
+		return 0
+	}
+	return t.files
+}
+
+// FileHashes 展开为 相对路径 -> 文件哈希
+func (t *FileTree) FileHashes() map[string]string {
+	hashes := make(map[string]string, t.FileCount())
+	if t == nil || t.Root == nil {
+		return hashes
+	}
+	walkFiles(t.Root, "", func(relPath string, node *FileTreeNode) {
+		hashes[relPath] = FormatFileHash(node.Hash)
+	})
+	return hashes
+}
+
+// DiffFileTrees 比较新旧两棵树，哈希相同的子树直接跳过。旧树为 nil 时新树的文件全部为新增
+func DiffFileTrees(old, new *FileTree) []*FileStatus {
+	var changes []*FileStatus
+	var oldRoot, newRoot *FileTreeNode
+	if old != nil {
+		oldRoot = old.Root
+	}
+	if new != nil {
+		newRoot = new.Root
+	}
+	diffNodes(oldRoot, newRoot, "", &changes)
+	return changes
+}
+
+func diffNodes(old, new *FileTreeNode, relPath string, changes *[]*FileStatus) {
+	switch {
+	case old == nil && new == nil:
+		return
+	case old == nil:
+		walkFiles(new, relPath, func(p string, n *FileTreeNode) {
+			*changes = append(*changes, &FileStatus{Path: p, Hash: FormatFileHash(n.Hash),
+				Status: FILE_STATUS_ADDED})
+		})
+		return
+	case new == nil:
+		walkFiles(old, relPath, func(p string, _ *FileTreeNode) {
+			*changes = append(*changes, &FileStatus{Path: p, Status: FILE_STATUS_DELETED})
+		})
+		return
+	case old.IsDir != new.IsDir:
+		diffNodes(old, nil, relPath, changes)
+		diffNodes(nil, new, relPath, changes)
+		return
+	case old.Hash == new.Hash:
+		return
+	case !new.IsDir:
+		*changes = append(*changes, &FileStatus{Path: relPath, Hash: FormatFileHash(new.Hash),
+			Status: FILE_STATUS_MODIFIED})
+		return
+	}
+
+	// 两个目录的子节点均按名称排序，归并比较
+	i, j := 0, 0
+	for i < len(old.Children) || j < len(new.Children) {
+		switch {
+		case j >= len(new.Children) || (i < len(old.Children) && old.Children[i].Name < new.Children[j].Name):
+			diffNodes(old.Children[i], nil, joinRelPath(relPath, old.Children[i].Name), changes)
+			i++
+		case i >= len(old.Children) || new.Children[j].Name < old.Children[i].Name:
+			diffNodes(nil, new.Children[j], joinRelPath(relPath, new.Children[j].Name), changes)
+			j++
+		default:
+			diffNodes(old.Children[i], new.Children[j], joinRelPath(relPath, new.Children[j].Name), changes)
+			i++
+			j++
+		}
+	}
+}
+
+func walkFiles(node *FileTreeNode, relPath string, fn func(relPath string, node *FileTreeNode)) {
+	if !node.IsDir {
+		fn(relPath, node)
+		return
+	}
+	for _, child := range node.Children {
+		walkFiles(child, joinRelPath(relPath, child.Name), fn)
+	}
+}
+
+func (n *FileTreeNode) child(name string) *FileTreeNode {
+	// 构建期间子节点未排序，按顺序查找；Seal 之后可二分
+	children := n.Children
+	if k := sort.Search(len(children), func(i int) bool { return children[i].Name >= name }); k < len(children) &&
+		children[k].Name == name {
+		return children[k]
+	}
+	for _, c := range children {
+		if c.Name == name {
+			return c
+		}
+	}
+	return nil
+}
+
+func splitRelPath(relPath string) []string {
+	relPath = filepath.Clean(relPath)
+	if relPath == "." || relPath == "" {
+		return nil
+	}
+	return strings.Split(relPath, string(filepath.Separator))
+}
+
+func joinRelPath(dir, name string) string {
+	if dir == "" {
+		return name
+	}
+	return dir + string(filepath.Separator) + name
+}
+
+// WriteTo 以紧凑的二进制格式写出：魔数后按先序排列节点，
+// 每个节点为 名称长度、名称、是否目录、修改时间、大小、哈希、子节点数
+func (t *FileTree) WriteTo(w io.Writer) (int64, error) {
+	bw := bufio.NewWriter(w)
+	n, err := bw.WriteString(fileTreeMagic)
+	written := int64(n)
+	if err != nil {
+		return written, err
+	}
+	buf := make([]byte, 0, 64)
+	var writeNode func(node *FileTreeNode) error
+	writeNode = func(node *FileTreeNode) error {
+		buf = binary.AppendUvarint(buf[:0], uint64(len(node.Name)))
+		buf = append(buf, node.Name...)
+		if node.IsDir {
+			buf = append(buf, 1)
+		} else {
+			buf = append(buf, 0)
+		}
+		buf = binary.AppendVarint(buf, node.ModTime)
+		buf = binary.AppendVarint(buf, node.Size)
+		buf = binary.BigEndian.AppendUint64(buf, node.Hash)
+		buf = binary.AppendUvarint(buf, uint64(len(node.Children)))
+		n, err := bw.Write(buf)
+		written += int64(n)
+		if err != nil {
+			return err
+		}
+		for _, child := range node.Children {
+			if err := writeNode(child); err != nil {
+				return err
+			}
+		}
+		return nil
+	}
+	if err = writeNode(t.Root); err != nil {
+		return written, err
+	}
+	return written, bw.Flush()
+}
+
+// ReadFileTree 读取 WriteTo 写出的树
+func ReadFileTree(r io.Reader) (*FileTree, error) {
+	br := bufio.NewReader(r)
+	magic := make([]byte, len(fileTreeMagic))
+	if _, err := io.ReadFull(br, magic); err != nil {
+		return nil, fmt.Errorf("failed to read file tree header: %v", err)
+	}
+	if string(magic) != fileTreeMagic {
+		return nil, fmt.Errorf("invalid file tree header %s", strconv.Quote(string(magic)))
+	}
+	tree := &FileTree{}
+	var readNode func(depth int) (*FileTreeNode, error)
+	readNode = func(depth int) (*FileTreeNode, error) {
+		if depth > maxFileTreeDepth {
+			return nil, errors.New("file tree too deep")
+		}
+		nameLen, err := binary.ReadUvarint(br)
+		if err != nil {
+			return nil, err
+		}
+		if nameLen > maxFileTreeNameLen {
+			return nil, fmt.Errorf("file tree node name too long: %d", nameLen)
+		}
+		name := make([]byte, nameLen)
+		if _, err = io.ReadFull(br, name); err != nil {
+			return nil, err
+		}
+		isDir, err := br.ReadByte()
+		if err != nil {
+			return nil, err
+		}
+		node := &FileTreeNode{Name: string(name), IsDir: isDir == 1}
+		if node.ModTime, err = binary.ReadVarint(br); err != nil {
+			return nil, err
+		}
+		if node.Size, err = binary.ReadVarint(br); err != nil {
+			return nil, err
+		}
+		var hash [8]byte
+		if _, err = io.ReadFull(br, hash[:]); err != nil {
+			return nil, err
+		}
+		node.Hash = binary.BigEndian.Uint64(hash[:])
+		count, err := binary.ReadUvarint(br)
+		if err != nil {
+			return nil, err
+		}
+		if !node.IsDir {
+			tree.files++
+			return node, nil
+		}
+		node.Children = make([]*FileTreeNode, 0, min(count, 1024))
+		for i := uint64(0); i < count; i++ {
+			child, err := readNode(depth + 1)
+			if err != nil {
+				return nil, err
+			}
+			node.Children = append(node.Children, child)
+		}
+		return node, nil
+	}
+	root, err := readNode(0)
+	if err != nil {
+		return nil, fmt.Errorf("failed to read file tree: %v", err)
+	}
+	tree.Root = root
+	return tree, nil
+}
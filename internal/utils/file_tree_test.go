@@ -0,0 +1,95 @@
+package utils
+
+import (
+	"bytes"
+	"encoding/binary"
+	"path/filepath"
+	"sort"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func buildFileTree(files map[string]uint64) *FileTree {
+	tree := NewFileTree()
+	for path, hash := range files {
+		tree.Add(path, 1000, 10, hash)
+	}
+	tree.Seal()
+	return tree
+}
+
+func sortedChanges(changes []*FileStatus) []FileStatus {
+	result := make([]FileStatus, 0, len(changes))
+	for _, c := range changes {
+		result = append(result, *c)
+	}
+	sort.Slice(result, func(i, j int) bool { return result[i].Path < result[j].Path })
+	return result
+}
+
+func TestFileTree(t *testing.T) {
+	mainGo := filepath.Join("src", "main.go")
+	utilsGo := filepath.Join("src", "pkg", "utils.go")
+	readme := "README.md"
+	docGo := filepath.Join("docs", "doc.go")
+
+	old := buildFileTree(map[string]uint64{mainGo: 1, utilsGo: 2, readme: 3})
+
+	t.Run("directory hash ignores insertion order", func(t *testing.T) {
+		tree := NewFileTree()
+		tree.Add(readme, 1000, 10, 3)
+		tree.Add(utilsGo, 1000, 10, 2)
+		tree.Add(mainGo, 1000, 10, 1)
+		tree.Seal()
+		assert.Equal(t, old.RootHash(), tree.RootHash())
+		assert.Empty(t, DiffFileTrees(old, tree))
+	})
+
+	t.Run("diff", func(t *testing.T) {
+		current := buildFileTree(map[string]uint64{mainGo: 1, utilsGo: 20, docGo: 4})
+		assert.Equal(t, old.Lookup("src").Children[0].Hash, current.Lookup("src").Children[0].Hash)
+		assert.NotEqual(t, old.RootHash(), current.RootHash())
+
+		assert.Equal(t, []FileStatus{
+			{Path: docGo, Hash: FormatFileHash(4), Status: FILE_STATUS_ADDED},
+			{Path: readme, Status: FILE_STATUS_DELETED},
+			{Path: utilsGo, Hash: FormatFileHash(20), Status: FILE_STATUS_MODIFIED},
+		}, sortedChanges(DiffFileTrees(old, current)))
+
+		// 旧树为空时全部为新增
+		assert.Len(t, DiffFileTrees(nil, current), 3)
+	})
+
+	t.Run("file hashes", func(t *testing.T) {
+		assert.Equal(t, map[string]string{
+			mainGo:  FormatFileHash(1),
+			utilsGo: FormatFileHash(2),
+			readme:  FormatFileHash(3),
+		}, old.FileHashes())
+		assert.Nil(t, old.Lookup(filepath.Join("src", "missing.go")))
+		assert.Equal(t, int64(10), old.Lookup(mainGo).Size)
+	})
+
+	t.Run("binary round trip", func(t *testing.T) {
+		var buf bytes.Buffer
+		_, err := old.WriteTo(&buf)
+		require.NoError(t, err)
+
+		loaded, err := ReadFileTree(&buf)
+		require.NoError(t, err)
+		assert.Equal(t, old.RootHash(), loaded.RootHash())
+		assert.Equal(t, old.FileCount(), loaded.FileCount())
+		assert.Equal(t, old.FileHashes(), loaded.FileHashes())
+		assert.Empty(t, DiffFileTrees(old, loaded))
+
+		_, err = ReadFileTree(bytes.NewReader([]byte("{}")))
+		assert.Error(t, err)
+
+		// 损坏的名称长度不应触发超大分配
+		corrupt := append([]byte(fileTreeMagic), binary.AppendUvarint(nil, 1<<40)...)
+		_, err = ReadFileTree(bytes.NewReader(corrupt))
+		assert.ErrorContains(t, err, "name too long")
+	})
+}
@@ -109,6 +109,14 @@ type MultipartFile struct {
 	Reader   io.Reader // 文件读取器
 }
 
+// UploadBody 流式上传的文件内容，Write 在每次上传时重新生成内容，不落盘
+type UploadBody struct {
+	FileName string
+	Size     int64         // 预估大小，用于计算超时
+	Timeout  time.Duration // 为 0 时按 Size 计算
+	Write    func(w io.Writer) error
+}
+
 // HTTPError HTTP错误结构
 type HTTPError struct {
 	StatusCode int    // HTTP状态码
@@ -222,6 +230,44 @@ func (hc *HTTPClient) DoHTTPRequest(req *HTTPRequest, token string) (*HTTPRespon
 		return nil, fmt.Errorf("failed to send request: %v", err)
 	}
 
+	return hc.buildHTTPResponse(resp)
+}
+
+// DoStreamRequest 以流式请求体执行HTTP请求，bodySize 为 -1 时使用分块传输，超时按单个请求设置
+func (hc *HTTPClient) DoStreamRequest(req *HTTPRequest, body io.Reader, bodySize int, token string) (*HTTPResponse, error) {
+	httpReq := fasthttp.AcquireRequest()
+	resp := fasthttp.AcquireResponse()
+	defer func() {
+		fasthttp.ReleaseRequest(httpReq)
+		fasthttp.ReleaseResponse(resp)
+	}()
+
+	httpReq.SetRequestURI(req.URL)
+	httpReq.Header.SetMethod(req.Method)
+	for key, value := range req.Headers {
+		httpReq.Header.Set(key, value)
+	}
+	httpReq.Header.Set("Authorization", "Bearer "+token)
+	for key, value := range req.QueryParams {
+		httpReq.URI().QueryArgs().Add(key, value)
+	}
+	if req.ContentType != "" {
+		httpReq.Header.SetContentType(req.ContentType)
+	}
+	httpReq.SetBodyStream(body, bodySize)
+	if req.Timeout > 0 {
+		httpReq.SetTimeout(req.Timeout)
+	}
+
+	if err := hc.httpClient.Do(httpReq, resp); err != nil {
+		return nil, fmt.Errorf("failed to send request: %v", err)
+	}
+
+	return hc.buildHTTPResponse(resp)
+}
+
+// buildHTTPResponse 复制响应内容，非 2xx 状态返回错误
+func (hc *HTTPClient) buildHTTPResponse(resp *fasthttp.Response) (*HTTPResponse, error) {
 	// 处理响应
 	response := &HTTPResponse{
 		StatusCode: resp.StatusCode(),
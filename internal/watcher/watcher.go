@@ -0,0 +1,301 @@
+// watcher/watcher.go - Native file system watcher for workspaces
+package watcher
+
+import (
+	"errors"
+	"fmt"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+
+	"codebase-indexer/pkg/logger"
+)
+
+// ErrUnsupported 当前平台不支持文件监听，调用方继续使用定时全量扫描
+var ErrUnsupported = errors.New("file watching is not supported on this platform")
+
+const (
+	defaultDebounce   = 500 * time.Millisecond
+	defaultMaxDelay   = 5 * time.Second
+	defaultMaxPending = 10000
+	readyQueueSize    = 64
+)
+
+// Filter 返回 true 表示忽略该路径，relPath 为相对工作区根目录的路径
+type Filter func(relPath string, isDir bool) bool
+
+// Options 监听参数
+type Options struct {
+	Debounce   time.Duration // 最后一次变更后静默多久再回调
+	MaxDelay   time.Duration // 持续变更时最长多久回调一次
+	MaxPending int           // 单个工作区合并的路径数上限，超过后改为全量扫描
+	// OnChanges 回调合并后的变更路径，同一时刻只有一个回调在执行
+	OnChanges func(root string, relPaths []string)
+	// OnOverflow 系统事件队列溢出或变更过多，可能丢失了变更，需全量扫描
+	OnOverflow func(root string)
+}
+
+// rawEvent 平台实现上报的原始事件，path 为绝对路径
+type rawEvent struct {
+	root     string
+	path     string
+	overflow bool
+}
+
+// backend 平台相关的监听实现
+type backend interface {
+	add(root string, filter Filter) error
+	remove(root string) error
+	close() error
+}
+
+type pendingChanges struct {
+	paths    map[string]struct{}
+	overflow bool
+	first    time.Time
+	last     time.Time
+}
+
+type changeBatch struct {
+	root     string
+	paths    []string
+	overflow bool
+}
+
+// Watcher 监听多个工作区，按工作区合并一段时间内的变更后批量回调
+type Watcher struct {
+	opts    Options
+	logger  logger.Logger
+	backend backend
+	events  chan rawEvent
+	ready   chan changeBatch
+
+	mu    sync.RWMutex
+	roots map[string]Filter
+
+	done      chan struct{}
+	wg        sync.WaitGroup
+	closeOnce sync.Once
+}
+
+// NewWatcher 创建监听器，平台不支持时返回 ErrUnsupported
+func NewWatcher(logger logger.Logger, opts Options) (*Watcher, error) {
+	events := make(chan rawEvent, 1024)
+	b, err := newBackend(events, logger)
+	if err != nil {
+		return nil, err
+	}
+	return newWatcher(logger, opts, b, events), nil
+}
+
+func newWatcher(logger logger.Logger, opts Options, b backend, events chan rawEvent) *Watcher {
+	if opts.Debounce <= 0 {
+		opts.Debounce = defaultDebounce
+	}
+	if opts.MaxDelay < opts.Debounce {
+		opts.MaxDelay = max(defaultMaxDelay, opts.Debounce)
+	}
+	if opts.MaxPending <= 0 {
+		opts.MaxPending = defaultMaxPending
+	}
+	w := &Watcher{
+		opts:    opts,
+		logger:  logger,
+		backend: b,
+		events:  events,
+		ready:   make(chan changeBatch, readyQueueSize),
+		roots:   make(map[string]Filter),
+		done:    make(chan struct{}),
+	}
+	w.wg.Add(2)
+	go w.loop()
+	go w.dispatch()
+	return w
+}
+
+// Watch 开始监听工作区，filter 过滤的目录不监听，其中的变更不回调
+func (w *Watcher) Watch(root string, filter Filter) error {
+	root = filepath.Clean(root)
+	if filter == nil {
+		filter = func(string, bool) bool { return false }
+	}
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if _, ok := w.roots[root]; ok {
+		return nil
+	}
+	if err := w.backend.add(root, filter); err != nil {
+		return fmt.Errorf("failed to watch %s: %w", root, err)
+	}
+	w.roots[root] = filter
+	w.logger.Info("watching workspace: %s", root)
+	return nil
+}
+
+// Unwatch 停止监听工作区
+func (w *Watcher) Unwatch(root string) {
+	root = filepath.Clean(root)
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if _, ok := w.roots[root]; !ok {
+		return
+	}
+	delete(w.roots, root)
+	if err := w.backend.remove(root); err != nil {
+		w.logger.Warn("failed to unwatch %s: %v", root, err)
+	}
+	w.logger.Info("stopped watching workspace: %s", root)
+}
+
+// Watching 工作区是否在监听中
+func (w *Watcher) Watching(root string) bool {
+	w.mu.RLock()
+	defer w.mu.RUnlock()
+	_, ok := w.roots[filepath.Clean(root)]
+	return ok
+}
+
+// Close 停止全部监听，等待正在执行的回调结束
+func (w *Watcher) Close() error {
+	var err error
+	w.closeOnce.Do(func() {
+		err = w.backend.close()
+		close(w.done)
+		w.wg.Wait()
+	})
+	return err
+}
+
+// loop 按工作区合并事件：最后一次变更后静默 Debounce 或首次变更后达到 MaxDelay 时提交
+func (w *Watcher) loop() {
+	defer w.wg.Done()
+	defer close(w.ready)
+	pending := make(map[string]*pendingChanges)
+	var ticker *time.Ticker
+	var tick <-chan time.Time
+	defer func() {
+		if ticker != nil {
+			ticker.Stop()
+		}
+	}()
+
+	for {
+		select {
+		case <-w.done:
+			return
+		case ev := <-w.events:
+			if !w.accept(pending, ev) {
+				continue
+			}
+			if ticker == nil {
+				ticker = time.NewTicker(max(w.opts.Debounce/4, 10*time.Millisecond))
+				tick = ticker.C
+			}
+		case now := <-tick:
+			w.flush(pending, now)
+			if len(pending) == 0 {
+				ticker.Stop()
+				ticker, tick = nil, nil
+			}
+		}
+	}
+}
+
+// accept 记录事件，返回是否产生了待提交的变更
+func (w *Watcher) accept(pending map[string]*pendingChanges, ev rawEvent) bool {
+	w.mu.RLock()
+	filter, ok := w.roots[ev.root]
+	w.mu.RUnlock()
+	if !ok {
+		return false
+	}
+	p := pending[ev.root]
+	if p == nil {
+		now := time.Now()
+		p = &pendingChanges{paths: make(map[string]struct{}), first: now}
+		pending[ev.root] = p
+	}
+	p.last = time.Now()
+	if ev.overflow {
+		p.overflow = true
+		p.paths = make(map[string]struct{})
+		return true
+	}
+	if p.overflow {
+		return true
+	}
+	relPath, err := filepath.Rel(ev.root, ev.path)
+	if err != nil || relPath == "." || strings.HasPrefix(relPath, "..") || ignored(filter, relPath) {
+		if len(p.paths) == 0 {
+			delete(pending, ev.root)
+			return false
+		}
+		return true
+	}
+	p.paths[relPath] = struct{}{}
+	if len(p.paths) > w.opts.MaxPending {
+		p.overflow = true
+		p.paths = make(map[string]struct{})
+	}
+	return true
+}
+
+// ignored 路径本身或任一上级目录被过滤
+func ignored(filter Filter, relPath string) bool {
+	for dir := filepath.Dir(relPath); dir != "." && dir != string(filepath.Separator); dir = filepath.Dir(dir) {
+		if filter(dir, true) {
+			return true
+		}
+	}
+	return false
+}
+
+func (w *Watcher) flush(pending map[string]*pendingChanges, now time.Time) {
+	for root, p := range pending {
+		if now.Sub(p.last) < w.opts.Debounce && now.Sub(p.first) < w.opts.MaxDelay {
+			continue
+		}
+		batch := changeBatch{root: root, overflow: p.overflow}
+		if !p.overflow {
+			batch.paths = make([]string, 0, len(p.paths))
+			for path := range p.paths {
+				batch.paths = append(batch.paths, path)
+			}
+		}
+		// 回调繁忙时保留变更继续合并，下次再提交
+		select {
+		case w.ready <- batch:
+			delete(pending, root)
+		default:
+		}
+	}
+}
+
+func (w *Watcher) dispatch() {
+	defer w.wg.Done()
+	for batch := range w.ready {
+		w.handle(batch)
+	}
+}
+
+func (w *Watcher) handle(batch changeBatch) {
+	defer func() {
+		if r := recover(); r != nil {
+			w.logger.Error("recovered from panic in file watcher callback: %v", r)
+		}
+	}()
+	if !w.Watching(batch.root) {
+		return
+	}
+	if batch.overflow {
+		w.logger.Info("too many changes or event overflow in workspace %s, need full scan", batch.root)
+		if w.opts.OnOverflow != nil {
+			w.opts.OnOverflow(batch.root)
+		}
+		return
+	}
+	if len(batch.paths) > 0 && w.opts.OnChanges != nil {
+		w.opts.OnChanges(batch.root, batch.paths)
+	}
+}
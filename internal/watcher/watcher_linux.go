@@ -0,0 +1,230 @@
+//go:build linux
+
+package watcher
+
+import (
+	"errors"
+	"fmt"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"syscall"
+	"unsafe"
+
+	"codebase-indexer/pkg/logger"
+)
+
+const inotifyMask = syscall.IN_CREATE | syscall.IN_DELETE | syscall.IN_MODIFY | syscall.IN_CLOSE_WRITE |
+	syscall.IN_MOVED_FROM | syscall.IN_MOVED_TO | syscall.IN_DELETE_SELF | syscall.IN_MOVE_SELF
+
+type inotifyWatch struct {
+	root string
+	dir  string
+}
+
+// inotifyBackend inotify 只监听单层目录，每个未被过滤的子目录单独添加监听，新建的目录在事件中补充监听
+type inotifyBackend struct {
+	file   *os.File
+	fd     int
+	events chan<- rawEvent
+	logger logger.Logger
+
+	mu      sync.Mutex
+	watches map[int32]inotifyWatch
+	dirs    map[string]int32
+	filters map[string]Filter
+
+	done chan struct{}
+	wg   sync.WaitGroup
+}
+
+func newBackend(events chan<- rawEvent, logger logger.Logger) (backend, error) {
+	fd, err := syscall.InotifyInit1(syscall.IN_CLOEXEC | syscall.IN_NONBLOCK)
+	if err != nil {
+		return nil, fmt.Errorf("failed to init inotify: %w", err)
+	}
+	b := &inotifyBackend{
+		// 非阻塞的 fd 由运行时轮询，Close 可以唤醒阻塞中的 Read
+		file:    os.NewFile(uintptr(fd), "inotify"),
+		fd:      fd,
+		events:  events,
+		logger:  logger,
+		watches: make(map[int32]inotifyWatch),
+		dirs:    make(map[string]int32),
+		filters: make(map[string]Filter),
+		done:    make(chan struct{}),
+	}
+	b.wg.Add(1)
+	go b.readEvents()
+	return b, nil
+}
+
+func (b *inotifyBackend) add(root string, filter Filter) error {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	b.filters[root] = filter
+	if err := b.addTreeLocked(root, root, nil); err != nil {
+		b.removeLocked(root)
+		if errors.Is(err, syscall.ENOSPC) {
+			return fmt.Errorf("%w, increase fs.inotify.max_user_watches", err)
+		}
+		return err
+	}
+	return nil
+}
+
+// addTreeLocked 监听 dir 及其未被过滤的子目录，found 非空时上报目录中已有的文件
+func (b *inotifyBackend) addTreeLocked(root, dir string, found func(path string)) error {
+	filter := b.filters[root]
+	return filepath.WalkDir(dir, func(path string, d fs.DirEntry, err error) error {
+		if err != nil {
+			if path == dir {
+				return err
+			}
+			return nil
+		}
+		if !d.IsDir() {
+			if found != nil {
+				found(path)
+			}
+			return nil
+		}
+		if path != root {
+			if relPath, err := filepath.Rel(root, path); err == nil && filter(relPath, true) {
+				return fs.SkipDir
+			}
+		}
+		if _, ok := b.dirs[path]; ok {
+			return nil
+		}
+		wd, err := syscall.InotifyAddWatch(b.fd, path, inotifyMask|syscall.IN_ONLYDIR)
+		if err != nil {
+			if errors.Is(err, syscall.ENOSPC) || path == dir {
+				return err
+			}
+			b.logger.Warn("failed to watch directory %s: %v", path, err)
+			return fs.SkipDir
+		}
+		b.watches[int32(wd)] = inotifyWatch{root: root, dir: path}
+		b.dirs[path] = int32(wd)
+		return nil
+	})
+}
+
+func (b *inotifyBackend) remove(root string) error {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	b.removeLocked(root)
+	return nil
+}
+
+func (b *inotifyBackend) removeLocked(root string) {
+	for wd, watch := range b.watches {
+		if watch.root != root {
+			continue
+		}
+		_, _ = syscall.InotifyRmWatch(b.fd, uint32(wd))
+		delete(b.watches, wd)
+		delete(b.dirs, watch.dir)
+	}
+	delete(b.filters, root)
+}
+
+func (b *inotifyBackend) close() error {
+	close(b.done)
+	err := b.file.Close()
+	b.wg.Wait()
+	return err
+}
+
+func (b *inotifyBackend) send(ev rawEvent) bool {
+	select {
+	case b.events <- ev:
+		return true
+	case <-b.done:
+		return false
+	}
+}
+
+func (b *inotifyBackend) readEvents() {
+	defer b.wg.Done()
+	buf := make([]byte, 64*1024)
+	for {
+		n, err := b.file.Read(buf)
+		if err != nil {
+			if !errors.Is(err, os.ErrClosed) {
+				b.logger.Error("failed to read inotify events: %v", err)
+			}
+			return
+		}
+		for offset := 0; offset+syscall.SizeofInotifyEvent <= n; {
+			raw := (*syscall.InotifyEvent)(unsafe.Pointer(&buf[offset]))
+			nameStart := offset + syscall.SizeofInotifyEvent
+			nameEnd := nameStart + int(raw.Len)
+			if nameEnd > n {
+				break
+			}
+			name := strings.TrimRight(string(buf[nameStart:nameEnd]), "\x00")
+			if !b.handle(raw.Wd, raw.Mask, name) {
+				return
+			}
+			offset = nameEnd
+		}
+	}
+}
+
+func (b *inotifyBackend) handle(wd int32, mask uint32, name string) bool {
+	if mask&syscall.IN_Q_OVERFLOW != 0 {
+		b.mu.Lock()
+		roots := make([]string, 0, len(b.filters))
+		for root := range b.filters {
+			roots = append(roots, root)
+		}
+		b.mu.Unlock()
+		for _, root := range roots {
+			if !b.send(rawEvent{root: root, overflow: true}) {
+				return false
+			}
+		}
+		return true
+	}
+
+	b.mu.Lock()
+	watch, ok := b.watches[wd]
+	if !ok {
+		b.mu.Unlock()
+		return true
+	}
+	if mask&syscall.IN_IGNORED != 0 {
+		delete(b.watches, wd)
+		if b.dirs[watch.dir] == wd {
+			delete(b.dirs, watch.dir)
+		}
+		b.mu.Unlock()
+		return true
+	}
+	path := watch.dir
+	if name != "" {
+		path = filepath.Join(watch.dir, name)
+	}
+	// 新建或移入的目录补充监听，监听生效前写入的文件一并上报
+	var found []string
+	if mask&syscall.IN_ISDIR != 0 && mask&(syscall.IN_CREATE|syscall.IN_MOVED_TO) != 0 {
+		if err := b.addTreeLocked(watch.root, path, func(p string) { found = append(found, p) }); err != nil {
+			b.logger.Warn("failed to watch new directory %s: %v", path, err)
+		}
+	}
+	b.mu.Unlock()
+
+	if !b.send(rawEvent{root: watch.root, path: path}) {
+		return false
+	}
+	for _, p := range found {
+		if !b.send(rawEvent{root: watch.root, path: p}) {
+			return false
+		}
+	}
+	return true
+}
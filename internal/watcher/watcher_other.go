@@ -0,0 +1,9 @@
+//go:build !linux && !windows
+
+package watcher
+
+import "codebase-indexer/pkg/logger"
+
+func newBackend(events chan<- rawEvent, logger logger.Logger) (backend, error) {
+	return nil, ErrUnsupported
+}
@@ -0,0 +1,143 @@
+package watcher
+
+import (
+	"errors"
+	"os"
+	"path/filepath"
+	"sort"
+	"sync"
+	"testing"
+	"time"
+
+	"codebase-indexer/test/mocks"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/mock"
+	"github.com/stretchr/testify/require"
+)
+
+type fakeBackend struct{}
+
+func (fakeBackend) add(string, Filter) error { return nil }
+func (fakeBackend) remove(string) error      { return nil }
+func (fakeBackend) close() error             { return nil }
+
+type recorder struct {
+	mu        sync.Mutex
+	changes   [][]string
+	overflows []string
+	notify    chan struct{}
+}
+
+func newRecorder() *recorder {
+	return &recorder{notify: make(chan struct{}, 16)}
+}
+
+func (r *recorder) options(debounce time.Duration) Options {
+	return Options{
+		Debounce:   debounce,
+		MaxDelay:   time.Second,
+		MaxPending: 3,
+		OnChanges: func(root string, relPaths []string) {
+			sort.Strings(relPaths)
+			r.mu.Lock()
+			r.changes = append(r.changes, relPaths)
+			r.mu.Unlock()
+			r.notify <- struct{}{}
+		},
+		OnOverflow: func(root string) {
+			r.mu.Lock()
+			r.overflows = append(r.overflows, root)
+			r.mu.Unlock()
+			r.notify <- struct{}{}
+		},
+	}
+}
+
+func (r *recorder) wait(t *testing.T) {
+	t.Helper()
+	select {
+	case <-r.notify:
+	case <-time.After(5 * time.Second):
+		t.Fatal("timed out waiting for watcher callback")
+	}
+}
+
+func newTestLogger() *mocks.MockLogger {
+	logger := &mocks.MockLogger{}
+	logger.On("Info", mock.Anything, mock.Anything).Return()
+	logger.On("Warn", mock.Anything, mock.Anything).Return()
+	logger.On("Error", mock.Anything, mock.Anything).Return()
+	return logger
+}
+
+func TestWatcherCoalesce(t *testing.T) {
+	root := filepath.Join(string(filepath.Separator), "workspace")
+	events := make(chan rawEvent, 16)
+	r := newRecorder()
+	w := newWatcher(newTestLogger(), r.options(50*time.Millisecond), fakeBackend{}, events)
+	defer w.Close()
+	require.NoError(t, w.Watch(root, func(relPath string, isDir bool) bool {
+		return isDir && relPath == "node_modules"
+	}))
+
+	// 同一文件的多次变更合并，被过滤目录中的变更丢弃
+	events <- rawEvent{root: root, path: filepath.Join(root, "a.go")}
+	events <- rawEvent{root: root, path: filepath.Join(root, "a.go")}
+	events <- rawEvent{root: root, path: filepath.Join(root, "src", "b.go")}
+	events <- rawEvent{root: root, path: filepath.Join(root, "node_modules", "x", "c.js")}
+	events <- rawEvent{root: filepath.Join(string(filepath.Separator), "other"), path: "d.go"}
+	r.wait(t)
+	r.mu.Lock()
+	assert.Equal(t, [][]string{{"a.go", filepath.Join("src", "b.go")}}, r.changes)
+	r.mu.Unlock()
+
+	// 变更过多时改为全量扫描
+	for _, name := range []string{"1.go", "2.go", "3.go", "4.go"} {
+		events <- rawEvent{root: root, path: filepath.Join(root, name)}
+	}
+	r.wait(t)
+	r.mu.Lock()
+	assert.Equal(t, []string{root}, r.overflows)
+	assert.Len(t, r.changes, 1)
+	r.mu.Unlock()
+}
+
+func TestWatcherNative(t *testing.T) {
+	r := newRecorder()
+	w, err := NewWatcher(newTestLogger(), r.options(100*time.Millisecond))
+	if errors.Is(err, ErrUnsupported) {
+		t.Skip("file watching is not supported on this platform")
+	}
+	require.NoError(t, err)
+	defer w.Close()
+
+	root := t.TempDir()
+	require.NoError(t, os.MkdirAll(filepath.Join(root, "build"), 0755))
+	require.NoError(t, w.Watch(root, func(relPath string, isDir bool) bool {
+		return isDir && relPath == "build"
+	}))
+
+	require.NoError(t, os.WriteFile(filepath.Join(root, "build", "out.o"), []byte("x"), 0644))
+	require.NoError(t, os.MkdirAll(filepath.Join(root, "src"), 0755))
+	require.NoError(t, os.WriteFile(filepath.Join(root, "src", "main.go"), []byte("package main"), 0644))
+	require.NoError(t, os.WriteFile(filepath.Join(root, "README.md"), []byte("readme"), 0644))
+
+	deadline := time.After(5 * time.Second)
+	seen := make(map[string]bool)
+	for !seen[filepath.Join("src", "main.go")] || !seen["README.md"] {
+		select {
+		case <-r.notify:
+		case <-deadline:
+			t.Fatalf("missing changes, got %v", seen)
+		}
+		r.mu.Lock()
+		for _, paths := range r.changes {
+			for _, p := range paths {
+				seen[p] = true
+			}
+		}
+		r.mu.Unlock()
+	}
+	assert.False(t, seen[filepath.Join("build", "out.o")])
+}
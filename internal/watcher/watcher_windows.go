@@ -0,0 +1,152 @@
+//go:build windows
+
+package watcher
+
+import (
+	"errors"
+	"fmt"
+	"path/filepath"
+	"sync"
+	"syscall"
+	"unsafe"
+
+	"codebase-indexer/pkg/logger"
+)
+
+const (
+	windowsNotifyFilter = syscall.FILE_NOTIFY_CHANGE_FILE_NAME | syscall.FILE_NOTIFY_CHANGE_DIR_NAME |
+		syscall.FILE_NOTIFY_CHANGE_SIZE | syscall.FILE_NOTIFY_CHANGE_LAST_WRITE
+	windowsBufferSize = 64 * 1024
+
+	errorNotifyEnumDir syscall.Errno = 1022
+)
+
+type windowsWatch struct {
+	handle syscall.Handle
+	done   chan struct{}
+}
+
+// windowsBackend 每个工作区一个 ReadDirectoryChangesW 递归监听，过滤在合并事件时进行
+type windowsBackend struct {
+	events chan<- rawEvent
+	logger logger.Logger
+
+	mu      sync.Mutex
+	watches map[string]*windowsWatch
+	closed  chan struct{}
+	wg      sync.WaitGroup
+}
+
+func newBackend(events chan<- rawEvent, logger logger.Logger) (backend, error) {
+	return &windowsBackend{
+		events:  events,
+		logger:  logger,
+		watches: make(map[string]*windowsWatch),
+		closed:  make(chan struct{}),
+	}, nil
+}
+
+func (b *windowsBackend) add(root string, _ Filter) error {
+	path, err := syscall.UTF16PtrFromString(root)
+	if err != nil {
+		return err
+	}
+	handle, err := syscall.CreateFile(path, syscall.FILE_LIST_DIRECTORY,
+		syscall.FILE_SHARE_READ|syscall.FILE_SHARE_WRITE|syscall.FILE_SHARE_DELETE,
+		nil, syscall.OPEN_EXISTING, syscall.FILE_FLAG_BACKUP_SEMANTICS, 0)
+	if err != nil {
+		return fmt.Errorf("failed to open directory: %w", err)
+	}
+	watch := &windowsWatch{handle: handle, done: make(chan struct{})}
+	b.mu.Lock()
+	b.watches[root] = watch
+	b.mu.Unlock()
+	b.wg.Add(1)
+	go b.readChanges(root, watch)
+	return nil
+}
+
+func (b *windowsBackend) remove(root string) error {
+	b.mu.Lock()
+	watch, ok := b.watches[root]
+	delete(b.watches, root)
+	b.mu.Unlock()
+	if ok {
+		stopWindowsWatch(watch)
+	}
+	return nil
+}
+
+func stopWindowsWatch(watch *windowsWatch) {
+	close(watch.done)
+	// 取消另一个线程上阻塞的 ReadDirectoryChangesW 后再关闭句柄
+	_ = syscall.CancelIoEx(watch.handle, nil)
+	_ = syscall.CloseHandle(watch.handle)
+}
+
+func (b *windowsBackend) close() error {
+	close(b.closed)
+	b.mu.Lock()
+	watches := b.watches
+	b.watches = make(map[string]*windowsWatch)
+	b.mu.Unlock()
+	for _, watch := range watches {
+		stopWindowsWatch(watch)
+	}
+	b.wg.Wait()
+	return nil
+}
+
+func (b *windowsBackend) send(watch *windowsWatch, ev rawEvent) bool {
+	select {
+	case b.events <- ev:
+		return true
+	case <-watch.done:
+		return false
+	case <-b.closed:
+		return false
+	}
+}
+
+func (b *windowsBackend) readChanges(root string, watch *windowsWatch) {
+	defer b.wg.Done()
+	buf := make([]byte, windowsBufferSize)
+	for {
+		var n uint32
+		err := syscall.ReadDirectoryChanges(watch.handle, &buf[0], uint32(len(buf)), true,
+			windowsNotifyFilter, &n, nil, 0)
+		select {
+		case <-watch.done:
+			return
+		default:
+		}
+		if err != nil {
+			if errors.Is(err, errorNotifyEnumDir) {
+				if !b.send(watch, rawEvent{root: root, overflow: true}) {
+					return
+				}
+				continue
+			}
+			b.logger.Error("failed to read directory changes of %s: %v", root, err)
+			return
+		}
+		// 缓冲区放不下时系统返回 0 字节，变更已丢失
+		if n == 0 {
+			if !b.send(watch, rawEvent{root: root, overflow: true}) {
+				return
+			}
+			continue
+		}
+		for offset := uint32(0); offset < n; {
+			info := (*syscall.FileNotifyInformation)(unsafe.Pointer(&buf[offset]))
+			name := syscall.UTF16ToString(unsafe.Slice(&info.FileName, info.FileNameLength/2))
+			if !b.send(watch, rawEvent{root: root, path: filepath.Join(root, name)}) {
+				return
+			}
+			if info.NextEntryOffset == 0 {
+				break
+			}
+			offset += info.NextEntryOffset
+		}
+	}
+}
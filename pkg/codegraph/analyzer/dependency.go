@@ -2,7 +2,7 @@ package analyzer
 
 import (
 	packageclassifier "codebase-indexer/pkg/codegraph/analyzer/package_classifier"
-	"codebase-indexer/pkg/codegraph/cache"
+	"codebase-indexer/pkg/codegraph/lang"
 	"codebase-indexer/pkg/codegraph/parser"
 	"codebase-indexer/pkg/codegraph/proto"
 	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
@@ -13,7 +13,6 @@ import (
 	"codebase-indexer/pkg/codegraph/workspace"
 	"codebase-indexer/pkg/logger"
 	"context"
-	"errors"
 	"fmt"
 	"os"
 	"path/filepath"
@@ -28,8 +27,8 @@ type DependencyAnalyzer struct {
 	workspaceReader       workspace.WorkspaceReader
 	logger                logger.Logger
 	store                 store.GraphStorage
-	loadThreshold         int
 	skipVariableThreshold int
+	cppIncludes           *workspace.CppIncludeIndexCache
 }
 
 func NewDependencyAnalyzer(logger logger.Logger,
@@ -42,24 +41,12 @@ func NewDependencyAnalyzer(logger logger.Logger,
 		PackageClassifier:     packageClassifier,
 		workspaceReader:       reader,
 		store:                 store,
-		loadThreshold:         getLoadThresholdFromEnv(),
 		skipVariableThreshold: getSkipVariableThresholdFromEnv(),
+		cppIncludes:           workspace.NewCppIncludeIndexCache(logger, reader),
 	}
 }
 
-const defaultLoadFromStoreThreshold = 9000 // 不存在则load，缓存key、value。
-
-const defaultSkipVariableThreshold = 9000 // 不存在则load，缓存key、value。
-
-func getLoadThresholdFromEnv() int {
-	loadThreshold := defaultLoadFromStoreThreshold
-	if envVal, ok := os.LookupEnv("LOAD_FROM_STORE_THRESHOLD"); ok {
-		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
-			loadThreshold = val
-		}
-	}
-	return loadThreshold
-}
+const defaultSkipVariableThreshold = 9000 // 文件数超过该值时不保存变量定义
 
 func getSkipVariableThresholdFromEnv() int {
 	skipVariableThreshold := defaultSkipVariableThreshold
@@ -71,9 +58,10 @@ func getSkipVariableThresholdFromEnv() int {
 	return skipVariableThreshold
 }
 
-// SaveSymbolOccurrences 保存符号定义位置
+// SaveSymbolOccurrences 保存符号定义位置。每个文件的每个符号写一条增量，替换符号表中该文件的位置，
+// 写入量只与文件本身相关，不读取已有的符号表
 func (da *DependencyAnalyzer) SaveSymbolOccurrences(ctx context.Context, projectUuid string, totalFiles int,
-	fileElementTables []*parser.FileElementTable, symbolCache *cache.LRUCache[*codegraphpb.SymbolOccurrence]) (*types.IndexTaskMetrics, error) {
+	fileElementTables []*parser.FileElementTable) (*types.IndexTaskMetrics, error) {
 	taskMetrics := &types.IndexTaskMetrics{}
 	if len(fileElementTables) == 0 {
 		return taskMetrics, nil
@@ -82,10 +70,12 @@ func (da *DependencyAnalyzer) SaveSymbolOccurrences(ctx context.Context, project
 	totalElements := 0
 	totalVariables := 0
 	totalElementsAfterFiltered := 0
-	totalLoad, totalVariablesFiltered := 0, 0
-	updatedSymbolOccurrences := make([]*codegraphpb.SymbolOccurrence, 0, 100)
+	totalVariablesFiltered := 0
+	postings := make(workspace.SymbolPostings, 0, 100)
 	for _, fileTable := range fileElementTables {
 		totalElements += len(fileTable.Elements)
+		// 同一文件内的同名定义合并为一条增量
+		fileSymbols := make(map[string]*codegraphpb.SymbolOccurrence)
 		for _, element := range fileTable.Elements {
 			switch element.(type) {
 			// 处理定义
@@ -100,17 +90,21 @@ func (da *DependencyAnalyzer) SaveSymbolOccurrences(ctx context.Context, project
 					}
 				}
 
-				symbol, load := da.loadSymbolOccurrenceByStrategy(ctx, projectUuid, totalFiles, element, symbolCache, fileTable)
-				if load {
-					totalLoad++
+				name := element.GetName()
+				symbol, ok := fileSymbols[name]
+				if !ok {
+					symbol = &codegraphpb.SymbolOccurrence{Name: name, Language: string(fileTable.Language)}
+					fileSymbols[name] = symbol
+					postings = append(postings, workspace.SymbolPosting{FilePath: fileTable.Path, Symbol: symbol})
+				}
+				if containsOccurrence(symbol.Occurrences, element.GetRange()) { // 去重
+					continue
 				}
 				symbol.Occurrences = append(symbol.Occurrences, &codegraphpb.Occurrence{
 					Path:        fileTable.Path,
 					Range:       element.GetRange(),
 					ElementType: proto.ElementTypeToProto(element.GetType()),
 				})
-
-				updatedSymbolOccurrences = append(updatedSymbolOccurrences, symbol)
 				totalElementsAfterFiltered++
 				// 引用位置
 				// case *resolver.Reference, *resolver.Call:
@@ -121,70 +115,46 @@ func (da *DependencyAnalyzer) SaveSymbolOccurrences(ctx context.Context, project
 	taskMetrics.TotalSymbols = totalElements
 	taskMetrics.TotalVariables = totalVariables
 	// 3. 保存到存储中，后续查询使用
-	if err := da.store.BatchSave(ctx, projectUuid, workspace.SymbolOccurrences(updatedSymbolOccurrences)); err != nil {
+	if err := da.store.BatchSave(ctx, projectUuid, postings); err != nil {
 		return taskMetrics, fmt.Errorf("batch save symbol definitions error: %w", err)
 	}
 	taskMetrics.TotalSavedSymbols = totalElementsAfterFiltered
 	taskMetrics.TotalSavedVariables = totalVariables - totalVariablesFiltered
-	da.logger.Info("batch save symbols end, element_tables %d, total elements %d, after filtered %d, load from db %d, total variable %d, skipped %d, load threshold %d, skip threshold %d",
-		len(fileElementTables), totalElements, totalElementsAfterFiltered, totalLoad, totalVariables, totalVariablesFiltered, da.loadThreshold, da.skipVariableThreshold)
+	da.logger.Info("batch save symbols end, element_tables %d, total elements %d, after filtered %d, postings %d, total variable %d, skipped %d, skip threshold %d",
+		len(fileElementTables), totalElements, totalElementsAfterFiltered, len(postings), totalVariables, totalVariablesFiltered, da.skipVariableThreshold)
 	return taskMetrics, nil
 }
 
-func (da *DependencyAnalyzer) shouldSkipVariable(totalFiles int, element resolver.Element) bool {
-	return totalFiles > da.skipVariableThreshold || (element.GetType() == types.ElementTypeVariable && (element.GetScope() != types.ScopePackage &&
-		element.GetScope() != types.ScopeFile &&
-		element.GetScope() != types.ScopeProject))
-}
-
-// loadSymbolOccurrenceByStrategy 根据策略加载，defaultLoadFromStoreThreshold、level2、level3
-func (da *DependencyAnalyzer) loadSymbolOccurrenceByStrategy(ctx context.Context,
-	projectUuid string,
-	totalFiles int,
-	elem resolver.Element,
-	symbolCache *cache.LRUCache[*codegraphpb.SymbolOccurrence],
-	fileTable *parser.FileElementTable) (*codegraphpb.SymbolOccurrence, bool) {
-	load := false
-	key := elem.GetName()
-	// TODO 同名处理：按文件数采取降级措施
-	symbol, ok := symbolCache.Get(key)
-
-	loadFromDB := func() {
-		nameKey := store.SymbolNameKey{Name: key, Language: fileTable.Language}
-		bytes, err := da.store.Get(ctx, projectUuid, nameKey)
-		if err == nil && len(bytes) > 0 {
-			var exist codegraphpb.SymbolOccurrence
-			if err := store.UnmarshalValue(bytes, &exist); err == nil {
-				newOccurrences := make([]*codegraphpb.Occurrence, 0)
-				// 去重，删除 path 和 range相同的
-				for _, o := range exist.Occurrences {
-					if o.Path == fileTable.Path && utils.SliceEqual(o.Range, elem.GetRange()) { // 去重
-						continue
-					}
-					newOccurrences = append(newOccurrences, o)
-				}
-				exist.Occurrences = newOccurrences
-				symbol = &exist
-			} else {
-				da.logger.Debug("unmarshal symbol occurrence err:%v", err)
-			}
-		} else if !errors.Is(err, store.ErrKeyNotFound) {
-			da.logger.Debug("get symbol occurrence from db failed, value is zero length or err:%v", err)
-		}
+// DeleteFileSymbolOccurrences 从符号表中删除文件内指定符号的全部位置，写入空增量，不读取已有的符号表
+func (da *DependencyAnalyzer) DeleteFileSymbolOccurrences(ctx context.Context, projectUuid string,
+	language lang.Language, filePath string, names []string) error {
+	if len(names) == 0 {
+		return nil
 	}
-
-	if !ok && totalFiles <= da.loadThreshold {
-		load = true
-		loadFromDB()
+	tombstones := make(workspace.SymbolPostings, 0, len(names))
+	for _, name := range names {
+		tombstones = append(tombstones, workspace.SymbolPosting{FilePath: filePath,
+			Symbol: &codegraphpb.SymbolOccurrence{Name: name, Language: string(language)}})
+	}
+	if err := da.store.BatchSave(ctx, projectUuid, tombstones); err != nil {
+		return fmt.Errorf("batch delete symbol definitions of file %s error: %w", filePath, err)
 	}
+	return nil
+}
 
-	if symbol == nil {
-		symbol = &codegraphpb.SymbolOccurrence{Name: key, Language: string(fileTable.Language),
-			Occurrences: make([]*codegraphpb.Occurrence, 0)}
+func containsOccurrence(occurrences []*codegraphpb.Occurrence, target []int32) bool {
+	for _, o := range occurrences {
+		if utils.SliceEqual(o.Range, target) {
+			return true
+		}
 	}
-	symbolCache.Put(key, symbol)
+	return false
+}
 
-	return symbol, load
+func (da *DependencyAnalyzer) shouldSkipVariable(totalFiles int, element resolver.Element) bool {
+	return totalFiles > da.skipVariableThreshold || (element.GetType() == types.ElementTypeVariable && (element.GetScope() != types.ScopePackage &&
+		element.GetScope() != types.ScopeFile &&
+		element.GetScope() != types.ScopeProject))
 }
 
 type RichElement struct {
@@ -23,7 +23,12 @@ import (
 func (da *DependencyAnalyzer) PreprocessImports(ctx context.Context,
 	language lang.Language, projectInfo *workspace.Project, imports []*resolver.Import) ([]*resolver.Import, error) {
 	processedImports := make([]*resolver.Import, 0, len(imports))
+	cppIndex := da.cppIncludeIndex(ctx, language, projectInfo)
 	for _, imp := range imports {
+		if cppIndex != nil && isCppInclude(imp.Name) {
+			processedImports = append(processedImports, resolveCppInclude(cppIndex, imp)...)
+			continue
+		}
 		// TODO 过滤掉标准库、第三方库等非项目的库
 		if i := da.processImportByLanguage(imp, language, projectInfo); i != nil {
 			processedImports = append(processedImports, i)
@@ -33,6 +38,48 @@ func (da *DependencyAnalyzer) PreprocessImports(ctx context.Context,
 	return processedImports, nil
 }
 
+// SetCppHeaderSkipFunc 设置构建头文件索引时遍历项目使用的忽略规则
+func (da *DependencyAnalyzer) SetCppHeaderSkipFunc(skipFunc func(projectPath string) types.SkipFunc) {
+	if da.cppIncludes != nil {
+		da.cppIncludes.SetSkipFunc(skipFunc)
+	}
+}
+
+// cppIncludeIndex C/C++ 项目的头文件索引，获取失败时返回空，退回按名称匹配
+func (da *DependencyAnalyzer) cppIncludeIndex(ctx context.Context, language lang.Language,
+	project *workspace.Project) *workspace.CppIncludeIndex {
+	if (language != lang.C && language != lang.CPP) || project == nil || project.Path == types.EmptyString {
+		return nil
+	}
+	index, err := da.cppIncludes.Get(ctx, project.Path)
+	if err != nil {
+		da.logger.Debug("get c/cpp include index of project %s err: %v", project.Path, err)
+		return nil
+	}
+	return index
+}
+
+func isCppInclude(name string) bool {
+	return strings.HasPrefix(name, "\"") || strings.HasPrefix(name, "<")
+}
+
+// resolveCppInclude 把 #include 解析为项目内的头文件，每个头文件一条导入。
+// Name 和 Source 为去掉扩展名、以 . 结尾的头文件绝对路径，头文件和同名的实现文件（foo.h、foo.cpp）都能匹配；
+// 项目外的头文件（系统库、第三方库）不保留
+func resolveCppInclude(index *workspace.CppIncludeIndex, imp *resolver.Import) []*resolver.Import {
+	headers := index.Resolve(imp.Path, imp.Name)
+	resolved := make([]*resolver.Import, 0, len(headers))
+	for _, header := range headers {
+		source := strings.TrimSuffix(header, filepath.Ext(header))
+		source = strings.ReplaceAll(source, types.WindowsSeparator, types.Dot)
+		source = strings.ReplaceAll(source, types.UnixSeparator, types.Dot) + types.Dot
+		base := *imp.BaseElement
+		base.Name = source
+		resolved = append(resolved, &resolver.Import{BaseElement: &base, Source: source, Alias: imp.Alias})
+	}
+	return resolved
+}
+
 // processImportByLanguage 根据语言类型统一处理导入
 func (da *DependencyAnalyzer) processImportByLanguage(imp *resolver.Import, language lang.Language,
 	project *workspace.Project) *resolver.Import {
@@ -0,0 +1,261 @@
+package cache
+
+import (
+	"sync"
+)
+
+const (
+	DefaultShardCount = 16
+)
+
+// Cache 字符串键的并发安全缓存，LRUCache 和 ShardedLRUCache 都实现了该接口
+type Cache[T any] interface {
+	Get(key string) (T, bool)
+	Put(key string, value T)
+	Purge()
+	Len() int
+	MaxCapacity() int
+}
+
+// Stats 缓存统计信息
+type Stats struct {
+	Hits      int64
+	Misses    int64
+	Evictions int64
+	Len       int
+	Bytes     int64
+}
+
+// HitRatio 命中率，没有访问时为0
+func (s Stats) HitRatio() float64 {
+	total := s.Hits + s.Misses
+	if total == 0 {
+		return 0
+	}
+	return float64(s.Hits) / float64(total)
+}
+
+// ShardedOptions 分片LRU的可选参数
+type ShardedOptions[T any] struct {
+	// Shards 分片数，向上取2的幂，默认 DefaultShardCount，且不超过最大容量
+	Shards int
+	// MaxBytes 总字节预算，平均分到各分片，0表示只按元素个数限制；超过单个分片预算的元素不缓存
+	MaxBytes int64
+	// SizeOf 计算元素占用的字节数，MaxBytes>0时必须设置
+	SizeOf func(key string, value T) int64
+}
+
+// ShardedLRUCache 按键哈希分片的LRU缓存，每个分片独立加锁，降低并发访问时的锁竞争。
+// 淘汰只在分片内进行，是全局LRU的近似
+type ShardedLRUCache[T any] struct {
+	shards      []*lruShard[T]
+	mask        uint32
+	maxCapacity int
+	sizeOf      func(key string, value T) int64
+}
+
+// lruShard 单个分片，结构与 LRUCache 相同，额外记录字节数和统计
+type lruShard[T any] struct {
+	mu          sync.Mutex
+	cache       map[string]*node[T]
+	head        *node[T]
+	tail        *node[T]
+	maxCapacity int
+	maxBytes    int64
+	bytes       int64
+	hits        int64
+	misses      int64
+	evictions   int64
+}
+
+// NewShardedLRUCache 创建分片LRU缓存，参数含义与 NewLRUCache 相同
+func NewShardedLRUCache[T any](initCapacity, maxCapacity int) *ShardedLRUCache[T] {
+	return NewShardedLRUCacheWithOptions[T](initCapacity, maxCapacity, ShardedOptions[T]{})
+}
+
+// NewShardedLRUCacheWithOptions 创建分片LRU缓存，可指定分片数和字节预算
+func NewShardedLRUCacheWithOptions[T any](initCapacity, maxCapacity int, opts ShardedOptions[T]) *ShardedLRUCache[T] {
+	shardCount := opts.Shards
+	if shardCount <= 0 {
+		shardCount = DefaultShardCount
+	}
+	// 容量太小时减少分片，保证每个分片至少能放一个元素
+	for shardCount > 1 && shardCount > maxCapacity {
+		shardCount /= 2
+	}
+	n := 1
+	for n < shardCount {
+		n <<= 1
+	}
+	shardCount = n
+
+	sizeOf := opts.SizeOf
+	if opts.MaxBytes <= 0 {
+		sizeOf = nil
+	}
+	c := &ShardedLRUCache[T]{
+		shards:      make([]*lruShard[T], shardCount),
+		mask:        uint32(shardCount - 1),
+		maxCapacity: maxCapacity,
+		sizeOf:      sizeOf,
+	}
+	shardCapacity := (maxCapacity + shardCount - 1) / shardCount
+	for i := range c.shards {
+		head, tail := &node[T]{}, &node[T]{}
+		head.next = tail
+		tail.prev = head
+		c.shards[i] = &lruShard[T]{
+			cache:       make(map[string]*node[T], initCapacity/shardCount),
+			head:        head,
+			tail:        tail,
+			maxCapacity: shardCapacity,
+			maxBytes:    opts.MaxBytes / int64(shardCount),
+		}
+	}
+	return c
+}
+
+// shard FNV-1a 哈希选择分片
+func (c *ShardedLRUCache[T]) shard(key string) *lruShard[T] {
+	hash := uint32(2166136261)
+	for i := 0; i < len(key); i++ {
+		hash ^= uint32(key[i])
+		hash *= 16777619
+	}
+	return c.shards[hash&c.mask]
+}
+
+// Get 并发安全的获取操作
+func (c *ShardedLRUCache[T]) Get(key string) (T, bool) {
+	s := c.shard(key)
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	if n, ok := s.cache[key]; ok {
+		s.moveToHead(n)
+		s.hits++
+		return n.value, true
+	}
+	s.misses++
+	var zero T
+	return zero, false
+}
+
+// Put 并发安全的添加/更新操作
+func (c *ShardedLRUCache[T]) Put(key string, value T) {
+	c.PutIf(key, value, nil)
+}
+
+// PutIf 键不存在，或 replace 对旧值返回 true 时写入，返回是否写入。replace 在分片锁内调用，不能访问缓存
+func (c *ShardedLRUCache[T]) PutIf(key string, value T, replace func(old T) bool) bool {
+	var size int64
+	if c.sizeOf != nil {
+		size = c.sizeOf(key, value)
+	}
+	s := c.shard(key)
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	n, ok := s.cache[key]
+	if ok && replace != nil && !replace(n.value) {
+		return false
+	}
+	if s.maxBytes > 0 && size > s.maxBytes {
+		// 放不下的元素不缓存，同时删除旧值，避免读到过期数据
+		if ok {
+			s.remove(n)
+		}
+		return false
+	}
+	if ok {
+		s.bytes += size - n.size
+		n.value, n.size = value, size
+		s.moveToHead(n)
+	} else {
+		n = &node[T]{key: key, value: value, size: size}
+		s.cache[key] = n
+		s.addToHead(n)
+		s.bytes += size
+	}
+	for s.tail.prev != s.head && (len(s.cache) > s.maxCapacity || (s.maxBytes > 0 && s.bytes > s.maxBytes)) {
+		s.remove(s.tail.prev)
+		s.evictions++
+	}
+	return true
+}
+
+// Delete 删除指定键
+func (c *ShardedLRUCache[T]) Delete(key string) {
+	s := c.shard(key)
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if n, ok := s.cache[key]; ok {
+		s.remove(n)
+	}
+}
+
+// Purge 清理所有缓存，统计信息保留
+func (c *ShardedLRUCache[T]) Purge() {
+	for _, s := range c.shards {
+		s.mu.Lock()
+		s.cache = make(map[string]*node[T], len(s.cache))
+		s.head.next = s.tail
+		s.tail.prev = s.head
+		s.bytes = 0
+		s.mu.Unlock()
+	}
+}
+
+// Len 返回当前缓存大小
+func (c *ShardedLRUCache[T]) Len() int {
+	total := 0
+	for _, s := range c.shards {
+		s.mu.Lock()
+		total += len(s.cache)
+		s.mu.Unlock()
+	}
+	return total
+}
+
+// MaxCapacity 返回最大容量限制
+func (c *ShardedLRUCache[T]) MaxCapacity() int {
+	return c.maxCapacity
+}
+
+// Stats 汇总各分片的统计信息
+func (c *ShardedLRUCache[T]) Stats() Stats {
+	var stats Stats
+	for _, s := range c.shards {
+		s.mu.Lock()
+		stats.Hits += s.hits
+		stats.Misses += s.misses
+		stats.Evictions += s.evictions
+		stats.Len += len(s.cache)
+		stats.Bytes += s.bytes
+		s.mu.Unlock()
+	}
+	return stats
+}
+
+func (s *lruShard[T]) moveToHead(n *node[T]) {
+	s.unlink(n)
+	s.addToHead(n)
+}
+
+func (s *lruShard[T]) addToHead(n *node[T]) {
+	n.prev = s.head
+	n.next = s.head.next
+	s.head.next.prev = n
+	s.head.next = n
+}
+
+func (s *lruShard[T]) unlink(n *node[T]) {
+	n.prev.next = n.next
+	n.next.prev = n.prev
+}
+
+func (s *lruShard[T]) remove(n *node[T]) {
+	s.unlink(n)
+	delete(s.cache, n.key)
+	s.bytes -= n.size
+}
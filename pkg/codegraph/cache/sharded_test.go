@@ -0,0 +1,109 @@
+package cache
+
+import (
+	"fmt"
+	"sync"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func TestShardedLRUCache_Basic(t *testing.T) {
+	var c Cache[int] = NewShardedLRUCache[int](0, 100)
+	c.Put("a", 1)
+	c.Put("b", 2)
+	c.Put("a", 3)
+	v, ok := c.Get("a")
+	assert.True(t, ok)
+	assert.Equal(t, 3, v)
+	_, ok = c.Get("missing")
+	assert.False(t, ok)
+	assert.Equal(t, 2, c.Len())
+	assert.Equal(t, 100, c.MaxCapacity())
+
+	stats := c.(*ShardedLRUCache[int]).Stats()
+	assert.Equal(t, int64(1), stats.Hits)
+	assert.Equal(t, int64(1), stats.Misses)
+	assert.Equal(t, 0.5, stats.HitRatio())
+
+	// 条件写入：旧值不满足条件时保留旧值
+	sharded := c.(*ShardedLRUCache[int])
+	assert.False(t, sharded.PutIf("a", 1, func(old int) bool { return old < 1 }))
+	assert.True(t, sharded.PutIf("a", 5, func(old int) bool { return old < 5 }))
+	assert.True(t, sharded.PutIf("new", 1, func(int) bool { return false }))
+	v, _ = c.Get("a")
+	assert.Equal(t, 5, v)
+
+	c.Purge()
+	assert.Equal(t, 0, c.Len())
+}
+
+func TestShardedLRUCache_Eviction(t *testing.T) {
+	// 单分片时与全局LRU一致
+	c := NewShardedLRUCacheWithOptions[int](0, 2, ShardedOptions[int]{Shards: 1})
+	c.Put("a", 1)
+	c.Put("b", 2)
+	c.Get("a")
+	c.Put("c", 3)
+	_, ok := c.Get("b")
+	assert.False(t, ok)
+	_, ok = c.Get("a")
+	assert.True(t, ok)
+	assert.Equal(t, int64(1), c.Stats().Evictions)
+
+	// 容量小于分片数时分片数随之减少，总数不超过容量
+	small := NewShardedLRUCache[int](0, 3)
+	for i := 0; i < 10; i++ {
+		small.Put(fmt.Sprintf("k%d", i), i)
+	}
+	assert.LessOrEqual(t, small.Len(), 4)
+}
+
+func TestShardedLRUCache_Bytes(t *testing.T) {
+	c := NewShardedLRUCacheWithOptions[string](0, 100, ShardedOptions[string]{
+		Shards:   1,
+		MaxBytes: 10,
+		SizeOf:   func(_ string, v string) int64 { return int64(len(v)) },
+	})
+	c.Put("a", "1234")
+	c.Put("b", "1234")
+	assert.Equal(t, int64(8), c.Stats().Bytes)
+	// 超出字节预算淘汰最久未使用的
+	c.Put("c", "1234")
+	_, ok := c.Get("a")
+	assert.False(t, ok)
+	assert.Equal(t, int64(8), c.Stats().Bytes)
+	// 更新值时重新计算字节数
+	c.Put("b", "12")
+	assert.Equal(t, int64(6), c.Stats().Bytes)
+	// 超过预算的单个元素不缓存，并删除旧值
+	c.Put("c", "12345678901")
+	_, ok = c.Get("c")
+	assert.False(t, ok)
+	assert.Equal(t, int64(2), c.Stats().Bytes)
+
+	c.Delete("b")
+	assert.Equal(t, 0, c.Len())
+	assert.Equal(t, int64(0), c.Stats().Bytes)
+}
+
+func TestShardedLRUCache_Concurrent(t *testing.T) {
+	c := NewShardedLRUCache[int](0, 1000)
+	var wg sync.WaitGroup
+	for w := 0; w < 8; w++ {
+		wg.Add(1)
+		go func(w int) {
+			defer wg.Done()
+			for i := 0; i < 1000; i++ {
+				key := fmt.Sprintf("k%d", (w*1000+i)%1500)
+				if _, ok := c.Get(key); !ok {
+					c.Put(key, i)
+				}
+			}
+		}(w)
+	}
+	wg.Wait()
+	assert.LessOrEqual(t, c.Len(), 1000+DefaultShardCount)
+	stats := c.Stats()
+	assert.Equal(t, int64(8000), stats.Hits+stats.Misses)
+}
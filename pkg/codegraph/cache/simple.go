@@ -8,6 +8,7 @@ import (
 type node[T any] struct {
 	key   string
 	value T
+	size  int64 // 仅分片缓存按字节计数时使用
 	prev  *node[T]
 	next  *node[T]
 }
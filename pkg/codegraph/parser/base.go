@@ -16,6 +16,8 @@ import (
 type SourceFileParser struct {
 	logger          logger.Logger
 	resolverManager *resolver.ResolverManager
+	parserPool      *parserPool
+	incremental     *incrementalCache
 }
 
 func NewSourceFileParser(logger logger.Logger) *SourceFileParser {
@@ -23,9 +25,17 @@ func NewSourceFileParser(logger logger.Logger) *SourceFileParser {
 	return &SourceFileParser{
 		logger:          logger,
 		resolverManager: resolveManager,
+		parserPool:      newParserPool(0),
+		incremental:     newIncrementalCache(DefaultIncrementalCacheSize),
 	}
 }
 
+// Close 释放缓存的解析器和语法树
+func (p *SourceFileParser) Close() {
+	p.parserPool.close()
+	p.incremental.close()
+}
+
 func (p *SourceFileParser) Parse(ctx context.Context,
 	sourceFile *types.SourceFile) (result *FileElementTable, err error) {
 	// 添加顶层的panic恢复机制
@@ -45,46 +55,83 @@ func (p *SourceFileParser) Parse(ctx context.Context,
 		return nil, err
 	}
 
-	sitterParser := sitter.NewParser()
-	defer sitterParser.Close()
-	sitterLanguage := langParser.SitterLanguage()
-	if err := sitterParser.SetLanguage(sitterLanguage); err != nil {
+	state, err := p.parserPool.get(langParser)
+	if err != nil {
 		return nil, err
 	}
+	// 发生panic时解析器状态未知，不归还
+	panicked := true
+	defer func() {
+		if panicked {
+			state.close()
+		} else {
+			p.parserPool.put(langParser.Language, state)
+		}
+	}()
+	result, err = p.parse(ctx, langParser, state, sourceFile)
+	panicked = false
+	return result, err
+}
 
+func (p *SourceFileParser) parse(ctx context.Context, langParser *lang.TreeSitterParser, state *parserState,
+	sourceFile *types.SourceFile) (*FileElementTable, error) {
 	content := sourceFile.Content
-	tree := sitterParser.Parse(content, nil)
+	tree := state.parser.Parse(content, nil)
 	if tree == nil {
 		return nil, fmt.Errorf("failed to parse file: %s", sourceFile.Path)
 	}
 
 	defer tree.Close()
 
+	collector := newElementCollector()
+	// 元素随文件元素表一起释放，按文件分块分配
+	if err := p.matchElements(ctx, langParser, state.cursor, tree, sourceFile, resolver.NewElementArena(),
+		collector.add); err != nil {
+		return nil, err
+	}
+	// 按顺序解析，使用在前、定义在后的符号不在这里处理，所有文件写入后由索引器的延迟解析（indexer/resolve.go）统一解析
+
+	// 返回结构信息，包含处理后的定义
+	return collector.table(sourceFile.Path, langParser.Language), nil
+}
+
+// matchElements 在语法树上执行 BaseQueries，按匹配顺序回调解析出的元素。
+// 游标设置了字节范围时只匹配该范围。arena 为 nil 时元素逐个分配；
+// 上下文中有驻留表时（见 utils.WithStringInterner）与同批次的文件共享，否则按文件驻留
+func (p *SourceFileParser) matchElements(ctx context.Context, langParser *lang.TreeSitterParser,
+	cursor *sitter.QueryCursor, tree *sitter.Tree, sourceFile *types.SourceFile, arena *resolver.ElementArena,
+	collect func(resolver.Element)) error {
 	baseQuery, ok := BaseQueries[langParser.Language]
 	if !ok {
-		return nil, lang.ErrQueryNotFound
+		return lang.ErrQueryNotFound
 	}
 	// TODO baseQuery永远不会关闭，影响？
 
 	captureNames := baseQuery.CaptureNames() // 根据scm文件从上到下排列的
 	if len(captureNames) == 0 {
-		return nil, fmt.Errorf("tree_sitter base_processor query capture names is empty")
+		return fmt.Errorf("tree_sitter base_processor query capture names is empty")
 	}
 
-	qc := sitter.NewQueryCursor()
-	defer qc.Close()
-	matches := qc.Matches(baseQuery, tree.RootNode(), content)
+	matches := cursor.Matches(baseQuery, tree.RootNode(), sourceFile.Content)
+
+	// 同一文件的匹配共用解析上下文
+	resolveCtx := &resolver.ResolveContext{
+		Language:     langParser.Language,
+		CaptureNames: captureNames,
+		SourceFile:   sourceFile,
+		Logger:       p.logger,
+		Arena:        arena,
+		Strings:      utils.StringInternerFromContext(ctx),
+	}
+	if resolveCtx.Strings == nil {
+		resolveCtx.Strings = utils.NewStringInterner()
+	}
 
 	// 消费 matches，并调用 ProcessStructureMatch 处理匹配结果
-	// elementName->elementPosition
-	var visited = make(map[string][]int32)
-	var sourcePackage *resolver.Package
-	var imports []*resolver.Import
-	elements := make([]resolver.Element, 0)
 	for {
 		// 统一的上下文取消检测函数
-		if err = utils.CheckContextCanceled(ctx); err != nil {
-			return nil, fmt.Errorf("tree_sitter base processor context canceled: %v", err)
+		if err := utils.CheckContextCanceled(ctx); err != nil {
+			return fmt.Errorf("tree_sitter base processor context canceled: %v", err)
 		}
 
 		match := matches.Next()
@@ -92,7 +139,7 @@ func (p *SourceFileParser) Parse(ctx context.Context,
 			break
 		}
 		// TODO Parent 、Children 关系处理。比如变量定义在函数中，函数定义在类中。
-		elems, err := p.processNode(ctx, langParser.Language, match, captureNames, sourceFile)
+		elems, err := p.processNode(ctx, match, resolveCtx)
 		// match.Remove()
 		if err != nil {
 			p.logger.Debug("tree_sitter base processor processNode error: %v", err)
@@ -100,71 +147,81 @@ func (p *SourceFileParser) Parse(ctx context.Context,
 		}
 
 		for _, element := range elems {
-			// 去重，主要针对variable
-			if position, ok := visited[element.GetName()]; ok && isSamePosition(position, element.GetRange()) {
-				continue
-			}
-			visited[element.GetName()] = element.GetRange()
-			// package go/java
-			if element.GetType() == types.ElementTypePackage && sourcePackage == nil {
-				sourcePackage = element.(*resolver.Package)
-				continue
-			}
-
-			// imports
-			if element.GetType() == types.ElementTypeImport {
-				imports = append(imports, element.(*resolver.Import))
-				continue
-			}
-
-			elements = append(elements, element)
+			collect(element)
 		}
+	}
+	return nil
+}
+
+// elementCollector 汇总解析出的元素，去重并分拣出package、import
+type elementCollector struct {
+	// elementName->elementPosition
+	visited       map[string][]int32
+	sourcePackage *resolver.Package
+	imports       []*resolver.Import
+	elements      []resolver.Element
+}
 
+func newElementCollector() *elementCollector {
+	return &elementCollector{
+		visited:  make(map[string][]int32),
+		elements: make([]resolver.Element, 0),
 	}
-	//TODO 顺序解析，对于使用在前，定义在后的类型，未进行处理，比如函数、方法、全局变量。需要再进行二次解析。
+}
 
-	// 返回结构信息，包含处理后的定义
+func (c *elementCollector) add(element resolver.Element) {
+	// 去重，主要针对variable
+	if position, ok := c.visited[element.GetName()]; ok && isSamePosition(position, element.GetRange()) {
+		return
+	}
+	c.visited[element.GetName()] = element.GetRange()
+	// package go/java
+	if element.GetType() == types.ElementTypePackage && c.sourcePackage == nil {
+		c.sourcePackage = element.(*resolver.Package)
+		return
+	}
+
+	// imports
+	if element.GetType() == types.ElementTypeImport {
+		c.imports = append(c.imports, element.(*resolver.Import))
+		return
+	}
+
+	c.elements = append(c.elements, element)
+}
+
+func (c *elementCollector) table(path string, language lang.Language) *FileElementTable {
 	return &FileElementTable{
-		Path:     sourceFile.Path,
-		Package:  sourcePackage,
-		Imports:  imports,
-		Language: langParser.Language,
-		Elements: elements,
-	}, nil
+		Path:     path,
+		Package:  c.sourcePackage,
+		Imports:  c.imports,
+		Language: language,
+		Elements: c.elements,
+	}
 }
 
 func (p *SourceFileParser) processNode(
 	ctx context.Context,
-	language lang.Language,
 	match *sitter.QueryMatch,
-	captureNames []string,
-	sourceFile *types.SourceFile) ([]resolver.Element, error) {
-	if len(match.Captures) == 0 || len(captureNames) == 0 {
-		p.logger.Debug("no captures in file:%s", sourceFile.Path)
+	resolveCtx *resolver.ResolveContext) ([]resolver.Element, error) {
+	if len(match.Captures) == 0 || len(resolveCtx.CaptureNames) == 0 {
+		p.logger.Debug("no captures in file:%s", resolveCtx.SourceFile.Path)
 		return nil, lang.ErrNoCaptures
 	} // root node
 	rootIndex := match.Captures[0].Index
-	rootCaptureName := captureNames[rootIndex]
+	rootCaptureName := resolveCtx.CaptureNames[rootIndex]
 
-	rootElement := newRootElement(rootCaptureName, rootIndex)
-	rootElement.SetPath(sourceFile.Path)
-	resolvedElements := make([]resolver.Element, 0)
+	rootElement := newRootElement(rootCaptureName, rootIndex, resolveCtx.Arena)
+	rootElement.SetPath(resolveCtx.SourceFile.Path)
 
-	resolveCtx := &resolver.ResolveContext{
-		Language:     language,
-		Match:        match,
-		CaptureNames: captureNames,
-		SourceFile:   sourceFile,
-		Logger:       p.logger,
-	}
+	resolveCtx.Match = match
 	elements, err := p.resolverManager.Resolve(ctx, rootElement, resolveCtx)
 	if err != nil {
 		// TODO full_name（import）、 find identifier recur (variable)、parameters/arguments
 		p.logger.Debug("parse match err: %v", err)
 	}
-	resolvedElements = append(resolvedElements, elements...)
-
-	return resolvedElements, nil
+	// 解析结果直接交给调用方，不再复制
+	return elements, nil
 }
 
 func isSamePosition(source []int32, target []int32) bool {
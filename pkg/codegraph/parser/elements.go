@@ -15,9 +15,9 @@ type FileElementTable struct {
 	Elements  []resolver.Element
 }
 
-func newRootElement(elementTypeValue string, rootIndex uint32) resolver.Element {
+func newRootElement(elementTypeValue string, rootIndex uint32, arena *resolver.ElementArena) resolver.Element {
 	elementType := types.ToElementType(elementTypeValue)
-	base := resolver.NewBaseElement(rootIndex)
+	base := arena.NewBaseElement(rootIndex)
 	switch elementType {
 	case types.ElementTypePackage:
 		base.Type = types.ElementTypePackage
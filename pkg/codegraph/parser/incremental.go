@@ -0,0 +1,394 @@
+package parser
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/resolver"
+	"codebase-indexer/pkg/codegraph/types"
+	"context"
+	"fmt"
+	"runtime/debug"
+	"sync"
+
+	"github.com/hashicorp/golang-lru/v2/simplelru"
+	sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+const (
+	// DefaultIncrementalCacheSize 保留语法树的最近编辑文件数
+	DefaultIncrementalCacheSize = 32
+	// incrementalMaxDirtyRatio 变更区域超过文件的该比例时，直接在新树上全量匹配
+	incrementalMaxDirtyRatio = 0.5
+)
+
+// incrementalEntry 最近一次解析的内容、语法树和元素表，三者保持一致
+type incrementalEntry struct {
+	language lang.Language
+	content  []byte
+	tree     *sitter.Tree
+	table    *FileElementTable
+	taken    bool // 已被取出使用，淘汰时不关闭语法树
+}
+
+// incrementalCache 最近编辑文件的语法树缓存。条目取出后归调用方独占，用完放回
+type incrementalCache struct {
+	mu      sync.Mutex
+	entries *simplelru.LRU[string, *incrementalEntry]
+}
+
+func newIncrementalCache(size int) *incrementalCache {
+	if size <= 0 {
+		size = DefaultIncrementalCacheSize
+	}
+	entries, _ := simplelru.NewLRU[string, *incrementalEntry](size, func(_ string, entry *incrementalEntry) {
+		if !entry.taken {
+			entry.tree.Close()
+		}
+	})
+	return &incrementalCache{entries: entries}
+}
+
+func (c *incrementalCache) take(path string) *incrementalEntry {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	entry, ok := c.entries.Peek(path)
+	if !ok {
+		return nil
+	}
+	entry.taken = true
+	c.entries.Remove(path)
+	return entry
+}
+
+func (c *incrementalCache) put(path string, entry *incrementalEntry) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	// 并发解析同一文件时，后放回的覆盖先放回的
+	if old, ok := c.entries.Peek(path); ok {
+		old.taken = true
+		c.entries.Remove(path)
+		old.tree.Close()
+	}
+	entry.taken = false
+	c.entries.Add(path, entry)
+}
+
+func (c *incrementalCache) close() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.entries.Purge()
+}
+
+// ParseIncremental 解析最近编辑过的文件。缓存中有该文件上次的语法树时，根据新旧内容计算一次编辑，
+// 在旧树上增量解析，只在变更区域重新执行 BaseQueries，区域外的元素沿用上次结果并平移位置。
+// 没有缓存时全量解析，并缓存语法树供下次使用。
+// 返回的元素表与缓存共享元素对象，调用方不应修改元素（imports 除外，缓存中保存的是副本）。
+func (p *SourceFileParser) ParseIncremental(ctx context.Context,
+	sourceFile *types.SourceFile) (result *FileElementTable, err error) {
+	defer func() {
+		if r := recover(); r != nil {
+			stack := debug.Stack()
+			err = fmt.Errorf("panic during incremental parsing file %s: %v\nStack trace:\n%s",
+				sourceFile.Path, r, string(stack))
+			p.logger.Error("ParseIncremental panic recovered: %v", err)
+			result = nil
+		}
+	}()
+
+	langParser, err := lang.GetSitterParserByFilePath(sourceFile.Path)
+	if err != nil {
+		return nil, err
+	}
+
+	entry := p.incremental.take(sourceFile.Path)
+	if entry != nil && entry.language != langParser.Language {
+		entry.tree.Close()
+		entry = nil
+	}
+
+	state, err := p.parserPool.get(langParser)
+	if err != nil {
+		if entry != nil {
+			entry.tree.Close()
+		}
+		return nil, err
+	}
+	// 发生panic时解析器状态未知，不归还
+	panicked := true
+	defer func() {
+		if panicked {
+			state.close()
+		} else {
+			p.parserPool.put(langParser.Language, state)
+		}
+	}()
+
+	var next *incrementalEntry
+	if entry == nil {
+		next, err = p.parseAndCache(ctx, langParser, state, sourceFile)
+	} else {
+		next, err = p.reparse(ctx, langParser, state, entry, sourceFile)
+	}
+	panicked = false
+	if err != nil {
+		return nil, err
+	}
+	result = next.table
+	next.table = cacheCopy(next.table)
+	p.incremental.put(sourceFile.Path, next)
+	return result, nil
+}
+
+// Forget 丢弃文件的语法树缓存，文件删除或重命名时调用
+func (p *SourceFileParser) Forget(path string) {
+	if entry := p.incremental.take(path); entry != nil {
+		entry.tree.Close()
+	}
+}
+
+// parseAndCache 全量解析，保留语法树
+func (p *SourceFileParser) parseAndCache(ctx context.Context, langParser *lang.TreeSitterParser, state *parserState,
+	sourceFile *types.SourceFile) (*incrementalEntry, error) {
+	tree := state.parser.Parse(sourceFile.Content, nil)
+	if tree == nil {
+		return nil, fmt.Errorf("failed to parse file: %s", sourceFile.Path)
+	}
+	collector := newElementCollector()
+	// 缓存的元素会在后续增量解析中部分保留，逐个分配，避免少量旧元素拖住整块内存
+	if err := p.matchElements(ctx, langParser, state.cursor, tree, sourceFile, nil, collector.add); err != nil {
+		tree.Close()
+		return nil, err
+	}
+	return &incrementalEntry{
+		language: langParser.Language,
+		content:  sourceFile.Content,
+		tree:     tree,
+		table:    collector.table(sourceFile.Path, langParser.Language),
+	}, nil
+}
+
+// reparse 基于上次的语法树增量解析。entry 的语法树在这里被消费
+func (p *SourceFileParser) reparse(ctx context.Context, langParser *lang.TreeSitterParser, state *parserState,
+	entry *incrementalEntry, sourceFile *types.SourceFile) (*incrementalEntry, error) {
+	content := sourceFile.Content
+	if bytes.Equal(entry.content, content) {
+		// 内容没变，直接沿用
+		entry.table = tableCopy(entry.table, sourceFile.Path)
+		return entry, nil
+	}
+
+	oldTree := entry.tree
+	defer oldTree.Close()
+
+	edit := computeEdit(entry.content, content)
+	oldTree.Edit(&edit)
+	newTree := state.parser.Parse(content, oldTree)
+	if newTree == nil {
+		return nil, fmt.Errorf("failed to parse file: %s", sourceFile.Path)
+	}
+
+	// 变更区域（新坐标）：编辑本身，加上语法结构发生变化的范围
+	dirtyStart, dirtyEnd := edit.StartByte, edit.NewEndByte
+	dirty := newPointRange(edit.StartPosition, edit.NewEndPosition)
+	for _, r := range oldTree.ChangedRanges(newTree) {
+		if r.StartByte < dirtyStart {
+			dirtyStart = r.StartByte
+			dirty.start = r.StartPoint
+		}
+		if r.EndByte > dirtyEnd {
+			dirtyEnd = r.EndByte
+			dirty.end = r.EndPoint
+		}
+	}
+
+	next := &incrementalEntry{language: langParser.Language, content: content, tree: newTree}
+	if float64(dirtyEnd-dirtyStart) > incrementalMaxDirtyRatio*float64(len(content)) {
+		// 变更太大，平移旧元素得不偿失
+		collector := newElementCollector()
+		if err := p.matchElements(ctx, langParser, state.cursor, newTree, sourceFile, nil, collector.add); err != nil {
+			newTree.Close()
+			return nil, err
+		}
+		next.table = collector.table(sourceFile.Path, langParser.Language)
+		return next, nil
+	}
+
+	// 只在变更区域重新匹配。字节范围使用独立游标，避免污染池中复用的游标
+	cursor := sitter.NewQueryCursor()
+	defer cursor.Close()
+	cursor.SetByteRange(dirtyStart, dirtyEnd)
+	var changed []resolver.Element
+	err := p.matchElements(ctx, langParser, cursor, newTree, sourceFile, nil, func(element resolver.Element) {
+		if dirty.intersects(element.GetRange()) {
+			changed = append(changed, element)
+		}
+	})
+	if err != nil {
+		newTree.Close()
+		return nil, err
+	}
+
+	// 区域外的旧元素平移到新坐标，按是否位于变更区域之前拆成两段，保持元素顺序
+	edited := newPointRange(edit.StartPosition, edit.OldEndPosition)
+	var before, after []resolver.Element
+	shiftedRelations := make(map[*resolver.Relation]struct{})
+	keep := func(element resolver.Element) {
+		if edited.intersects(element.GetRange()) {
+			return
+		}
+		shifted := shiftRange(element.GetRange(), &edit)
+		if dirty.intersects(shifted) {
+			return
+		}
+		element.SetRange(shifted)
+		for _, relation := range element.GetRelations() {
+			if _, ok := shiftedRelations[relation]; ok || relation == nil {
+				continue
+			}
+			shiftedRelations[relation] = struct{}{}
+			relation.Range = shiftRange(relation.Range, &edit)
+		}
+		if comparePoint(rangeStart(shifted), dirty.start) < 0 {
+			before = append(before, element)
+		} else {
+			after = append(after, element)
+		}
+	}
+	old := entry.table
+	if old.Package != nil {
+		keep(old.Package)
+	}
+	for _, imp := range old.Imports {
+		keep(imp)
+	}
+	for _, element := range old.Elements {
+		keep(element)
+	}
+
+	collector := newElementCollector()
+	for _, elements := range [][]resolver.Element{before, changed, after} {
+		for _, element := range elements {
+			collector.add(element)
+		}
+	}
+	next.table = collector.table(sourceFile.Path, langParser.Language)
+	p.logger.Debug("incremental parse file %s, dirty bytes [%d,%d), reused %d elements, reparsed %d elements",
+		sourceFile.Path, dirtyStart, dirtyEnd, len(before)+len(after), len(changed))
+	return next, nil
+}
+
+// computeEdit 根据新旧内容的公共前后缀计算一次编辑
+func computeEdit(oldContent, newContent []byte) sitter.InputEdit {
+	minLen := len(oldContent)
+	if len(newContent) < minLen {
+		minLen = len(newContent)
+	}
+	prefix := 0
+	for prefix < minLen && oldContent[prefix] == newContent[prefix] {
+		prefix++
+	}
+	suffix := 0
+	for suffix < minLen-prefix &&
+		oldContent[len(oldContent)-1-suffix] == newContent[len(newContent)-1-suffix] {
+		suffix++
+	}
+	oldEnd := len(oldContent) - suffix
+	newEnd := len(newContent) - suffix
+	return sitter.InputEdit{
+		StartByte:      uint(prefix),
+		OldEndByte:     uint(oldEnd),
+		NewEndByte:     uint(newEnd),
+		StartPosition:  pointAt(oldContent, prefix),
+		OldEndPosition: pointAt(oldContent, oldEnd),
+		NewEndPosition: pointAt(newContent, newEnd),
+	}
+}
+
+// pointAt 字节偏移对应的行列，列为行内字节偏移，与tree-sitter一致
+func pointAt(content []byte, offset int) sitter.Point {
+	row := bytes.Count(content[:offset], []byte{'\n'})
+	lineStart := bytes.LastIndexByte(content[:offset], '\n') + 1
+	return sitter.Point{Row: uint(row), Column: uint(offset - lineStart)}
+}
+
+// shiftRange 将编辑前的 [开始行,开始列,结束行,结束列] 平移到编辑后的坐标，返回新切片
+func shiftRange(r []int32, edit *sitter.InputEdit) []int32 {
+	if len(r) < 4 {
+		return r
+	}
+	start := shiftPoint(sitter.Point{Row: uint(r[0]), Column: uint(r[1])}, edit)
+	end := shiftPoint(sitter.Point{Row: uint(r[2]), Column: uint(r[3])}, edit)
+	return []int32{int32(start.Row), int32(start.Column), int32(end.Row), int32(end.Column)}
+}
+
+func shiftPoint(point sitter.Point, edit *sitter.InputEdit) sitter.Point {
+	if comparePoint(point, edit.OldEndPosition) >= 0 {
+		shifted := sitter.Point{Row: point.Row + edit.NewEndPosition.Row - edit.OldEndPosition.Row, Column: point.Column}
+		if point.Row == edit.OldEndPosition.Row {
+			shifted.Column = edit.NewEndPosition.Column + point.Column - edit.OldEndPosition.Column
+		}
+		return shifted
+	}
+	if comparePoint(point, edit.StartPosition) > 0 {
+		return edit.NewEndPosition
+	}
+	return point
+}
+
+func comparePoint(a, b sitter.Point) int {
+	switch {
+	case a.Row < b.Row:
+		return -1
+	case a.Row > b.Row:
+		return 1
+	case a.Column < b.Column:
+		return -1
+	case a.Column > b.Column:
+		return 1
+	}
+	return 0
+}
+
+func rangeStart(r []int32) sitter.Point {
+	return sitter.Point{Row: uint(r[0]), Column: uint(r[1])}
+}
+
+// pointRange 闭区间，边界相接也视为相交，宁可多重新解析
+type pointRange struct {
+	start sitter.Point
+	end   sitter.Point
+}
+
+func newPointRange(start, end sitter.Point) pointRange {
+	return pointRange{start: start, end: end}
+}
+
+func (pr pointRange) intersects(r []int32) bool {
+	if len(r) < 4 {
+		return true
+	}
+	start := rangeStart(r)
+	end := sitter.Point{Row: uint(r[2]), Column: uint(r[3])}
+	return comparePoint(start, pr.end) <= 0 && comparePoint(end, pr.start) >= 0
+}
+
+// tableCopy 复制元素表的切片，元素对象共享
+func tableCopy(table *FileElementTable, path string) *FileElementTable {
+	return &FileElementTable{
+		Path:     path,
+		Package:  table.Package,
+		Imports:  append([]*resolver.Import(nil), table.Imports...),
+		Language: table.Language,
+		Elements: append([]resolver.Element(nil), table.Elements...),
+	}
+}
+
+// cacheCopy 缓存用的元素表副本。imports 会被调用方预处理时原地修改，需要复制对象
+func cacheCopy(table *FileElementTable) *FileElementTable {
+	cached := tableCopy(table, table.Path)
+	for i, imp := range cached.Imports {
+		base := *imp.BaseElement
+		cached.Imports[i] = &resolver.Import{BaseElement: &base, Source: imp.Source, Alias: imp.Alias}
+	}
+	return cached
+}
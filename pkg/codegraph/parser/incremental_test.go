@@ -0,0 +1,72 @@
+package parser
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/types"
+	"context"
+	"fmt"
+	"sort"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+	sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+func elementSignatures(table *FileElementTable) []string {
+	signatures := make([]string, 0, len(table.Elements))
+	for _, e := range table.Elements {
+		signatures = append(signatures, fmt.Sprintf("%s|%s|%v", e.GetName(), e.GetType(), e.GetRange()))
+	}
+	sort.Strings(signatures)
+	return signatures
+}
+
+func TestParseIncremental_MatchesFullParse(t *testing.T) {
+	logger := initLogger()
+	parser := NewSourceFileParser(logger)
+	defer parser.Close()
+
+	content := readFile("testdata/test.go")
+	// 在文件中间插入一个函数，插入点之后的元素位置整体下移
+	anchor := []byte("\nfunc (c Circle) Area() float64 {")
+	pos := bytes.Index(content, anchor)
+	require.Greater(t, pos, 0)
+	inserted := []byte("\nfunc inserted(x int) int {\n\t_, y := add(x, 1)\n\treturn y\n}\n")
+	modified := append(append(append([]byte{}, content[:pos]...), inserted...), content[pos:]...)
+
+	// 第一次没有缓存，全量解析并缓存语法树
+	_, err := parser.ParseIncremental(context.Background(), &types.SourceFile{Path: "test.go", Content: content})
+	require.NoError(t, err)
+
+	incremental, err := parser.ParseIncremental(context.Background(), &types.SourceFile{Path: "test.go", Content: modified})
+	require.NoError(t, err)
+	full, err := parser.Parse(context.Background(), &types.SourceFile{Path: "test.go", Content: modified})
+	require.NoError(t, err)
+
+	assert.Equal(t, elementSignatures(full), elementSignatures(incremental))
+	assert.Equal(t, len(full.Imports), len(incremental.Imports))
+
+	// 还原修改，同样与全量解析一致
+	restored, err := parser.ParseIncremental(context.Background(), &types.SourceFile{Path: "test.go", Content: content})
+	require.NoError(t, err)
+	original, err := parser.Parse(context.Background(), &types.SourceFile{Path: "test.go", Content: content})
+	require.NoError(t, err)
+	assert.Equal(t, elementSignatures(original), elementSignatures(restored))
+}
+
+func TestComputeEdit(t *testing.T) {
+	oldContent := []byte("a\nbc\nd")
+	newContent := []byte("a\nbXYc\nd")
+	edit := computeEdit(oldContent, newContent)
+	assert.Equal(t, uint(3), edit.StartByte)
+	assert.Equal(t, uint(3), edit.OldEndByte)
+	assert.Equal(t, uint(5), edit.NewEndByte)
+	assert.Equal(t, sitter.Point{Row: 1, Column: 1}, edit.StartPosition)
+	assert.Equal(t, sitter.Point{Row: 1, Column: 3}, edit.NewEndPosition)
+
+	// 编辑点之后同一行的列平移，之后行的行号不变
+	assert.Equal(t, []int32{1, 4, 2, 1}, shiftRange([]int32{1, 2, 2, 1}, &edit))
+	// 编辑点之前不变
+	assert.Equal(t, []int32{0, 0, 0, 1}, shiftRange([]int32{0, 0, 0, 1}, &edit))
+}
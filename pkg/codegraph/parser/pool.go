@@ -0,0 +1,79 @@
+package parser
+
+import (
+	"codebase-indexer/pkg/codegraph/lang"
+	"runtime"
+
+	sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+// parserState 已设置好语言的解析器和查询游标，取出后归当前goroutine独占，跨文件复用
+type parserState struct {
+	parser *sitter.Parser
+	cursor *sitter.QueryCursor
+}
+
+func (s *parserState) close() {
+	s.cursor.Close()
+	s.parser.Close()
+}
+
+// parserPool 按语言缓存空闲的解析器状态，每种语言最多保留 maxIdle 个。
+// 不用 sync.Pool，是因为它在GC时直接丢弃对象，C侧内存无法释放。
+// BaseQueries 只读，可被多个游标并发使用，查询游标则不跨goroutine共享。
+type parserPool struct {
+	idle map[lang.Language]chan *parserState
+}
+
+func newParserPool(maxIdle int) *parserPool {
+	if maxIdle <= 0 {
+		maxIdle = runtime.GOMAXPROCS(0)
+	}
+	pool := &parserPool{idle: make(map[lang.Language]chan *parserState)}
+	// 初始化后只读，不需要加锁
+	for _, l := range lang.GetTreeSitterParsers() {
+		pool.idle[l.Language] = make(chan *parserState, maxIdle)
+	}
+	return pool
+}
+
+// get 取出一个空闲的解析器状态，没有则新建
+func (p *parserPool) get(langParser *lang.TreeSitterParser) (*parserState, error) {
+	select {
+	case state := <-p.idle[langParser.Language]:
+		return state, nil
+	default:
+	}
+
+	sitterParser := sitter.NewParser()
+	if err := sitterParser.SetLanguage(langParser.SitterLanguage()); err != nil {
+		sitterParser.Close()
+		return nil, err
+	}
+	return &parserState{parser: sitterParser, cursor: sitter.NewQueryCursor()}, nil
+}
+
+// put 归还解析器状态，超过空闲上限则直接释放
+func (p *parserPool) put(language lang.Language, state *parserState) {
+	state.parser.Reset()
+	select {
+	case p.idle[language] <- state:
+	default:
+		state.close()
+	}
+}
+
+// close 释放所有空闲的解析器状态
+func (p *parserPool) close() {
+	for _, idle := range p.idle {
+		for {
+			select {
+			case state := <-idle:
+				state.close()
+				continue
+			default:
+			}
+			break
+		}
+	}
+}
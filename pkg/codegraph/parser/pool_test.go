@@ -0,0 +1,47 @@
+package parser
+
+import (
+	"codebase-indexer/pkg/codegraph/types"
+	"context"
+	"sync"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestSourceFileParser_ReuseParserConcurrently(t *testing.T) {
+	logger := initLogger()
+	parser := NewSourceFileParser(logger)
+	defer parser.Close()
+
+	files := []*types.SourceFile{
+		{Path: "test.go", Content: readFile("testdata/test.go")},
+		{Path: "test.java", Content: readFile("testdata/test.java")},
+	}
+	// 单次解析的结果作为基准
+	expected := make([]int, len(files))
+	for i, f := range files {
+		res, err := parser.Parse(context.Background(), f)
+		require.NoError(t, err)
+		expected[i] = len(res.Elements)
+	}
+
+	// 多个goroutine复用解析器，结果应与单次解析一致
+	var wg sync.WaitGroup
+	for w := 0; w < 8; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for round := 0; round < 10; round++ {
+				for i, f := range files {
+					res, err := parser.Parse(context.Background(), f)
+					if assert.NoError(t, err) {
+						assert.Equal(t, expected[i], len(res.Elements))
+					}
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
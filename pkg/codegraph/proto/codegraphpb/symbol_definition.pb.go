@@ -89,6 +89,7 @@ type Occurrence struct {
 	Range         []int32                `protobuf:"varint,2,rep,packed,name=range,proto3" json:"range,omitempty"`
 	ElementType   ElementType            `protobuf:"varint,3,opt,name=element_type,json=elementType,proto3,enum=codegraphpb.ElementType" json:"element_type,omitempty"`
 	RelationType  RelationType           `protobuf:"varint,4,opt,name=relation_type,json=relationType,proto3,enum=codegraphpb.RelationType" json:"relation_type,omitempty"`
+	FileId        uint32                 `protobuf:"varint,5,opt,name=file_id,json=fileId,proto3" json:"file_id,omitempty"`
 	unknownFields protoimpl.UnknownFields
 	sizeCache     protoimpl.SizeCache
 }
@@ -151,6 +152,13 @@ func (x *Occurrence) GetRelationType() RelationType {
 	return RelationType_RELATION_UNDEFINED
 }
 
+func (x *Occurrence) GetFileId() uint32 {
+	if x != nil {
+		return x.FileId
+	}
+	return 0
+}
+
 var File_pkg_codegraph_proto_symbol_definition_proto protoreflect.FileDescriptor
 
 const file_pkg_codegraph_proto_symbol_definition_proto_rawDesc = "" +
@@ -159,13 +167,14 @@ const file_pkg_codegraph_proto_symbol_definition_proto_rawDesc = "" +
 	"\x10SymbolOccurrence\x12\x12\n" +
 	"\x04name\x18\x01 \x01(\tR\x04name\x12\x1a\n" +
 	"\blanguage\x18\x02 \x01(\tR\blanguage\x129\n" +
-	"\voccurrences\x18\x03 \x03(\v2\x17.codegraphpb.OccurrenceR\voccurrences\"\xb3\x01\n" +
+	"\voccurrences\x18\x03 \x03(\v2\x17.codegraphpb.OccurrenceR\voccurrences\"\xcc\x01\n" +
 	"\n" +
 	"Occurrence\x12\x12\n" +
 	"\x04path\x18\x01 \x01(\tR\x04path\x12\x14\n" +
 	"\x05range\x18\x02 \x03(\x05R\x05range\x12;\n" +
 	"\felement_type\x18\x03 \x01(\x0e2\x18.codegraphpb.ElementTypeR\velementType\x12>\n" +
-	"\rrelation_type\x18\x04 \x01(\x0e2\x19.codegraphpb.RelationTypeR\frelationTypeB-Z+pkg/codegraph/proto/codegraphpb;codegraphpbb\x06proto3"
+	"\rrelation_type\x18\x04 \x01(\x0e2\x19.codegraphpb.RelationTypeR\frelationType\x12\x17\n" +
+	"\afile_id\x18\x05 \x01(\rR\x06fileIdB-Z+pkg/codegraph/proto/codegraphpb;codegraphpbb\x06proto3"
 
 var (
 	file_pkg_codegraph_proto_symbol_definition_proto_rawDescOnce sync.Once
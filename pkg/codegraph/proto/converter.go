@@ -208,52 +208,58 @@ func FileElementTablesToProto(fileElementTables []*parser.FileElementTable) []*c
 	}
 	protoElementTables := make([]*codegraphpb.FileElementTable, len(fileElementTables))
 	for j, ft := range fileElementTables {
-		pft := &codegraphpb.FileElementTable{
-			Path:      ft.Path,
-			Language:  string(ft.Language),
-			Timestamp: ft.Timestamp,
-			Elements:  make([]*codegraphpb.Element, len(ft.Elements)),
-			Imports:   make([]*codegraphpb.Import, len(ft.Imports)),
-		}
-		if ft.Package != nil {
-			pft.Package = &codegraphpb.Package{Name: ft.Package.Name, Range: ft.Package.Range}
-		}
+		protoElementTables[j] = FileElementTableToProto(ft)
+	}
+	return protoElementTables
+}
 
-		for i, imp := range ft.Imports {
-			pft.Imports[i] = &codegraphpb.Import{Name: imp.Name, Source: imp.Source,
-				Alias: imp.Alias, Range: imp.Range}
-		}
+// FileElementTableToProto 将单个 parser.FileElementTable 转换为 *codegraphpb.FileElementTable。
+// 字符串和 Range 与解析结果共享，不再复制
+func FileElementTableToProto(ft *parser.FileElementTable) *codegraphpb.FileElementTable {
+	pft := &codegraphpb.FileElementTable{
+		Path:      ft.Path,
+		Language:  string(ft.Language),
+		Timestamp: ft.Timestamp,
+		Elements:  make([]*codegraphpb.Element, len(ft.Elements)),
+		Imports:   make([]*codegraphpb.Import, len(ft.Imports)),
+	}
+	if ft.Package != nil {
+		pft.Package = &codegraphpb.Package{Name: ft.Package.Name, Range: ft.Package.Range}
+	}
 
-		for k, e := range ft.Elements {
-			pbe := &codegraphpb.Element{
-				Name:        e.GetName(),
-				ElementType: ElementTypeToProto(e.GetType()),
-				Range:       e.GetRange(),
-			}
-			// 定义：class interface method function variable
-			if e.GetType() == types.ElementTypeClass || e.GetType() == types.ElementTypeInterface ||
-				e.GetType() == types.ElementTypeMethod || e.GetType() == types.ElementTypeFunction ||
-				e.GetType() == types.ElementTypeVariable {
-				pbe.IsDefinition = true
-			}
+	for i, imp := range ft.Imports {
+		pft.Imports[i] = &codegraphpb.Import{Name: imp.Name, Source: imp.Source,
+			Alias: imp.Alias, Range: imp.Range}
+	}
 
-			//for _, r := range e.GetRelations() {
-			//	pbe.Relations = append(pbe.Relations, RelationToProto(r))
-			//}
-			// extra_data
-			extraData, err := MarshalExtraData(e)
-			if err != nil {
-				// TODO remove this debug info
-				fmt.Printf("marshal extra data error:%v", err)
-			} else {
-				pbe.ExtraData = extraData
-			}
-			pft.Elements[k] = pbe
+	// 元素按块分配，减少小对象数量
+	pbElements := make([]codegraphpb.Element, len(ft.Elements))
+	for k, e := range ft.Elements {
+		pbe := &pbElements[k]
+		pbe.Name = e.GetName()
+		pbe.ElementType = ElementTypeToProto(e.GetType())
+		pbe.Range = e.GetRange()
+		// 定义：class interface method function variable
+		if e.GetType() == types.ElementTypeClass || e.GetType() == types.ElementTypeInterface ||
+			e.GetType() == types.ElementTypeMethod || e.GetType() == types.ElementTypeFunction ||
+			e.GetType() == types.ElementTypeVariable {
+			pbe.IsDefinition = true
 		}
 
-		protoElementTables[j] = pft
+		//for _, r := range e.GetRelations() {
+		//	pbe.Relations = append(pbe.Relations, RelationToProto(r))
+		//}
+		// extra_data
+		extraData, err := MarshalExtraData(e)
+		if err != nil {
+			// TODO remove this debug info
+			fmt.Printf("marshal extra data error:%v", err)
+		} else {
+			pbe.ExtraData = extraData
+		}
+		pft.Elements[k] = pbe
 	}
-	return protoElementTables
+	return pft
 }
 
 func GetParametersFromExtraData(extraData map[string][]byte) (parameters []resolver.Parameter, err error) {
@@ -292,9 +298,16 @@ func GetSuperInterfacesFromExtraData(extraData map[string][]byte) (superInterfac
 	return
 }
 
+// MarshalExtraData 序列化元素的附加信息，没有附加信息时返回 nil
 func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 	var errs []error
-	extraData := make(map[string][]byte)
+	var extraData map[string][]byte
+	set := func(key string, value []byte) {
+		if extraData == nil {
+			extraData = make(map[string][]byte, 2)
+		}
+		extraData[key] = value
+	}
 
 	switch e := element.(type) {
 	case *resolver.Import, *resolver.Package, *resolver.Variable:
@@ -306,7 +319,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keyParameters] = parametersBytes
+				set(keyParameters, parametersBytes)
 			}
 		}
 
@@ -315,7 +328,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keyReturnType] = returnTypeBytes
+				set(keyReturnType, returnTypeBytes)
 			}
 		}
 
@@ -326,7 +339,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keyParameters] = parametersBytes
+				set(keyParameters, parametersBytes)
 			}
 		}
 
@@ -335,7 +348,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keyReturnType] = returnTypeBytes
+				set(keyReturnType, returnTypeBytes)
 			}
 		}
 
@@ -345,7 +358,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keySuperClasses] = superClassesBytes
+				set(keySuperClasses, superClassesBytes)
 			}
 		}
 
@@ -354,7 +367,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keySuperInterfaces] = superInterfacesBytes
+				set(keySuperInterfaces, superInterfacesBytes)
 			}
 		}
 
@@ -364,7 +377,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keySuperInterfaces] = superInterfacesBytes
+				set(keySuperInterfaces, superInterfacesBytes)
 			}
 		}
 
@@ -374,7 +387,7 @@ func MarshalExtraData(element resolver.Element) (map[string][]byte, error) {
 			if err != nil {
 				errs = append(errs, err)
 			} else {
-				extraData[keyParameters] = parametersBytes
+				set(keyParameters, parametersBytes)
 			}
 		}
 	}
@@ -0,0 +1,63 @@
+package resolver
+
+import (
+	"codebase-indexer/pkg/codegraph/types"
+
+	sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+const arenaChunkSize = 128
+
+// ElementArena 单个文件解析结果的分块分配器。同一文件的元素随文件元素表一起释放，
+// 按块分配 BaseElement 和 Range，把大量小对象合并成少量大块。不能跨文件复用；nil 时逐个分配
+type ElementArena struct {
+	bases  []BaseElement
+	ranges []int32
+}
+
+func NewElementArena() *ElementArena {
+	return &ElementArena{}
+}
+
+// NewBaseElement 从当前块中分配 BaseElement
+func (a *ElementArena) NewBaseElement(rootCaptureIndex uint32) *BaseElement {
+	if a == nil {
+		return NewBaseElement(rootCaptureIndex)
+	}
+	if len(a.bases) == 0 {
+		a.bases = make([]BaseElement, arenaChunkSize)
+	}
+	base := &a.bases[0]
+	a.bases = a.bases[1:]
+	base.rootCaptureIndex = rootCaptureIndex
+	return base
+}
+
+// NodeRange 从当前块中分配节点的 [开始行，开始列，结束行，结束列]
+func (a *ElementArena) NodeRange(node *sitter.Node) []int32 {
+	var r []int32
+	if a == nil {
+		r = make([]int32, 4)
+	} else {
+		if len(a.ranges) < 4 {
+			a.ranges = make([]int32, arenaChunkSize*4)
+		}
+		// 限定容量，append 时不会覆盖相邻元素的 Range
+		r = a.ranges[:4:4]
+		a.ranges = a.ranges[4:]
+	}
+	start, end := node.StartPosition(), node.EndPosition()
+	r[0], r[1], r[2], r[3] = int32(start.Row), int32(start.Column), int32(end.Row), int32(end.Column)
+	return r
+}
+
+// newReference 同 NewReference，从文件的分配器中分配
+func (rc *ResolveContext) newReference(rootElement Element, curNode *sitter.Node, name string, owner string) *Reference {
+	base := rc.Arena.NewBaseElement(0)
+	base.Name = name
+	base.Path = rootElement.GetPath()
+	base.Type = types.ElementTypeReference
+	base.Range = rc.Arena.NodeRange(curNode)
+	base.Scope = types.ScopeFunction
+	return &Reference{BaseElement: base, Owner: owner}
+}
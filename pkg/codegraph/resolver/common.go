@@ -1,6 +1,7 @@
 package resolver
 
 import (
+	"bytes"
 	"codebase-indexer/pkg/codegraph/types"
 	"codebase-indexer/pkg/logger"
 	"fmt"
@@ -207,7 +208,27 @@ func findAllIdentifiers(node *sitter.Node, content []byte) []string {
 	return identifiers
 }
 
-func findFirstIdentifier(node *sitter.Node, content []byte) string {
+// maxInternedTextLen 驻留的文本长度上限。标识符、类型名通常很短，更长的文本（如复杂的参数表达式）直接复制，
+// 不放进整批共享的驻留表
+const maxInternedTextLen = 128
+
+// text 返回标识符、类型等短捕获去掉首尾空白后的文本，相同内容复用驻留的字符串。
+// 类、命名空间、方法体等根捕获不应调用，需要时直接读取 SourceFile.Content
+func (rc *ResolveContext) text(node *sitter.Node) string {
+	b := bytes.TrimSpace(rc.SourceFile.Content[node.StartByte():node.EndByte()])
+	if len(b) > maxInternedTextLen {
+		return string(b)
+	}
+	return rc.Strings.InternBytes(b)
+}
+
+// typeIdentifiers 递归查找节点下所有的type_identifier
+func (rc *ResolveContext) typeIdentifiers(node *sitter.Node) []string {
+	return collectIdentifiers(node, types.NodeKindTypeIdentifier, rc.text)
+}
+
+// firstIdentifier 查找节点下第一个identifier
+func (rc *ResolveContext) firstIdentifier(node *sitter.Node) string {
 	if node == nil {
 		return types.EmptyString
 	}
@@ -215,7 +236,7 @@ func findFirstIdentifier(node *sitter.Node, content []byte) string {
 	var walk func(n *sitter.Node)
 	walk = func(n *sitter.Node) {
 		if types.ToNodeKind(n.Kind()) == types.NodeKindIdentifier {
-			identifier = StripSpaces(n.Utf8Text(content))
+			identifier = rc.text(n)
 			return
 		}
 		for i := uint(0); i < n.NamedChildCount(); i++ {
@@ -223,29 +244,27 @@ func findFirstIdentifier(node *sitter.Node, content []byte) string {
 			if child.IsMissing() || child.IsError() {
 				continue
 			}
-			switch types.ToNodeKind(child.Kind()) {
-			case types.NodeKindIdentifier:
-				identifier = StripSpaces(child.Utf8Text(content))
+			if types.ToNodeKind(child.Kind()) == types.NodeKindIdentifier {
+				identifier = rc.text(child)
 				return
-			default:
-				// 递归查找类型中的标识符
-				walk(child)
 			}
+			walk(child)
 		}
 	}
 	walk(node)
 	return identifier
 }
 
-func findAllTypeIdentifiers(node *sitter.Node, content []byte) []string {
+// collectIdentifiers 递归收集 kind 类型节点的文本，不进入已匹配节点的子节点
+func collectIdentifiers(node *sitter.Node, kind types.NodeKind, text func(*sitter.Node) string) []string {
 	if node == nil {
 		return nil
 	}
 	var identifiers []string
 	var walk func(n *sitter.Node)
 	walk = func(n *sitter.Node) {
-		if types.ToNodeKind(n.Kind()) == types.NodeKindTypeIdentifier {
-			identifiers = append(identifiers, n.Utf8Text(content))
+		if types.ToNodeKind(n.Kind()) == kind {
+			identifiers = append(identifiers, text(n))
 			return
 		}
 		for i := uint(0); i < n.NamedChildCount(); i++ {
@@ -253,13 +272,7 @@ func findAllTypeIdentifiers(node *sitter.Node, content []byte) []string {
 			if child.IsMissing() || child.IsError() {
 				continue
 			}
-			switch types.ToNodeKind(child.Kind()) {
-			case types.NodeKindTypeIdentifier:
-				identifiers = append(identifiers, child.Utf8Text(content))
-			default:
-				// 递归查找类型中的标识符
-				walk(child)
-			}
+			walk(child)
 		}
 	}
 	walk(node)
@@ -11,6 +11,9 @@ import (
 type CppResolver struct {
 }
 
+// primitiveTypes 基础类型占位，所有元素只读共享，避免每个元素分配
+var primitiveTypes = []string{types.PrimitiveType}
+
 var _ ElementResolver = &CppResolver{}
 
 func (c *CppResolver) Resolve(ctx context.Context, element Element, rc *ResolveContext) ([]Element, error) {
@@ -25,11 +28,10 @@ func (c *CppResolver) resolveImport(ctx context.Context, element *Import, rc *Re
 		if cap.Node.IsMissing() || cap.Node.IsError() {
 			continue
 		}
-		content := cap.Node.Utf8Text(rc.SourceFile.Content)
 		switch types.ToElementType(captureName) {
 		case types.ElementTypeImportName:
 			// 容错处理，出现空格，语法会报错，但也应该能解析
-			element.BaseElement.Name = StripSpaces(content)
+			element.BaseElement.Name = rc.text(&cap.Node)
 		}
 	}
 	element.BaseElement.Scope = types.ScopeProject
@@ -51,16 +53,16 @@ func (c *CppResolver) resolveFunction(ctx context.Context, element *Function, rc
 		}
 		switch types.ToElementType(captureName) {
 		case types.ElementTypeFunctionName:
-			element.BaseElement.Name = findFirstIdentifier(&cap.Node, rc.SourceFile.Content)
+			element.BaseElement.Name = rc.firstIdentifier(&cap.Node)
 			element.Declaration.Name = element.BaseElement.Name
 		case types.ElementTypeFunctionReturnType:
-			typs := findAllTypeIdentifiers(&cap.Node, rc.SourceFile.Content)
+			typs := rc.typeIdentifiers(&cap.Node)
 			element.Declaration.ReturnType = typs
 			if len(element.Declaration.ReturnType) == 0 {
-				element.Declaration.ReturnType = []string{types.PrimitiveType}
+				element.Declaration.ReturnType = primitiveTypes
 			}
 		case types.ElementTypeFunctionParameters:
-			parameters := parseCppParameters(&cap.Node, rc.SourceFile.Content)
+			parameters := parseCppParameters(&cap.Node, rc)
 			element.Declaration.Parameters = parameters
 		}
 	}
@@ -79,17 +81,16 @@ func (c *CppResolver) resolveMethod(ctx context.Context, element *Method, rc *Re
 		if cap.Node.IsMissing() || cap.Node.IsError() {
 			continue
 		}
-		content := cap.Node.Utf8Text(rc.SourceFile.Content)
 		switch types.ToElementType(captureName) {
 		case types.ElementTypeMethodReturnType:
-			element.Declaration.ReturnType = findAllTypeIdentifiers(&cap.Node, rc.SourceFile.Content)
+			element.Declaration.ReturnType = rc.typeIdentifiers(&cap.Node)
 			if len(element.Declaration.ReturnType) == 0 {
-				element.Declaration.ReturnType = []string{types.PrimitiveType}
+				element.Declaration.ReturnType = primitiveTypes
 			}
 		case types.ElementTypeMethodParameters:
-			element.Declaration.Parameters = parseCppParameters(&cap.Node, rc.SourceFile.Content)
+			element.Declaration.Parameters = parseCppParameters(&cap.Node, rc)
 		case types.ElementTypeMethodName:
-			element.BaseElement.Name = StripSpaces(content)
+			element.BaseElement.Name = rc.text(&cap.Node)
 			element.Declaration.Name = element.BaseElement.Name
 		}
 	}
@@ -97,7 +98,7 @@ func (c *CppResolver) resolveMethod(ctx context.Context, element *Method, rc *Re
 	ownerNode := findMethodOwner(&rootCap.Node)
 	var ownerKind types.NodeKind
 	if ownerNode != nil {
-		element.Owner = extractNodeName(ownerNode, rc.SourceFile.Content)
+		element.Owner = rc.Strings.Intern(extractNodeName(ownerNode, rc.SourceFile.Content))
 		ownerKind = types.ToNodeKind(ownerNode.Kind())
 	}
 	modifier := findAccessSpecifier(&rootCap.Node, rc.SourceFile.Content)
@@ -116,23 +117,21 @@ func (c *CppResolver) resolveClass(ctx context.Context, element *Class, rc *Reso
 		if cap.Node.IsMissing() || cap.Node.IsError() {
 			continue
 		}
-		content := cap.Node.Utf8Text(rc.SourceFile.Content)
 		switch types.ToElementType(captureName) {
 		case types.ElementTypeClassName, types.ElementTypeStructName, types.ElementTypeEnumName,
 			types.ElementTypeUnionName, types.ElementTypeNamespaceName:
 			// 枚举类型只考虑name
-			element.BaseElement.Name = StripSpaces(content)
+			element.BaseElement.Name = rc.text(&cap.Node)
 		case types.ElementTypeTypedefAlias, types.ElementTypeTypeAliasAlias:
 			// typedef只考虑alias
-			name := StripSpaces(content)
 			// 去除指针引用以及修饰符
-			name = CleanParam(name)
+			name := CleanParam(rc.text(&cap.Node))
 			element.BaseElement.Name = name
 		case types.ElementTypeClassExtends, types.ElementTypeStructExtends:
 			// 不考虑cpp的ns调用，owner暂时无用
-			typs := parseBaseClassClause(&cap.Node, rc.SourceFile.Content)
+			typs := parseBaseClassClause(&cap.Node, rc)
 			for _, typ := range typs {
-				refs = append(refs, NewReference(element, &cap.Node, typ, types.EmptyString))
+				refs = append(refs, rc.newReference(element, &cap.Node, typ, types.EmptyString))
 				element.SuperClasses = append(element.SuperClasses, typ)
 			}
 		}
@@ -155,11 +154,10 @@ func (c *CppResolver) resolveVariable(ctx context.Context, element *Variable, rc
 		if cap.Node.IsMissing() || cap.Node.IsError() {
 			continue
 		}
-		content := cap.Node.Utf8Text(rc.SourceFile.Content)
 		switch types.ToElementType(captureName) {
 		case types.ElementTypeVariableName, types.ElementTypeFieldName:
 			// 去除指针引用
-			element.BaseElement.Name = CleanParam(content)
+			element.BaseElement.Name = CleanParam(rc.text(&cap.Node))
 			if isLocalVariable(&cap.Node) {
 				element.BaseElement.Scope = types.ScopeFunction
 			} else {
@@ -167,18 +165,18 @@ func (c *CppResolver) resolveVariable(ctx context.Context, element *Variable, rc
 				element.BaseElement.Scope = types.ScopeClass
 			}
 		case types.ElementTypeVariableType, types.ElementTypeFieldType:
-			typs := findAllTypeIdentifiers(&cap.Node, rc.SourceFile.Content)
+			typs := rc.typeIdentifiers(&cap.Node)
 			for _, typ := range typs {
-				refs = append(refs, NewReference(element, &cap.Node, typ, types.EmptyString))
+				refs = append(refs, rc.newReference(element, &cap.Node, typ, types.EmptyString))
 			}
 			element.VariableType = typs
 			if len(element.VariableType) == 0 {
-				element.VariableType = []string{types.PrimitiveType}
+				element.VariableType = primitiveTypes
 			}
 		case types.ElementTypeEnumConstantName:
 			// 枚举的类型不考虑，都是基础类型（有匿名枚举）
-			element.BaseElement.Name = StripSpaces(content)
-			element.VariableType = []string{types.PrimitiveType}
+			element.BaseElement.Name = rc.text(&cap.Node)
+			element.VariableType = primitiveTypes
 			element.BaseElement.Scope = types.ScopeClass
 		}
 	}
@@ -202,33 +200,32 @@ func (c *CppResolver) resolveCall(ctx context.Context, element *Call, rc *Resolv
 		if cap.Node.IsMissing() || cap.Node.IsError() {
 			continue
 		}
-		content := cap.Node.Utf8Text(rc.SourceFile.Content)
 		switch types.ToElementType(captureName) {
 		case types.ElementTypeFunctionCallName, types.ElementTypeCallName, types.ElementTypeTemplateCallName,
 			types.ElementTypeNewExpressionType:
-			element.BaseElement.Name = findFirstIdentifier(&cap.Node, rc.SourceFile.Content)
+			element.BaseElement.Name = rc.firstIdentifier(&cap.Node)
 			if element.BaseElement.Name == types.EmptyString {
 				// 避免为空
-				element.BaseElement.Name = StripSpaces(content)
+				element.BaseElement.Name = rc.text(&cap.Node)
 			}
 		case types.ElementTypeFunctionOwner, types.ElementTypeCallOwner, types.ElementTypeNewExpressionOwner:
-			element.Owner = StripSpaces(content)
+			element.Owner = rc.text(&cap.Node)
 		case types.ElementTypeTemplateCallArgs:
-			typs := findAllTypeIdentifiers(&cap.Node, rc.SourceFile.Content)
+			typs := rc.typeIdentifiers(&cap.Node)
 			if len(typs) != 0 {
 				for _, typ := range typs {
 					// TODO 可以考虑解析出来命名空间
-					refs = append(refs, NewReference(element, &cap.Node, typ, types.EmptyString))
+					refs = append(refs, rc.newReference(element, &cap.Node, typ, types.EmptyString))
 				}
 			}
 		case types.ElementTypeCompoundLiteralType:
-			names := findAllTypeIdentifiers(&cap.Node, rc.SourceFile.Content)
+			names := rc.typeIdentifiers(&cap.Node)
 			// (struct MyStruct)
 			if len(names) != 0 {
 				// 找到第一个类型，作为name
-				element.BaseElement.Name = StripSpaces(names[0])
+				element.BaseElement.Name = names[0]
 			} else {
-				element.BaseElement.Name = StripSpaces(content)
+				element.BaseElement.Name = rc.text(&cap.Node)
 			}
 		case types.ElementTypeFunctionArguments, types.ElementTypeCallArguments, types.ElementTypeNewExpressionArgs:
 			// 暂时只保留name，参数类型先不考虑
@@ -238,9 +235,8 @@ func (c *CppResolver) resolveCall(ctx context.Context, element *Call, rc *Resolv
 					// 过滤comment
 					continue
 				}
-				argContent := arg.Utf8Text(rc.SourceFile.Content)
 				element.Parameters = append(element.Parameters, &Parameter{
-					Name: StripSpaces(argContent),
+					Name: rc.text(arg),
 					Type: []string{},
 				})
 			}
@@ -282,7 +278,7 @@ func findAccessSpecifier(node *sitter.Node, content []byte) string {
 	return types.EmptyString
 }
 
-func parseCppParameters(node *sitter.Node, content []byte) []Parameter {
+func parseCppParameters(node *sitter.Node, rc *ResolveContext) []Parameter {
 
 	if node == nil || types.ToNodeKind(node.Kind()) != types.NodeKindParameterList {
 		return nil
@@ -296,9 +292,9 @@ func parseCppParameters(node *sitter.Node, content []byte) []Parameter {
 		childKind := child.Kind()
 		switch types.ToNodeKind(childKind) {
 		case types.NodeKindParameterDeclaration:
-			typs := findAllTypeIdentifiers(child, content)
+			typs := rc.typeIdentifiers(child)
 			if len(typs) == 0 {
-				typs = []string{types.PrimitiveType}
+				typs = primitiveTypes
 			}
 			param := Parameter{
 				Name: types.EmptyString,
@@ -307,7 +303,7 @@ func parseCppParameters(node *sitter.Node, content []byte) []Parameter {
 			// 可能为nil，即无名参数，只有类型
 			declaratorNode := child.ChildByFieldName("declarator")
 			// 理论上delcs第一个应该是参数名(这里应该只有一层)
-			decls := findAllIdentifiers(declaratorNode, content)
+			decls := findAllIdentifiers(declaratorNode, rc.SourceFile.Content)
 			if len(decls) > 0 {
 				param.Name = decls[0]
 			}
@@ -318,7 +314,7 @@ func parseCppParameters(node *sitter.Node, content []byte) []Parameter {
 			param := Parameter{
 				Name: "...",
 				// 参数类型未知，也不重要，暂时用primitiveType
-				Type: []string{types.PrimitiveType},
+				Type: primitiveTypes,
 			}
 			params = append(params, param)
 		}
@@ -346,14 +342,14 @@ func isLocalVariable(node *sitter.Node) bool {
 }
 
 // 处理cpp语法中的base_class_clause类型，返回类型列表
-func parseBaseClassClause(node *sitter.Node, content []byte) []string {
+func parseBaseClassClause(node *sitter.Node, rc *ResolveContext) []string {
 	if node == nil {
 		return nil
 	}
 
 	// 如果不是base_class_clause节点，直接返回节点内容
 	if types.ToNodeKind(node.Kind()) != types.NodeKindBaseClassClause {
-		return []string{node.Utf8Text(content)}
+		return []string{rc.text(node)}
 	}
 
 	typs := []string{}
@@ -370,10 +366,10 @@ func parseBaseClassClause(node *sitter.Node, content []byte) []string {
 
 		if types.ToNodeKind(child.Kind()) == types.NodeKindTypeIdentifier {
 			// 直接是type_identifier
-			baseClasses = []string{child.Utf8Text(content)}
+			baseClasses = []string{rc.text(child)}
 		} else {
 			// 不是type_identifier，递归查找所有的type_identifier
-			baseClasses = findAllTypeIdentifiers(child, content)
+			baseClasses = rc.typeIdentifiers(child)
 		}
 
 		// 如果找到了类型标识符，添加到结果中
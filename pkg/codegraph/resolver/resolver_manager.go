@@ -3,6 +3,7 @@ package resolver
 import (
 	"codebase-indexer/pkg/codegraph/lang"
 	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/utils"
 	"codebase-indexer/pkg/logger"
 	"context"
 	"fmt"
@@ -16,6 +17,8 @@ type ResolveContext struct {
 	CaptureNames []string // 通过Match.Capture.Index获取captureName
 	SourceFile   *types.SourceFile
 	Logger       logger.Logger
+	Arena        *ElementArena         // 当前文件的元素分配器，可为nil
+	Strings      *utils.StringInterner // 类型名等字符串驻留表，可为nil
 }
 
 // 解析器管理器
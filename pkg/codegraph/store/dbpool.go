@@ -0,0 +1,344 @@
+package store
+
+import (
+	"sort"
+	"sync"
+	"sync/atomic"
+	"time"
+	"unsafe"
+
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/cache"
+)
+
+// 打开的项目数据库池：已打开的实例无锁获取；打开的实例数和 memtable 总量超出预算时关闭最久未访问的实例；
+// 所有实例共享一个块缓存，总内存不随打开的项目数增长，实例关闭时只淘汰自己的块
+
+const (
+	DefaultMaxOpenDBs   = 16                // 同时打开的项目数据库上限
+	DefaultOpenDBMemory = 128 * 1024 * 1024 // 打开的项目数据库 memtable 总量上限
+	// evictMinIdle 超出预算时只关闭空闲超过该时长的实例，刚访问过的实例很可能马上再用，避免反复打开
+	evictMinIdle = time.Minute
+)
+
+// Preopener 支持预先打开项目数据库的存储
+type Preopener interface {
+	// Preopen 在后台打开已有索引的项目数据库，不阻塞调用方
+	Preopen(projectUuids ...string)
+}
+
+// dbAccessRecord 记录数据库实例的访问信息
+type dbAccessRecord struct {
+	lastAccess atomic.Int64 // 最后访问时间（UnixNano），获取实例时无锁更新
+	pins       atomic.Int32 // 使用中的调用和迭代器数，不为0时不关闭
+	db         *leveldb.DB
+	bulkLoad   bool // 是否以批量导入参数打开
+}
+
+func newDBAccessRecord(db *leveldb.DB, bulkLoad bool) *dbAccessRecord {
+	record := &dbAccessRecord{db: db, bulkLoad: bulkLoad}
+	record.touch()
+	return record
+}
+
+func (r *dbAccessRecord) touch() {
+	r.lastAccess.Store(time.Now().UnixNano())
+}
+
+func (r *dbAccessRecord) lastAccessTime() time.Time {
+	return time.Unix(0, r.lastAccess.Load())
+}
+
+func (r *dbAccessRecord) unpin() {
+	r.pins.Add(-1)
+}
+
+// pinDB 无锁占用池中的实例。先占用再确认实例仍在池中，closeIdleDB 先移除再确认没有占用，
+// 两边至少有一方能看到对方，不会关闭已占用的实例
+func (s *LevelDBStorage) pinDB(projectUuid string) (*dbAccessRecord, bool) {
+	value, ok := s.clients.Load(projectUuid)
+	if !ok {
+		return nil, false
+	}
+	record := value.(*dbAccessRecord)
+	record.pins.Add(1)
+	if current, ok := s.clients.Load(projectUuid); !ok || current != value {
+		// 正在关闭或已重新打开，加锁后重新获取
+		record.unpin()
+		return nil, false
+	}
+	record.touch()
+	return record, true
+}
+
+// sharedBlockCacher 所有数据库共享的块缓存 LRU，每个数据库拿到自己的视图。
+// 块按表文件号区分，不同数据库的文件号可能相同，所以每个节点记录所属视图，按文件号淘汰和关闭时只处理本数据库的块
+type sharedBlockCacher struct {
+	mu       sync.Mutex
+	capacity int
+	used     int
+	recent   sharedLRUNode // 哨兵，next 为最近使用
+}
+
+type sharedLRUNode struct {
+	n          *cache.Node
+	h          *cache.Handle
+	owner      *sharedCacher
+	ban        bool
+	next, prev *sharedLRUNode
+}
+
+func (n *sharedLRUNode) insert(at *sharedLRUNode) {
+	x := at.next
+	at.next = n
+	n.prev = at
+	n.next = x
+	x.prev = n
+}
+
+func (n *sharedLRUNode) remove() {
+	n.prev.next = n.next
+	n.next.prev = n.prev
+	n.prev, n.next = nil, nil
+}
+
+func newSharedBlockCacher(capacity int) *sharedBlockCacher {
+	c := &sharedBlockCacher{capacity: capacity}
+	c.recent.next = &c.recent
+	c.recent.prev = &c.recent
+	return c
+}
+
+func (c *sharedBlockCacher) New(int) cache.Cacher {
+	return &sharedCacher{shared: c}
+}
+
+// evictOverflowLocked 超出容量时从最久未使用的一端淘汰，返回需要在锁外释放的节点
+func (c *sharedBlockCacher) evictOverflowLocked(evicted []*sharedLRUNode) []*sharedLRUNode {
+	for c.used > c.capacity && c.recent.prev != &c.recent {
+		rn := c.recent.prev
+		rn.remove()
+		rn.n.CacheData = nil
+		c.used -= rn.n.Size()
+		evicted = append(evicted, rn)
+	}
+	return evicted
+}
+
+// evictWhere 淘汰满足条件的节点
+func (c *sharedBlockCacher) evictWhere(match func(rn *sharedLRUNode) bool) {
+	var evicted []*sharedLRUNode
+	c.mu.Lock()
+	for e := c.recent.prev; e != &c.recent; {
+		rn := e
+		e = e.prev
+		if match(rn) {
+			rn.remove()
+			rn.n.CacheData = nil
+			c.used -= rn.n.Size()
+			evicted = append(evicted, rn)
+		}
+	}
+	c.mu.Unlock()
+	releaseSharedLRUNodes(evicted)
+}
+
+// releaseSharedLRUNodes 释放句柄会回调所属数据库的缓存，必须在锁外调用
+func releaseSharedLRUNodes(nodes []*sharedLRUNode) {
+	for _, rn := range nodes {
+		rn.h.Release()
+	}
+}
+
+// sharedCacher 单个数据库的视图。调整容量不影响共享的 LRU，关闭时淘汰本数据库的所有块
+type sharedCacher struct {
+	shared *sharedBlockCacher
+}
+
+func (v *sharedCacher) Capacity() int {
+	v.shared.mu.Lock()
+	defer v.shared.mu.Unlock()
+	return v.shared.capacity
+}
+
+func (v *sharedCacher) SetCapacity(int) {}
+
+func (v *sharedCacher) Promote(n *cache.Node) {
+	c := v.shared
+	var evicted []*sharedLRUNode
+	c.mu.Lock()
+	if n.CacheData == nil {
+		if n.Size() <= c.capacity {
+			rn := &sharedLRUNode{n: n, h: n.GetHandle(), owner: v}
+			rn.insert(&c.recent)
+			n.CacheData = unsafe.Pointer(rn)
+			c.used += n.Size()
+			evicted = c.evictOverflowLocked(evicted)
+		}
+	} else if rn := (*sharedLRUNode)(n.CacheData); !rn.ban {
+		rn.remove()
+		rn.insert(&c.recent)
+	}
+	c.mu.Unlock()
+	releaseSharedLRUNodes(evicted)
+}
+
+func (v *sharedCacher) Ban(n *cache.Node) {
+	c := v.shared
+	c.mu.Lock()
+	if n.CacheData == nil {
+		n.CacheData = unsafe.Pointer(&sharedLRUNode{n: n, owner: v, ban: true})
+		c.mu.Unlock()
+		return
+	}
+	rn := (*sharedLRUNode)(n.CacheData)
+	if rn.ban {
+		c.mu.Unlock()
+		return
+	}
+	rn.remove()
+	rn.ban = true
+	c.used -= n.Size()
+	c.mu.Unlock()
+	rn.h.Release()
+	rn.h = nil
+}
+
+func (v *sharedCacher) Evict(n *cache.Node) {
+	c := v.shared
+	c.mu.Lock()
+	rn := (*sharedLRUNode)(n.CacheData)
+	if rn == nil || rn.ban {
+		c.mu.Unlock()
+		return
+	}
+	rn.remove()
+	n.CacheData = nil
+	c.used -= n.Size()
+	c.mu.Unlock()
+	rn.h.Release()
+}
+
+func (v *sharedCacher) EvictNS(ns uint64) {
+	v.shared.evictWhere(func(rn *sharedLRUNode) bool { return rn.owner == v && rn.n.NS() == ns })
+}
+
+func (v *sharedCacher) EvictAll() {
+	v.shared.evictWhere(func(rn *sharedLRUNode) bool { return rn.owner == v })
+}
+
+// Close 数据库关闭块缓存时先调用 EvictAll，这里再淘汰一次，避免已关闭数据库的块继续占用共享容量
+func (v *sharedCacher) Close() error {
+	v.EvictAll()
+	return nil
+}
+
+// projectMutex 获取项目级别的互斥锁，打开、关闭项目数据库都在锁内完成
+func (s *LevelDBStorage) projectMutex(projectUuid string) *sync.Mutex {
+	mutexInterface, _ := s.dbMutex.LoadOrStore(projectUuid, &sync.Mutex{})
+	return mutexInterface.(*sync.Mutex)
+}
+
+// openDBMemory 实例计入预算的内存，按打开参数的 memtable 大小估算
+func (s *LevelDBStorage) openDBMemory(record *dbAccessRecord) int {
+	if record.bulkLoad {
+		return s.config.BulkWriteBuffer
+	}
+	return s.config.WriteBuffer
+}
+
+// Preopen 在后台打开已有索引的项目数据库，工作区激活后的首次查询不必等待打开和回放日志
+func (s *LevelDBStorage) Preopen(projectUuids ...string) {
+	for _, projectUuid := range projectUuids {
+		if s.closed {
+			return
+		}
+		if _, ok := s.clients.Load(projectUuid); ok {
+			continue
+		}
+		// 没有索引的项目不创建空数据库
+		if exists, _ := s.ProjectIndexExists(projectUuid); !exists {
+			continue
+		}
+		go func(projectUuid string) {
+			_, release, err := s.getDB(projectUuid)
+			if err != nil {
+				s.logger.Debug("leveldb: preopen project %s err: %v", projectUuid, err)
+				return
+			}
+			release()
+		}(projectUuid)
+	}
+}
+
+// enforceOpenBudget 打开的实例超出数量或内存预算时，按最后访问时间关闭空闲的实例，keep 是刚打开的实例。
+// 批量导入中、使用中的实例和刚访问过的实例不关闭，都不可关闭时暂时超出预算
+func (s *LevelDBStorage) enforceOpenBudget(keep string) {
+	s.evictMu.Lock()
+	defer s.evictMu.Unlock()
+
+	type candidate struct {
+		projectUuid string
+		lastAccess  int64
+	}
+	var count, memory int
+	var candidates []candidate
+	idleBefore := time.Now().Add(-evictMinIdle).UnixNano()
+	s.clients.Range(func(key, value any) bool {
+		record := value.(*dbAccessRecord)
+		count++
+		memory += s.openDBMemory(record)
+		if lastAccess := record.lastAccess.Load(); key != keep && !record.bulkLoad && record.pins.Load() == 0 &&
+			lastAccess < idleBefore {
+			candidates = append(candidates, candidate{projectUuid: key.(string), lastAccess: lastAccess})
+		}
+		return true
+	})
+	if count <= s.config.MaxOpenDBs && memory <= s.config.OpenDBMemory {
+		return
+	}
+	sort.Slice(candidates, func(i, j int) bool { return candidates[i].lastAccess < candidates[j].lastAccess })
+	for _, c := range candidates {
+		if count <= s.config.MaxOpenDBs && memory <= s.config.OpenDBMemory {
+			return
+		}
+		if freed, ok := s.closeIdleDB(c.projectUuid, evictMinIdle); ok {
+			count--
+			memory -= freed
+			s.logger.Info("leveldb: closed project %s to stay within open budget, %d open", c.projectUuid, count)
+		}
+	}
+	if count > s.config.MaxOpenDBs || memory > s.config.OpenDBMemory {
+		s.logger.Debug("leveldb: %d open databases (%d bytes memtable) exceed budget, no idle database to close",
+			count, memory)
+	}
+}
+
+// closeIdleDB 关闭空闲超过 idle 且没有被占用的实例，返回释放的预算内存。实例先从池中移除再确认没有占用，
+// 移除期间被占用时放回池中
+func (s *LevelDBStorage) closeIdleDB(projectUuid string, idle time.Duration) (int, bool) {
+	mutex := s.projectMutex(projectUuid)
+	mutex.Lock()
+	defer mutex.Unlock()
+
+	value, ok := s.clients.Load(projectUuid)
+	if !ok {
+		return 0, false
+	}
+	record := value.(*dbAccessRecord)
+	if record.bulkLoad || record.pins.Load() > 0 || time.Since(record.lastAccessTime()) < idle {
+		return 0, false
+	}
+	s.clients.Delete(projectUuid)
+	if record.pins.Load() > 0 {
+		// 移除期间被占用
+		s.clients.Store(projectUuid, record)
+		return 0, false
+	}
+	if err := record.db.Close(); err != nil {
+		s.logger.Error("leveldb: failed to close database. project %s, err: %v", projectUuid, err)
+	}
+	s.dropSymbolIndex(projectUuid)
+	s.unmountSnapshot(projectUuid)
+	return s.openDBMemory(record), true
+}
@@ -0,0 +1,271 @@
+package store
+
+import (
+	"bytes"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"sync"
+
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/util"
+)
+
+// keyCountKey 各类型键的数量，每个类型8字节大端，按类型标签顺序排列
+const keyCountKey = internalKeyPrefix + "c"
+
+// countedKeyPrefixes 维护计数的键类型，下标对应 keyType 的返回值
+var countedKeyPrefixes = []string{
+	PathKeySystemPrefix,
+	SymKeySystemPrefix,
+	CalleeMapKeySystemPrefix,
+	MetaKeySystemPrefix,
+}
+
+// keyType 返回键类型在 countedKeyPrefixes 中的下标，不计数的键返回 -1
+func keyType(key []byte) int {
+	if len(key) == 0 {
+		return -1
+	}
+	for i, prefix := range countedKeyPrefixes {
+		if key[0] == prefix[0] {
+			return i
+		}
+	}
+	return -1
+}
+
+// keyCounter 项目内各类型键的数量。计数与数据在同一个 batch 中写入，Size 按类型查询时无需遍历；
+// 写入时对计数的键做一次存在性检查，检查和写入在锁内完成，保证计数准确。
+// 批量导入期间不维护计数，写入不做存在性检查，结束后重新打开数据库时遍历统计一次。
+// 所有写入都经过该锁，也用于串行化符号增量压缩的读-改-写。
+// 挂载了快照时，删除快照中的键会在同一个 batch 中写入墓碑
+type keyCounter struct {
+	mu     sync.Mutex
+	loaded bool
+	counts []int64
+	base   *snapshotFile
+}
+
+func newKeyCounter() *keyCounter {
+	return &keyCounter{counts: make([]int64, len(countedKeyPrefixes))}
+}
+
+// reset 丢弃内存中的计数，下次打开数据库时重新加载
+func (c *keyCounter) reset() {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.loaded = false
+	clear(c.counts)
+}
+
+// setBase 设置挂载的快照，nil 表示卸载
+func (c *keyCounter) setBase(base *snapshotFile) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.base = base
+}
+
+func (c *keyCounter) encodeLocked() []byte {
+	buf := make([]byte, 8*len(c.counts))
+	for i, n := range c.counts {
+		binary.BigEndian.PutUint64(buf[i*8:], uint64(n))
+	}
+	return buf
+}
+
+// load 读取持久化的计数，不存在时（新建或迁移后的数据库）通过 reader 按前缀遍历统计一次并写入
+func (c *keyCounter) load(db *leveldb.DB, reader leveldbReader) error {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	value, err := db.Get([]byte(keyCountKey), nil)
+	if err == nil && len(value) == 8*len(c.counts) {
+		for i := range c.counts {
+			c.counts[i] = int64(binary.BigEndian.Uint64(value[i*8:]))
+		}
+		c.loaded = true
+		return nil
+	}
+	if err != nil && !errors.Is(err, leveldb.ErrNotFound) {
+		return fmt.Errorf("failed to read key counts: %w", err)
+	}
+	for i, prefix := range countedKeyPrefixes {
+		var n int64
+		iter := reader.NewIterator(util.BytesPrefix([]byte(prefix)), nil)
+		for iter.Next() {
+			n++
+		}
+		iter.Release()
+		if err = iter.Error(); err != nil {
+			return fmt.Errorf("failed to count keys: %w", err)
+		}
+		c.counts[i] = n
+	}
+	if err = db.Put([]byte(keyCountKey), c.encodeLocked(), nil); err != nil {
+		return fmt.Errorf("failed to write key counts: %w", err)
+	}
+	c.loaded = true
+	return nil
+}
+
+// suspend 批量导入时调用：删除持久化的计数，之后的写入不再检查和更新计数，Size 退化为遍历。
+// 导入中途退出时，下次打开数据库因为没有计数会重新统计
+func (c *keyCounter) suspend(db *leveldb.DB) error {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.loaded = false
+	clear(c.counts)
+	if err := db.Delete([]byte(keyCountKey), nil); err != nil {
+		return fmt.Errorf("failed to delete key counts: %w", err)
+	}
+	return nil
+}
+
+// count 返回某类型键的数量，计数未加载时返回 false
+func (c *keyCounter) count(prefix string) (int, bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if !c.loaded {
+		return 0, false
+	}
+	for i, p := range countedKeyPrefixes {
+		if p == prefix {
+			return int(c.counts[i]), true
+		}
+	}
+	return 0, false
+}
+
+// write 写入 batch 并更新计数
+func (c *keyCounter) write(db *leveldb.DB, batch *leveldb.Batch) error {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return c.writeLocked(db, batch)
+}
+
+// update 在写锁内读取数据并构造 batch 后写入，构造期间不会有其他写入，用于读-改-写
+func (c *keyCounter) update(db *leveldb.DB, build func(batch *leveldb.Batch) error) error {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	batch := new(leveldb.Batch)
+	if err := build(batch); err != nil {
+		return err
+	}
+	if batch.Len() == 0 {
+		return nil
+	}
+	return c.writeLocked(db, batch)
+}
+
+// writeLocked batch 内同一个键可能出现多次，按顺序回放计算增减，调用方持有锁
+func (c *keyCounter) writeLocked(db *leveldb.DB, batch *leveldb.Batch) error {
+	var base *snapshotFile
+	if c.base != nil && c.base.acquire() {
+		base = c.base
+		defer base.release()
+		addTombstones(base, batch)
+	}
+	if !c.loaded {
+		return db.Write(batch, nil)
+	}
+	replay := &countReplay{db: db, base: base, exists: make(map[string]bool), delta: make([]int64, len(c.counts))}
+	if err := batch.Replay(replay); err != nil {
+		return err
+	}
+	if replay.err != nil {
+		return fmt.Errorf("failed to check key existence: %w", replay.err)
+	}
+	changed := false
+	for i, d := range replay.delta {
+		if d != 0 {
+			changed = true
+			c.counts[i] += d
+		}
+	}
+	if changed {
+		batch.Put([]byte(keyCountKey), c.encodeLocked())
+	}
+	if err := db.Write(batch, nil); err != nil {
+		if changed {
+			for i, d := range replay.delta {
+				c.counts[i] -= d
+			}
+		}
+		return err
+	}
+	return nil
+}
+
+// addTombstones 为 batch 中删除的快照键追加墓碑
+func addTombstones(base *snapshotFile, batch *leveldb.Batch) {
+	replay := &tombstoneReplay{base: base}
+	_ = batch.Replay(replay)
+	for _, key := range replay.keys {
+		batch.Put(tombstoneKey(key), nil)
+	}
+}
+
+type tombstoneReplay struct {
+	base *snapshotFile
+	keys [][]byte
+}
+
+func (r *tombstoneReplay) Put(_, _ []byte) {}
+
+func (r *tombstoneReplay) Delete(key []byte) {
+	if !isDataKey(key) {
+		return
+	}
+	if _, ok := r.base.get(key); ok {
+		r.keys = append(r.keys, bytes.Clone(key))
+	}
+}
+
+// countReplay 回放 batch，统计每类键的增减
+type countReplay struct {
+	db     *leveldb.DB
+	base   *snapshotFile
+	exists map[string]bool // batch 内已处理过的键在当前记录之后是否存在
+	delta  []int64
+	err    error
+}
+
+func (r *countReplay) existed(key []byte) bool {
+	if exists, ok := r.exists[string(key)]; ok {
+		return exists
+	}
+	exists, err := r.db.Has(key, nil)
+	if err == nil && !exists && r.base != nil {
+		// 覆盖层没有时看快照，有墓碑表示已删除
+		var deleted bool
+		if deleted, err = r.db.Has(tombstoneKey(key), nil); err == nil && !deleted {
+			_, exists = r.base.get(key)
+		}
+	}
+	if err != nil && r.err == nil {
+		r.err = err
+	}
+	return exists
+}
+
+func (r *countReplay) Put(key, _ []byte) {
+	t := keyType(key)
+	if t < 0 {
+		return
+	}
+	if !r.existed(key) {
+		r.delta[t]++
+	}
+	r.exists[string(key)] = true
+}
+
+func (r *countReplay) Delete(key []byte) {
+	t := keyType(key)
+	if t < 0 {
+		return
+	}
+	if r.existed(key) {
+		r.delta[t]--
+	}
+	r.exists[string(key)] = false
+}
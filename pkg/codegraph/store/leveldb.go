@@ -1,6 +1,7 @@
 package store
 
 import (
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
 	"codebase-indexer/pkg/codegraph/types"
 	"codebase-indexer/pkg/codegraph/utils"
 	"context"
@@ -9,7 +10,9 @@ import (
 	"github.com/syndtr/goleveldb/leveldb/util"
 	"os"
 	"path/filepath"
-	"strings"
+	"runtime"
+	"sort"
+	"strconv"
 	"sync"
 	"time"
 
@@ -29,20 +32,135 @@ const (
 	CleanupInterval = time.Hour
 )
 
-// dbAccessRecord 记录数据库实例的访问信息
-type dbAccessRecord struct {
-	lastAccessTime time.Time
-	db             *leveldb.DB
+const (
+	DefaultWriteBuffer             = 4 * 1024 * 1024  // 4MB write buffer
+	DefaultBlockCacheCapacity      = 64 * 1024 * 1024 // 64MB block cache，所有项目共享
+	DefaultBulkWriteBuffer         = 64 * 1024 * 1024 // 64MB write buffer
+	DefaultBulkCompactionL0Trigger = 32               // 批量导入时L0文件数到达该值才触发压缩
+	DefaultBulkWriteL0PauseTrigger = 128              // 批量导入时L0文件数到达该值才暂停写入
+	DefaultBatchSaveMarshalBufSize = 4 * 1024         // BatchSave序列化复用缓冲的初始大小
+	DefaultMultiGetParallelMinKeys = 64               // MultiGet键数达到该值才并行读取
+	deleteBatchSize                = 1000             // 批量删除时每个batch的键数
+)
+
+// LevelDBConfig LevelDB调优参数，零值字段使用默认值
+type LevelDBConfig struct {
+	WriteBuffer        int // 常规模式memtable大小
+	BlockCacheCapacity int // 所有项目数据库共享的块缓存大小
+	// 同时打开的项目数据库数量及 memtable 总量上限，超出时关闭最久未访问的数据库
+	MaxOpenDBs   int
+	OpenDBMemory int
+	// 批量导入模式（首次全量索引），写入量大且基本没有读，使用更大的memtable并推迟压缩，结束时统一压缩一次
+	BulkWriteBuffer         int
+	BulkCompactionL0Trigger int
+	BulkWriteL0PauseTrigger int
+	// MultiGet 并行读取的协程数及触发并行的最小键数，协程数为1时始终串行
+	MultiGetConcurrency     int
+	MultiGetParallelMinKeys int
+	// 累计写入的符号增量达到该值后在后台合并进符号表
+	PostingCompactThreshold int
+}
+
+// initLevelDBConfig 初始化配置，支持环境变量覆盖（单位MB）
+func initLevelDBConfig(config *LevelDBConfig) {
+	// 从环境变量获取WriteBuffer（环境变量名：LEVELDB_WRITE_BUFFER_MB）
+	if val := envMegabytes("LEVELDB_WRITE_BUFFER_MB"); val > 0 {
+		config.WriteBuffer = val
+	}
+	if config.WriteBuffer <= 0 {
+		config.WriteBuffer = DefaultWriteBuffer
+	}
+
+	// 从环境变量获取BlockCacheCapacity（环境变量名：LEVELDB_BLOCK_CACHE_MB）
+	if val := envMegabytes("LEVELDB_BLOCK_CACHE_MB"); val > 0 {
+		config.BlockCacheCapacity = val
+	}
+	if config.BlockCacheCapacity <= 0 {
+		config.BlockCacheCapacity = DefaultBlockCacheCapacity
+	}
+
+	// 从环境变量获取MaxOpenDBs（环境变量名：LEVELDB_MAX_OPEN_DBS）
+	if envVal, ok := os.LookupEnv("LEVELDB_MAX_OPEN_DBS"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			config.MaxOpenDBs = val
+		}
+	}
+	if config.MaxOpenDBs <= 0 {
+		config.MaxOpenDBs = DefaultMaxOpenDBs
+	}
+
+	// 从环境变量获取OpenDBMemory（环境变量名：LEVELDB_OPEN_DB_MEMORY_MB）
+	if val := envMegabytes("LEVELDB_OPEN_DB_MEMORY_MB"); val > 0 {
+		config.OpenDBMemory = val
+	}
+	if config.OpenDBMemory <= 0 {
+		config.OpenDBMemory = DefaultOpenDBMemory
+	}
+
+	// 从环境变量获取BulkWriteBuffer（环境变量名：LEVELDB_BULK_WRITE_BUFFER_MB）
+	if val := envMegabytes("LEVELDB_BULK_WRITE_BUFFER_MB"); val > 0 {
+		config.BulkWriteBuffer = val
+	}
+	if config.BulkWriteBuffer <= 0 {
+		config.BulkWriteBuffer = DefaultBulkWriteBuffer
+	}
+
+	if config.BulkCompactionL0Trigger <= 0 {
+		config.BulkCompactionL0Trigger = DefaultBulkCompactionL0Trigger
+	}
+	if config.BulkWriteL0PauseTrigger <= 0 {
+		config.BulkWriteL0PauseTrigger = DefaultBulkWriteL0PauseTrigger
+	}
+
+	// 从环境变量获取MultiGetConcurrency（环境变量名：LEVELDB_MULTI_GET_CONCURRENCY）
+	if envVal, ok := os.LookupEnv("LEVELDB_MULTI_GET_CONCURRENCY"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			config.MultiGetConcurrency = val
+		}
+	}
+	if config.MultiGetConcurrency <= 0 {
+		config.MultiGetConcurrency = runtime.GOMAXPROCS(0)
+	}
+	if config.MultiGetParallelMinKeys <= 0 {
+		config.MultiGetParallelMinKeys = DefaultMultiGetParallelMinKeys
+	}
+
+	// 从环境变量获取PostingCompactThreshold（环境变量名：LEVELDB_POSTING_COMPACT_THRESHOLD）
+	if envVal, ok := os.LookupEnv("LEVELDB_POSTING_COMPACT_THRESHOLD"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			config.PostingCompactThreshold = val
+		}
+	}
+	if config.PostingCompactThreshold <= 0 {
+		config.PostingCompactThreshold = DefaultPostingCompactThreshold
+	}
+}
+
+func envMegabytes(name string) int {
+	if envVal, ok := os.LookupEnv(name); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			return val * 1024 * 1024
+		}
+	}
+	return 0
 }
 
 // LevelDBStorage implements GraphStorage interface using LevelDB
 type LevelDBStorage struct {
 	baseDir       string
 	logger        logger.Logger
+	config        LevelDBConfig
 	clients       sync.Map // projectUuid -> *dbAccessRecord
 	closeOnce     sync.Once
 	closed        bool
-	dbMutex       sync.Map // projectUuid -> *sync.Mutex
+	dbMutex       sync.Map   // projectUuid -> *sync.Mutex
+	evictMu       sync.Mutex // 串行化超出预算时的淘汰
+	blockCacher   *sharedBlockCacher
+	pathDicts     sync.Map // projectUuid -> *pathDict
+	keyCounters   sync.Map // projectUuid -> *keyCounter
+	postingStates sync.Map // projectUuid -> *postingState
+	symbolIndexes sync.Map // projectUuid -> *symbolNameIndex
+	snapshots     sync.Map // projectUuid -> *snapshotFile
 	cleanupCtx    context.Context
 	cleanupCancel context.CancelFunc
 	cleanupWG     sync.WaitGroup
@@ -50,6 +168,12 @@ type LevelDBStorage struct {
 
 // NewLevelDBStorage creates new LevelDB storage instance
 func NewLevelDBStorage(baseDir string, logger logger.Logger) (*LevelDBStorage, error) {
+	return NewLevelDBStorageWithConfig(baseDir, logger, LevelDBConfig{})
+}
+
+// NewLevelDBStorageWithConfig creates new LevelDB storage instance with tuning config
+func NewLevelDBStorageWithConfig(baseDir string, logger logger.Logger, config LevelDBConfig) (*LevelDBStorage, error) {
+	initLevelDBConfig(&config)
 	logger.Info("leveldb: checking base directory baseDir %s", baseDir)
 	if err := os.MkdirAll(baseDir, 0755); err != nil {
 		return nil, fmt.Errorf("failed to create base directory: %w", err)
@@ -61,8 +185,10 @@ func NewLevelDBStorage(baseDir string, logger logger.Logger) (*LevelDBStorage, e
 	}
 
 	storage := &LevelDBStorage{
-		baseDir: baseDir,
-		logger:  logger,
+		baseDir:     baseDir,
+		logger:      logger,
+		config:      config,
+		blockCacher: newSharedBlockCacher(config.BlockCacheCapacity),
 	}
 
 	// 启动后台清理任务
@@ -72,46 +198,37 @@ func NewLevelDBStorage(baseDir string, logger logger.Logger) (*LevelDBStorage, e
 	return storage, nil
 }
 
-// getDB gets or creates LevelDB instance for specified project
-func (s *LevelDBStorage) getDB(projectUuid string) (*leveldb.DB, error) {
+// getDB gets or creates LevelDB instance for specified project.
+// 返回的实例在调用 release 之前被占用，不会因超出打开预算或不活跃被关闭
+func (s *LevelDBStorage) getDB(projectUuid string) (*leveldb.DB, func(), error) {
 	if s.closed {
-		return nil, fmt.Errorf("storage is closed")
+		return nil, nil, fmt.Errorf("storage is closed")
 	}
 
-	// 获取或创建项目级别的互斥锁
-	mutexInterface, _ := s.dbMutex.LoadOrStore(projectUuid, &sync.Mutex{})
-	mutex := mutexInterface.(*sync.Mutex)
+	// 已打开的实例无锁获取
+	if record, ok := s.pinDB(projectUuid); ok {
+		return record.db, record.unpin, nil
+	}
 
 	// 加锁防止并发创建数据库
+	mutex := s.projectMutex(projectUuid)
 	mutex.Lock()
-	defer mutex.Unlock()
-
-	now := time.Now()
-
-	if record, exists := s.clients.Load(projectUuid); exists {
-		accessRecord := record.(*dbAccessRecord)
-		// 更新最后访问时间
-		accessRecord.lastAccessTime = now
-		return accessRecord.db, nil
+	if record, ok := s.pinDB(projectUuid); ok {
+		mutex.Unlock()
+		return record.db, record.unpin, nil
 	}
-
-	db, err := s.createDB(projectUuid)
+	db, err := s.createDB(projectUuid, false)
 	if err != nil {
-		return nil, err
-	}
-
-	accessRecord := &dbAccessRecord{
-		lastAccessTime: now,
-		db:             db,
+		mutex.Unlock()
+		return nil, nil, err
 	}
+	record := newDBAccessRecord(db, false)
+	record.pins.Add(1)
+	s.clients.Store(projectUuid, record)
+	mutex.Unlock()
 
-	actual, loaded := s.clients.LoadOrStore(projectUuid, accessRecord)
-	if loaded {
-		db.Close()
-		return actual.(*dbAccessRecord).db, nil
-	}
-
-	return db, nil
+	s.enforceOpenBudget(projectUuid)
+	return db, record.unpin, nil
 }
 
 func (s *LevelDBStorage) generateDbPath(projectUuid string) string {
@@ -119,7 +236,7 @@ func (s *LevelDBStorage) generateDbPath(projectUuid string) string {
 }
 
 // createDB creates new LevelDB instance
-func (s *LevelDBStorage) createDB(projectUuid string) (*leveldb.DB, error) {
+func (s *LevelDBStorage) createDB(projectUuid string, bulkLoad bool) (*leveldb.DB, error) {
 	s.logger.Info("creating project directory project %s", projectUuid)
 	projectDir := filepath.Join(s.baseDir, projectUuid)
 	if err := os.MkdirAll(projectDir, 0755); err != nil {
@@ -129,7 +246,8 @@ func (s *LevelDBStorage) createDB(projectUuid string) (*leveldb.DB, error) {
 	dbPath := s.generateDbPath(projectUuid)
 	s.logger.Info("opening database project %s path %s", projectUuid, dbPath)
 
-	db, err := openLevelDB(dbPath)
+	dbOptions := s.dbOptions(bulkLoad)
+	db, err := openLevelDB(dbPath, dbOptions)
 	if err != nil {
 		s.logger.Warn("database open failed, attempting to recreate. project %s err:%v", projectUuid, err)
 
@@ -140,23 +258,103 @@ func (s *LevelDBStorage) createDB(projectUuid string) (*leveldb.DB, error) {
 		}
 
 		// 重新尝试创建数据库
-		db, err = openLevelDB(dbPath)
+		db, err = openLevelDB(dbPath, dbOptions)
 		if err != nil {
 			return nil, fmt.Errorf("failed to recreate project database %s: %w", dbPath, err)
 		}
 	}
 
+	// 重新打开的可能是重建或迁移后的数据库，内存中的路径字典和符号名索引在下次使用时重新加载
+	s.pathDict(projectUuid).reset()
+	s.dropSymbolIndex(projectUuid)
+	if err = s.mountSnapshot(projectUuid, db); err != nil {
+		// 覆盖层不属于当前快照（如导入中断）或快照损坏：清空覆盖层后重新挂载，快照仍不可用时删除快照
+		s.logger.Warn("snapshot mount failed, recreating overlay. project %s err:%v", projectUuid, err)
+		db.Close()
+		if err = os.RemoveAll(dbPath); err != nil {
+			return nil, fmt.Errorf("failed to remove project database %s: %w", dbPath, err)
+		}
+		if db, err = openLevelDB(dbPath, dbOptions); err != nil {
+			return nil, fmt.Errorf("failed to recreate project database %s: %w", dbPath, err)
+		}
+		if err = s.mountSnapshot(projectUuid, db); err != nil {
+			s.logger.Error("snapshot unusable, removed. project %s err:%v", projectUuid, err)
+			_ = os.Remove(s.snapshotPath(projectUuid))
+		}
+	}
+	if err = s.migrateLayout(projectUuid, db); err != nil {
+		db.Close()
+		return nil, fmt.Errorf("failed to migrate project database %s: %w", dbPath, err)
+	}
+	counter := s.keyCounter(projectUuid)
+	counter.reset()
+	if bulkLoad {
+		// 批量导入的写入不做存在性检查，以常规参数重新打开时重新统计
+		if err = counter.suspend(db); err != nil {
+			s.logger.Warn("failed to suspend key counts. project %s err:%v", projectUuid, err)
+		}
+	} else if err = counter.load(db, s.reader(projectUuid, db)); err != nil {
+		// 计数不可用时 Size 退化为遍历，删除持久化的计数避免之后读到过期值
+		s.logger.Warn("failed to load key counts, fallback to scan. project %s err:%v", projectUuid, err)
+		_ = db.Delete([]byte(keyCountKey), nil)
+	}
+
 	s.logger.Debug("created new project database. project %s path %s", projectUuid, dbPath)
 	return db, nil
 }
 
-func openLevelDB(dbPath string) (*leveldb.DB, error) {
-	// 配置LevelDB选项
-	dbOptions := &opt.Options{
-		WriteBuffer:        4 * 1024 * 1024, // 5MB write buffer
-		BlockCacheCapacity: 8 * 1024 * 1024, // 8MB block cache
+// pathDict 获取项目的路径字典
+func (s *LevelDBStorage) pathDict(projectUuid string) *pathDict {
+	if d, ok := s.pathDicts.Load(projectUuid); ok {
+		return d.(*pathDict)
 	}
+	d, _ := s.pathDicts.LoadOrStore(projectUuid, newPathDict())
+	return d.(*pathDict)
+}
 
+// keyCounter 获取项目的键计数
+func (s *LevelDBStorage) keyCounter(projectUuid string) *keyCounter {
+	if c, ok := s.keyCounters.Load(projectUuid); ok {
+		return c.(*keyCounter)
+	}
+	c, _ := s.keyCounters.LoadOrStore(projectUuid, newKeyCounter())
+	return c.(*keyCounter)
+}
+
+// ResolveFilePaths 将符号表 Occurrence 中的文件ID还原为路径
+func (s *LevelDBStorage) ResolveFilePaths(ctx context.Context, projectUuid string, occurrences []*codegraphpb.Occurrence) error {
+	if err := utils.CheckContext(ctx); err != nil {
+		return fmt.Errorf("context cancelled: %w", err)
+	}
+	db, release, err := s.getDB(projectUuid)
+	if err != nil {
+		return fmt.Errorf("failed to get database: %w", err)
+	}
+	defer release()
+	return s.pathDict(projectUuid).resolve(db, occurrences)
+}
+
+// dbOptions 配置LevelDB选项
+func (s *LevelDBStorage) dbOptions(bulkLoad bool) *opt.Options {
+	if !bulkLoad {
+		return &opt.Options{
+			WriteBuffer:        s.config.WriteBuffer,
+			BlockCacher:        s.blockCacher,
+			BlockCacheCapacity: s.config.BlockCacheCapacity,
+		}
+	}
+	return &opt.Options{
+		WriteBuffer:            s.config.BulkWriteBuffer,
+		BlockCacher:            s.blockCacher,
+		BlockCacheCapacity:     s.config.BlockCacheCapacity,
+		CompactionL0Trigger:    s.config.BulkCompactionL0Trigger,
+		WriteL0SlowdownTrigger: s.config.BulkWriteL0PauseTrigger,
+		WriteL0PauseTrigger:    s.config.BulkWriteL0PauseTrigger,
+		DisableSeeksCompaction: true,
+	}
+}
+
+func openLevelDB(dbPath string, dbOptions *opt.Options) (*leveldb.DB, error) {
 	db, err := leveldb.OpenFile(dbPath, dbOptions)
 	if err != nil {
 		return nil, fmt.Errorf("failed to open database %s: %w", dbPath, err)
@@ -165,16 +363,25 @@ func openLevelDB(dbPath string) (*leveldb.DB, error) {
 	return db, nil
 }
 
-// BatchSave saves multiple values in batch
+// BatchSave saves multiple values in batch, committed atomically through one leveldb.Batch
 func (s *LevelDBStorage) BatchSave(ctx context.Context, projectUuid string, values Entries) error {
 	if err := utils.CheckContext(ctx); err != nil {
 		return fmt.Errorf("context cancelled: %w", err)
 	}
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		return fmt.Errorf("failed to get database: %w", err)
 	}
-
+	defer release()
+
+	batch := new(leveldb.Batch)
+	// batch.Put 会拷贝数据，序列化缓冲可以复用
+	buf := make([]byte, 0, DefaultBatchSaveMarshalBufSize)
+	marshalOpts := proto.MarshalOptions{}
+	dict := s.pathDict(projectUuid)
+	var pendingIds []uint32
+	var symbolNames []string
+	postings := 0
 	for i := 0; i < values.Len(); i++ {
 		if err := utils.CheckContext(ctx); err != nil {
 			return fmt.Errorf("context cancelled during batch save: %w", err)
@@ -186,6 +393,27 @@ func (s *LevelDBStorage) BatchSave(ctx context.Context, projectUuid string, valu
 			continue
 		}
 		value := values.Value(i)
+		if symbol, ok := value.(*codegraphpb.SymbolOccurrence); ok {
+			// 空增量表示文件删除了该符号，不加入符号名索引
+			if IsSymbolNameKey(key) || IsSymbolPostingKey(key) && len(symbol.Occurrences) > 0 {
+				symbolNames = append(symbolNames, key)
+			}
+			encoded, pending, err := dict.encode(db, batch, symbol)
+			if err != nil {
+				return fmt.Errorf("failed to encode file paths for key %q: %w", key, err)
+			}
+			value = encoded
+			pendingIds = append(pendingIds, pending...)
+		}
+		switch {
+		case IsSymbolNameKey(key):
+			// 整体覆盖符号表，之前的增量已包含在内
+			if err := deleteSymbolPostings(s.reader(projectUuid, db), batch, key); err != nil {
+				return fmt.Errorf("failed to clear symbol postings for key %q: %w", key, err)
+			}
+		case IsSymbolPostingKey(key):
+			postings++
+		}
 
 		var data []byte
 		var marshalErr error
@@ -196,7 +424,8 @@ func (s *LevelDBStorage) BatchSave(ctx context.Context, projectUuid string, valu
 		}); ok {
 			data, marshalErr = customMsg.Marshal()
 		} else {
-			data, marshalErr = proto.Marshal(value)
+			data, marshalErr = marshalOpts.MarshalAppend(buf[:0], value)
+			buf = data
 		}
 
 		if marshalErr != nil {
@@ -204,10 +433,78 @@ func (s *LevelDBStorage) BatchSave(ctx context.Context, projectUuid string, valu
 			continue
 		}
 
-		_ = db.Put([]byte(key), data, &opt.WriteOptions{})
+		batch.Put([]byte(key), data)
 	}
 
-	return err
+	if batch.Len() == 0 {
+		return nil
+	}
+	if err = s.keyCounter(projectUuid).write(db, batch); err != nil {
+		return fmt.Errorf("failed to write batch of %d entries: %w", batch.Len(), err)
+	}
+	dict.markPersisted(pendingIds)
+	s.addSymbolNames(s.loadedSymbolIndex(projectUuid), symbolNames)
+	s.notePostings(projectUuid, postings)
+	return nil
+}
+
+// BeginBulkLoad 以批量导入参数重新打开项目数据库，用于首次全量索引
+func (s *LevelDBStorage) BeginBulkLoad(ctx context.Context, projectUuid string) error {
+	return s.reopenDB(projectUuid, true)
+}
+
+// EndBulkLoad 合并符号增量、全量压缩一次后以常规参数重新打开项目数据库，重新打开时统计一次键数量
+func (s *LevelDBStorage) EndBulkLoad(ctx context.Context, projectUuid string) error {
+	if _, err := s.CompactSymbolPostings(ctx, projectUuid); err != nil {
+		s.logger.Warn("bulk_load: failed to compact symbol postings. project %s, err: %v", projectUuid, err)
+	}
+	return s.reopenDB(projectUuid, false)
+}
+
+// reopenDB 切换项目数据库的打开参数。goleveldb不支持运行时修改参数，只能关闭后重新打开，
+// 已经持有旧实例的调用会得到 leveldb.ErrClosed
+func (s *LevelDBStorage) reopenDB(projectUuid string, bulkLoad bool) error {
+	if s.closed {
+		return fmt.Errorf("storage is closed")
+	}
+
+	mutex := s.projectMutex(projectUuid)
+	mutex.Lock()
+	defer mutex.Unlock()
+
+	if record, exists := s.clients.Load(projectUuid); exists {
+		accessRecord := record.(*dbAccessRecord)
+		if accessRecord.bulkLoad == bulkLoad {
+			return nil
+		}
+		if !bulkLoad {
+			// 批量导入期间推迟的压缩在这里统一完成
+			start := time.Now()
+			if err := accessRecord.db.CompactRange(util.Range{}); err != nil {
+				s.logger.Error("bulk_load: failed to compact database. project %s, err: %v", projectUuid, err)
+			}
+			s.logger.Info("bulk_load: compact database. project %s, cost %d ms", projectUuid,
+				time.Since(start).Milliseconds())
+		}
+		s.clients.Delete(projectUuid)
+		if err := accessRecord.db.Close(); err != nil {
+			return fmt.Errorf("failed to close database for reopen: %w", err)
+		}
+	} else if !bulkLoad {
+		return nil
+	}
+
+	db, err := s.createDB(projectUuid, bulkLoad)
+	if err != nil {
+		return err
+	}
+	s.clients.Store(projectUuid, newDBAccessRecord(db, bulkLoad))
+	s.logger.Info("bulk_load: reopened database. project %s, bulk_load %v", projectUuid, bulkLoad)
+	if bulkLoad {
+		// 批量导入的 memtable 较大，在持有项目锁的调用返回后再检查预算
+		go s.enforceOpenBudget(projectUuid)
+	}
+	return nil
 }
 
 // Put saves single value
@@ -216,25 +513,50 @@ func (s *LevelDBStorage) Put(ctx context.Context, projectUuid string, entry *Ent
 		return fmt.Errorf("context cancelled: %w", err)
 	}
 
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		return fmt.Errorf("failed to get database: %w", err)
 	}
+	defer release()
 
 	keyStr, err := entry.Key.Get()
 	if err != nil {
 		return err
 	}
 
-	var data []byte
-	data, err = proto.Marshal(entry.Value)
+	// 符号表与新增的路径字典项一起写入
+	dict := s.pathDict(projectUuid)
+	batch := new(leveldb.Batch)
+	value := entry.Value
+	var pendingIds []uint32
+	var symbolNames []string
+	if symbol, ok := value.(*codegraphpb.SymbolOccurrence); ok {
+		if IsSymbolNameKey(keyStr) || IsSymbolPostingKey(keyStr) && len(symbol.Occurrences) > 0 {
+			symbolNames = []string{keyStr}
+		}
+		if value, pendingIds, err = dict.encode(db, batch, symbol); err != nil {
+			return fmt.Errorf("failed to encode file paths for key %q: %w", keyStr, err)
+		}
+	}
+	data, err := proto.Marshal(value)
 	if err != nil {
-		return fmt.Errorf("failed to marshal data for type %s: %w", keyStr, err)
+		return fmt.Errorf("failed to marshal data for type %q: %w", keyStr, err)
 	}
-
-	err = db.Put([]byte(keyStr), data, nil)
-
-	return err
+	if IsSymbolNameKey(keyStr) {
+		if err = deleteSymbolPostings(s.reader(projectUuid, db), batch, keyStr); err != nil {
+			return fmt.Errorf("failed to clear symbol postings for key %q: %w", keyStr, err)
+		}
+	}
+	batch.Put([]byte(keyStr), data)
+	if err = s.keyCounter(projectUuid).write(db, batch); err != nil {
+		return err
+	}
+	dict.markPersisted(pendingIds)
+	s.addSymbolNames(s.loadedSymbolIndex(projectUuid), symbolNames)
+	if IsSymbolPostingKey(keyStr) {
+		s.notePostings(projectUuid, 1)
+	}
+	return nil
 }
 
 // Get retrieves data by key
@@ -243,19 +565,28 @@ func (s *LevelDBStorage) Get(ctx context.Context, projectUuid string, key Key) (
 		return nil, fmt.Errorf("context cancelled: %w", err)
 	}
 
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		return nil, fmt.Errorf("failed to get database: %w", err)
 	}
+	defer release()
 	keyStr, err := key.Get()
 	if err != nil {
 		return nil, err
 	}
 
-	if err != nil {
-		return nil, err
+	var data []byte
+	if IsSymbolNameKey(keyStr) {
+		// 符号表与增量在同一快照上读取并合并
+		snapshot, snapshotErr := db.GetSnapshot()
+		if snapshotErr != nil {
+			return nil, fmt.Errorf("failed to get snapshot: %w", snapshotErr)
+		}
+		data, err = s.readSymbol(s.reader(projectUuid, snapshot), db, projectUuid, keyStr)
+		snapshot.Release()
+	} else {
+		data, err = s.reader(projectUuid, db).Get([]byte(keyStr), nil)
 	}
-	data, err := db.Get([]byte(keyStr), nil)
 	if err != nil {
 		if errors.Is(err, leveldb.ErrNotFound) {
 			return nil, ErrKeyNotFound
@@ -265,20 +596,116 @@ func (s *LevelDBStorage) Get(ctx context.Context, projectUuid string, key Key) (
 
 	return data, nil
 }
+
+// MultiGet 批量读取，返回值与 keys 一一对应，不存在或无法编码的键对应 nil。
+// 所有键在同一快照上按键序读取，键数较多时分段并行
+func (s *LevelDBStorage) MultiGet(ctx context.Context, projectUuid string, keys []Key) ([][]byte, error) {
+	if err := utils.CheckContext(ctx); err != nil {
+		return nil, fmt.Errorf("context cancelled: %w", err)
+	}
+	if len(keys) == 0 {
+		return nil, nil
+	}
+
+	db, release, err := s.getDB(projectUuid)
+	if err != nil {
+		return nil, fmt.Errorf("failed to get database: %w", err)
+	}
+	defer release()
+	keyStrs := make([]string, len(keys))
+	order := make([]int, 0, len(keys))
+	for i, key := range keys {
+		if keyStrs[i], err = key.Get(); err != nil {
+			// 单个键无效时只跳过该键，对应位置返回 nil
+			s.logger.Warn("multi get skip invalid key %v, project %s err:%v", key, projectUuid, err)
+			continue
+		}
+		order = append(order, i)
+	}
+	// 按键序读取，相邻的键大概率落在同一个数据块
+	sort.Slice(order, func(a, b int) bool { return keyStrs[order[a]] < keyStrs[order[b]] })
+
+	snapshot, err := db.GetSnapshot()
+	if err != nil {
+		return nil, fmt.Errorf("failed to get snapshot: %w", err)
+	}
+	defer snapshot.Release()
+	reader := s.reader(projectUuid, snapshot)
+
+	values := make([][]byte, len(keys))
+	readRange := func(part []int) error {
+		for n, i := range part {
+			if n%100 == 0 {
+				if err := utils.CheckContext(ctx); err != nil {
+					return fmt.Errorf("context cancelled: %w", err)
+				}
+			}
+			data, err := s.readValue(reader, db, projectUuid, keyStrs[i])
+			if errors.Is(err, leveldb.ErrNotFound) {
+				continue
+			}
+			if err != nil {
+				return fmt.Errorf("failed to get key %s: %w", keyStrs[i], err)
+			}
+			values[i] = data
+		}
+		return nil
+	}
+
+	workers := s.config.MultiGetConcurrency
+	if workers <= 1 || len(order) < s.config.MultiGetParallelMinKeys {
+		if err = readRange(order); err != nil {
+			return nil, err
+		}
+		return values, nil
+	}
+
+	// 按键序切成连续的段，每个协程读一段，各自写入不同下标无需加锁
+	partSize := (len(order) + workers - 1) / workers
+	errs := make([]error, 0, workers)
+	var errMu sync.Mutex
+	var wg sync.WaitGroup
+	for begin := 0; begin < len(order); begin += partSize {
+		end := min(begin+partSize, len(order))
+		wg.Add(1)
+		go func(part []int) {
+			defer wg.Done()
+			if err := readRange(part); err != nil {
+				errMu.Lock()
+				errs = append(errs, err)
+				errMu.Unlock()
+			}
+		}(order[begin:end])
+	}
+	wg.Wait()
+	if err = errors.Join(errs...); err != nil {
+		return nil, err
+	}
+	return values, nil
+}
+
 func (s *LevelDBStorage) Exists(ctx context.Context, projectUuid string, key Key) (bool, error) {
 	if err := utils.CheckContext(ctx); err != nil {
 		return false, fmt.Errorf("context cancelled: %w", err)
 	}
 
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		return false, fmt.Errorf("failed to get database: %w", err)
 	}
+	defer release()
 	keyStr, err := key.Get()
 	if err != nil {
 		return false, err
 	}
-	return db.Has([]byte(keyStr), nil)
+	if s.mountedSnapshot(projectUuid) == nil {
+		return db.Has([]byte(keyStr), nil)
+	}
+	_, err = s.reader(projectUuid, db).Get([]byte(keyStr), nil)
+	if errors.Is(err, leveldb.ErrNotFound) {
+		return false, nil
+	}
+	return err == nil, err
 }
 
 // Delete deletes data by key
@@ -287,16 +714,24 @@ func (s *LevelDBStorage) Delete(ctx context.Context, projectUuid string, key Key
 		return fmt.Errorf("context cancelled: %w", err)
 	}
 
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		return fmt.Errorf("failed to get database: %w", err)
 	}
+	defer release()
 	keyStr, err := key.Get()
 	if err != nil {
 		return err
 	}
 
-	err = db.Delete([]byte(keyStr), nil)
+	batch := new(leveldb.Batch)
+	if IsSymbolNameKey(keyStr) {
+		if err = deleteSymbolPostings(s.reader(projectUuid, db), batch, keyStr); err != nil {
+			return fmt.Errorf("failed to clear symbol postings for key %q: %w", keyStr, err)
+		}
+	}
+	batch.Delete([]byte(keyStr))
+	err = s.keyCounter(projectUuid).write(db, batch)
 	if err != nil && !errors.Is(err, leveldb.ErrNotFound) {
 		return fmt.Errorf("failed to delete key %s: %w", keyStr, err)
 	}
@@ -305,84 +740,157 @@ func (s *LevelDBStorage) Delete(ctx context.Context, projectUuid string, key Key
 }
 
 func (s *LevelDBStorage) DeleteAll(ctx context.Context, projectUuid string) error {
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		s.logger.Debug("failed to get database. project %s, error: %v", projectUuid, err)
 		return nil
 	}
+	defer release()
 	s.logger.Info("start to delete all for project %s", projectUuid)
-	iter := s.Iter(ctx, projectUuid)
-	for iter.Next() {
-		_ = db.Delete([]byte(iter.Key()), nil)
+	if s.mountedSnapshot(projectUuid) != nil {
+		// 挂载了快照时逐个写墓碑没有意义，直接删除快照和覆盖层
+		return s.dropSnapshot(projectUuid)
 	}
-	if err = iter.Close(); err != nil {
-		s.logger.Debug("failed to close iter for project %s, error: %v", projectUuid, err)
+	// 符号增量、解析结果、路径字典随数据一起清空，布局版本和计数保留
+	for _, slice := range []*util.Range{dataRange(types.EmptyString), util.BytesPrefix([]byte(SymbolPostingKeySystemPrefix)),
+		util.BytesPrefix([]byte(ResolvedKeySystemPrefix)), util.BytesPrefix([]byte(filePathIdPrefix)),
+		util.BytesPrefix([]byte(fileIdPathPrefix))} {
+		if err = s.deleteRange(projectUuid, db, slice); err != nil {
+			s.logger.Debug("failed to delete all for project %s, error: %v", projectUuid, err)
+		}
 	}
+	s.pathDict(projectUuid).reset()
+	s.dropSymbolIndex(projectUuid)
 	err = db.CompactRange(util.Range{})
 	s.logger.Info("delete all for project %s end, after size: %d", projectUuid,
 		s.Size(ctx, projectUuid, types.EmptyString))
-	return err	
+	return err
 }
 func (s *LevelDBStorage) DeleteAllWithPrefix(ctx context.Context, projectUuid string, keyPrefix string) error {
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		s.logger.Debug("failed to get database. project %s, error: %v", projectUuid, err)
 		return nil
 	}
+	defer release()
 	s.logger.Info("start to delete all for project %s", projectUuid)
-	iter := s.Iter(ctx, projectUuid)
-	for iter.Next() {
-		if strings.HasPrefix(iter.Key(), keyPrefix) {
-			_ = db.Delete([]byte(iter.Key()), nil)
+	slice := dataRange(keyPrefix)
+	if err = s.deleteRange(projectUuid, db, slice); err != nil {
+		s.logger.Debug("failed to delete prefix %s for project %s, error: %v", keyPrefix, projectUuid, err)
+	}
+	if IsSymbolNameKey(keyPrefix) {
+		// 符号表的增量一起删除
+		postingPrefix := SymbolPostingKeySystemPrefix + keyPrefix[len(SymKeySystemPrefix):]
+		if err = s.deleteRange(projectUuid, db, util.BytesPrefix([]byte(postingPrefix))); err != nil {
+			s.logger.Debug("failed to delete postings %s for project %s, error: %v", keyPrefix, projectUuid, err)
 		}
 	}
-	if err = iter.Close(); err != nil {
-		s.logger.Debug("failed to close iter for project %s, error: %v", projectUuid, err)
+	if keyPrefix == types.EmptyString || IsSymbolNameKey(keyPrefix) {
+		s.dropSymbolIndex(projectUuid)
 	}
-	err = db.CompactRange(util.Range{})
+	err = db.CompactRange(*slice)
 	s.logger.Info("delete all with prefix %s for project %s end, after size: %d", keyPrefix, projectUuid,
 		s.Size(ctx, projectUuid, keyPrefix))
 	return err
 }
 
+// deleteRange 分批删除范围内的所有键
+func (s *LevelDBStorage) deleteRange(projectUuid string, db *leveldb.DB, slice *util.Range) error {
+	iter := s.reader(projectUuid, db).NewIterator(slice, nil)
+	defer iter.Release()
+	counter := s.keyCounter(projectUuid)
+	batch := new(leveldb.Batch)
+	for iter.Next() {
+		batch.Delete(iter.Key())
+		if batch.Len() >= deleteBatchSize {
+			if err := counter.write(db, batch); err != nil {
+				return err
+			}
+			batch.Reset()
+		}
+	}
+	if err := iter.Error(); err != nil {
+		return err
+	}
+	if batch.Len() == 0 {
+		return nil
+	}
+	return counter.write(db, batch)
+}
+
+// dataRange 前缀对应的键范围，前缀为空时为除内部键和符号增量以外的全部数据
+func dataRange(keyPrefix string) *util.Range {
+	if keyPrefix == types.EmptyString {
+		return &util.Range{Start: []byte(dataKeyStart), Limit: []byte(SymbolPostingKeySystemPrefix)}
+	}
+	return util.BytesPrefix([]byte(keyPrefix))
+}
+
 // Iter creates iterator
 func (s *LevelDBStorage) Iter(ctx context.Context, projectUuid string) Iterator {
-	db, err := s.getDB(projectUuid)
+	return s.newIterator(ctx, projectUuid, dataRange(types.EmptyString))
+}
+
+// IterPrefix creates iterator over keys with the given prefix only
+func (s *LevelDBStorage) IterPrefix(ctx context.Context, projectUuid string, keyPrefix string) Iterator {
+	return s.newIterator(ctx, projectUuid, dataRange(keyPrefix))
+}
+
+// IterRange creates iterator over keys in [start, limit), limit 为空时到数据范围末尾
+func (s *LevelDBStorage) IterRange(ctx context.Context, projectUuid string, start string, limit string) Iterator {
+	slice := dataRange(types.EmptyString)
+	if start > dataKeyStart {
+		slice.Start = []byte(start)
+	}
+	if limit != types.EmptyString && limit < SymbolPostingKeySystemPrefix {
+		slice.Limit = []byte(limit)
+	}
+	return s.newIterator(ctx, projectUuid, slice)
+}
+
+func (s *LevelDBStorage) newIterator(ctx context.Context, projectUuid string, slice *util.Range) Iterator {
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		s.logger.Debug("iter: failed to get database. project %s, error: %v", projectUuid, err)
 		return nil
 	}
+	// 迭代器关闭前占用实例
 	return &leveldbIterator{
 		storage:     s,
 		projectUuid: projectUuid,
 		ctx:         ctx,
 		db:          db,
-		iter:        db.NewIterator(nil, nil),
+		release:     release,
+		slice:       slice,
+		iter:        s.reader(projectUuid, db).NewIterator(slice, nil),
 	}
 }
 
-// Size returns project data size
+// Size returns project data size. 按键类型查询时直接返回维护的计数，其他前缀只遍历前缀范围内的键
 func (s *LevelDBStorage) Size(ctx context.Context, projectUuid string, keyPrefix string) int {
 	if err := utils.CheckContext(ctx); err != nil {
 		s.logger.Debug("size: context cancelled. project %s", projectUuid)
 		return 0
 	}
 
-	db, err := s.getDB(projectUuid)
+	db, release, err := s.getDB(projectUuid)
 	if err != nil {
 		s.logger.Debug("size: failed to get database. project %s, error:%v", projectUuid, err)
 		return 0
 	}
+	defer release()
+
+	if count, ok := s.keyCounter(projectUuid).count(keyPrefix); ok {
+		return count
+	}
 
 	count := 0
 
-	iter := db.NewIterator(nil, nil)
+	iter := s.reader(projectUuid, db).NewIterator(dataRange(keyPrefix), nil)
 	defer iter.Release()
 
 	for iter.Next() {
-		if keyPrefix == types.EmptyString || strings.HasPrefix(string(iter.Key()), keyPrefix) {
-			count++
-		}
+		count++
 	}
 
 	if err := iter.Error(); err != nil {
@@ -419,6 +927,10 @@ func (s *LevelDBStorage) Close() error {
 		}
 		return true
 	})
+	s.snapshots.Range(func(key, _ interface{}) bool {
+		s.unmountSnapshot(key.(string))
+		return true
+	})
 
 	s.closeOnce.Do(func() {
 		s.closed = true
@@ -439,55 +951,20 @@ func (s *LevelDBStorage) cleanupInactiveDBs() {
 		return
 	}
 
-	now := time.Now()
 	var cleanedCount int
-
 	s.clients.Range(func(key, value interface{}) bool {
 		projectUuid := key.(string)
 		record := value.(*dbAccessRecord)
 
-		// 检查是否超过不活跃阈值
-		if now.Sub(record.lastAccessTime) > InactiveThreshold {
+		// 检查是否超过不活跃阈值，关闭前在项目锁内再次检查
+		if time.Since(record.lastAccessTime()) > InactiveThreshold {
 			s.logger.Info("cleanup: cleaning up inactive database. project %s, last access: %v",
-				projectUuid, record.lastAccessTime)
-
-			// 获取项目级别的互斥锁
-			mutexInterface, _ := s.dbMutex.LoadOrStore(projectUuid, &sync.Mutex{})
-			mutex := mutexInterface.(*sync.Mutex)
-
-			// 加锁防止并发操作
-			mutex.Lock()
-
-			// 再次检查，防止在等待锁的过程中数据库被重新访问
-			if currentRecord, exists := s.clients.Load(projectUuid); exists {
-				currentAccessRecord := currentRecord.(*dbAccessRecord)
-				if now.Sub(currentAccessRecord.lastAccessTime) > InactiveThreshold {
-					// TODO 清理数据库数据
-					// // 清理数据库数据
-					// if err := s.cleanupDBData(projectUuid, currentAccessRecord.db); err != nil {
-					// 	s.logger.Error("cleanup: failed to cleanup database data. project %s, err: %v",
-					// 		projectUuid, err)
-					// 	mutex.Unlock()
-					// 	return true // 继续处理其他数据库
-					// }
-
-					// 关闭数据库连接
-					if err := currentAccessRecord.db.Close(); err != nil {
-						s.logger.Error("cleanup: failed to close database. project %s, err: %v",
-							projectUuid, err)
-					}
-
-					// 从内存中移除
-					s.clients.Delete(projectUuid)
-					s.dbMutex.Delete(projectUuid)
-					cleanedCount++
-					s.logger.Info("cleanup: successfully cleaned up inactive database. project %s", projectUuid)
-				}
+				projectUuid, record.lastAccessTime())
+			if _, ok := s.closeIdleDB(projectUuid, InactiveThreshold); ok {
+				cleanedCount++
+				s.logger.Info("cleanup: successfully cleaned up inactive database. project %s", projectUuid)
 			}
-
-			mutex.Unlock()
 		}
-
 		return true
 	})
 
@@ -586,6 +1063,8 @@ type leveldbIterator struct {
 	projectUuid string
 	ctx         context.Context
 	db          *leveldb.DB
+	release     func() // 释放对实例的占用
+	slice       *util.Range
 	iter        iterator.Iterator
 	currentK    []byte
 	currentV    []byte
@@ -608,15 +1087,19 @@ func (it *leveldbIterator) Next() bool {
 
 	if it.iter == nil {
 		it.storage.logger.Debug("next: getting database project %s", it.projectUuid)
-		db, err := it.storage.getDB(it.projectUuid)
+		db, release, err := it.storage.getDB(it.projectUuid)
 		if err != nil {
 			it.err = fmt.Errorf("failed to get database: %w", err)
 			return false
 		}
+		if it.release != nil {
+			it.release()
+		}
 		it.db = db
+		it.release = release
 
 		it.storage.logger.Debug("next: creating iterator. project %s", it.projectUuid)
-		it.iter = db.NewIterator(nil, nil)
+		it.iter = it.storage.reader(it.projectUuid, db).NewIterator(it.slice, nil)
 		if it.iter == nil {
 			it.err = fmt.Errorf("failed to create iterator")
 			return false
@@ -671,5 +1154,9 @@ func (it *leveldbIterator) Close() error {
 	it.currentK = nil
 	it.currentV = nil
 	it.db = nil
+	if it.release != nil {
+		it.release()
+		it.release = nil
+	}
 	return err
 }
@@ -0,0 +1,125 @@
+package store
+
+import (
+	"strconv"
+	"strings"
+	"time"
+
+	"github.com/syndtr/goleveldb/leveldb"
+)
+
+// LevelStats 单层的表数量和累计压缩统计，来自 leveldb.stats
+type LevelStats struct {
+	Level          int
+	Tables         int
+	SizeBytes      int64
+	CompactionTime time.Duration
+	ReadBytes      int64
+	WriteBytes     int64
+}
+
+// DBStats 项目数据库的运行统计
+type DBStats struct {
+	ProjectUuid     string
+	Levels          []LevelStats
+	WriteDelayCount int64         // 因 L0 文件过多被延迟的写入次数
+	WriteDelay      time.Duration // 写入被延迟的累计时长
+	WritePaused     bool          // 当前写入是否因压缩跟不上而暂停
+	CachedBlock     int64         // 块缓存占用字节数
+	OpenedTables    int64         // 打开的表文件数
+}
+
+// Stats 获取当前已打开的项目数据库的统计信息，不会打开未使用的数据库
+func (s *LevelDBStorage) Stats() []DBStats {
+	var result []DBStats
+	s.clients.Range(func(key, value any) bool {
+		stats, err := leveldbStats(value.(*dbAccessRecord).db)
+		if err != nil {
+			s.logger.Debug("leveldb: get stats of project %s err: %v", key, err)
+			return true
+		}
+		stats.ProjectUuid = key.(string)
+		result = append(result, stats)
+		return true
+	})
+	return result
+}
+
+func leveldbStats(db *leveldb.DB) (DBStats, error) {
+	var stats DBStats
+	value, err := db.GetProperty("leveldb.stats")
+	if err != nil {
+		return stats, err
+	}
+	stats.Levels = parseLevelStats(value)
+	if value, err = db.GetProperty("leveldb.writedelay"); err == nil {
+		stats.WriteDelayCount, stats.WriteDelay, stats.WritePaused = parseWriteDelay(value)
+	}
+	if value, err = db.GetProperty("leveldb.cachedblock"); err == nil {
+		stats.CachedBlock, _ = strconv.ParseInt(strings.TrimSpace(value), 10, 64)
+	}
+	if value, err = db.GetProperty("leveldb.openedtables"); err == nil {
+		stats.OpenedTables, _ = strconv.ParseInt(strings.TrimSpace(value), 10, 64)
+	}
+	return stats, nil
+}
+
+// parseLevelStats 解析 leveldb.stats 的压缩表格：
+//
+//	Level |   Tables   |    Size(MB)   |    Time(sec)  |    Read(MB)   |   Write(MB)
+//	   0  |          1 |       0.00012 |       0.00000 |       0.00000 |       0.00012
+func parseLevelStats(value string) []LevelStats {
+	const mb = 1 << 20
+	var levels []LevelStats
+	for _, line := range strings.Split(value, "\n") {
+		fields := strings.Split(line, "|")
+		if len(fields) != 6 {
+			continue
+		}
+		level, err := strconv.Atoi(strings.TrimSpace(fields[0]))
+		if err != nil {
+			// 表头
+			continue
+		}
+		var nums [5]float64
+		for i := range nums {
+			if nums[i], err = strconv.ParseFloat(strings.TrimSpace(fields[i+1]), 64); err != nil {
+				break
+			}
+		}
+		if err != nil {
+			continue
+		}
+		levels = append(levels, LevelStats{
+			Level:          level,
+			Tables:         int(nums[0]),
+			SizeBytes:      int64(nums[1] * mb),
+			CompactionTime: time.Duration(nums[2] * float64(time.Second)),
+			ReadBytes:      int64(nums[3] * mb),
+			WriteBytes:     int64(nums[4] * mb),
+		})
+	}
+	return levels
+}
+
+// parseWriteDelay 解析 leveldb.writedelay，格式为 DelayN:%d Delay:%s Paused:%t
+func parseWriteDelay(value string) (int64, time.Duration, bool) {
+	var count int64
+	var delay time.Duration
+	var paused bool
+	for _, field := range strings.Fields(value) {
+		k, v, ok := strings.Cut(field, ":")
+		if !ok {
+			continue
+		}
+		switch k {
+		case "DelayN":
+			count, _ = strconv.ParseInt(v, 10, 64)
+		case "Delay":
+			delay, _ = time.ParseDuration(v)
+		case "Paused":
+			paused, _ = strconv.ParseBool(v)
+		}
+	}
+	return count, delay, paused
+}
@@ -4,17 +4,21 @@ import (
 	"codebase-indexer/pkg/codegraph/lang"
 	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
 	"context"
+	"errors"
 	"fmt"
 	"io/fs"
 	"os"
 	"path/filepath"
 	"runtime"
+	"sort"
 	"sync"
 	"testing"
 	"time"
 
 	"github.com/stretchr/testify/assert"
 	"github.com/stretchr/testify/require"
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/cache"
 	"google.golang.org/protobuf/proto"
 )
 
@@ -752,6 +756,464 @@ func TestLevelDBStorage_CorruptedFileHandling(t *testing.T) {
 	assert.ErrorIs(t, err, ErrKeyNotFound)
 }
 
+func TestLevelDBStorage_BatchSaveBulkLoad(t *testing.T) {
+	storage, cleanup := setupLeveldbTestStorage(t)
+	defer cleanup()
+
+	ctx := context.Background()
+	projectID := "test-project"
+
+	require.NoError(t, storage.BeginBulkLoad(ctx, projectID))
+	// 重复进入不会重新打开
+	require.NoError(t, storage.BeginBulkLoad(ctx, projectID))
+
+	n := 100
+	values := make([]proto.Message, 0, n)
+	keys := make([]Key, 0, n)
+	for i := 0; i < n; i++ {
+		values = append(values, &codegraphpb.TestMessage{Value: fmt.Sprintf("value-%d", i)})
+		keys = append(keys, ElementPathKey{Language: lang.Go, Path: fmt.Sprintf("/path/%d.go", i)})
+	}
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues(values, keys)))
+	// 批量导入期间不维护计数，按遍历统计
+	_, ok := storage.keyCounter(projectID).count(PathKeySystemPrefix)
+	assert.False(t, ok)
+	assert.Equal(t, n, storage.Size(ctx, projectID, PathKeySystemPrefix))
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues(values[:10], keys[:10])))
+
+	require.NoError(t, storage.EndBulkLoad(ctx, projectID))
+	_, ok = storage.keyCounter(projectID).count(PathKeySystemPrefix)
+	assert.True(t, ok)
+	assert.Equal(t, n, storage.Size(ctx, projectID, PathKeySystemPrefix))
+
+	// 复用序列化缓冲不能串值
+	for i := 0; i < n; i++ {
+		data, err := storage.Get(ctx, projectID, keys[i])
+		require.NoError(t, err)
+		var msg codegraphpb.TestMessage
+		require.NoError(t, proto.Unmarshal(data, &msg))
+		assert.Equal(t, fmt.Sprintf("value-%d", i), msg.Value)
+	}
+}
+
+func TestLevelDBStorage_IterPrefix(t *testing.T) {
+	storage, cleanup := setupLeveldbTestStorage(t)
+	defer cleanup()
+
+	ctx := context.Background()
+	projectID := "test-project"
+
+	keys := []Key{
+		CalleeMapKey{SymbolName: "Foo", FilePath: "/a.go"},
+		CalleeMapKey{SymbolName: "Foo", FilePath: "/b.go"},
+		CalleeMapKey{SymbolName: "FooBar", FilePath: "/c.go"},
+		ElementPathKey{Language: lang.Go, Path: "/a.go"},
+	}
+	for _, k := range keys {
+		require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: k, Value: &codegraphpb.TestMessage{Value: "v"}}))
+	}
+
+	iter := storage.IterPrefix(ctx, projectID, CalleeMapKeyPrefix("Foo"))
+	defer iter.Close()
+	var got []string
+	for iter.Next() {
+		got = append(got, iter.Key())
+	}
+	require.NoError(t, iter.Error())
+	// 前缀带分隔符，不会匹配到 FooBar
+	keyA, _ := CalleeMapKey{SymbolName: "Foo", FilePath: "/a.go"}.Get()
+	keyB, _ := CalleeMapKey{SymbolName: "Foo", FilePath: "/b.go"}.Get()
+	assert.Equal(t, []string{keyA, keyB}, got)
+
+	_, err := CalleeMapKey{SymbolName: "Foo"}.Get()
+	assert.Error(t, err)
+}
+
+func TestLevelDBStorage_MultiGet(t *testing.T) {
+	tempDir := t.TempDir()
+	// 并行阈值调低，覆盖串行和分段并行两种读取
+	storage, err := NewLevelDBStorageWithConfig(tempDir, &MockLogger{},
+		LevelDBConfig{MultiGetConcurrency: 4, MultiGetParallelMinKeys: 8})
+	require.NoError(t, err)
+	defer storage.Close()
+
+	ctx := context.Background()
+	projectID := "test-project"
+	for i := 0; i < 20; i++ {
+		require.NoError(t, storage.Put(ctx, projectID, &Entry{
+			Key:   SymbolNameKey{Language: lang.Go, Name: fmt.Sprintf("sym%02d", i)},
+			Value: &codegraphpb.TestMessage{Value: fmt.Sprintf("v%02d", i)},
+		}))
+	}
+
+	for _, n := range []int{3, 30} {
+		keys := make([]Key, 0, n)
+		// 倒序并夹杂不存在的键，结果仍按输入顺序对应
+		for i := n - 1; i >= 0; i-- {
+			keys = append(keys, SymbolNameKey{Language: lang.Go, Name: fmt.Sprintf("sym%02d", i)})
+		}
+		values, err := storage.MultiGet(ctx, projectID, keys)
+		require.NoError(t, err)
+		require.Len(t, values, n)
+		for k, i := 0, n-1; i >= 0; k, i = k+1, i-1 {
+			if i >= 20 {
+				assert.Nil(t, values[k])
+				continue
+			}
+			var msg codegraphpb.TestMessage
+			require.NoError(t, UnmarshalValue(values[k], &msg))
+			assert.Equal(t, fmt.Sprintf("v%02d", i), msg.Value)
+		}
+	}
+
+	// 无法编码的键对应 nil，不影响其他键
+	values, err := storage.MultiGet(ctx, projectID, []Key{SymbolNameKey{Language: lang.Go},
+		SymbolNameKey{Language: lang.Go, Name: "sym01"}})
+	require.NoError(t, err)
+	require.Len(t, values, 2)
+	assert.Nil(t, values[0])
+	assert.NotNil(t, values[1])
+}
+
+func TestKeyEncoding(t *testing.T) {
+	pathKey, err := ElementPathKey{Language: lang.Python, Path: "/a/b:c.py"}.Get()
+	require.NoError(t, err)
+	assert.True(t, IsElementPathKey(pathKey))
+	assert.False(t, IsSymbolNameKey(pathKey))
+	decodedPath, err := ToElementPathKey(pathKey)
+	require.NoError(t, err)
+	assert.Equal(t, ElementPathKey{Language: lang.Python, Path: "/a/b:c.py"}, decodedPath)
+
+	symKey, err := SymbolNameKey{Language: lang.Scala, Name: "pkg.Foo"}.Get()
+	require.NoError(t, err)
+	assert.Len(t, symKey, len("pkg.Foo")+2)
+	decodedSym, err := ToSymbolNameKey(symKey)
+	require.NoError(t, err)
+	assert.Equal(t, SymbolNameKey{Language: lang.Scala, Name: "pkg.Foo"}, decodedSym)
+
+	_, err = ElementPathKey{Language: "cobol", Path: "/a.cbl"}.Get()
+	assert.Error(t, err)
+	_, err = ToSymbolNameKey(pathKey)
+	assert.Error(t, err)
+	_, err = ToElementPathKey(string([]byte{PathKeySystemPrefix[0], 0xff, 'a'}))
+	assert.Error(t, err)
+}
+
+func TestLevelDBStorage_SymbolFileIds(t *testing.T) {
+	storage, cleanup := setupLeveldbTestStorage(t)
+	defer cleanup()
+
+	ctx := context.Background()
+	projectID := "test-project"
+	symbol := &codegraphpb.SymbolOccurrence{
+		Name:     "Foo",
+		Language: string(lang.Go),
+		Occurrences: []*codegraphpb.Occurrence{
+			{Path: "/src/a.go", Range: []int32{1, 2, 1, 5}, ElementType: codegraphpb.ElementType_FUNCTION},
+			{Path: "/src/b.go", Range: []int32{3, 0, 3, 4}},
+			{Path: "/src/a.go", Range: []int32{7, 0, 7, 4}},
+		},
+	}
+	key := SymbolNameKey{Language: lang.Go, Name: "Foo"}
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: key, Value: symbol}))
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues(
+		[]proto.Message{&codegraphpb.SymbolOccurrence{Name: "Bar", Occurrences: []*codegraphpb.Occurrence{{Path: "/src/c.go"}}}},
+		[]Key{SymbolNameKey{Language: lang.Go, Name: "Bar"}},
+	)))
+	// 写入不修改调用方的对象
+	assert.Equal(t, "/src/a.go", symbol.Occurrences[0].Path)
+	assert.Zero(t, symbol.Occurrences[0].FileId)
+
+	// 存储的值只有文件ID，同一文件共用一个ID
+	raw, err := storage.Get(ctx, projectID, key)
+	require.NoError(t, err)
+	var stored codegraphpb.SymbolOccurrence
+	require.NoError(t, UnmarshalValue(raw, &stored))
+	assert.Empty(t, stored.Occurrences[0].Path)
+	assert.NotZero(t, stored.Occurrences[0].FileId)
+	assert.Equal(t, stored.Occurrences[0].FileId, stored.Occurrences[2].FileId)
+	assert.NotEqual(t, stored.Occurrences[0].FileId, stored.Occurrences[1].FileId)
+
+	var resolved codegraphpb.SymbolOccurrence
+	require.NoError(t, UnmarshalSymbolOccurrence(ctx, storage, projectID, raw, &resolved))
+	assert.True(t, proto.Equal(symbol, &resolved))
+
+	// 字典项是内部键，不计入 Size，重启后从数据库加载
+	assert.Equal(t, 2, storage.Size(ctx, projectID, ""))
+	storage.pathDict(projectID).reset()
+	raw, err = storage.Get(ctx, projectID, SymbolNameKey{Language: lang.Go, Name: "Bar"})
+	require.NoError(t, err)
+	require.NoError(t, UnmarshalSymbolOccurrence(ctx, storage, projectID, raw, &resolved))
+	assert.Equal(t, "/src/c.go", resolved.Occurrences[0].Path)
+
+	// 删除全部数据后字典一起清空
+	require.NoError(t, storage.DeleteAll(ctx, projectID))
+	assert.Equal(t, 0, storage.Size(ctx, projectID, ""))
+	require.NoError(t, storage.ResolveFilePaths(ctx, projectID, nil))
+	err = storage.ResolveFilePaths(ctx, projectID, []*codegraphpb.Occurrence{{FileId: stored.Occurrences[0].FileId}})
+	assert.Error(t, err)
+}
+
+func TestLevelDBStorage_MigrateLegacyLayout(t *testing.T) {
+	tempDir := t.TempDir()
+	projectID := "legacy-project"
+	dbPath := filepath.Join(tempDir, projectID, dataDir)
+
+	// 构造 v1 布局的数据库
+	legacy, err := leveldb.OpenFile(dbPath, nil)
+	require.NoError(t, err)
+	fileTable, err := proto.Marshal(&codegraphpb.FileElementTable{Path: "/src/a.go", Language: "go"})
+	require.NoError(t, err)
+	symbol := &codegraphpb.SymbolOccurrence{Name: "Foo", Language: "go",
+		Occurrences: []*codegraphpb.Occurrence{{Path: "/src/a.go", Range: []int32{1, 0, 1, 3}}}}
+	symbolBytes, err := proto.Marshal(symbol)
+	require.NoError(t, err)
+	meta, err := proto.Marshal(&codegraphpb.TestMessage{Value: "1"})
+	require.NoError(t, err)
+	require.NoError(t, legacy.Put([]byte("@path:go:/src/a.go"), fileTable, nil))
+	require.NoError(t, legacy.Put([]byte("@sym:go:Foo"), symbolBytes, nil))
+	require.NoError(t, legacy.Put([]byte("@callee:Foo:/src/b.go"), meta, nil))
+	require.NoError(t, legacy.Put([]byte("@meta:version"), meta, nil))
+	require.NoError(t, legacy.Put([]byte("@sym:cobol:Bar"), symbolBytes, nil))
+	require.NoError(t, legacy.Close())
+
+	storage, err := NewLevelDBStorage(tempDir, &MockLogger{})
+	require.NoError(t, err)
+	ctx := context.Background()
+
+	// 无法识别语言的旧键被丢弃，其余键转换为新布局
+	assert.Equal(t, 4, storage.Size(ctx, projectID, ""))
+	for _, key := range []Key{
+		ElementPathKey{Language: lang.Go, Path: "/src/a.go"},
+		CalleeMapKey{SymbolName: "Foo", FilePath: "/src/b.go"},
+		MetaKey{Name: "version"},
+	} {
+		exists, err := storage.Exists(ctx, projectID, key)
+		require.NoError(t, err)
+		assert.True(t, exists)
+	}
+	raw, err := storage.Get(ctx, projectID, SymbolNameKey{Language: lang.Go, Name: "Foo"})
+	require.NoError(t, err)
+	var migrated codegraphpb.SymbolOccurrence
+	require.NoError(t, UnmarshalSymbolOccurrence(ctx, storage, projectID, raw, &migrated))
+	assert.True(t, proto.Equal(symbol, &migrated))
+	require.NoError(t, storage.Close())
+
+	// 再次打开不重复迁移
+	storage, err = NewLevelDBStorage(tempDir, &MockLogger{})
+	require.NoError(t, err)
+	defer storage.Close()
+	assert.Equal(t, 4, storage.Size(ctx, projectID, ""))
+	raw, err = storage.Get(ctx, projectID, SymbolNameKey{Language: lang.Go, Name: "Foo"})
+	require.NoError(t, err)
+	require.NoError(t, UnmarshalSymbolOccurrence(ctx, storage, projectID, raw, &migrated))
+	assert.Equal(t, "/src/a.go", migrated.Occurrences[0].Path)
+}
+
+func TestLevelDBStorage_KeyCounts(t *testing.T) {
+	tempDir := t.TempDir()
+	storage, err := NewLevelDBStorage(tempDir, &MockLogger{})
+	require.NoError(t, err)
+
+	ctx := context.Background()
+	projectID := "test-project"
+	value := &codegraphpb.TestMessage{Value: "v"}
+	pathKey := func(i int) Key { return ElementPathKey{Language: lang.Go, Path: fmt.Sprintf("/src/%d.go", i)} }
+
+	// batch 内重复的键和覆盖写入只计一次
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues(
+		[]proto.Message{value, value, value, value},
+		[]Key{pathKey(1), pathKey(2), pathKey(1), SymbolNameKey{Language: lang.Go, Name: "Foo"}},
+	)))
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: pathKey(2), Value: value}))
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: pathKey(3), Value: value}))
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: CalleeMapKey{SymbolName: "Foo", FilePath: "/src/1.go"}, Value: value}))
+	assert.Equal(t, 3, storage.Size(ctx, projectID, PathKeySystemPrefix))
+	assert.Equal(t, 1, storage.Size(ctx, projectID, SymKeySystemPrefix))
+	assert.Equal(t, 5, storage.Size(ctx, projectID, ""))
+
+	// 删除不存在的键不影响计数
+	require.NoError(t, storage.Delete(ctx, projectID, pathKey(3)))
+	require.NoError(t, storage.Delete(ctx, projectID, pathKey(3)))
+	assert.Equal(t, 2, storage.Size(ctx, projectID, PathKeySystemPrefix))
+
+	// 非类型前缀按范围统计
+	prefix, err := ElementPathKeyPrefix(lang.Go, "/src/1")
+	require.NoError(t, err)
+	assert.Equal(t, 1, storage.Size(ctx, projectID, prefix))
+	iter := storage.IterRange(ctx, projectID, PathKeySystemPrefix, SymKeySystemPrefix)
+	var got int
+	for iter.Next() {
+		assert.True(t, IsElementPathKey(iter.Key()))
+		got++
+	}
+	require.NoError(t, iter.Close())
+	assert.Equal(t, 2, got)
+
+	require.NoError(t, storage.DeleteAllWithPrefix(ctx, projectID, CalleeMapKeySystemPrefix))
+	assert.Equal(t, 0, storage.Size(ctx, projectID, CalleeMapKeySystemPrefix))
+	require.NoError(t, storage.Close())
+
+	// 计数持久化，重新打开后直接可用
+	storage, err = NewLevelDBStorage(tempDir, &MockLogger{})
+	require.NoError(t, err)
+	defer storage.Close()
+	assert.Equal(t, 2, storage.Size(ctx, projectID, PathKeySystemPrefix))
+	assert.Equal(t, 1, storage.Size(ctx, projectID, SymKeySystemPrefix))
+	require.NoError(t, storage.DeleteAll(ctx, projectID))
+	assert.Equal(t, 0, storage.Size(ctx, projectID, PathKeySystemPrefix))
+	assert.Equal(t, 0, storage.Size(ctx, projectID, ""))
+}
+
+func TestLevelDBStorage_SymbolPostings(t *testing.T) {
+	storage, cleanup := setupLeveldbTestStorage(t)
+	defer cleanup()
+
+	ctx := context.Background()
+	projectID := "test-project"
+	key := SymbolNameKey{Language: lang.Go, Name: "Foo"}
+	occurrence := func(path string, line int32) *codegraphpb.Occurrence {
+		return &codegraphpb.Occurrence{Path: path, Range: []int32{line, 0, line, 3}}
+	}
+	posting := func(path string, occurrences ...*codegraphpb.Occurrence) (proto.Message, Key) {
+		return &codegraphpb.SymbolOccurrence{Name: "Foo", Language: string(lang.Go), Occurrences: occurrences},
+			SymbolPostingKey{Language: lang.Go, Name: "Foo", FilePath: path}
+	}
+	resolve := func() []string {
+		raw, err := storage.Get(ctx, projectID, key)
+		if errors.Is(err, ErrKeyNotFound) {
+			return nil
+		}
+		require.NoError(t, err)
+		var symbol codegraphpb.SymbolOccurrence
+		require.NoError(t, UnmarshalSymbolOccurrence(ctx, storage, projectID, raw, &symbol))
+		paths := make([]string, 0, len(symbol.Occurrences))
+		for _, o := range symbol.Occurrences {
+			paths = append(paths, fmt.Sprintf("%s:%d", o.Path, o.Range[0]))
+		}
+		sort.Strings(paths)
+		return paths
+	}
+
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: key, Value: &codegraphpb.SymbolOccurrence{
+		Name: "Foo", Language: string(lang.Go),
+		Occurrences: []*codegraphpb.Occurrence{occurrence("/src/a.go", 1), occurrence("/src/b.go", 2)},
+	}}))
+
+	// 增量替换该文件在符号表中的位置，其他文件不变
+	va, ka := posting("/src/a.go", occurrence("/src/a.go", 5))
+	vc, kc := posting("/src/c.go", occurrence("/src/c.go", 3))
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues([]proto.Message{va, vc}, []Key{ka, kc})))
+	assert.Equal(t, []string{"/src/a.go:5", "/src/b.go:2", "/src/c.go:3"}, resolve())
+	values, err := storage.MultiGet(ctx, projectID, []Key{key, SymbolNameKey{Language: lang.Go, Name: "Bar"}})
+	require.NoError(t, err)
+	assert.NotNil(t, values[0])
+	assert.Nil(t, values[1])
+	// 增量不是符号表键，不计入 Size，也不出现在遍历中
+	assert.Equal(t, 1, storage.Size(ctx, projectID, SymKeySystemPrefix))
+	assert.Equal(t, 1, storage.Size(ctx, projectID, ""))
+
+	// 空增量删除该文件的位置
+	vb, kb := posting("/src/b.go")
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: kb, Value: vb}))
+	assert.Equal(t, []string{"/src/a.go:5", "/src/c.go:3"}, resolve())
+
+	// 压缩后结果不变，增量被删除
+	compacted, err := storage.CompactSymbolPostings(ctx, projectID)
+	require.NoError(t, err)
+	assert.Equal(t, 1, compacted)
+	assert.Equal(t, []string{"/src/a.go:5", "/src/c.go:3"}, resolve())
+	assert.Equal(t, 0, storage.Size(ctx, projectID, SymbolPostingKeySystemPrefix))
+
+	// 只有增量的符号也能读到，全部文件删除后不存在
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues([]proto.Message{vb}, []Key{kb})))
+	vn, kn := posting("/src/a.go")
+	vm, km := posting("/src/c.go")
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues([]proto.Message{vn, vm}, []Key{kn, km})))
+	assert.Nil(t, resolve())
+	_, err = storage.CompactSymbolPostings(ctx, projectID)
+	require.NoError(t, err)
+	assert.Equal(t, 0, storage.Size(ctx, projectID, SymKeySystemPrefix))
+
+	// 整体写入符号表覆盖之前的增量
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues([]proto.Message{va}, []Key{ka})))
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: key, Value: &codegraphpb.SymbolOccurrence{
+		Name: "Foo", Language: string(lang.Go), Occurrences: []*codegraphpb.Occurrence{occurrence("/src/d.go", 4)},
+	}}))
+	assert.Equal(t, []string{"/src/d.go:4"}, resolve())
+	assert.Equal(t, 0, storage.Size(ctx, projectID, SymbolPostingKeySystemPrefix))
+}
+
+func TestLevelDBStorage_SearchSymbolNames(t *testing.T) {
+	storage, cleanup := setupLeveldbTestStorage(t)
+	defer cleanup()
+
+	ctx := context.Background()
+	projectID := "test-project"
+	symbol := func(language lang.Language, name string, paths ...string) (proto.Message, Key) {
+		occurrences := make([]*codegraphpb.Occurrence, 0, len(paths))
+		for _, path := range paths {
+			occurrences = append(occurrences, &codegraphpb.Occurrence{Path: path, Range: []int32{1, 0, 1, 3}})
+		}
+		return &codegraphpb.SymbolOccurrence{Name: name, Language: string(language), Occurrences: occurrences},
+			SymbolNameKey{Language: language, Name: name}
+	}
+	search := func(query string, language lang.Language) []string {
+		matches, err := storage.SearchSymbolNames(ctx, projectID, SymbolSearchOptions{Query: query, Language: language})
+		require.NoError(t, err)
+		names := make([]string, 0, len(matches))
+		for _, m := range matches {
+			names = append(names, fmt.Sprintf("%s:%s", m.Name, m.Kind))
+		}
+		return names
+	}
+
+	var values []proto.Message
+	var keys []Key
+	for _, name := range []string{"ParseFile", "parseFileHeader", "FileParser", "TryParseFiles", "Close"} {
+		v, k := symbol(lang.Go, name, "/src/a.go")
+		values, keys = append(values, v), append(keys, k)
+	}
+	v, k := symbol(lang.Java, "parseFile", "/src/A.java")
+	values, keys = append(values, v), append(keys, k)
+	require.NoError(t, storage.BatchSave(ctx, projectID, CreateTestValues(values, keys)))
+
+	// 精确 > 前缀 > 单词开头的子串 > 模糊
+	assert.Equal(t, []string{"ParseFile:exact", "parseFile:exact", "parseFileHeader:prefix",
+		"TryParseFiles:substring", "FileParser:fuzzy"}, search("ParseFile", ""))
+	assert.Equal(t, []string{"parseFile:exact"}, search("parseFile", lang.Java))
+	// 短查询只按前缀匹配
+	assert.Equal(t, []string{"Close:prefix"}, search("cl", ""))
+	assert.Empty(t, search("xyz", ""))
+
+	// 加载后的写入进入索引
+	vs, ks := symbol(lang.Go, "ParseSource", "/src/b.go")
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: ks, Value: vs}))
+	vp := &codegraphpb.SymbolOccurrence{Name: "Parse", Language: string(lang.Go),
+		Occurrences: []*codegraphpb.Occurrence{{Path: "/src/c.go", Range: []int32{2, 0, 2, 5}}}}
+	kp := SymbolPostingKey{Language: lang.Go, Name: "Parse", FilePath: "/src/c.go"}
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: kp, Value: vp}))
+	matches, err := storage.SearchSymbolNames(ctx, projectID, SymbolSearchOptions{Query: "Pars", Limit: 2})
+	require.NoError(t, err)
+	require.Len(t, matches, 2)
+	assert.Equal(t, "Parse", matches[0].Name)
+	assert.Equal(t, lang.Go, matches[0].Language)
+	require.Len(t, matches[0].Occurrences, 1)
+	assert.Equal(t, "/src/c.go", matches[0].Occurrences[0].Path)
+
+	// 删除后的符号在搜索时确认并移除
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: kp, Value: &codegraphpb.SymbolOccurrence{
+		Name: "Parse", Language: string(lang.Go)}}))
+	require.NoError(t, storage.Delete(ctx, projectID, ks))
+	assert.Equal(t, []string{"ParseFile:prefix", "parseFile:prefix"}, search("Pars", "")[:2])
+	goId, err := encodeLanguage(lang.Go)
+	require.NoError(t, err)
+	index := storage.loadedSymbolIndex(projectID)
+	require.NotNil(t, index)
+	assert.NotContains(t, index.ids, symbolEntryKey{languageId: goId, name: "Parse"})
+	assert.NotContains(t, index.ids, symbolEntryKey{languageId: goId, name: "ParseSource"})
+}
+
 func TestLevelDBStorage_NonexistentDirectory(t *testing.T) {
 	tempDir := filepath.Join(os.TempDir(), "nonexistent", "deep", "path", fmt.Sprintf("%d", time.Now().UnixNano()))
 	defer os.RemoveAll(filepath.Dir(tempDir))
@@ -910,3 +1372,156 @@ func TestLevelDBStorage_CloseDuringOperations(t *testing.T) {
 
 	wg.Wait()
 }
+
+func TestLevelDBStorage_Stats(t *testing.T) {
+	storage, cleanup := setupLeveldbTestStorage(t)
+	defer cleanup()
+
+	ctx := context.Background()
+	projectID := GenerateTestProjectUUID("stats-project", "/tmp/stats-project")
+	assert.Empty(t, storage.Stats())
+
+	err := storage.Put(ctx, projectID, &Entry{Key: TestKey{"stats"}, Value: &codegraphpb.TestMessage{Value: "v"}})
+	require.NoError(t, err)
+	stats := storage.Stats()
+	require.Len(t, stats, 1)
+	assert.Equal(t, projectID, stats[0].ProjectUuid)
+	assert.False(t, stats[0].WritePaused)
+
+	levels := parseLevelStats("Compactions\n" +
+		" Level |   Tables   |    Size(MB)   |    Time(sec)  |    Read(MB)   |   Write(MB)\n" +
+		"-------+------------+---------------+---------------+---------------+---------------\n" +
+		"   0   |          2 |       1.00000 |       0.50000 |       0.00000 |       2.00000\n")
+	assert.Equal(t, []LevelStats{{Level: 0, Tables: 2, SizeBytes: 1 << 20, CompactionTime: 500 * time.Millisecond,
+		WriteBytes: 2 << 20}}, levels)
+
+	count, delay, paused := parseWriteDelay("DelayN:3 Delay:1.5s Paused:true")
+	assert.Equal(t, int64(3), count)
+	assert.Equal(t, 1500*time.Millisecond, delay)
+	assert.True(t, paused)
+}
+
+func TestLevelDBStorage_OpenBudgetKeepsPinned(t *testing.T) {
+	storage, err := NewLevelDBStorageWithConfig(t.TempDir(), &MockLogger{}, LevelDBConfig{MaxOpenDBs: 1})
+	require.NoError(t, err)
+	defer storage.Close()
+
+	ctx := context.Background()
+	value := &codegraphpb.TestMessage{Value: "v"}
+	idle := func(projectID string) {
+		record, ok := storage.clients.Load(projectID)
+		require.True(t, ok)
+		record.(*dbAccessRecord).lastAccess.Store(time.Now().Add(-2 * evictMinIdle).UnixNano())
+	}
+	require.NoError(t, storage.Put(ctx, "p1", &Entry{Key: TestKey{"k1"}, Value: value}))
+	require.NoError(t, storage.Put(ctx, "p1", &Entry{Key: TestKey{"k2"}, Value: value}))
+	iter := storage.IterPrefix(ctx, "p1", "k")
+	require.NotNil(t, iter)
+	require.True(t, iter.Next())
+	idle("p1")
+
+	// 迭代器未关闭，超出预算也不关闭实例
+	require.NoError(t, storage.Put(ctx, "p2", &Entry{Key: TestKey{"k"}, Value: value}))
+	_, ok := storage.clients.Load("p1")
+	assert.True(t, ok)
+	_, ok = storage.closeIdleDB("p1", evictMinIdle)
+	assert.False(t, ok)
+	assert.True(t, iter.Next())
+	require.NoError(t, iter.Error())
+
+	require.NoError(t, iter.Close())
+	_, ok = storage.closeIdleDB("p1", evictMinIdle)
+	assert.True(t, ok)
+}
+
+func TestLevelDBStorage_OpenBudget(t *testing.T) {
+	storage, err := NewLevelDBStorageWithConfig(t.TempDir(), &MockLogger{}, LevelDBConfig{MaxOpenDBs: 2})
+	require.NoError(t, err)
+	defer func() { storage.Close() }()
+
+	ctx := context.Background()
+	value := &codegraphpb.TestMessage{Value: "v"}
+	idle := func(projectID string) {
+		record, ok := storage.clients.Load(projectID)
+		require.True(t, ok)
+		record.(*dbAccessRecord).lastAccess.Store(time.Now().Add(-2 * evictMinIdle).UnixNano())
+	}
+	require.NoError(t, storage.Put(ctx, "p1", &Entry{Key: TestKey{"k"}, Value: value}))
+	require.NoError(t, storage.Put(ctx, "p2", &Entry{Key: TestKey{"k"}, Value: value}))
+	idle("p1")
+	idle("p2")
+	// 刚访问过的实例不关闭
+	_, err = storage.Get(ctx, "p1", TestKey{"k"})
+	require.NoError(t, err)
+
+	require.NoError(t, storage.Put(ctx, "p3", &Entry{Key: TestKey{"k"}, Value: value}))
+	assert.Len(t, storage.Stats(), 2)
+	_, ok := storage.clients.Load("p2")
+	assert.False(t, ok)
+
+	// 关闭的实例在下次访问时重新打开，数据不丢失
+	exists, err := storage.Exists(ctx, "p2", TestKey{"k"})
+	require.NoError(t, err)
+	assert.True(t, exists)
+
+	// 预先打开只打开已有索引的项目
+	require.NoError(t, storage.Close())
+	storage, err = NewLevelDBStorageWithConfig(storage.baseDir, &MockLogger{}, LevelDBConfig{})
+	require.NoError(t, err)
+	storage.Preopen("p1", "missing")
+	assert.Eventually(t, func() bool {
+		_, ok := storage.clients.Load("p1")
+		return ok
+	}, 5*time.Second, 10*time.Millisecond)
+	_, ok = storage.clients.Load("missing")
+	assert.False(t, ok)
+	exists, err = storage.ProjectIndexExists("missing")
+	require.NoError(t, err)
+	assert.False(t, exists)
+}
+
+func TestSharedBlockCacher(t *testing.T) {
+	shared := newSharedBlockCacher(4)
+	db1 := cache.NewCache(shared.New(0))
+	db2 := cache.NewCache(shared.New(0))
+	put := func(c *cache.Cache, ns, key uint64) {
+		h := c.Get(ns, key, func() (int, cache.Value) { return 1, key })
+		require.NotNil(t, h)
+		h.Release()
+	}
+	cached := func(c *cache.Cache, ns, key uint64) bool {
+		h := c.Get(ns, key, nil)
+		if h == nil {
+			return false
+		}
+		h.Release()
+		return true
+	}
+
+	// 两个数据库使用相同的文件号
+	put(db1, 1, 1)
+	put(db1, 2, 1)
+	put(db2, 1, 1)
+	put(db2, 1, 2)
+	assert.Equal(t, 4, shared.used)
+
+	// 按文件号淘汰只影响本数据库
+	db1.EvictNS(1)
+	assert.False(t, cached(db1, 1, 1))
+	assert.True(t, cached(db2, 1, 1))
+	assert.True(t, cached(db2, 1, 2))
+	assert.Equal(t, 3, shared.used)
+
+	// 关闭数据库后其块不再占用共享容量
+	require.NoError(t, db1.CloseWeak())
+	assert.Equal(t, 2, shared.used)
+	assert.True(t, cached(db2, 1, 1))
+
+	// 容量在所有数据库之间共享，超出时淘汰最久未使用的块
+	db3 := cache.NewCache(shared.New(0))
+	put(db3, 1, 1)
+	put(db3, 1, 2)
+	put(db3, 1, 3)
+	assert.Equal(t, 4, shared.used)
+	assert.False(t, cached(db2, 1, 2))
+}
@@ -0,0 +1,136 @@
+package store
+
+import (
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"errors"
+	"fmt"
+	"strings"
+	"time"
+
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/util"
+	"google.golang.org/protobuf/proto"
+)
+
+// 布局 v1 的键格式：@path:<language>:<path>、@sym:<language>:<name>、@callee:<name>:<path>、@meta:<name>
+const (
+	legacyKeyPrefix       = "@"
+	legacyPathKeyPrefix   = "@path:"
+	legacySymKeyPrefix    = "@sym:"
+	legacyCalleeKeyPrefix = "@callee:"
+	legacyMetaKeyPrefix   = "@meta:"
+	migrateBatchSize      = 1000
+)
+
+// migrateLayout 将 v1 字符串布局的数据库迁移到当前布局。已迁移的数据库只读取一次版本键；
+// 迁移分批提交，中途失败时已迁移的数据可用，下次打开时继续迁移剩余的旧键
+func (s *LevelDBStorage) migrateLayout(projectUuid string, db *leveldb.DB) error {
+	version, err := db.Get([]byte(layoutVersionKey), nil)
+	if err == nil && len(version) == 1 && version[0] >= layoutVersion {
+		return nil
+	}
+	if err != nil && !errors.Is(err, leveldb.ErrNotFound) {
+		return fmt.Errorf("failed to read layout version: %w", err)
+	}
+
+	start := time.Now()
+	dict := s.pathDict(projectUuid)
+	iter := db.NewIterator(util.BytesPrefix([]byte(legacyKeyPrefix)), nil)
+	defer iter.Release()
+
+	batch := new(leveldb.Batch)
+	var pendingIds []uint32
+	migrated, dropped := 0, 0
+	flush := func() error {
+		if batch.Len() == 0 {
+			return nil
+		}
+		if err := db.Write(batch, nil); err != nil {
+			return fmt.Errorf("failed to write migrated batch: %w", err)
+		}
+		dict.markPersisted(pendingIds)
+		batch.Reset()
+		pendingIds = pendingIds[:0]
+		return nil
+	}
+
+	for iter.Next() {
+		oldKey := string(iter.Key())
+		newKey, value, pending, err := s.migrateEntry(db, batch, dict, oldKey, iter.Value())
+		// batch 会拷贝键值，迭代器的数据在 Next 之前写入即可
+		batch.Delete(iter.Key())
+		if err != nil {
+			// 无法识别的旧键没有任何读取方，直接丢弃，重新索引时会重建
+			s.logger.Warn("leveldb_migrate: drop legacy key %s for project %s, err: %v", oldKey, projectUuid, err)
+			dropped++
+		} else {
+			batch.Put([]byte(newKey), value)
+			pendingIds = append(pendingIds, pending...)
+			migrated++
+		}
+		if batch.Len() >= migrateBatchSize {
+			if err := flush(); err != nil {
+				return err
+			}
+		}
+	}
+	if err := iter.Error(); err != nil {
+		return fmt.Errorf("failed to iterate legacy keys: %w", err)
+	}
+	if err := flush(); err != nil {
+		return err
+	}
+	if err := db.Put([]byte(layoutVersionKey), []byte{layoutVersion}, nil); err != nil {
+		return fmt.Errorf("failed to write layout version: %w", err)
+	}
+	if migrated > 0 || dropped > 0 {
+		s.logger.Info("leveldb_migrate: project %s migrated %d keys, dropped %d, cost %d ms",
+			projectUuid, migrated, dropped, time.Since(start).Milliseconds())
+	}
+	return nil
+}
+
+// migrateEntry 转换单个旧键，符号表的值改为引用文件ID
+func (s *LevelDBStorage) migrateEntry(db *leveldb.DB, batch *leveldb.Batch, dict *pathDict,
+	oldKey string, oldValue []byte) (string, []byte, []uint32, error) {
+	switch {
+	case strings.HasPrefix(oldKey, legacyPathKeyPrefix):
+		language, path, ok := strings.Cut(oldKey[len(legacyPathKeyPrefix):], ":")
+		if !ok {
+			return "", nil, nil, fmt.Errorf("invalid legacy element_path key")
+		}
+		newKey, err := ElementPathKey{Language: lang.Language(language), Path: path}.Get()
+		return newKey, oldValue, nil, err
+	case strings.HasPrefix(oldKey, legacySymKeyPrefix):
+		language, name, ok := strings.Cut(oldKey[len(legacySymKeyPrefix):], ":")
+		if !ok {
+			return "", nil, nil, fmt.Errorf("invalid legacy symbol_name key")
+		}
+		newKey, err := SymbolNameKey{Language: lang.Language(language), Name: name}.Get()
+		if err != nil {
+			return "", nil, nil, err
+		}
+		var symbol codegraphpb.SymbolOccurrence
+		if err = proto.Unmarshal(oldValue, &symbol); err != nil {
+			return "", nil, nil, err
+		}
+		encoded, pending, err := dict.encode(db, batch, &symbol)
+		if err != nil {
+			return "", nil, nil, err
+		}
+		value, err := proto.Marshal(encoded)
+		return newKey, value, pending, err
+	case strings.HasPrefix(oldKey, legacyCalleeKeyPrefix):
+		name, path, ok := strings.Cut(oldKey[len(legacyCalleeKeyPrefix):], ":")
+		if !ok {
+			return "", nil, nil, fmt.Errorf("invalid legacy callee_map key")
+		}
+		newKey, err := CalleeMapKey{SymbolName: name, FilePath: path}.Get()
+		return newKey, oldValue, nil, err
+	case strings.HasPrefix(oldKey, legacyMetaKeyPrefix):
+		newKey, err := MetaKey{Name: oldKey[len(legacyMetaKeyPrefix):]}.Get()
+		return newKey, oldValue, nil, err
+	}
+	return "", nil, nil, fmt.Errorf("unknown legacy key type")
+}
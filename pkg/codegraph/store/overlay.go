@@ -0,0 +1,559 @@
+package store
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/utils"
+	"context"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/iterator"
+	"github.com/syndtr/goleveldb/leveldb/opt"
+	"github.com/syndtr/goleveldb/leveldb/util"
+)
+
+// 快照挂载：导入的快照作为项目索引的只读底层直接查询，本地 LevelDB 作为覆盖层保存之后的写入。
+// 读取时覆盖层优先，删除快照中的键时在覆盖层写入墓碑。内部键（布局版本、路径字典、键计数）
+// 挂载时从快照复制到覆盖层，之后只读写覆盖层
+const (
+	snapshotFileName = "snapshot" + SnapshotFileExt
+	// tombstonePrefix 墓碑：覆盖层删除了快照中的键
+	tombstonePrefix = internalKeyPrefix + "d"
+	// snapshotBaseKey 覆盖层所属快照的校验和与提交，与挂载的快照不一致时覆盖层作废
+	snapshotBaseKey = internalKeyPrefix + "s"
+	// adoptedFilePrefix 路径 -> 本地修改时间(8字节大端)，内容与快照一致的本地文件
+	adoptedFilePrefix = internalKeyPrefix + "t"
+)
+
+var errSnapshotOverlayMismatch = errors.New("overlay does not belong to snapshot")
+
+// SnapshotStore 支持导出、导入只读快照的存储
+type SnapshotStore interface {
+	// ExportSnapshot 导出项目索引的快照
+	ExportSnapshot(ctx context.Context, projectUuid string, w io.Writer, meta SnapshotMeta) (*SnapshotMeta, error)
+	// ImportSnapshot 导入快照作为项目索引，原有索引被丢弃
+	ImportSnapshot(ctx context.Context, projectUuid string, path string) (*SnapshotMeta, error)
+	// MountedSnapshot 项目当前挂载的快照，没有时返回 nil
+	MountedSnapshot(projectUuid string) *SnapshotMeta
+	// AdoptSnapshotFiles 记录内容与快照一致的本地文件的修改时间
+	AdoptSnapshotFiles(ctx context.Context, projectUuid string, timestamps map[string]int64) error
+	// AdoptedSnapshotFiles 读取已记录的本地文件修改时间
+	AdoptedSnapshotFiles(ctx context.Context, projectUuid string) (map[string]int64, error)
+}
+
+func tombstoneKey(key []byte) []byte {
+	return append([]byte(tombstonePrefix), key...)
+}
+
+func isDataKey(key []byte) bool {
+	return len(key) > 0 && key[0] >= dataKeyStart[0]
+}
+
+// isSnapshotInternalKey 随快照导出的内部键
+func isSnapshotInternalKey(key []byte) bool {
+	k := string(key)
+	return k == layoutVersionKey || k == keyCountKey ||
+		strings.HasPrefix(k, filePathIdPrefix) || strings.HasPrefix(k, fileIdPathPrefix)
+}
+
+func snapshotId(meta *SnapshotMeta) []byte {
+	id := binary.BigEndian.AppendUint32(nil, meta.Checksum)
+	return append(id, meta.Commit...)
+}
+
+func (s *LevelDBStorage) snapshotPath(projectUuid string) string {
+	return filepath.Join(s.baseDir, projectUuid, snapshotFileName)
+}
+
+// mountedSnapshot 项目挂载的快照，没有时返回 nil
+func (s *LevelDBStorage) mountedSnapshot(projectUuid string) *snapshotFile {
+	if sf, ok := s.snapshots.Load(projectUuid); ok {
+		return sf.(*snapshotFile)
+	}
+	return nil
+}
+
+// reader 挂载了快照时返回叠加快照的读取器
+func (s *LevelDBStorage) reader(projectUuid string, top leveldbReader) leveldbReader {
+	if sf := s.mountedSnapshot(projectUuid); sf != nil {
+		return &layeredReader{top: top, base: sf}
+	}
+	return top
+}
+
+// MountedSnapshot 项目当前挂载的快照
+func (s *LevelDBStorage) MountedSnapshot(projectUuid string) *SnapshotMeta {
+	if sf := s.mountedSnapshot(projectUuid); sf != nil {
+		meta := sf.meta
+		return &meta
+	}
+	return nil
+}
+
+// mountSnapshot 挂载项目目录下的快照。覆盖层为空时从快照复制内部键，覆盖层属于其他快照时返回
+// errSnapshotOverlayMismatch
+func (s *LevelDBStorage) mountSnapshot(projectUuid string, db *leveldb.DB) error {
+	s.unmountSnapshot(projectUuid)
+	path := s.snapshotPath(projectUuid)
+	if _, err := os.Stat(path); errors.Is(err, os.ErrNotExist) {
+		return nil
+	}
+	sf, err := openSnapshot(path)
+	if err != nil {
+		return err
+	}
+	id := snapshotId(&sf.meta)
+	marker, err := db.Get([]byte(snapshotBaseKey), nil)
+	switch {
+	case err == nil && bytes.Equal(marker, id):
+	case errors.Is(err, leveldb.ErrNotFound) && isEmptyDB(db):
+		err = seedOverlay(db, sf, id)
+	case err == nil || errors.Is(err, leveldb.ErrNotFound):
+		err = errSnapshotOverlayMismatch
+	}
+	if err != nil {
+		sf.release()
+		return err
+	}
+	s.snapshots.Store(projectUuid, sf)
+	s.keyCounter(projectUuid).setBase(sf)
+	s.logger.Info("snapshot: mounted project %s commit %s, %d keys", projectUuid, sf.meta.Commit, sf.count)
+	return nil
+}
+
+// unmountSnapshot 卸载快照，正在进行的读取结束后解除映射
+func (s *LevelDBStorage) unmountSnapshot(projectUuid string) {
+	if sf, ok := s.snapshots.LoadAndDelete(projectUuid); ok {
+		s.keyCounter(projectUuid).setBase(nil)
+		sf.(*snapshotFile).release()
+	}
+}
+
+func isEmptyDB(db *leveldb.DB) bool {
+	iter := db.NewIterator(nil, nil)
+	defer iter.Release()
+	return !iter.First()
+}
+
+// seedOverlay 把快照的内部键复制到空的覆盖层，内部键排在所有数据键之前
+func seedOverlay(db *leveldb.DB, sf *snapshotFile, id []byte) error {
+	batch := new(leveldb.Batch)
+	for i := 0; i < sf.count; i++ {
+		key, value := sf.record(i)
+		if isDataKey(key) {
+			break
+		}
+		batch.Put(key, value)
+		if batch.Len() >= deleteBatchSize {
+			if err := db.Write(batch, nil); err != nil {
+				return err
+			}
+			batch.Reset()
+		}
+	}
+	batch.Put([]byte(snapshotBaseKey), id)
+	return db.Write(batch, nil)
+}
+
+// closeProjectLocked 关闭项目数据库并卸载快照，调用方持有项目锁
+func (s *LevelDBStorage) closeProjectLocked(projectUuid string) {
+	if record, ok := s.clients.LoadAndDelete(projectUuid); ok {
+		if err := record.(*dbAccessRecord).db.Close(); err != nil {
+			s.logger.Warn("snapshot: failed to close database. project %s, err: %v", projectUuid, err)
+		}
+	}
+	s.unmountSnapshot(projectUuid)
+	s.dropSymbolIndex(projectUuid)
+}
+
+// ExportSnapshot 在一致的快照上导出项目的全部数据键和随快照导出的内部键，导出前合并符号增量
+func (s *LevelDBStorage) ExportSnapshot(ctx context.Context, projectUuid string, w io.Writer,
+	meta SnapshotMeta) (*SnapshotMeta, error) {
+	if _, err := s.CompactSymbolPostings(ctx, projectUuid); err != nil {
+		s.logger.Warn("snapshot: failed to compact symbol postings. project %s, err: %v", projectUuid, err)
+	}
+	db, release, err := s.getDB(projectUuid)
+	if err != nil {
+		return nil, fmt.Errorf("failed to get database: %w", err)
+	}
+	defer release()
+	snapshot, err := db.GetSnapshot()
+	if err != nil {
+		return nil, fmt.Errorf("failed to get snapshot: %w", err)
+	}
+	defer snapshot.Release()
+
+	start := time.Now()
+	sw, err := newSnapshotWriter(w)
+	if err != nil {
+		return nil, err
+	}
+	iter := s.reader(projectUuid, snapshot).NewIterator(nil, nil)
+	defer iter.Release()
+	for n := 0; iter.Next(); n++ {
+		if n%1000 == 0 {
+			if err = utils.CheckContext(ctx); err != nil {
+				return nil, err
+			}
+		}
+		key := iter.Key()
+		if !isDataKey(key) && !isSnapshotInternalKey(key) {
+			continue
+		}
+		if err = sw.add(key, iter.Value()); err != nil {
+			return nil, fmt.Errorf("failed to write snapshot: %w", err)
+		}
+	}
+	if err = iter.Error(); err != nil {
+		return nil, err
+	}
+	meta.ProjectUuid = projectUuid
+	meta.Layout = layoutVersion
+	if meta.CreatedAt == 0 {
+		meta.CreatedAt = time.Now().Unix()
+	}
+	if meta.Checksum, err = sw.finish(&meta); err != nil {
+		return nil, fmt.Errorf("failed to write snapshot: %w", err)
+	}
+	s.logger.Info("snapshot: exported project %s commit %s, %d keys, cost %d ms", projectUuid, meta.Commit,
+		meta.Keys, time.Since(start).Milliseconds())
+	return &meta, nil
+}
+
+// ImportSnapshot 校验快照后复制到项目目录并挂载，丢弃项目原有的索引
+func (s *LevelDBStorage) ImportSnapshot(ctx context.Context, projectUuid string, path string) (*SnapshotMeta, error) {
+	if s.closed {
+		return nil, fmt.Errorf("storage is closed")
+	}
+	sf, err := openSnapshot(path)
+	if err != nil {
+		return nil, err
+	}
+	meta := sf.meta
+	sf.release()
+	if meta.ProjectUuid != projectUuid {
+		return nil, fmt.Errorf("snapshot %s belongs to project %s (%s), not %s", path, meta.ProjectUuid,
+			meta.ProjectPath, projectUuid)
+	}
+	if err = utils.CheckContext(ctx); err != nil {
+		return nil, err
+	}
+
+	mutexInterface, _ := s.dbMutex.LoadOrStore(projectUuid, &sync.Mutex{})
+	mutex := mutexInterface.(*sync.Mutex)
+	mutex.Lock()
+	defer mutex.Unlock()
+
+	s.closeProjectLocked(projectUuid)
+	dest := s.snapshotPath(projectUuid)
+	if err = os.MkdirAll(filepath.Dir(dest), 0755); err != nil {
+		return nil, fmt.Errorf("failed to create project directory: %w", err)
+	}
+	if filepath.Clean(path) != dest {
+		if err = copyFileAtomic(path, dest); err != nil {
+			return nil, fmt.Errorf("failed to copy snapshot: %w", err)
+		}
+	}
+	if err = os.RemoveAll(s.generateDbPath(projectUuid)); err != nil {
+		return nil, fmt.Errorf("failed to remove project database: %w", err)
+	}
+	db, err := s.createDB(projectUuid, false)
+	if err != nil {
+		return nil, err
+	}
+	if s.mountedSnapshot(projectUuid) == nil {
+		db.Close()
+		return nil, fmt.Errorf("failed to mount snapshot %s", path)
+	}
+	s.clients.Store(projectUuid, newDBAccessRecord(db, false))
+	return &meta, nil
+}
+
+// dropSnapshot 删除项目的快照和覆盖层，项目回到空索引
+func (s *LevelDBStorage) dropSnapshot(projectUuid string) error {
+	mutexInterface, _ := s.dbMutex.LoadOrStore(projectUuid, &sync.Mutex{})
+	mutex := mutexInterface.(*sync.Mutex)
+	mutex.Lock()
+	defer mutex.Unlock()
+
+	s.closeProjectLocked(projectUuid)
+	if err := os.Remove(s.snapshotPath(projectUuid)); err != nil && !errors.Is(err, os.ErrNotExist) {
+		return fmt.Errorf("failed to remove snapshot: %w", err)
+	}
+	if err := os.RemoveAll(s.generateDbPath(projectUuid)); err != nil {
+		return fmt.Errorf("failed to remove project database: %w", err)
+	}
+	s.logger.Info("snapshot: dropped snapshot of project %s", projectUuid)
+	return nil
+}
+
+// copyFileAtomic 复制到临时文件后改名，目标文件要么是旧内容要么是完整的新内容
+func copyFileAtomic(src, dest string) error {
+	in, err := os.Open(src)
+	if err != nil {
+		return err
+	}
+	defer in.Close()
+	tmp, err := os.CreateTemp(filepath.Dir(dest), filepath.Base(dest)+".*.tmp")
+	if err != nil {
+		return err
+	}
+	defer os.Remove(tmp.Name())
+	if _, err = io.Copy(tmp, in); err != nil {
+		tmp.Close()
+		return err
+	}
+	if err = tmp.Sync(); err != nil {
+		tmp.Close()
+		return err
+	}
+	if err = tmp.Close(); err != nil {
+		return err
+	}
+	return os.Rename(tmp.Name(), dest)
+}
+
+// AdoptSnapshotFiles 记录本地文件的修改时间，这些文件的内容已确认与快照一致
+func (s *LevelDBStorage) AdoptSnapshotFiles(ctx context.Context, projectUuid string, timestamps map[string]int64) error {
+	if err := utils.CheckContext(ctx); err != nil {
+		return err
+	}
+	db, release, err := s.getDB(projectUuid)
+	if err != nil {
+		return fmt.Errorf("failed to get database: %w", err)
+	}
+	defer release()
+	batch := new(leveldb.Batch)
+	for path, timestamp := range timestamps {
+		batch.Put([]byte(adoptedFilePrefix+path), binary.BigEndian.AppendUint64(nil, uint64(timestamp)))
+		if batch.Len() >= deleteBatchSize {
+			if err = db.Write(batch, nil); err != nil {
+				return err
+			}
+			batch.Reset()
+		}
+	}
+	return db.Write(batch, nil)
+}
+
+// AdoptedSnapshotFiles 读取 AdoptSnapshotFiles 记录的文件修改时间
+func (s *LevelDBStorage) AdoptedSnapshotFiles(ctx context.Context, projectUuid string) (map[string]int64, error) {
+	db, release, err := s.getDB(projectUuid)
+	if err != nil {
+		return nil, fmt.Errorf("failed to get database: %w", err)
+	}
+	defer release()
+	iter := db.NewIterator(util.BytesPrefix([]byte(adoptedFilePrefix)), nil)
+	defer iter.Release()
+	timestamps := make(map[string]int64)
+	for iter.Next() {
+		if len(iter.Value()) != 8 {
+			continue
+		}
+		timestamps[string(iter.Key()[len(adoptedFilePrefix):])] = int64(binary.BigEndian.Uint64(iter.Value()))
+	}
+	return timestamps, iter.Error()
+}
+
+// layeredReader 覆盖层优先、再读快照的读取器。内部键只在覆盖层
+type layeredReader struct {
+	top  leveldbReader
+	base *snapshotFile
+}
+
+func (r *layeredReader) Get(key []byte, ro *opt.ReadOptions) ([]byte, error) {
+	value, err := r.top.Get(key, ro)
+	if !errors.Is(err, leveldb.ErrNotFound) || !isDataKey(key) {
+		return value, err
+	}
+	if _, err = r.top.Get(tombstoneKey(key), ro); err == nil {
+		return nil, leveldb.ErrNotFound
+	} else if !errors.Is(err, leveldb.ErrNotFound) {
+		return nil, err
+	}
+	if !r.base.acquire() {
+		return nil, leveldb.ErrClosed
+	}
+	defer r.base.release()
+	if value, ok := r.base.get(key); ok {
+		return bytes.Clone(value), nil
+	}
+	return nil, leveldb.ErrNotFound
+}
+
+func (r *layeredReader) NewIterator(slice *util.Range, ro *opt.ReadOptions) iterator.Iterator {
+	top := r.top.NewIterator(slice, ro)
+	if !r.base.acquire() {
+		return top
+	}
+	// 快照只参与数据键范围
+	baseRange := &util.Range{Start: []byte(dataKeyStart)}
+	if slice != nil {
+		if bytes.Compare(slice.Start, baseRange.Start) > 0 {
+			baseRange.Start = slice.Start
+		}
+		baseRange.Limit = slice.Limit
+	}
+	tombRange := &util.Range{Start: tombstoneKey(baseRange.Start), Limit: util.BytesPrefix([]byte(tombstonePrefix)).Limit}
+	if baseRange.Limit != nil {
+		tombRange.Limit = tombstoneKey(baseRange.Limit)
+	}
+	return &layeredIterator{
+		top:  top,
+		base: r.base.newIterator(baseRange),
+		tomb: r.top.NewIterator(tombRange, ro),
+	}
+}
+
+// layeredIterator 按键序合并覆盖层和快照，相同的键取覆盖层，跳过有墓碑的快照键。
+// 只支持正向遍历
+type layeredIterator struct {
+	util.BasicReleaser
+	top, tomb iterator.Iterator
+	base      *snapshotIterator
+	tombKey   []byte
+	tombDone  bool
+	started   bool
+	valid     bool
+	fromTop   bool
+	err       error
+}
+
+var _ iterator.Iterator = (*layeredIterator)(nil)
+
+func (it *layeredIterator) First() bool {
+	it.top.First()
+	it.base.First()
+	it.tombDone = !it.tomb.First()
+	it.settle()
+	return it.valid
+}
+
+func (it *layeredIterator) Seek(key []byte) bool {
+	it.top.Seek(key)
+	it.base.Seek(key)
+	it.tombDone = !it.tomb.Seek(tombstoneKey(key))
+	it.settle()
+	return it.valid
+}
+
+func (it *layeredIterator) Next() bool {
+	if !it.started {
+		return it.First()
+	}
+	if !it.valid {
+		return false
+	}
+	if it.fromTop {
+		if it.base.Valid() && bytes.Equal(it.base.Key(), it.top.Key()) {
+			it.base.Next()
+		}
+		it.top.Next()
+	} else {
+		it.base.Next()
+	}
+	it.settle()
+	return it.valid
+}
+
+func (it *layeredIterator) Last() bool {
+	return it.unsupported()
+}
+
+func (it *layeredIterator) Prev() bool {
+	return it.unsupported()
+}
+
+func (it *layeredIterator) unsupported() bool {
+	it.err = errors.New("layered iterator: reverse iteration is not supported")
+	it.valid = false
+	return false
+}
+
+// settle 定位到两层中较小的键
+func (it *layeredIterator) settle() {
+	it.started = true
+	for {
+		topOk, baseOk := it.top.Valid(), it.base.Valid()
+		if topOk && (!baseOk || bytes.Compare(it.top.Key(), it.base.Key()) <= 0) {
+			it.valid, it.fromTop = true, true
+			return
+		}
+		if !baseOk {
+			it.valid = false
+			return
+		}
+		if it.deleted(it.base.Key()) {
+			it.base.Next()
+			continue
+		}
+		it.valid, it.fromTop = true, false
+		return
+	}
+}
+
+// deleted 快照中的键是否有墓碑。快照键递增，墓碑迭代器只需向前移动
+func (it *layeredIterator) deleted(key []byte) bool {
+	if it.tombDone {
+		return false
+	}
+	it.tombKey = append(append(it.tombKey[:0], tombstonePrefix...), key...)
+	c := bytes.Compare(it.tomb.Key(), it.tombKey)
+	if c < 0 {
+		if !it.tomb.Seek(it.tombKey) {
+			it.tombDone = true
+			return false
+		}
+		c = bytes.Compare(it.tomb.Key(), it.tombKey)
+	}
+	return c == 0
+}
+
+func (it *layeredIterator) Valid() bool {
+	return it.valid
+}
+
+func (it *layeredIterator) Key() []byte {
+	if !it.valid {
+		return nil
+	}
+	if it.fromTop {
+		return it.top.Key()
+	}
+	return it.base.Key()
+}
+
+func (it *layeredIterator) Value() []byte {
+	if !it.valid {
+		return nil
+	}
+	if it.fromTop {
+		return it.top.Value()
+	}
+	return it.base.Value()
+}
+
+func (it *layeredIterator) Error() error {
+	if it.err != nil {
+		return it.err
+	}
+	if err := it.top.Error(); err != nil {
+		return err
+	}
+	return it.tomb.Error()
+}
+
+func (it *layeredIterator) Release() {
+	it.top.Release()
+	it.tomb.Release()
+	it.base.Release()
+	it.BasicReleaser.Release()
+}
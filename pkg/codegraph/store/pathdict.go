@@ -0,0 +1,172 @@
+package store
+
+import (
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"encoding/binary"
+	"fmt"
+	"sync"
+
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/util"
+)
+
+// pathDict 项目的文件路径字典，符号表中的 Occurrence 只保存文件ID，路径统一存一份。
+// 字典项与引用它的数据在同一个 leveldb.Batch 中写入；ID 只增不减，文件删除后不回收
+type pathDict struct {
+	mu        sync.Mutex
+	loaded    bool
+	ids       map[string]uint32
+	paths     map[uint32]string
+	persisted map[uint32]bool
+	next      uint32
+}
+
+func newPathDict() *pathDict {
+	d := &pathDict{}
+	d.resetLocked()
+	return d
+}
+
+func (d *pathDict) resetLocked() {
+	d.loaded = false
+	d.ids = make(map[string]uint32)
+	d.paths = make(map[uint32]string)
+	d.persisted = make(map[uint32]bool)
+	d.next = 1
+}
+
+// reset 丢弃内存中的字典，下次使用时从数据库重新加载
+func (d *pathDict) reset() {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	d.resetLocked()
+}
+
+func encodeFileId(id uint32) []byte {
+	var buf [4]byte
+	binary.BigEndian.PutUint32(buf[:], id)
+	return buf[:]
+}
+
+// loadLocked 从数据库加载全部字典项，调用方持有锁
+func (d *pathDict) loadLocked(db *leveldb.DB) error {
+	if d.loaded {
+		return nil
+	}
+	iter := db.NewIterator(util.BytesPrefix([]byte(fileIdPathPrefix)), nil)
+	defer iter.Release()
+	for iter.Next() {
+		key := iter.Key()
+		if len(key) != len(fileIdPathPrefix)+4 {
+			continue
+		}
+		id := binary.BigEndian.Uint32(key[len(fileIdPathPrefix):])
+		path := string(iter.Value())
+		d.ids[path] = id
+		d.paths[id] = path
+		d.persisted[id] = true
+		if id >= d.next {
+			d.next = id + 1
+		}
+	}
+	if err := iter.Error(); err != nil {
+		return fmt.Errorf("failed to load path dictionary: %w", err)
+	}
+	d.loaded = true
+	return nil
+}
+
+// encode 返回用文件ID代替路径的副本，不修改原对象（原对象可能在缓存中被共享）。
+// 尚未持久化的字典项追加到 batch，写入成功后需调用 markPersisted
+func (d *pathDict) encode(db *leveldb.DB, batch *leveldb.Batch,
+	symbol *codegraphpb.SymbolOccurrence) (*codegraphpb.SymbolOccurrence, []uint32, error) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	if err := d.loadLocked(db); err != nil {
+		return nil, nil, err
+	}
+
+	var pending []uint32
+	occurrences := make([]codegraphpb.Occurrence, len(symbol.Occurrences))
+	encoded := &codegraphpb.SymbolOccurrence{
+		Name:        symbol.Name,
+		Language:    symbol.Language,
+		Occurrences: make([]*codegraphpb.Occurrence, len(symbol.Occurrences)),
+	}
+	for i, o := range symbol.Occurrences {
+		e := &occurrences[i]
+		e.Range = o.Range
+		e.ElementType = o.ElementType
+		e.RelationType = o.RelationType
+		e.FileId = o.FileId
+		if o.Path != "" {
+			id, ok := d.ids[o.Path]
+			if !ok {
+				id = d.next
+				d.next++
+				d.ids[o.Path] = id
+				d.paths[id] = o.Path
+			}
+			if !d.persisted[id] {
+				idBytes := encodeFileId(id)
+				batch.Put(append([]byte(filePathIdPrefix), o.Path...), idBytes)
+				batch.Put(append([]byte(fileIdPathPrefix), idBytes...), []byte(o.Path))
+				pending = append(pending, id)
+			}
+			e.FileId = id
+		}
+		encoded.Occurrences[i] = e
+	}
+	return encoded, pending, nil
+}
+
+// markPersisted 标记字典项已写入数据库，之后的写入不再重复携带
+func (d *pathDict) markPersisted(ids []uint32) {
+	if len(ids) == 0 {
+		return
+	}
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	for _, id := range ids {
+		if _, ok := d.paths[id]; ok {
+			d.persisted[id] = true
+		}
+	}
+}
+
+// lookupIds 查询路径对应的文件ID，字典中没有的路径不在结果中
+func (d *pathDict) lookupIds(db *leveldb.DB, paths map[string]struct{}) (map[uint32]struct{}, error) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	if err := d.loadLocked(db); err != nil {
+		return nil, err
+	}
+	ids := make(map[uint32]struct{}, len(paths))
+	for path := range paths {
+		if id, ok := d.ids[path]; ok {
+			ids[id] = struct{}{}
+		}
+	}
+	return ids, nil
+}
+
+// resolve 将文件ID还原为路径
+func (d *pathDict) resolve(db *leveldb.DB, occurrences []*codegraphpb.Occurrence) error {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	if err := d.loadLocked(db); err != nil {
+		return err
+	}
+	for _, o := range occurrences {
+		if o.FileId == 0 || o.Path != "" {
+			continue
+		}
+		path, ok := d.paths[o.FileId]
+		if !ok {
+			return fmt.Errorf("file id %d not found in path dictionary", o.FileId)
+		}
+		o.Path = path
+		o.FileId = 0
+	}
+	return nil
+}
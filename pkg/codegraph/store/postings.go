@@ -0,0 +1,243 @@
+package store
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/utils"
+	"context"
+	"errors"
+	"fmt"
+	"sync/atomic"
+	"time"
+
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/iterator"
+	"github.com/syndtr/goleveldb/leveldb/opt"
+	"github.com/syndtr/goleveldb/leveldb/util"
+	"google.golang.org/protobuf/proto"
+)
+
+const DefaultPostingCompactThreshold = 50000 // 累计写入的符号增量达到该值后触发后台压缩
+
+// leveldbReader leveldb.DB 和 leveldb.Snapshot 共有的读取方法
+type leveldbReader interface {
+	Get(key []byte, ro *opt.ReadOptions) ([]byte, error)
+	NewIterator(slice *util.Range, ro *opt.ReadOptions) iterator.Iterator
+}
+
+// postingState 项目的符号增量压缩状态
+type postingState struct {
+	pending atomic.Int64 // 上次压缩后写入的增量数，只用于触发压缩
+	running atomic.Bool
+}
+
+// symbolPostingPrefix 符号表key对应的增量key前缀：标签 + 语言编码 + 符号名 + 分隔符
+func symbolPostingPrefix(symbolKey string) []byte {
+	prefix := make([]byte, 0, len(symbolKey)+len(keySeparator))
+	prefix = append(prefix, SymbolPostingKeySystemPrefix...)
+	prefix = append(prefix, symbolKey[len(SymKeySystemPrefix):]...)
+	return append(prefix, keySeparator...)
+}
+
+// postingSymbolKey 增量key所属的符号表key
+func postingSymbolKey(postingKey []byte) (string, bool) {
+	if len(postingKey) < 3 {
+		return "", false
+	}
+	end := bytes.Index(postingKey[2:], []byte(keySeparator))
+	if end < 0 {
+		return "", false
+	}
+	return SymKeySystemPrefix + string(postingKey[1:2+end]), true
+}
+
+// mergeSymbolPostings 将符号的增量合并到符号表的值（均为文件ID形式）。没有增量时返回 nil；
+// 同时返回读到的增量key，供压缩时删除
+func (s *LevelDBStorage) mergeSymbolPostings(reader leveldbReader, db *leveldb.DB, dict *pathDict,
+	symbolKey string, base []byte) (*codegraphpb.SymbolOccurrence, [][]byte, error) {
+	prefix := symbolPostingPrefix(symbolKey)
+	iter := reader.NewIterator(util.BytesPrefix(prefix), nil)
+	defer iter.Release()
+
+	var postingKeys [][]byte
+	var postings []*codegraphpb.SymbolOccurrence
+	replacedPaths := make(map[string]struct{})
+	for iter.Next() {
+		var posting codegraphpb.SymbolOccurrence
+		if err := proto.Unmarshal(iter.Value(), &posting); err != nil {
+			return nil, nil, fmt.Errorf("failed to unmarshal symbol posting %q: %w", iter.Key(), err)
+		}
+		postingKeys = append(postingKeys, bytes.Clone(iter.Key()))
+		postings = append(postings, &posting)
+		replacedPaths[string(iter.Key()[len(prefix):])] = struct{}{}
+	}
+	if err := iter.Error(); err != nil {
+		return nil, nil, err
+	}
+	if len(postings) == 0 {
+		return nil, nil, nil
+	}
+
+	symbol := new(codegraphpb.SymbolOccurrence)
+	if base != nil {
+		if err := proto.Unmarshal(base, symbol); err != nil {
+			return nil, nil, fmt.Errorf("failed to unmarshal symbol %q: %w", symbolKey, err)
+		}
+	}
+	replacedIds, err := dict.lookupIds(db, replacedPaths)
+	if err != nil {
+		return nil, nil, err
+	}
+	occurrences := make([]*codegraphpb.Occurrence, 0, len(symbol.Occurrences))
+	for _, o := range symbol.Occurrences {
+		if _, ok := replacedIds[o.FileId]; ok && o.FileId != 0 {
+			continue
+		}
+		if _, ok := replacedPaths[o.Path]; ok && o.Path != "" {
+			continue
+		}
+		occurrences = append(occurrences, o)
+	}
+	for _, posting := range postings {
+		if symbol.Name == "" && posting.Name != "" {
+			symbol.Name, symbol.Language = posting.Name, posting.Language
+		}
+		occurrences = append(occurrences, posting.Occurrences...)
+	}
+	symbol.Occurrences = occurrences
+	return symbol, postingKeys, nil
+}
+
+// readSymbol 读取符号表的值并合并增量，合并后没有任何出现时返回 leveldb.ErrNotFound
+func (s *LevelDBStorage) readSymbol(reader leveldbReader, db *leveldb.DB, projectUuid string,
+	symbolKey string) ([]byte, error) {
+	base, err := reader.Get([]byte(symbolKey), nil)
+	if err != nil && !errors.Is(err, leveldb.ErrNotFound) {
+		return nil, err
+	}
+	merged, _, mergeErr := s.mergeSymbolPostings(reader, db, s.pathDict(projectUuid), symbolKey, base)
+	if mergeErr != nil {
+		return nil, mergeErr
+	}
+	if merged == nil {
+		return base, err
+	}
+	if len(merged.Occurrences) == 0 {
+		return nil, leveldb.ErrNotFound
+	}
+	return proto.Marshal(merged)
+}
+
+// readValue 读取单个key，符号表key合并增量
+func (s *LevelDBStorage) readValue(reader leveldbReader, db *leveldb.DB, projectUuid string, key string) ([]byte, error) {
+	if IsSymbolNameKey(key) {
+		return s.readSymbol(reader, db, projectUuid, key)
+	}
+	return reader.Get([]byte(key), nil)
+}
+
+// deleteSymbolPostings 整体写入或删除符号表时，同一个 batch 中删除该符号的增量
+func deleteSymbolPostings(reader leveldbReader, batch *leveldb.Batch, symbolKey string) error {
+	iter := reader.NewIterator(util.BytesPrefix(symbolPostingPrefix(symbolKey)), nil)
+	defer iter.Release()
+	for iter.Next() {
+		batch.Delete(iter.Key())
+	}
+	return iter.Error()
+}
+
+func (s *LevelDBStorage) postingState(projectUuid string) *postingState {
+	if state, ok := s.postingStates.Load(projectUuid); ok {
+		return state.(*postingState)
+	}
+	state, _ := s.postingStates.LoadOrStore(projectUuid, &postingState{})
+	return state.(*postingState)
+}
+
+// notePostings 记录写入的增量数，达到阈值后在后台压缩
+func (s *LevelDBStorage) notePostings(projectUuid string, n int) {
+	if n == 0 {
+		return
+	}
+	state := s.postingState(projectUuid)
+	if state.pending.Add(int64(n)) < int64(s.config.PostingCompactThreshold) {
+		return
+	}
+	if !state.running.CompareAndSwap(false, true) {
+		return
+	}
+	go func() {
+		defer state.running.Store(false)
+		if _, err := s.CompactSymbolPostings(s.cleanupCtx, projectUuid); err != nil {
+			s.logger.Warn("posting_compact: failed to compact symbol postings. project %s, err: %v", projectUuid, err)
+		}
+	}()
+}
+
+// CompactSymbolPostings 将符号增量合并进符号表并删除增量，返回处理的符号数。
+// 每个符号的读-改-写在写锁内完成，不会覆盖压缩期间新写入的增量
+func (s *LevelDBStorage) CompactSymbolPostings(ctx context.Context, projectUuid string) (int, error) {
+	db, release, err := s.getDB(projectUuid)
+	if err != nil {
+		return 0, fmt.Errorf("failed to get database: %w", err)
+	}
+	defer release()
+	start := time.Now()
+	state := s.postingState(projectUuid)
+	state.pending.Store(0)
+	dict := s.pathDict(projectUuid)
+	counter := s.keyCounter(projectUuid)
+	reader := s.reader(projectUuid, db)
+
+	iter := reader.NewIterator(util.BytesPrefix([]byte(SymbolPostingKeySystemPrefix)), nil)
+	defer iter.Release()
+	compacted := 0
+	lastSymbolKey := ""
+	for iter.Next() {
+		symbolKey, ok := postingSymbolKey(iter.Key())
+		if !ok || symbolKey == lastSymbolKey {
+			continue
+		}
+		lastSymbolKey = symbolKey
+		if compacted%100 == 0 {
+			if err = utils.CheckContext(ctx); err != nil {
+				return compacted, err
+			}
+		}
+		err = counter.update(db, func(batch *leveldb.Batch) error {
+			base, err := reader.Get([]byte(symbolKey), nil)
+			if err != nil && !errors.Is(err, leveldb.ErrNotFound) {
+				return err
+			}
+			merged, postingKeys, err := s.mergeSymbolPostings(reader, db, dict, symbolKey, base)
+			if err != nil || merged == nil {
+				return err
+			}
+			for _, key := range postingKeys {
+				batch.Delete(key)
+			}
+			if len(merged.Occurrences) == 0 {
+				batch.Delete([]byte(symbolKey))
+				return nil
+			}
+			value, err := proto.Marshal(merged)
+			if err != nil {
+				return err
+			}
+			batch.Put([]byte(symbolKey), value)
+			return nil
+		})
+		if err != nil {
+			return compacted, fmt.Errorf("failed to compact symbol %q: %w", symbolKey, err)
+		}
+		compacted++
+	}
+	if err = iter.Error(); err != nil {
+		return compacted, err
+	}
+	if compacted > 0 {
+		s.logger.Info("posting_compact: project %s compacted %d symbols, cost %d ms", projectUuid, compacted,
+			time.Since(start).Milliseconds())
+	}
+	return compacted, nil
+}
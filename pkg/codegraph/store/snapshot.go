@@ -0,0 +1,374 @@
+package store
+
+import (
+	"bufio"
+	"bytes"
+	"encoding/binary"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"hash"
+	"hash/crc32"
+	"io"
+	"os"
+	"sort"
+	"sync/atomic"
+
+	"github.com/syndtr/goleveldb/leveldb/iterator"
+	"github.com/syndtr/goleveldb/leveldb/util"
+)
+
+// 快照文件：项目索引某一时刻的只读副本，按键序保存原始键值，可直接映射到内存查询。
+//
+//	魔数(8) | 记录: uvarint(键长) uvarint(值长) 键 值 ... | 记录偏移: 每条 8 字节小端 |
+//	元数据 JSON | 尾部: 偏移区起点 记录数 元数据起点 元数据长度(各 8 字节) crc32c(4) 保留(4) 魔数(8)
+//
+// crc32c 覆盖尾部校验和之前的全部内容，打开时整体校验一次
+const (
+	snapshotMagic      = "CGSNAP\x00\x01"
+	snapshotFooterSize = 48
+	// SnapshotFileExt 快照文件扩展名
+	SnapshotFileExt = ".cgsnap"
+)
+
+var snapshotCrcTable = crc32.MakeTable(crc32.Castagnoli)
+
+// SnapshotMeta 快照元数据
+type SnapshotMeta struct {
+	Commit      string `json:"commit"`      // 导出时项目所在的提交
+	ProjectUuid string `json:"projectUuid"` // 由项目名和路径生成，快照只能导入同一路径的项目
+	ProjectPath string `json:"projectPath"`
+	CreatedAt   int64  `json:"createdAt"`
+	Layout      byte   `json:"layout"`
+	Keys        int    `json:"keys"`
+	// FileHashes 导出时与索引一致的源文件内容哈希，导入后用于确认本地文件未修改，免去重新索引
+	FileHashes map[string]string `json:"fileHashes,omitempty"`
+	// Checksum 快照文件的校验和，打开时填充
+	Checksum uint32 `json:"-"`
+}
+
+// snapshotWriter 按键序写入快照，键必须严格递增
+type snapshotWriter struct {
+	out     io.Writer
+	w       *bufio.Writer
+	crc     hash.Hash32
+	offset  uint64
+	offsets []uint64
+	lastKey []byte
+	buf     [2 * binary.MaxVarintLen64]byte
+}
+
+func newSnapshotWriter(w io.Writer) (*snapshotWriter, error) {
+	crc := crc32.New(snapshotCrcTable)
+	sw := &snapshotWriter{out: w, w: bufio.NewWriterSize(io.MultiWriter(w, crc), 1<<20), crc: crc}
+	if err := sw.write([]byte(snapshotMagic)); err != nil {
+		return nil, err
+	}
+	return sw, nil
+}
+
+func (sw *snapshotWriter) write(p []byte) error {
+	n, err := sw.w.Write(p)
+	sw.offset += uint64(n)
+	return err
+}
+
+func (sw *snapshotWriter) add(key, value []byte) error {
+	if sw.offsets != nil && bytes.Compare(key, sw.lastKey) <= 0 {
+		return fmt.Errorf("snapshot keys out of order: %q after %q", key, sw.lastKey)
+	}
+	sw.offsets = append(sw.offsets, sw.offset)
+	sw.lastKey = append(sw.lastKey[:0], key...)
+	n := binary.PutUvarint(sw.buf[:], uint64(len(key)))
+	n += binary.PutUvarint(sw.buf[n:], uint64(len(value)))
+	if err := sw.write(sw.buf[:n]); err != nil {
+		return err
+	}
+	if err := sw.write(key); err != nil {
+		return err
+	}
+	return sw.write(value)
+}
+
+// finish 写入偏移区、元数据和尾部，返回校验和
+func (sw *snapshotWriter) finish(meta *SnapshotMeta) (uint32, error) {
+	offsetsStart := sw.offset
+	var b [8]byte
+	for _, off := range sw.offsets {
+		binary.LittleEndian.PutUint64(b[:], off)
+		if err := sw.write(b[:]); err != nil {
+			return 0, err
+		}
+	}
+	meta.Keys = len(sw.offsets)
+	metaData, err := json.Marshal(meta)
+	if err != nil {
+		return 0, err
+	}
+	metaStart := sw.offset
+	if err = sw.write(metaData); err != nil {
+		return 0, err
+	}
+	var footer [snapshotFooterSize]byte
+	binary.LittleEndian.PutUint64(footer[0:], offsetsStart)
+	binary.LittleEndian.PutUint64(footer[8:], uint64(len(sw.offsets)))
+	binary.LittleEndian.PutUint64(footer[16:], metaStart)
+	binary.LittleEndian.PutUint64(footer[24:], uint64(len(metaData)))
+	if err = sw.write(footer[:32]); err != nil {
+		return 0, err
+	}
+	if err = sw.w.Flush(); err != nil {
+		return 0, err
+	}
+	// 校验和及之后的内容不计入 crc，直接写入底层
+	checksum := sw.crc.Sum32()
+	binary.LittleEndian.PutUint32(footer[32:], checksum)
+	copy(footer[40:], snapshotMagic)
+	if _, err = sw.out.Write(footer[32:]); err != nil {
+		return 0, err
+	}
+	return checksum, nil
+}
+
+// snapshotFile 映射到内存的只读快照。引用计数归零后解除映射，
+// 查询通过 acquire/release 保证使用期间映射有效
+type snapshotFile struct {
+	meta    SnapshotMeta
+	data    []byte
+	offsets []byte
+	count   int
+	unmap   func() error
+	refs    atomic.Int64
+}
+
+// openSnapshot 打开并校验快照文件
+func openSnapshot(path string) (*snapshotFile, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer f.Close()
+	info, err := f.Stat()
+	if err != nil {
+		return nil, err
+	}
+	if info.Size() < int64(len(snapshotMagic)+snapshotFooterSize) {
+		return nil, fmt.Errorf("snapshot %s too small", path)
+	}
+	data, unmap, err := mapFile(f, int(info.Size()))
+	if err != nil {
+		return nil, fmt.Errorf("failed to map snapshot %s: %w", path, err)
+	}
+	sf, err := parseSnapshot(data)
+	if err != nil {
+		_ = unmap()
+		return nil, fmt.Errorf("invalid snapshot %s: %w", path, err)
+	}
+	sf.unmap = unmap
+	sf.refs.Store(1)
+	return sf, nil
+}
+
+// parseSnapshot 校验尾部、校验和以及每条记录的边界
+func parseSnapshot(data []byte) (*snapshotFile, error) {
+	size := uint64(len(data))
+	if size < uint64(len(snapshotMagic)+snapshotFooterSize) {
+		return nil, errors.New("too small")
+	}
+	footer := data[size-snapshotFooterSize:]
+	if string(data[:len(snapshotMagic)]) != snapshotMagic || string(footer[40:]) != snapshotMagic {
+		return nil, errors.New("bad magic")
+	}
+	if crc32.Checksum(data[:size-snapshotFooterSize+32], snapshotCrcTable) != binary.LittleEndian.Uint32(footer[32:]) {
+		return nil, errors.New("checksum mismatch")
+	}
+	offsetsStart := binary.LittleEndian.Uint64(footer[0:])
+	count := binary.LittleEndian.Uint64(footer[8:])
+	metaStart := binary.LittleEndian.Uint64(footer[16:])
+	metaLen := binary.LittleEndian.Uint64(footer[24:])
+	// 先确认 offsetsStart 落在尾部之前，后面的减法不会下溢
+	dataEnd := size - snapshotFooterSize
+	if offsetsStart < uint64(len(snapshotMagic)) || offsetsStart > dataEnd || count > (dataEnd-offsetsStart)/8 ||
+		metaStart != offsetsStart+count*8 || metaLen > dataEnd-metaStart {
+		return nil, errors.New("bad footer")
+	}
+	sf := &snapshotFile{
+		data:    data[:offsetsStart],
+		offsets: data[offsetsStart:metaStart],
+		count:   int(count),
+	}
+	if err := json.Unmarshal(data[metaStart:metaStart+metaLen], &sf.meta); err != nil {
+		return nil, fmt.Errorf("bad meta: %w", err)
+	}
+	if sf.meta.Layout != layoutVersion {
+		return nil, fmt.Errorf("unsupported layout version %d", sf.meta.Layout)
+	}
+	var prev []byte
+	for i := 0; i < sf.count; i++ {
+		key, _, ok := sf.checkedRecord(i)
+		if !ok {
+			return nil, fmt.Errorf("bad record %d", i)
+		}
+		if i > 0 && bytes.Compare(key, prev) <= 0 {
+			return nil, fmt.Errorf("record %d out of order", i)
+		}
+		prev = key
+	}
+	sf.meta.Checksum = binary.LittleEndian.Uint32(footer[32:])
+	return sf, nil
+}
+
+func (sf *snapshotFile) checkedRecord(i int) (key, value []byte, ok bool) {
+	off := binary.LittleEndian.Uint64(sf.offsets[i*8:])
+	if off >= uint64(len(sf.data)) {
+		return nil, nil, false
+	}
+	rec := sf.data[off:]
+	klen, n := binary.Uvarint(rec)
+	if n <= 0 {
+		return nil, nil, false
+	}
+	vlen, m := binary.Uvarint(rec[n:])
+	if m <= 0 {
+		return nil, nil, false
+	}
+	rec = rec[n+m:]
+	if klen > uint64(len(rec)) || vlen > uint64(len(rec))-klen {
+		return nil, nil, false
+	}
+	return rec[:klen:klen], rec[klen : klen+vlen : klen+vlen], true
+}
+
+// record 第 i 条记录，打开时已校验边界。返回的切片指向映射的内存，只在持有引用期间有效
+func (sf *snapshotFile) record(i int) (key, value []byte) {
+	key, value, _ = sf.checkedRecord(i)
+	return key, value
+}
+
+// search 第一条键不小于 key 的记录下标
+func (sf *snapshotFile) search(key []byte) int {
+	return sort.Search(sf.count, func(i int) bool {
+		k, _ := sf.record(i)
+		return bytes.Compare(k, key) >= 0
+	})
+}
+
+// get 读取键的值，返回指向映射内存的切片
+func (sf *snapshotFile) get(key []byte) ([]byte, bool) {
+	i := sf.search(key)
+	if i == sf.count {
+		return nil, false
+	}
+	k, v := sf.record(i)
+	if !bytes.Equal(k, key) {
+		return nil, false
+	}
+	return v, true
+}
+
+// acquire 增加引用，快照已关闭时返回 false
+func (sf *snapshotFile) acquire() bool {
+	for {
+		n := sf.refs.Load()
+		if n <= 0 {
+			return false
+		}
+		if sf.refs.CompareAndSwap(n, n+1) {
+			return true
+		}
+	}
+}
+
+func (sf *snapshotFile) release() {
+	if sf.refs.Add(-1) == 0 && sf.unmap != nil {
+		_ = sf.unmap()
+	}
+}
+
+// newIterator 遍历范围内的记录，调用方已持有引用，Release 时释放
+func (sf *snapshotFile) newIterator(slice *util.Range) *snapshotIterator {
+	it := &snapshotIterator{file: sf, lo: 0, hi: sf.count}
+	if slice != nil {
+		if slice.Start != nil {
+			it.lo = sf.search(slice.Start)
+		}
+		if slice.Limit != nil {
+			it.hi = sf.search(slice.Limit)
+		}
+	}
+	it.pos = it.lo - 1
+	return it
+}
+
+// snapshotIterator 实现 iterator.Iterator
+type snapshotIterator struct {
+	util.BasicReleaser
+	file     *snapshotFile
+	lo, hi   int
+	pos      int
+	released bool
+}
+
+var _ iterator.Iterator = (*snapshotIterator)(nil)
+
+func (it *snapshotIterator) Valid() bool {
+	return !it.released && it.pos >= it.lo && it.pos < it.hi
+}
+
+func (it *snapshotIterator) First() bool {
+	it.pos = it.lo
+	return it.Valid()
+}
+
+func (it *snapshotIterator) Last() bool {
+	it.pos = it.hi - 1
+	return it.Valid()
+}
+
+func (it *snapshotIterator) Seek(key []byte) bool {
+	it.pos = max(it.lo, it.file.search(key))
+	return it.Valid()
+}
+
+func (it *snapshotIterator) Next() bool {
+	if it.pos < it.hi {
+		it.pos++
+	}
+	return it.Valid()
+}
+
+func (it *snapshotIterator) Prev() bool {
+	if it.pos >= it.lo {
+		it.pos--
+	}
+	return it.Valid()
+}
+
+func (it *snapshotIterator) Key() []byte {
+	if !it.Valid() {
+		return nil
+	}
+	key, _ := it.file.record(it.pos)
+	return key
+}
+
+func (it *snapshotIterator) Value() []byte {
+	if !it.Valid() {
+		return nil
+	}
+	_, value := it.file.record(it.pos)
+	return value
+}
+
+func (it *snapshotIterator) Error() error {
+	return nil
+}
+
+func (it *snapshotIterator) Release() {
+	if it.released {
+		return
+	}
+	it.released = true
+	it.file.release()
+	it.BasicReleaser.Release()
+}
@@ -0,0 +1,157 @@
+package store
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"context"
+	"encoding/binary"
+	"fmt"
+	"hash/crc32"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+	"github.com/syndtr/goleveldb/leveldb/util"
+	"google.golang.org/protobuf/proto"
+)
+
+func TestSnapshotFile(t *testing.T) {
+	var buf bytes.Buffer
+	sw, err := newSnapshotWriter(&buf)
+	require.NoError(t, err)
+	require.NoError(t, sw.add([]byte("\x00v"), []byte{layoutVersion}))
+	for i := 0; i < 100; i++ {
+		require.NoError(t, sw.add([]byte(fmt.Sprintf("\x01k%03d", i)), []byte(fmt.Sprintf("v%d", i))))
+	}
+	assert.Error(t, sw.add([]byte("\x01k000"), nil))
+	meta := SnapshotMeta{Commit: "abc", ProjectUuid: "p"}
+	checksum, err := sw.finish(&meta)
+	require.NoError(t, err)
+
+	path := filepath.Join(t.TempDir(), "a"+SnapshotFileExt)
+	require.NoError(t, os.WriteFile(path, buf.Bytes(), 0644))
+	sf, err := openSnapshot(path)
+	require.NoError(t, err)
+	assert.Equal(t, checksum, sf.meta.Checksum)
+	assert.Equal(t, "abc", sf.meta.Commit)
+	assert.Equal(t, 101, sf.meta.Keys)
+
+	value, ok := sf.get([]byte("\x01k042"))
+	require.True(t, ok)
+	assert.Equal(t, "v42", string(value))
+	_, ok = sf.get([]byte("\x01k1000"))
+	assert.False(t, ok)
+
+	require.True(t, sf.acquire())
+	iter := sf.newIterator(&util.Range{Start: []byte("\x01k010"), Limit: []byte("\x01k020")})
+	var keys []string
+	for iter.Next() {
+		keys = append(keys, string(iter.Key()))
+	}
+	assert.Len(t, keys, 10)
+	assert.Equal(t, "\x01k010", keys[0])
+	assert.True(t, iter.Seek([]byte("\x01k015")))
+	assert.Equal(t, "v15", string(iter.Value()))
+	iter.Release()
+	sf.release()
+	assert.False(t, sf.acquire())
+
+	// 任意字节损坏都在打开时发现
+	data := bytes.Clone(buf.Bytes())
+	data[len(snapshotMagic)+3] ^= 0xff
+	require.NoError(t, os.WriteFile(path, data, 0644))
+	_, err = openSnapshot(path)
+	assert.Error(t, err)
+
+	// 校验和正确但偏移越界的尾部不会导致下溢
+	data = bytes.Clone(buf.Bytes())
+	footer := data[len(data)-snapshotFooterSize:]
+	binary.LittleEndian.PutUint64(footer[0:], uint64(len(data))+1)
+	binary.LittleEndian.PutUint32(footer[32:], crc32.Checksum(data[:len(data)-snapshotFooterSize+32], snapshotCrcTable))
+	_, err = parseSnapshot(data)
+	assert.ErrorContains(t, err, "bad footer")
+}
+
+func TestLevelDBStorage_Snapshot(t *testing.T) {
+	ctx := context.Background()
+	projectID := "test-project"
+	value := &codegraphpb.TestMessage{Value: "v"}
+	pathKey := func(i int) Key { return ElementPathKey{Language: lang.Go, Path: fmt.Sprintf("/src/%d.go", i)} }
+	symbolKey := SymbolNameKey{Language: lang.Go, Name: "Foo"}
+
+	source, err := NewLevelDBStorage(t.TempDir(), &MockLogger{})
+	require.NoError(t, err)
+	defer source.Close()
+	require.NoError(t, source.BatchSave(ctx, projectID, CreateTestValues(
+		[]proto.Message{value, value, value, &codegraphpb.SymbolOccurrence{Name: "Foo", Language: string(lang.Go),
+			Occurrences: []*codegraphpb.Occurrence{{Path: "/src/1.go", Range: []int32{1, 0, 1, 3}}}}},
+		[]Key{pathKey(1), pathKey(2), pathKey(3), symbolKey},
+	)))
+	path := filepath.Join(t.TempDir(), "export"+SnapshotFileExt)
+	f, err := os.Create(path)
+	require.NoError(t, err)
+	meta, err := source.ExportSnapshot(ctx, projectID, f, SnapshotMeta{Commit: "abc"})
+	require.NoError(t, err)
+	require.NoError(t, f.Close())
+	assert.Equal(t, projectID, meta.ProjectUuid)
+
+	baseDir := t.TempDir()
+	storage, err := NewLevelDBStorage(baseDir, &MockLogger{})
+	require.NoError(t, err)
+	_, err = storage.ImportSnapshot(ctx, "other-project", path)
+	assert.Error(t, err)
+	imported, err := storage.ImportSnapshot(ctx, projectID, path)
+	require.NoError(t, err)
+	assert.Equal(t, meta.Checksum, imported.Checksum)
+	require.NotNil(t, storage.MountedSnapshot(projectID))
+
+	// 快照中的数据直接可读，路径字典随快照导入
+	assert.Equal(t, 3, storage.Size(ctx, projectID, PathKeySystemPrefix))
+	data, err := storage.Get(ctx, projectID, symbolKey)
+	require.NoError(t, err)
+	var symbol codegraphpb.SymbolOccurrence
+	require.NoError(t, proto.Unmarshal(data, &symbol))
+	require.NoError(t, storage.ResolveFilePaths(ctx, projectID, symbol.Occurrences))
+	assert.Equal(t, "/src/1.go", symbol.Occurrences[0].Path)
+
+	// 写入进入覆盖层，删除快照中的键写墓碑
+	require.NoError(t, storage.Delete(ctx, projectID, pathKey(2)))
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: pathKey(4), Value: value}))
+	require.NoError(t, storage.Put(ctx, projectID, &Entry{Key: pathKey(1), Value: &codegraphpb.TestMessage{Value: "w"}}))
+	exists, err := storage.Exists(ctx, projectID, pathKey(2))
+	require.NoError(t, err)
+	assert.False(t, exists)
+	assertPaths := func(storage *LevelDBStorage) {
+		assert.Equal(t, 3, storage.Size(ctx, projectID, PathKeySystemPrefix))
+		iter := storage.IterPrefix(ctx, projectID, PathKeySystemPrefix)
+		var values []string
+		for iter.Next() {
+			var msg codegraphpb.TestMessage
+			require.NoError(t, proto.Unmarshal(iter.Value(), &msg))
+			values = append(values, iter.Key()[len(iter.Key())-4:]+"="+msg.Value)
+		}
+		require.NoError(t, iter.Close())
+		assert.Equal(t, []string{"1.go=w", "3.go=v", "4.go=v"}, values)
+	}
+	assertPaths(storage)
+	require.NoError(t, storage.Close())
+
+	// 重新打开后快照与覆盖层一起恢复
+	storage, err = NewLevelDBStorage(baseDir, &MockLogger{})
+	require.NoError(t, err)
+	defer storage.Close()
+	assertPaths(storage)
+	require.NotNil(t, storage.MountedSnapshot(projectID))
+
+	require.NoError(t, storage.AdoptSnapshotFiles(ctx, projectID, map[string]int64{"/src/1.go": 42}))
+	adopted, err := storage.AdoptedSnapshotFiles(ctx, projectID)
+	require.NoError(t, err)
+	assert.Equal(t, map[string]int64{"/src/1.go": 42}, adopted)
+
+	require.NoError(t, storage.DeleteAll(ctx, projectID))
+	assert.Nil(t, storage.MountedSnapshot(projectID))
+	assert.Equal(t, 0, storage.Size(ctx, projectID, ""))
+}
@@ -2,6 +2,7 @@ package store
 
 import (
 	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
 	"codebase-indexer/pkg/codegraph/types"
 	"context"
 	"fmt"
@@ -16,13 +17,18 @@ import (
 
 type GraphStorage interface {
 	BatchSave(ctx context.Context, projectUuid string, values Entries) error
+	BeginBulkLoad(ctx context.Context, projectUuid string) error
+	EndBulkLoad(ctx context.Context, projectUuid string) error
 	Put(ctx context.Context, projectUuid string, entry *Entry) error
 	Get(ctx context.Context, projectUuid string, key Key) ([]byte, error)
+	MultiGet(ctx context.Context, projectUuid string, keys []Key) ([][]byte, error)
 	Exists(ctx context.Context, projectUuid string, key Key) (bool, error)
 	Delete(ctx context.Context, projectUuid string, key Key) error
 	DeleteAll(ctx context.Context, projectUuid string) error
 	DeleteAllWithPrefix(ctx context.Context, projectUuid string, prefix string) error
 	Iter(ctx context.Context, projectUuid string) Iterator
+	IterPrefix(ctx context.Context, projectUuid string, keyPrefix string) Iterator
+	IterRange(ctx context.Context, projectUuid string, start string, limit string) Iterator
 	Size(ctx context.Context, projectUuid string, keyPrefix string) int
 	Close() error
 	ProjectIndexExists(projectUuid string) (bool, error)
@@ -46,13 +52,78 @@ type Iterator interface {
 	Close() error
 }
 
+// 存储布局 v2：键的第一个字节为类型标签，语言编码为一个字节，路径和符号名按原样追加，
+// 同类键共享前缀便于 LevelDB 前缀压缩。以 \x00 开头的键为存储内部使用（布局版本、路径字典），
+// 不会出现在 Iter 和 Size 的结果中
 const (
-	PathKeySystemPrefix      = "@path"
-	SymKeySystemPrefix       = "@sym"
-	CalleeMapKeySystemPrefix = "@callee"
-	dataDir                  = "data"
+	PathKeySystemPrefix      = "\x01"
+	SymKeySystemPrefix       = "\x02"
+	CalleeMapKeySystemPrefix = "\x03"
+	MetaKeySystemPrefix      = "\x04"
+	// SymbolPostingKeySystemPrefix 符号表的按文件增量，读取符号表时合并，后台压缩进符号表
+	SymbolPostingKeySystemPrefix = "\x05"
+	// ResolvedKeySystemPrefix 延迟解析的引用边及其元数据，不在 Iter 的数据范围内
+	ResolvedKeySystemPrefix = "\x06"
+	dataDir                 = "data"
 )
 
+const (
+	// internalKeyPrefix 存储内部键的前缀，排在所有数据键之前
+	internalKeyPrefix = "\x00"
+	// dataKeyStart 数据键的起始位置，遍历时跳过内部键
+	dataKeyStart = "\x01"
+	// layoutVersionKey 记录存储布局版本，不存在时表示旧的字符串布局，打开时自动迁移
+	layoutVersionKey = internalKeyPrefix + "v"
+	// filePathIdPrefix 路径 -> 文件ID
+	filePathIdPrefix = internalKeyPrefix + "f"
+	// fileIdPathPrefix 文件ID(4字节大端) -> 路径
+	fileIdPathPrefix = internalKeyPrefix + "i"
+	// keySeparator 被调用者索引中符号名与文件路径的分隔符
+	keySeparator = "\x00"
+
+	layoutVersion byte = 2
+)
+
+// languageIds 语言编码表，只能在末尾追加，已有语言的编码不能修改
+var languageIds = []lang.Language{
+	lang.Java,
+	lang.Python,
+	lang.Go,
+	lang.JavaScript,
+	lang.TypeScript,
+	lang.Rust,
+	lang.C,
+	lang.CPP,
+	lang.CSharp,
+	lang.Ruby,
+	lang.PHP,
+	lang.Kotlin,
+	lang.Scala,
+}
+
+var languageIdIndex = func() map[lang.Language]byte {
+	index := make(map[lang.Language]byte, len(languageIds))
+	for i, l := range languageIds {
+		index[l] = byte(i + 1)
+	}
+	return index
+}()
+
+func encodeLanguage(language lang.Language) (byte, error) {
+	id, ok := languageIdIndex[language]
+	if !ok {
+		return 0, fmt.Errorf("unsupported language %s", language)
+	}
+	return id, nil
+}
+
+func decodeLanguage(id byte) (lang.Language, error) {
+	if id == 0 || int(id) > len(languageIds) {
+		return types.EmptyString, fmt.Errorf("unknown language id %d", id)
+	}
+	return languageIds[id-1], nil
+}
+
 type Key interface {
 	Get() (string, error)
 }
@@ -69,7 +140,11 @@ func (p ElementPathKey) Get() (string, error) {
 	if p.Path == types.EmptyString {
 		return types.EmptyString, fmt.Errorf("ElementPathKey field Path must not be empty")
 	}
-	return fmt.Sprintf("%s:%s:%s", PathKeySystemPrefix, p.Language, p.Path), nil
+	id, err := encodeLanguage(p.Language)
+	if err != nil {
+		return types.EmptyString, fmt.Errorf("ElementPathKey: %w", err)
+	}
+	return PathKeySystemPrefix + string([]byte{id}) + p.Path, nil
 }
 
 type SymbolNameKey struct {
@@ -84,15 +159,134 @@ func (s SymbolNameKey) Get() (string, error) {
 	if s.Name == types.EmptyString {
 		return types.EmptyString, fmt.Errorf("ElementPathKey field Name must not be empty")
 	}
-	return fmt.Sprintf("%s:%s:%s", SymKeySystemPrefix, s.Language, s.Name), nil
+	id, err := encodeLanguage(s.Language)
+	if err != nil {
+		return types.EmptyString, fmt.Errorf("SymbolNameKey: %w", err)
+	}
+	return SymKeySystemPrefix + string([]byte{id}) + s.Name, nil
 }
 
+// ElementPathKeyPrefix 某个语言下路径以 pathPrefix 开头的元素表key前缀，pathPrefix 为空时为该语言的全部元素表
+func ElementPathKeyPrefix(language lang.Language, pathPrefix string) (string, error) {
+	id, err := encodeLanguage(language)
+	if err != nil {
+		return types.EmptyString, fmt.Errorf("ElementPathKeyPrefix: %w", err)
+	}
+	return PathKeySystemPrefix + string([]byte{id}) + pathPrefix, nil
+}
+
+// ElementPathKeyPrefixes 所有语言下路径以 pathPrefix 开头的元素表key前缀
+func ElementPathKeyPrefixes(pathPrefix string) []string {
+	prefixes := make([]string, 0, len(languageIds))
+	for _, language := range languageIds {
+		prefix, _ := ElementPathKeyPrefix(language, pathPrefix)
+		prefixes = append(prefixes, prefix)
+	}
+	return prefixes
+}
+
+// SymbolPostingKey 符号在单个文件内的全部出现，写入后替换符号表中该文件的出现，
+// 值为没有出现的 SymbolOccurrence 时表示从符号表中删除该文件。写入只与文件大小相关，无需读取符号表
+type SymbolPostingKey struct {
+	Language lang.Language
+	Name     string
+	FilePath string
+}
+
+func (s SymbolPostingKey) Get() (string, error) {
+	if s.Name == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("SymbolPostingKey field Name must not be empty")
+	}
+	if s.FilePath == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("SymbolPostingKey field FilePath must not be empty")
+	}
+	id, err := encodeLanguage(s.Language)
+	if err != nil {
+		return types.EmptyString, fmt.Errorf("SymbolPostingKey: %w", err)
+	}
+	return SymbolPostingKeySystemPrefix + string([]byte{id}) + s.Name + keySeparator + s.FilePath, nil
+}
+
+// CalleeMapKey 被调用者反向索引，按 被调用符号名+调用方文件 拆分，文件变更时只需增删该文件对应的key
 type CalleeMapKey struct {
 	SymbolName string
+	FilePath   string
 }
 
 func (c CalleeMapKey) Get() (string, error) {
-	return fmt.Sprintf("%s:%s", CalleeMapKeySystemPrefix, c.SymbolName), nil
+	if c.SymbolName == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("CalleeMapKey field SymbolName must not be empty")
+	}
+	if c.FilePath == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("CalleeMapKey field FilePath must not be empty")
+	}
+	return CalleeMapKeyPrefix(c.SymbolName) + c.FilePath, nil
+}
+
+// CalleeMapKeyPrefix 某个被调用符号所有调用方文件的key前缀
+func CalleeMapKeyPrefix(symbolName string) string {
+	return CalleeMapKeySystemPrefix + symbolName + keySeparator
+}
+
+// MetaKey 索引元数据，如派生索引的版本号
+type MetaKey struct {
+	Name string
+}
+
+func (m MetaKey) Get() (string, error) {
+	if m.Name == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("MetaKey field Name must not be empty")
+	}
+	return MetaKeySystemPrefix + m.Name, nil
+}
+
+// ResolvedSymbolKey 引用方文件中的调用、引用解析到的定义，按 符号名+引用方文件 存储，
+// 值为 SymbolOccurrence，只记录定义所在的文件。定义变化时按符号名前缀找到受影响的引用方文件
+type ResolvedSymbolKey struct {
+	SymbolName string
+	FilePath   string
+}
+
+func (r ResolvedSymbolKey) Get() (string, error) {
+	if r.SymbolName == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("ResolvedSymbolKey field SymbolName must not be empty")
+	}
+	if r.FilePath == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("ResolvedSymbolKey field FilePath must not be empty")
+	}
+	return ResolvedSymbolKeyPrefix(r.SymbolName) + r.FilePath, nil
+}
+
+// ResolvedSymbolKeyPrefix 引用了某个符号的所有文件的解析结果key前缀
+func ResolvedSymbolKeyPrefix(symbolName string) string {
+	return ResolvedKeySystemPrefix + symbolName + keySeparator
+}
+
+// ResolvedPendingKeyPrefix 等待重新解析的文件。符号名不为空，与解析结果的key不会冲突
+const ResolvedPendingKeyPrefix = ResolvedKeySystemPrefix + keySeparator + "p"
+
+// ResolvePendingKey 等待重新解析的文件，该文件已有的解析结果已删除
+type ResolvePendingKey struct {
+	FilePath string
+}
+
+func (r ResolvePendingKey) Get() (string, error) {
+	if r.FilePath == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("ResolvePendingKey field FilePath must not be empty")
+	}
+	return ResolvedPendingKeyPrefix + r.FilePath, nil
+}
+
+// ResolvedMetaKey 解析结果的元数据，如格式版本。与解析结果同前缀，随解析结果一起删除
+type ResolvedMetaKey struct {
+	Name string
+}
+
+func (r ResolvedMetaKey) Get() (string, error) {
+	if r.Name == types.EmptyString {
+		return types.EmptyString, fmt.Errorf("ResolvedMetaKey field Name must not be empty")
+	}
+	return ResolvedKeySystemPrefix + keySeparator + "m" + r.Name, nil
 }
 
 func IsSymbolNameKey(key string) bool {
@@ -104,52 +298,40 @@ func IsCalleeMapKey(key string) bool {
 func IsElementPathKey(key string) bool {
 	return strings.HasPrefix(key, PathKeySystemPrefix)
 }
+func IsMetaKey(key string) bool {
+	return strings.HasPrefix(key, MetaKeySystemPrefix)
+}
+func IsSymbolPostingKey(key string) bool {
+	return strings.HasPrefix(key, SymbolPostingKeySystemPrefix)
+}
 
 func ToSymbolNameKey(key string) (SymbolNameKey, error) {
-	// 查找第一个冒号位置
-	first := strings.Index(key, types.Colon)
-	if first == -1 {
-		return SymbolNameKey{}, fmt.Errorf("invalid symbol_name key: %s", key)
+	// 标签 + 语言编码 + 符号名
+	if len(key) < 3 || !IsSymbolNameKey(key) {
+		return SymbolNameKey{}, fmt.Errorf("invalid symbol_name key: %q", key)
 	}
-	// 查找第二个冒号位置
-	second := strings.Index(key[first+1:], types.Colon)
-	if second == -1 {
-		return SymbolNameKey{}, fmt.Errorf("invalid symbol_name key: %s", key)
-	}
-
-	second += first + 1
-
-	if key[:first] != SymKeySystemPrefix {
-		return SymbolNameKey{}, fmt.Errorf("invalid symbol_name key: %s", key)
+	language, err := decodeLanguage(key[1])
+	if err != nil {
+		return SymbolNameKey{}, fmt.Errorf("invalid symbol_name key: %q, %w", key, err)
 	}
-
 	return SymbolNameKey{
-		Language: lang.Language(key[first+1 : second]),
-		Name:     key[second+1:],
+		Language: language,
+		Name:     key[2:],
 	}, nil
 }
 
 func ToElementPathKey(key string) (ElementPathKey, error) {
-	// 查找第一个冒号位置
-	first := strings.Index(key, types.Colon)
-	if first == -1 {
-		return ElementPathKey{}, fmt.Errorf("invalid element_path key: %s", key)
-	}
-	// 查找第二个冒号位置
-	second := strings.Index(key[first+1:], types.Colon)
-	if second == -1 {
-		return ElementPathKey{}, fmt.Errorf("invalid element_path key: %s", key)
+	// 标签 + 语言编码 + 路径
+	if len(key) < 3 || !IsElementPathKey(key) {
+		return ElementPathKey{}, fmt.Errorf("invalid element_path key: %q", key)
 	}
-
-	second += first + 1
-
-	if key[:first] != PathKeySystemPrefix {
-		return ElementPathKey{}, fmt.Errorf("invalid element_path key: %s", key)
+	language, err := decodeLanguage(key[1])
+	if err != nil {
+		return ElementPathKey{}, fmt.Errorf("invalid element_path key: %q, %w", key, err)
 	}
-
 	return ElementPathKey{
-		Language: lang.Language(key[first+1 : second]),
-		Path:     key[second+1:],
+		Language: language,
+		Path:     key[2:],
 	}, nil
 }
 
@@ -178,3 +360,71 @@ func checkDirWritable(dir string) error {
 func UnmarshalValue(value []byte, target proto.Message) error {
 	return proto.Unmarshal(value, target)
 }
+
+// FilePathResolver 由使用路径字典的存储实现，将 Occurrence 中的文件ID还原为路径
+type FilePathResolver interface {
+	ResolveFilePaths(ctx context.Context, projectUuid string, occurrences []*codegraphpb.Occurrence) error
+}
+
+// SymbolPostingCompactor 由按文件写符号增量的存储实现，将增量合并进符号表。
+// 按键遍历符号表（如导出）之前调用，点查已在读取时合并，无需调用
+type SymbolPostingCompactor interface {
+	CompactSymbolPostings(ctx context.Context, projectUuid string) (int, error)
+}
+
+// UnmarshalSymbolOccurrence 解析符号表的值并还原文件路径，读取 SymbolNameKey 的值都应使用该方法
+func UnmarshalSymbolOccurrence(ctx context.Context, storage GraphStorage, projectUuid string,
+	value []byte, target *codegraphpb.SymbolOccurrence) error {
+	if err := proto.Unmarshal(value, target); err != nil {
+		return err
+	}
+	resolver, ok := storage.(FilePathResolver)
+	if !ok {
+		return nil
+	}
+	return resolver.ResolveFilePaths(ctx, projectUuid, target.Occurrences)
+}
+
+// NewResolvedIterator 包装迭代器，符号表的值还原文件路径后重新编码，用于导出等需要完整值的遍历
+func NewResolvedIterator(ctx context.Context, storage GraphStorage, projectUuid string, iter Iterator) Iterator {
+	if iter == nil {
+		return nil
+	}
+	if _, ok := storage.(FilePathResolver); !ok {
+		return iter
+	}
+	return &resolvedIterator{Iterator: iter, ctx: ctx, storage: storage, projectUuid: projectUuid}
+}
+
+type resolvedIterator struct {
+	Iterator
+	ctx         context.Context
+	storage     GraphStorage
+	projectUuid string
+	err         error
+}
+
+func (it *resolvedIterator) Value() []byte {
+	value := it.Iterator.Value()
+	if !IsSymbolNameKey(it.Iterator.Key()) {
+		return value
+	}
+	var symbol codegraphpb.SymbolOccurrence
+	if err := UnmarshalSymbolOccurrence(it.ctx, it.storage, it.projectUuid, value, &symbol); err != nil {
+		it.err = err
+		return value
+	}
+	resolved, err := proto.Marshal(&symbol)
+	if err != nil {
+		it.err = err
+		return value
+	}
+	return resolved
+}
+
+func (it *resolvedIterator) Error() error {
+	if it.err != nil {
+		return it.err
+	}
+	return it.Iterator.Error()
+}
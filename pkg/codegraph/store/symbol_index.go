@@ -0,0 +1,503 @@
+package store
+
+import (
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/proto/codegraphpb"
+	"codebase-indexer/pkg/codegraph/utils"
+	"context"
+	"errors"
+	"fmt"
+	"sort"
+	"strings"
+	"sync"
+	"unicode"
+
+	"github.com/syndtr/goleveldb/leveldb"
+	"github.com/syndtr/goleveldb/leveldb/util"
+	"google.golang.org/protobuf/proto"
+)
+
+// 符号名索引：内存中保存项目的全部符号名，短查询按排序后的小写名做前缀匹配，
+// 三个字符以上的查询按 trigram 倒排做子串和模糊匹配。首次搜索时从符号表和符号增量的键加载，
+// 之后随写入增量更新。删除文件只写空增量，无法得知符号在其他文件是否还有出现，
+// 索引只增不减，搜索命中时读取符号表确认，没有出现的从索引中移除
+
+const (
+	DefaultSymbolSearchLimit = 50
+	MaxSymbolSearchLimit     = 500
+	// symbolIndexCompactMin 已移除的条目数超过该值且超过总数一半时重建倒排
+	symbolIndexCompactMin = 1024
+)
+
+// SymbolMatchKind 符号名与查询的匹配方式
+type SymbolMatchKind string
+
+const (
+	SymbolMatchExact     SymbolMatchKind = "exact"
+	SymbolMatchPrefix    SymbolMatchKind = "prefix"
+	SymbolMatchSubstring SymbolMatchKind = "substring"
+	SymbolMatchFuzzy     SymbolMatchKind = "fuzzy"
+)
+
+// SymbolSearchOptions 符号名搜索参数
+type SymbolSearchOptions struct {
+	Query    string
+	Language lang.Language // 为空时搜索全部语言
+	Limit    int           // 为0时使用 DefaultSymbolSearchLimit
+}
+
+// SymbolNameMatch 符号名搜索结果，按 Score 从高到低排列
+type SymbolNameMatch struct {
+	Name        string
+	Language    lang.Language
+	Kind        SymbolMatchKind
+	Score       float64
+	Occurrences []*codegraphpb.Occurrence // 文件路径已还原
+}
+
+// SymbolNameSearcher 由维护符号名索引的存储实现
+type SymbolNameSearcher interface {
+	SearchSymbolNames(ctx context.Context, projectUuid string, opts SymbolSearchOptions) ([]*SymbolNameMatch, error)
+}
+
+type symbolEntryKey struct {
+	languageId byte
+	name       string
+}
+
+type symbolEntry struct {
+	symbolEntryKey
+	lower   string
+	touched uint64 // 最近一次写入时的 seq
+	removed bool
+}
+
+type symbolNameIndex struct {
+	ready   chan struct{} // 加载完成后关闭
+	loadErr error
+
+	mu       sync.RWMutex
+	entries  []symbolEntry
+	ids      map[symbolEntryKey]int32
+	trigrams map[uint32][]int32
+	sorted   []int32 // 按小写名排序的条目
+	unsorted []int32 // 尚未合并进 sorted 的新条目
+	removed  int
+	seq      uint64 // 每次 add 递增
+}
+
+func newSymbolNameIndex() *symbolNameIndex {
+	return &symbolNameIndex{
+		ready:    make(chan struct{}),
+		ids:      make(map[symbolEntryKey]int32),
+		trigrams: make(map[uint32][]int32),
+	}
+}
+
+// symbolKeyEntry 从符号表或符号增量的键中取出语言编码和符号名
+func symbolKeyEntry(key string) (symbolEntryKey, bool) {
+	if len(key) < 3 {
+		return symbolEntryKey{}, false
+	}
+	name := key[2:]
+	if IsSymbolPostingKey(key) {
+		end := strings.Index(name, keySeparator)
+		if end < 0 {
+			return symbolEntryKey{}, false
+		}
+		name = name[:end]
+	} else if !IsSymbolNameKey(key) {
+		return symbolEntryKey{}, false
+	}
+	if name == "" {
+		return symbolEntryKey{}, false
+	}
+	return symbolEntryKey{languageId: key[1], name: name}, true
+}
+
+// add 添加符号名，调用方持有写锁
+func (x *symbolNameIndex) add(k symbolEntryKey) {
+	x.seq++
+	if id, ok := x.ids[k]; ok {
+		x.entries[id].touched = x.seq
+		return
+	}
+	// 键中截出的名字会拖住整个键（增量键还包含路径），复制一份
+	k.name = strings.Clone(k.name)
+	id := int32(len(x.entries))
+	x.entries = append(x.entries, symbolEntry{symbolEntryKey: k, lower: strings.ToLower(k.name), touched: x.seq})
+	x.ids[k] = id
+	x.index(id)
+}
+
+// index 建立条目的倒排，调用方持有写锁
+func (x *symbolNameIndex) index(id int32) {
+	eachTrigram(x.entries[id].lower, func(t uint32) {
+		x.trigrams[t] = append(x.trigrams[t], id)
+	})
+	x.unsorted = append(x.unsorted, id)
+}
+
+// remove 移除确认已没有出现的符号，确认之后（seq 大于 since）又写入过的保留。调用方持有写锁
+func (x *symbolNameIndex) remove(k symbolEntryKey, since uint64) {
+	id, ok := x.ids[k]
+	if !ok || x.entries[id].touched > since {
+		return
+	}
+	delete(x.ids, k)
+	x.entries[id].removed = true
+	x.removed++
+	if x.removed >= symbolIndexCompactMin && x.removed*2 > len(x.entries) {
+		x.compact()
+	}
+}
+
+// compact 去掉已移除的条目，重建倒排和排序，调用方持有写锁
+func (x *symbolNameIndex) compact() {
+	entries := make([]symbolEntry, 0, len(x.entries)-x.removed)
+	for _, e := range x.entries {
+		if !e.removed {
+			entries = append(entries, e)
+		}
+	}
+	x.entries = entries
+	x.ids = make(map[symbolEntryKey]int32, len(entries))
+	x.trigrams = make(map[uint32][]int32)
+	x.sorted, x.unsorted = nil, nil
+	x.removed = 0
+	for i := range x.entries {
+		x.ids[x.entries[i].symbolEntryKey] = int32(i)
+		x.index(int32(i))
+	}
+}
+
+// mergeSorted 把新条目合并进排序数组，调用方持有写锁
+func (x *symbolNameIndex) mergeSorted() {
+	if len(x.unsorted) == 0 {
+		return
+	}
+	less := func(a, b int32) bool { return x.entries[a].lower < x.entries[b].lower }
+	added := x.unsorted
+	sort.Slice(added, func(i, j int) bool { return less(added[i], added[j]) })
+	merged := make([]int32, 0, len(x.sorted)+len(added))
+	i, j := 0, 0
+	for i < len(x.sorted) && j < len(added) {
+		if less(added[j], x.sorted[i]) {
+			merged = append(merged, added[j])
+			j++
+		} else {
+			merged = append(merged, x.sorted[i])
+			i++
+		}
+	}
+	merged = append(merged, x.sorted[i:]...)
+	merged = append(merged, added[j:]...)
+	x.sorted, x.unsorted = merged, nil
+}
+
+// symbolCandidate 待确认的搜索结果
+type symbolCandidate struct {
+	symbolEntryKey
+	kind  SymbolMatchKind
+	score float64
+}
+
+// candidates 按查询找出匹配的条目并打分，按分数排序
+func (x *symbolNameIndex) candidates(query string, languageId byte) []symbolCandidate {
+	lowerQuery := strings.ToLower(query)
+	var result []symbolCandidate
+	collect := func(id int32, overlap float64) {
+		e := &x.entries[id]
+		if e.removed || (languageId != 0 && e.languageId != languageId) {
+			return
+		}
+		if kind, score, ok := scoreSymbolName(e.name, e.lower, query, lowerQuery, overlap); ok {
+			result = append(result, symbolCandidate{symbolEntryKey: e.symbolEntryKey, kind: kind, score: score})
+		}
+	}
+
+	var queryTrigrams []uint32
+	eachTrigram(lowerQuery, func(t uint32) { queryTrigrams = append(queryTrigrams, t) })
+	if len(queryTrigrams) == 0 {
+		// 短查询只做前缀匹配
+		start := sort.Search(len(x.sorted), func(i int) bool { return x.entries[x.sorted[i]].lower >= lowerQuery })
+		for _, id := range x.sorted[start:] {
+			if !strings.HasPrefix(x.entries[id].lower, lowerQuery) {
+				break
+			}
+			collect(id, 1)
+		}
+	} else {
+		// 命中至少一半查询 trigram 的条目作为候选，全部命中的才可能是子串
+		counts := make([]uint16, len(x.entries))
+		for _, t := range queryTrigrams {
+			for _, id := range x.trigrams[t] {
+				counts[id]++
+			}
+		}
+		threshold := uint16((len(queryTrigrams) + 1) / 2)
+		for id, n := range counts {
+			if n >= threshold {
+				collect(int32(id), float64(n)/float64(len(queryTrigrams)))
+			}
+		}
+	}
+
+	sort.Slice(result, func(i, j int) bool {
+		if result[i].score != result[j].score {
+			return result[i].score > result[j].score
+		}
+		return result[i].name < result[j].name
+	})
+	return result
+}
+
+// scoreSymbolName 对符号名打分：精确 > 前缀 > 单词开头的子串 > 子串 > 模糊，同类中名字越短越靠前。
+// overlap 为命中的查询 trigram 比例
+func scoreSymbolName(name, lower, query, lowerQuery string, overlap float64) (SymbolMatchKind, float64, bool) {
+	var kind SymbolMatchKind
+	var score float64
+	switch {
+	case name == query:
+		kind, score = SymbolMatchExact, 1000
+	case lower == lowerQuery:
+		kind, score = SymbolMatchExact, 950
+	case strings.HasPrefix(name, query):
+		kind, score = SymbolMatchPrefix, 800
+	case strings.HasPrefix(lower, lowerQuery):
+		kind, score = SymbolMatchPrefix, 750
+	default:
+		if i := strings.Index(lower, lowerQuery); i >= 0 {
+			kind, score = SymbolMatchSubstring, 500
+			if isWordStart(name, i) {
+				// VecAdd 中的 Add、vec_add 中的 add
+				score = 650
+			}
+		} else if overlap > 0 && len(lowerQuery) >= 3 {
+			kind, score = SymbolMatchFuzzy, 100+300*overlap
+		} else {
+			return "", 0, false
+		}
+	}
+	return kind, score - min(float64(len(name)-len(query)), 40)*0.5, true
+}
+
+// isWordStart name[i] 是否为驼峰或下划线分隔的单词开头
+func isWordStart(name string, i int) bool {
+	if i == 0 {
+		return true
+	}
+	prev, cur := rune(name[i-1]), rune(name[i])
+	return !unicode.IsLetter(prev) && !unicode.IsDigit(prev) || unicode.IsLower(prev) && unicode.IsUpper(cur)
+}
+
+// eachTrigram 遍历字符串中不重复的三字节组合
+func eachTrigram(s string, fn func(uint32)) {
+	if len(s) < 3 {
+		return
+	}
+	var seen map[uint32]struct{}
+	for i := 0; i+3 <= len(s); i++ {
+		t := uint32(s[i])<<16 | uint32(s[i+1])<<8 | uint32(s[i+2])
+		if i > 0 {
+			if seen == nil {
+				seen = make(map[uint32]struct{}, len(s))
+			}
+			if _, ok := seen[t]; ok {
+				continue
+			}
+		}
+		if seen != nil {
+			seen[t] = struct{}{}
+		} else {
+			seen = map[uint32]struct{}{t: {}}
+		}
+		fn(t)
+	}
+}
+
+// loadedSymbolIndex 已创建的符号名索引，没有时返回 nil。写入只需要更新已创建的索引
+func (s *LevelDBStorage) loadedSymbolIndex(projectUuid string) *symbolNameIndex {
+	if x, ok := s.symbolIndexes.Load(projectUuid); ok {
+		return x.(*symbolNameIndex)
+	}
+	return nil
+}
+
+// addSymbolNames 写入成功后把符号表和非空增量的键加入符号名索引
+func (s *LevelDBStorage) addSymbolNames(x *symbolNameIndex, keys []string) {
+	if x == nil || len(keys) == 0 {
+		return
+	}
+	x.mu.Lock()
+	defer x.mu.Unlock()
+	for _, key := range keys {
+		if k, ok := symbolKeyEntry(key); ok {
+			x.add(k)
+		}
+	}
+}
+
+// dropSymbolIndex 丢弃项目的符号名索引，下次搜索时重新加载
+func (s *LevelDBStorage) dropSymbolIndex(projectUuid string) {
+	s.symbolIndexes.Delete(projectUuid)
+}
+
+// symbolIndex 获取项目的符号名索引，首次使用时加载。索引先注册再遍历，
+// 遍历期间的写入同时进入索引，不会遗漏
+func (s *LevelDBStorage) symbolIndex(ctx context.Context, projectUuid string, db *leveldb.DB) (*symbolNameIndex, error) {
+	x := newSymbolNameIndex()
+	actual, loaded := s.symbolIndexes.LoadOrStore(projectUuid, x)
+	if loaded {
+		x = actual.(*symbolNameIndex)
+		select {
+		case <-x.ready:
+		case <-ctx.Done():
+			return nil, ctx.Err()
+		}
+		if x.loadErr != nil {
+			return nil, x.loadErr
+		}
+		return x, nil
+	}
+
+	err := s.loadSymbolIndex(ctx, s.reader(projectUuid, db), x)
+	if err != nil {
+		x.loadErr = fmt.Errorf("failed to load symbol name index: %w", err)
+		s.symbolIndexes.CompareAndDelete(projectUuid, x)
+	}
+	close(x.ready)
+	return x, x.loadErr
+}
+
+// loadSymbolIndex 遍历符号表和符号增量的键，只读键不读值
+func (s *LevelDBStorage) loadSymbolIndex(ctx context.Context, reader leveldbReader, x *symbolNameIndex) error {
+	for _, prefix := range []string{SymKeySystemPrefix, SymbolPostingKeySystemPrefix} {
+		iter := reader.NewIterator(util.BytesPrefix([]byte(prefix)), nil)
+		n := 0
+		var batch []symbolEntryKey
+		flush := func() {
+			x.mu.Lock()
+			for _, k := range batch {
+				x.add(k)
+			}
+			x.mu.Unlock()
+			batch = batch[:0]
+		}
+		for iter.Next() {
+			if n++; n%1000 == 0 {
+				if err := utils.CheckContext(ctx); err != nil {
+					iter.Release()
+					return err
+				}
+				flush()
+			}
+			k, ok := symbolKeyEntry(string(iter.Key()))
+			if ok {
+				batch = append(batch, k)
+			}
+		}
+		flush()
+		err := iter.Error()
+		iter.Release()
+		if err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// SearchSymbolNames 按前缀、子串或模糊匹配搜索符号名，返回确认存在的符号及其出现位置
+func (s *LevelDBStorage) SearchSymbolNames(ctx context.Context, projectUuid string,
+	opts SymbolSearchOptions) ([]*SymbolNameMatch, error) {
+	if err := utils.CheckContext(ctx); err != nil {
+		return nil, fmt.Errorf("context cancelled: %w", err)
+	}
+	if strings.TrimSpace(opts.Query) == "" {
+		return nil, nil
+	}
+	limit := opts.Limit
+	if limit <= 0 {
+		limit = DefaultSymbolSearchLimit
+	}
+	limit = min(limit, MaxSymbolSearchLimit)
+	var languageId byte
+	if opts.Language != "" {
+		id, err := encodeLanguage(opts.Language)
+		if err != nil {
+			return nil, err
+		}
+		languageId = id
+	}
+
+	db, release, err := s.getDB(projectUuid)
+	if err != nil {
+		return nil, fmt.Errorf("failed to get database: %w", err)
+	}
+	defer release()
+	x, err := s.symbolIndex(ctx, projectUuid, db)
+	if err != nil {
+		return nil, err
+	}
+
+	x.mu.Lock()
+	x.mergeSorted()
+	since := x.seq
+	x.mu.Unlock()
+	x.mu.RLock()
+	candidates := x.candidates(strings.TrimSpace(opts.Query), languageId)
+	x.mu.RUnlock()
+
+	// 按分数顺序读取符号表确认，同时得到出现位置
+	snapshot, err := db.GetSnapshot()
+	if err != nil {
+		return nil, fmt.Errorf("failed to get snapshot: %w", err)
+	}
+	defer snapshot.Release()
+	reader := s.reader(projectUuid, snapshot)
+	var matches []*SymbolNameMatch
+	var missing []symbolEntryKey
+	for i, c := range candidates {
+		if len(matches) >= limit {
+			break
+		}
+		if i%100 == 0 {
+			if err = utils.CheckContext(ctx); err != nil {
+				return nil, fmt.Errorf("context cancelled: %w", err)
+			}
+		}
+		symbolKey := SymKeySystemPrefix + string([]byte{c.languageId}) + c.name
+		value, err := s.readSymbol(reader, db, projectUuid, symbolKey)
+		if errors.Is(err, leveldb.ErrNotFound) {
+			missing = append(missing, c.symbolEntryKey)
+			continue
+		}
+		if err != nil {
+			return nil, fmt.Errorf("failed to read symbol %s: %w", c.name, err)
+		}
+		var symbol codegraphpb.SymbolOccurrence
+		if err = proto.Unmarshal(value, &symbol); err != nil {
+			return nil, fmt.Errorf("failed to unmarshal symbol %s: %w", c.name, err)
+		}
+		if err = s.ResolveFilePaths(ctx, projectUuid, symbol.Occurrences); err != nil {
+			return nil, err
+		}
+		language, _ := decodeLanguage(c.languageId)
+		matches = append(matches, &SymbolNameMatch{
+			Name:        c.name,
+			Language:    language,
+			Kind:        c.kind,
+			Score:       c.score,
+			Occurrences: symbol.Occurrences,
+		})
+	}
+
+	if len(missing) > 0 {
+		x.mu.Lock()
+		for _, k := range missing {
+			x.remove(k, since)
+		}
+		x.mu.Unlock()
+	}
+	return matches, nil
+}
@@ -1,5 +1,7 @@
 package types
 
+import "time"
+
 type NodeType string
 
 const ( //
@@ -12,6 +14,7 @@ const ( //
 type FileWithModTimestamp struct {
 	Path    string
 	ModTime int64
+	Size    int64 // 收集文件时的大小，用于估算读取的字节数
 }
 
 type IndexTaskMetrics struct {
@@ -62,7 +65,27 @@ type QueryCallGraphOptions struct {
 	LineRange  string
 	SymbolName string
 	MaxLayer   int
+	MaxNodes   int           // 最多展开的调用者节点数，0 使用默认值
+	Timeout    time.Duration // 展开调用图的耗时上限，超时返回已构建的部分，0 使用默认值
+}
+
+// SearchSymbolOptions 按符号名前缀、子串或模糊匹配搜索符号
+type SearchSymbolOptions struct {
+	Workspace string
+	Query     string
+	Language  string // 为空时搜索全部语言
+	Limit     int    // 0 使用默认值
+}
+
+// SymbolSearchResult 符号名搜索结果，按 Score 从高到低排列
+type SymbolSearchResult struct {
+	SymbolName  string
+	Language    string
+	MatchType   string // exact、prefix、substring、fuzzy
+	Score       float64
+	Definitions []*Definition
 }
+
 type RelationNode struct {
 	FilePath   string          `json:"filePath,omitempty"`
 	SymbolName string          `json:"symbolName,omitempty"`
@@ -0,0 +1,59 @@
+package utils
+
+import "context"
+
+// StringInterner 字符串驻留，相同内容只保留一份，用于类型名、路径等大量重复的短字符串。
+// 非并发安全，按批次或文件使用；nil 表示不驻留
+type StringInterner struct {
+	strs map[string]string
+}
+
+func NewStringInterner() *StringInterner {
+	return &StringInterner{strs: make(map[string]string)}
+}
+
+// Intern 返回与 s 内容相同的驻留字符串
+func (in *StringInterner) Intern(s string) string {
+	if in == nil {
+		return s
+	}
+	if interned, ok := in.strs[s]; ok {
+		return interned
+	}
+	in.strs[s] = s
+	return s
+}
+
+// InternBytes 返回与 b 内容相同的驻留字符串，命中时不分配内存
+func (in *StringInterner) InternBytes(b []byte) string {
+	if in == nil {
+		return string(b)
+	}
+	if interned, ok := in.strs[string(b)]; ok {
+		return interned
+	}
+	s := string(b)
+	in.strs[s] = s
+	return s
+}
+
+// Len 驻留的字符串数量
+func (in *StringInterner) Len() int {
+	if in == nil {
+		return 0
+	}
+	return len(in.strs)
+}
+
+type stringInternerKey struct{}
+
+// WithStringInterner 把驻留表放入上下文，同一上下文下解析的文件共享驻留表
+func WithStringInterner(ctx context.Context, in *StringInterner) context.Context {
+	return context.WithValue(ctx, stringInternerKey{}, in)
+}
+
+// StringInternerFromContext 取出上下文中的驻留表，没有时返回 nil
+func StringInternerFromContext(ctx context.Context) *StringInterner {
+	in, _ := ctx.Value(stringInternerKey{}).(*StringInterner)
+	return in
+}
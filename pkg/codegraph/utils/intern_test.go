@@ -0,0 +1,37 @@
+package utils
+
+import (
+	"context"
+	"testing"
+	"unsafe"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func TestStringInterner(t *testing.T) {
+	in := NewStringInterner()
+	content := []byte("std::string std::string")
+
+	a := in.InternBytes(content[:11])
+	b := in.InternBytes(content[12:])
+	assert.Equal(t, "std::string", a)
+	// 相同内容复用同一份数据
+	assert.Equal(t, unsafe.StringData(a), unsafe.StringData(b))
+	assert.Equal(t, unsafe.StringData(a), unsafe.StringData(in.Intern(string(content[12:]))))
+	assert.Equal(t, 1, in.Len())
+
+	// 驻留的字符串不受源字节修改影响
+	content[0] = 'x'
+	assert.Equal(t, "std::string", a)
+
+	var nilInterner *StringInterner
+	assert.Equal(t, "int", nilInterner.InternBytes([]byte("int")))
+	assert.Equal(t, "int", nilInterner.Intern("int"))
+	assert.Equal(t, 0, nilInterner.Len())
+}
+
+func TestStringInternerFromContext(t *testing.T) {
+	assert.Nil(t, StringInternerFromContext(context.Background()))
+	in := NewStringInterner()
+	assert.Same(t, in, StringInternerFromContext(WithStringInterner(context.Background(), in)))
+}
@@ -0,0 +1,205 @@
+package utils
+
+import (
+	"context"
+	"errors"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+const maxWalkWorkers = 32
+
+// WalkEntry ParallelWalk 访问到的目录项
+type WalkEntry struct {
+	Path    string // 绝对路径
+	RelPath string // 相对遍历根目录的路径
+	Entry   fs.DirEntry
+}
+
+// ParallelWalkOptions 并行遍历参数，回调会被多个 goroutine 同时调用，需自行保证并发安全
+type ParallelWalkOptions struct {
+	Workers int // 并发读取目录的 goroutine 数，默认 2*GOMAXPROCS，最多 32
+	// VisitDir 访问子目录，根目录不回调。返回 filepath.SkipDir 跳过该目录，其余返回值同 VisitFile
+	VisitDir func(entry WalkEntry) error
+	// VisitFile 访问非目录项，返回 filepath.SkipAll 停止遍历，其他错误终止遍历并返回该错误
+	VisitFile func(entry WalkEntry) error
+	// OnError 读取目录失败时回调，返回 nil 继续遍历其他目录，为空时忽略错误。根目录读取失败总是返回错误
+	OnError func(path string, err error) error
+}
+
+type walkDir struct {
+	path    string
+	relPath string
+}
+
+// walkQueue 每个 worker 一个目录栈，worker 优先后进先出处理自己发现的子目录，
+// 自己的栈为空时从其他 worker 的栈底窃取，栈底的目录通常层级更浅、子树更大
+type walkQueue struct {
+	mu      sync.Mutex
+	cond    *sync.Cond
+	stacks  [][]walkDir
+	pending int // 已入栈但尚未处理完的目录数，为 0 时遍历结束
+	stopped bool
+	halted  atomic.Bool // 与 stopped 同步设置，访问目录项时无锁检查
+	err     error
+}
+
+func (q *walkQueue) push(worker int, dir walkDir) {
+	q.mu.Lock()
+	q.stacks[worker] = append(q.stacks[worker], dir)
+	q.pending++
+	q.mu.Unlock()
+	q.cond.Signal()
+}
+
+func (q *walkQueue) pop(worker int) (walkDir, bool) {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+	for {
+		if q.stopped {
+			return walkDir{}, false
+		}
+		if n := len(q.stacks[worker]); n > 0 {
+			dir := q.stacks[worker][n-1]
+			q.stacks[worker] = q.stacks[worker][:n-1]
+			return dir, true
+		}
+		for k := 1; k < len(q.stacks); k++ {
+			victim := (worker + k) % len(q.stacks)
+			if len(q.stacks[victim]) > 0 {
+				dir := q.stacks[victim][0]
+				q.stacks[victim] = q.stacks[victim][1:]
+				return dir, true
+			}
+		}
+		if q.pending == 0 {
+			q.stopped = true
+			q.cond.Broadcast()
+			return walkDir{}, false
+		}
+		q.cond.Wait()
+	}
+}
+
+func (q *walkQueue) done() {
+	q.mu.Lock()
+	q.pending--
+	finished := q.pending == 0
+	q.mu.Unlock()
+	if finished {
+		q.cond.Broadcast()
+	}
+}
+
+// stop 终止遍历，只记录第一个错误
+func (q *walkQueue) stop(err error) {
+	q.mu.Lock()
+	if !q.stopped && err != nil {
+		q.err = err
+	}
+	q.stopped = true
+	q.halted.Store(true)
+	q.mu.Unlock()
+	q.cond.Broadcast()
+}
+
+// ParallelWalk 并行遍历目录树，多个 goroutine 同时读取不同目录。不跟随符号链接，访问顺序不确定
+func ParallelWalk(ctx context.Context, root string, opts ParallelWalkOptions) error {
+	root = filepath.Clean(root)
+	entries, err := readDirEntries(root)
+	if err != nil {
+		return err
+	}
+	workers := opts.Workers
+	if workers <= 0 {
+		workers = min(2*runtime.GOMAXPROCS(0), maxWalkWorkers)
+	}
+	q := &walkQueue{stacks: make([][]walkDir, workers), pending: 1}
+	q.cond = sync.NewCond(&q.mu)
+	stopWatch := context.AfterFunc(ctx, func() { q.stop(ctx.Err()) })
+	defer stopWatch()
+
+	// 根目录已读取，先分发其子项
+	visitEntries(ctx, q, &opts, 0, walkDir{path: root}, entries)
+	q.done()
+
+	var wg sync.WaitGroup
+	for i := 0; i < workers; i++ {
+		wg.Add(1)
+		go func(worker int) {
+			defer wg.Done()
+			for {
+				dir, ok := q.pop(worker)
+				if !ok {
+					return
+				}
+				entries, err := readDirEntries(dir.path)
+				if err != nil {
+					if opts.OnError != nil {
+						if err = opts.OnError(dir.path, err); err != nil {
+							q.stop(err)
+						}
+					}
+				} else {
+					visitEntries(ctx, q, &opts, worker, dir, entries)
+				}
+				q.done()
+			}
+		}(i)
+	}
+	wg.Wait()
+	return q.err
+}
+
+func visitEntries(ctx context.Context, q *walkQueue, opts *ParallelWalkOptions, worker int, dir walkDir,
+	entries []fs.DirEntry) {
+	for _, entry := range entries {
+		if q.halted.Load() {
+			return
+		}
+		name := entry.Name()
+		walkEntry := WalkEntry{Path: dir.path + string(filepath.Separator) + name, RelPath: name, Entry: entry}
+		if dir.relPath != "" {
+			walkEntry.RelPath = dir.relPath + string(filepath.Separator) + name
+		}
+		var err error
+		if entry.IsDir() {
+			if opts.VisitDir != nil {
+				err = opts.VisitDir(walkEntry)
+			}
+			if err == nil {
+				q.push(worker, walkDir{path: walkEntry.Path, relPath: walkEntry.RelPath})
+				continue
+			}
+			if errors.Is(err, filepath.SkipDir) {
+				continue
+			}
+		} else if opts.VisitFile != nil {
+			err = opts.VisitFile(walkEntry)
+		}
+		if err != nil {
+			if errors.Is(err, filepath.SkipAll) {
+				err = nil
+			}
+			q.stop(err)
+			return
+		}
+	}
+	if err := ctx.Err(); err != nil {
+		q.stop(err)
+	}
+}
+
+// readDirEntries 读取目录项，不排序
+func readDirEntries(path string) ([]fs.DirEntry, error) {
+	dir, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer dir.Close()
+	return dir.ReadDir(-1)
+}
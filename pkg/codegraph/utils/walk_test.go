@@ -0,0 +1,92 @@
+package utils
+
+import (
+	"context"
+	"errors"
+	"os"
+	"path/filepath"
+	"sort"
+	"sync"
+	"sync/atomic"
+	"testing"
+)
+
+func TestParallelWalk(t *testing.T) {
+	root := t.TempDir()
+	var expected []string
+	for _, dir := range []string{"a", filepath.Join("a", "b"), filepath.Join("a", "b", "c"), "d", "skip"} {
+		if err := os.MkdirAll(filepath.Join(root, dir), 0755); err != nil {
+			t.Fatal(err)
+		}
+		for _, name := range []string{"1.go", "2.go"} {
+			relPath := filepath.Join(dir, name)
+			if err := os.WriteFile(filepath.Join(root, relPath), []byte("x"), 0644); err != nil {
+				t.Fatal(err)
+			}
+			if dir != "skip" {
+				expected = append(expected, relPath)
+			}
+		}
+	}
+	if err := os.WriteFile(filepath.Join(root, "root.go"), []byte("x"), 0644); err != nil {
+		t.Fatal(err)
+	}
+	expected = append(expected, "root.go")
+	sort.Strings(expected)
+
+	var mu sync.Mutex
+	var visited []string
+	err := ParallelWalk(context.Background(), root, ParallelWalkOptions{
+		Workers: 4,
+		VisitDir: func(entry WalkEntry) error {
+			if entry.RelPath == "skip" {
+				return filepath.SkipDir
+			}
+			return nil
+		},
+		VisitFile: func(entry WalkEntry) error {
+			if entry.Path != filepath.Join(root, entry.RelPath) {
+				t.Errorf("unexpected path %s for %s", entry.Path, entry.RelPath)
+			}
+			mu.Lock()
+			visited = append(visited, entry.RelPath)
+			mu.Unlock()
+			return nil
+		},
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+	sort.Strings(visited)
+	if len(visited) != len(expected) {
+		t.Fatalf("visited %v, expected %v", visited, expected)
+	}
+	for i := range expected {
+		if visited[i] != expected[i] {
+			t.Fatalf("visited %v, expected %v", visited, expected)
+		}
+	}
+
+	// SkipAll 提前结束且不返回错误，其他错误原样返回
+	var count atomic.Int32
+	err = ParallelWalk(context.Background(), root, ParallelWalkOptions{
+		VisitFile: func(entry WalkEntry) error {
+			count.Add(1)
+			return filepath.SkipAll
+		},
+	})
+	if err != nil || count.Load() == 0 {
+		t.Fatalf("SkipAll: err %v, visited %d", err, count.Load())
+	}
+	errStop := errors.New("stop")
+	err = ParallelWalk(context.Background(), root, ParallelWalkOptions{
+		VisitFile: func(entry WalkEntry) error { return errStop },
+	})
+	if !errors.Is(err, errStop) {
+		t.Fatalf("expected stop error, got %v", err)
+	}
+
+	if err = ParallelWalk(context.Background(), filepath.Join(root, "missing"), ParallelWalkOptions{}); err == nil {
+		t.Fatal("expected error for missing root")
+	}
+}
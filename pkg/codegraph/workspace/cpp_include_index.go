@@ -0,0 +1,393 @@
+package workspace
+
+import (
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/logger"
+	"context"
+	"encoding/json"
+	"fmt"
+	"math"
+	"os"
+	"path/filepath"
+	"slices"
+	"strings"
+	"sync"
+	"time"
+)
+
+const compileCommandsFile = "compile_commands.json"
+
+// 查找编译数据库的目录，相对项目根目录，按顺序取第一个存在的
+var compileCommandsDirs = []string{"", "build", "out", "cmake-build-debug", "cmake-build-release"}
+
+var cppHeaderExts = map[string]struct{}{
+	".h": {}, ".hh": {}, ".hpp": {}, ".hxx": {}, ".h++": {}, ".inl": {}, ".inc": {}, ".ipp": {}, ".tpp": {},
+}
+
+// 两次检查索引是否失效的最小间隔，避免每个文件都 stat 一遍目录
+const cppIncludeIndexCheckInterval = 2 * time.Second
+
+// CppIncludeIndex 项目内 C/C++ 头文件索引，把 #include 解析为具体的头文件路径。
+// include 目录来自 compile_commands.json，源文件不在编译数据库中时按路径后缀匹配项目内的头文件
+type CppIncludeIndex struct {
+	root        string
+	compileDB   string              // 使用的编译数据库路径，为空表示没有
+	compileMod  int64               // 编译数据库的修改时间
+	includeDirs []string            // 所有编译命令中项目内的 include 目录，按首次出现排序
+	fileDirs    map[string][]string // 源文件 -> 其编译命令中的 include 目录
+	headers     map[string]struct{} // 项目内全部头文件
+	byName      map[string][]string // 头文件名 -> 路径
+	dirMods     map[string]int64    // 遍历到的目录及其修改时间，目录内增删文件后失效
+	checkedAt   time.Time
+}
+
+// Resolve 解析 fromFile 中的 #include，返回项目内对应的头文件；不是 #include 或找不到项目内的头文件时返回空
+func (idx *CppIncludeIndex) Resolve(fromFile, include string) []string {
+	name := strings.TrimSpace(include)
+	if len(name) < 2 || (name[0] != '"' && name[0] != '<') {
+		return nil
+	}
+	quoted := name[0] == '"'
+	name = strings.Trim(name, "\"<>")
+	if name == "" {
+		return nil
+	}
+	rel := filepath.Clean(filepath.FromSlash(name))
+	fromFile = filepath.Clean(fromFile)
+
+	// 引号形式先找当前文件所在目录
+	if quoted {
+		if path, ok := idx.lookup(filepath.Dir(fromFile), rel); ok {
+			return []string{path}
+		}
+	}
+	dirs, inCompileDB := idx.fileDirs[fromFile]
+	if !inCompileDB {
+		dirs = idx.includeDirs
+	}
+	for _, dir := range dirs {
+		if path, ok := idx.lookup(dir, rel); ok {
+			return []string{path}
+		}
+	}
+	if path, ok := idx.lookup(idx.root, rel); ok {
+		return []string{path}
+	}
+	// 编译数据库中的源文件按其 include 目录未命中时，说明头文件不在项目内
+	if inCompileDB {
+		return nil
+	}
+	var matched []string
+	suffix := string(filepath.Separator) + rel
+	for _, path := range idx.byName[filepath.Base(rel)] {
+		if strings.HasSuffix(path, suffix) {
+			matched = append(matched, path)
+		}
+	}
+	return matched
+}
+
+func (idx *CppIncludeIndex) lookup(dir, rel string) (string, bool) {
+	path := filepath.Join(dir, rel)
+	_, ok := idx.headers[path]
+	return path, ok
+}
+
+// stale 编译数据库或任一目录的修改时间变化后索引失效
+func (idx *CppIncludeIndex) stale() bool {
+	compileDB, compileMod := findCompileDB(idx.root)
+	if compileDB != idx.compileDB || compileMod != idx.compileMod {
+		return true
+	}
+	for dir, mod := range idx.dirMods {
+		info, err := os.Stat(dir)
+		if err != nil || info.ModTime().UnixNano() != mod {
+			return true
+		}
+	}
+	return false
+}
+
+// CppIncludeIndexCache 按项目缓存头文件索引。每个项目单独加锁，锁内只读写缓存的状态，
+// 失效检查和重建在锁外进行，同一项目同时只有一个调用在检查或重建，期间其他调用使用已有的索引
+type CppIncludeIndexCache struct {
+	logger   logger.Logger
+	reader   WorkspaceReader
+	skipFunc func(projectPath string) types.SkipFunc // 遍历头文件时的忽略规则，为空时只排除默认目录
+	entries  sync.Map                                // projectPath -> *cppIncludeIndexEntry
+}
+
+type cppIncludeIndexEntry struct {
+	mu         sync.Mutex
+	index      *CppIncludeIndex
+	refreshing bool          // 正在检查失效或重建
+	done       chan struct{} // 本轮检查或重建结束时关闭
+}
+
+func NewCppIncludeIndexCache(logger logger.Logger, reader WorkspaceReader) *CppIncludeIndexCache {
+	return &CppIncludeIndexCache{logger: logger, reader: reader}
+}
+
+// SetSkipFunc 设置遍历项目头文件时的忽略规则，与索引收集源码文件使用相同的规则。在使用缓存前调用
+func (c *CppIncludeIndexCache) SetSkipFunc(skipFunc func(projectPath string) types.SkipFunc) {
+	c.skipFunc = skipFunc
+}
+
+// Get 获取项目的头文件索引，不存在或已失效时重建
+func (c *CppIncludeIndexCache) Get(ctx context.Context, projectPath string) (*CppIncludeIndex, error) {
+	projectPath = filepath.Clean(projectPath)
+	value, _ := c.entries.LoadOrStore(projectPath, &cppIncludeIndexEntry{})
+	e := value.(*cppIncludeIndexEntry)
+	for {
+		e.mu.Lock()
+		index := e.index
+		if index != nil && (e.refreshing || time.Since(index.checkedAt) < cppIncludeIndexCheckInterval) {
+			e.mu.Unlock()
+			return index, nil
+		}
+		if e.refreshing {
+			// 首次构建中，等待结果
+			done := e.done
+			e.mu.Unlock()
+			select {
+			case <-done:
+				continue
+			case <-ctx.Done():
+				return nil, ctx.Err()
+			}
+		}
+		e.refreshing = true
+		e.done = make(chan struct{})
+		e.mu.Unlock()
+		return c.refresh(ctx, projectPath, e, index)
+	}
+}
+
+// refresh 在锁外检查索引是否失效，失效或不存在时重建。构建失败时保留原索引，下次访问重试
+func (c *CppIncludeIndexCache) refresh(ctx context.Context, projectPath string, e *cppIncludeIndexEntry,
+	index *CppIncludeIndex) (*CppIncludeIndex, error) {
+	var err error
+	if index == nil || index.stale() {
+		start := time.Now()
+		var built *CppIncludeIndex
+		if built, err = c.build(ctx, projectPath); err == nil {
+			index = built
+			c.logger.Info("build c/cpp include index for %s, headers: %d, compile db: %s, cost %d ms",
+				projectPath, len(index.headers), index.compileDB, time.Since(start).Milliseconds())
+		}
+	}
+	e.mu.Lock()
+	if err == nil {
+		index.checkedAt = time.Now()
+		e.index = index
+	}
+	e.refreshing = false
+	close(e.done)
+	e.mu.Unlock()
+	if err != nil {
+		return nil, err
+	}
+	return index, nil
+}
+
+func (c *CppIncludeIndexCache) build(ctx context.Context, root string) (*CppIncludeIndex, error) {
+	var skip types.SkipFunc
+	if c.skipFunc != nil {
+		skip = c.skipFunc(root)
+	}
+	return buildCppIncludeIndex(ctx, c.reader, root, skip)
+}
+
+// buildCppIncludeIndex 遍历项目内的头文件，构建索引。skip 为项目的忽略规则，可以为空
+func buildCppIncludeIndex(ctx context.Context, reader WorkspaceReader, root string,
+	skip types.SkipFunc) (*CppIncludeIndex, error) {
+	info, err := os.Stat(root)
+	if err != nil {
+		return nil, err
+	}
+	idx := &CppIncludeIndex{
+		root:     root,
+		fileDirs: make(map[string][]string),
+		headers:  make(map[string]struct{}),
+		byName:   make(map[string][]string),
+		dirMods:  map[string]int64{root: info.ModTime().UnixNano()},
+	}
+
+	// 目录在过滤时记录修改时间，忽略的目录不记录，其中的变化不使索引失效
+	var mu sync.Mutex
+	excludeDirs := DefaultVisitPattern.ExcludeDirs
+	visitPattern := &types.VisitPattern{
+		MaxVisitLimit: math.MaxInt,
+		SkipFunc: func(fileInfo *types.FileInfo) (bool, error) {
+			if fileInfo.IsDir && slices.Contains(excludeDirs, fileInfo.Name) {
+				return true, nil
+			}
+			if skip != nil {
+				if skipped, err := skip(fileInfo); skipped {
+					return true, err
+				}
+			}
+			if fileInfo.IsDir {
+				mu.Lock()
+				idx.dirMods[fileInfo.Path] = fileInfo.ModTime.UnixNano()
+				mu.Unlock()
+			}
+			return false, nil
+		},
+	}
+	err = reader.WalkFile(ctx, root, func(walkCtx *types.WalkContext) error {
+		if _, ok := cppHeaderExts[strings.ToLower(filepath.Ext(walkCtx.Path))]; !ok {
+			return nil
+		}
+		idx.headers[walkCtx.Path] = struct{}{}
+		name := filepath.Base(walkCtx.Path)
+		idx.byName[name] = append(idx.byName[name], walkCtx.Path)
+		return nil
+	}, types.WalkOptions{IgnoreError: true, VisitPattern: visitPattern})
+	if err != nil {
+		return nil, fmt.Errorf("walk %s for c/cpp headers err: %w", root, err)
+	}
+
+	idx.compileDB, idx.compileMod = findCompileDB(root)
+	if idx.compileDB != "" {
+		if err = idx.loadCompileDB(); err != nil {
+			return nil, err
+		}
+	}
+	idx.checkedAt = time.Now()
+	return idx, nil
+}
+
+// findCompileDB 返回项目使用的编译数据库路径和修改时间
+func findCompileDB(root string) (string, int64) {
+	for _, dir := range compileCommandsDirs {
+		path := filepath.Join(root, dir, compileCommandsFile)
+		if info, err := os.Stat(path); err == nil && !info.IsDir() {
+			return path, info.ModTime().UnixNano()
+		}
+	}
+	return "", 0
+}
+
+type compileCommand struct {
+	Directory string   `json:"directory"`
+	File      string   `json:"file"`
+	Command   string   `json:"command"`
+	Arguments []string `json:"arguments"`
+}
+
+// loadCompileDB 逐条解码编译数据库，只保留项目内的 include 目录
+func (idx *CppIncludeIndex) loadCompileDB() error {
+	f, err := os.Open(idx.compileDB)
+	if err != nil {
+		return err
+	}
+	defer f.Close()
+
+	decoder := json.NewDecoder(f)
+	if _, err = decoder.Token(); err != nil {
+		return fmt.Errorf("parse %s err: %w", idx.compileDB, err)
+	}
+	seen := make(map[string]struct{})
+	for decoder.More() {
+		var cmd compileCommand
+		if err = decoder.Decode(&cmd); err != nil {
+			return fmt.Errorf("parse %s err: %w", idx.compileDB, err)
+		}
+		args := cmd.Arguments
+		if len(args) == 0 {
+			args = splitCommandLine(cmd.Command)
+		}
+		directory := cmd.Directory
+		if !filepath.IsAbs(directory) {
+			directory = filepath.Join(idx.root, directory)
+		}
+		file := cmd.File
+		if !filepath.IsAbs(file) {
+			file = filepath.Join(directory, file)
+		}
+		var dirs []string
+		for _, dir := range includeDirsFromArgs(args) {
+			if !filepath.IsAbs(dir) {
+				dir = filepath.Join(directory, dir)
+			}
+			dir = filepath.Clean(dir)
+			if dir != idx.root && !strings.HasPrefix(dir, idx.root+string(filepath.Separator)) {
+				continue
+			}
+			dirs = append(dirs, dir)
+			if _, ok := seen[dir]; !ok {
+				seen[dir] = struct{}{}
+				idx.includeDirs = append(idx.includeDirs, dir)
+			}
+		}
+		idx.fileDirs[filepath.Clean(file)] = dirs
+	}
+	return nil
+}
+
+// includeDirsFromArgs 提取编译参数中的 include 目录，支持 -I dir、-Idir、-iquote、-isystem、-idirafter 和 MSVC 的 /I dir
+func includeDirsFromArgs(args []string) []string {
+	var dirs []string
+	for i := 0; i < len(args); i++ {
+		arg := args[i]
+		// MSVC 的 /I 只支持分开写，避免把 /Include/... 之类的路径当成参数
+		if arg == "/I" && i+1 < len(args) {
+			i++
+			dirs = append(dirs, args[i])
+			continue
+		}
+		for _, flag := range []string{"-iquote", "-isystem", "-idirafter", "-I"} {
+			if !strings.HasPrefix(arg, flag) {
+				continue
+			}
+			if dir := strings.TrimPrefix(arg, flag); dir != "" {
+				dirs = append(dirs, dir)
+			} else if i+1 < len(args) {
+				i++
+				dirs = append(dirs, args[i])
+			}
+			break
+		}
+	}
+	return dirs
+}
+
+// splitCommandLine 拆分编译命令，处理引号。反斜杠只在双引号内、位于 " 或 \ 之前时作为转义，
+// 其余情况按原样保留，不破坏 Windows 路径。compile_commands.json 有 arguments 时优先使用 arguments
+func splitCommandLine(command string) []string {
+	var args []string
+	var current strings.Builder
+	inArg := false
+	var quote byte
+	for i := 0; i < len(command); i++ {
+		c := command[i]
+		switch {
+		case quote == '"' && c == '\\' && i+1 < len(command) && (command[i+1] == '"' || command[i+1] == '\\'):
+			i++
+			current.WriteByte(command[i])
+		case quote != 0:
+			if c == quote {
+				quote = 0
+			} else {
+				current.WriteByte(c)
+			}
+		case c == '"' || c == '\'':
+			quote = c
+			inArg = true
+		case c == ' ' || c == '\t' || c == '\n':
+			if inArg {
+				args = append(args, current.String())
+				current.Reset()
+				inArg = false
+			}
+		default:
+			current.WriteByte(c)
+			inArg = true
+		}
+	}
+	if inArg {
+		args = append(args, current.String())
+	}
+	return args
+}
@@ -0,0 +1,93 @@
+package workspace
+
+import (
+	"codebase-indexer/pkg/codegraph/types"
+	"context"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestCppIncludeIndex(t *testing.T) {
+	root := createTestDir(t, map[string]bool{
+		"include/foo/bar.h":     false,
+		"src/main.cpp":          false,
+		"src/local.h":           false,
+		"third/other/foo/bar.h": false,
+		"tools/tool.cpp":        false,
+	})
+	mainFile := filepath.Join(root, "src", "main.cpp")
+	toolFile := filepath.Join(root, "tools", "tool.cpp")
+	barHeader := filepath.Join(root, "include", "foo", "bar.h")
+	otherBarHeader := filepath.Join(root, "third", "other", "foo", "bar.h")
+
+	t.Run("WithoutCompileDB", func(t *testing.T) {
+		index, err := NewCppIncludeIndexCache(NewMockLogger(), NewWorkSpaceReader(NewMockLogger())).Get(
+			context.Background(), root)
+		require.NoError(t, err)
+
+		assert.Equal(t, []string{filepath.Join(root, "src", "local.h")}, index.Resolve(mainFile, `"local.h"`))
+		// 没有编译数据库时按路径后缀匹配
+		assert.ElementsMatch(t, []string{barHeader, otherBarHeader}, index.Resolve(mainFile, "<foo/bar.h>"))
+		assert.Empty(t, index.Resolve(mainFile, "<vector>"))
+		assert.Empty(t, index.Resolve(mainFile, "std::vector"))
+	})
+
+	t.Run("WithCompileDB", func(t *testing.T) {
+		buildDir := filepath.Join(root, "build")
+		require.NoError(t, os.MkdirAll(buildDir, 0755))
+		compileDB := `[
+			{"directory": "` + buildDir + `", "file": "../src/main.cpp",
+			 "command": "c++ -I../include -isystem /usr/include -o main.o -c ../src/main.cpp"}
+		]`
+		require.NoError(t, os.WriteFile(filepath.Join(buildDir, compileCommandsFile), []byte(compileDB), 0644))
+
+		cache := NewCppIncludeIndexCache(NewMockLogger(), NewWorkSpaceReader(NewMockLogger()))
+		index, err := cache.Get(context.Background(), root)
+		require.NoError(t, err)
+
+		assert.Equal(t, []string{barHeader}, index.Resolve(mainFile, "<foo/bar.h>"))
+		assert.Equal(t, []string{filepath.Join(root, "src", "local.h")}, index.Resolve(mainFile, `"local.h"`))
+		// 编译命令没有覆盖的文件使用所有 include 目录
+		assert.Equal(t, []string{barHeader}, index.Resolve(toolFile, `"foo/bar.h"`))
+
+		// 新增头文件后目录修改时间变化，索引重建
+		newHeader := filepath.Join(root, "include", "foo", "baz.h")
+		require.NoError(t, os.WriteFile(newHeader, nil, 0644))
+		later := time.Now().Add(time.Minute)
+		require.NoError(t, os.Chtimes(filepath.Dir(newHeader), later, later))
+		index.checkedAt = time.Time{}
+		index, err = cache.Get(context.Background(), root)
+		require.NoError(t, err)
+		assert.Equal(t, []string{newHeader}, index.Resolve(mainFile, "<foo/baz.h>"))
+	})
+
+	t.Run("IgnoredDirs", func(t *testing.T) {
+		cache := NewCppIncludeIndexCache(NewMockLogger(), NewWorkSpaceReader(NewMockLogger()))
+		cache.SetSkipFunc(func(projectPath string) types.SkipFunc {
+			return func(fileInfo *types.FileInfo) (bool, error) {
+				return fileInfo.IsDir && fileInfo.Path == filepath.Join(projectPath, "third"), nil
+			}
+		})
+		index, err := cache.Get(context.Background(), root)
+		require.NoError(t, err)
+		// 忽略目录中的头文件不参与匹配，目录的变化也不使索引失效
+		assert.Contains(t, index.headers, barHeader)
+		assert.NotContains(t, index.headers, otherBarHeader)
+		assert.NotContains(t, index.dirMods, filepath.Join(root, "third"))
+	})
+}
+
+func TestSplitCommandLine(t *testing.T) {
+	args := splitCommandLine(`clang++ -I"my dir" -DNAME='a b' -I"inc \"q\"" -c main.cpp`)
+	assert.Equal(t, []string{"clang++", "-Imy dir", "-DNAME=a b", `-Iinc "q"`, "-c", "main.cpp"}, args)
+	// 引号外的反斜杠按原样保留，Windows 路径不被改写
+	assert.Equal(t, []string{"cl.exe", `/IC:\src\inc`, `-IC:\Program Files\sdk\`, `C:\src\main.cpp`},
+		splitCommandLine(`cl.exe /IC:\src\inc "-IC:\Program Files\sdk\\" C:\src\main.cpp`))
+	assert.Equal(t, []string{"my dir", `inc "q"`, "x", "y"},
+		includeDirsFromArgs(append(args, "-iquote", "x", "/I", "y", "/Include/z.cpp")))
+}
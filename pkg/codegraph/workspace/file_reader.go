@@ -0,0 +1,122 @@
+package workspace
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/cache"
+	"io"
+	"os"
+	"sync"
+)
+
+const lineIndexCacheSize = 256
+
+var lineIndexBufPool = sync.Pool{
+	New: func() any {
+		buf := make([]byte, 64*1024)
+		return &buf
+	},
+}
+
+// lineIndex 文件每行起始偏移，最后一个元素为文件大小，按修改时间和大小判断是否失效
+type lineIndex struct {
+	modTime int64
+	size    int64
+	starts  []int64
+}
+
+func (idx *lineIndex) lineCount() int {
+	return len(idx.starts) - 1
+}
+
+// lineIndexCache 缓存最近读取过片段的文件的行索引，避免每次从第一行扫描
+type lineIndexCache struct {
+	entries *cache.LRUCache[*lineIndex]
+}
+
+func newLineIndexCache() *lineIndexCache {
+	return &lineIndexCache{entries: cache.NewLRUCache[*lineIndex](lineIndexCacheSize, lineIndexCacheSize)}
+}
+
+func (c *lineIndexCache) get(path string, file *os.File, info os.FileInfo) (*lineIndex, error) {
+	modTime := info.ModTime().UnixNano()
+	if idx, ok := c.entries.Get(path); ok && idx.modTime == modTime && idx.size == info.Size() {
+		return idx, nil
+	}
+	idx, err := buildLineIndex(file, info.Size())
+	if err != nil {
+		return nil, err
+	}
+	idx.modTime = modTime
+	c.entries.Put(path, idx)
+	return idx, nil
+}
+
+// buildLineIndex 用池化缓冲区顺序扫描换行符
+func buildLineIndex(file *os.File, sizeHint int64) (*lineIndex, error) {
+	bufPtr := lineIndexBufPool.Get().(*[]byte)
+	defer lineIndexBufPool.Put(bufPtr)
+	buf := *bufPtr
+
+	starts := make([]int64, 1, sizeHint/32+2)
+	var offset int64
+	for {
+		n, err := file.ReadAt(buf, offset)
+		chunk := buf[:n]
+		for i := bytes.IndexByte(chunk, '\n'); i >= 0; {
+			starts = append(starts, offset+int64(i)+1)
+			next := bytes.IndexByte(chunk[i+1:], '\n')
+			if next < 0 {
+				break
+			}
+			i += next + 1
+		}
+		offset += int64(n)
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			return nil, err
+		}
+	}
+	// 末尾没有换行时补上最后一行的结束位置
+	if starts[len(starts)-1] != offset {
+		starts = append(starts, offset)
+	}
+	return &lineIndex{size: offset, starts: starts}, nil
+}
+
+// readLines 读取 [startLine, endLine] 行，去掉行尾的 \n 和 \r\n 后以 LF 连接
+func readLines(file *os.File, idx *lineIndex, startLine, endLine int) ([]byte, error) {
+	if startLine > idx.lineCount() {
+		return []byte{}, nil
+	}
+	endLine = min(endLine, idx.lineCount())
+	from, to := idx.starts[startLine-1], idx.starts[endLine]
+	data := make([]byte, to-from)
+	n, err := file.ReadAt(data, from)
+	if err != nil && err != io.EOF {
+		return nil, err
+	}
+	data = data[:n]
+
+	// 原地去掉每行的 \r\n 换行中的 \r
+	out := data[:0]
+	for len(data) > 0 {
+		i := bytes.IndexByte(data, '\n')
+		if i < 0 {
+			out = append(out, data...)
+			break
+		}
+		line := data[:i]
+		if len(line) > 0 && line[len(line)-1] == '\r' {
+			line = line[:len(line)-1]
+		}
+		out = append(out, line...)
+		out = append(out, '\n')
+		data = data[i+1:]
+	}
+	if len(out) > 0 && out[len(out)-1] == '\n' {
+		out = out[:len(out)-1]
+	}
+	return out, nil
+}
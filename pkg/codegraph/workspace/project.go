@@ -81,11 +81,52 @@ func (l SymbolOccurrences) Key(i int) store.Key {
 	return store.SymbolNameKey{Language: lang.Language(l[i].Language), Name: l[i].Name}
 }
 
+// SymbolPosting 符号在单个文件内的全部出现，Symbol 没有出现时表示从该文件删除
+type SymbolPosting struct {
+	FilePath string
+	Symbol   *codegraphpb.SymbolOccurrence
+}
+
+// SymbolPostings 按文件写入的符号表增量，无需读取已有的符号表
+type SymbolPostings []SymbolPosting
+
+func (l SymbolPostings) Len() int { return len(l) }
+func (l SymbolPostings) Value(i int) proto.Message {
+	return l[i].Symbol
+}
+func (l SymbolPostings) Key(i int) store.Key {
+	return store.SymbolPostingKey{Language: lang.Language(l[i].Symbol.Language), Name: l[i].Symbol.Name,
+		FilePath: l[i].FilePath}
+}
+
+// CalleeMapItems 单个调用方文件内对某个被调用符号的调用者列表，同一项中的调用者来自同一文件
 type CalleeMapItems []*codegraphpb.CalleeMapItem
+
 func (l CalleeMapItems) Len() int { return len(l) }
 func (l CalleeMapItems) Value(i int) proto.Message {
 	return l[i]
 }
 func (l CalleeMapItems) Key(i int) store.Key {
-	return store.CalleeMapKey{SymbolName: l[i].CalleeName}
-}
\ No newline at end of file
+	var filePath string
+	if len(l[i].Callers) > 0 {
+		filePath = l[i].Callers[0].FilePath
+	}
+	return store.CalleeMapKey{SymbolName: l[i].CalleeName, FilePath: filePath}
+}
+
+// ResolvedSymbol 引用方文件中一个符号名的解析结果，Symbol 的出现只记录定义所在的文件
+type ResolvedSymbol struct {
+	FilePath string
+	Symbol   *codegraphpb.SymbolOccurrence
+}
+
+// ResolvedSymbols 延迟解析的结果
+type ResolvedSymbols []ResolvedSymbol
+
+func (l ResolvedSymbols) Len() int { return len(l) }
+func (l ResolvedSymbols) Value(i int) proto.Message {
+	return l[i].Symbol
+}
+func (l ResolvedSymbols) Key(i int) store.Key {
+	return store.ResolvedSymbolKey{SymbolName: l[i].Symbol.Name, FilePath: l[i].FilePath}
+}
@@ -1,18 +1,18 @@
 package workspace
 
 import (
-	"bufio"
 	"codebase-indexer/pkg/codegraph/types"
 	"codebase-indexer/pkg/codegraph/utils"
 	"codebase-indexer/pkg/logger"
 	"context"
 	"errors"
 	"fmt"
-	"io"
 	"io/fs"
 	"os"
 	"path/filepath"
+	"sort"
 	"strings"
+	"sync"
 	"time"
 )
 
@@ -45,7 +45,8 @@ type WorkspaceReader interface {
 
 // workspaceReader 工作区读取器实现
 type workspaceReader struct {
-	logger logger.Logger
+	logger      logger.Logger
+	lineIndexes *lineIndexCache
 }
 
 // 确保 workspaceReader 实现了 WorkspaceReader 接口
@@ -53,7 +54,8 @@ var _ WorkspaceReader = (*workspaceReader)(nil)
 
 func NewWorkSpaceReader(logger logger.Logger) WorkspaceReader {
 	return &workspaceReader{
-		logger: logger,
+		logger:      logger,
+		lineIndexes: newLineIndexCache(),
 	}
 }
 
@@ -192,81 +194,55 @@ func (w *workspaceReader) FindProjects(ctx context.Context, workspacePath string
 	return projects
 }
 
-// ReadFile 读取单个文件
+// ReadFile 读取单个文件。未指定行范围时一次读取全部内容并保留原始换行，
+// 否则通过缓存的行索引直接定位到起始行，单次最多读取 ReadFileMaxLine 行
 func (w *workspaceReader) ReadFile(ctx context.Context, path string, option types.ReadOptions) ([]byte, error) {
-
-	exists, err := w.Exists(ctx, path)
-	if err != nil {
-		return nil, err
+	if path == types.EmptyString {
+		return nil, errors.New("path cannot be empty")
 	}
-	if !exists {
-		return nil, ErrPathNotExists
+
+	if option.StartLine <= 1 && option.EndLine <= 0 {
+		data, err := os.ReadFile(path)
+		if os.IsNotExist(err) {
+			return nil, ErrPathNotExists
+		}
+		return data, err
 	}
 
 	// 如果StartLine <= 0，设置为1
 	if option.StartLine <= 0 {
 		option.StartLine = 1
 	}
-	// endLine 设置默认值，且不超过最大值
-	if option.EndLine <= 0 || option.EndLine > ReadFileMaxLine {
-		option.EndLine = ReadFileMaxLine
+	// endLine 设置默认值，且单次读取不超过最大行数
+	maxEndLine := option.StartLine + ReadFileMaxLine - 1
+	if option.EndLine <= 0 || option.EndLine > maxEndLine {
+		option.EndLine = maxEndLine
+	}
+	if option.EndLine < option.StartLine {
+		return []byte{}, nil
 	}
 
-	// 打开文件
 	file, err := os.Open(path)
 	if err != nil {
+		if os.IsNotExist(err) {
+			return nil, ErrPathNotExists
+		}
 		return nil, err
 	}
 	defer file.Close()
 
-	// 创建reader来读取文件
-	reader := bufio.NewReader(file)
-	var lines []string
-	lineNum := 1
-
-	// 读取行
-	for {
-
-		// 如果EndLine > 0 且当前行号大于EndLine，则退出
-		if lineNum > option.EndLine {
-			break
-		}
-
-		// 读取一行，允许超过默认缓冲区大小
-		line, isPrefix, err := reader.ReadLine()
-		if err != nil {
-			if err == io.EOF {
-				break
-			}
-			return nil, err
-		}
-
-		// 处理可能被截断的行
-		var lineBuffer []byte
-		lineBuffer = append(lineBuffer, line...)
-		for isPrefix {
-			line, isPrefix, err = reader.ReadLine()
-			if err != nil {
-				if err == io.EOF {
-					break
-				}
-				return nil, err
-			}
-			lineBuffer = append(lineBuffer, line...)
-		}
-
-		// 转换为字符串
-		lineStr := string(lineBuffer)
-
-		// 如果当前行号大于等于StartLine，则添加到结果中
-		if lineNum >= option.StartLine {
-			lines = append(lines, lineStr)
-		}
-		lineNum++
+	info, err := file.Stat()
+	if err != nil {
+		return nil, err
 	}
-
-	// 将结果转换为字节数组
-	return []byte(strings.Join(lines, types.LF)), nil
+	if info.IsDir() {
+		return nil, fmt.Errorf("%s is a directory", path)
+	}
+	idx, err := w.lineIndexes.get(path, file, info)
+	if err != nil {
+		return nil, err
+	}
+	return readLines(file, idx, option.StartLine, option.EndLine)
 }
 
 // Exists 判断文件/目录是否存在
@@ -303,59 +279,34 @@ func (w *workspaceReader) WalkFile(ctx context.Context, dir string, walkFn types
 		walkOpts.VisitPattern.MaxVisitLimit = MaxFileVisitLimit
 	}
 
+	// 目录并行读取，过滤也在各 worker 中进行；walkFn 串行调用，调用方无需处理并发
+	var mu sync.Mutex
 	var visitCount int
-
-	return filepath.WalkDir(dir, func(filePath string, info fs.DirEntry, err error) error {
-		if err != nil && !walkOpts.IgnoreError {
-			return err
-		}
-
-		// 跳过隐藏文件和目录
-		if utils.IsHiddenFile(info.Name()) {
-			if info.IsDir() {
-				return filepath.SkipDir
-			}
-			return nil
-		}
-
-		relativePath, err := filepath.Rel(dir, filePath)
-		if err != nil && !walkOpts.IgnoreError {
-			return err
-		}
-
-		if relativePath == types.Dot {
-			return nil
-		}
-
+	visit := func(filePath, relativePath string, info fs.DirEntry) error {
 		var size int64
 		var modTime time.Time
 		if fileInfo, err := info.Info(); err == nil {
 			size = fileInfo.Size()
 			modTime = fileInfo.ModTime()
 		}
-
-		skip, err := walkOpts.VisitPattern.ShouldSkip(
-			&types.FileInfo{
-				Name:    info.Name(),
-				Path:    filePath,
-				IsDir:   info.IsDir(),
-				Size:    size,
-				ModTime: modTime,
-			})
+		fileInfo := &types.FileInfo{
+			Name:    info.Name(),
+			Path:    filePath,
+			IsDir:   info.IsDir(),
+			Size:    size,
+			ModTime: modTime,
+		}
+		skip, err := walkOpts.VisitPattern.ShouldSkip(fileInfo)
 		if skip {
 			// 跳过目录
-			if info.IsDir() {
-				return filepath.SkipDir
-			}
-			return nil
+			return filepath.SkipDir
 		}
 		if errors.Is(err, filepath.SkipDir) || errors.Is(err, filepath.SkipAll) {
 			return err
 		}
 
-		// Convert Windows filePath separators to forward slashes
-		relativePath = filepath.ToSlash(relativePath)
-
+		mu.Lock()
+		defer mu.Unlock()
 		visitCount++
 		if visitCount > walkOpts.VisitPattern.MaxVisitLimit {
 			return filepath.SkipAll
@@ -368,19 +319,40 @@ func (w *workspaceReader) WalkFile(ctx context.Context, dir string, walkFn types
 
 		// 构建 WalkContext
 		walkCtx := &types.WalkContext{
-			Path:         filePath,
-			RelativePath: relativePath,
-			Info: &types.FileInfo{
-				Name:    info.Name(),
-				Path:    filePath,
-				IsDir:   info.IsDir(),
-				Size:    size,
-				ModTime: modTime,
-			},
-			ParentPath: filepath.Dir(filePath),
+			Path: filePath,
+			// Convert Windows filePath separators to forward slashes
+			RelativePath: filepath.ToSlash(relativePath),
+			Info:         fileInfo,
+			ParentPath:   filepath.Dir(filePath),
 		}
-
 		return walkFn(walkCtx)
+	}
+
+	return utils.ParallelWalk(ctx, dir, utils.ParallelWalkOptions{
+		VisitDir: func(entry utils.WalkEntry) error {
+			// 跳过隐藏目录
+			if utils.IsHiddenFile(entry.Entry.Name()) {
+				return filepath.SkipDir
+			}
+			return visit(entry.Path, entry.RelPath, entry.Entry)
+		},
+		VisitFile: func(entry utils.WalkEntry) error {
+			// 跳过隐藏文件
+			if utils.IsHiddenFile(entry.Entry.Name()) {
+				return nil
+			}
+			// 文件返回 SkipDir 时只跳过该文件
+			if err := visit(entry.Path, entry.RelPath, entry.Entry); !errors.Is(err, filepath.SkipDir) {
+				return err
+			}
+			return nil
+		},
+		OnError: func(path string, err error) error {
+			if walkOpts.IgnoreError {
+				return nil
+			}
+			return err
+		},
 	})
 }
 
@@ -401,42 +373,23 @@ func (l *workspaceReader) Tree(ctx context.Context, workspacePath string, subDir
 	nodeMap := make(map[string]*types.TreeNode)
 	walkBasePath := filepath.Join(workspacePath, subDir)
 
-	err = filepath.WalkDir(walkBasePath, func(absFilePath string, info fs.DirEntry, err error) error {
-		if err != nil {
-			return err
-		}
-
+	// 并行遍历收集需要的目录项，排序后按先父后子的顺序构建树
+	var mu sync.Mutex
+	var entries []utils.WalkEntry
+	accept := func(entry utils.WalkEntry) bool {
 		// 跳过隐藏文件和目录
-		if utils.IsHiddenFile(info.Name()) {
-			if info.IsDir() {
-				return filepath.SkipDir
-			}
-			return nil
-		}
-
-		// 获取相对路径，相对workspacePath
-		codeBaseRelativePath, err := filepath.Rel(workspacePath, absFilePath)
-		if err != nil {
-			return err
-		}
-		// 获取相对路径，相对workspacePath + subdir
-		walkBaseRelativePath, err := filepath.Rel(walkBasePath, absFilePath)
-		if err != nil {
-			return err
+		if utils.IsHiddenFile(entry.Entry.Name()) {
+			return false
 		}
+		// 相对路径，相对workspacePath + subdir
+		walkBaseRelativePath := entry.RelPath
 
 		// 应用过滤规则
 		if option.ExcludePattern != nil && option.ExcludePattern.MatchString(walkBaseRelativePath) {
-			if info.IsDir() {
-				return filepath.SkipDir
-			}
-			return nil
+			return false
 		}
 		if option.IncludePattern != nil && !option.IncludePattern.MatchString(walkBaseRelativePath) {
-			if info.IsDir() {
-				return filepath.SkipDir
-			}
-			return nil
+			return false
 		}
 
 		// 检查深度限制
@@ -444,21 +397,53 @@ func (l *workspaceReader) Tree(ctx context.Context, workspacePath string, subDir
 			// 相对根+subdir 的depth
 			depth := len(strings.Split(walkBaseRelativePath, string(filepath.Separator)))
 			if depth > option.MaxDepth {
-				if info.IsDir() {
-					return filepath.SkipDir
-				}
-				return nil
+				return false
 			}
 		}
+		mu.Lock()
+		entries = append(entries, entry)
+		mu.Unlock()
+		return true
+	}
+	err = utils.ParallelWalk(ctx, walkBasePath, utils.ParallelWalkOptions{
+		VisitDir: func(entry utils.WalkEntry) error {
+			if !accept(entry) {
+				return filepath.SkipDir
+			}
+			return nil
+		},
+		VisitFile: func(entry utils.WalkEntry) error {
+			accept(entry)
+			return nil
+		},
+		OnError: func(path string, err error) error {
+			return err
+		},
+	})
+	if err != nil {
+		return nil, fmt.Errorf("failed to walk directory: %w", err)
+	}
+	// 路径排序后父目录总在子项之前
+	sort.Slice(entries, func(i, j int) bool { return entries[i].RelPath < entries[j].RelPath })
+
+	for _, entry := range entries {
+		absFilePath := entry.Path
+		info := entry.Entry
+		walkBaseRelativePath := entry.RelPath
+
+		// 获取相对路径，相对workspacePath
+		codeBaseRelativePath, err := filepath.Rel(workspacePath, absFilePath)
+		if err != nil {
+			return nil, fmt.Errorf("failed to walk directory: %w", err)
+		}
 
 		var currentPath string
 		var parts []string
 
 		// 如果是根目录本身，跳过
 		if walkBaseRelativePath == types.Dot || utils.PathEqual(walkBaseRelativePath, subDir) {
-			return nil
+			continue
 		}
-
 		// 如果是根目录下的文件或目录
 		if !strings.Contains(walkBaseRelativePath, string(filepath.Separator)) {
 			currentPath = walkBaseRelativePath
@@ -513,12 +498,6 @@ func (l *workspaceReader) Tree(ctx context.Context, workspacePath string, subDir
 				}
 			}
 		}
-
-		return nil
-	})
-
-	if err != nil {
-		return nil, fmt.Errorf("failed to walk directory: %w", err)
 	}
 
 	// 构建根节点列表
@@ -3,8 +3,10 @@ package workspace
 import (
 	"codebase-indexer/pkg/codegraph/types"
 	"context"
+	"fmt"
 	"os"
 	"path/filepath"
+	"strings"
 	"testing"
 
 	"github.com/stretchr/testify/assert"
@@ -91,3 +93,43 @@ func TestFindProjects(t *testing.T) {
 		})
 	}
 }
+
+func TestReadFile(t *testing.T) {
+	dir := t.TempDir()
+	path := filepath.Join(dir, "main.go")
+	content := "package main\r\n\r\nfunc main() {\n}\n"
+	assert.NoError(t, os.WriteFile(path, []byte(content), 0644))
+	wr := NewWorkSpaceReader(NewMockLogger())
+	ctx := context.Background()
+
+	// 全量读取保留原始内容
+	data, err := wr.ReadFile(ctx, path, types.ReadOptions{})
+	assert.NoError(t, err)
+	assert.Equal(t, content, string(data))
+
+	data, err = wr.ReadFile(ctx, path, types.ReadOptions{StartLine: 1, EndLine: 3})
+	assert.NoError(t, err)
+	assert.Equal(t, "package main\n\nfunc main() {", string(data))
+	data, err = wr.ReadFile(ctx, path, types.ReadOptions{StartLine: 3})
+	assert.NoError(t, err)
+	assert.Equal(t, "func main() {\n}", string(data))
+	data, err = wr.ReadFile(ctx, path, types.ReadOptions{StartLine: 10, EndLine: 20})
+	assert.NoError(t, err)
+	assert.Empty(t, data)
+
+	// 文件变化后行索引重建
+	var sb strings.Builder
+	for i := 1; i <= 20000; i++ {
+		sb.WriteString(fmt.Sprintf("line %d\n", i))
+	}
+	assert.NoError(t, os.WriteFile(path, []byte(sb.String()), 0644))
+	data, err = wr.ReadFile(ctx, path, types.ReadOptions{StartLine: 12345, EndLine: 12346})
+	assert.NoError(t, err)
+	assert.Equal(t, "line 12345\nline 12346", string(data))
+	data, err = wr.ReadFile(ctx, path, types.ReadOptions{StartLine: 19999})
+	assert.NoError(t, err)
+	assert.Equal(t, "line 19999\nline 20000", string(data))
+
+	_, err = wr.ReadFile(ctx, filepath.Join(dir, "missing.go"), types.ReadOptions{StartLine: 1, EndLine: 2})
+	assert.ErrorIs(t, err, ErrPathNotExists)
+}
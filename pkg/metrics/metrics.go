@@ -0,0 +1,386 @@
+// Package metrics 进程内指标注册表，按 Prometheus 文本格式输出，不依赖 prometheus 客户端库
+package metrics
+
+import (
+	"bufio"
+	"fmt"
+	"io"
+	"math"
+	"net/http"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// DefBuckets 默认的耗时直方图分桶（秒）
+var DefBuckets = []float64{.005, .01, .025, .05, .1, .25, .5, 1, 2.5, 5, 10}
+
+// ExponentialBuckets 生成 count 个从 start 开始、按 factor 递增的分桶
+func ExponentialBuckets(start, factor float64, count int) []float64 {
+	buckets := make([]float64, count)
+	for i := range buckets {
+		buckets[i] = start
+		start *= factor
+	}
+	return buckets
+}
+
+const labelSeparator = "\xff"
+
+type metricType string
+
+const (
+	typeCounter   metricType = "counter"
+	typeGauge     metricType = "gauge"
+	typeHistogram metricType = "histogram"
+)
+
+// collector 一个指标族
+type collector interface {
+	describe() (name, help string, typ metricType)
+	write(w *bufio.Writer)
+}
+
+// Registry 指标注册表。同名指标重复注册时后注册的覆盖先注册的
+type Registry struct {
+	mu         sync.RWMutex
+	collectors map[string]collector
+}
+
+// Default 默认注册表，/metrics 输出的内容
+var Default = NewRegistry()
+
+func NewRegistry() *Registry {
+	return &Registry{collectors: make(map[string]collector)}
+}
+
+func (r *Registry) register(c collector) {
+	name, _, _ := c.describe()
+	r.mu.Lock()
+	r.collectors[name] = c
+	r.mu.Unlock()
+}
+
+// Unregister 移除指标
+func (r *Registry) Unregister(name string) {
+	r.mu.Lock()
+	delete(r.collectors, name)
+	r.mu.Unlock()
+}
+
+// WriteText 按名称顺序以 Prometheus 文本格式输出全部指标
+func (r *Registry) WriteText(w io.Writer) error {
+	r.mu.RLock()
+	collectors := make([]collector, 0, len(r.collectors))
+	for _, c := range r.collectors {
+		collectors = append(collectors, c)
+	}
+	r.mu.RUnlock()
+	sort.Slice(collectors, func(i, j int) bool {
+		ni, _, _ := collectors[i].describe()
+		nj, _, _ := collectors[j].describe()
+		return ni < nj
+	})
+
+	bw := bufio.NewWriter(w)
+	for _, c := range collectors {
+		name, help, typ := c.describe()
+		fmt.Fprintf(bw, "# HELP %s %s\n", name, escapeHelp(help))
+		fmt.Fprintf(bw, "# TYPE %s %s\n", name, typ)
+		c.write(bw)
+	}
+	return bw.Flush()
+}
+
+// Handler 输出注册表的 HTTP 处理器
+func (r *Registry) Handler() http.Handler {
+	return http.HandlerFunc(func(w http.ResponseWriter, _ *http.Request) {
+		w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+		_ = r.WriteText(w)
+	})
+}
+
+// vec 按标签值分组的子指标
+type vec[T any] struct {
+	name       string
+	help       string
+	labelNames []string
+	newChild   func() *T
+	mu         sync.RWMutex
+	children   map[string]*T
+}
+
+func (v *vec[T]) withLabelValues(values ...string) *T {
+	if len(values) != len(v.labelNames) {
+		panic(fmt.Sprintf("metrics: %s expects %d label values, got %d", v.name, len(v.labelNames), len(values)))
+	}
+	key := strings.Join(values, labelSeparator)
+	v.mu.RLock()
+	child, ok := v.children[key]
+	v.mu.RUnlock()
+	if ok {
+		return child
+	}
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	if child, ok = v.children[key]; !ok {
+		child = v.newChild()
+		v.children[key] = child
+	}
+	return child
+}
+
+// each 按标签值顺序遍历子指标
+func (v *vec[T]) each(fn func(labels string, child *T)) {
+	v.mu.RLock()
+	keys := make([]string, 0, len(v.children))
+	for key := range v.children {
+		keys = append(keys, key)
+	}
+	children := make([]*T, len(keys))
+	sort.Strings(keys)
+	for i, key := range keys {
+		children[i] = v.children[key]
+	}
+	v.mu.RUnlock()
+	for i, key := range keys {
+		var values []string
+		if len(v.labelNames) > 0 {
+			values = strings.Split(key, labelSeparator)
+		}
+		fn(formatLabels(v.labelNames, values), children[i])
+	}
+}
+
+// Counter 单调递增计数
+type Counter struct {
+	bits atomic.Uint64
+}
+
+func (c *Counter) Add(v float64) {
+	addFloat(&c.bits, v)
+}
+
+func (c *Counter) Inc() {
+	c.Add(1)
+}
+
+// CounterVec 带标签的计数
+type CounterVec struct {
+	vec[Counter]
+}
+
+func (r *Registry) NewCounterVec(name, help string, labelNames ...string) *CounterVec {
+	c := &CounterVec{vec[Counter]{name: name, help: help, labelNames: labelNames,
+		newChild: func() *Counter { return new(Counter) }, children: make(map[string]*Counter)}}
+	r.register(c)
+	return c
+}
+
+func (c *CounterVec) WithLabelValues(values ...string) *Counter {
+	return c.withLabelValues(values...)
+}
+
+func (c *CounterVec) describe() (string, string, metricType) {
+	return c.name, c.help, typeCounter
+}
+
+func (c *CounterVec) write(w *bufio.Writer) {
+	c.each(func(labels string, child *Counter) {
+		writeSample(w, c.name, labels, math.Float64frombits(child.bits.Load()))
+	})
+}
+
+// Histogram 累计分桶直方图
+type Histogram struct {
+	upperBounds []float64
+	buckets     []atomic.Uint64 // 各分桶自身的计数，输出时累加
+	count       atomic.Uint64
+	sumBits     atomic.Uint64
+}
+
+func newHistogram(buckets []float64) *Histogram {
+	return &Histogram{upperBounds: buckets, buckets: make([]atomic.Uint64, len(buckets))}
+}
+
+func (h *Histogram) Observe(v float64) {
+	if i := sort.SearchFloat64s(h.upperBounds, v); i < len(h.upperBounds) {
+		h.buckets[i].Add(1)
+	}
+	h.count.Add(1)
+	addFloat(&h.sumBits, v)
+}
+
+// ObserveSince 记录从 start 到现在的秒数
+func (h *Histogram) ObserveSince(start time.Time) {
+	h.Observe(time.Since(start).Seconds())
+}
+
+// ObserveDuration 记录耗时（秒）
+func (h *Histogram) ObserveDuration(d time.Duration) {
+	h.Observe(d.Seconds())
+}
+
+// HistogramVec 带标签的直方图
+type HistogramVec struct {
+	vec[Histogram]
+}
+
+func (r *Registry) NewHistogramVec(name, help string, buckets []float64, labelNames ...string) *HistogramVec {
+	if len(buckets) == 0 {
+		buckets = DefBuckets
+	}
+	buckets = append([]float64(nil), buckets...)
+	sort.Float64s(buckets)
+	h := &HistogramVec{vec[Histogram]{name: name, help: help, labelNames: labelNames,
+		newChild: func() *Histogram { return newHistogram(buckets) }, children: make(map[string]*Histogram)}}
+	r.register(h)
+	return h
+}
+
+func (h *HistogramVec) WithLabelValues(values ...string) *Histogram {
+	return h.withLabelValues(values...)
+}
+
+func (h *HistogramVec) describe() (string, string, metricType) {
+	return h.name, h.help, typeHistogram
+}
+
+func (h *HistogramVec) write(w *bufio.Writer) {
+	h.each(func(labels string, child *Histogram) {
+		var cumulative uint64
+		for i, bound := range child.upperBounds {
+			cumulative += child.buckets[i].Load()
+			writeSample(w, h.name+"_bucket", appendLabel(labels, "le", formatFloat(bound)), float64(cumulative))
+		}
+		count := child.count.Load()
+		writeSample(w, h.name+"_bucket", appendLabel(labels, "le", "+Inf"), float64(count))
+		writeSample(w, h.name+"_sum", labels, math.Float64frombits(child.sumBits.Load()))
+		writeSample(w, h.name+"_count", labels, float64(count))
+	})
+}
+
+// funcCollector 输出时回调取值，用于从其他组件的统计信息中采集
+type funcCollector struct {
+	name       string
+	help       string
+	typ        metricType
+	labelNames []string
+	collect    func(emit func(value float64, labelValues ...string))
+}
+
+// NewGaugeFunc 注册在输出时回调取值的仪表盘，collect 对每组标签值调用一次 emit
+func (r *Registry) NewGaugeFunc(name, help string, labelNames []string,
+	collect func(emit func(value float64, labelValues ...string))) {
+	r.register(&funcCollector{name: name, help: help, typ: typeGauge, labelNames: labelNames, collect: collect})
+}
+
+// NewCounterFunc 注册在输出时回调取值的计数，用于暴露组件内部已维护的累计值
+func (r *Registry) NewCounterFunc(name, help string, labelNames []string,
+	collect func(emit func(value float64, labelValues ...string))) {
+	r.register(&funcCollector{name: name, help: help, typ: typeCounter, labelNames: labelNames, collect: collect})
+}
+
+func (f *funcCollector) describe() (string, string, metricType) {
+	return f.name, f.help, f.typ
+}
+
+func (f *funcCollector) write(w *bufio.Writer) {
+	f.collect(func(value float64, labelValues ...string) {
+		if len(labelValues) != len(f.labelNames) {
+			return
+		}
+		writeSample(w, f.name, formatLabels(f.labelNames, labelValues), value)
+	})
+}
+
+// NewHistogramVec 在默认注册表上创建直方图
+func NewHistogramVec(name, help string, buckets []float64, labelNames ...string) *HistogramVec {
+	return Default.NewHistogramVec(name, help, buckets, labelNames...)
+}
+
+// NewCounterVec 在默认注册表上创建计数
+func NewCounterVec(name, help string, labelNames ...string) *CounterVec {
+	return Default.NewCounterVec(name, help, labelNames...)
+}
+
+// NewGaugeFunc 在默认注册表上注册回调仪表盘
+func NewGaugeFunc(name, help string, labelNames []string, collect func(emit func(value float64, labelValues ...string))) {
+	Default.NewGaugeFunc(name, help, labelNames, collect)
+}
+
+// NewCounterFunc 在默认注册表上注册回调计数
+func NewCounterFunc(name, help string, labelNames []string, collect func(emit func(value float64, labelValues ...string))) {
+	Default.NewCounterFunc(name, help, labelNames, collect)
+}
+
+func addFloat(bits *atomic.Uint64, v float64) {
+	for {
+		old := bits.Load()
+		if bits.CompareAndSwap(old, math.Float64bits(math.Float64frombits(old)+v)) {
+			return
+		}
+	}
+}
+
+func writeSample(w *bufio.Writer, name, labels string, value float64) {
+	w.WriteString(name)
+	w.WriteString(labels)
+	w.WriteByte(' ')
+	w.WriteString(formatFloat(value))
+	w.WriteByte('\n')
+}
+
+func formatLabels(names, values []string) string {
+	if len(names) == 0 {
+		return ""
+	}
+	var sb strings.Builder
+	sb.WriteByte('{')
+	for i, name := range names {
+		if i > 0 {
+			sb.WriteByte(',')
+		}
+		sb.WriteString(name)
+		sb.WriteString(`="`)
+		sb.WriteString(escapeLabelValue(values[i]))
+		sb.WriteByte('"')
+	}
+	sb.WriteByte('}')
+	return sb.String()
+}
+
+func appendLabel(labels, name, value string) string {
+	pair := name + `="` + escapeLabelValue(value) + `"`
+	if labels == "" {
+		return "{" + pair + "}"
+	}
+	return labels[:len(labels)-1] + "," + pair + "}"
+}
+
+func formatFloat(v float64) string {
+	switch {
+	case math.IsInf(v, 1):
+		return "+Inf"
+	case math.IsInf(v, -1):
+		return "-Inf"
+	case math.IsNaN(v):
+		return "NaN"
+	}
+	return strconv.FormatFloat(v, 'g', -1, 64)
+}
+
+var labelValueEscaper = strings.NewReplacer(`\`, `\\`, "\n", `\n`, `"`, `\"`)
+
+func escapeLabelValue(v string) string {
+	return labelValueEscaper.Replace(v)
+}
+
+var helpEscaper = strings.NewReplacer(`\`, `\\`, "\n", `\n`)
+
+func escapeHelp(help string) string {
+	return helpEscaper.Replace(help)
+}
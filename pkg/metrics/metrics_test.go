@@ -0,0 +1,65 @@
+package metrics
+
+import (
+	"net/http/httptest"
+	"strings"
+	"sync"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func TestRegistry_WriteText(t *testing.T) {
+	r := NewRegistry()
+	h := r.NewHistogramVec("test_duration_seconds", "stage duration", []float64{1, 0.1}, "stage")
+	c := r.NewCounterVec("test_files_total", "indexed files", "result")
+	r.NewGaugeFunc("test_queue_depth", "queue depth", []string{"workspace"}, func(emit func(float64, ...string)) {
+		emit(3, `/a "b"`)
+		emit(1) // 标签数量不匹配，忽略
+	})
+
+	h.WithLabelValues("parse").Observe(0.05)
+	h.WithLabelValues("parse").Observe(0.5)
+	h.WithLabelValues("parse").Observe(5)
+	c.WithLabelValues("ok").Add(2)
+	c.WithLabelValues("ok").Inc()
+
+	var sb strings.Builder
+	assert.NoError(t, r.WriteText(&sb))
+	assert.Equal(t, `# HELP test_duration_seconds stage duration
+# TYPE test_duration_seconds histogram
+test_duration_seconds_bucket{stage="parse",le="0.1"} 1
+test_duration_seconds_bucket{stage="parse",le="1"} 2
+test_duration_seconds_bucket{stage="parse",le="+Inf"} 3
+test_duration_seconds_sum{stage="parse"} 5.55
+test_duration_seconds_count{stage="parse"} 3
+# HELP test_files_total indexed files
+# TYPE test_files_total counter
+test_files_total{result="ok"} 3
+# HELP test_queue_depth queue depth
+# TYPE test_queue_depth gauge
+test_queue_depth{workspace="/a \"b\""} 3
+`, sb.String())
+}
+
+func TestRegistry_ConcurrentObserve(t *testing.T) {
+	r := NewRegistry()
+	h := r.NewHistogramVec("test_seconds", "", nil)
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < 1000; j++ {
+				h.WithLabelValues().Observe(0.001)
+			}
+		}()
+	}
+	wg.Wait()
+	assert.Equal(t, uint64(8000), h.WithLabelValues().count.Load())
+
+	rec := httptest.NewRecorder()
+	r.Handler().ServeHTTP(rec, httptest.NewRequest("GET", "/metrics", nil))
+	assert.Contains(t, rec.Body.String(), `test_seconds_bucket{le="+Inf"} 8000`)
+	assert.Contains(t, rec.Header().Get("Content-Type"), "text/plain")
+}
@@ -0,0 +1,55 @@
+package response
+
+import (
+	"encoding/json"
+	"net/http"
+
+	"github.com/gin-gonic/gin"
+)
+
+// StreamWriter 以 NDJSON 分块返回，每行是一个 Response，写入后立即刷新
+type StreamWriter struct {
+	c       *gin.Context
+	started bool
+}
+
+// NewStreamWriter 创建流式响应，第一次写入时发送响应头
+func NewStreamWriter(c *gin.Context) *StreamWriter {
+	return &StreamWriter{c: c}
+}
+
+// Write 写入一行数据，客户端已断开时返回错误
+func (w *StreamWriter) Write(v any) error {
+	return w.write(wrapResponse(v))
+}
+
+// Error 尚未写入数据时按普通请求返回错误，否则写入一行错误
+func (w *StreamWriter) Error(httpStatusCode int, e error) {
+	if !w.started {
+		Error(w.c, httpStatusCode, e)
+		return
+	}
+	_ = w.write(wrapResponse(e))
+}
+
+func (w *StreamWriter) write(resp Response[any]) error {
+	if err := w.c.Request.Context().Err(); err != nil {
+		return err
+	}
+	data, err := json.Marshal(resp)
+	if err != nil {
+		return err
+	}
+	if !w.started {
+		w.c.Header("Content-Type", "application/x-ndjson")
+		w.c.Header("Cache-Control", "no-cache")
+		w.c.Header("X-Accel-Buffering", "no") // 禁止反向代理缓冲
+		w.c.Writer.WriteHeader(http.StatusOK)
+		w.started = true
+	}
+	if _, err := w.c.Writer.Write(append(data, '\n')); err != nil {
+		return err
+	}
+	w.c.Writer.Flush()
+	return nil
+}
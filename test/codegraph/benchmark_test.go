@@ -0,0 +1,373 @@
+package codegraph
+
+import (
+	"codebase-indexer/internal/service"
+	"codebase-indexer/pkg/codegraph/lang"
+	"codebase-indexer/pkg/codegraph/types"
+	"codebase-indexer/pkg/codegraph/workspace"
+	"context"
+	"encoding/json"
+	"fmt"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"sort"
+	"strconv"
+	"testing"
+	"time"
+)
+
+// 基准测试使用合成仓库，规模通过环境变量调整：
+//   BENCH_FILES   合成仓库的文件数，默认 10000
+//   BENCH_DIR     合成仓库的生成目录，默认 /tmp/codebase-indexer-bench
+//   BENCH_OUTPUT  结果以 JSON Lines 追加写入该文件，便于跟踪趋势；为空时不写
+// make bench 运行全部 BenchmarkSynthetic*。
+
+const (
+	defaultBenchFiles = 10000
+	defaultBenchDir   = "/tmp/codebase-indexer-bench"
+	// 解析基准每种语言最多加载到内存的文件数
+	benchParseSampleFiles = 2000
+	// 调用链查询深度
+	benchCallGraphLayers = 5
+)
+
+// benchResult 写入 BENCH_OUTPUT 的一行
+type benchResult struct {
+	Name    string             `json:"name"`
+	Files   int                `json:"files"`
+	N       int                `json:"n"`
+	Time    string             `json:"time"`
+	Metrics map[string]float64 `json:"metrics"`
+}
+
+// benchIndexedWorkspace 已生成并完成索引的合成仓库，查询基准共用
+type benchIndexedWorkspace struct {
+	env     *testEnvironment
+	indexer service.Indexer
+	repo    *SyntheticRepo
+}
+
+var benchIndexed *benchIndexedWorkspace
+
+func benchFiles() int {
+	if envVal, ok := os.LookupEnv("BENCH_FILES"); ok {
+		if val, err := strconv.Atoi(envVal); err == nil && val > 0 {
+			return val
+		}
+	}
+	return defaultBenchFiles
+}
+
+func benchDir() string {
+	if envVal, ok := os.LookupEnv("BENCH_DIR"); ok && envVal != "" {
+		return envVal
+	}
+	return defaultBenchDir
+}
+
+// benchRepo 生成（或复用）当前规模的合成仓库
+func benchRepo(b *testing.B) *SyntheticRepo {
+	b.Helper()
+	files := benchFiles()
+	repo, err := GenerateSyntheticRepo(filepath.Join(benchDir(), fmt.Sprintf("repo_%d", files)),
+		SyntheticRepoOptions{Files: files})
+	if err != nil {
+		b.Fatal(err)
+	}
+	return repo
+}
+
+func newBenchIndexer(env *testEnvironment, repo *SyntheticRepo) service.Indexer {
+	return service.NewCodeIndexer(
+		env.Scanner,
+		env.sourceFileParser,
+		env.dependencyAnalyzer,
+		env.workspaceReader,
+		env.storage,
+		env.repository,
+		service.IndexerConfig{VisitPattern: workspace.DefaultVisitPattern, MaxFiles: repo.Files + 1},
+		env.logger,
+	)
+}
+
+// benchIndex 首次调用时重建合成仓库的索引，之后复用
+func benchIndex(b *testing.B) *benchIndexedWorkspace {
+	b.Helper()
+	if benchIndexed != nil {
+		return benchIndexed
+	}
+	repo := benchRepo(b)
+	env, err := setupTestEnvironment()
+	if err != nil {
+		b.Fatal(err)
+	}
+	if err = initWorkspaceModel(env, repo.Root); err != nil {
+		b.Fatal(err)
+	}
+	indexer := newBenchIndexer(env, repo)
+	ctx := context.Background()
+	if err = indexer.RemoveAllIndexes(ctx, repo.Root); err != nil {
+		b.Fatal(err)
+	}
+	if _, err = indexer.IndexWorkspace(ctx, repo.Root); err != nil {
+		b.Fatal(err)
+	}
+	benchIndexed = &benchIndexedWorkspace{env: env, indexer: indexer, repo: repo}
+	return benchIndexed
+}
+
+// benchQueryTargets 返回有调用关系的查询目标，按步长取样使其分布在整个仓库
+func benchQueryTargets(b *testing.B, repo *SyntheticRepo) []SyntheticTarget {
+	b.Helper()
+	var targets []SyntheticTarget
+	for _, target := range repo.Targets {
+		if target.SymbolName != "syntheticFunc0" {
+			targets = append(targets, target)
+		}
+	}
+	if len(targets) == 0 {
+		b.Fatal("synthetic repo has no query targets")
+	}
+	const maxTargets = 1000
+	if len(targets) <= maxTargets {
+		return targets
+	}
+	sampled := make([]SyntheticTarget, 0, maxTargets)
+	step := len(targets) / maxTargets
+	for i := 0; i < len(targets) && len(sampled) < maxTargets; i += step {
+		sampled = append(sampled, targets[i])
+	}
+	return sampled
+}
+
+// reportBench 上报自定义指标并追加写入 BENCH_OUTPUT
+func reportBench(b *testing.B, files int, metrics map[string]float64) {
+	b.Helper()
+	for unit, value := range metrics {
+		b.ReportMetric(value, unit)
+	}
+	output := os.Getenv("BENCH_OUTPUT")
+	if output == "" {
+		return
+	}
+	line, err := json.Marshal(benchResult{
+		Name:    b.Name(),
+		Files:   files,
+		N:       b.N,
+		Time:    time.Now().Format(time.RFC3339),
+		Metrics: metrics,
+	})
+	if err != nil {
+		b.Fatal(err)
+	}
+	if err = os.MkdirAll(filepath.Dir(output), 0755); err != nil {
+		b.Fatal(err)
+	}
+	f, err := os.OpenFile(output, os.O_CREATE|os.O_APPEND|os.O_WRONLY, 0644)
+	if err != nil {
+		b.Fatal(err)
+	}
+	defer f.Close()
+	if _, err = f.Write(append(line, '\n')); err != nil {
+		b.Fatal(err)
+	}
+}
+
+// latencyMetrics 计算 p50/p99 延迟（毫秒）
+func latencyMetrics(latencies []time.Duration) map[string]float64 {
+	if len(latencies) == 0 {
+		return map[string]float64{}
+	}
+	sort.Slice(latencies, func(i, j int) bool { return latencies[i] < latencies[j] })
+	percentile := func(p float64) float64 {
+		i := int(float64(len(latencies)-1) * p)
+		return float64(latencies[i]) / float64(time.Millisecond)
+	}
+	return map[string]float64{"p50-ms": percentile(0.50), "p99-ms": percentile(0.99)}
+}
+
+// dirSize 统计目录下文件的总字节数
+func dirSize(dir string) (int64, error) {
+	var size int64
+	err := filepath.WalkDir(dir, func(path string, d fs.DirEntry, err error) error {
+		if err != nil {
+			return err
+		}
+		if d.IsDir() {
+			return nil
+		}
+		info, err := d.Info()
+		if err != nil {
+			return err
+		}
+		size += info.Size()
+		return nil
+	})
+	return size, err
+}
+
+// BenchmarkSyntheticParse 单文件解析吞吐，每次操作解析一个文件，allocs/op 即每个文件的分配次数
+func BenchmarkSyntheticParse(b *testing.B) {
+	repo := benchRepo(b)
+	env, err := setupTestEnvironment()
+	if err != nil {
+		b.Fatal(err)
+	}
+	defer teardownTestEnvironment(nil, env)
+
+	byLanguage := make(map[lang.Language][]*types.SourceFile)
+	for _, target := range repo.Targets {
+		if len(byLanguage[target.Language]) >= benchParseSampleFiles {
+			continue
+		}
+		content, err := os.ReadFile(target.FilePath)
+		if err != nil {
+			b.Fatal(err)
+		}
+		byLanguage[target.Language] = append(byLanguage[target.Language],
+			&types.SourceFile{Path: target.FilePath, Content: content})
+	}
+	languages := make([]string, 0, len(byLanguage))
+	for language := range byLanguage {
+		languages = append(languages, string(language))
+	}
+	sort.Strings(languages)
+
+	for _, language := range languages {
+		files := byLanguage[lang.Language(language)]
+		b.Run(language, func(b *testing.B) {
+			ctx := context.Background()
+			var bytes int64
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				file := files[i%len(files)]
+				if _, err := env.sourceFileParser.Parse(ctx, file); err != nil {
+					b.Fatalf("parse %s err: %v", file.Path, err)
+				}
+				bytes += int64(len(file.Content))
+			}
+			elapsed := b.Elapsed().Seconds()
+			b.StopTimer()
+			reportBench(b, repo.Files, map[string]float64{
+				"files/s": float64(b.N) / elapsed,
+				"MB/s":    float64(bytes) / 1e6 / elapsed,
+			})
+		})
+	}
+}
+
+// BenchmarkSyntheticIndexWorkspace 全量索引合成仓库的端到端耗时及索引存储大小
+func BenchmarkSyntheticIndexWorkspace(b *testing.B) {
+	repo := benchRepo(b)
+	env, err := setupTestEnvironment()
+	if err != nil {
+		b.Fatal(err)
+	}
+	defer teardownTestEnvironment(nil, env)
+	if err = initWorkspaceModel(env, repo.Root); err != nil {
+		b.Fatal(err)
+	}
+	indexer := newBenchIndexer(env, repo)
+	ctx := context.Background()
+
+	var indexed int
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		b.StopTimer()
+		if err = indexer.RemoveAllIndexes(ctx, repo.Root); err != nil {
+			b.Fatal(err)
+		}
+		b.StartTimer()
+		metrics, err := indexer.IndexWorkspace(ctx, repo.Root)
+		if err != nil {
+			b.Fatal(err)
+		}
+		indexed += metrics.TotalFiles - metrics.TotalFailedFiles
+	}
+	elapsed := b.Elapsed().Seconds()
+	b.StopTimer()
+
+	var storeBytes int64
+	for _, p := range env.workspaceReader.FindProjects(ctx, repo.Root, true, workspace.DefaultVisitPattern) {
+		size, err := dirSize(filepath.Join(env.storageDir, p.Uuid))
+		if err != nil && !os.IsNotExist(err) {
+			b.Fatal(err)
+		}
+		storeBytes += size
+	}
+	reportBench(b, repo.Files, map[string]float64{
+		"index-s":     elapsed / float64(b.N),
+		"files/s":     float64(indexed) / elapsed,
+		"MB/s":        float64(repo.Bytes) * float64(b.N) / 1e6 / elapsed,
+		"store-bytes": float64(storeBytes),
+	})
+}
+
+// runQueryBench 每次操作执行一次查询，记录单次延迟
+func runQueryBench(b *testing.B, query func(ctx context.Context, target SyntheticTarget) (int, error)) {
+	indexed := benchIndex(b)
+	targets := benchQueryTargets(b, indexed.repo)
+	ctx := context.Background()
+
+	latencies := make([]time.Duration, 0, b.N)
+	var results, failures int
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		start := time.Now()
+		n, err := query(ctx, targets[i%len(targets)])
+		latencies = append(latencies, time.Since(start))
+		if err != nil {
+			failures++
+			continue
+		}
+		results += n
+	}
+	b.StopTimer()
+
+	metrics := latencyMetrics(latencies)
+	metrics["results/op"] = float64(results) / float64(b.N)
+	metrics["errors/op"] = float64(failures) / float64(b.N)
+	reportBench(b, indexed.repo.Files, metrics)
+}
+
+func BenchmarkSyntheticQueryDefinitions(b *testing.B) {
+	runQueryBench(b, func(ctx context.Context, target SyntheticTarget) (int, error) {
+		// 函数体第一行是对上一个文件中函数的调用
+		defs, err := benchIndexed.indexer.QueryDefinitions(ctx, &types.QueryDefinitionOptions{
+			Workspace: benchIndexed.repo.Root,
+			FilePath:  target.FilePath,
+			StartLine: target.Line + 1,
+			EndLine:   target.Line + 1,
+		})
+		return len(defs), err
+	})
+}
+
+func BenchmarkSyntheticQueryReferences(b *testing.B) {
+	runQueryBench(b, func(ctx context.Context, target SyntheticTarget) (int, error) {
+		refs, err := benchIndexed.indexer.QueryReferences(ctx, &types.QueryReferenceOptions{
+			Workspace:  benchIndexed.repo.Root,
+			FilePath:   target.FilePath,
+			StartLine:  target.Line,
+			EndLine:    target.Line,
+			SymbolName: target.SymbolName,
+		})
+		return len(refs), err
+	})
+}
+
+func BenchmarkSyntheticQueryCallGraph(b *testing.B) {
+	runQueryBench(b, func(ctx context.Context, target SyntheticTarget) (int, error) {
+		nodes, err := benchIndexed.indexer.QueryCallGraph(ctx, &types.QueryCallGraphOptions{
+			Workspace:  benchIndexed.repo.Root,
+			FilePath:   target.FilePath,
+			SymbolName: target.SymbolName,
+			MaxLayer:   benchCallGraphLayers,
+		})
+		return len(nodes), err
+	})
+}
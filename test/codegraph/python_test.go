@@ -706,12 +706,12 @@ func TestIterPythonProjectKeys(t *testing.T) {
 				}
 
 				// 统计key类型
-				if strings.HasPrefix(key, "@sym:") {
+				if store.IsSymbolNameKey(key) {
 					symbolKeys++
 					if symbolKeys <= 5 { // 显示前5个符号key的详细信息
 						fmt.Printf("      -> 符号Key: %s\n", key)
 					}
-				} else if strings.HasPrefix(key, "@path:") {
+				} else if store.IsElementPathKey(key) {
 					pathKeys++
 
 					// 检查特定路径的内容
@@ -0,0 +1,225 @@
+package codegraph
+
+import (
+	"bytes"
+	"codebase-indexer/pkg/codegraph/lang"
+	"encoding/json"
+	"fmt"
+	"os"
+	"path/filepath"
+	"sort"
+	"strings"
+)
+
+// 合成仓库使用的样例文件目录，相对 test/codegraph
+var syntheticFixtureDir = filepath.Join("..", "..", "pkg", "codegraph", "parser", "testdata")
+
+// 生成完成的标记文件，存在时直接复用已生成的仓库
+const syntheticManifestFile = "synthetic_manifest.json"
+
+// SyntheticRepoOptions 合成仓库参数
+type SyntheticRepoOptions struct {
+	Files       int             // 生成的源文件总数
+	FilesPerDir int             // 每个目录的文件数，默认 100
+	Languages   []lang.Language // 参与生成的语言，默认 C++/Java/Go/TS
+}
+
+// SyntheticTarget 生成文件末尾追加的函数，作为查询的目标
+type SyntheticTarget struct {
+	Language   lang.Language `json:"language"`
+	FilePath   string        `json:"filePath"`
+	SymbolName string        `json:"symbolName"`
+	Line       int           `json:"line"` // 函数声明所在行（从1开始）
+}
+
+// SyntheticRepo 合成仓库
+type SyntheticRepo struct {
+	Root    string            `json:"root"`
+	Files   int               `json:"files"`
+	Bytes   int64             `json:"bytes"`
+	Targets []SyntheticTarget `json:"targets"`
+}
+
+type syntheticFixture struct {
+	name    string
+	content []byte
+	lines   int
+}
+
+// GenerateSyntheticRepo 把 parser/testdata 下的样例文件按语言轮流复制到 root 下，扩展到指定文件数。
+// 每个文件末尾追加一个函数，调用同语言上一个文件中的函数，形成跨文件的调用链，供引用和调用链查询使用。
+// root 下已有相同参数生成的仓库时直接复用
+func GenerateSyntheticRepo(root string, opts SyntheticRepoOptions) (*SyntheticRepo, error) {
+	if opts.Files <= 0 {
+		return nil, fmt.Errorf("synthetic repo files must be positive, got %d", opts.Files)
+	}
+	if opts.FilesPerDir <= 0 {
+		opts.FilesPerDir = 100
+	}
+	if len(opts.Languages) == 0 {
+		opts.Languages = []lang.Language{lang.CPP, lang.Java, lang.Go, lang.TypeScript}
+	}
+	if repo, err := loadSyntheticRepo(root, opts.Files); err == nil {
+		return repo, nil
+	}
+
+	fixtures := make(map[lang.Language][]syntheticFixture, len(opts.Languages))
+	for _, language := range opts.Languages {
+		fs, err := loadSyntheticFixtures(language)
+		if err != nil {
+			return nil, err
+		}
+		fixtures[language] = fs
+	}
+
+	if err := os.RemoveAll(root); err != nil {
+		return nil, err
+	}
+	repo := &SyntheticRepo{Root: root, Files: opts.Files}
+	counters := make(map[lang.Language]int, len(opts.Languages))
+	for i := 0; i < opts.Files; i++ {
+		language := opts.Languages[i%len(opts.Languages)]
+		seq := counters[language]
+		counters[language]++
+		fs := fixtures[language]
+		fixture := fs[seq%len(fs)]
+
+		dir := filepath.Join(root, string(language), fmt.Sprintf("pkg%04d", i/opts.FilesPerDir))
+		if err := os.MkdirAll(dir, 0755); err != nil {
+			return nil, err
+		}
+		ext := filepath.Ext(fixture.name)
+		path := filepath.Join(dir, fmt.Sprintf("%s_%d%s", strings.TrimSuffix(fixture.name, ext), seq, ext))
+
+		symbol, tail := syntheticTail(language, seq)
+		var buf bytes.Buffer
+		buf.Grow(len(fixture.content) + len(tail) + 1)
+		buf.Write(fixture.content)
+		if len(fixture.content) > 0 && fixture.content[len(fixture.content)-1] != '\n' {
+			buf.WriteByte('\n')
+		}
+		buf.WriteString(tail)
+		if err := os.WriteFile(path, buf.Bytes(), 0644); err != nil {
+			return nil, err
+		}
+		repo.Bytes += int64(buf.Len())
+		repo.Targets = append(repo.Targets, SyntheticTarget{
+			Language:   language,
+			FilePath:   path,
+			SymbolName: symbol,
+			Line:       fixture.lines + 1,
+		})
+	}
+
+	data, err := json.Marshal(repo)
+	if err != nil {
+		return nil, err
+	}
+	if err = os.WriteFile(filepath.Join(root, syntheticManifestFile), data, 0644); err != nil {
+		return nil, err
+	}
+	return repo, nil
+}
+
+func loadSyntheticRepo(root string, files int) (*SyntheticRepo, error) {
+	data, err := os.ReadFile(filepath.Join(root, syntheticManifestFile))
+	if err != nil {
+		return nil, err
+	}
+	repo := new(SyntheticRepo)
+	if err = json.Unmarshal(data, repo); err != nil {
+		return nil, err
+	}
+	if repo.Files != files || repo.Root != root {
+		return nil, fmt.Errorf("synthetic repo %s was generated with %d files", root, repo.Files)
+	}
+	return repo, nil
+}
+
+// loadSyntheticFixtures 读取语言对应的样例文件，跳过空文件
+func loadSyntheticFixtures(language lang.Language) ([]syntheticFixture, error) {
+	parser, err := lang.GetSitterParserByLanguage(language)
+	if err != nil {
+		return nil, err
+	}
+	var paths []string
+	for _, dir := range []string{syntheticFixtureDir, filepath.Join(syntheticFixtureDir, syntheticFixtureSubDir(language))} {
+		for _, ext := range parser.SupportedExts {
+			// .c 文件会被识别为 C
+			if language == lang.CPP && ext == ".c" {
+				continue
+			}
+			matched, err := filepath.Glob(filepath.Join(dir, "*"+ext))
+			if err != nil {
+				return nil, err
+			}
+			paths = append(paths, matched...)
+		}
+	}
+	sort.Strings(paths)
+
+	var fixtures []syntheticFixture
+	seen := make(map[string]struct{}, len(paths))
+	for _, path := range paths {
+		if _, ok := seen[path]; ok {
+			continue
+		}
+		seen[path] = struct{}{}
+		content, err := os.ReadFile(path)
+		if err != nil {
+			return nil, err
+		}
+		if len(bytes.TrimSpace(content)) == 0 {
+			continue
+		}
+		lines := bytes.Count(content, []byte("\n"))
+		if content[len(content)-1] != '\n' {
+			lines++
+		}
+		fixtures = append(fixtures, syntheticFixture{name: filepath.Base(path), content: content, lines: lines})
+	}
+	if len(fixtures) == 0 {
+		return nil, fmt.Errorf("no fixtures found for language %s in %s", language, syntheticFixtureDir)
+	}
+	return fixtures, nil
+}
+
+func syntheticFixtureSubDir(language lang.Language) string {
+	switch language {
+	case lang.CPP:
+		return "cpp"
+	case lang.TypeScript:
+		return "ts"
+	default:
+		return string(language)
+	}
+}
+
+// syntheticTail 生成追加到文件末尾的函数，第一行为函数声明，第二行为对上一个函数的调用
+func syntheticTail(language lang.Language, seq int) (string, string) {
+	symbol := fmt.Sprintf("syntheticFunc%d", seq)
+	callee := fmt.Sprintf("syntheticFunc%d", seq-1)
+	switch language {
+	case lang.Java:
+		if seq == 0 {
+			return symbol, fmt.Sprintf("class SyntheticCaller%d { static void %s() {\n  }\n}\n", seq, symbol)
+		}
+		return symbol, fmt.Sprintf("class SyntheticCaller%d { static void %s() {\n    SyntheticCaller%d.%s();\n  }\n}\n",
+			seq, symbol, seq-1, callee)
+	case lang.Go:
+		if seq == 0 {
+			return symbol, fmt.Sprintf("func %s() {\n}\n", symbol)
+		}
+		return symbol, fmt.Sprintf("func %s() {\n\t%s()\n}\n", symbol, callee)
+	case lang.TypeScript:
+		if seq == 0 {
+			return symbol, fmt.Sprintf("export function %s(): void {\n}\n", symbol)
+		}
+		return symbol, fmt.Sprintf("export function %s(): void {\n  %s();\n}\n", symbol, callee)
+	default:
+		if seq == 0 {
+			return symbol, fmt.Sprintf("void %s() {\n}\n", symbol)
+		}
+		return symbol, fmt.Sprintf("void %s() {\n  %s();\n}\n", symbol, callee)
+	}
+}
@@ -77,6 +77,21 @@ func (mr *MockEventRepositoryMockRecorder) BatchUpdateEvents(events interface{})
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "BatchUpdateEvents", reflect.TypeOf((*MockEventRepository)(nil).BatchUpdateEvents), events)
 }
 
+// ClaimEventsForEmbedding mocks base method.
+func (m *MockEventRepository) ClaimEventsForEmbedding(workspacePath string, eventTypes []string, statuses []int, limit int) ([]*model.Event, error) {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "ClaimEventsForEmbedding", workspacePath, eventTypes, statuses, limit)
+	ret0, _ := ret[0].([]*model.Event)
+	ret1, _ := ret[1].(error)
+	return ret0, ret1
+}
+
+// ClaimEventsForEmbedding indicates an expected call of ClaimEventsForEmbedding.
+func (mr *MockEventRepositoryMockRecorder) ClaimEventsForEmbedding(workspacePath, eventTypes, statuses, limit interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "ClaimEventsForEmbedding", reflect.TypeOf((*MockEventRepository)(nil).ClaimEventsForEmbedding), workspacePath, eventTypes, statuses, limit)
+}
+
 // ClearTable mocks base method.
 func (m *MockEventRepository) ClearTable() error {
 	m.ctrl.T.Helper()
@@ -269,6 +284,21 @@ func (mr *MockEventRepositoryMockRecorder) GetEventsCountByWorkspaceAndStatus(wo
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "GetEventsCountByWorkspaceAndStatus", reflect.TypeOf((*MockEventRepository)(nil).GetEventsCountByWorkspaceAndStatus), workspacePaths, embeddingStatuses, codegraphStatuses)
 }
 
+// GetEventsCountGroupByWorkspace mocks base method.
+func (m *MockEventRepository) GetEventsCountGroupByWorkspace(embeddingStatuses, codegraphStatuses []int) (map[string]int64, error) {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "GetEventsCountGroupByWorkspace", embeddingStatuses, codegraphStatuses)
+	ret0, _ := ret[0].(map[string]int64)
+	ret1, _ := ret[1].(error)
+	return ret0, ret1
+}
+
+// GetEventsCountGroupByWorkspace indicates an expected call of GetEventsCountGroupByWorkspace.
+func (mr *MockEventRepositoryMockRecorder) GetEventsCountGroupByWorkspace(embeddingStatuses, codegraphStatuses interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "GetEventsCountGroupByWorkspace", reflect.TypeOf((*MockEventRepository)(nil).GetEventsCountGroupByWorkspace), embeddingStatuses, codegraphStatuses)
+}
+
 // GetExpiredEventIDs mocks base method.
 func (m *MockEventRepository) GetExpiredEventIDs(cutoffTime time.Time) ([]int64, error) {
 	m.ctrl.T.Helper()
@@ -299,6 +329,21 @@ func (mr *MockEventRepositoryMockRecorder) GetLatestEventByWorkspaceAndSourcePat
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "GetLatestEventByWorkspaceAndSourcePath", reflect.TypeOf((*MockEventRepository)(nil).GetLatestEventByWorkspaceAndSourcePath), workspacePath, sourceFilePath)
 }
 
+// GetLatestEventsBySourcePaths mocks base method.
+func (m *MockEventRepository) GetLatestEventsBySourcePaths(workspacePath string, sourceFilePaths []string) (map[string]*model.Event, error) {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "GetLatestEventsBySourcePaths", workspacePath, sourceFilePaths)
+	ret0, _ := ret[0].(map[string]*model.Event)
+	ret1, _ := ret[1].(error)
+	return ret0, ret1
+}
+
+// GetLatestEventsBySourcePaths indicates an expected call of GetLatestEventsBySourcePaths.
+func (mr *MockEventRepositoryMockRecorder) GetLatestEventsBySourcePaths(workspacePath, sourceFilePaths interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "GetLatestEventsBySourcePaths", reflect.TypeOf((*MockEventRepository)(nil).GetLatestEventsBySourcePaths), workspacePath, sourceFilePaths)
+}
+
 // GetRecentEvents mocks base method.
 func (m *MockEventRepository) GetRecentEvents(workspacePath string, limit int) ([]*model.Event, error) {
 	m.ctrl.T.Helper()
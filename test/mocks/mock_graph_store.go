@@ -50,6 +50,20 @@ func (mr *MockGraphStorageMockRecorder) BatchSave(ctx, projectUuid, values inter
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "BatchSave", reflect.TypeOf((*MockGraphStorage)(nil).BatchSave), ctx, projectUuid, values)
 }
 
+// BeginBulkLoad mocks base method.
+func (m *MockGraphStorage) BeginBulkLoad(ctx context.Context, projectUuid string) error {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "BeginBulkLoad", ctx, projectUuid)
+	ret0, _ := ret[0].(error)
+	return ret0
+}
+
+// BeginBulkLoad indicates an expected call of BeginBulkLoad.
+func (mr *MockGraphStorageMockRecorder) BeginBulkLoad(ctx, projectUuid interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "BeginBulkLoad", reflect.TypeOf((*MockGraphStorage)(nil).BeginBulkLoad), ctx, projectUuid)
+}
+
 // Close mocks base method.
 func (m *MockGraphStorage) Close() error {
 	m.ctrl.T.Helper()
@@ -92,6 +106,34 @@ func (mr *MockGraphStorageMockRecorder) DeleteAll(ctx, projectUuid interface{})
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "DeleteAll", reflect.TypeOf((*MockGraphStorage)(nil).DeleteAll), ctx, projectUuid)
 }
 
+// DeleteAllWithPrefix mocks base method.
+func (m *MockGraphStorage) DeleteAllWithPrefix(ctx context.Context, projectUuid, prefix string) error {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "DeleteAllWithPrefix", ctx, projectUuid, prefix)
+	ret0, _ := ret[0].(error)
+	return ret0
+}
+
+// DeleteAllWithPrefix indicates an expected call of DeleteAllWithPrefix.
+func (mr *MockGraphStorageMockRecorder) DeleteAllWithPrefix(ctx, projectUuid, prefix interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "DeleteAllWithPrefix", reflect.TypeOf((*MockGraphStorage)(nil).DeleteAllWithPrefix), ctx, projectUuid, prefix)
+}
+
+// EndBulkLoad mocks base method.
+func (m *MockGraphStorage) EndBulkLoad(ctx context.Context, projectUuid string) error {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "EndBulkLoad", ctx, projectUuid)
+	ret0, _ := ret[0].(error)
+	return ret0
+}
+
+// EndBulkLoad indicates an expected call of EndBulkLoad.
+func (mr *MockGraphStorageMockRecorder) EndBulkLoad(ctx, projectUuid interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "EndBulkLoad", reflect.TypeOf((*MockGraphStorage)(nil).EndBulkLoad), ctx, projectUuid)
+}
+
 // Exists mocks base method.
 func (m *MockGraphStorage) Exists(ctx context.Context, projectUuid string, key store.Key) (bool, error) {
 	m.ctrl.T.Helper()
@@ -136,6 +178,49 @@ func (mr *MockGraphStorageMockRecorder) Iter(ctx, projectUuid interface{}) *gomo
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "Iter", reflect.TypeOf((*MockGraphStorage)(nil).Iter), ctx, projectUuid)
 }
 
+// IterPrefix mocks base method.
+func (m *MockGraphStorage) IterPrefix(ctx context.Context, projectUuid, keyPrefix string) store.Iterator {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "IterPrefix", ctx, projectUuid, keyPrefix)
+	ret0, _ := ret[0].(store.Iterator)
+	return ret0
+}
+
+// IterPrefix indicates an expected call of IterPrefix.
+func (mr *MockGraphStorageMockRecorder) IterPrefix(ctx, projectUuid, keyPrefix interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "IterPrefix", reflect.TypeOf((*MockGraphStorage)(nil).IterPrefix), ctx, projectUuid, keyPrefix)
+}
+
+// IterRange mocks base method.
+func (m *MockGraphStorage) IterRange(ctx context.Context, projectUuid, start, limit string) store.Iterator {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "IterRange", ctx, projectUuid, start, limit)
+	ret0, _ := ret[0].(store.Iterator)
+	return ret0
+}
+
+// IterRange indicates an expected call of IterRange.
+func (mr *MockGraphStorageMockRecorder) IterRange(ctx, projectUuid, start, limit interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "IterRange", reflect.TypeOf((*MockGraphStorage)(nil).IterRange), ctx, projectUuid, start, limit)
+}
+
+// MultiGet mocks base method.
+func (m *MockGraphStorage) MultiGet(ctx context.Context, projectUuid string, keys []store.Key) ([][]byte, error) {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "MultiGet", ctx, projectUuid, keys)
+	ret0, _ := ret[0].([][]byte)
+	ret1, _ := ret[1].(error)
+	return ret0, ret1
+}
+
+// MultiGet indicates an expected call of MultiGet.
+func (mr *MockGraphStorageMockRecorder) MultiGet(ctx, projectUuid, keys interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "MultiGet", reflect.TypeOf((*MockGraphStorage)(nil).MultiGet), ctx, projectUuid, keys)
+}
+
 // ProjectIndexExists mocks base method.
 func (m *MockGraphStorage) ProjectIndexExists(projectUuid string) (bool, error) {
 	m.ctrl.T.Helper()
@@ -3,6 +3,7 @@ package mocks
 import (
 	"codebase-indexer/internal/config"
 	"codebase-indexer/internal/dto"
+	"codebase-indexer/internal/utils"
 
 	"github.com/stretchr/testify/mock"
 )
@@ -35,6 +36,11 @@ func (m *MockHTTPSync) UploadFile(filePath string, uploadReq dto.UploadReq) erro
 	return args.Error(0)
 }
 
+func (m *MockHTTPSync) UploadStream(body utils.UploadBody, uploadReq dto.UploadReq) error {
+	args := m.Called(body, uploadReq)
+	return args.Error(0)
+}
+
 func (m *MockHTTPSync) FetchFileStatus(req dto.FileStatusReq) (*dto.FileStatusResp, error) {
 	args := m.Called(req)
 	return args.Get(0).(*dto.FileStatusResp), args.Error(1)
@@ -37,6 +37,21 @@ func (m *MockIndexer) EXPECT() *MockIndexerMockRecorder {
 	return m.recorder
 }
 
+// ExportSnapshots mocks base method.
+func (m *MockIndexer) ExportSnapshots(ctx context.Context, workspacePath, dir string) ([]string, error) {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "ExportSnapshots", ctx, workspacePath, dir)
+	ret0, _ := ret[0].([]string)
+	ret1, _ := ret[1].(error)
+	return ret0, ret1
+}
+
+// ExportSnapshots indicates an expected call of ExportSnapshots.
+func (mr *MockIndexerMockRecorder) ExportSnapshots(ctx, workspacePath, dir interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "ExportSnapshots", reflect.TypeOf((*MockIndexer)(nil).ExportSnapshots), ctx, workspacePath, dir)
+}
+
 // GetFileElementTable mocks base method.
 func (m *MockIndexer) GetFileElementTable(ctx context.Context, workspacePath, filePath string) (*codegraphpb.FileElementTable, error) {
 	m.ctrl.T.Helper()
@@ -110,6 +125,18 @@ func (mr *MockIndexerMockRecorder) IndexWorkspace(ctx, workspacePath interface{}
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "IndexWorkspace", reflect.TypeOf((*MockIndexer)(nil).IndexWorkspace), ctx, workspacePath)
 }
 
+// PreopenWorkspace mocks base method.
+func (m *MockIndexer) PreopenWorkspace(ctx context.Context, workspacePath string) {
+	m.ctrl.T.Helper()
+	m.ctrl.Call(m, "PreopenWorkspace", ctx, workspacePath)
+}
+
+// PreopenWorkspace indicates an expected call of PreopenWorkspace.
+func (mr *MockIndexerMockRecorder) PreopenWorkspace(ctx, workspacePath interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "PreopenWorkspace", reflect.TypeOf((*MockIndexer)(nil).PreopenWorkspace), ctx, workspacePath)
+}
+
 // QueryCallGraph mocks base method.
 func (m *MockIndexer) QueryCallGraph(ctx context.Context, opts *types.QueryCallGraphOptions) ([]*types.RelationNode, error) {
 	m.ctrl.T.Helper()
@@ -196,3 +223,32 @@ func (mr *MockIndexerMockRecorder) RenameIndexes(ctx, workspacePath, sourceFileP
 	mr.mock.ctrl.T.Helper()
 	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "RenameIndexes", reflect.TypeOf((*MockIndexer)(nil).RenameIndexes), ctx, workspacePath, sourceFilePath, targetFilePath)
 }
+
+// SearchSymbols mocks base method.
+func (m *MockIndexer) SearchSymbols(ctx context.Context, opts *types.SearchSymbolOptions) ([]*types.SymbolSearchResult, error) {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "SearchSymbols", ctx, opts)
+	ret0, _ := ret[0].([]*types.SymbolSearchResult)
+	ret1, _ := ret[1].(error)
+	return ret0, ret1
+}
+
+// SearchSymbols indicates an expected call of SearchSymbols.
+func (mr *MockIndexerMockRecorder) SearchSymbols(ctx, opts interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "SearchSymbols", reflect.TypeOf((*MockIndexer)(nil).SearchSymbols), ctx, opts)
+}
+
+// UpdateFileIndex mocks base method.
+func (m *MockIndexer) UpdateFileIndex(ctx context.Context, workspacePath, filePath string) error {
+	m.ctrl.T.Helper()
+	ret := m.ctrl.Call(m, "UpdateFileIndex", ctx, workspacePath, filePath)
+	ret0, _ := ret[0].(error)
+	return ret0
+}
+
+// UpdateFileIndex indicates an expected call of UpdateFileIndex.
+func (mr *MockIndexerMockRecorder) UpdateFileIndex(ctx, workspacePath, filePath interface{}) *gomock.Call {
+	mr.mock.ctrl.T.Helper()
+	return mr.mock.ctrl.RecordCallWithMethodType(mr.mock, "UpdateFileIndex", reflect.TypeOf((*MockIndexer)(nil).UpdateFileIndex), ctx, workspacePath, filePath)
+}
@@ -50,6 +50,14 @@ func (m *MockScanner) ScanCodebase(ignoreConfig *config.IgnoreConfig, codebasePa
 	return nil, args.Error(1)
 }
 
+func (m *MockScanner) ScanCodebaseTree(ignoreConfig *config.IgnoreConfig, codebasePath string, previous *utils.FileTree) (*utils.FileTree, error) {
+	args := m.Called(ignoreConfig, codebasePath, previous)
+	if args.Get(0) != nil {
+		return args.Get(0).(*utils.FileTree), args.Error(1)
+	}
+	return nil, args.Error(1)
+}
+
 func (m *MockScanner) ScanFilePaths(codebasePath string, filePaths []string) (map[string]string, error) {
 	args := m.Called(codebasePath, filePaths)
 	if args.Get(0) != nil {
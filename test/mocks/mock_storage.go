@@ -2,6 +2,7 @@ package mocks
 
 import (
 	"codebase-indexer/internal/config"
+	"codebase-indexer/internal/utils"
 
 	"github.com/stretchr/testify/mock"
 )
@@ -45,3 +46,16 @@ func (m *MockStorageManager) SaveCodebaseEnv(codebaseEnv *config.CodebaseEnv) er
 	args := m.Called(codebaseEnv)
 	return args.Error(0)
 }
+
+func (m *MockStorageManager) GetFileTree(codebaseId string) (*utils.FileTree, error) {
+	args := m.Called(codebaseId)
+	if args.Get(0) != nil {
+		return args.Get(0).(*utils.FileTree), args.Error(1)
+	}
+	return nil, args.Error(1)
+}
+
+func (m *MockStorageManager) SaveFileTree(codebaseId string, tree *utils.FileTree) error {
+	args := m.Called(codebaseId, tree)
+	return args.Error(0)
+}